@@ -107,11 +107,13 @@ public class CesiumEditor : ModuleRules
                 "CoreUObject",
                 "Engine",
                 "ApplicationCore",
+                "AssetRegistry",
                 "Slate",
                 "SlateCore",
                 "MeshDescription",
                 "StaticMeshDescription",
                 "HTTP",
+                "Json",
                 "MikkTSpace",
                 "Chaos",
                 "Projects",
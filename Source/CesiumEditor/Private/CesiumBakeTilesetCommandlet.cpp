@@ -0,0 +1,822 @@
+// Copyright 2020-2021 CesiumGS, Inc. and Contributors
+
+#include "CesiumBakeTilesetCommandlet.h"
+#include "Cesium3DTileset.h"
+#include "CesiumAsync/AsyncSystem.h"
+#include "CesiumCameraManager.h"
+#include "CesiumEditor.h"
+#include "CesiumGeoreference.h"
+#include "CesiumGeospatial/Ellipsoid.h"
+#include "CesiumRuntime.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/StaticMeshActor.h"
+#include "Engine/Texture2D.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "FileHelpers.h"
+#include "HAL/PlatformProcess.h"
+#include "HAL/PlatformTime.h"
+#include "HttpManager.h"
+#include "HttpModule.h"
+#include "Materials/MaterialInstanceConstant.h"
+#include "Misc/PackageName.h"
+#include "Misc/Parse.h"
+#include "PhysicsEngine/BodySetup.h"
+#include "Runtime/Launch/Resources/Version.h"
+#include "StaticMeshAttributes.h"
+#include "StaticMeshResources.h"
+#include "UObject/Package.h"
+#include <glm/trigonometric.hpp>
+#include <vector>
+
+#if ENGINE_MAJOR_VERSION == 5
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "WorldPartition/HLOD/HLODLayer.h"
+#else
+#include "AssetRegistryModule.h"
+#endif
+
+namespace {
+
+// UE4 and UE5 both use single-precision vectors for meshes, but they have
+// different names.
+#if ENGINE_MAJOR_VERSION == 5
+using TMeshVector3 = FVector3f;
+using TMeshVector4 = FVector4f;
+#else
+using TMeshVector3 = FVector;
+using TMeshVector4 = FVector4;
+#endif
+
+// The field of view and viewport of each of the views looking down over the
+// region, which are the same as those of the cache warming commandlet.
+constexpr double ViewFieldOfViewDegrees = 60.0;
+constexpr float ViewportSize = 1024.0f;
+
+TArray<FStaticMaterial>& getStaticMaterials(UStaticMesh* pStaticMesh) {
+#if ENGINE_MAJOR_VERSION == 4 && ENGINE_MINOR_VERSION < 27
+  return pStaticMesh->StaticMaterials;
+#else
+  return pStaticMesh->GetStaticMaterials();
+#endif
+}
+
+FStaticMeshRenderData* getRenderData(UStaticMesh* pStaticMesh) {
+#if ENGINE_MAJOR_VERSION == 4 && ENGINE_MINOR_VERSION < 27
+  return pStaticMesh->RenderData.Get();
+#else
+  return pStaticMesh->GetRenderData();
+#endif
+}
+
+const FTexturePlatformData* getPlatformData(const UTexture2D* pTexture) {
+#if ENGINE_MAJOR_VERSION >= 5
+  return pTexture->GetPlatformData();
+#else
+  return pTexture->PlatformData;
+#endif
+}
+
+/**
+ * Creates a grid of cameras looking straight down from the given height over
+ * the given region, in degrees, spaced so that their footprints on the
+ * ground cover all of it.
+ */
+std::vector<FCesiumCamera> createCameras(
+    const ACesiumGeoreference& georeference,
+    double west,
+    double south,
+    double east,
+    double north,
+    double height) {
+  if (east < west) {
+    // The region crosses the anti-meridian.
+    east += 360.0;
+  }
+
+  const double radius = CesiumGeospatial::Ellipsoid::WGS84.getMaximumRadius();
+  const double footprint =
+      2.0 * height * glm::tan(glm::radians(ViewFieldOfViewDegrees) * 0.5);
+
+  const double midLatitude = glm::radians((south + north) * 0.5);
+  const double widthMeters =
+      glm::radians(east - west) * radius * glm::cos(midLatitude);
+  const double heightMeters = glm::radians(north - south) * radius;
+  const int32 columns =
+      FMath::Max(1, FMath::CeilToInt(float(widthMeters / footprint)));
+  const int32 rows =
+      FMath::Max(1, FMath::CeilToInt(float(heightMeters / footprint)));
+
+  const FQuat lookDown = FRotator(-90.0f, 0.0f, 0.0f).Quaternion();
+
+  std::vector<FCesiumCamera> cameras;
+  cameras.reserve(size_t(columns) * size_t(rows));
+
+  for (int32 row = 0; row < rows; ++row) {
+    const double latitude = south + (north - south) * (row + 0.5) / rows;
+    for (int32 column = 0; column < columns; ++column) {
+      const double longitude =
+          west + (east - west) * (column + 0.5) / columns;
+
+      const glm::dvec3 unreal =
+          georeference.TransformLongitudeLatitudeHeightToUnreal(
+              glm::dvec3(longitude, latitude, height));
+      const FVector location(unreal.x, unreal.y, unreal.z);
+      const FMatrix enuToUnreal =
+          georeference.InaccurateComputeEastNorthUpToUnreal(location);
+
+      cameras.emplace_back(
+          FVector2D(ViewportSize, ViewportSize),
+          location,
+          FRotator(enuToUnreal.ToQuat() * lookDown),
+          float(ViewFieldOfViewDegrees));
+    }
+  }
+
+  return cameras;
+}
+
+/**
+ * Copies the transient meshes, materials and textures that tiles are drawn
+ * with into new assets, each in a package of its own under the output path.
+ * Materials and textures that are shared by several tiles are copied once.
+ */
+class TilesetBaker {
+public:
+  TilesetBaker(const FString& outputPath) : _outputPath(outputPath) {}
+
+  /**
+   * Copies the static mesh of the component, with the materials that the
+   * component draws it with. Returns nullptr if the mesh can't be copied,
+   * which is logged.
+   */
+  UStaticMesh* bakeMesh(UStaticMeshComponent& component);
+
+  /**
+   * Whether an asset could not be created because its package already
+   * exists.
+   */
+  bool failed() const { return this->_failed; }
+
+  /**
+   * The assets that were created, which are not saved yet.
+   */
+  const TArray<UObject*>& getAssets() const { return this->_assets; }
+
+private:
+  UPackage* createPackage(const TCHAR* prefix, FString& assetName);
+  void addAsset(UObject* pAsset);
+  UMaterialInterface* bakeMaterial(UMaterialInterface* pMaterial);
+  UTexture* bakeTexture(UTexture* pTexture);
+
+  FString _outputPath;
+  int32 _nextAssetIndex = 0;
+  bool _failed = false;
+  TMap<UObject*, UObject*> _baked;
+  TArray<UObject*> _assets;
+};
+
+UPackage* TilesetBaker::createPackage(const TCHAR* prefix, FString& assetName) {
+  assetName = FString::Printf(TEXT("%s_%d"), prefix, this->_nextAssetIndex++);
+  const FString packageName = this->_outputPath / assetName;
+
+  // Replacing the assets of an earlier bake in place could leave references
+  // to them from elsewhere pointing at unrelated tiles.
+  if (FPackageName::DoesPackageExist(packageName) ||
+      FindPackage(nullptr, *packageName)) {
+    UE_LOG(
+        LogCesiumEditor,
+        Error,
+        TEXT("%s already exists, bake into an empty -Output path instead"),
+        *packageName);
+    this->_failed = true;
+    return nullptr;
+  }
+
+  return CreatePackage(*packageName);
+}
+
+void TilesetBaker::addAsset(UObject* pAsset) {
+  FAssetRegistryModule::AssetCreated(pAsset);
+  pAsset->MarkPackageDirty();
+  this->_assets.Add(pAsset);
+}
+
+UTexture* TilesetBaker::bakeTexture(UTexture* pTexture) {
+  if (!pTexture || pTexture->IsAsset()) {
+    return pTexture;
+  }
+
+  UObject** ppBaked = this->_baked.Find(pTexture);
+  if (ppBaked) {
+    return Cast<UTexture>(*ppBaked);
+  }
+  this->_baked.Add(pTexture, nullptr);
+
+  // The editor keeps the pixels of the textures of tiles after they are
+  // uploaded, but only uncompressed ones can be turned back into a source.
+  UTexture2D* pTexture2D = Cast<UTexture2D>(pTexture);
+  const FTexturePlatformData* pData =
+      pTexture2D ? getPlatformData(pTexture2D) : nullptr;
+  ETextureSourceFormat format = TSF_Invalid;
+  if (pData && pData->Mips.Num() > 0) {
+    if (pData->PixelFormat == PF_R8G8B8A8 ||
+        pData->PixelFormat == PF_B8G8R8A8) {
+      format = TSF_BGRA8;
+    } else if (pData->PixelFormat == PF_G8) {
+      format = TSF_G8;
+    }
+  }
+
+  const FTexture2DMipMap* pMip =
+      format != TSF_Invalid ? &pData->Mips[0] : nullptr;
+  const uint8* pPixels =
+      pMip ? static_cast<const uint8*>(pMip->BulkData.LockReadOnly())
+           : nullptr;
+  if (!pPixels) {
+    if (pMip) {
+      pMip->BulkData.Unlock();
+    }
+    UE_LOG(
+        LogCesiumEditor,
+        Warning,
+        TEXT(
+            "%s can't be baked because its pixels are compressed or were "
+            "discarded, so its materials use their default texture instead"),
+        *pTexture->GetName());
+    return nullptr;
+  }
+
+  FString name;
+  UPackage* pPackage = this->createPackage(TEXT("T_Tile"), name);
+  if (!pPackage) {
+    pMip->BulkData.Unlock();
+    return nullptr;
+  }
+
+  UTexture2D* pBaked =
+      NewObject<UTexture2D>(pPackage, *name, RF_Public | RF_Standalone);
+  if (pData->PixelFormat == PF_R8G8B8A8) {
+    const int32 numTexels = pMip->SizeX * pMip->SizeY;
+    TArray<uint8> bgra;
+    bgra.SetNumUninitialized(numTexels * 4);
+    for (int32 i = 0; i < numTexels; ++i) {
+      bgra[i * 4] = pPixels[i * 4 + 2];
+      bgra[i * 4 + 1] = pPixels[i * 4 + 1];
+      bgra[i * 4 + 2] = pPixels[i * 4];
+      bgra[i * 4 + 3] = pPixels[i * 4 + 3];
+    }
+    pBaked->Source.Init(pMip->SizeX, pMip->SizeY, 1, 1, format, bgra.GetData());
+  } else {
+    pBaked->Source.Init(pMip->SizeX, pMip->SizeY, 1, 1, format, pPixels);
+  }
+  pMip->BulkData.Unlock();
+
+  pBaked->SRGB = pTexture2D->SRGB;
+  pBaked->CompressionSettings = pTexture2D->CompressionSettings;
+  pBaked->Filter = pTexture2D->Filter;
+  pBaked->AddressX = pTexture2D->AddressX;
+  pBaked->AddressY = pTexture2D->AddressY;
+  pBaked->LODGroup = pTexture2D->LODGroup;
+  pBaked->PostEditChange();
+
+  this->addAsset(pBaked);
+  this->_baked[pTexture] = pBaked;
+  return pBaked;
+}
+
+UMaterialInterface*
+TilesetBaker::bakeMaterial(UMaterialInterface* pMaterial) {
+  if (!pMaterial || pMaterial->IsAsset()) {
+    return pMaterial;
+  }
+
+  UObject** ppBaked = this->_baked.Find(pMaterial);
+  if (ppBaked) {
+    return Cast<UMaterialInterface>(*ppBaked);
+  }
+  this->_baked.Add(pMaterial, nullptr);
+
+  // The materials of tiles are instances of the tileset's materials, whose
+  // parameters, such as the textures of the tile and of its raster overlay
+  // tiles, are copied into a constant instance.
+  UMaterialInstance* pInstance = Cast<UMaterialInstance>(pMaterial);
+  UMaterialInterface* pParent =
+      pInstance ? this->bakeMaterial(pInstance->Parent) : nullptr;
+  if (!pParent) {
+    UE_LOG(
+        LogCesiumEditor,
+        Warning,
+        TEXT("%s can't be baked because it isn't an instance of an asset"),
+        *pMaterial->GetName());
+    return nullptr;
+  }
+
+  FString name;
+  UPackage* pPackage = this->createPackage(TEXT("MI_Tile"), name);
+  if (!pPackage) {
+    return nullptr;
+  }
+
+  UMaterialInstanceConstant* pBaked = NewObject<UMaterialInstanceConstant>(
+      pPackage,
+      *name,
+      RF_Public | RF_Standalone);
+  pBaked->SetParentEditorOnly(pParent);
+
+  for (const FScalarParameterValue& parameter :
+       pInstance->ScalarParameterValues) {
+    pBaked->SetScalarParameterValueEditorOnly(
+        parameter.ParameterInfo,
+        parameter.ParameterValue);
+  }
+  for (const FVectorParameterValue& parameter :
+       pInstance->VectorParameterValues) {
+    pBaked->SetVectorParameterValueEditorOnly(
+        parameter.ParameterInfo,
+        parameter.ParameterValue);
+  }
+  for (const FTextureParameterValue& parameter :
+       pInstance->TextureParameterValues) {
+    UTexture* pTexture = this->bakeTexture(parameter.ParameterValue);
+    if (pTexture) {
+      pBaked->SetTextureParameterValueEditorOnly(
+          parameter.ParameterInfo,
+          pTexture);
+    }
+  }
+  pBaked->PostEditChange();
+
+  this->addAsset(pBaked);
+  this->_baked[pMaterial] = pBaked;
+  return pBaked;
+}
+
+UStaticMesh* TilesetBaker::bakeMesh(UStaticMeshComponent& component) {
+  UStaticMesh* pSource = component.GetStaticMesh();
+  FStaticMeshRenderData* pRenderData =
+      pSource ? getRenderData(pSource) : nullptr;
+  if (!pRenderData || pRenderData->LODResources.Num() == 0) {
+    return nullptr;
+  }
+
+  // Tiles have a single LOD, whose vertices and indices the editor keeps
+  // after they are uploaded.
+  FStaticMeshLODResources& lod = pRenderData->LODResources[0];
+  FPositionVertexBuffer& positionBuffer =
+      lod.VertexBuffers.PositionVertexBuffer;
+  FStaticMeshVertexBuffer& meshBuffer =
+      lod.VertexBuffers.StaticMeshVertexBuffer;
+  const FColorVertexBuffer& colorBuffer = lod.VertexBuffers.ColorVertexBuffer;
+  const uint32 numVertices = positionBuffer.GetNumVertices();
+
+  TArray<uint32> indices;
+  lod.IndexBuffer.GetCopy(indices);
+  if (numVertices == 0 || indices.Num() == 0 ||
+      !positionBuffer.GetVertexData() || !meshBuffer.GetTangentData()) {
+    UE_LOG(
+        LogCesiumEditor,
+        Warning,
+        TEXT("%s can't be baked because its vertices were discarded"),
+        *pSource->GetName());
+    return nullptr;
+  }
+
+  FString name;
+  UPackage* pPackage = this->createPackage(TEXT("SM_Tile"), name);
+  if (!pPackage) {
+    return nullptr;
+  }
+
+  UStaticMesh* pMesh =
+      NewObject<UStaticMesh>(pPackage, *name, RF_Public | RF_Standalone);
+  const int32 numTexCoords = int32(meshBuffer.GetNumTexCoords());
+
+  // The normals and tangents are kept as they were converted. Lightmap UVs
+  // are generated into a channel of their own, after the ones that the
+  // materials sample the textures and raster overlays with.
+  pMesh->SetNumSourceModels(1);
+  FMeshBuildSettings& buildSettings = pMesh->GetSourceModel(0).BuildSettings;
+  buildSettings.bRecomputeNormals = false;
+  buildSettings.bRecomputeTangents = false;
+  buildSettings.bRemoveDegenerates = false;
+  buildSettings.bGenerateLightmapUVs =
+      numTexCoords > 0 && numTexCoords < MAX_MESH_TEXTURE_COORDS_MD;
+  buildSettings.SrcLightmapIndex = 0;
+  buildSettings.DstLightmapIndex = numTexCoords;
+  if (buildSettings.bGenerateLightmapUVs) {
+#if ENGINE_MAJOR_VERSION == 4 && ENGINE_MINOR_VERSION < 27
+    pMesh->LightMapCoordinateIndex = numTexCoords;
+#else
+    pMesh->SetLightMapCoordinateIndex(numTexCoords);
+#endif
+  }
+
+  FMeshDescription* pDescription = pMesh->CreateMeshDescription(0);
+  FStaticMeshAttributes attributes(*pDescription);
+  auto positions = attributes.GetVertexPositions();
+  auto normals = attributes.GetVertexInstanceNormals();
+  auto tangents = attributes.GetVertexInstanceTangents();
+  auto binormalSigns = attributes.GetVertexInstanceBinormalSigns();
+  auto colors = attributes.GetVertexInstanceColors();
+  auto uvs = attributes.GetVertexInstanceUVs();
+  auto slotNames = attributes.GetPolygonGroupMaterialSlotNames();
+#if ENGINE_MAJOR_VERSION == 5
+  uvs.SetNumChannels(FMath::Max(numTexCoords, 1));
+#else
+  uvs.SetNumIndices(FMath::Max(numTexCoords, 1));
+#endif
+
+  pDescription->ReserveNewVertices(numVertices);
+  pDescription->ReserveNewVertexInstances(numVertices);
+  pDescription->ReserveNewPolygons(indices.Num() / 3);
+
+  // The vertices of the render data are already split wherever their
+  // attributes differ, so each one gets a single vertex instance.
+  const bool hasColors = colorBuffer.GetNumVertices() == numVertices;
+  TArray<FVertexInstanceID> vertexInstances;
+  vertexInstances.Reserve(numVertices);
+  for (uint32 i = 0; i < numVertices; ++i) {
+    const FVertexID vertex = pDescription->CreateVertex();
+    positions[vertex] = positionBuffer.VertexPosition(i);
+
+    const FVertexInstanceID instance =
+        pDescription->CreateVertexInstance(vertex);
+    const TMeshVector4 tangentZ = meshBuffer.VertexTangentZ(i);
+    normals[instance] = TMeshVector3(tangentZ);
+    tangents[instance] = TMeshVector3(meshBuffer.VertexTangentX(i));
+    binormalSigns[instance] = tangentZ.W < 0.0f ? -1.0f : 1.0f;
+    colors[instance] =
+        hasColors ? TMeshVector4(FLinearColor(colorBuffer.VertexColor(i)))
+                  : TMeshVector4(1.0f, 1.0f, 1.0f, 1.0f);
+    for (int32 uv = 0; uv < numTexCoords; ++uv) {
+      uvs.Set(instance, uv, meshBuffer.GetVertexUV(i, uv));
+    }
+    vertexInstances.Add(instance);
+  }
+
+  // Each section gets a polygon group and a material slot of its own, in the
+  // same order, with the material that the component draws it with.
+  TArray<FStaticMaterial>& materials = getStaticMaterials(pMesh);
+  TArray<FVertexInstanceID> triangle;
+  for (const FStaticMeshSection& section : lod.Sections) {
+    const FPolygonGroupID group = pDescription->CreatePolygonGroup();
+    const FName slotName(*FString::Printf(TEXT("Section%d"), materials.Num()));
+    slotNames[group] = slotName;
+    materials.Add(FStaticMaterial(
+        this->bakeMaterial(component.GetMaterial(section.MaterialIndex)),
+        slotName,
+        slotName));
+
+    for (uint32 i = 0; i < section.NumTriangles; ++i) {
+      const int32 first = int32(section.FirstIndex + i * 3);
+      if (first + 2 >= indices.Num()) {
+        break;
+      }
+
+      const uint32 a = indices[first];
+      const uint32 b = indices[first + 1];
+      const uint32 c = indices[first + 2];
+      if (a >= numVertices || b >= numVertices || c >= numVertices ||
+          a == b || b == c || a == c) {
+        continue;
+      }
+
+      triangle.Reset();
+      triangle.Add(vertexInstances[a]);
+      triangle.Add(vertexInstances[b]);
+      triangle.Add(vertexInstances[c]);
+      pDescription->CreatePolygon(group, triangle);
+    }
+  }
+
+  pMesh->CommitMeshDescription(0);
+
+  // Like the tiles, the baked meshes collide with their triangles.
+  pMesh->CreateBodySetup();
+#if ENGINE_MAJOR_VERSION == 4 && ENGINE_MINOR_VERSION < 27
+  UBodySetup* pBodySetup = pMesh->BodySetup;
+#else
+  UBodySetup* pBodySetup = pMesh->GetBodySetup();
+#endif
+  pBodySetup->CollisionTraceFlag = ECollisionTraceFlag::CTF_UseComplexAsSimple;
+
+  pMesh->Build(true);
+  pMesh->PostEditChange();
+
+  this->addAsset(pMesh);
+  return pMesh;
+}
+
+/**
+ * Places a Static Mesh Actor that draws the baked mesh of a tile where the
+ * tile is drawn.
+ */
+void spawnBakedActor(
+    UWorld& world,
+    UStaticMesh& mesh,
+    const UStaticMeshComponent& source,
+    const FTransform& transform,
+    const FName& folder,
+    const FName& tag,
+    UObject* pHLODLayer) {
+  FActorSpawnParameters parameters;
+  parameters.OverrideLevel = world.PersistentLevel;
+  AStaticMeshActor* pActor =
+      world.SpawnActor<AStaticMeshActor>(transform, parameters);
+  if (!pActor) {
+    return;
+  }
+
+  UStaticMeshComponent* pComponent = pActor->GetStaticMeshComponent();
+  pComponent->SetStaticMesh(&mesh);
+  pComponent->SetCollisionProfileName(source.GetCollisionProfileName());
+  pComponent->SetCastShadow(source.CastShadow);
+
+  pActor->SetActorLabel(mesh.GetName());
+  pActor->SetFolderPath(folder);
+  pActor->Tags.Add(tag);
+
+#if ENGINE_MAJOR_VERSION == 5
+  UHLODLayer* pLayer = Cast<UHLODLayer>(pHLODLayer);
+  if (pLayer) {
+    pActor->SetHLODLayer(pLayer);
+  }
+#endif
+}
+
+ACesium3DTileset* findTileset(UWorld& world, const FString& name) {
+  ACesium3DTileset* pFound = nullptr;
+  for (TActorIterator<ACesium3DTileset> it(&world); it; ++it) {
+    if (!name.IsEmpty() && it->GetName() != name &&
+        it->GetActorLabel() != name) {
+      continue;
+    }
+    if (pFound) {
+      UE_LOG(
+          LogCesiumEditor,
+          Error,
+          TEXT("The map has several tilesets, choose one with -Tileset"));
+      return nullptr;
+    }
+    pFound = *it;
+  }
+
+  if (!pFound) {
+    UE_LOG(LogCesiumEditor, Error, TEXT("The tileset was not found"));
+  }
+  return pFound;
+}
+} // namespace
+
+UCesiumBakeTilesetCommandlet::UCesiumBakeTilesetCommandlet() {
+  this->IsClient = false;
+  this->IsEditor = true;
+  this->IsServer = false;
+  this->LogToConsole = true;
+}
+
+int32 UCesiumBakeTilesetCommandlet::Main(const FString& Params) {
+  const TCHAR* pParams = *Params;
+
+  FString map;
+  double west = 0.0;
+  double south = 0.0;
+  double east = 0.0;
+  double north = 0.0;
+  if (!FParse::Value(pParams, TEXT("Map="), map) ||
+      !FParse::Value(pParams, TEXT("West="), west) ||
+      !FParse::Value(pParams, TEXT("South="), south) ||
+      !FParse::Value(pParams, TEXT("East="), east) ||
+      !FParse::Value(pParams, TEXT("North="), north)) {
+    UE_LOG(
+        LogCesiumEditor,
+        Error,
+        TEXT(
+            "Usage: -run=CesiumBakeTileset -Map=<map package> "
+            "-West=<degrees> -South=<degrees> -East=<degrees> "
+            "-North=<degrees>"));
+    return 1;
+  }
+
+  FString tilesetName;
+  FString outputPath;
+  FString hlodLayerPath;
+  double height = 1000.0;
+  float maximumScreenSpaceError = 0.0f;
+  double timeout = 600.0;
+  FParse::Value(pParams, TEXT("Tileset="), tilesetName);
+  FParse::Value(pParams, TEXT("Output="), outputPath);
+  FParse::Value(pParams, TEXT("HLODLayer="), hlodLayerPath);
+  FParse::Value(pParams, TEXT("Height="), height);
+  FParse::Value(
+      pParams,
+      TEXT("MaximumScreenSpaceError="),
+      maximumScreenSpaceError);
+  FParse::Value(pParams, TEXT("Timeout="), timeout);
+  const bool keepTileset = FParse::Param(pParams, TEXT("KeepTileset"));
+  height = FMath::Max(height, 1.0);
+
+  UWorld* pWorld = UEditorLoadingAndSavingUtils::LoadMap(map);
+  if (!pWorld) {
+    UE_LOG(LogCesiumEditor, Error, TEXT("%s could not be loaded"), *map);
+    return 1;
+  }
+
+  ACesium3DTileset* pTileset = findTileset(*pWorld, tilesetName);
+  ACesiumGeoreference* pGeoreference =
+      pTileset ? pTileset->ResolveGeoreference() : nullptr;
+  ACesiumCameraManager* pCameraManager =
+      ACesiumCameraManager::GetDefaultCameraManager(pWorld);
+  if (!pGeoreference || !pCameraManager) {
+    return 1;
+  }
+
+  if (outputPath.IsEmpty()) {
+    outputPath = TEXT("/Game/CesiumBaked/") + pTileset->GetName();
+  }
+
+  UObject* pHLODLayer = nullptr;
+  if (!hlodLayerPath.IsEmpty()) {
+#if ENGINE_MAJOR_VERSION == 5
+    pHLODLayer = LoadObject<UHLODLayer>(nullptr, *hlodLayerPath);
+#endif
+    if (!pHLODLayer) {
+      UE_LOG(
+          LogCesiumEditor,
+          Error,
+          TEXT("%s is not an HLOD layer of this engine"),
+          *hlodLayerPath);
+      return 1;
+    }
+  }
+
+  // Only the views over the region select tiles, at the requested
+  // screen-space error, in the same way as a preloaded view does.
+  std::vector<FCesiumCamera> cameras =
+      createCameras(*pGeoreference, west, south, east, north, height);
+  TArray<int32> cameraIds;
+  for (FCesiumCamera& camera : cameras) {
+    if (maximumScreenSpaceError > 0.0f) {
+      camera.ScreenSpaceErrorScale =
+          pTileset->MaximumScreenSpaceError / maximumScreenSpaceError;
+    }
+    cameraIds.Add(pCameraManager->AddCamera(camera));
+  }
+
+  const bool useOnlyRegisteredCameras =
+      pCameraManager->UseOnlyRegisteredCameras;
+  const bool updateInEditor = pTileset->UpdateInEditor;
+  pCameraManager->UseOnlyRegisteredCameras = true;
+  pTileset->UpdateInEditor = true;
+
+  UE_LOG(
+      LogCesiumEditor,
+      Display,
+      TEXT("Loading the tiles of %s from %d views"),
+      *pTileset->GetActorLabel(),
+      int32(cameras.size()));
+
+  FHttpManager& httpManager = FHttpModule::Get().GetHttpManager();
+  const double startTime = FPlatformTime::Seconds();
+  double lastReportTime = startTime;
+  double lastTickTime = startTime;
+  bool timedOut = false;
+
+  // The tiles are loaded once the tileset has reported them all loaded for a
+  // few updates in a row, so that the tiles refined to after loading their
+  // parents are loaded too.
+  int32 completeUpdates = 0;
+  while (completeUpdates < 3) {
+    const double now = FPlatformTime::Seconds();
+    const float deltaTime = float(now - lastTickTime);
+    lastTickTime = now;
+
+    httpManager.Tick(deltaTime);
+    pWorld->Tick(LEVELTICK_ViewportsOnly, deltaTime);
+    getAsyncSystem().dispatchMainThreadTasks();
+    ++GFrameCounter;
+
+    const float progress = pTileset->GetLoadProgress();
+    completeUpdates = pTileset->IsLoadComplete() ? completeUpdates + 1 : 0;
+
+    if (now - lastReportTime >= 1.0) {
+      UE_LOG(LogCesiumEditor, Display, TEXT("%.0f%% loaded"), progress);
+      lastReportTime = now;
+    }
+
+    if (now - startTime > timeout) {
+      UE_LOG(
+          LogCesiumEditor,
+          Error,
+          TEXT("Loading timed out at %.0f%% loaded"),
+          progress);
+      timedOut = true;
+      break;
+    }
+
+    FPlatformProcess::Sleep(0.01f);
+  }
+
+  for (int32 cameraId : cameraIds) {
+    pCameraManager->RemoveCamera(cameraId);
+  }
+  pCameraManager->UseOnlyRegisteredCameras = useOnlyRegisteredCameras;
+  pTileset->UpdateInEditor = updateInEditor;
+
+  if (timedOut) {
+    return 1;
+  }
+
+  TArray<UStaticMeshComponent*> components;
+  pTileset->GetRenderedTileMeshComponents(components);
+
+  // The actors of an earlier bake of this tileset are replaced.
+  const FName tag(*(TEXT("CesiumBaked:") + pTileset->GetName()));
+  const FName folder(*(pTileset->GetActorLabel() + TEXT(" (Baked)")));
+  TArray<AActor*> previousActors;
+  for (TActorIterator<AStaticMeshActor> it(pWorld); it; ++it) {
+    if (it->Tags.Contains(tag)) {
+      previousActors.Add(*it);
+    }
+  }
+  for (AActor* pActor : previousActors) {
+    pWorld->EditorDestroyActor(pActor, true);
+  }
+
+  TilesetBaker baker(outputPath);
+  int32 numBaked = 0;
+  for (UStaticMeshComponent* pComponent : components) {
+    UStaticMesh* pMesh = baker.bakeMesh(*pComponent);
+    if (baker.failed()) {
+      return 1;
+    }
+    if (!pMesh) {
+      continue;
+    }
+
+    // Each instance of an instanced primitive gets an actor of its own.
+    UInstancedStaticMeshComponent* pInstanced =
+        Cast<UInstancedStaticMeshComponent>(pComponent);
+    if (pInstanced) {
+      for (int32 i = 0; i < pInstanced->GetInstanceCount(); ++i) {
+        FTransform transform;
+        pInstanced->GetInstanceTransform(i, transform, true);
+        spawnBakedActor(
+            *pWorld,
+            *pMesh,
+            *pComponent,
+            transform,
+            folder,
+            tag,
+            pHLODLayer);
+      }
+    } else {
+      spawnBakedActor(
+          *pWorld,
+          *pMesh,
+          *pComponent,
+          pComponent->GetComponentTransform(),
+          folder,
+          tag,
+          pHLODLayer);
+    }
+    ++numBaked;
+  }
+
+  if (!keepTileset) {
+    pTileset->Modify();
+    pTileset->bIsEditorOnlyActor = true;
+  }
+
+  bool saved = true;
+  for (UObject* pAsset : baker.getAssets()) {
+    UPackage* pPackage = pAsset->GetOutermost();
+    const FString filename = FPackageName::LongPackageNameToFilename(
+        pPackage->GetName(),
+        FPackageName::GetAssetPackageExtension());
+    if (!UPackage::SavePackage(
+            pPackage,
+            pAsset,
+            RF_Public | RF_Standalone,
+            *filename)) {
+      UE_LOG(LogCesiumEditor, Error, TEXT("%s could not be saved"), *filename);
+      saved = false;
+    }
+  }
+
+  // This saves the actors too when World Partition stores them in packages
+  // of their own.
+  saved = UEditorLoadingAndSavingUtils::SaveDirtyPackages(true, false) && saved;
+
+  UE_LOG(
+      LogCesiumEditor,
+      Display,
+      TEXT("Baked %d of %d tile primitives into %d assets under %s"),
+      numBaked,
+      components.Num(),
+      baker.getAssets().Num(),
+      *outputPath);
+  return saved ? 0 : 1;
+}
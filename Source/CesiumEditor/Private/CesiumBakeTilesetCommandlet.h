@@ -0,0 +1,46 @@
+// Copyright 2020-2021 CesiumGS, Inc. and Contributors
+
+#pragma once
+
+#include "Commandlets/Commandlet.h"
+#include "CoreMinimal.h"
+#include "CesiumBakeTilesetCommandlet.generated.h"
+
+/**
+ * Bakes the tiles of a Cesium3DTileset in a level that are needed to view a
+ * region at a given screen-space error into regular static mesh, material
+ * and texture assets, and places a Static Mesh Actor for each of them in the
+ * level, so that a shipping build can render the region without streaming.
+ *
+ * The tiles are selected for a grid of views looking straight down over the
+ * region, like UCesiumCacheWarmingCommandlet does, and converted the same
+ * way as when they are streamed. Their meshes, materials, including the
+ * raster overlay textures draped over them, and uncompressed textures are
+ * then copied into assets under the output path, which must not contain
+ * assets from an earlier bake. The actors of an earlier bake of the same
+ * tileset are replaced.
+ *
+ * The baked actors are spatially loaded, so World Partition streams them in
+ * its cells, and they are included in the HLODs of the level like any other
+ * Static Mesh Actor. In Unreal Engine 5, -HLODLayer assigns them an HLOD
+ * layer. Unless -KeepTileset is given, the tileset is made editor-only, so
+ * that it can be baked again but is left out of cooked builds.
+ *
+ * Usage:
+ *
+ *   UnrealEditor-Cmd <Project> -run=CesiumBakeTileset -Map=<map package>
+ *     [-Tileset=<actor name or label>]
+ *     -West=<degrees> -South=<degrees> -East=<degrees> -North=<degrees>
+ *     [-Height=<meters>] [-MaximumScreenSpaceError=<pixels>]
+ *     [-Output=<content path>] [-HLODLayer=<HLOD layer asset>]
+ *     [-Timeout=<seconds>] [-KeepTileset]
+ */
+UCLASS()
+class UCesiumBakeTilesetCommandlet : public UCommandlet {
+  GENERATED_BODY()
+
+public:
+  UCesiumBakeTilesetCommandlet();
+
+  virtual int32 Main(const FString& Params) override;
+};
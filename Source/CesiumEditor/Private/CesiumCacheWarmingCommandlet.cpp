@@ -0,0 +1,314 @@
+// Copyright 2020-2021 CesiumGS, Inc. and Contributors
+
+#include "CesiumCacheWarmingCommandlet.h"
+#include "Cesium3DTilesSelection/CreditSystem.h"
+#include "Cesium3DTilesSelection/IPrepareRendererResources.h"
+#include "Cesium3DTilesSelection/IonRasterOverlay.h"
+#include "Cesium3DTilesSelection/Tileset.h"
+#include "Cesium3DTilesSelection/ViewState.h"
+#include "CesiumAsync/AsyncSystem.h"
+#include "CesiumAsync/IAssetAccessor.h"
+#include "CesiumEditor.h"
+#include "CesiumGeospatial/Cartographic.h"
+#include "CesiumGeospatial/Ellipsoid.h"
+#include "CesiumRuntime.h"
+#include "CesiumRuntimeSettings.h"
+#include "CesiumUtility/Math.h"
+#include "HAL/PlatformProcess.h"
+#include "HAL/PlatformTime.h"
+#include "HttpManager.h"
+#include "HttpModule.h"
+#include "Misc/Parse.h"
+#include <glm/geometric.hpp>
+#include <glm/trigonometric.hpp>
+#include <algorithm>
+#include <spdlog/spdlog.h>
+
+using namespace Cesium3DTilesSelection;
+using namespace CesiumGeospatial;
+
+namespace {
+// The field of view and viewport of each of the views looking down over the
+// region.
+constexpr double ViewFieldOfView =
+    CesiumUtility::Math::degreesToRadians(60.0);
+constexpr double ViewportSize = 1024.0;
+
+// The tiles are only downloaded, so they don't need any renderer resources.
+class HeadlessResourcePreparer : public IPrepareRendererResources {
+public:
+  virtual void* prepareInLoadThread(
+      const CesiumGltf::Model& /*model*/,
+      const glm::dmat4& /*transform*/) override {
+    return nullptr;
+  }
+
+  virtual void*
+  prepareInMainThread(Tile& /*tile*/, void* /*pLoadThreadResult*/) override {
+    return nullptr;
+  }
+
+  virtual void free(
+      Tile& /*tile*/,
+      void* /*pLoadThreadResult*/,
+      void* /*pMainThreadResult*/) noexcept override {}
+
+  virtual void* prepareRasterInLoadThread(
+      const CesiumGltf::ImageCesium& /*image*/) override {
+    return nullptr;
+  }
+
+  virtual void* prepareRasterInMainThread(
+      const RasterOverlayTile& /*rasterTile*/,
+      void* /*pLoadThreadResult*/) override {
+    return nullptr;
+  }
+
+  virtual void freeRaster(
+      const RasterOverlayTile& /*rasterTile*/,
+      void* /*pLoadThreadResult*/,
+      void* /*pMainThreadResult*/) noexcept override {}
+
+  virtual void attachRasterInMainThread(
+      const Tile& /*tile*/,
+      int32_t /*overlayTextureCoordinateID*/,
+      const RasterOverlayTile& /*rasterTile*/,
+      void* /*pMainThreadRendererResources*/,
+      const glm::dvec2& /*translation*/,
+      const glm::dvec2& /*scale*/) override {}
+
+  virtual void detachRasterInMainThread(
+      const Tile& /*tile*/,
+      int32_t /*overlayTextureCoordinateID*/,
+      const RasterOverlayTile& /*rasterTile*/,
+      void* /*pMainThreadRendererResources*/) noexcept override {}
+};
+
+/**
+ * Creates a grid of views looking straight down from the given height over
+ * the given region, in radians, spaced so that their footprints on the
+ * ground cover all of it.
+ */
+std::vector<ViewState> createViews(
+    double west,
+    double south,
+    double east,
+    double north,
+    double height) {
+  const Ellipsoid& ellipsoid = Ellipsoid::WGS84;
+  const double radius = ellipsoid.getMaximumRadius();
+  const double footprint = 2.0 * height * glm::tan(ViewFieldOfView * 0.5);
+
+  const double midLatitude = (south + north) * 0.5;
+  const double widthMeters = (east - west) * radius * glm::cos(midLatitude);
+  const double heightMeters = (north - south) * radius;
+  const int32 columns =
+      FMath::Max(1, FMath::CeilToInt(float(widthMeters / footprint)));
+  const int32 rows =
+      FMath::Max(1, FMath::CeilToInt(float(heightMeters / footprint)));
+
+  std::vector<ViewState> views;
+  views.reserve(size_t(columns) * size_t(rows));
+
+  for (int32 row = 0; row < rows; ++row) {
+    const double latitude = south + (north - south) * (row + 0.5) / rows;
+    for (int32 column = 0; column < columns; ++column) {
+      const double longitude =
+          west + (east - west) * (column + 0.5) / columns;
+
+      const glm::dvec3 position = ellipsoid.cartographicToCartesian(
+          Cartographic(longitude, latitude, height));
+      const glm::dvec3 normal = ellipsoid.geodeticSurfaceNormal(position);
+      const glm::dvec3 eastDirection(
+          -glm::sin(longitude),
+          glm::cos(longitude),
+          0.0);
+      const glm::dvec3 northDirection =
+          glm::normalize(glm::cross(normal, eastDirection));
+
+      views.emplace_back(ViewState::create(
+          position,
+          -normal,
+          northDirection,
+          glm::dvec2(ViewportSize, ViewportSize),
+          ViewFieldOfView,
+          ViewFieldOfView,
+          ellipsoid));
+    }
+  }
+
+  return views;
+}
+} // namespace
+
+UCesiumCacheWarmingCommandlet::UCesiumCacheWarmingCommandlet() {
+  this->IsClient = false;
+  this->IsEditor = true;
+  this->IsServer = false;
+  this->LogToConsole = true;
+}
+
+int32 UCesiumCacheWarmingCommandlet::Main(const FString& Params) {
+  const TCHAR* pParams = *Params;
+
+  FString url;
+  uint32 ionAssetID = 0;
+  FString ionAccessToken =
+      GetDefault<UCesiumRuntimeSettings>()->DefaultIonAccessToken;
+  FParse::Value(pParams, TEXT("Url="), url);
+  FParse::Value(pParams, TEXT("IonAssetID="), ionAssetID);
+  FParse::Value(pParams, TEXT("IonAccessToken="), ionAccessToken);
+
+  double west = 0.0;
+  double south = 0.0;
+  double east = 0.0;
+  double north = 0.0;
+  if (!FParse::Value(pParams, TEXT("West="), west) ||
+      !FParse::Value(pParams, TEXT("South="), south) ||
+      !FParse::Value(pParams, TEXT("East="), east) ||
+      !FParse::Value(pParams, TEXT("North="), north) ||
+      (url.IsEmpty() && ionAssetID == 0)) {
+    UE_LOG(
+        LogCesiumEditor,
+        Error,
+        TEXT(
+            "Usage: -run=CesiumCacheWarming (-Url=<URL> | -IonAssetID=<ID>) "
+            "-West=<degrees> -South=<degrees> -East=<degrees> "
+            "-North=<degrees>"));
+    return 1;
+  }
+
+  double height = 1000.0;
+  double maximumScreenSpaceError = 16.0;
+  uint32 overlayIonAssetID = 0;
+  int32 parallelism = 40;
+  int32 viewsPerBatch = 16;
+  double timeout = 600.0;
+  FParse::Value(pParams, TEXT("Height="), height);
+  FParse::Value(
+      pParams,
+      TEXT("MaximumScreenSpaceError="),
+      maximumScreenSpaceError);
+  FParse::Value(pParams, TEXT("OverlayIonAssetID="), overlayIonAssetID);
+  FParse::Value(pParams, TEXT("Parallelism="), parallelism);
+  FParse::Value(pParams, TEXT("ViewsPerBatch="), viewsPerBatch);
+  FParse::Value(pParams, TEXT("Timeout="), timeout);
+  height = FMath::Max(height, 1.0);
+  parallelism = FMath::Max(parallelism, 1);
+  viewsPerBatch = FMath::Max(viewsPerBatch, 1);
+
+  const std::vector<ViewState> views = createViews(
+      glm::radians(west),
+      glm::radians(south),
+      glm::radians(east),
+      glm::radians(north),
+      height);
+
+  TilesetExternals externals{
+      getAssetAccessor(),
+      std::make_shared<HeadlessResourcePreparer>(),
+      getAsyncSystem(),
+      std::make_shared<CreditSystem>(),
+      spdlog::default_logger()};
+
+  TilesetOptions options;
+  options.maximumScreenSpaceError = maximumScreenSpaceError;
+  options.maximumSimultaneousTileLoads = uint32_t(parallelism);
+  options.enableFogCulling = false;
+  options.loadErrorCallback = [](const TilesetLoadFailureDetails& details) {
+    UE_LOG(
+        LogCesiumEditor,
+        Warning,
+        TEXT("%s"),
+        UTF8_TO_TCHAR(details.message.c_str()));
+  };
+
+  std::unique_ptr<Tileset> pTileset;
+  if (!url.IsEmpty()) {
+    pTileset =
+        std::make_unique<Tileset>(externals, TCHAR_TO_UTF8(*url), options);
+  } else {
+    pTileset = std::make_unique<Tileset>(
+        externals,
+        ionAssetID,
+        TCHAR_TO_UTF8(*ionAccessToken),
+        options);
+  }
+
+  if (overlayIonAssetID != 0) {
+    pTileset->getOverlays().add(std::make_unique<IonRasterOverlay>(
+        "Overlay",
+        overlayIonAssetID,
+        TCHAR_TO_UTF8(*ionAccessToken)));
+  }
+
+  const int32 batchCount =
+      (int32(views.size()) + viewsPerBatch - 1) / viewsPerBatch;
+  UE_LOG(
+      LogCesiumEditor,
+      Display,
+      TEXT("Warming the request cache from %d views in %d batches"),
+      int32(views.size()),
+      batchCount);
+
+  FHttpManager& httpManager = FHttpModule::Get().GetHttpManager();
+  bool timedOut = false;
+
+  for (int32 batch = 0; batch < batchCount; ++batch) {
+    const size_t first = size_t(batch) * size_t(viewsPerBatch);
+    const size_t last = std::min(views.size(), first + size_t(viewsPerBatch));
+    const std::vector<ViewState> batchViews(
+        views.begin() + first,
+        views.begin() + last);
+
+    const double startTime = FPlatformTime::Seconds();
+    double lastReportTime = startTime;
+    double lastTickTime = startTime;
+
+    // A batch is done once all of its tiles have been loaded for a few
+    // updates in a row, so that the tiles refined to after loading their
+    // parents are loaded too.
+    int32 completeUpdates = 0;
+    while (completeUpdates < 3) {
+      const double now = FPlatformTime::Seconds();
+      httpManager.Tick(float(now - lastTickTime));
+      lastTickTime = now;
+
+      pTileset->updateView(batchViews);
+      getAsyncSystem().dispatchMainThreadTasks();
+
+      const float progress = pTileset->computeLoadProgress();
+      completeUpdates = progress >= 100.0f ? completeUpdates + 1 : 0;
+
+      if (now - lastReportTime >= 1.0) {
+        UE_LOG(
+            LogCesiumEditor,
+            Display,
+            TEXT("Batch %d of %d: %.0f%% loaded"),
+            batch + 1,
+            batchCount,
+            progress);
+        lastReportTime = now;
+      }
+
+      if (now - startTime > timeout) {
+        UE_LOG(
+            LogCesiumEditor,
+            Warning,
+            TEXT("Batch %d of %d timed out at %.0f%% loaded"),
+            batch + 1,
+            batchCount,
+            progress);
+        timedOut = true;
+        break;
+      }
+
+      FPlatformProcess::Sleep(0.01f);
+    }
+  }
+
+  pTileset.reset();
+
+  UE_LOG(LogCesiumEditor, Display, TEXT("Finished warming the request cache"));
+  return timedOut ? 1 : 0;
+}
@@ -0,0 +1,35 @@
+// Copyright 2020-2021 CesiumGS, Inc. and Contributors
+
+#pragma once
+
+#include "Commandlets/Commandlet.h"
+#include "CoreMinimal.h"
+#include "CesiumCacheWarmingCommandlet.generated.h"
+
+/**
+ * Fills the request cache with the tiles, and raster overlay tiles, of a
+ * tileset that are needed to view a region at a given screen-space error,
+ * so that they can be loaded without network access later.
+ *
+ * The tileset is selected headlessly from a grid of views looking straight
+ * down over the region, a batch of views at a time, and all of its tiles are
+ * loaded through the same request cache used by Cesium3DTileset actors.
+ *
+ * Usage:
+ *
+ *   UnrealEditor-Cmd <Project> -run=CesiumCacheWarming
+ *     (-Url=<tileset.json URL> | -IonAssetID=<ID> [-IonAccessToken=<token>])
+ *     -West=<degrees> -South=<degrees> -East=<degrees> -North=<degrees>
+ *     [-Height=<meters>] [-MaximumScreenSpaceError=<pixels>]
+ *     [-OverlayIonAssetID=<ID>] [-Parallelism=<loads>]
+ *     [-ViewsPerBatch=<count>] [-Timeout=<seconds per batch>]
+ */
+UCLASS()
+class UCesiumCacheWarmingCommandlet : public UCommandlet {
+  GENERATED_BODY()
+
+public:
+  UCesiumCacheWarmingCommandlet();
+
+  virtual int32 Main(const FString& Params) override;
+};
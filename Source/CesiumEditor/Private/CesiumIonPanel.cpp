@@ -10,6 +10,7 @@
 #include "Editor.h"
 #include "EditorModeManager.h"
 #include "EngineUtils.h"
+#include "Framework/Application/SlateApplication.h"
 #include "Framework/MultiBox/MultiBoxBuilder.h"
 #include "IonLoginPanel.h"
 #include "IonQuickAddPanel.h"
@@ -29,6 +30,14 @@ static FName ColumnName_Name = "Name";
 static FName ColumnName_Type = "Type";
 static FName ColumnName_DateAdded = "DateAdded";
 
+// The time, in seconds, that the search text must stay the same before the
+// assets are searched for it.
+static constexpr double searchDelaySeconds = 0.3;
+
+// The number of rows from the end of the loaded assets at which the next
+// page is requested.
+static constexpr int32 rowsBeforeNextPage = 20;
+
 CesiumIonPanel::CesiumIonPanel()
     : _connectionUpdatedDelegateHandle(),
       _assetsUpdatedDelegateHandle(),
@@ -123,7 +132,7 @@ void CesiumIonPanel::Construct(const FArguments& InArgs) {
                     .Text(FText::FromString(TEXT("Refresh")))
                     .ToolTipText(FText::FromString(TEXT("Refresh the asset list")))
                     .OnClicked_Lambda([this]() {
-                      FCesiumEditorModule::ion().refreshAssets();
+                      FCesiumEditorModule::ion().invalidateAssetQueries();
                       Refresh();
                       return FReply::Handled();
                     })
@@ -156,7 +165,9 @@ void CesiumIonPanel::Construct(const FArguments& InArgs) {
         ];
   // clang-format on
 
-  FCesiumEditorModule::ion().refreshAssets();
+  // The first page of the assets comes from the cache of the session if the
+  // panel was opened before.
+  this->Refresh();
 }
 
 void CesiumIonPanel::OnSortChange(
@@ -180,7 +191,7 @@ void CesiumIonPanel::OnSortChange(
 
 void CesiumIonPanel::OnSearchTextChange(const FText& SearchText) {
   _searchString = SearchText.ToString().TrimStartAndEnd();
-  Refresh();
+  _searchChangedTime = FSlateApplication::Get().GetCurrentTime();
 }
 
 static bool isSupportedTileset(const TSharedPtr<Asset>& pAsset) {
@@ -330,87 +341,55 @@ TSharedRef<SWidget> CesiumIonPanel::AssetDetails() {
 }
 
 /**
- * @brief Returns a comparator for the property of an Asset that is
- * associated with the given column name.
+ * @brief Returns the field by which the ion server sorts the assets for
+ * the given column name.
  *
  * @param columnName The column name
- * @return The comparator, comparing is ascending order (comparing by
- * the asset->name by default, if the given column name was not known)
+ * @return The field (the asset name by default, if the given column name
+ * was not known)
  */
-static std::function<bool(const TSharedPtr<Asset>&, const TSharedPtr<Asset>&)>
-comparatorFor(const FName& columnName) {
+static std::string sortFieldFor(const FName& columnName) {
   if (columnName == ColumnName_Type) {
-    return [](const TSharedPtr<Asset>& a0, const TSharedPtr<Asset>& a1) {
-      return a0->type < a1->type;
-    };
+    return "TYPE";
   }
   if (columnName == ColumnName_DateAdded) {
-    return [](const TSharedPtr<Asset>& a0, const TSharedPtr<Asset>& a1) {
-      return a0->dateAdded < a1->dateAdded;
-    };
+    return "DATE_ADDED";
   }
-  return [](const TSharedPtr<Asset>& a0, const TSharedPtr<Asset>& a1) {
-    return a0->name < a1->name;
-  };
+  return "NAME";
 }
 
-void CesiumIonPanel::ApplyFilter() {
-
-  // UE_LOG(LogCesiumEditor, Warning, TEXT("ApplyFilter %s"), *_searchString);
-
-  if (_searchString.IsEmpty()) {
-    return;
-  }
-  this->_assets =
-      this->_assets.FilterByPredicate([this](const TSharedPtr<Asset>& Asset) {
-        // This mimics the behavior of the ion web UI, which
-        // searches for the given text in the name and description.
-        //
-        // Creating and using FString instances here instead of
-        // converting the _searchString to a std::string, because
-        // the 'FString::Contains' function does the desired
-        // case-INsensitive check by default.
-        FString Name = UTF8_TO_TCHAR(Asset->name.c_str());
-        if (Name.Contains(_searchString)) {
-          return true;
-        }
-        FString Description = UTF8_TO_TCHAR(Asset->description.c_str());
-        if (Description.Contains(_searchString)) {
-          return true;
-        }
-        return false;
-      });
-}
-
-void CesiumIonPanel::ApplySorting() {
-
-  // UE_LOG(LogCesiumEditor, Warning, TEXT("ApplySorting %s with %d"),
-  // *_sortColumnName.ToString(), _sortMode);
-
-  if (_sortMode == EColumnSortMode::Type::None) {
-    return;
-  }
-  auto baseComparator = comparatorFor(_sortColumnName);
-  if (_sortMode == EColumnSortMode::Type::Ascending) {
-    this->_assets.Sort(baseComparator);
-  } else {
-    this->_assets.Sort(
-        [&baseComparator](
-            const TSharedPtr<Asset>& a0,
-            const TSharedPtr<Asset>& a1) { return baseComparator(a1, a0); });
+CesiumIonSession::AssetQuery CesiumIonPanel::GetQuery() const {
+  CesiumIonSession::AssetQuery query;
+  query.search = TCHAR_TO_UTF8(*this->_searchString);
+  if (this->_sortMode != EColumnSortMode::Type::None) {
+    query.sortBy = sortFieldFor(this->_sortColumnName);
+    query.ascending = this->_sortMode == EColumnSortMode::Type::Ascending;
   }
+  return query;
 }
 
 void CesiumIonPanel::Refresh() {
-  const Assets& assets = FCesiumEditorModule::ion().getAssets();
-
-  this->_assets.SetNum(assets.items.size());
+  this->_searchChangedTime = 0.0;
+
+  const CesiumIonSession::AssetQuery query = this->GetQuery();
+  const CesiumIonSession::AssetQueryResult& result =
+      FCesiumEditorModule::ion().getAssetQuery(query);
+
+  // The assets that are already shown are kept, and only those of the pages
+  // that were loaded since are added, unless the query changed or its
+  // results were discarded.
+  if (query.search != this->_displayedQuery.search ||
+      query.sortBy != this->_displayedQuery.sortBy ||
+      query.ascending != this->_displayedQuery.ascending ||
+      result.items.size() < size_t(this->_assets.Num())) {
+    this->_assets.Reset();
+    this->_displayedQuery = query;
+  }
 
-  for (size_t i = 0; i < assets.items.size(); ++i) {
-    this->_assets[i] = MakeShared<Asset>(assets.items[i]);
+  this->_assets.Reserve(int32(result.items.size()));
+  for (size_t i = size_t(this->_assets.Num()); i < result.items.size(); ++i) {
+    this->_assets.Add(MakeShared<Asset>(result.items[i]));
   }
-  ApplyFilter();
-  ApplySorting();
   this->_pListView->RequestListRefresh();
 }
 
@@ -419,6 +398,13 @@ void CesiumIonPanel::Tick(
     const double InCurrentTime,
     const float InDeltaTime) {
   FCesiumEditorModule::ion().getAsyncSystem().dispatchMainThreadTasks();
+
+  // Each query is a request to the ion server, so none is made until the
+  // search text stops changing.
+  if (this->_searchChangedTime > 0.0 &&
+      InCurrentTime - this->_searchChangedTime >= searchDelaySeconds) {
+    this->Refresh();
+  }
   SCompoundWidget::Tick(AllottedGeometry, InCurrentTime, InDeltaTime);
 }
 
@@ -586,5 +572,10 @@ private:
 TSharedRef<ITableRow> CesiumIonPanel::CreateAssetRow(
     TSharedPtr<Asset> item,
     const TSharedRef<STableViewBase>& list) {
+  // The list view only generates the rows that are scrolled into view, so
+  // the next page of assets is requested when the last loaded ones are.
+  if (this->_assets.Num() - this->_assets.Find(item) <= rowsBeforeNextPage) {
+    FCesiumEditorModule::ion().loadMoreAssets(this->_displayedQuery);
+  }
   return SNew(AssetsTableRow, list, item);
 }
@@ -3,6 +3,7 @@
 #pragma once
 
 #include "CesiumIonClient/Assets.h"
+#include "CesiumIonSession.h"
 #include "Widgets/DeclarativeSyntaxSupport.h"
 #include "Widgets/Input/SSearchBox.h"
 #include "Widgets/SCompoundWidget.h"
@@ -45,17 +46,12 @@ private:
       ESelectInfo::Type selectionType);
 
   /**
-   * Filter the current _assets array, based on the current _searchString.
-   * This will replace the _assets array with one that only contains
-   * assets whose name or description contain the search string
+   * Gets the query of the ion assets for the current _searchString,
+   * _sortColumnName and _sortMode. The ion server searches, sorts and pages
+   * the assets, so the list view only ever holds the pages that were
+   * scrolled to.
    */
-  void ApplyFilter();
-
-  /**
-   * Sort the current _assets array, based on the current _sortColumnName
-   * and _sortMode, before using it to populate the list view.
-   */
-  void ApplySorting();
+  CesiumIonSession::AssetQuery GetQuery() const;
 
   /**
    * Will be called whenever one header of the asset list view is
@@ -69,7 +65,8 @@ private:
 
   /**
    * Will be called whenever the contents of the _SearchBox changes,
-   * store the corresponding _searchString, and refresh the view.
+   * store the corresponding _searchString, and refresh the view once
+   * the text stops changing for a moment.
    */
   void OnSearchTextChange(const FText& SearchText);
 
@@ -98,7 +95,18 @@ private:
   /**
    * The string that is currently entered in the SearchBox,
    * (trimmed from whitespace), used for filtering the asset
-   * list in ApplyFilter.
+   * list in GetQuery.
    */
   FString _searchString;
+
+  /**
+   * The time at which the _searchString last changed, if the view hasn't
+   * been refreshed for it yet, or 0.
+   */
+  double _searchChangedTime = 0.0;
+
+  /**
+   * The query whose assets are in the _assets array.
+   */
+  CesiumIonSession::AssetQuery _displayedQuery;
 };
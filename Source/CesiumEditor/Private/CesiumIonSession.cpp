@@ -1,10 +1,17 @@
 // Copyright 2020-2021 CesiumGS, Inc. and Contributors
 
 #include "CesiumIonSession.h"
+#include "CesiumAsync/IAssetRequest.h"
+#include "CesiumAsync/IAssetResponse.h"
+#include "CesiumEditor.h"
 #include "CesiumEditorSettings.h"
 #include "CesiumRuntimeSettings.h"
+#include "Dom/JsonObject.h"
+#include "GenericPlatform/GenericPlatformHttp.h"
 #include "HAL/PlatformProcess.h"
 #include "Misc/App.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
 
 using namespace CesiumAsync;
 using namespace CesiumIonClient;
@@ -111,6 +118,7 @@ void CesiumIonSession::disconnect() {
   this->_connection.reset();
   this->_profile.reset();
   this->_assets.reset();
+  this->invalidateAssetQueries();
   this->_tokens.reset();
 
   UCesiumEditorSettings* pSettings = GetMutableDefault<UCesiumEditorSettings>();
@@ -338,3 +346,200 @@ SharedFuture<Token> CesiumIonSession::getProjectDefaultTokenDetails() {
 void CesiumIonSession::invalidateProjectDefaultTokenDetails() {
   this->_projectDefaultTokenDetailsFuture.reset();
 }
+
+namespace {
+
+// The number of assets in each page of an asset query. This is the largest
+// page that the ion server returns.
+constexpr int32 assetsPerPage = 100;
+
+// The number of asset queries whose results are kept.
+constexpr size_t maximumCachedAssetQueries = 32;
+
+std::string getJsonString(const FJsonObject& json, const TCHAR* field) {
+  FString value;
+  json.TryGetStringField(field, value);
+  return TCHAR_TO_UTF8(*value);
+}
+
+std::optional<std::vector<Asset>>
+parseAssetPage(const CesiumAsync::IAssetResponse& response) {
+  const gsl::span<const std::byte> data = response.data();
+  const FUTF8ToTCHAR text(
+      reinterpret_cast<const ANSICHAR*>(data.data()),
+      int32(data.size()));
+
+  TSharedPtr<FJsonObject> pRoot;
+  TSharedRef<TJsonReader<>> pReader =
+      TJsonReaderFactory<>::Create(FString(text.Length(), text.Get()));
+  const TArray<TSharedPtr<FJsonValue>>* pItems = nullptr;
+  if (!FJsonSerializer::Deserialize(pReader, pRoot) || !pRoot ||
+      !pRoot->TryGetArrayField(TEXT("items"), pItems)) {
+    return std::nullopt;
+  }
+
+  std::vector<Asset> assets;
+  assets.reserve(pItems->Num());
+  for (const TSharedPtr<FJsonValue>& pItem : *pItems) {
+    const TSharedPtr<FJsonObject>* ppObject = nullptr;
+    if (!pItem || !pItem->TryGetObject(ppObject)) {
+      continue;
+    }
+
+    const FJsonObject& object = **ppObject;
+    Asset& asset = assets.emplace_back();
+    int64 id = 0;
+    object.TryGetNumberField(TEXT("id"), id);
+    asset.id = id;
+    asset.name = getJsonString(object, TEXT("name"));
+    asset.description = getJsonString(object, TEXT("description"));
+    asset.attribution = getJsonString(object, TEXT("attribution"));
+    asset.type = getJsonString(object, TEXT("type"));
+    int64 bytes = 0;
+    object.TryGetNumberField(TEXT("bytes"), bytes);
+    asset.bytes = bytes;
+    asset.dateAdded = getJsonString(object, TEXT("dateAdded"));
+    asset.status = getJsonString(object, TEXT("status"));
+    int32 percentComplete = 0;
+    object.TryGetNumberField(TEXT("percentComplete"), percentComplete);
+    asset.percentComplete = int8_t(percentComplete);
+  }
+  return assets;
+}
+
+} // namespace
+
+/*static*/ std::string
+CesiumIonSession::getAssetQueryKey(const AssetQuery& query) {
+  std::string key = "sortOrder=";
+  key += query.ascending ? "ASC" : "DESC";
+  if (!query.sortBy.empty()) {
+    key += "&sortBy=" + query.sortBy;
+  }
+  if (!query.search.empty()) {
+    key += "&search=";
+    key += TCHAR_TO_UTF8(
+        *FGenericPlatformHttp::UrlEncode(UTF8_TO_TCHAR(query.search.c_str())));
+  }
+  return key;
+}
+
+const CesiumIonSession::AssetQueryResult&
+CesiumIonSession::getAssetQuery(const AssetQuery& query) {
+  static const AssetQueryResult empty;
+  if (!this->_connection) {
+    return empty;
+  }
+
+  const std::string key = getAssetQueryKey(query);
+  auto it = this->_assetQueries.find(key);
+  if (it != this->_assetQueries.end()) {
+    return it->second;
+  }
+
+  // Drop the cached queries that aren't loading anything, rather than
+  // keeping every search that was ever typed.
+  if (this->_assetQueries.size() >= maximumCachedAssetQueries) {
+    for (auto cached = this->_assetQueries.begin();
+         cached != this->_assetQueries.end();) {
+      if (cached->second.isLoading) {
+        ++cached;
+      } else {
+        cached = this->_assetQueries.erase(cached);
+      }
+    }
+  }
+
+  this->requestAssetPage(key, query);
+  return this->_assetQueries[key];
+}
+
+void CesiumIonSession::loadMoreAssets(const AssetQuery& query) {
+  if (!this->_connection) {
+    return;
+  }
+
+  const std::string key = getAssetQueryKey(query);
+  auto it = this->_assetQueries.find(key);
+  if (it == this->_assetQueries.end()) {
+    this->getAssetQuery(query);
+  } else if (!it->second.isLoading && !it->second.isComplete) {
+    this->requestAssetPage(key, query);
+  }
+}
+
+void CesiumIonSession::invalidateAssetQueries() {
+  this->_assetQueries.clear();
+  ++this->_assetQueryGeneration;
+}
+
+void CesiumIonSession::requestAssetPage(
+    const std::string& key,
+    const AssetQuery& query) {
+  AssetQueryResult& result = this->_assetQueries[key];
+  result.isLoading = true;
+
+  // The assets endpoint of the ion REST API pages, sorts and searches the
+  // assets on the server, which the Connection of cesium-native doesn't
+  // expose.
+  const std::string url =
+      this->_connection->getApiUrl() + "/v1/assets?limit=" +
+      std::to_string(assetsPerPage) + "&page=" +
+      std::to_string(result.pagesLoaded + 1) + "&" + key;
+  const std::vector<IAssetAccessor::THeader> headers{
+      {"Accept", "application/json"},
+      {"Authorization", "Bearer " + this->_connection->getAccessToken()}};
+
+  this->_pAssetAccessor->requestAsset(this->_asyncSystem, url, headers)
+      .thenInMainThread(
+          [this, key, generation = this->_assetQueryGeneration](
+              std::shared_ptr<IAssetRequest>&& pRequest) {
+            if (generation != this->_assetQueryGeneration) {
+              return;
+            }
+
+            AssetQueryResult& result = this->_assetQueries[key];
+            result.isLoading = false;
+
+            const IAssetResponse* pResponse = pRequest->response();
+            std::optional<std::vector<Asset>> maybePage =
+                pResponse && pResponse->statusCode() >= 200 &&
+                        pResponse->statusCode() < 300
+                    ? parseAssetPage(*pResponse)
+                    : std::nullopt;
+            if (!maybePage) {
+              UE_LOG(
+                  LogCesiumEditor,
+                  Warning,
+                  TEXT("Could not load a page of Cesium ion assets from %s"),
+                  UTF8_TO_TCHAR(pRequest->url().c_str()));
+              result.isComplete = true;
+            } else {
+              ++result.pagesLoaded;
+              result.isComplete = maybePage->size() < size_t(assetsPerPage);
+              result.items.insert(
+                  result.items.end(),
+                  std::make_move_iterator(maybePage->begin()),
+                  std::make_move_iterator(maybePage->end()));
+            }
+
+            this->AssetsUpdated.Broadcast();
+          })
+      .catchInMainThread(
+          [this, key, generation = this->_assetQueryGeneration](
+              std::exception&& e) {
+            if (generation != this->_assetQueryGeneration) {
+              return;
+            }
+
+            UE_LOG(
+                LogCesiumEditor,
+                Warning,
+                TEXT("Could not load a page of Cesium ion assets: %s"),
+                UTF8_TO_TCHAR(e.what()));
+            AssetQueryResult& result = this->_assetQueries[key];
+            result.isLoading = false;
+            result.isComplete = true;
+            this->AssetsUpdated.Broadcast();
+          });
+}
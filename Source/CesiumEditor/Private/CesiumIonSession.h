@@ -7,7 +7,10 @@
 #include "CesiumAsync/SharedFuture.h"
 #include "CesiumIonClient/Connection.h"
 #include "Delegates/Delegate.h"
+#include <map>
 #include <memory>
+#include <string>
+#include <vector>
 
 DECLARE_MULTICAST_DELEGATE(FIonUpdated);
 
@@ -92,7 +95,80 @@ public:
 
   void invalidateProjectDefaultTokenDetails();
 
+  /**
+   * A search of the assets in the user's account, which the ion server pages
+   * and sorts, so that accounts with many assets can be browsed without
+   * listing all of them first.
+   */
+  struct AssetQuery {
+    /**
+     * The text to search for in the names and descriptions of the assets, or
+     * an empty string for all assets.
+     */
+    std::string search;
+
+    /**
+     * The field by which the ion server sorts the assets: "NAME", "TYPE" or
+     * "DATE_ADDED", or an empty string for the server's default order.
+     */
+    std::string sortBy;
+
+    /**
+     * Whether the assets are sorted in ascending order.
+     */
+    bool ascending = true;
+  };
+
+  /**
+   * The assets found so far by an AssetQuery.
+   */
+  struct AssetQueryResult {
+    /**
+     * The assets of the pages that are loaded, in order.
+     */
+    std::vector<CesiumIonClient::Asset> items;
+
+    /**
+     * Whether a page is being loaded.
+     */
+    bool isLoading = false;
+
+    /**
+     * Whether all the pages are loaded, or the last one failed to load.
+     */
+    bool isComplete = false;
+
+    /**
+     * The number of pages that are loaded.
+     */
+    int32 pagesLoaded = 0;
+  };
+
+  /**
+   * Gets the assets found so far by the given query. The results are cached,
+   * so that going back to an earlier query doesn't request its pages again,
+   * until invalidateAssetQueries is called. If the first page of the query
+   * isn't loaded yet, it is requested and AssetsUpdated is broadcast once it
+   * is.
+   */
+  const AssetQueryResult& getAssetQuery(const AssetQuery& query);
+
+  /**
+   * Requests the next page of the given query, unless one is already being
+   * loaded or all of them are. AssetsUpdated is broadcast once it is loaded.
+   */
+  void loadMoreAssets(const AssetQuery& query);
+
+  /**
+   * Discards the cached results of the asset queries, so that their pages
+   * are requested again when they are next used.
+   */
+  void invalidateAssetQueries();
+
 private:
+  static std::string getAssetQueryKey(const AssetQuery& query);
+  void requestAssetPage(const std::string& key, const AssetQuery& query);
+
   CesiumAsync::AsyncSystem _asyncSystem;
   std::shared_ptr<CesiumAsync::IAssetAccessor> _pAssetAccessor;
 
@@ -104,6 +180,12 @@ private:
   std::optional<CesiumAsync::SharedFuture<CesiumIonClient::Token>>
       _projectDefaultTokenDetailsFuture;
 
+  // The results of the asset queries, by getAssetQueryKey. The generation is
+  // incremented when they are discarded, so that the pages that were being
+  // loaded for them are ignored.
+  std::map<std::string, AssetQueryResult> _assetQueries;
+  int32 _assetQueryGeneration = 0;
+
   bool _isConnecting;
   bool _isResuming;
   bool _isLoadingProfile;
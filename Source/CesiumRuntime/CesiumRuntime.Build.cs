@@ -138,7 +138,10 @@ public class CesiumRuntime : ModuleRules
                 "MeshDescription",
                 "StaticMeshDescription",
                 "HTTP",
+                "Json",
                 "LevelSequence",
+                "MovieScene",
+                "MovieSceneTracks",
                 "Projects",
                 "RenderCore",
                 "SunPosition",
@@ -146,6 +149,9 @@ public class CesiumRuntime : ModuleRules
             }
         );
 
+        // Responses are decompressed with the engine's zlib.
+        AddEngineThirdPartyPrivateStaticDependencies(Target, "zlib");
+
         // Use UE's MikkTSpace on non-Android
         if (Target.Platform != UnrealTargetPlatform.Android)
         {
@@ -175,6 +181,18 @@ public class CesiumRuntime : ModuleRules
             PrivateDependencyModuleNames.Add("Chaos");
         }
 
+        // Nanite resources can only be built at runtime in the editor, which
+        // is the only place the Nanite builder is available.
+        if (Target.bBuildEditor == true && Target.Version.MajorVersion >= 5)
+        {
+            PrivateDependencyModuleNames.Add("NaniteBuilder");
+            PrivateDefinitions.Add("CESIUM_BUILD_NANITE=1");
+        }
+        else
+        {
+            PrivateDefinitions.Add("CESIUM_BUILD_NANITE=0");
+        }
+
         if (Target.bBuildEditor == true)
         {
             PublicDependencyModuleNames.AddRange(
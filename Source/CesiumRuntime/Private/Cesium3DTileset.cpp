@@ -2,6 +2,7 @@
 
 #include "Cesium3DTileset.h"
 #include "Async/Async.h"
+#include "Async/ParallelFor.h"
 #include "Camera/CameraTypes.h"
 #include "Camera/PlayerCameraManager.h"
 #include "Cesium3DTilesSelection/BingMapsRasterOverlay.h"
@@ -13,54 +14,87 @@
 #include "Cesium3DTilesSelection/TilesetOptions.h"
 #include "Cesium3DTilesetLoadFailureDetails.h"
 #include "Cesium3DTilesetRoot.h"
-#include "CesiumAsync/CachingAssetAccessor.h"
 #include "CesiumAsync/IAssetResponse.h"
-#include "CesiumAsync/SqliteCache.h"
 #include "CesiumCamera.h"
 #include "CesiumCameraManager.h"
+#include "CesiumCartographicPolygon.h"
+#include "CesiumConvertedModel.h"
+#include "CesiumConvertedModelCache.h"
 #include "CesiumCustomVersion.h"
+#include "CesiumDistanceField.h"
+#include "CesiumFarFieldProxy.h"
+#include "CesiumFeatureIndex.h"
 #include "CesiumGeospatial/Cartographic.h"
 #include "CesiumGeospatial/Ellipsoid.h"
 #include "CesiumGeospatial/Transforms.h"
+#include "CesiumGltf/ExtensionModelExtFeatureMetadata.h"
 #include "CesiumGltf/ImageCesium.h"
 #include "CesiumGltf/Ktx2TranscodeTargets.h"
+#include "CesiumGltf/Model.h"
 #include "CesiumGltfComponent.h"
 #include "CesiumGltfPrimitiveComponent.h"
+#include "CesiumGltfPrimitivePool.h"
 #include "CesiumLifetime.h"
+#include "CesiumMemoryPressure.h"
+#include "CesiumMeshoptDecoder.h"
+#include "CesiumOcclusionTileExcluder.h"
+#include "CesiumPipelinePrecache.h"
+#include "CesiumPolygonTileExcluder.h"
 #include "CesiumRasterOverlay.h"
 #include "CesiumRuntime.h"
 #include "CesiumRuntimeSettings.h"
+#include "CesiumRuntimeStats.h"
+#include "CesiumScreenSpaceErrorController.h"
+#include "CesiumSequencePreload.h"
+#include "CesiumTexturePool.h"
 #include "CesiumTextureUtility.h"
+#include "CesiumTileBatchComponent.h"
+#include "CesiumTileLoadController.h"
+#include "CesiumTileLoadScheduler.h"
+#include "CesiumTileSnapshot.h"
+#include "CesiumTileTrace.h"
 #include "CesiumTransforms.h"
-#include "Components/SceneCaptureComponent2D.h"
+#include "CesiumTriangleBVH.h"
+#include "CesiumUtility/Tracing.h"
+#include "CesiumWaterMaskAtlas.h"
 #include "CreateModelOptions.h"
 #include "Engine/Engine.h"
 #include "Engine/GameViewportClient.h"
-#include "Engine/SceneCapture2D.h"
+#include "Engine/StaticMesh.h"
 #include "Engine/Texture.h"
 #include "Engine/Texture2D.h"
-#include "Engine/TextureRenderTarget2D.h"
 #include "Engine/World.h"
 #include "EngineUtils.h"
 #include "GameFramework/Controller.h"
+#include "GameFramework/Pawn.h"
 #include "GameFramework/PlayerController.h"
-#include "HAL/FileManager.h"
 #include "HttpModule.h"
 #include "IPhysXCookingModule.h"
+#if CESIUM_BUILD_NANITE
+#include "NaniteBuilder.h"
+#endif
 #include "Kismet/GameplayStatics.h"
 #include "LevelSequenceActor.h"
+#include "Materials/MaterialInterface.h"
 #include "Math/UnrealMathUtility.h"
 #include "Misc/EnumRange.h"
+#include "Misc/ScopeExit.h"
 #include "PhysicsPublicCore.h"
 #include "PixelFormat.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "RenderUtils.h"
+#include "StaticMeshResources.h"
 #include "StereoRendering.h"
-#include "UnrealAssetAccessor.h"
-#include "UnrealTaskProcessor.h"
+#include "UObject/GCObject.h"
 #include <glm/ext/matrix_transform.hpp>
 #include <glm/gtc/matrix_inverse.hpp>
+#include <algorithm>
+#include <atomic>
 #include <glm/trigonometric.hpp>
+#include <limits>
 #include <memory>
 #include <spdlog/spdlog.h>
+#include <unordered_set>
 
 FCesium3DTilesetLoadFailure OnCesium3DTilesetLoadFailure{};
 
@@ -77,6 +111,7 @@ ACesium3DTileset::ACesium3DTileset()
       CreditSystem(nullptr),
 
       _pTileset(nullptr),
+      _pResourcePreparer(nullptr),
 
       _lastTilesRendered(0),
       _lastTilesLoadingLowPriority(0),
@@ -87,6 +122,10 @@ ACesium3DTileset::ACesium3DTileset()
       _lastTilesCulled(0),
       _lastMaxDepthVisited(0),
 
+      _lastLoadProgress(0.0f),
+      _lastLoadComplete(false),
+      _lastNumberOfTilesRendered(0),
+
       _captureMovieMode{false},
       _beforeMoviePreloadAncestors{PreloadAncestors},
       _beforeMoviePreloadSiblings{PreloadSiblings},
@@ -256,6 +295,13 @@ void ACesium3DTileset::SetIonAssetEndpointUrl(
   }
 }
 
+void ACesium3DTileset::SetShareTileset(bool bShareTileset) {
+  if (this->ShareTileset != bShareTileset) {
+    this->ShareTileset = bShareTileset;
+    this->DestroyTileset();
+  }
+}
+
 void ACesium3DTileset::SetCreatePhysicsMeshes(bool bCreatePhysicsMeshes) {
   if (this->CreatePhysicsMeshes != bCreatePhysicsMeshes) {
     this->CreatePhysicsMeshes = bCreatePhysicsMeshes;
@@ -263,6 +309,89 @@ void ACesium3DTileset::SetCreatePhysicsMeshes(bool bCreatePhysicsMeshes) {
   }
 }
 
+void ACesium3DTileset::SetCollisionOnly(bool bCollisionOnly) {
+  if (this->CollisionOnly != bCollisionOnly) {
+    this->CollisionOnly = bCollisionOnly;
+    this->DestroyTileset();
+  }
+}
+
+void ACesium3DTileset::SetCollisionOnlyViewportSize(
+    float InCollisionOnlyViewportSize) {
+  if (this->CollisionOnlyViewportSize != InCollisionOnlyViewportSize) {
+    this->CollisionOnlyViewportSize = InCollisionOnlyViewportSize;
+    this->_viewUpdateNeeded = true;
+  }
+}
+
+void ACesium3DTileset::SetCollisionRadius(float InCollisionRadius) {
+  if (this->CollisionRadius != InCollisionRadius) {
+    // Switching between deferred and immediate cooking requires reloading
+    // the tiles.
+    bool wasDeferred = this->CollisionRadius > 0.0f;
+    this->CollisionRadius = InCollisionRadius;
+    if (wasDeferred != (this->CollisionRadius > 0.0f)) {
+      this->DestroyTileset();
+    }
+  }
+}
+
+void ACesium3DTileset::AddCollisionSource(AActor* Actor) {
+  if (Actor) {
+    this->_collisionSources.AddUnique(Actor);
+  }
+}
+
+void ACesium3DTileset::RemoveCollisionSource(AActor* Actor) {
+  this->_collisionSources.Remove(Actor);
+}
+
+void ACesium3DTileset::SetCollisionSimplificationError(
+    float InCollisionSimplificationError) {
+  if (this->CollisionSimplificationError != InCollisionSimplificationError) {
+    this->CollisionSimplificationError = InCollisionSimplificationError;
+    this->DestroyTileset();
+  }
+}
+
+void ACesium3DTileset::SetFarFieldSimplificationError(
+    float InFarFieldSimplificationError) {
+  if (this->FarFieldSimplificationError != InFarFieldSimplificationError) {
+    this->FarFieldSimplificationError = InFarFieldSimplificationError;
+    this->DestroyTileset();
+  }
+}
+
+void ACesium3DTileset::SetFarFieldDistance(float InFarFieldDistance) {
+  if (this->FarFieldDistance != InFarFieldDistance) {
+    this->FarFieldDistance = InFarFieldDistance;
+    this->_viewUpdateNeeded = true;
+  }
+}
+
+void ACesium3DTileset::SetFarFieldGeometricError(
+    float InFarFieldGeometricError) {
+  if (this->FarFieldGeometricError != InFarFieldGeometricError) {
+    this->FarFieldGeometricError = InFarFieldGeometricError;
+    this->_viewUpdateNeeded = true;
+  }
+}
+
+void ACesium3DTileset::SetFarFieldUpdateInterval(
+    float InFarFieldUpdateInterval) {
+  if (this->FarFieldUpdateInterval != InFarFieldUpdateInterval) {
+    this->FarFieldUpdateInterval = InFarFieldUpdateInterval;
+    this->_viewUpdateNeeded = true;
+  }
+}
+
+void ACesium3DTileset::SetFarFieldMaterial(UMaterialInterface* InMaterial) {
+  if (this->FarFieldMaterial != InMaterial) {
+    this->FarFieldMaterial = InMaterial;
+    this->updateFarFieldMaterial();
+  }
+}
+
 void ACesium3DTileset::SetAlwaysIncludeTangents(bool bAlwaysIncludeTangents) {
   if (this->AlwaysIncludeTangents != bAlwaysIncludeTangents) {
     this->AlwaysIncludeTangents = bAlwaysIncludeTangents;
@@ -270,6 +399,129 @@ void ACesium3DTileset::SetAlwaysIncludeTangents(bool bAlwaysIncludeTangents) {
   }
 }
 
+void ACesium3DTileset::SetHighPrecisionVertexAttributes(
+    bool bHighPrecisionVertexAttributes) {
+  if (this->HighPrecisionVertexAttributes != bHighPrecisionVertexAttributes) {
+    this->HighPrecisionVertexAttributes = bHighPrecisionVertexAttributes;
+    this->DestroyTileset();
+  }
+}
+
+void ACesium3DTileset::SetComputeFlatNormalsInMaterial(
+    bool bComputeFlatNormalsInMaterial) {
+  if (this->ComputeFlatNormalsInMaterial != bComputeFlatNormalsInMaterial) {
+    this->ComputeFlatNormalsInMaterial = bComputeFlatNormalsInMaterial;
+    this->DestroyTileset();
+  }
+}
+
+void ACesium3DTileset::SetOptimizeMeshes(bool bOptimizeMeshes) {
+  if (this->OptimizeMeshes != bOptimizeMeshes) {
+    this->OptimizeMeshes = bOptimizeMeshes;
+    this->DestroyTileset();
+  }
+}
+
+void ACesium3DTileset::SetMergePrimitives(bool bMergePrimitives) {
+  if (this->MergePrimitives != bMergePrimitives) {
+    this->MergePrimitives = bMergePrimitives;
+    this->DestroyTileset();
+  }
+}
+
+void ACesium3DTileset::SetBuildNaniteMeshes(bool bBuildNaniteMeshes) {
+  if (this->BuildNaniteMeshes != bBuildNaniteMeshes) {
+    this->BuildNaniteMeshes = bBuildNaniteMeshes;
+    this->DestroyTileset();
+  }
+}
+
+void ACesium3DTileset::SetUseBatchedRendering(bool bUseBatchedRendering) {
+  if (this->UseBatchedRendering != bUseBatchedRendering) {
+    this->UseBatchedRendering = bUseBatchedRendering;
+    this->DestroyTileset();
+  }
+}
+
+void ACesium3DTileset::SetRenderTerrainAsHeightfields(
+    bool bRenderTerrainAsHeightfields) {
+  if (this->RenderTerrainAsHeightfields != bRenderTerrainAsHeightfields) {
+    this->RenderTerrainAsHeightfields = bRenderTerrainAsHeightfields;
+    this->DestroyTileset();
+  }
+}
+
+void ACesium3DTileset::SetStreamTileTextures(bool bStreamTileTextures) {
+  if (this->StreamTileTextures != bStreamTileTextures) {
+    this->StreamTileTextures = bStreamTileTextures;
+    this->DestroyTileset();
+  }
+}
+
+void ACesium3DTileset::SetMaximumTextureSize(int32 InMaximumTextureSize) {
+  if (this->MaximumTextureSize != InMaximumTextureSize) {
+    this->MaximumTextureSize = InMaximumTextureSize;
+    this->DestroyTileset();
+  }
+}
+
+void ACesium3DTileset::SetMetadataTextureProperties(
+    const TArray<FString>& Properties) {
+  if (this->MetadataTextureProperties != Properties) {
+    this->MetadataTextureProperties = Properties;
+    this->DestroyTileset();
+  }
+}
+
+void ACesium3DTileset::SetEnableFeatureIndex(bool bEnableFeatureIndex) {
+  if (this->EnableFeatureIndex != bEnableFeatureIndex) {
+    this->EnableFeatureIndex = bEnableFeatureIndex;
+    this->DestroyTileset();
+  }
+}
+
+void ACesium3DTileset::SetEnableGeometryQueries(bool bEnableGeometryQueries) {
+  if (this->EnableGeometryQueries != bEnableGeometryQueries) {
+    this->EnableGeometryQueries = bEnableGeometryQueries;
+    this->DestroyTileset();
+  }
+}
+
+void ACesium3DTileset::SetEnableMeshDistanceFields(
+    bool bEnableMeshDistanceFields) {
+  if (this->EnableMeshDistanceFields != bEnableMeshDistanceFields) {
+    this->EnableMeshDistanceFields = bEnableMeshDistanceFields;
+    this->DestroyTileset();
+  }
+}
+
+void ACesium3DTileset::SetMeshDistanceFieldRadius(
+    float InMeshDistanceFieldRadius) {
+  if (this->MeshDistanceFieldRadius != InMeshDistanceFieldRadius) {
+    this->MeshDistanceFieldRadius = InMeshDistanceFieldRadius;
+    this->_viewUpdateNeeded = true;
+  }
+}
+
+void ACesium3DTileset::SetMeshDistanceFieldResolution(
+    int32 InMeshDistanceFieldResolution) {
+  if (this->MeshDistanceFieldResolution != InMeshDistanceFieldResolution) {
+    // Only the distance fields built from now on use the new resolution.
+    this->MeshDistanceFieldResolution = InMeshDistanceFieldResolution;
+    this->_viewUpdateNeeded = true;
+  }
+}
+
+void ACesium3DTileset::SetMaximumMeshDistanceFieldBuildsPerFrame(
+    int32 InMaximumMeshDistanceFieldBuildsPerFrame) {
+  if (this->MaximumMeshDistanceFieldBuildsPerFrame !=
+      InMaximumMeshDistanceFieldBuildsPerFrame) {
+    this->MaximumMeshDistanceFieldBuildsPerFrame =
+        InMaximumMeshDistanceFieldBuildsPerFrame;
+    this->_viewUpdateNeeded = true;
+  }
+}
+
 void ACesium3DTileset::SetGenerateSmoothNormals(bool bGenerateSmoothNormals) {
   if (this->GenerateSmoothNormals != bGenerateSmoothNormals) {
     this->GenerateSmoothNormals = bGenerateSmoothNormals;
@@ -284,17 +536,72 @@ void ACesium3DTileset::SetEnableWaterMask(bool bEnableMask) {
   }
 }
 
+void ACesium3DTileset::SetPackWaterMasks(bool bPackWaterMasks) {
+  if (this->PackWaterMasks != bPackWaterMasks) {
+    this->PackWaterMasks = bPackWaterMasks;
+    this->DestroyTileset();
+  }
+}
+
 void ACesium3DTileset::SetMaterial(UMaterialInterface* InMaterial) {
   if (this->Material != InMaterial) {
     this->Material = InMaterial;
-    this->DestroyTileset();
+    this->UpdateTileMaterials();
   }
 }
 
 void ACesium3DTileset::SetWaterMaterial(UMaterialInterface* InMaterial) {
   if (this->WaterMaterial != InMaterial) {
     this->WaterMaterial = InMaterial;
-    this->DestroyTileset();
+    this->UpdateTileMaterials();
+  }
+}
+
+void ACesium3DTileset::SetMaximumShadowDistance(float InMaximumShadowDistance) {
+  if (this->MaximumShadowDistance != InMaximumShadowDistance) {
+    this->MaximumShadowDistance = InMaximumShadowDistance;
+    this->_viewUpdateNeeded = true;
+  }
+}
+
+void ACesium3DTileset::SetMaximumShadowGeometricError(
+    float InMaximumShadowGeometricError) {
+  if (this->MaximumShadowGeometricError != InMaximumShadowGeometricError) {
+    this->MaximumShadowGeometricError = InMaximumShadowGeometricError;
+    this->_viewUpdateNeeded = true;
+  }
+}
+
+void ACesium3DTileset::SetMaximumRayTracingDistance(
+    float InMaximumRayTracingDistance) {
+  if (this->MaximumRayTracingDistance != InMaximumRayTracingDistance) {
+    this->MaximumRayTracingDistance = InMaximumRayTracingDistance;
+    this->_viewUpdateNeeded = true;
+  }
+}
+
+void ACesium3DTileset::SetMaximumRayTracingGeometricError(
+    float InMaximumRayTracingGeometricError) {
+  if (this->MaximumRayTracingGeometricError !=
+      InMaximumRayTracingGeometricError) {
+    this->MaximumRayTracingGeometricError = InMaximumRayTracingGeometricError;
+    this->_viewUpdateNeeded = true;
+  }
+}
+
+void ACesium3DTileset::SetMaximumRayTracingTilesPerFrame(
+    int32 InMaximumRayTracingTilesPerFrame) {
+  if (this->MaximumRayTracingTilesPerFrame !=
+      InMaximumRayTracingTilesPerFrame) {
+    this->MaximumRayTracingTilesPerFrame = InMaximumRayTracingTilesPerFrame;
+    this->_viewUpdateNeeded = true;
+  }
+}
+
+void ACesium3DTileset::SetTileCullDistanceScale(float InTileCullDistanceScale) {
+  if (this->TileCullDistanceScale != InTileCullDistanceScale) {
+    this->TileCullDistanceScale = InTileCullDistanceScale;
+    this->_viewUpdateNeeded = true;
   }
 }
 
@@ -302,7 +609,16 @@ void ACesium3DTileset::SetCustomDepthParameters(
     FCustomDepthParameters InCustomDepthParameters) {
   if (this->CustomDepthParameters != InCustomDepthParameters) {
     this->CustomDepthParameters = InCustomDepthParameters;
-    this->DestroyTileset();
+    this->UpdateTileCustomDepthParameters();
+  }
+}
+
+void ACesium3DTileset::UpdateTileCollisionSettings() {
+  TArray<UCesiumGltfComponent*> gltfComponents;
+  this->GetComponents<UCesiumGltfComponent>(gltfComponents);
+
+  for (UCesiumGltfComponent* pGltf : gltfComponents) {
+    pGltf->SetCollisionSettings(this->BodyInstance);
   }
 }
 
@@ -470,6 +786,9 @@ void ACesium3DTileset::UpdateTransformFromCesium() {
   for (UCesiumGltfComponent* pGltf : gltfComponents) {
     pGltf->UpdateTransformFromCesium(CesiumToUnreal);
   }
+
+  // The far-field proxy has the old transform baked into its vertices.
+  this->resetFarField();
 }
 
 // Called when the game starts or when spawned
@@ -479,10 +798,12 @@ void ACesium3DTileset::BeginPlay() {
   this->LoadTileset();
 
   // Search for level sequence.
+  this->_levelSequenceActors.Reset();
   for (auto sequenceActorIt = TActorIterator<ALevelSequenceActor>(GetWorld());
        sequenceActorIt;
        ++sequenceActorIt) {
     ALevelSequenceActor* sequenceActor = *sequenceActorIt;
+    this->_levelSequenceActors.Add(sequenceActor);
 
     FScriptDelegate playMovieSequencerDelegate;
     playMovieSequencerDelegate.BindUFunction(this, FName("PlayMovieSequencer"));
@@ -541,35 +862,214 @@ void ACesium3DTileset::NotifyHit(
   // std::cout << "Hit face index 2: " << detailedHit.FaceIndex << std::endl;
 }
 
+/**
+ * Whether the given material has the "heightfieldPositions" texture
+ * parameter, in itself or in one of its layers, which it needs to displace
+ * the grid that heightfields are drawn with.
+ */
+static bool materialSupportsHeightfields(const UMaterialInterface* pMaterial) {
+  if (!pMaterial) {
+    return false;
+  }
+  TArray<FMaterialParameterInfo> parameters;
+  TArray<FGuid> ids;
+  pMaterial->GetAllTextureParameterInfo(parameters, ids);
+  return parameters.ContainsByPredicate(
+      [](const FMaterialParameterInfo& parameter) {
+        return parameter.Name == TEXT("heightfieldPositions");
+      });
+}
+
+/**
+ * Frees the decoded images and, unless feature metadata refers to them, the
+ * buffers of a model whose Unreal objects have been created. The rest of the
+ * model stays valid, with empty data.
+ */
+static void releaseModelData(CesiumGltf::Model& model) {
+  CESIUM_TRACE("releaseModelData");
+
+  for (CesiumGltf::Image& image : model.images) {
+    std::vector<std::byte>().swap(image.cesium.pixelData);
+    image.cesium.mipPositions.clear();
+  }
+
+  // The metadata of the primitives holds views into the buffers.
+  if (model.getExtension<CesiumGltf::ExtensionModelExtFeatureMetadata>()) {
+    return;
+  }
+
+  for (CesiumGltf::Buffer& buffer : model.buffers) {
+    std::vector<std::byte>().swap(buffer.cesium.data);
+  }
+}
+
 class UnrealResourcePreparer
-    : public Cesium3DTilesSelection::IPrepareRendererResources {
+    : public Cesium3DTilesSelection::IPrepareRendererResources,
+      public FGCObject {
 public:
-  UnrealResourcePreparer(ACesium3DTileset* pActor)
-      : _pActor(pActor)
+  UnrealResourcePreparer(
+      ACesium3DTileset* pActor,
+      UCesiumTileBatchComponent* pTileBatch)
+      : _pActor(pActor),
+        _pTileBatch(pTileBatch)
 #if PHYSICS_INTERFACE_PHYSX
         ,
         _pPhysXCooking(
             pActor->GetCreatePhysicsMeshes()
                 ? GetPhysXCookingModule()->GetPhysXCooking()
                 : nullptr)
+#endif
+#if CESIUM_BUILD_NANITE
+        ,
+        _pNaniteBuilder(
+            pActor->GetBuildNaniteMeshes() ? &INaniteBuilderModule::Get()
+                                           : nullptr)
 #endif
   {
+    if (pActor->UseWarmStartSnapshot) {
+      const FString source =
+          pActor->GetTilesetSource() == ETilesetSource::FromUrl
+              ? pActor->GetUrl()
+              : FString::Printf(TEXT("ion:%lld"), pActor->GetIonAssetID());
+      this->_pSnapshot = std::make_unique<CesiumTileSnapshot>(
+          CesiumTileSnapshot::getDirectory(pActor->GetName(), source));
+    }
+
+    // Without a material that displaces the grid, heightfields would be
+    // drawn flat, so the tiles are converted into meshes instead.
+    if (pActor->GetRenderTerrainAsHeightfields()) {
+      const UCesiumGltfComponent* pDefaults =
+          GetDefault<UCesiumGltfComponent>();
+      const UMaterialInterface* pMaterial = pActor->GetMaterial()
+                                                ? pActor->GetMaterial()
+                                                : pDefaults->BaseMaterial;
+      const UMaterialInterface* pWaterMaterial =
+          pActor->GetWaterMaterial() ? pActor->GetWaterMaterial()
+                                     : pDefaults->BaseMaterialWithWater;
+      this->_renderHeightfields =
+          materialSupportsHeightfields(pMaterial) &&
+          (!pActor->GetEnableWaterMask() ||
+           materialSupportsHeightfields(pWaterMaterial));
+      if (!this->_renderHeightfields) {
+        UE_LOG(
+            LogCesium,
+            Warning,
+            TEXT("Tileset %s draws its terrain as meshes rather than heightfields, because its material has no \"heightfieldPositions\" texture parameter"),
+            *pActor->GetName());
+      }
+    }
   }
 
   virtual void* prepareInLoadThread(
       const CesiumGltf::Model& model,
       const glm::dmat4& transform) override {
 
+    // cesium-native doesn't decode EXT_meshopt_compression, so it is decoded
+    // here, before the model is converted. cesium-native has already read
+    // the still-compressed buffers by now to generate the raster overlay
+    // texture coordinates, so these tiles don't receive raster overlays, see
+    // warnIfMeshoptWithOverlays.
+    if (std::find(
+            model.extensionsUsed.begin(),
+            model.extensionsUsed.end(),
+            "EXT_meshopt_compression") != model.extensionsUsed.end()) {
+      CesiumMeshoptDecoder::decodeModel(const_cast<CesiumGltf::Model&>(model));
+    }
+
     CreateModelOptions options;
     options.pModel = &model;
     options.alwaysIncludeTangents = this->_pActor->GetAlwaysIncludeTangents();
+    options.highPrecisionVertexAttributes =
+        this->_pActor->GetHighPrecisionVertexAttributes();
+    options.flatNormalsInMaterial =
+        this->_pActor->GetComputeFlatNormalsInMaterial();
+    options.optimizeMeshes = this->_pActor->GetOptimizeMeshes();
+    options.mergePrimitives = this->_pActor->GetMergePrimitives();
+    options.streamTextures = this->_pActor->GetStreamTileTextures();
+    if (this->_pActor->GetMaximumTextureSize() > 0) {
+      // The size is for the default maximum screen-space error of 16.
+      options.maximumTextureSize = FMath::Max(
+          FMath::RoundToInt(
+              this->_pActor->GetMaximumTextureSize() * 16.0f /
+              FMath::Max(this->_pActor->MaximumScreenSpaceError, 1.0f)),
+          1);
+    }
+    options.metadataTextureProperties =
+        this->_pActor->GetMetadataTextureProperties();
+    options.buildFeatureIndex = this->_pActor->GetEnableFeatureIndex();
+    // Mesh distance fields are built from the geometry query hierarchies.
+    options.buildGeometryQueries =
+        this->_pActor->GetEnableGeometryQueries() ||
+        (this->_pActor->GetEnableMeshDistanceFields() &&
+         CesiumDistanceField::IsSupported);
+    options.collisionOnly = this->_pActor->GetCollisionOnly();
+    options.renderHeightfields = this->_renderHeightfields;
+    options.deferPhysicsMeshes = this->_pActor->GetCollisionRadius() > 0.0f;
+    options.collisionSimplificationError =
+        this->_pActor->GetCollisionSimplificationError();
+    options.farFieldSimplificationError =
+        options.collisionOnly
+            ? 0.0
+            : this->_pActor->GetFarFieldSimplificationError();
+    options.packWaterMasks = this->_pActor->GetPackWaterMasks();
+    options.pCanceled = &this->_canceled;
 
 #if PHYSICS_INTERFACE_PHYSX
     options.pPhysXCooking = this->_pPhysXCooking;
 #endif
+#if CESIUM_BUILD_NANITE
+    options.pNaniteBuilder = this->_pNaniteBuilder;
+#endif
+
+    TRACE_CPUPROFILER_EVENT_SCOPE(Cesium_PrepareInLoadThread);
+    const uint64 traceKey = CesiumTileTrace::getModelKey(model);
+    CesiumTileTrace::recordStage(
+        CesiumTileTrace::Stage::LoadThreadStarted,
+        traceKey);
+
+    const double startTime = FPlatformTime::Seconds();
+
+    // The model is restored from the snapshot or the converted model cache
+    // when one of them has its key, and written to them otherwise.
+    CesiumConvertedModelCache* pCache = CesiumConvertedModelCache::get();
+    const bool useConvertedModels = this->_pSnapshot || pCache;
+    uint64 convertedModelKey = 0;
+    TArray<uint8> convertedModel;
+    bool inSnapshot = false;
+    bool inCache = false;
+    if (useConvertedModels) {
+      convertedModelKey =
+          CesiumConvertedModel::computeKey(model, transform, options);
+      inSnapshot = this->_pSnapshot &&
+                   this->_pSnapshot->find(convertedModelKey, convertedModel);
+      inCache = !inSnapshot && pCache &&
+                pCache->find(convertedModelKey, convertedModel);
+      if (inSnapshot || inCache) {
+        options.pConvertedModel = &convertedModel;
+      } else {
+        options.pWrittenConvertedModel = &convertedModel;
+      }
+    }
 
     std::unique_ptr<UCesiumGltfComponent::HalfConstructed> pHalf =
         UCesiumGltfComponent::CreateOffGameThread(transform, options);
+    CesiumRuntimeStats::addTilePrepared(FPlatformTime::Seconds() - startTime);
+
+    if (useConvertedModels) {
+      pHalf->ConvertedModelKey = convertedModelKey;
+      if (convertedModel.Num() > 0) {
+        if (this->_pSnapshot && !inSnapshot) {
+          this->_pSnapshot->add(convertedModelKey, convertedModel);
+        }
+        if (pCache && !inSnapshot && !inCache) {
+          pCache->add(convertedModelKey, convertedModel);
+        }
+      }
+    }
+
+    CesiumTileTrace::recordStage(
+        CesiumTileTrace::Stage::LoadThreadFinished,
+        traceKey);
     return pHalf.release();
   }
 
@@ -578,17 +1078,65 @@ public:
       void* pLoadThreadResult) override {
     const Cesium3DTilesSelection::TileContentLoadResult* pContent =
         tile.getContent();
+    if (this->_canceled) {
+      releaseLoadThreadResult(pLoadThreadResult);
+      return nullptr;
+    }
     if (pContent && pContent->model) {
+      TRACE_CPUPROFILER_EVENT_SCOPE(Cesium_PrepareInMainThread);
+      SCOPE_CYCLE_COUNTER(STAT_CesiumMainThreadFinalize);
+      const uint64 traceKey = CesiumTileTrace::isEnabled()
+                                  ? CesiumTileTrace::getTileKey(tile)
+                                  : 0;
+      CesiumTileTrace::recordLink(
+          CesiumTileTrace::getModelKey(*pContent->model),
+          traceKey);
+      CesiumTileTrace::recordStage(
+          CesiumTileTrace::Stage::MainThreadStarted,
+          traceKey);
+
       std::unique_ptr<UCesiumGltfComponent::HalfConstructed> pHalf(
           reinterpret_cast<UCesiumGltfComponent::HalfConstructed*>(
               pLoadThreadResult));
-      return UCesiumGltfComponent::CreateOnGameThread(
+      bool defer = this->_pActor->MainThreadLoadingTimeLimit > 0.0f;
+      CesiumGltfPrimitivePool* pPool =
+          this->_pActor->MaximumPooledPrimitives > 0 ? &this->_pool : nullptr;
+      UCesiumGltfComponent* pGltf = UCesiumGltfComponent::CreateOnGameThread(
           this->_pActor,
           std::move(pHalf),
           _pActor->GetCesiumTilesetToUnrealRelativeWorldTransform(),
           this->_pActor->GetMaterial(),
           this->_pActor->GetWaterMaterial(),
-          this->_pActor->GetCustomDepthParameters());
+          this->_pActor->GetCustomDepthParameters(),
+          this->_pActor->BodyInstance,
+          defer,
+          pPool,
+          &this->_waterMaskAtlas,
+          this->_pTileBatch.Get(),
+          this->_pActor->GetMaximumRayTracingGeometricError() <= 0.0f ||
+              tile.getGeometricError() <=
+                  double(this->_pActor->GetMaximumRayTracingGeometricError()));
+      if (pGltf && this->_pActor->GetEnableFeatureIndex()) {
+        this->_featureIndex.add(pGltf);
+      }
+      if (pGltf && pGltf->HasPendingPrimitives()) {
+        this->_pending.push_back(
+            {pGltf,
+             Cesium3DTilesSelection::getBoundingVolumeCenter(
+                 tile.getBoundingVolume()),
+             0.0});
+      }
+      this->warnIfMeshoptWithOverlays(*pContent->model);
+      if (this->_pActor->ReleaseTileDataAfterLoad &&
+          !this->_pActor->FindComponentByClass<UCesiumRasterOverlay>()) {
+        releaseModelData(*tile.getContent()->model);
+        this->_pActor->NotifyTileDataReleased();
+      }
+
+      CesiumTileTrace::recordStage(
+          CesiumTileTrace::Stage::MainThreadFinished,
+          traceKey);
+      return pGltf;
     }
     // UE_LOG(LogCesium, VeryVerbose, TEXT("No content for tile"));
     return nullptr;
@@ -598,25 +1146,36 @@ public:
       Cesium3DTilesSelection::Tile& tile,
       void* pLoadThreadResult,
       void* pMainThreadResult) noexcept override {
+    if (CesiumTileTrace::isEnabled()) {
+      CesiumTileTrace::recordStage(
+          CesiumTileTrace::Stage::Evicted,
+          CesiumTileTrace::getTileKey(tile));
+    }
+
     if (pLoadThreadResult) {
-      UCesiumGltfComponent::HalfConstructed* pHalf =
-          reinterpret_cast<UCesiumGltfComponent::HalfConstructed*>(
-              pLoadThreadResult);
-      delete pHalf;
+      releaseLoadThreadResult(pLoadThreadResult);
     } else if (pMainThreadResult) {
       UCesiumGltfComponent* pGltf =
           reinterpret_cast<UCesiumGltfComponent*>(pMainThreadResult);
+      this->_featureIndex.remove(pGltf);
+      this->_waterMaskAtlas.release(pGltf);
+      this->releasePooledPrimitives(pGltf);
       this->destroyRecursively(pGltf);
     }
   }
 
   virtual void*
   prepareRasterInLoadThread(const CesiumGltf::ImageCesium& image) override {
+    if (this->_canceled) {
+      return nullptr;
+    }
     return (void*)CesiumTextureUtility::loadTextureAnyThreadPart(
         image,
         TextureAddress::TA_Clamp,
         TextureAddress::TA_Clamp,
-        TextureFilter::TF_Bilinear);
+        TextureFilter::TF_Bilinear,
+        false,
+        this->_pActor->MaximumPooledOverlayTextures > 0);
   }
 
   virtual void* prepareRasterInMainThread(
@@ -627,14 +1186,21 @@ public:
         static_cast<CesiumTextureUtility::LoadedTextureResult*>(
             pLoadThreadResult);
 
-    CesiumTextureUtility::loadTextureGameThreadPart(pLoadedTexture);
-
     if (!pLoadedTexture) {
       return nullptr;
     }
 
-    UTexture2D* pTexture = pLoadedTexture->pTexture;
-    pTexture->AddToRoot();
+    UTexture2D* pTexture =
+        this->_overlayTexturePool.acquireTexture(*pLoadedTexture);
+    if (!pTexture) {
+      CesiumTextureUtility::loadTextureGameThreadPart(pLoadedTexture);
+      pTexture = pLoadedTexture->pTexture;
+    }
+    this->_overlayTextures.Add(pTexture);
+
+    int64 textureBytes = CesiumTextureUtility::getTextureMemoryBytes(pTexture);
+    this->_rasterOverlayTextureBytes += textureBytes;
+    INC_MEMORY_STAT_BY(STAT_CesiumRasterOverlayTextureMemory, textureBytes);
 
     delete pLoadedTexture;
 
@@ -654,8 +1220,21 @@ public:
 
     if (pMainThreadResult) {
       UTexture2D* pTexture = static_cast<UTexture2D*>(pMainThreadResult);
-      pTexture->RemoveFromRoot();
-      CesiumLifetime::destroy(pTexture);
+
+      int64 textureBytes =
+          CesiumTextureUtility::getTextureMemoryBytes(pTexture);
+      this->_rasterOverlayTextureBytes -= textureBytes;
+      DEC_MEMORY_STAT_BY(STAT_CesiumRasterOverlayTextureMemory, textureBytes);
+
+      this->_overlayTextures.Remove(pTexture);
+      // While memory is low, textures are destroyed instead of pooled.
+      const int32 maximumPooled =
+          CesiumMemoryPressure::isUnderPressure()
+              ? 0
+              : this->_pActor->MaximumPooledOverlayTextures;
+      if (!this->_overlayTexturePool.releaseTexture(pTexture, maximumPooled)) {
+        CesiumLifetime::destroy(pTexture);
+      }
     }
   }
 
@@ -702,7 +1281,178 @@ public:
     }
   }
 
+  /**
+   * Gets the number of glTF components created by prepareInMainThread whose
+   * primitives are still waiting to be created.
+   */
+  int32 getPendingComponentCount() const {
+    return int32(this->_pending.size());
+  }
+
+  /**
+   * Creates the pending primitives of the glTF components created by
+   * prepareInMainThread, closest to one of the given views first, until the
+   * given time, as returned by FPlatformTime::Seconds, is reached.
+   */
+  void createPendingPrimitives(
+      const std::vector<Cesium3DTilesSelection::ViewState>& frustums,
+      double endTimeSeconds) {
+    if (this->_pending.empty()) {
+      return;
+    }
+
+    for (PendingGltf& pending : this->_pending) {
+      pending.distanceSquared = std::numeric_limits<double>::max();
+      for (const Cesium3DTilesSelection::ViewState& frustum : frustums) {
+        glm::dvec3 delta = pending.center - frustum.getPosition();
+        pending.distanceSquared =
+            glm::min(pending.distanceSquared, glm::dot(delta, delta));
+      }
+    }
+
+    std::sort(
+        this->_pending.begin(),
+        this->_pending.end(),
+        [](const PendingGltf& lhs, const PendingGltf& rhs) {
+          return lhs.distanceSquared < rhs.distanceSquared;
+        });
+
+    const glm::dmat4& cesiumToUnreal =
+        this->_pActor->GetCesiumTilesetToUnrealRelativeWorldTransform();
+
+    // Always make progress on at least one component per frame.
+    size_t completed = 0;
+    for (PendingGltf& pending : this->_pending) {
+      if (completed > 0 && FPlatformTime::Seconds() >= endTimeSeconds) {
+        break;
+      }
+
+      UCesiumGltfComponent* pGltf = pending.pGltf.Get();
+      if (!pGltf ||
+          pGltf->CreatePendingPrimitives(cesiumToUnreal, endTimeSeconds)) {
+        ++completed;
+      } else {
+        break;
+      }
+    }
+
+    // The completed components are at the front of the list, plus any that
+    // were destroyed by free while they were waiting.
+    this->_pending.erase(
+        std::remove_if(
+            this->_pending.begin(),
+            this->_pending.end(),
+            [](const PendingGltf& pending) {
+              UCesiumGltfComponent* pGltf = pending.pGltf.Get();
+              return !pGltf || !pGltf->HasPendingPrimitives();
+            }),
+        this->_pending.end());
+  }
+
+  /**
+   * Cancels the work of the tiles that are still loading, because the tileset
+   * is being destroyed. The load threads skip the rest of their work at the
+   * next stage they reach, and tiles that have finished loading no longer
+   * create their components.
+   */
+  void cancelLoads() { this->_canceled = true; }
+
+  /**
+   * Saves the warm-start snapshot of the tileset, if it has one, with the
+   * converted models of the tiles that are currently shown.
+   */
+  void saveSnapshot() {
+    if (!this->_pSnapshot) {
+      return;
+    }
+
+    TSet<uint64> keys;
+    TArray<UCesiumGltfComponent*> gltfComponents;
+    this->_pActor->GetComponents<UCesiumGltfComponent>(gltfComponents);
+    for (UCesiumGltfComponent* pGltf : gltfComponents) {
+      if (pGltf->ConvertedModelKey != 0 && pGltf->IsVisible()) {
+        keys.Add(pGltf->ConvertedModelKey);
+      }
+    }
+    this->_pSnapshot->save(keys);
+  }
+
+  /**
+   * Gets the number of bytes used by the raster overlay textures that are
+   * currently loaded for the tileset.
+   */
+  int64 getRasterOverlayTextureBytes() const {
+    return this->_rasterOverlayTextureBytes;
+  }
+
+  /**
+   * Gets the number of bytes used by the textures of the water mask atlas.
+   */
+  int64 getWaterMaskAtlasBytes() const {
+    return this->_waterMaskAtlas.getTextureBytes();
+  }
+
+  /**
+   * Gets the index of the features of the loaded tiles, which is empty unless
+   * the feature index of the tileset is enabled.
+   */
+  const CesiumFeatureIndex& getFeatureIndex() const {
+    return this->_featureIndex;
+  }
+
+  /**
+   * Destroys the pooled primitives, materials and raster overlay textures, to
+   * give their memory back.
+   */
+  void emptyPools() {
+    this->_pool.clear();
+    this->_overlayTexturePool.clear();
+  }
+
+  /**
+   * Keeps the loaded raster overlay textures from being garbage collected.
+   * They are only referenced by the materials of tiles once they are
+   * attached, and some are never attached.
+   */
+  virtual void AddReferencedObjects(FReferenceCollector& Collector) override {
+    Collector.AddReferencedObjects(this->_overlayTextures);
+  }
+
+  virtual FString GetReferencerName() const override {
+    return TEXT("UnrealResourcePreparer");
+  }
+
 private:
+  /**
+   * Frees the result of prepareInLoadThread of a tile whose components are
+   * never created, along with the textures and render data it loaded.
+   */
+  static void releaseLoadThreadResult(void* pLoadThreadResult) {
+    delete reinterpret_cast<UCesiumGltfComponent::HalfConstructed*>(
+        pLoadThreadResult);
+  }
+
+  /**
+   * Moves the primitives of the given glTF component into the pool, as long
+   * as there is room. Only primitives owned by the tileset actor itself are
+   * pooled, because the others are destroyed along with the glTF component.
+   */
+  void releasePooledPrimitives(UCesiumGltfComponent* pGltf) {
+    int32 maximumSize = this->_pActor->MaximumPooledPrimitives;
+    if (!pGltf || maximumSize <= 0 || CesiumMemoryPressure::isUnderPressure()) {
+      return;
+    }
+
+    TArray<USceneComponent*> children = pGltf->GetAttachChildren();
+    for (USceneComponent* pChild : children) {
+      UCesiumGltfPrimitiveComponent* pPrimitive =
+          Cast<UCesiumGltfPrimitiveComponent>(pChild);
+      if (pPrimitive && pPrimitive->GetOuter() == this->_pActor) {
+        this->_pool.releasePrimitive(pPrimitive, maximumSize);
+      }
+    }
+  }
+
   void destroyRecursively(USceneComponent* pComponent) {
 
     UE_LOG(
@@ -730,65 +1480,315 @@ private:
     UE_LOG(LogCesium, VeryVerbose, TEXT("Destroying scene component done"));
   }
 
+  /**
+   * Logs a warning, once, when a tile compressed with EXT_meshopt_compression
+   * is loaded into a tileset that has raster overlays, which are not drawn on
+   * such tiles.
+   */
+  void warnIfMeshoptWithOverlays(const CesiumGltf::Model& model) {
+    if (this->_meshoptOverlayWarned ||
+        std::find(
+            model.extensionsUsed.begin(),
+            model.extensionsUsed.end(),
+            "EXT_meshopt_compression") == model.extensionsUsed.end() ||
+        !this->_pActor->FindComponentByClass<UCesiumRasterOverlay>()) {
+      return;
+    }
+    this->_meshoptOverlayWarned = true;
+    UE_LOG(
+        LogCesium,
+        Warning,
+        TEXT("Tileset %s has tiles compressed with EXT_meshopt_compression, which don't receive raster overlays"),
+        *this->_pActor->GetName());
+  }
+
+  struct PendingGltf {
+    TWeakObjectPtr<UCesiumGltfComponent> pGltf;
+    glm::dvec3 center;
+    double distanceSquared;
+  };
+
   ACesium3DTileset* _pActor;
+  TWeakObjectPtr<UCesiumTileBatchComponent> _pTileBatch;
 #if PHYSICS_INTERFACE_PHYSX
   IPhysXCooking* _pPhysXCooking;
 #endif
+#if CESIUM_BUILD_NANITE
+  INaniteBuilderModule* _pNaniteBuilder;
+#endif
+  std::vector<PendingGltf> _pending;
+  CesiumGltfPrimitivePool _pool;
+  CesiumFeatureIndex _featureIndex;
+  CesiumTexturePool _overlayTexturePool;
+  CesiumWaterMaskAtlas _waterMaskAtlas;
+  TSet<UTexture2D*> _overlayTextures;
+  int64 _rasterOverlayTextureBytes = 0;
+  std::atomic<bool> _canceled{false};
+  std::unique_ptr<CesiumTileSnapshot> _pSnapshot;
+  bool _meshoptOverlayWarned = false;
+  bool _renderHeightfields = false;
 };
 
-static std::string getCacheDatabaseName() {
-#if PLATFORM_ANDROID
-  FString BaseDirectory = FPaths::ProjectPersistentDownloadDir();
-#elif PLATFORM_IOS
-  FString BaseDirectory =
-      FPaths::Combine(*FPaths::ProjectSavedDir(), TEXT("Cesium"));
-  if (!IFileManager::Get().DirectoryExists(*BaseDirectory)) {
-    IFileManager::Get().MakeDirectory(*BaseDirectory, true);
-  }
-#else
-  FString BaseDirectory = FPaths::EngineUserDir();
-#endif
+void ACesium3DTileset::UpdateTileMaterials() {
+  this->resetPipelinePrecache();
 
-  FString CesiumDBFile =
-      FPaths::Combine(*BaseDirectory, TEXT("cesium-request-cache.sqlite"));
-  FString PlatformAbsolutePath =
-      IFileManager::Get().ConvertToAbsolutePathForExternalAppForWrite(
-          *CesiumDBFile);
+  TArray<UCesiumGltfComponent*> gltfComponents;
+  this->GetComponents<UCesiumGltfComponent>(gltfComponents);
 
-  UE_LOG(
-      LogCesium,
-      Display,
-      TEXT("Caching Cesium requests in %s"),
-      *PlatformAbsolutePath);
+  for (UCesiumGltfComponent* pGltf : gltfComponents) {
+    if (!UCesiumGltfComponent::CanUpdateMaterials(
+            pGltf->BaseMaterial,
+            pGltf->BaseMaterialWithWater,
+            this->Material,
+            this->WaterMaterial)) {
+      this->DestroyTileset();
+      return;
+    }
+  }
+
+  for (UCesiumGltfComponent* pGltf : gltfComponents) {
+    pGltf->UpdateMaterials(this->Material, this->WaterMaterial);
+  }
+
+  // The pooled material instances are parented to the old materials, so
+  // they would never be reused.
+  if (this->_pResourcePreparer) {
+    this->_pResourcePreparer->emptyPools();
+  }
+}
+
+void ACesium3DTileset::UpdateTileCustomDepthParameters() {
+  TArray<UCesiumGltfComponent*> gltfComponents;
+  this->GetComponents<UCesiumGltfComponent>(gltfComponents);
+
+  for (UCesiumGltfComponent* pGltf : gltfComponents) {
+    pGltf->SetCustomDepthParameters(this->CustomDepthParameters);
+  }
+}
+
+/**
+ * @brief Overrides a KTX2 transcode target with the one chosen in the
+ * settings, if the platform supports it.
+ *
+ * @param target The target chosen in the settings.
+ * @param supportedFormats The formats supported by the platform.
+ * @param format The target picked from the supported formats, which is
+ * replaced.
+ */
+static void applyKtx2TranscodeTarget(
+    ECesiumKtx2TranscodeTarget target,
+    const CesiumGltf::SupportedGpuCompressedPixelFormats& supportedFormats,
+    CesiumGltf::GpuCompressedPixelFormat& format) {
+  using CesiumGltf::GpuCompressedPixelFormat;
+
+  GpuCompressedPixelFormat targetFormat = GpuCompressedPixelFormat::NONE;
+  bool supported = true;
+  switch (target) {
+  case ECesiumKtx2TranscodeTarget::Default:
+    return;
+  case ECesiumKtx2TranscodeTarget::Uncompressed:
+    break;
+  case ECesiumKtx2TranscodeTarget::BC1:
+    targetFormat = GpuCompressedPixelFormat::BC1_RGB;
+    supported = supportedFormats.BC1_RGB;
+    break;
+  case ECesiumKtx2TranscodeTarget::BC3:
+    targetFormat = GpuCompressedPixelFormat::BC3_RGBA;
+    supported = supportedFormats.BC3_RGBA;
+    break;
+  case ECesiumKtx2TranscodeTarget::BC4:
+    targetFormat = GpuCompressedPixelFormat::BC4_R;
+    supported = supportedFormats.BC4_R;
+    break;
+  case ECesiumKtx2TranscodeTarget::BC5:
+    targetFormat = GpuCompressedPixelFormat::BC5_RG;
+    supported = supportedFormats.BC5_RG;
+    break;
+  case ECesiumKtx2TranscodeTarget::BC7:
+    targetFormat = GpuCompressedPixelFormat::BC7_RGBA;
+    supported = supportedFormats.BC7_RGBA;
+    break;
+  case ECesiumKtx2TranscodeTarget::ETC1:
+    targetFormat = GpuCompressedPixelFormat::ETC1_RGB;
+    supported = supportedFormats.ETC1_RGB;
+    break;
+  case ECesiumKtx2TranscodeTarget::ETC2:
+    targetFormat = GpuCompressedPixelFormat::ETC2_RGBA;
+    supported = supportedFormats.ETC2_RGBA;
+    break;
+  case ECesiumKtx2TranscodeTarget::ETC2_R11:
+    targetFormat = GpuCompressedPixelFormat::ETC2_EAC_R11;
+    supported = supportedFormats.ETC2_EAC_R11;
+    break;
+  case ECesiumKtx2TranscodeTarget::ETC2_RG11:
+    targetFormat = GpuCompressedPixelFormat::ETC2_EAC_RG11;
+    supported = supportedFormats.ETC2_EAC_RG11;
+    break;
+  case ECesiumKtx2TranscodeTarget::ASTC_4x4:
+    targetFormat = GpuCompressedPixelFormat::ASTC_4x4_RGBA;
+    supported = supportedFormats.ASTC_4x4_RGBA;
+    break;
+  case ECesiumKtx2TranscodeTarget::PVRTC2:
+    targetFormat = GpuCompressedPixelFormat::PVRTC2_4_RGBA;
+    supported = supportedFormats.PVRTC2_4_RGBA;
+    break;
+  }
+
+  if (supported) {
+    format = targetFormat;
+  }
+}
+
+/**
+ * @brief Gets the formats that KTX2 textures are transcoded to, from the
+ * formats supported by the platform and the targets chosen in the settings
+ * of each kind of texture, which is told by its number of channels.
+ */
+static CesiumGltf::Ktx2TranscodeTargets getKtx2TranscodeTargets(
+    const CesiumGltf::SupportedGpuCompressedPixelFormats& supportedFormats) {
+  const UCesiumRuntimeSettings* pSettings =
+      GetDefault<UCesiumRuntimeSettings>();
+  CesiumGltf::Ktx2TranscodeTargets targets(
+      supportedFormats,
+      pSettings->Ktx2PreserveHighQuality);
+
+  applyKtx2TranscodeTarget(
+      pSettings->Ktx2SingleChannelTarget,
+      supportedFormats,
+      targets.ETC1S_R);
+  applyKtx2TranscodeTarget(
+      pSettings->Ktx2SingleChannelTarget,
+      supportedFormats,
+      targets.UASTC_R);
+  applyKtx2TranscodeTarget(
+      pSettings->Ktx2NormalTarget,
+      supportedFormats,
+      targets.ETC1S_RG);
+  applyKtx2TranscodeTarget(
+      pSettings->Ktx2NormalTarget,
+      supportedFormats,
+      targets.UASTC_RG);
+  applyKtx2TranscodeTarget(
+      pSettings->Ktx2ColorTarget,
+      supportedFormats,
+      targets.ETC1S_RGB);
+  applyKtx2TranscodeTarget(
+      pSettings->Ktx2ColorTarget,
+      supportedFormats,
+      targets.UASTC_RGB);
+  applyKtx2TranscodeTarget(
+      pSettings->Ktx2ColorAlphaTarget,
+      supportedFormats,
+      targets.ETC1S_RGBA);
+  applyKtx2TranscodeTarget(
+      pSettings->Ktx2ColorAlphaTarget,
+      supportedFormats,
+      targets.UASTC_RGBA);
+  return targets;
+}
+
+namespace {
+/**
+ * The tilesets that load the tiles for the tilesets with ShareTileset, by
+ * ACesium3DTileset::getShareKey. It is only used on the game thread.
+ */
+TMap<FString, TWeakObjectPtr<ACesium3DTileset>>& getSharedTilesets() {
+  static TMap<FString, TWeakObjectPtr<ACesium3DTileset>> sharedTilesets;
+  return sharedTilesets;
+}
 
-  return TCHAR_TO_UTF8(*PlatformAbsolutePath);
+/**
+ * Appends the values of the properties that a raster overlay class declares
+ * as text, leaving out those of the component it derives from.
+ */
+void appendRasterOverlayProperties(
+    const UCesiumRasterOverlay& overlay,
+    FString& text) {
+  for (TFieldIterator<FProperty> it(overlay.GetClass()); it; ++it) {
+    const UClass* pOwner = it->GetOwnerClass();
+    if (!pOwner || !pOwner->IsChildOf(UCesiumRasterOverlay::StaticClass()) ||
+        it->HasAnyPropertyFlags(CPF_Transient)) {
+      continue;
+    }
+    it->ExportTextItem(
+        text,
+        it->ContainerPtrToValuePtr<void>(&overlay),
+        nullptr,
+        nullptr,
+        PPF_None);
+    text += TEXT(";");
+  }
 }
+} // namespace
 
 void ACesium3DTileset::LoadTileset() {
-  static std::shared_ptr<CesiumAsync::IAssetAccessor> pAssetAccessor =
-      std::make_shared<CesiumAsync::CachingAssetAccessor>(
-          spdlog::default_logger(),
-          std::make_shared<UnrealAssetAccessor>(),
-          std::make_shared<CesiumAsync::SqliteCache>(
-              spdlog::default_logger(),
-              getCacheDatabaseName()));
-  static CesiumAsync::AsyncSystem asyncSystem(
-      std::make_shared<UnrealTaskProcessor>());
 
   if (this->_pTileset) {
     // Tileset already loaded, do nothing.
     return;
   }
 
+  if (!isAssetAccessorReady()) {
+    // The request cache is still being opened in the background, so the
+    // tileset is loaded by a later Tick instead of stalling the game thread.
+    return;
+  }
+
+  if (this->ShareTileset) {
+    this->ResolveGeoreference();
+    const FString key = this->getShareKey();
+    TWeakObjectPtr<ACesium3DTileset>& pShared =
+        getSharedTilesets().FindOrAdd(key);
+    if (!pShared.IsValid() || !pShared->_pTileset) {
+      // This tileset loads the tiles, for itself and for the compatible
+      // tilesets that are loaded after it.
+      pShared = this;
+      this->_shareKey = key;
+    } else if (pShared->GetActorTransform().Equals(this->GetActorTransform())) {
+      UE_LOG(
+          LogCesium,
+          Log,
+          TEXT("Tileset %s shares the tiles loaded by %s"),
+          *this->GetName(),
+          *pShared->GetName());
+      this->_shareKey = key;
+      this->_pSharedTileset = pShared;
+      return;
+    }
+    // Otherwise, a tileset with another transform already loads the same
+    // tiles, and this one loads its own.
+  }
+
   TArray<UCesiumRasterOverlay*> rasterOverlays;
   this->GetComponents<UCesiumRasterOverlay>(rasterOverlays);
 
   ACesiumCreditSystem* pCreditSystem = this->ResolveCreditSystem();
 
+  if (this->UseBatchedRendering && !this->_pTileBatch) {
+    this->_pTileBatch = NewObject<UCesiumTileBatchComponent>(this);
+    this->_pTileBatch->SetFlags(
+        RF_Transient | RF_DuplicateTransient | RF_TextExportTransient);
+    this->_pTileBatch->AttachToComponent(
+        this->RootComponent,
+        FAttachmentTransformRules::KeepRelativeTransform);
+    this->_pTileBatch->RegisterComponent();
+  } else if (!this->UseBatchedRendering && this->_pTileBatch) {
+    this->_pTileBatch->DestroyComponent();
+    this->_pTileBatch = nullptr;
+  }
+
+  this->_pResourcePreparer =
+      std::make_shared<UnrealResourcePreparer>(this, this->_pTileBatch);
+
+#if WITH_EDITOR
+  this->_reloadPropertiesSignature = this->GetReloadPropertiesSignature();
+#endif
+  this->_viewUpdateNeeded = true;
+
   Cesium3DTilesSelection::TilesetExternals externals{
-      pAssetAccessor,
-      std::make_shared<UnrealResourcePreparer>(this),
-      asyncSystem,
+      getAssetAccessor(),
+      this->_pResourcePreparer,
+      getAsyncSystem(),
       pCreditSystem ? pCreditSystem->GetExternalCreditSystem() : nullptr,
       spdlog::default_logger()};
 
@@ -861,7 +1861,7 @@ void ACesium3DTileset::LoadTileset() {
       GPixelFormats[EPixelFormat::PF_ETC2_RG11_EAC].Supported;
 
   options.contentOptions.ktx2TranscodeTargets =
-      CesiumGltf::Ktx2TranscodeTargets(supportedFormats, false);
+      getKtx2TranscodeTargets(supportedFormats);
 
   switch (this->TilesetSource) {
   case ETilesetSource::FromUrl:
@@ -921,6 +1921,18 @@ void ACesium3DTileset::LoadTileset() {
 
 void ACesium3DTileset::DestroyTileset() {
 
+  // The tilesets that shared the tiles of this one load them again, and one
+  // of them takes its place.
+  if (!this->_shareKey.IsEmpty()) {
+    TWeakObjectPtr<ACesium3DTileset>* pShared =
+        getSharedTilesets().Find(this->_shareKey);
+    if (pShared && (!pShared->IsValid() || pShared->Get() == this)) {
+      getSharedTilesets().Remove(this->_shareKey);
+    }
+    this->_shareKey.Empty();
+    this->_pSharedTileset.Reset();
+  }
+
   if (this->Url.Len() > 0) {
     UE_LOG(
         LogCesium,
@@ -951,8 +1963,30 @@ void ACesium3DTileset::DestroyTileset() {
     return;
   }
 
+  // The tileset waits for its tiles that are loading, so their remaining
+  // work is canceled first.
+  if (this->_pResourcePreparer) {
+    this->_pResourcePreparer->cancelLoads();
+  }
+
+  this->resetFarField();
+  this->resetPipelinePrecache();
   delete this->_pTileset;
   this->_pTileset = nullptr;
+  this->_pLastViewUpdateResult = nullptr;
+  this->_capturedViewUpdateResult = Cesium3DTilesSelection::ViewUpdateResult();
+  this->_tilesToNoLongerRenderNextFrame.clear();
+  this->_renderedTiles.clear();
+  this->_tileShownTimes.clear();
+  this->_baseLevelOfDetailLoaded = false;
+  this->_tileDataReleased = false;
+  this->_pResourcePreparer.reset();
+  this->_pOcclusionExcluder.reset();
+
+  UCesiumTileLoadScheduler* pScheduler = this->GetTileLoadScheduler();
+  if (pScheduler) {
+    pScheduler->RemoveTileset(this);
+  }
 
   if (this->Url.Len() > 0) {
     UE_LOG(
@@ -970,25 +2004,34 @@ void ACesium3DTileset::DestroyTileset() {
 }
 
 std::vector<FCesiumCamera> ACesium3DTileset::GetCameras() const {
-  std::vector<FCesiumCamera> cameras = this->GetPlayerCameras();
+  ACesiumCameraManager* pCameraManager =
+      ACesiumCameraManager::GetDefaultCameraManager(this->GetWorld());
+  const bool useLocalViews =
+      !pCameraManager || !pCameraManager->UseOnlyRegisteredCameras;
 
-  std::vector<FCesiumCamera> sceneCaptures = this->GetSceneCaptures();
-  cameras.insert(
-      cameras.end(),
-      std::make_move_iterator(sceneCaptures.begin()),
-      std::make_move_iterator(sceneCaptures.end()));
+  std::vector<FCesiumCamera> cameras;
+  if (useLocalViews) {
+    cameras = this->GetPlayerCameras();
 
 #if WITH_EDITOR
-  std::vector<FCesiumCamera> editorCameras = this->GetEditorCameras();
-  cameras.insert(
-      cameras.end(),
-      std::make_move_iterator(editorCameras.begin()),
-      std::make_move_iterator(editorCameras.end()));
+    std::vector<FCesiumCamera> editorCameras = this->GetEditorCameras();
+    cameras.insert(
+        cameras.end(),
+        std::make_move_iterator(editorCameras.begin()),
+        std::make_move_iterator(editorCameras.end()));
 #endif
+  }
 
-  ACesiumCameraManager* pCameraManager =
-      ACesiumCameraManager::GetDefaultCameraManager(this->GetWorld());
   if (pCameraManager) {
+    if (useLocalViews) {
+      const std::vector<FCesiumCamera>& sceneCaptures =
+          pCameraManager->GetSceneCaptureCameras();
+      cameras.insert(
+          cameras.end(),
+          sceneCaptures.begin(),
+          sceneCaptures.end());
+    }
+
     const TMap<int32, FCesiumCamera>& extraCameras =
         pCameraManager->GetCameras();
     cameras.reserve(cameras.size() + extraCameras.Num());
@@ -997,9 +2040,265 @@ std::vector<FCesiumCamera> ACesium3DTileset::GetCameras() const {
     }
   }
 
+  std::vector<FCesiumCamera> pointOfInterestCameras =
+      this->GetPointOfInterestCameras(true);
+  cameras.insert(
+      cameras.end(),
+      std::make_move_iterator(pointOfInterestCameras.begin()),
+      std::make_move_iterator(pointOfInterestCameras.end()));
+
+  return cameras;
+}
+
+/**
+ * @brief Applies the ScreenSpaceErrorScale and MaximumViewportHeight of each
+ * camera to its viewport size.
+ *
+ * The screen-space error of a tile is proportional to the viewport height, so
+ * scaling the viewport scales the detail selected for the view.
+ */
+static void applyCameraDetail(std::vector<FCesiumCamera>& cameras) {
+  for (FCesiumCamera& camera : cameras) {
+    float scale = FMath::Max(camera.ScreenSpaceErrorScale, 0.0f);
+    if (camera.MaximumViewportHeight > 0.0f &&
+        camera.ViewportSize.Y * scale > camera.MaximumViewportHeight) {
+      scale = camera.MaximumViewportHeight / float(camera.ViewportSize.Y);
+    }
+
+    if (scale != 1.0f) {
+      camera.ViewportSize.X = FMath::Max(camera.ViewportSize.X * scale, 1.0f);
+      camera.ViewportSize.Y = FMath::Max(camera.ViewportSize.Y * scale, 1.0f);
+    }
+  }
+}
+
+void ACesium3DTileset::AddPredictedCameras(
+    std::vector<FCesiumCamera>& cameras,
+    float deltaTime) {
+  if (this->PredictiveLoadingTime <= 0.0f || deltaTime <= 0.0f) {
+    this->_previousCameraLocations.clear();
+    this->_cameraVelocities.clear();
+    return;
+  }
+
+  // Cameras are matched with those of the previous frame by their index. If
+  // the set of cameras changed, there is no meaningful velocity yet.
+  size_t cameraCount = cameras.size();
+  if (this->_previousCameraLocations.size() != cameraCount) {
+    this->_previousCameraLocations.clear();
+    this->_cameraVelocities.assign(cameraCount, FVector::ZeroVector);
+    for (const FCesiumCamera& camera : cameras) {
+      this->_previousCameraLocations.push_back(camera.Location);
+    }
+    return;
+  }
+
+  // Smooth the velocity over a few frames so that an uneven frame rate does
+  // not make the predicted views jitter.
+  const float smoothing = 0.25f;
+
+  cameras.reserve(cameraCount * 2);
+  for (size_t i = 0; i < cameraCount; ++i) {
+    FVector location = cameras[i].Location;
+    FVector velocity =
+        (location - this->_previousCameraLocations[i]) / deltaTime;
+    this->_previousCameraLocations[i] = location;
+    this->_cameraVelocities[i] =
+        FMath::Lerp(this->_cameraVelocities[i], velocity, smoothing);
+
+    FVector offset = this->_cameraVelocities[i] * this->PredictiveLoadingTime;
+    if (offset.IsNearlyZero()) {
+      continue;
+    }
+
+    // Selecting for half the viewport size coarsens the tiles needed by the
+    // predicted view by about one level of detail.
+    FCesiumCamera predicted = cameras[i];
+    predicted.Location += offset;
+    predicted.ViewportSize *= 0.5f;
+    cameras.push_back(predicted);
+  }
+}
+
+std::vector<FCesiumCamera> ACesium3DTileset::getSequencerPreloadCameras(
+    const std::vector<FCesiumCamera>& cameras) const {
+  std::vector<FCesiumCamera> preloadCameras;
+  if (this->SequencerPreloadTime <= 0.0f || cameras.empty()) {
+    return preloadCameras;
+  }
+
+  for (const TWeakObjectPtr<ALevelSequenceActor>& pSequenceActor :
+       this->_levelSequenceActors) {
+    if (pSequenceActor.IsValid()) {
+      CesiumSequencePreload::addUpcomingCameras(
+          *pSequenceActor,
+          this->SequencerPreloadTime,
+          this->SequencerPreloadSamples,
+          cameras[0],
+          preloadCameras);
+    }
+  }
+  return preloadCameras;
+}
+
+std::vector<FCesiumCamera> ACesium3DTileset::GetPawnCameras() const {
+  UWorld* pWorld = this->GetWorld();
+  if (!pWorld) {
+    return {};
+  }
+
+  FVector2D viewportSize(
+      this->CollisionOnlyViewportSize,
+      this->CollisionOnlyViewportSize);
+
+  std::vector<FCesiumCamera> cameras;
+  cameras.reserve(pWorld->GetNumPlayerControllers());
+
+  for (auto playerControllerIt = pWorld->GetPlayerControllerIterator();
+       playerControllerIt;
+       playerControllerIt++) {
+    const TWeakObjectPtr<APlayerController> pPlayerController =
+        *playerControllerIt;
+    if (pPlayerController == nullptr) {
+      continue;
+    }
+
+    const APawn* pPawn = pPlayerController->GetPawn();
+    if (!pPawn) {
+      continue;
+    }
+
+    cameras.emplace_back(
+        viewportSize,
+        pPawn->GetActorLocation(),
+        pPawn->GetActorRotation(),
+        90.0f);
+  }
+
+  return cameras;
+}
+
+std::vector<FCesiumCamera>
+ACesium3DTileset::GetPointOfInterestCameras(bool includeRemotePlayers) const {
+  ACesiumCameraManager* pCameraManager =
+      ACesiumCameraManager::GetDefaultCameraManager(this->GetWorld());
+  if (!pCameraManager) {
+    return {};
+  }
+
+  std::vector<FCesiumPointOfInterest> pointsOfInterest;
+  for (const auto& pointOfInterestIt : pCameraManager->GetPointsOfInterest()) {
+    pointsOfInterest.push_back(pointOfInterestIt.Value);
+  }
+  if (includeRemotePlayers) {
+    const std::vector<FCesiumPointOfInterest>& remotePlayers =
+        pCameraManager->GetRemotePlayerPointsOfInterest();
+    pointsOfInterest.insert(
+        pointsOfInterest.end(),
+        remotePlayers.begin(),
+        remotePlayers.end());
+  }
+
+  if (pointsOfInterest.empty()) {
+    return {};
+  }
+
+  // Without frustum culling, a single camera selects the tiles all around a
+  // point. Otherwise, it takes the six faces of a cube to cover every
+  // direction.
+  static const FRotator allDirections[] = {
+      FRotator(0.0f, 0.0f, 0.0f),
+      FRotator(0.0f, 90.0f, 0.0f),
+      FRotator(0.0f, 180.0f, 0.0f),
+      FRotator(0.0f, 270.0f, 0.0f),
+      FRotator(90.0f, 0.0f, 0.0f),
+      FRotator(-90.0f, 0.0f, 0.0f)};
+  const bool frustumCulling =
+      this->EnableFrustumCulling && !this->CollisionOnly;
+  const size_t directionCount =
+      frustumCulling ? sizeof(allDirections) / sizeof(allDirections[0]) : 1;
+
+  FVector2D viewportSize(
+      pCameraManager->PointOfInterestViewportSize,
+      pCameraManager->PointOfInterestViewportSize);
+
+  std::vector<FCesiumCamera> cameras;
+  cameras.reserve(pointsOfInterest.size() * directionCount);
+  for (const FCesiumPointOfInterest& pointOfInterest : pointsOfInterest) {
+    for (size_t i = 0; i < directionCount; ++i) {
+      FCesiumCamera& camera = cameras.emplace_back(
+          viewportSize,
+          pointOfInterest.Location,
+          allDirections[i],
+          90.0f);
+      camera.ScreenSpaceErrorScale = pointOfInterest.ScreenSpaceErrorScale;
+    }
+  }
+
   return cameras;
 }
 
+namespace {
+/**
+ * @brief Creates a single camera whose frustum contains the frustums of both
+ * eyes, for selecting tiles once per stereo view instead of once per eye.
+ *
+ * The combined camera looks along the head's direction from a point behind
+ * the eyes, far enough back that its frustum contains both of theirs. Its
+ * field of view is widened to cover eyes that are canted away from the head
+ * direction. Its viewport is as detailed as the more detailed eye's, scaled
+ * up with the field of view, so tiles are selected for at least the
+ * screen-space error of either eye.
+ */
+FCesiumCamera createCombinedStereoCamera(
+    const FCesiumCamera& leftEye,
+    const FCesiumCamera& rightEye,
+    const FRotator& headRotation) {
+  const FVector forward = headRotation.Vector();
+
+  // Widen the field of view so that it covers both eyes, even if they look in
+  // slightly different directions.
+  auto halfFieldOfView = [&forward](const FCesiumCamera& eye) {
+    const double cosine = FMath::Clamp(
+        double(FVector::DotProduct(eye.Rotation.Vector(), forward)),
+        -1.0,
+        1.0);
+    return glm::radians(double(eye.FieldOfViewDegrees)) * 0.5 +
+           glm::acos(cosine);
+  };
+  const double eyeHalfFieldOfView = glm::radians(
+      0.5 * double(FMath::Max(
+                leftEye.FieldOfViewDegrees,
+                rightEye.FieldOfViewDegrees)));
+  const double halfFieldOfView = FMath::Min(
+      FMath::Max(halfFieldOfView(leftEye), halfFieldOfView(rightEye)),
+      glm::radians(89.0));
+
+  // Move back from the point between the eyes until the combined frustum's
+  // sides pass through both eyes.
+  const FVector center = (leftEye.Location + rightEye.Location) * 0.5f;
+  const double halfSeparation =
+      0.5 * FVector::Distance(leftEye.Location, rightEye.Location);
+  const double setback = halfSeparation / glm::tan(halfFieldOfView);
+  const FVector location = center - forward * float(setback);
+
+  // Keep at least the pixel density of the more detailed eye across the wider
+  // field of view.
+  const FVector2D eyeSize(
+      FMath::Max(leftEye.ViewportSize.X, rightEye.ViewportSize.X),
+      FMath::Max(leftEye.ViewportSize.Y, rightEye.ViewportSize.Y));
+  const float sizeScale = float(
+      glm::tan(halfFieldOfView) /
+      glm::tan(FMath::Max(eyeHalfFieldOfView, 1.0e-6)));
+
+  return FCesiumCamera(
+      eyeSize * sizeScale,
+      location,
+      headRotation,
+      float(glm::degrees(2.0 * halfFieldOfView)));
+}
+} // namespace
+
 std::vector<FCesiumCamera> ACesium3DTileset::GetPlayerCameras() const {
   UWorld* pWorld = this->GetWorld();
   if (!pWorld) {
@@ -1085,9 +2384,15 @@ std::vector<FCesiumCamera> ACesium3DTileset::GetPlayerCameras() const {
       FVector2D stereoLeftSize(stereoLeftSizeX, stereoLeftSizeY);
       FVector2D stereoRightSize(stereoRightSizeX, stereoRightSizeY);
 
-      if (stereoLeftSize.X >= 1.0 && stereoLeftSize.Y >= 1.0) {
-        FVector leftEyeLocation = location;
-        FRotator leftEyeRotation = rotation;
+      const bool hasLeftEye =
+          stereoLeftSize.X >= 1.0 && stereoLeftSize.Y >= 1.0;
+      const bool hasRightEye =
+          stereoRightSize.X >= 1.0 && stereoRightSize.Y >= 1.0;
+
+      FVector leftEyeLocation = location;
+      FRotator leftEyeRotation = rotation;
+      float leftEyeHfov = 0.0f;
+      if (hasLeftEye) {
         pStereoRendering->CalculateStereoViewOffset(
             leftEye,
             leftEyeRotation,
@@ -1100,19 +2405,14 @@ std::vector<FCesiumCamera> ACesium3DTileset::GetPlayerCameras() const {
         // TODO: consider assymetric frustums using 4 fovs
         float one_over_tan_half_hfov = projection.M[0][0];
 
-        float hfov =
+        leftEyeHfov =
             glm::degrees(2.0f * glm::atan(1.0f / one_over_tan_half_hfov));
-
-        cameras.emplace_back(
-            stereoLeftSize,
-            leftEyeLocation,
-            leftEyeRotation,
-            hfov);
       }
 
-      if (stereoRightSize.X >= 1.0 && stereoRightSize.Y >= 1.0) {
-        FVector rightEyeLocation = location;
-        FRotator rightEyeRotation = rotation;
+      FVector rightEyeLocation = location;
+      FRotator rightEyeRotation = rotation;
+      float rightEyeHfov = 0.0f;
+      if (hasRightEye) {
         pStereoRendering->CalculateStereoViewOffset(
             rightEye,
             rightEyeRotation,
@@ -1124,14 +2424,39 @@ std::vector<FCesiumCamera> ACesium3DTileset::GetPlayerCameras() const {
 
         float one_over_tan_half_hfov = projection.M[0][0];
 
-        float hfov =
+        rightEyeHfov =
             glm::degrees(2.0f * glm::atan(1.0f / one_over_tan_half_hfov));
+      }
 
-        cameras.emplace_back(
-            stereoRightSize,
-            rightEyeLocation,
-            rightEyeRotation,
-            hfov);
+      if (this->CombineStereoViews && hasLeftEye && hasRightEye) {
+        cameras.push_back(createCombinedStereoCamera(
+            FCesiumCamera(
+                stereoLeftSize,
+                leftEyeLocation,
+                leftEyeRotation,
+                leftEyeHfov),
+            FCesiumCamera(
+                stereoRightSize,
+                rightEyeLocation,
+                rightEyeRotation,
+                rightEyeHfov),
+            rotation));
+      } else {
+        if (hasLeftEye) {
+          cameras.emplace_back(
+              stereoLeftSize,
+              leftEyeLocation,
+              leftEyeRotation,
+              leftEyeHfov);
+        }
+
+        if (hasRightEye) {
+          cameras.emplace_back(
+              stereoRightSize,
+              rightEyeLocation,
+              rightEyeRotation,
+              rightEyeHfov);
+        }
       }
     } else {
       cameras.emplace_back(FVector2D(sizeX, sizeY), location, rotation, fov);
@@ -1141,61 +2466,6 @@ std::vector<FCesiumCamera> ACesium3DTileset::GetPlayerCameras() const {
   return cameras;
 }
 
-std::vector<FCesiumCamera> ACesium3DTileset::GetSceneCaptures() const {
-  // TODO: really USceneCaptureComponent2D can be attached to any actor, is it
-  // worth searching every actor? Might it be better to provide an interface
-  // where users can volunteer cameras to be used with the tile selection as
-  // needed?
-  TArray<AActor*> sceneCaptures;
-  static TSubclassOf<ASceneCapture2D> SceneCapture2D =
-      ASceneCapture2D::StaticClass();
-  UGameplayStatics::GetAllActorsOfClass(this, SceneCapture2D, sceneCaptures);
-
-  std::vector<FCesiumCamera> cameras;
-  cameras.reserve(sceneCaptures.Num());
-
-  for (AActor* pActor : sceneCaptures) {
-    ASceneCapture2D* pSceneCapture = static_cast<ASceneCapture2D*>(pActor);
-    if (!pSceneCapture) {
-      continue;
-    }
-
-    USceneCaptureComponent2D* pSceneCaptureComponent =
-        pSceneCapture->GetCaptureComponent2D();
-    if (!pSceneCaptureComponent) {
-      continue;
-    }
-
-    if (pSceneCaptureComponent->ProjectionType !=
-        ECameraProjectionMode::Type::Perspective) {
-      continue;
-    }
-
-    UTextureRenderTarget2D* pRenderTarget =
-        pSceneCaptureComponent->TextureTarget;
-    if (!pRenderTarget) {
-      continue;
-    }
-
-    FVector2D renderTargetSize(pRenderTarget->SizeX, pRenderTarget->SizeY);
-    if (renderTargetSize.X < 1.0 || renderTargetSize.Y < 1.0) {
-      continue;
-    }
-
-    FVector captureLocation = pSceneCaptureComponent->GetComponentLocation();
-    FRotator captureRotation = pSceneCaptureComponent->GetComponentRotation();
-    float captureFov = pSceneCaptureComponent->FOVAngle;
-
-    cameras.emplace_back(
-        renderTargetSize,
-        captureLocation,
-        captureRotation,
-        captureFov);
-  }
-
-  return cameras;
-}
-
 /*static*/ Cesium3DTilesSelection::ViewState
 ACesium3DTileset::CreateViewStateFromViewParameters(
     const FCesiumCamera& camera,
@@ -1275,11 +2545,20 @@ std::vector<FCesiumCamera> ACesium3DTileset::GetEditorCameras() const {
   std::vector<FCesiumCamera> cameras;
   cameras.reserve(viewportClients.Num());
 
+  // Viewports that are hidden, or that only redraw when something changes,
+  // don't need tiles to be selected for them every frame.
+  const bool onlyRealtime = this->isThrottlingEditorUpdates();
+
   for (FEditorViewportClient* pEditorViewportClient : viewportClients) {
     if (!pEditorViewportClient) {
       continue;
     }
 
+    if (onlyRealtime && (!pEditorViewportClient->IsVisible() ||
+                         !pEditorViewportClient->IsRealtime())) {
+      continue;
+    }
+
     const FVector& location = pEditorViewportClient->GetViewLocation();
     const FRotator& rotation = pEditorViewportClient->GetViewRotation();
     float fov = pEditorViewportClient->ViewFOV;
@@ -1305,8 +2584,178 @@ std::vector<FCesiumCamera> ACesium3DTileset::GetEditorCameras() const {
 
   return cameras;
 }
+
+void ACesium3DTileset::addLastViewCredits() {
+  // The credit system starts a new frame after every tick, and a credit that
+  // is not added to it again is removed from the screen. A credit that
+  // another tileset had already added in the frame of the last selection
+  // isn't recorded, and stays shown by that tileset.
+  const std::shared_ptr<Cesium3DTilesSelection::CreditSystem>& pCreditSystem =
+      this->_pTileset->getExternals().pCreditSystem;
+  if (!pCreditSystem) {
+    return;
+  }
+  for (const Cesium3DTilesSelection::Credit& credit : this->_lastViewCredits) {
+    pCreditSystem->addCreditToFrame(credit);
+  }
+}
+
+bool ACesium3DTileset::isThrottlingEditorUpdates() const {
+  if (!this->ThrottleEditorUpdates) {
+    return false;
+  }
+
+  UWorld* pWorld = this->GetWorld();
+  return IsValid(pWorld) && !pWorld->IsGameWorld();
+}
 #endif
 
+static bool camerasAreEqual(const FCesiumCamera& a, const FCesiumCamera& b) {
+  return a.ViewportSize == b.ViewportSize && a.Location == b.Location &&
+         a.Rotation == b.Rotation &&
+         a.FieldOfViewDegrees == b.FieldOfViewDegrees &&
+         a.OverrideAspectRatio == b.OverrideAspectRatio &&
+         a.ScreenSpaceErrorScale == b.ScreenSpaceErrorScale &&
+         a.MaximumViewportHeight == b.MaximumViewportHeight;
+}
+
+/**
+ * Whether the given lists contain the same tiles, in any order. They are
+ * almost always in the same order, since both come from the same selection,
+ * so they are only sorted when they are not.
+ */
+static bool tileListsAreEqual(
+    const std::vector<Cesium3DTilesSelection::Tile*>& a,
+    const std::vector<Cesium3DTilesSelection::Tile*>& b) {
+  if (a.size() != b.size()) {
+    return false;
+  }
+  if (std::equal(a.begin(), a.end(), b.begin())) {
+    return true;
+  }
+  std::vector<Cesium3DTilesSelection::Tile*> sortedA(a);
+  std::vector<Cesium3DTilesSelection::Tile*> sortedB(b);
+  std::sort(sortedA.begin(), sortedA.end());
+  std::sort(sortedB.begin(), sortedB.end());
+  return sortedA == sortedB;
+}
+
+/**
+ * Whether the given lists hold the same tile excluders, which are all still
+ * alive, in the same order.
+ */
+static bool excludersAreEqual(
+    const std::vector<std::weak_ptr<Cesium3DTilesSelection::ITileExcluder>>& a,
+    const std::vector<std::weak_ptr<Cesium3DTilesSelection::ITileExcluder>>&
+        b) {
+  if (a.size() != b.size()) {
+    return false;
+  }
+  for (size_t i = 0; i < a.size(); ++i) {
+    std::shared_ptr<Cesium3DTilesSelection::ITileExcluder> pExcluder =
+        a[i].lock();
+    if (!pExcluder || pExcluder != b[i].lock()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool ACesium3DTileset::ViewUpdateOptions::operator==(
+    const ViewUpdateOptions& other) const {
+  return maximumScreenSpaceError == other.maximumScreenSpaceError &&
+         maximumCachedBytes == other.maximumCachedBytes &&
+         maximumSimultaneousTileLoads == other.maximumSimultaneousTileLoads &&
+         loadingDescendantLimit == other.loadingDescendantLimit &&
+         culledScreenSpaceError == other.culledScreenSpaceError &&
+         preloadAncestors == other.preloadAncestors &&
+         preloadSiblings == other.preloadSiblings &&
+         forbidHoles == other.forbidHoles &&
+         enableFrustumCulling == other.enableFrustumCulling &&
+         enableFogCulling == other.enableFogCulling &&
+         enforceCulledScreenSpaceError ==
+             other.enforceCulledScreenSpaceError &&
+         captureMovieMode == other.captureMovieMode &&
+         rasterOverlayQualityTier == other.rasterOverlayQualityTier &&
+         excludersAreEqual(excluders, other.excluders) &&
+         overlays == other.overlays;
+}
+
+bool ACesium3DTileset::needsViewUpdate(
+    const std::vector<FCesiumCamera>& cameras,
+    const glm::dmat4& unrealWorldToTileset) {
+  const Cesium3DTilesSelection::TilesetOptions& options =
+      this->_pTileset->getOptions();
+
+  ViewUpdateOptions viewOptions;
+  viewOptions.maximumScreenSpaceError = options.maximumScreenSpaceError;
+  viewOptions.maximumCachedBytes = options.maximumCachedBytes;
+  viewOptions.maximumSimultaneousTileLoads =
+      int32(options.maximumSimultaneousTileLoads);
+  viewOptions.loadingDescendantLimit = int32(options.loadingDescendantLimit);
+  viewOptions.culledScreenSpaceError = options.culledScreenSpaceError;
+  viewOptions.preloadAncestors = options.preloadAncestors;
+  viewOptions.preloadSiblings = options.preloadSiblings;
+  viewOptions.forbidHoles = options.forbidHoles;
+  viewOptions.enableFrustumCulling = options.enableFrustumCulling;
+  viewOptions.enableFogCulling = options.enableFogCulling;
+  viewOptions.enforceCulledScreenSpaceError =
+      options.enforceCulledScreenSpaceError;
+  viewOptions.captureMovieMode = this->_captureMovieMode;
+  viewOptions.rasterOverlayQualityTier = this->_rasterOverlayQualityTier;
+  viewOptions.excluders.assign(
+      options.excluders.begin(),
+      options.excluders.end());
+  for (const std::unique_ptr<Cesium3DTilesSelection::RasterOverlay>& pOverlay :
+       this->_pTileset->getOverlays()) {
+    viewOptions.overlays.push_back(pOverlay.get());
+  }
+
+  // The tiles only load, and the loaded ones are only created, while the
+  // selection runs. The occlusion of tiles and the predicted views change
+  // even while the views don't. The tiles replaced in the last selection
+  // are only hidden by the next one, and the tiles kept for LodHysteresis or
+  // MinimumTileResidency are only replaced by a later one.
+  bool needed =
+      this->_viewUpdateNeeded || !this->_pLastViewUpdateResult ||
+      !this->_tilesToNoLongerRenderNextFrame.empty() ||
+      !tileListsAreEqual(
+          this->_renderedTiles,
+          this->_pLastViewUpdateResult->tilesToRenderThisFrame) ||
+      !this->_lastLoadComplete || this->_lastViewLoadingLowPriority ||
+      (this->_pResourcePreparer &&
+       this->_pResourcePreparer->getPendingComponentCount() > 0) ||
+      (this->_pFarFieldProxy && this->_pFarFieldProxy->isBuilding()) ||
+      this->_rayTracingTilesPending || this->_distanceFieldBuildsPending ||
+      this->_pOcclusionExcluder != nullptr ||
+      !(viewOptions == this->_lastViewOptions) ||
+      unrealWorldToTileset != this->_lastViewUnrealWorldToTileset ||
+      cameras.size() != this->_lastViewCameras.size();
+  for (size_t i = 0; !needed && i < cameras.size(); ++i) {
+    needed = !camerasAreEqual(cameras[i], this->_lastViewCameras[i]);
+  }
+  for (size_t i = 0; !needed && i < this->_cameraVelocities.size(); ++i) {
+    needed = !this->_cameraVelocities[i].IsZero();
+  }
+
+  this->_viewUpdateNeeded = false;
+  this->_lastViewCameras = cameras;
+  this->_lastViewUnrealWorldToTileset = unrealWorldToTileset;
+  this->_lastViewOptions = viewOptions;
+  return needed;
+}
+
+const glm::dmat4& ACesium3DTileset::getUnrealWorldToTileset() {
+  const glm::dmat4& tilesetToUnrealRelativeWorld =
+      this->GetCesiumTilesetToUnrealRelativeWorldTransform();
+  if (tilesetToUnrealRelativeWorld != this->_tilesetToUnrealRelativeWorld) {
+    this->_tilesetToUnrealRelativeWorld = tilesetToUnrealRelativeWorld;
+    this->_unrealWorldToTileset =
+        glm::affineInverse(tilesetToUnrealRelativeWorld);
+  }
+  return this->_unrealWorldToTileset;
+}
+
 bool ACesium3DTileset::ShouldTickIfViewportsOnly() const {
   return this->UpdateInEditor;
 }
@@ -1356,19 +2805,35 @@ bool isInExclusionZone(
   return false;
 }
 
-void removeVisibleTilesFromList(
-    std::vector<Cesium3DTilesSelection::Tile*>& list,
+/**
+ * @brief Removes all tiles that are in the given list of visible tiles from
+ * the given list.
+ *
+ * The visible tiles are collected in a hash set first, so this is linear in
+ * the size of both lists rather than quadratic.
+ *
+ * @param list The list to remove the visible tiles from
+ * @param visibleTiles The tiles that are visible in the current frame
+ */
+void removeVisibleTilesFromList(
+    std::vector<Cesium3DTilesSelection::Tile*>& list,
     const std::vector<Cesium3DTilesSelection::Tile*>& visibleTiles) {
-  if (list.empty()) {
+  if (list.empty() || visibleTiles.empty()) {
     return;
   }
 
-  for (Cesium3DTilesSelection::Tile* pTile : visibleTiles) {
-    auto it = std::find(list.begin(), list.end(), pTile);
-    if (it != list.end()) {
-      list.erase(it);
-    }
-  }
+  const std::unordered_set<Cesium3DTilesSelection::Tile*> visibleSet(
+      visibleTiles.begin(),
+      visibleTiles.end());
+
+  list.erase(
+      std::remove_if(
+          list.begin(),
+          list.end(),
+          [&visibleSet](Cesium3DTilesSelection::Tile* pTile) {
+            return visibleSet.find(pTile) != visibleSet.end();
+          }),
+      list.end());
 }
 
 /**
@@ -1390,8 +2855,16 @@ void hideTilesToNoLongerRender(
     UCesiumGltfComponent* Gltf =
         static_cast<UCesiumGltfComponent*>(pTile->getRendererResources());
     if (Gltf && Gltf->IsVisible()) {
-      Gltf->SetVisibility(false, true);
-      Gltf->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+      Gltf->SetTileVisibility(false);
+      if (CesiumTileTrace::isEnabled()) {
+        CesiumTileTrace::recordStage(
+            CesiumTileTrace::Stage::Hidden,
+            CesiumTileTrace::getTileKey(*pTile));
+      }
+
+      // Only the smallest mips of streamed textures are kept for tiles that
+      // are not rendered. This has no effect without streamed textures.
+      Gltf->UpdateTextureStreaming(0.0f);
     } else {
       // TODO: why is this happening?
       UE_LOG(
@@ -1401,54 +2874,491 @@ void hideTilesToNoLongerRender(
     }
   }
 }
+} // namespace
 
-/**
- * @brief Applies the actor collision settings for a newly created glTF
- * component
- *
- * TODO Add details here what that means
- * @param BodyInstance ...
- * @param Gltf ...
- */
-void applyActorCollisionSettings(
-    const FBodyInstance& BodyInstance,
-    UCesiumGltfComponent* Gltf) {
-  UCesiumGltfPrimitiveComponent* PrimitiveComponent =
-      static_cast<UCesiumGltfPrimitiveComponent*>(Gltf->GetChildComponent(0));
-  if (PrimitiveComponent != nullptr) {
-    if (PrimitiveComponent->GetCollisionObjectType() !=
-        BodyInstance.GetObjectType()) {
-      PrimitiveComponent->SetCollisionObjectType(BodyInstance.GetObjectType());
-    }
-    const UEnum* ChannelEnum = StaticEnum<ECollisionChannel>();
-    if (ChannelEnum) {
-      FCollisionResponseContainer responseContainer =
-          BodyInstance.GetResponseToChannels();
-      PrimitiveComponent->SetCollisionResponseToChannels(responseContainer);
+void ACesium3DTileset::updateOcclusionExcluder(
+    Cesium3DTilesSelection::TilesetOptions& options) {
+  const bool useOcclusion = this->EnableOcclusionCulling &&
+                            options.enableFrustumCulling && this->GetWorld();
+  if (!useOcclusion) {
+    if (this->_pOcclusionExcluder) {
+      auto& excluders = options.excluders;
+      excluders.erase(
+          std::remove(
+              excluders.begin(),
+              excluders.end(),
+              this->_pOcclusionExcluder),
+          excluders.end());
+      this->_pOcclusionExcluder.reset();
     }
+    return;
+  }
+
+  if (!this->_pOcclusionExcluder) {
+    this->_pOcclusionExcluder = std::make_shared<CesiumOcclusionTileExcluder>();
+    options.excluders.push_back(this->_pOcclusionExcluder);
   }
+
+  this->_pOcclusionExcluder->update(
+      this->GetWorld()->GetTimeSeconds(),
+      this->OcclusionCullingDelay,
+      this->OcclusionRetestInterval);
 }
-} // namespace
 
 void ACesium3DTileset::updateTilesetOptionsFromProperties() {
   Cesium3DTilesSelection::TilesetOptions& options =
       this->_pTileset->getOptions();
   options.maximumScreenSpaceError =
-      static_cast<double>(this->MaximumScreenSpaceError);
+      static_cast<double>(this->GetEffectiveScreenSpaceError());
   options.maximumCachedBytes = this->MaximumCachedBytes;
   options.preloadAncestors = this->PreloadAncestors;
   options.preloadSiblings = this->PreloadSiblings;
   options.forbidHoles = this->ForbidHoles;
   options.maximumSimultaneousTileLoads = this->MaximumSimultaneousTileLoads;
+  if (this->AdaptSimultaneousTileLoads && this->_pTileLoadController) {
+    options.maximumSimultaneousTileLoads =
+        this->_pTileLoadController->getLimit();
+  }
+
+  // When the tilesets in the world share a budget, use no more than this
+  // tileset's share of it.
+  UCesiumTileLoadScheduler* pScheduler = this->GetTileLoadScheduler();
+  int32 allocatedTileLoads = 0;
+  int32 allocatedRasterOverlayTileLoads = 0;
+  int64 allocatedCachedBytes = 0;
+  bool useAllocation = pScheduler && pScheduler->GetAllocation(
+                                         this,
+                                         allocatedTileLoads,
+                                         allocatedRasterOverlayTileLoads,
+                                         allocatedCachedBytes);
+  if (useAllocation) {
+    options.maximumSimultaneousTileLoads = FMath::Min(
+        options.maximumSimultaneousTileLoads,
+        allocatedTileLoads);
+    options.maximumCachedBytes =
+        FMath::Min(this->MaximumCachedBytes, allocatedCachedBytes);
+  }
+
+  // The tile selection only knows the size of the loaded tile data, so scale
+  // its limit down by how much larger the objects created from that data are.
+  if (this->LimitCacheByMeasuredMemory) {
+    int64 dataBytes = this->_pTileset->getTotalDataBytes();
+    int64 measuredBytes = this->GetMemoryStatistics().TotalBytes;
+    if (dataBytes > 0 && measuredBytes > dataBytes) {
+      options.maximumCachedBytes = static_cast<int64>(
+          static_cast<double>(options.maximumCachedBytes) *
+          static_cast<double>(dataBytes) / static_cast<double>(measuredBytes));
+    }
+  }
+
+  // While memory is low, the tiles that are not visible are unloaded down to
+  // a fraction of the usual cache size.
+  const double cacheFraction = double(
+      GetDefault<UCesiumRuntimeSettings>()->MemoryPressureCacheFraction);
+  if (this->_underMemoryPressure) {
+    options.maximumCachedBytes = static_cast<int64>(
+        static_cast<double>(options.maximumCachedBytes) * cacheFraction);
+  }
+
+  TArray<UCesiumRasterOverlay*> rasterOverlays;
+  this->GetComponents<UCesiumRasterOverlay>(rasterOverlays);
+  for (UCesiumRasterOverlay* pOverlay : rasterOverlays) {
+    pOverlay->SetTileLoadLimit(
+        useAllocation ? allocatedRasterOverlayTileLoads : -1);
+    pOverlay->SetAdaptiveQualityTier(this->_rasterOverlayQualityTier);
+    pOverlay->SetSubTileCacheLimit(
+        this->_underMemoryPressure
+            ? static_cast<int64>(
+                  static_cast<double>(pOverlay->GetSubTileCacheBytes()) *
+                  cacheFraction)
+            : -1);
+  }
   options.loadingDescendantLimit = this->LoadingDescendantLimit;
 
-  options.enableFrustumCulling = this->EnableFrustumCulling;
-  options.enableFogCulling = this->EnableFogCulling;
+  // A tile is loaded and rendered instead of its descendants when more than
+  // loadingDescendantLimit of them are not loaded yet. In a quadtree, that
+  // is when they are more than the given number of levels below it.
+  if (this->SkipLevelOfDetail && this->_baseLevelOfDetailLoaded) {
+    options.preloadAncestors = false;
+    options.forbidHoles = false;
+    if (this->ImmediatelyLoadDesiredLevelOfDetail) {
+      options.loadingDescendantLimit = TNumericLimits<int32>::Max();
+    } else {
+      // Each level halves the screen-space error of its parent.
+      const int32 factorLevels = FMath::CeilToInt(
+          FMath::Log2(FMath::Max(this->SkipScreenSpaceErrorFactor, 1.0f)));
+      const int32 levels =
+          FMath::Clamp(FMath::Max(this->SkipLevels, factorLevels), 0, 15);
+      options.loadingDescendantLimit =
+          FMath::Max(this->LoadingDescendantLimit, 1 << (2 * levels));
+    }
+  }
+
+  // Collision is needed all around the pawns, not just in front of them.
+  options.enableFrustumCulling =
+      this->EnableFrustumCulling && !this->CollisionOnly;
+  options.enableFogCulling = this->EnableFogCulling && !this->CollisionOnly;
+  this->updateOcclusionExcluder(options);
   options.enforceCulledScreenSpaceError = this->EnforceCulledScreenSpaceError;
   options.culledScreenSpaceError =
       static_cast<double>(this->CulledScreenSpaceError);
 }
 
+FCesiumTilesetMemoryStatistics ACesium3DTileset::GetMemoryStatistics() const {
+  FCesiumTilesetMemoryStatistics statistics;
+
+  TArray<UCesiumGltfComponent*> gltfComponents;
+  this->GetComponents<UCesiumGltfComponent>(gltfComponents);
+  for (const UCesiumGltfComponent* pGltf : gltfComponents) {
+    statistics += pGltf->GetMemoryUsage();
+  }
+
+  if (this->_pResourcePreparer) {
+    statistics.RasterOverlayTextureBytes =
+        this->_pResourcePreparer->getRasterOverlayTextureBytes();
+    statistics.TextureBytes +=
+        this->_pResourcePreparer->getWaterMaskAtlasBytes();
+  }
+
+  statistics.UpdateTotalBytes();
+  return statistics;
+}
+
+float ACesium3DTileset::GetLoadProgress() const {
+  const ACesium3DTileset* pShared = this->getSharedTileset();
+  return pShared ? pShared->GetLoadProgress() : this->_lastLoadProgress;
+}
+
+bool ACesium3DTileset::IsLoadComplete() const {
+  const ACesium3DTileset* pShared = this->getSharedTileset();
+  if (pShared) {
+    return pShared->IsLoadComplete();
+  }
+  return this->_pTileset && this->_lastLoadComplete;
+}
+
+int32 ACesium3DTileset::GetNumberOfTilesRendered() const {
+  const ACesium3DTileset* pShared = this->getSharedTileset();
+  if (pShared) {
+    return pShared->GetNumberOfTilesRendered();
+  }
+  return this->_pTileset ? this->_lastNumberOfTilesRendered : 0;
+}
+
+int32 ACesium3DTileset::GetNumberOfTilesLoaded() const {
+  const ACesium3DTileset* pShared = this->getSharedTileset();
+  if (pShared) {
+    return pShared->GetNumberOfTilesLoaded();
+  }
+  return this->_pTileset ? this->_pTileset->getNumberOfTilesLoaded() : 0;
+}
+
+void ACesium3DTileset::GetRenderedTileMeshComponents(
+    TArray<UStaticMeshComponent*>& OutComponents) const {
+  const ACesium3DTileset* pShared = this->getSharedTileset();
+  if (pShared) {
+    pShared->GetRenderedTileMeshComponents(OutComponents);
+    return;
+  }
+
+  for (Cesium3DTilesSelection::Tile* pTile : this->_renderedTiles) {
+    if (pTile->getState() != Cesium3DTilesSelection::Tile::LoadState::Done) {
+      continue;
+    }
+
+    UCesiumGltfComponent* pGltf =
+        static_cast<UCesiumGltfComponent*>(pTile->getRendererResources());
+    if (!pGltf) {
+      continue;
+    }
+
+    for (USceneComponent* pChild : pGltf->GetAttachChildren()) {
+      UCesiumGltfPrimitiveComponent* pPrimitive =
+          Cast<UCesiumGltfPrimitiveComponent>(pChild);
+      if (pPrimitive) {
+        if (!pPrimitive->IsPointCloud && !pPrimitive->IsHeightfield &&
+            pPrimitive->GetStaticMesh()) {
+          OutComponents.Add(pPrimitive);
+        }
+        continue;
+      }
+
+      UCesiumGltfInstancedComponent* pInstanced =
+          Cast<UCesiumGltfInstancedComponent>(pChild);
+      if (pInstanced && pInstanced->GetStaticMesh()) {
+        OutComponents.Add(pInstanced);
+      }
+    }
+  }
+}
+
+TArray<FCesiumFeatureHandle>
+ACesium3DTileset::FindFeaturesInSphere(const FVector& Center, float Radius)
+    const {
+  TArray<FCesiumFeatureHandle> result;
+  if (this->_pResourcePreparer) {
+    this->_pResourcePreparer->getFeatureIndex().findInSphere(
+        Center,
+        Radius,
+        result);
+  }
+  return result;
+}
+
+TArray<FCesiumFeatureHandle>
+ACesium3DTileset::FindFeaturesInBox(const FBox& Box) const {
+  TArray<FCesiumFeatureHandle> result;
+  if (this->_pResourcePreparer) {
+    this->_pResourcePreparer->getFeatureIndex().findInBox(Box, result);
+  }
+  return result;
+}
+
+TArray<FCesiumFeatureHandle>
+ACesium3DTileset::FindFeaturesInPolygon(ACesiumCartographicPolygon* Polygon) {
+  TArray<FCesiumFeatureHandle> result;
+  ACesiumGeoreference* pGeoreference = this->ResolveGeoreference();
+  if (!this->_pResourcePreparer || !IsValid(Polygon) ||
+      !IsValid(pGeoreference)) {
+    return result;
+  }
+
+  CesiumPolygonTileExcluder polygons({Polygon->CreateCartographicPolygon()});
+  this->_pResourcePreparer->getFeatureIndex().findInPolygons(
+      polygons,
+      *pGeoreference,
+      result);
+  return result;
+}
+
+TArray<FCesiumFeatureHandle>
+ACesium3DTileset::FindFeaturesAlongRay(const FVector& Start, const FVector& End)
+    const {
+  TArray<FCesiumFeatureHandle> result;
+  if (this->_pResourcePreparer) {
+    this->_pResourcePreparer->getFeatureIndex().findAlongRay(
+        Start,
+        End,
+        result);
+  }
+  return result;
+}
+
+void ACesium3DTileset::RaycastBatch(
+    const TArray<FVector>& Starts,
+    const TArray<FVector>& Ends,
+    const FCesiumGeometryQueryDelegate& OnComplete) {
+  if (Starts.Num() != Ends.Num()) {
+    UE_LOG(
+        LogCesium,
+        Warning,
+        TEXT("RaycastBatch was given %d starts but %d ends, so the rays "
+             "without both are ignored."),
+        Starts.Num(),
+        Ends.Num());
+  }
+
+  const int32 numRays = FMath::Min(Starts.Num(), Ends.Num());
+  this->castGeometryQueryRays(
+      TArray<FVector>(Starts.GetData(), numRays),
+      TArray<FVector>(Ends.GetData(), numRays),
+      [OnComplete](TArray<FCesiumGeometryHit>&& hits) {
+        OnComplete.ExecuteIfBound(hits);
+      });
+}
+
+void ACesium3DTileset::SampleHeights(
+    const TArray<FVector>& Locations,
+    float MaximumDistance,
+    const FCesiumGeometryQueryDelegate& OnComplete) {
+  ACesiumGeoreference* pGeoreference = this->ResolveGeoreference();
+  if (!IsValid(pGeoreference)) {
+    TArray<FCesiumGeometryHit> misses;
+    misses.SetNum(Locations.Num());
+    OnComplete.ExecuteIfBound(misses);
+    return;
+  }
+
+  TArray<FVector> starts;
+  TArray<FVector> ends;
+  starts.SetNumUninitialized(Locations.Num());
+  ends.SetNumUninitialized(Locations.Num());
+  for (int32 i = 0; i < Locations.Num(); ++i) {
+    const FVector& location = Locations[i];
+    const glm::dvec3 up = pGeoreference->ComputeEastNorthUpToUnreal(
+        glm::dvec3(location.X, location.Y, location.Z))[2];
+    const FVector offset =
+        FVector(up.x, up.y, up.z).GetSafeNormal() * MaximumDistance;
+    starts[i] = location + offset;
+    ends[i] = location - offset;
+  }
+
+  TWeakObjectPtr<ACesiumGeoreference> pWeakGeoreference = pGeoreference;
+  this->castGeometryQueryRays(
+      MoveTemp(starts),
+      MoveTemp(ends),
+      [OnComplete, pWeakGeoreference](TArray<FCesiumGeometryHit>&& hits) {
+        if (ACesiumGeoreference* pGeoreference = pWeakGeoreference.Get()) {
+          for (FCesiumGeometryHit& hit : hits) {
+            if (hit.bBlockingHit) {
+              hit.Height = float(
+                  pGeoreference
+                      ->TransformUnrealToLongitudeLatitudeHeight(glm::dvec3(
+                          hit.Location.X,
+                          hit.Location.Y,
+                          hit.Location.Z))
+                      .z);
+            }
+          }
+        }
+        OnComplete.ExecuteIfBound(hits);
+      });
+}
+
+namespace {
+
+/**
+ * A primitive that the rays of a geometry query are cast against.
+ */
+struct GeometryQueryPart {
+  std::shared_ptr<const CesiumTriangleBVH> pBVH;
+  FTransform transform;
+  FBox bounds;
+};
+
+/**
+ * Casts a ray against the given primitives, from start to end, in Unreal
+ * world coordinates.
+ */
+FCesiumGeometryHit castGeometryQueryRay(
+    const std::vector<GeometryQueryPart>& parts,
+    const FVector& start,
+    const FVector& end) {
+  FCesiumGeometryHit result;
+  const FVector ray = end - start;
+  if (ray.IsNearlyZero()) {
+    return result;
+  }
+
+  // The distances along the rays are fractions of their lengths, which are
+  // the same in the coordinates of the primitives and of the world.
+  float nearest = 1.0f;
+  for (const GeometryQueryPart& part : parts) {
+    if (!FMath::LineBoxIntersection(part.bounds, start, end, ray)) {
+      continue;
+    }
+
+    const FVector localStart = part.transform.InverseTransformPosition(start);
+    const FVector localEnd = part.transform.InverseTransformPosition(end);
+    CesiumTriangleBVH::Hit hit;
+    if (!part.pBVH->raycast(localStart, localEnd - localStart, nearest, hit)) {
+      continue;
+    }
+
+    // Normals are transformed by the inverse of the scale.
+    nearest = hit.distance;
+    result.bBlockingHit = true;
+    result.Normal = part.transform.GetRotation()
+                        .RotateVector(
+                            hit.normal * FTransform::GetSafeScaleReciprocal(
+                                             part.transform.GetScale3D()))
+                        .GetSafeNormal();
+  }
+
+  if (result.bBlockingHit) {
+    result.Location = start + ray * nearest;
+    result.Distance = float(ray.Size() * nearest);
+    if (FVector::DotProduct(result.Normal, ray) > 0.0) {
+      result.Normal = -result.Normal;
+    }
+  }
+  return result;
+}
+
+} // namespace
+
+void ACesium3DTileset::castGeometryQueryRays(
+    TArray<FVector>&& starts,
+    TArray<FVector>&& ends,
+    TFunction<void(TArray<FCesiumGeometryHit>&&)>&& onComplete) {
+  CESIUM_TRACE("ACesium3DTileset::castGeometryQueryRays");
+
+  // The hierarchies are shared with the rays, so tiles that are unloaded
+  // before the rays are cast don't free them.
+  std::vector<GeometryQueryPart> parts;
+  TArray<UCesiumGltfPrimitiveComponent*> primitives;
+  this->GetComponents<UCesiumGltfPrimitiveComponent>(primitives);
+  for (UCesiumGltfPrimitiveComponent* pPrimitive : primitives) {
+    if (!pPrimitive->pQueryBVH || !pPrimitive->IsVisible()) {
+      continue;
+    }
+    const FTransform& transform = pPrimitive->GetComponentTransform();
+    parts.push_back(
+        {pPrimitive->pQueryBVH,
+         transform,
+         pPrimitive->pQueryBVH->getBounds().TransformBy(transform)});
+  }
+
+  TWeakObjectPtr<ACesium3DTileset> pThis = this;
+  Async(
+      EAsyncExecution::ThreadPool,
+      [pThis,
+       parts = std::move(parts),
+       starts = MoveTemp(starts),
+       ends = MoveTemp(ends),
+       onComplete = MoveTemp(onComplete)]() mutable {
+        CESIUM_TRACE("Cesium::GeometryQuery");
+
+        TArray<FCesiumGeometryHit> hits;
+        hits.SetNum(starts.Num());
+        ParallelFor(starts.Num(), [&](int32 i) {
+          hits[i] = castGeometryQueryRay(parts, starts[i], ends[i]);
+        });
+
+        AsyncTask(
+            ENamedThreads::GameThread,
+            [pThis,
+             hits = MoveTemp(hits),
+             onComplete = MoveTemp(onComplete)]() mutable {
+              if (pThis.IsValid()) {
+                onComplete(MoveTemp(hits));
+              }
+            });
+      });
+}
+
+void ACesium3DTileset::updateLoadState(
+    const Cesium3DTilesSelection::ViewUpdateResult& result) {
+  this->_lastLoadProgress = this->_pTileset->computeLoadProgress();
+  this->_lastNumberOfTilesRendered =
+      int32(result.tilesToRenderThisFrame.size());
+  this->_lastLoadComplete = this->_lastLoadProgress >= 100.0f &&
+                            result.tilesLoadingHighPriority == 0 &&
+                            result.tilesLoadingMediumPriority == 0;
+  if (!this->_lastLoadComplete) {
+    return;
+  }
+
+  // Tiles are rendered with the overlays of their ancestors while their own
+  // raster overlay tiles are still loading.
+  using AttachmentState =
+      Cesium3DTilesSelection::RasterMappedTo3DTile::AttachmentState;
+  for (const Cesium3DTilesSelection::Tile* pTile :
+       result.tilesToRenderThisFrame) {
+    if (pTile->getState() != Cesium3DTilesSelection::Tile::LoadState::Done) {
+      this->_lastLoadComplete = false;
+      return;
+    }
+    for (const Cesium3DTilesSelection::RasterMappedTo3DTile& mapped :
+         pTile->getMappedRasterTiles()) {
+      if (mapped.getState() != AttachmentState::Attached) {
+        this->_lastLoadComplete = false;
+        return;
+      }
+    }
+  }
+}
+
 void ACesium3DTileset::updateLastViewUpdateResultState(
     const Cesium3DTilesSelection::ViewUpdateResult& result) {
   if (!this->LogSelectionStats) {
@@ -1513,6 +3423,15 @@ void ACesium3DTileset::showTilesToRender(
     // 11626) { 	continue;
     //}
 
+    // The tiles drawn by the far-field proxy stay hidden.
+    if (this->_farFieldShown &&
+        std::binary_search(
+            this->_farFieldTiles.begin(),
+            this->_farFieldTiles.end(),
+            pTile)) {
+      continue;
+    }
+
     UCesiumGltfComponent* Gltf =
         static_cast<UCesiumGltfComponent*>(pTile->getRendererResources());
     if (!Gltf) {
@@ -1523,8 +3442,6 @@ void ACesium3DTileset::showTilesToRender(
       continue;
     }
 
-    applyActorCollisionSettings(BodyInstance, Gltf);
-
     if (Gltf->GetAttachParent() == nullptr) {
 
       // The AttachToComponent method is ridiculously complex,
@@ -1546,8 +3463,12 @@ void ACesium3DTileset::showTilesToRender(
     }
 
     if (!Gltf->IsVisible()) {
-      Gltf->SetVisibility(true, true);
-      Gltf->SetCollisionEnabled(ECollisionEnabled::QueryAndPhysics);
+      Gltf->SetTileVisibility(true);
+      if (CesiumTileTrace::isEnabled()) {
+        CesiumTileTrace::recordStage(
+            CesiumTileTrace::Stage::Shown,
+            CesiumTileTrace::getTileKey(*pTile));
+      }
     }
   }
 }
@@ -1556,6 +3477,12 @@ void ACesium3DTileset::showTilesToRender(
 void ACesium3DTileset::Tick(float DeltaTime) {
   Super::Tick(DeltaTime);
 
+  const double tickStartSeconds = FPlatformTime::Seconds();
+  ON_SCOPE_EXIT {
+    CesiumRuntimeStats::addGameThreadTime(
+        FPlatformTime::Seconds() - tickStartSeconds);
+  };
+
   UCesium3DTilesetRoot* pRoot = Cast<UCesium3DTilesetRoot>(this->RootComponent);
   if (!pRoot) {
     return;
@@ -1565,115 +3492,1392 @@ void ACesium3DTileset::Tick(float DeltaTime) {
     return;
   }
 
+  if (!this->_pTileset && !this->_pSharedTileset.IsExplicitlyNull()) {
+    if (this->getSharedTileset()) {
+      // The tileset that this one shares its tiles with selects and draws
+      // them.
+      return;
+    }
+
+    // That tileset went away or changed, so this one loads the tiles again.
+    this->_shareKey.Empty();
+    this->_pSharedTileset.Reset();
+  }
+
   if (!this->_pTileset) {
     LoadTileset();
 
-    // In the unlikely event that we _still_ don't have a tileset, stop here so
-    // we don't crash below. This shouldn't happen.
+    // The tileset isn't loaded until the shared asset accessor is ready, or
+    // when it shares the tiles of another one.
     if (!this->_pTileset) {
-      assert(false);
       return;
     }
   }
 
+#if WITH_EDITOR
+  const bool throttleEditorUpdates = this->isThrottlingEditorUpdates();
+  if (throttleEditorUpdates) {
+    if (this->MaximumEditorUpdateRate > 0.0f &&
+        tickStartSeconds - this->_lastEditorUpdateTime <
+            1.0 / double(this->MaximumEditorUpdateRate)) {
+      // The credits of the last update stay shown until the next one.
+      this->addLastViewCredits();
+      return;
+    }
+    this->_lastEditorUpdateTime = tickStartSeconds;
+  }
+#endif
+
+  updateMemoryPressure();
+  updateScreenSpaceErrorController();
+  updateRasterOverlayQuality();
   updateTilesetOptionsFromProperties();
 
-  std::vector<FCesiumCamera> cameras = this->GetCameras();
+  std::vector<FCesiumCamera> cameras;
+  if (this->CollisionOnly) {
+    cameras = this->GetPawnCameras();
+    std::vector<FCesiumCamera> pointOfInterestCameras =
+        this->GetPointOfInterestCameras(false);
+    cameras.insert(
+        cameras.end(),
+        std::make_move_iterator(pointOfInterestCameras.begin()),
+        std::make_move_iterator(pointOfInterestCameras.end()));
+  } else {
+    cameras = this->GetCameras();
+  }
   if (cameras.empty()) {
     return;
   }
 
-  glm::dmat4 unrealWorldToTileset = glm::affineInverse(
-      this->GetCesiumTilesetToUnrealRelativeWorldTransform());
+  if (!this->CollisionOnly) {
+    this->updatePipelinePrecache(cameras);
+  }
+
+  const std::vector<FCesiumCamera> preloadCameras =
+      this->CollisionOnly ? std::vector<FCesiumCamera>()
+                          : this->getSequencerPreloadCameras(cameras);
+
+  const glm::dmat4& unrealWorldToTileset = this->getUnrealWorldToTileset();
+
+  // When nothing changed, the last selection is still valid and the tiles
+  // are already up to date, except for the deferred collision, whose sources
+  // may have moved. The last selection then rendered exactly its own tiles.
+  bool skipUnchanged = this->SkipUnchangedViewUpdates;
+#if WITH_EDITOR
+  skipUnchanged = skipUnchanged || throttleEditorUpdates;
+#endif
+  if (skipUnchanged && preloadCameras.empty() &&
+      !this->needsViewUpdate(cameras, unrealWorldToTileset)) {
+    this->addLastViewCredits();
+    CesiumRuntimeStats::addViewUpdateResult(*this->_pLastViewUpdateResult);
+    cookDeferredCollision(this->_renderedTiles);
+    return;
+  }
+  if (!skipUnchanged) {
+    this->_viewUpdateNeeded = true;
+  }
+
+  applyCameraDetail(cameras);
+  this->AddPredictedCameras(cameras, DeltaTime);
 
-  std::vector<Cesium3DTilesSelection::ViewState> frustums;
+  std::vector<Cesium3DTilesSelection::ViewState>& frustums = this->_frustums;
+  frustums.clear();
+  frustums.reserve(cameras.size() + preloadCameras.size());
   for (const FCesiumCamera& camera : cameras) {
     frustums.push_back(
         CreateViewStateFromViewParameters(camera, unrealWorldToTileset));
   }
 
-  const Cesium3DTilesSelection::ViewUpdateResult& result =
-      this->_captureMovieMode ? this->_pTileset->updateViewOffline(frustums)
-                              : this->_pTileset->updateView(frustums);
-  updateLastViewUpdateResultState(result);
+  const auto addPreloadFrustums = [&frustums,
+                                   &preloadCameras,
+                                   &unrealWorldToTileset]() {
+    for (const FCesiumCamera& camera : preloadCameras) {
+      frustums.push_back(
+          CreateViewStateFromViewParameters(camera, unrealWorldToTileset));
+    }
+  };
 
-  removeVisibleTilesFromList(
-      this->_tilesToNoLongerRenderNextFrame,
-      result.tilesToRenderThisFrame);
-  hideTilesToNoLongerRender(this->_tilesToNoLongerRenderNextFrame);
-  this->_tilesToNoLongerRenderNextFrame = result.tilesToNoLongerRenderThisFrame;
-  showTilesToRender(result.tilesToRenderThisFrame);
+  // The credits that the selection adds are recorded for the frames where
+  // it is skipped.
+  const std::shared_ptr<Cesium3DTilesSelection::CreditSystem>& pCreditSystem =
+      this->_pTileset->getExternals().pCreditSystem;
+  const size_t creditCount =
+      pCreditSystem ? pCreditSystem->getCreditsToShowThisFrame().size() : 0;
+
+  // The selection must run on the game thread, because it also advances tile
+  // loading, which creates Unreal objects for tiles that finished loading.
+  const Cesium3DTilesSelection::ViewUpdateResult* pResult;
+  if (this->_captureMovieMode) {
+    // A captured frame only waits for the tiles of its own views, and only
+    // renders those. The upcoming views are selected afterward, which starts
+    // loading their tiles while this frame renders. That selection replaces
+    // the result of the tileset, so the captured one is copied first.
+    Cesium3DTilesSelection::ViewUpdateResult& captured =
+        this->_capturedViewUpdateResult;
+    captured = this->_pTileset->updateViewOffline(frustums);
+    if (!preloadCameras.empty()) {
+      // The tileset compares the captured selection with its selection for
+      // the upcoming views, whose tiles were never rendered, so the tiles
+      // rendered in the last frame that are no longer needed are found here.
+      std::vector<Cesium3DTilesSelection::Tile*> noLongerRendered =
+          this->_renderedTiles;
+      removeVisibleTilesFromList(
+          noLongerRendered,
+          captured.tilesToRenderThisFrame);
+      captured.tilesToNoLongerRenderThisFrame.insert(
+          captured.tilesToNoLongerRenderThisFrame.end(),
+          noLongerRendered.begin(),
+          noLongerRendered.end());
+
+      addPreloadFrustums();
+      this->_pTileset->updateView(frustums);
+    }
+    pResult = &captured;
+  } else {
+    addPreloadFrustums();
+    pResult = &this->_pTileset->updateView(frustums);
+  }
+  const Cesium3DTilesSelection::ViewUpdateResult& result = *pResult;
+  this->_lastViewCredits.clear();
+  if (pCreditSystem) {
+    const std::vector<Cesium3DTilesSelection::Credit>& credits =
+        pCreditSystem->getCreditsToShowThisFrame();
+    this->_lastViewCredits.assign(
+        credits.begin() + std::min(creditCount, credits.size()),
+        credits.end());
+  }
+  updateLastViewUpdateResultState(result);
+  CesiumRuntimeStats::addViewUpdateResult(result);
+  this->_pLastViewUpdateResult = &result;
+  this->_lastViewLoadingLowPriority = result.tilesLoadingLowPriority > 0;
+  updateLoadState(result);
+  updateTileLoadController(result);
+  reportTileLoadDemand(result);
+  CesiumTileTrace::addQueueDepths(
+      int32(result.tilesLoadingHighPriority),
+      int32(result.tilesLoadingMediumPriority),
+      int32(result.tilesLoadingLowPriority),
+      this->_pResourcePreparer
+          ? this->_pResourcePreparer->getPendingComponentCount()
+          : 0);
+  const std::vector<Cesium3DTilesSelection::Tile*>& tilesToRender =
+      applyViewUpdateResult(result, frustums);
+  this->_baseLevelOfDetailLoaded =
+      this->SkipLevelOfDetail &&
+      this->isBaseLevelOfDetailLoaded(tilesToRender, frustums);
+
+  createPendingTilePrimitives(frustums);
+  cookDeferredCollision(tilesToRender);
+  updateTextureStreaming(tilesToRender, cameras);
+  updateShadowCasting(tilesToRender, cameras);
+  updateRayTracing(tilesToRender, cameras);
+  buildDistanceFields(tilesToRender, cameras);
+  updateCullDistances(tilesToRender, frustums);
+  updateFarField(tilesToRender, cameras);
 }
 
-void ACesium3DTileset::EndPlay(const EEndPlayReason::Type EndPlayReason) {
-  this->DestroyTileset();
-  AActor::EndPlay(EndPlayReason);
+/**
+ * @brief Computes the largest size of the primitives of the given glTF
+ * component on the screen of any of the given cameras, in pixels.
+ */
+static float computeScreenSize(
+    const UCesiumGltfComponent* pGltf,
+    const std::vector<FCesiumCamera>& cameras) {
+  float screenSize = 0.0f;
+  for (const USceneComponent* pChild : pGltf->GetAttachChildren()) {
+    const UPrimitiveComponent* pPrimitive = Cast<UPrimitiveComponent>(pChild);
+    if (!pPrimitive) {
+      continue;
+    }
+
+    const FBoxSphereBounds& bounds = pPrimitive->Bounds;
+    for (const FCesiumCamera& camera : cameras) {
+      const float distance = FMath::Max(
+          float(FVector::Dist(camera.Location, bounds.Origin)) -
+              float(bounds.SphereRadius),
+          1.0f);
+      const float tanHalfFov = FMath::Tan(
+          FMath::DegreesToRadians(camera.FieldOfViewDegrees * 0.5f));
+      screenSize = FMath::Max(
+          screenSize,
+          float(bounds.SphereRadius) * float(camera.ViewportSize.X) /
+              (distance * tanHalfFov));
+    }
+  }
+  return screenSize;
 }
 
-void ACesium3DTileset::PostLoad() {
-  BodyInstance.FixupData(this); // We need to call this one after Loading the
-                                // actor to have correct BodyInstance values.
+void ACesium3DTileset::updateTextureStreaming(
+    const std::vector<Cesium3DTilesSelection::Tile*>& tiles,
+    const std::vector<FCesiumCamera>& cameras) {
+  if (!this->StreamTileTextures) {
+    return;
+  }
 
-  Super::PostLoad();
+  for (Cesium3DTilesSelection::Tile* pTile : tiles) {
+    if (pTile->getState() != Cesium3DTilesSelection::Tile::LoadState::Done) {
+      continue;
+    }
+
+    UCesiumGltfComponent* pGltf =
+        static_cast<UCesiumGltfComponent*>(pTile->getRendererResources());
+    if (pGltf) {
+      // While memory is low, each texture keeps one mip less.
+      const float screenSize = computeScreenSize(pGltf, cameras);
+      pGltf->UpdateTextureStreaming(
+          this->_underMemoryPressure ? 0.5f * screenSize : screenSize);
+    }
+  }
 }
 
-void ACesium3DTileset::Serialize(FArchive& Ar) {
-  Super::Serialize(Ar);
+/**
+ * @brief Computes the smallest distance from any of the given cameras to the
+ * bounds of the primitives of the given glTF component, in Unreal units.
+ */
+static float computeDistanceToCameras(
+    const UCesiumGltfComponent* pGltf,
+    const std::vector<FCesiumCamera>& cameras) {
+  float distance = TNumericLimits<float>::Max();
+  for (const USceneComponent* pChild : pGltf->GetAttachChildren()) {
+    const UPrimitiveComponent* pPrimitive = Cast<UPrimitiveComponent>(pChild);
+    if (!pPrimitive) {
+      continue;
+    }
 
-  Ar.UsingCustomVersion(FCesiumCustomVersion::GUID);
+    const FBoxSphereBounds& bounds = pPrimitive->Bounds;
+    for (const FCesiumCamera& camera : cameras) {
+      distance = FMath::Min(
+          distance,
+          FMath::Max(
+              float(FVector::Dist(camera.Location, bounds.Origin)) -
+                  float(bounds.SphereRadius),
+              0.0f));
+    }
+  }
+  return distance;
+}
 
-  const int32 CesiumVersion = Ar.CustomVer(FCesiumCustomVersion::GUID);
+void ACesium3DTileset::updateShadowCasting(
+    const std::vector<Cesium3DTilesSelection::Tile*>& tiles,
+    const std::vector<FCesiumCamera>& cameras) {
+  for (Cesium3DTilesSelection::Tile* pTile : tiles) {
+    if (pTile->getState() != Cesium3DTilesSelection::Tile::LoadState::Done) {
+      continue;
+    }
 
-  if (CesiumVersion < FCesiumCustomVersion::TilesetExplicitSource) {
-    // In previous versions, the tileset source was inferred from the presence
-    // of a non-empty URL property, rather than being explicitly specified.
-    if (this->Url.Len() > 0) {
-      this->TilesetSource = ETilesetSource::FromUrl;
-    } else {
-      this->TilesetSource = ETilesetSource::FromCesiumIon;
+    UCesiumGltfComponent* pGltf =
+        static_cast<UCesiumGltfComponent*>(pTile->getRendererResources());
+    if (!pGltf) {
+      continue;
+    }
+
+    bool castShadow = this->MaximumShadowGeometricError <= 0.0f ||
+                      pTile->getGeometricError() <=
+                          double(this->MaximumShadowGeometricError);
+    if (castShadow && this->MaximumShadowDistance > 0.0f) {
+      castShadow = computeDistanceToCameras(pGltf, cameras) <=
+                   this->MaximumShadowDistance;
     }
+    pGltf->SetTileCastShadow(castShadow);
   }
 }
 
-#if WITH_EDITOR
-void ACesium3DTileset::PostEditChangeProperty(
-    FPropertyChangedEvent& PropertyChangedEvent) {
-  Super::PostEditChangeProperty(PropertyChangedEvent);
-
-  if (!PropertyChangedEvent.Property) {
+void ACesium3DTileset::updateRayTracing(
+    const std::vector<Cesium3DTilesSelection::Tile*>& tiles,
+    const std::vector<FCesiumCamera>& cameras) {
+  this->_rayTracingTilesPending = false;
+  if (!IsRayTracingEnabled()) {
     return;
   }
 
-  FName PropName = PropertyChangedEvent.Property->GetFName();
-  FString PropNameAsString = PropertyChangedEvent.Property->GetName();
+  // The tiles that enter ray tracing in this frame, with their distance to
+  // the cameras.
+  std::vector<std::pair<float, UCesiumGltfComponent*>> entering;
+  const bool needsDistance = this->MaximumRayTracingDistance > 0.0f ||
+                             this->MaximumRayTracingTilesPerFrame > 0;
 
-  if (PropName == GET_MEMBER_NAME_CHECKED(ACesium3DTileset, TilesetSource) ||
-      PropName == GET_MEMBER_NAME_CHECKED(ACesium3DTileset, Url) ||
-      PropName == GET_MEMBER_NAME_CHECKED(ACesium3DTileset, IonAssetID) ||
-      PropName == GET_MEMBER_NAME_CHECKED(ACesium3DTileset, IonAccessToken) ||
-      PropName ==
-          GET_MEMBER_NAME_CHECKED(ACesium3DTileset, IonAssetEndpointUrl) ||
-      PropName ==
-          GET_MEMBER_NAME_CHECKED(ACesium3DTileset, CreatePhysicsMeshes) ||
-      PropName ==
-          GET_MEMBER_NAME_CHECKED(ACesium3DTileset, AlwaysIncludeTangents) ||
-      PropName ==
-          GET_MEMBER_NAME_CHECKED(ACesium3DTileset, GenerateSmoothNormals) ||
-      PropName == GET_MEMBER_NAME_CHECKED(ACesium3DTileset, EnableWaterMask) ||
+  for (Cesium3DTilesSelection::Tile* pTile : tiles) {
+    if (pTile->getState() != Cesium3DTilesSelection::Tile::LoadState::Done) {
+      continue;
+    }
+
+    UCesiumGltfComponent* pGltf =
+        static_cast<UCesiumGltfComponent*>(pTile->getRendererResources());
+    if (!pGltf) {
+      continue;
+    }
+
+    // Tiles above the MaximumRayTracingGeometricError were created without
+    // ray tracing geometry.
+    bool visible = pGltf->GetSupportRayTracing();
+    const float distance = visible && needsDistance
+                               ? computeDistanceToCameras(pGltf, cameras)
+                               : 0.0f;
+    if (visible && this->MaximumRayTracingDistance > 0.0f) {
+      visible = distance <= this->MaximumRayTracingDistance;
+    }
+
+    if (!visible) {
+      pGltf->SetTileVisibleInRayTracing(false);
+    } else if (!pGltf->GetTileVisibleInRayTracing()) {
+      entering.emplace_back(distance, pGltf);
+    }
+  }
+
+  // The nearest tiles enter first, and the others wait for later frames.
+  const size_t limit = size_t(this->MaximumRayTracingTilesPerFrame);
+  if (limit > 0 && entering.size() > limit) {
+    this->_rayTracingTilesPending = true;
+    std::nth_element(
+        entering.begin(),
+        entering.begin() + limit,
+        entering.end(),
+        [](const auto& lhs, const auto& rhs) { return lhs.first < rhs.first; });
+    entering.resize(limit);
+  }
+
+  for (const auto& entry : entering) {
+    entry.second->SetTileVisibleInRayTracing(true);
+  }
+}
+
+void ACesium3DTileset::buildDistanceFields(
+    const std::vector<Cesium3DTilesSelection::Tile*>& tiles,
+    const std::vector<FCesiumCamera>& cameras) {
+  this->_distanceFieldBuildsPending = false;
+  if (!this->EnableMeshDistanceFields || !CesiumDistanceField::isEnabled() ||
+      cameras.empty()) {
+    return;
+  }
+
+  std::vector<std::pair<float, UCesiumGltfComponent*>> nearTiles;
+  for (Cesium3DTilesSelection::Tile* pTile : tiles) {
+    if (pTile->getState() != Cesium3DTilesSelection::Tile::LoadState::Done) {
+      continue;
+    }
+
+    UCesiumGltfComponent* pGltf =
+        static_cast<UCesiumGltfComponent*>(pTile->getRendererResources());
+    if (!pGltf) {
+      continue;
+    }
+
+    const float distance = computeDistanceToCameras(pGltf, cameras);
+    if (distance <= this->MeshDistanceFieldRadius) {
+      nearTiles.emplace_back(distance, pGltf);
+    }
+  }
+
+  std::sort(
+      nearTiles.begin(),
+      nearTiles.end(),
+      [](const auto& lhs, const auto& rhs) { return lhs.first < rhs.first; });
+
+  TArray<FSphere> sources;
+  for (const FCesiumCamera& camera : cameras) {
+    sources.Emplace(camera.Location, this->MeshDistanceFieldRadius);
+  }
+
+  int32 budget = this->MaximumMeshDistanceFieldBuildsPerFrame;
+  for (const auto& entry : nearTiles) {
+    if (budget <= 0) {
+      break;
+    }
+    budget -= entry.second->BuildDistanceFields(
+        sources,
+        budget,
+        this->MeshDistanceFieldResolution);
+  }
+
+  // More builds may be waiting for the budget of the next frames.
+  this->_distanceFieldBuildsPending = budget <= 0;
+}
+
+void ACesium3DTileset::updateCullDistances(
+    const std::vector<Cesium3DTilesSelection::Tile*>& tiles,
+    const std::vector<Cesium3DTilesSelection::ViewState>& frustums) {
+  // The screen-space error of a unit geometric error at a unit distance, in
+  // the view with the most pixels per radian.
+  double errorPerMeter = 0.0;
+  for (const Cesium3DTilesSelection::ViewState& frustum : frustums) {
+    errorPerMeter =
+        std::max(errorPerMeter, frustum.computeScreenSpaceError(1.0, 1.0));
+  }
+  const double maximumError = double(this->GetEffectiveScreenSpaceError());
+
+  for (Cesium3DTilesSelection::Tile* pTile : tiles) {
+    if (pTile->getState() != Cesium3DTilesSelection::Tile::LoadState::Done) {
+      continue;
+    }
+
+    UCesiumGltfComponent* pGltf =
+        static_cast<UCesiumGltfComponent*>(pTile->getRendererResources());
+    if (!pGltf) {
+      continue;
+    }
+
+    const Cesium3DTilesSelection::Tile* pParent = pTile->getParent();
+    if (this->TileCullDistanceScale <= 0.0f || !pParent ||
+        pParent->getGeometricError() <= 0.0 || maximumError <= 0.0) {
+      pGltf->SetTileCullDistance(0.0f);
+      continue;
+    }
+
+    // Unreal measures the draw distance to the center of the bounds, and the
+    // selection measures it to the bounding volume.
+    float radius = 0.0f;
+    for (const USceneComponent* pChild : pGltf->GetAttachChildren()) {
+      if (const UPrimitiveComponent* pPrimitive =
+              Cast<UPrimitiveComponent>(pChild)) {
+        radius = FMath::Max(radius, float(pPrimitive->Bounds.SphereRadius));
+      }
+    }
+
+    const double refinementDistance =
+        pParent->getGeometricError() * errorPerMeter / maximumError;
+    pGltf->SetTileCullDistance(
+        float(
+            double(this->TileCullDistanceScale) * refinementDistance *
+            CesiumTransforms::metersToCentimeters) +
+        radius);
+  }
+}
+
+/**
+ * @brief Gets whether every primitive of the given glTF component has
+ * geometry for the far-field proxy, so that the proxy can draw the whole
+ * tile.
+ */
+static bool hasFarFieldGeometry(const UCesiumGltfComponent* pGltf) {
+  bool hasPrimitives = false;
+  for (const USceneComponent* pChild : pGltf->GetAttachChildren()) {
+    const UCesiumGltfPrimitiveComponent* pPrimitive =
+        Cast<UCesiumGltfPrimitiveComponent>(pChild);
+    if (!pPrimitive || !pPrimitive->pFarFieldGeometry) {
+      return false;
+    }
+    hasPrimitives = true;
+  }
+  return hasPrimitives;
+}
+
+/**
+ * @brief Creates the static mesh of the far-field proxy from the given render
+ * data, which it takes ownership of.
+ */
+static UStaticMesh* createFarFieldMesh(
+    UStaticMeshComponent* pComponent,
+    FStaticMeshRenderData* pRenderData,
+    UMaterialInterface* pMaterial) {
+  UStaticMesh* pStaticMesh = NewObject<UStaticMesh>(pComponent);
+  pStaticMesh->SetFlags(
+      RF_Transient | RF_DuplicateTransient | RF_TextExportTransient);
+  pStaticMesh->NeverStream = true;
+
+#if ENGINE_MAJOR_VERSION == 4 && ENGINE_MINOR_VERSION < 27
+  pStaticMesh->bIsBuiltAtRuntime = true;
+  pStaticMesh->RenderData = TUniquePtr<FStaticMeshRenderData>(pRenderData);
+#elif ENGINE_MAJOR_VERSION == 4
+  pStaticMesh->SetIsBuiltAtRuntime(true);
+  pStaticMesh->SetRenderData(TUniquePtr<FStaticMeshRenderData>(pRenderData));
+#else
+  pStaticMesh->SetRenderData(TUniquePtr<FStaticMeshRenderData>(pRenderData));
+#endif
+
+  pStaticMesh->AddMaterial(pMaterial);
+  pStaticMesh->InitResources();
+  pStaticMesh->CalculateExtendedBounds();
+
+#if ENGINE_MAJOR_VERSION == 4 && ENGINE_MINOR_VERSION < 27
+  pStaticMesh->RenderData->ScreenSize[0].Default = 1.0f;
+#else
+  pStaticMesh->GetRenderData()->ScreenSize[0].Default = 1.0f;
+#endif
+  return pStaticMesh;
+}
+
+/**
+ * @brief Sets the visibility of those of the given tiles of the far-field
+ * proxy that are rendered. The others may have been unloaded.
+ *
+ * @param farFieldTiles The tiles of the proxy, sorted by address.
+ * @param renderedTiles The tiles rendered in the current frame, sorted by
+ * address.
+ */
+static void setFarFieldTileVisibility(
+    const std::vector<const Cesium3DTilesSelection::Tile*>& farFieldTiles,
+    const std::vector<const Cesium3DTilesSelection::Tile*>& renderedTiles,
+    bool visible) {
+  for (const Cesium3DTilesSelection::Tile* pTile : farFieldTiles) {
+    if (!std::binary_search(
+            renderedTiles.begin(),
+            renderedTiles.end(),
+            pTile)) {
+      continue;
+    }
+
+    UCesiumGltfComponent* pGltf =
+        static_cast<UCesiumGltfComponent*>(pTile->getRendererResources());
+    if (pGltf) {
+      pGltf->SetTileVisibility(visible);
+    }
+  }
+}
+
+void ACesium3DTileset::updateFarField(
+    const std::vector<Cesium3DTilesSelection::Tile*>& tiles,
+    const std::vector<FCesiumCamera>& cameras) {
+  if (this->FarFieldSimplificationError <= 0.0f || this->CollisionOnly ||
+      (this->FarFieldDistance <= 0.0f &&
+       this->FarFieldGeometricError <= 0.0f)) {
+    if (this->_pFarFieldProxy) {
+      this->resetFarField();
+    }
+    return;
+  }
+
+  std::vector<const Cesium3DTilesSelection::Tile*> renderedTiles(
+      tiles.begin(),
+      tiles.end());
+  std::sort(renderedTiles.begin(), renderedTiles.end());
+
+  if (!this->_pFarFieldProxy) {
+    this->_pFarFieldProxy = std::make_shared<CesiumFarFieldProxy>();
+  }
+
+  CESIUM_TRACE("updateFarField");
+
+  std::vector<const Cesium3DTilesSelection::Tile*> farTiles;
+  for (const Cesium3DTilesSelection::Tile* pTile : renderedTiles) {
+    if (pTile->getState() != Cesium3DTilesSelection::Tile::LoadState::Done) {
+      continue;
+    }
+
+    const UCesiumGltfComponent* pGltf =
+        static_cast<const UCesiumGltfComponent*>(pTile->getRendererResources());
+    if (!pGltf || !hasFarFieldGeometry(pGltf)) {
+      continue;
+    }
+
+    bool isFar = this->FarFieldGeometricError > 0.0f &&
+                 pTile->getGeometricError() >=
+                     double(this->FarFieldGeometricError);
+    if (!isFar && this->FarFieldDistance > 0.0f) {
+      isFar =
+          computeDistanceToCameras(pGltf, cameras) > this->FarFieldDistance;
+    }
+    if (isFar) {
+      farTiles.push_back(pTile);
+    }
+  }
+
+  // Pick up the proxy that was built in the background, if any. The tiles of
+  // the old proxy are shown until it is decided below whether to show the
+  // new one.
+  CesiumFarFieldProxy::Result result;
+  if (this->_pFarFieldProxy->takeResult(result)) {
+    if (!this->_pFarFieldComponent) {
+      this->_pFarFieldComponent = NewObject<UStaticMeshComponent>(this);
+      this->_pFarFieldComponent->SetFlags(
+          RF_Transient | RF_DuplicateTransient | RF_TextExportTransient);
+      this->_pFarFieldComponent->SetMobility(EComponentMobility::Movable);
+      this->_pFarFieldComponent->SetCollisionEnabled(
+          ECollisionEnabled::NoCollision);
+      this->_pFarFieldComponent->CastShadow = false;
+      this->_pFarFieldComponent->SetVisibility(false);
+      this->_pFarFieldComponent->AttachToComponent(
+          this->RootComponent,
+          FAttachmentTransformRules::KeepRelativeTransform);
+      this->_pFarFieldComponent->RegisterComponent();
+    }
+
+    if (this->_farFieldShown) {
+      setFarFieldTileVisibility(this->_farFieldTiles, renderedTiles, true);
+      this->_pFarFieldComponent->SetVisibility(false);
+      this->_farFieldShown = false;
+    }
+
+    UMaterialInterface* pMaterial = this->FarFieldMaterial
+                                        ? this->FarFieldMaterial
+                                        : GEngine->VertexColorMaterial;
+    this->_pFarFieldComponent->SetStaticMesh(
+        result.pRenderData ? createFarFieldMesh(
+                                 this->_pFarFieldComponent,
+                                 result.pRenderData,
+                                 pMaterial)
+                           : nullptr);
+    this->_farFieldTiles.clear();
+    if (result.pRenderData) {
+      this->_farFieldTiles = std::move(result.tiles);
+    }
+  }
+
+  const double now = this->GetWorld()->GetTimeSeconds();
+  if (farTiles != this->_farFieldTiles &&
+      !this->_pFarFieldProxy->isBuilding() &&
+      (this->_lastFarFieldBuildTime < 0.0 ||
+       now - this->_lastFarFieldBuildTime >=
+           double(this->FarFieldUpdateInterval))) {
+    const glm::dmat4& cesiumToUnreal =
+        this->GetCesiumTilesetToUnrealRelativeWorldTransform();
+    std::vector<CesiumFarFieldProxy::Part> parts;
+    for (const Cesium3DTilesSelection::Tile* pTile : farTiles) {
+      const UCesiumGltfComponent* pGltf =
+          static_cast<const UCesiumGltfComponent*>(
+              pTile->getRendererResources());
+      for (const USceneComponent* pChild : pGltf->GetAttachChildren()) {
+        const UCesiumGltfPrimitiveComponent* pPrimitive =
+            Cast<UCesiumGltfPrimitiveComponent>(pChild);
+        parts.push_back(
+            {pPrimitive->pFarFieldGeometry,
+             cesiumToUnreal * pPrimitive->HighPrecisionNodeTransform});
+      }
+    }
+
+    this->_pFarFieldProxy->build(std::move(farTiles), std::move(parts));
+    this->_lastFarFieldBuildTime = now;
+  }
+
+  // The proxy is only shown while all of the tiles it draws are rendered, so
+  // that it never draws a tile that was refined or culled in the meantime.
+  const bool show = !this->_farFieldTiles.empty() &&
+                    std::includes(
+                        renderedTiles.begin(),
+                        renderedTiles.end(),
+                        this->_farFieldTiles.begin(),
+                        this->_farFieldTiles.end());
+  if (show != this->_farFieldShown) {
+    setFarFieldTileVisibility(this->_farFieldTiles, renderedTiles, !show);
+    this->_pFarFieldComponent->SetVisibility(show);
+    this->_farFieldShown = show;
+  }
+}
+
+void ACesium3DTileset::resetFarField() {
+  // All of the tiles of a proxy that is shown are rendered, and so loaded.
+  if (this->_farFieldShown) {
+    setFarFieldTileVisibility(
+        this->_farFieldTiles,
+        this->_farFieldTiles,
+        true);
+  }
+
+  if (this->_pFarFieldProxy) {
+    this->_pFarFieldProxy->reset();
+  }
+  this->_pFarFieldProxy.reset();
+
+  if (this->_pFarFieldComponent) {
+    this->_pFarFieldComponent->SetVisibility(false);
+    this->_pFarFieldComponent->SetStaticMesh(nullptr);
+  }
+
+  this->_farFieldTiles.clear();
+  this->_farFieldShown = false;
+  this->_lastFarFieldBuildTime = -1.0;
+}
+
+void ACesium3DTileset::updateFarFieldMaterial() {
+  if (this->_pFarFieldComponent &&
+      this->_pFarFieldComponent->GetStaticMesh()) {
+    this->_pFarFieldComponent->SetMaterial(
+        0,
+        this->FarFieldMaterial ? this->FarFieldMaterial
+                               : GEngine->VertexColorMaterial);
+  }
+}
+
+void ACesium3DTileset::updatePipelinePrecache(
+    const std::vector<FCesiumCamera>& cameras) {
+  if (this->_pipelinePrecacheFramesLeft == 0) {
+    return;
+  }
+
+  // The editor compiles shaders and creates pipeline states as materials
+  // are edited, so only games precache them.
+  UWorld* pWorld = this->GetWorld();
+  if (!pWorld || !pWorld->IsGameWorld() ||
+      !GetDefault<UCesiumRuntimeSettings>()->PrecachePipelineStates) {
+    return;
+  }
+
+  if (this->_pipelinePrecacheFramesLeft < 0) {
+    CESIUM_TRACE("createPipelinePrecacheComponents");
+
+    // These are the base materials that tiles are drawn with, see
+    // loadPrimitive. The instances of each material that tiles get share its
+    // shaders, so drawing the base material is enough.
+    const UCesiumGltfComponent* pDefaults =
+        GetDefault<UCesiumGltfComponent>();
+    TArray<UMaterialInterface*> materials;
+    materials.Add(this->Material ? this->Material : pDefaults->BaseMaterial);
+#if !PLATFORM_MAC
+    materials.Add(
+        this->WaterMaterial ? this->WaterMaterial
+                            : pDefaults->BaseMaterialWithWater);
+#endif
+    materials.Remove(nullptr);
+
+    this->_pipelinePrecacheComponents =
+        CesiumPipelinePrecache::createComponents(
+            *this->RootComponent,
+            materials,
+            this->HighPrecisionVertexAttributes);
+    this->_pipelinePrecacheFramesLeft = CesiumPipelinePrecache::FramesToDraw;
+  }
+
+  --this->_pipelinePrecacheFramesLeft;
+  if (this->_pipelinePrecacheFramesLeft > 0) {
+    CesiumPipelinePrecache::placeComponents(
+        this->_pipelinePrecacheComponents,
+        cameras.front());
+    return;
+  }
+
+  for (UStaticMeshComponent* pComponent : this->_pipelinePrecacheComponents) {
+    if (pComponent) {
+      pComponent->DestroyComponent();
+    }
+  }
+  this->_pipelinePrecacheComponents.Empty();
+}
+
+void ACesium3DTileset::resetPipelinePrecache() {
+  for (UStaticMeshComponent* pComponent : this->_pipelinePrecacheComponents) {
+    if (pComponent) {
+      pComponent->DestroyComponent();
+    }
+  }
+  this->_pipelinePrecacheComponents.Empty();
+  this->_pipelinePrecacheFramesLeft = -1;
+}
+
+void ACesium3DTileset::cookDeferredCollision(
+    const std::vector<Cesium3DTilesSelection::Tile*>& tiles) {
+  if (this->CollisionRadius <= 0.0f || !this->CreatePhysicsMeshes) {
+    return;
+  }
+
+  UWorld* pWorld = this->GetWorld();
+  if (!pWorld) {
+    return;
+  }
+
+  TArray<FSphere> sources;
+  for (auto playerControllerIt = pWorld->GetPlayerControllerIterator();
+       playerControllerIt;
+       playerControllerIt++) {
+    const TWeakObjectPtr<APlayerController> pPlayerController =
+        *playerControllerIt;
+    const APawn* pPawn =
+        pPlayerController != nullptr ? pPlayerController->GetPawn() : nullptr;
+    if (pPawn) {
+      sources.Emplace(pPawn->GetActorLocation(), this->CollisionRadius);
+    }
+  }
+
+  this->_collisionSources.RemoveAll(
+      [](const TWeakObjectPtr<AActor>& pSource) { return !pSource.IsValid(); });
+  for (const TWeakObjectPtr<AActor>& pSource : this->_collisionSources) {
+    sources.Emplace(pSource->GetActorLocation(), this->CollisionRadius);
+  }
+
+  ACesiumCameraManager* pCameraManager =
+      ACesiumCameraManager::GetDefaultCameraManager(pWorld);
+  if (pCameraManager) {
+    auto addPointOfInterest = [&](const FCesiumPointOfInterest& point) {
+      sources.Emplace(
+          point.Location,
+          point.Radius > 0.0f ? point.Radius : this->CollisionRadius);
+    };
+    for (const auto& pointOfInterestIt :
+         pCameraManager->GetPointsOfInterest()) {
+      addPointOfInterest(pointOfInterestIt.Value);
+    }
+    for (const FCesiumPointOfInterest& point :
+         pCameraManager->GetRemotePlayerPointsOfInterest()) {
+      addPointOfInterest(point);
+    }
+  }
+
+  if (sources.Num() == 0) {
+    return;
+  }
+
+  for (Cesium3DTilesSelection::Tile* pTile : tiles) {
+    if (pTile->getState() != Cesium3DTilesSelection::Tile::LoadState::Done) {
+      continue;
+    }
+
+    UCesiumGltfComponent* pGltf =
+        static_cast<UCesiumGltfComponent*>(pTile->getRendererResources());
+    if (pGltf) {
+      pGltf->CookDeferredCollision(sources);
+    }
+  }
+}
+
+UCesiumTileLoadScheduler* ACesium3DTileset::GetTileLoadScheduler() const {
+  UWorld* pWorld = this->GetWorld();
+  return pWorld ? pWorld->GetSubsystem<UCesiumTileLoadScheduler>() : nullptr;
+}
+
+void ACesium3DTileset::updateMemoryPressure() {
+  const bool underPressure = CesiumMemoryPressure::isUnderPressure();
+
+  // The pools only save time, so they are the first to give their memory back.
+  if (underPressure && !this->_underMemoryPressure &&
+      this->_pResourcePreparer) {
+    this->_pResourcePreparer->emptyPools();
+  }
+
+  this->_underMemoryPressure = underPressure;
+}
+
+float ACesium3DTileset::GetEffectiveScreenSpaceError() const {
+  return this->AdaptScreenSpaceError && this->_pScreenSpaceErrorController
+             ? this->_pScreenSpaceErrorController->getScreenSpaceError()
+             : this->MaximumScreenSpaceError;
+}
+
+void ACesium3DTileset::updateScreenSpaceErrorController() {
+  if (!this->AdaptScreenSpaceError) {
+    this->_pScreenSpaceErrorController.reset();
+    return;
+  }
+
+  if (!this->_pScreenSpaceErrorController) {
+    this->_pScreenSpaceErrorController =
+        std::make_shared<CesiumScreenSpaceErrorController>();
+  }
+
+  this->_pScreenSpaceErrorController->update(
+      this->MaximumScreenSpaceError,
+      this->MaximumAdaptiveScreenSpaceError,
+      this->TargetFrameRate);
+}
+
+void ACesium3DTileset::updateRasterOverlayQuality() {
+  TArray<UCesiumRasterOverlay*> rasterOverlays;
+  this->GetComponents<UCesiumRasterOverlay>(rasterOverlays);
+  int32 maximumTier = 0;
+  for (const UCesiumRasterOverlay* pOverlay : rasterOverlays) {
+    maximumTier =
+        FMath::Max(maximumTier, pOverlay->GetMaximumAdaptiveQualityTier());
+  }
+
+  if (maximumTier == 0) {
+    this->_rasterOverlayQualityTier = 0;
+    return;
+  }
+
+  // A new tier only changes the memory use and frame time once the overlay
+  // tiles loaded with it replace the old ones, so changes are spaced out.
+  const double changeInterval = 2.0;
+  const double now = FPlatformTime::Seconds();
+  if (this->_lastRasterOverlayQualityChangeTime >= 0.0 &&
+      now - this->_lastRasterOverlayQualityChangeTime < changeInterval) {
+    this->_rasterOverlayQualityTier =
+        FMath::Min(this->_rasterOverlayQualityTier, maximumTier);
+    return;
+  }
+
+  const int64 textureBytes =
+      this->_pResourcePreparer
+          ? this->_pResourcePreparer->getRasterOverlayTextureBytes()
+          : 0;
+  const int64 budget = this->MaximumRasterOverlayTextureBytes;
+  const bool overBudget = budget > 0 && textureBytes > budget;
+  const bool underBudget = budget <= 0 || textureBytes < budget / 4 * 3;
+
+  // The overlays only give up detail once the geometry has given up all it
+  // may to hold the frame rate.
+  const float error = this->GetEffectiveScreenSpaceError();
+  const bool frameTimeOver = this->AdaptScreenSpaceError &&
+                             error >= this->MaximumAdaptiveScreenSpaceError;
+  const bool frameTimeUnder =
+      !this->AdaptScreenSpaceError || error <= this->MaximumScreenSpaceError;
+
+  int32 tier = FMath::Min(this->_rasterOverlayQualityTier, maximumTier);
+  if ((overBudget || this->_underMemoryPressure || frameTimeOver) &&
+      tier < maximumTier) {
+    ++tier;
+  } else if (
+      underBudget && !this->_underMemoryPressure && frameTimeUnder &&
+      tier > 0) {
+    --tier;
+  }
+
+  if (tier != this->_rasterOverlayQualityTier) {
+    UE_LOG(
+        LogCesium,
+        Verbose,
+        TEXT("Raster overlay quality tier of %s changed to %d"),
+        *this->GetName(),
+        tier);
+    this->_rasterOverlayQualityTier = tier;
+    this->_lastRasterOverlayQualityChangeTime = now;
+  }
+}
+
+void ACesium3DTileset::updateTileLoadController(
+    const Cesium3DTilesSelection::ViewUpdateResult& result) {
+  if (!this->AdaptSimultaneousTileLoads) {
+    this->_pTileLoadController.reset();
+    return;
+  }
+
+  if (!this->_pTileLoadController) {
+    this->_pTileLoadController = std::make_shared<CesiumTileLoadController>();
+  }
+
+  this->_pTileLoadController->update(
+      this->MinimumSimultaneousTileLoads,
+      this->MaximumSimultaneousTileLoads,
+      int32(
+          result.tilesLoadingHighPriority + result.tilesLoadingMediumPriority +
+          result.tilesLoadingLowPriority));
+}
+
+void ACesium3DTileset::reportTileLoadDemand(
+    const Cesium3DTilesSelection::ViewUpdateResult& result) {
+  UCesiumTileLoadScheduler* pScheduler = this->GetTileLoadScheduler();
+  if (!pScheduler) {
+    return;
+  }
+
+  FCesiumTileLoadDemand demand;
+  demand.TilesRendered = int32(result.tilesToRenderThisFrame.size());
+  demand.TilesLoadingHighPriority = int32(result.tilesLoadingHighPriority);
+  demand.TilesLoadingMediumPriority = int32(result.tilesLoadingMediumPriority);
+  demand.TilesLoadingLowPriority = int32(result.tilesLoadingLowPriority);
+
+  TArray<UCesiumRasterOverlay*> rasterOverlays;
+  this->GetComponents<UCesiumRasterOverlay>(rasterOverlays);
+  for (UCesiumRasterOverlay* pOverlay : rasterOverlays) {
+    if (pOverlay->IsActive()) {
+      ++demand.RasterOverlays;
+    }
+  }
+
+  if (demand.RasterOverlays > 0) {
+    using AttachmentState =
+        Cesium3DTilesSelection::RasterMappedTo3DTile::AttachmentState;
+    for (const Cesium3DTilesSelection::Tile* pTile :
+         result.tilesToRenderThisFrame) {
+      for (const Cesium3DTilesSelection::RasterMappedTo3DTile& mapped :
+           pTile->getMappedRasterTiles()) {
+        if (mapped.getState() != AttachmentState::Attached) {
+          ++demand.TilesWaitingForRasterOverlays;
+          break;
+        }
+      }
+    }
+  }
+
+  pScheduler->ReportDemand(this, demand);
+}
+
+const std::vector<Cesium3DTilesSelection::Tile*>&
+ACesium3DTileset::applyViewUpdateResult(
+    const Cesium3DTilesSelection::ViewUpdateResult& result,
+    const std::vector<Cesium3DTilesSelection::ViewState>& frustums) {
+  if (this->LodHysteresis <= 1.0f && this->MinimumTileResidency <= 0.0f) {
+    this->_renderedTiles = result.tilesToRenderThisFrame;
+    this->_tileShownTimes.clear();
+
+    removeVisibleTilesFromList(
+        this->_tilesToNoLongerRenderNextFrame,
+        result.tilesToRenderThisFrame);
+    hideTilesToNoLongerRender(this->_tilesToNoLongerRenderNextFrame);
+    this->_tilesToNoLongerRenderNextFrame =
+        result.tilesToNoLongerRenderThisFrame;
+    showTilesToRender(result.tilesToRenderThisFrame);
+    return this->_renderedTiles;
+  }
+
+  std::vector<Cesium3DTilesSelection::Tile*> previousTiles =
+      std::move(this->_renderedTiles);
+  this->_renderedTiles = this->selectTilesToRender(
+      result.tilesToRenderThisFrame,
+      previousTiles,
+      frustums);
+
+  // The tiles kept from the last frame are also in the selection's list of
+  // tiles to no longer render, but they are taken out of it again next frame
+  // if they are still rendered then.
+  std::vector<Cesium3DTilesSelection::Tile*> noLongerRendered =
+      std::move(previousTiles);
+  removeVisibleTilesFromList(noLongerRendered, this->_renderedTiles);
+  noLongerRendered.insert(
+      noLongerRendered.end(),
+      result.tilesToNoLongerRenderThisFrame.begin(),
+      result.tilesToNoLongerRenderThisFrame.end());
+
+  removeVisibleTilesFromList(
+      this->_tilesToNoLongerRenderNextFrame,
+      this->_renderedTiles);
+  hideTilesToNoLongerRender(this->_tilesToNoLongerRenderNextFrame);
+  this->_tilesToNoLongerRenderNextFrame = std::move(noLongerRendered);
+  showTilesToRender(this->_renderedTiles);
+
+  const double now = this->GetWorld()->GetTimeSeconds();
+  std::unordered_map<const Cesium3DTilesSelection::Tile*, double> shownTimes;
+  shownTimes.reserve(this->_renderedTiles.size());
+  for (const Cesium3DTilesSelection::Tile* pTile : this->_renderedTiles) {
+    auto it = this->_tileShownTimes.find(pTile);
+    shownTimes.emplace(
+        pTile,
+        it != this->_tileShownTimes.end() ? it->second : now);
+  }
+  this->_tileShownTimes = std::move(shownTimes);
+
+  return this->_renderedTiles;
+}
+
+namespace {
+
+bool isTileRenderable(const Cesium3DTilesSelection::Tile* pTile) {
+  return pTile->getState() == Cesium3DTilesSelection::Tile::LoadState::Done &&
+         pTile->getRendererResources() != nullptr;
+}
+
+/**
+ * @brief Computes the largest screen-space error of the given tile in any of
+ * the given views, the same way the tile selection does.
+ */
+double computeScreenSpaceError(
+    const Cesium3DTilesSelection::Tile& tile,
+    const std::vector<Cesium3DTilesSelection::ViewState>& frustums) {
+  double error = 0.0;
+  for (const Cesium3DTilesSelection::ViewState& frustum : frustums) {
+    const double distance = std::sqrt(
+        frustum.computeDistanceSquaredToBoundingVolume(
+            tile.getBoundingVolume()));
+    error = std::max(
+        error,
+        frustum.computeScreenSpaceError(tile.getGeometricError(), distance));
+  }
+  return error;
+}
+
+/**
+ * @brief Finds the closest ancestor of the given tile that is in the given
+ * set, or nullptr if there is none.
+ */
+Cesium3DTilesSelection::Tile* findAncestorInSet(
+    const Cesium3DTilesSelection::Tile* pTile,
+    const std::unordered_set<Cesium3DTilesSelection::Tile*>& set) {
+  for (Cesium3DTilesSelection::Tile* pAncestor = pTile->getParent();
+       pAncestor;
+       pAncestor = pAncestor->getParent()) {
+    if (set.find(pAncestor) != set.end()) {
+      return pAncestor;
+    }
+  }
+  return nullptr;
+}
+
+} // namespace
+
+std::vector<Cesium3DTilesSelection::Tile*>
+ACesium3DTileset::selectTilesToRender(
+    const std::vector<Cesium3DTilesSelection::Tile*>& selectedTiles,
+    const std::vector<Cesium3DTilesSelection::Tile*>& previousTiles,
+    const std::vector<Cesium3DTilesSelection::ViewState>& frustums) const {
+  using Cesium3DTilesSelection::Tile;
+
+  const std::unordered_set<Tile*> selected(
+      selectedTiles.begin(),
+      selectedTiles.end());
+  const std::unordered_set<Tile*> previous(
+      previousTiles.begin(),
+      previousTiles.end());
+
+  // The tiles that were shown in the last frame and are replaced by a
+  // selected ancestor, by that ancestor.
+  std::unordered_set<Tile*> newlySelected;
+  for (Tile* pTile : selectedTiles) {
+    if (previous.find(pTile) == previous.end()) {
+      newlySelected.insert(pTile);
+    }
+  }
+  std::unordered_map<Tile*, std::vector<Tile*>> coarsened;
+  for (Tile* pTile : previousTiles) {
+    if (selected.find(pTile) == selected.end()) {
+      if (Tile* pAncestor = findAncestorInSet(pTile, newlySelected)) {
+        coarsened[pAncestor].push_back(pTile);
+      }
+    }
+  }
+
+  // The selected tiles that replace an ancestor shown in the last frame, by
+  // that ancestor.
+  std::unordered_set<Tile*> noLongerSelected;
+  for (Tile* pTile : previousTiles) {
+    if (selected.find(pTile) == selected.end()) {
+      noLongerSelected.insert(pTile);
+    }
+  }
+  std::unordered_map<Tile*, std::vector<Tile*>> refined;
+  for (Tile* pTile : newlySelected) {
+    if (Tile* pAncestor = findAncestorInSet(pTile, noLongerSelected)) {
+      refined[pAncestor].push_back(pTile);
+    }
+  }
+
+  const double now = this->GetWorld()->GetTimeSeconds();
+  auto isResident = [this, now](const Tile* pTile) {
+    auto it = this->_tileShownTimes.find(pTile);
+    return it == this->_tileShownTimes.end() ||
+           now - it->second >= double(this->MinimumTileResidency);
+  };
+
+  std::unordered_set<Tile*> skipped;
+  std::vector<Tile*> kept;
+
+  // Descendants are kept instead of their ancestor while any of them was
+  // only just shown, or while the error of the ancestor is still within the
+  // hysteresis band. They all need to be loaded, or there would be holes.
+  const double coarsenError =
+      double(this->GetEffectiveScreenSpaceError()) /
+      double(FMath::Max(this->LodHysteresis, 1.0f));
+  for (const auto& coarsenedIt : coarsened) {
+    const std::vector<Tile*>& descendants = coarsenedIt.second;
+    if (!std::all_of(
+            descendants.begin(),
+            descendants.end(),
+            isTileRenderable)) {
+      continue;
+    }
+
+    const bool keep =
+        !std::all_of(descendants.begin(), descendants.end(), isResident) ||
+        computeScreenSpaceError(*coarsenedIt.first, frustums) > coarsenError;
+    if (keep) {
+      skipped.insert(coarsenedIt.first);
+      kept.insert(kept.end(), descendants.begin(), descendants.end());
+    }
+  }
+
+  // An ancestor that was only just shown is kept instead of its descendants.
+  for (const auto& refinedIt : refined) {
+    Tile* pAncestor = refinedIt.first;
+    if (isTileRenderable(pAncestor) && !isResident(pAncestor)) {
+      skipped.insert(refinedIt.second.begin(), refinedIt.second.end());
+      kept.push_back(pAncestor);
+    }
+  }
+
+  std::vector<Tile*> tiles;
+  tiles.reserve(selectedTiles.size() + kept.size());
+  for (Tile* pTile : selectedTiles) {
+    if (skipped.find(pTile) == skipped.end()) {
+      tiles.push_back(pTile);
+    }
+  }
+  tiles.insert(tiles.end(), kept.begin(), kept.end());
+  return tiles;
+}
+
+bool ACesium3DTileset::isBaseLevelOfDetailLoaded(
+    const std::vector<Cesium3DTilesSelection::Tile*>& tiles,
+    const std::vector<Cesium3DTilesSelection::ViewState>& frustums) const {
+  bool anyLoaded = false;
+  for (const Cesium3DTilesSelection::Tile* pTile : tiles) {
+    if (!isTileRenderable(pTile)) {
+      continue;
+    }
+    if (computeScreenSpaceError(*pTile, frustums) >
+        double(this->BaseScreenSpaceError)) {
+      return false;
+    }
+    anyLoaded = true;
+  }
+  return anyLoaded;
+}
+
+void ACesium3DTileset::createPendingTilePrimitives(
+    const std::vector<Cesium3DTilesSelection::ViewState>& frustums) {
+  if (!this->_pResourcePreparer) {
+    return;
+  }
+
+  SCOPE_CYCLE_COUNTER(STAT_CesiumMainThreadFinalize);
+  double endTimeSeconds = FPlatformTime::Seconds() +
+                          this->MainThreadLoadingTimeLimit / 1000.0;
+  this->_pResourcePreparer->createPendingPrimitives(frustums, endTimeSeconds);
+}
+
+void ACesium3DTileset::EndPlay(const EEndPlayReason::Type EndPlayReason) {
+  if (this->_pResourcePreparer) {
+    this->_pResourcePreparer->saveSnapshot();
+  }
+  this->DestroyTileset();
+  AActor::EndPlay(EndPlayReason);
+}
+
+void ACesium3DTileset::PostLoad() {
+  BodyInstance.FixupData(this); // We need to call this one after Loading the
+                                // actor to have correct BodyInstance values.
+
+  Super::PostLoad();
+}
+
+void ACesium3DTileset::Serialize(FArchive& Ar) {
+  Super::Serialize(Ar);
+
+  Ar.UsingCustomVersion(FCesiumCustomVersion::GUID);
+
+  const int32 CesiumVersion = Ar.CustomVer(FCesiumCustomVersion::GUID);
+
+  if (CesiumVersion < FCesiumCustomVersion::TilesetExplicitSource) {
+    // In previous versions, the tileset source was inferred from the presence
+    // of a non-empty URL property, rather than being explicitly specified.
+    if (this->Url.Len() > 0) {
+      this->TilesetSource = ETilesetSource::FromUrl;
+    } else {
+      this->TilesetSource = ETilesetSource::FromCesiumIon;
+    }
+  }
+}
+
+/*static*/ const TArray<FName>& ACesium3DTileset::GetReloadPropertyNames() {
+  static const TArray<FName> names = {
+      GET_MEMBER_NAME_CHECKED(ACesium3DTileset, TilesetSource),
+      GET_MEMBER_NAME_CHECKED(ACesium3DTileset, Url),
+      GET_MEMBER_NAME_CHECKED(ACesium3DTileset, IonAssetID),
+      GET_MEMBER_NAME_CHECKED(ACesium3DTileset, IonAccessToken),
+      GET_MEMBER_NAME_CHECKED(ACesium3DTileset, IonAssetEndpointUrl),
+      GET_MEMBER_NAME_CHECKED(ACesium3DTileset, ShareTileset),
+      GET_MEMBER_NAME_CHECKED(ACesium3DTileset, CreatePhysicsMeshes),
+      GET_MEMBER_NAME_CHECKED(ACesium3DTileset, CollisionOnly),
+      GET_MEMBER_NAME_CHECKED(ACesium3DTileset, CollisionRadius),
+      GET_MEMBER_NAME_CHECKED(ACesium3DTileset, CollisionSimplificationError),
+      GET_MEMBER_NAME_CHECKED(ACesium3DTileset, FarFieldSimplificationError),
+      GET_MEMBER_NAME_CHECKED(ACesium3DTileset, AlwaysIncludeTangents),
+      GET_MEMBER_NAME_CHECKED(ACesium3DTileset, HighPrecisionVertexAttributes),
+      GET_MEMBER_NAME_CHECKED(ACesium3DTileset, GenerateSmoothNormals),
+      GET_MEMBER_NAME_CHECKED(ACesium3DTileset, ComputeFlatNormalsInMaterial),
+      GET_MEMBER_NAME_CHECKED(ACesium3DTileset, OptimizeMeshes),
+      GET_MEMBER_NAME_CHECKED(ACesium3DTileset, MergePrimitives),
+      GET_MEMBER_NAME_CHECKED(ACesium3DTileset, BuildNaniteMeshes),
+      GET_MEMBER_NAME_CHECKED(ACesium3DTileset, UseBatchedRendering),
+      GET_MEMBER_NAME_CHECKED(ACesium3DTileset, RenderTerrainAsHeightfields),
+      GET_MEMBER_NAME_CHECKED(ACesium3DTileset, StreamTileTextures),
+      GET_MEMBER_NAME_CHECKED(ACesium3DTileset, MaximumTextureSize),
+      GET_MEMBER_NAME_CHECKED(ACesium3DTileset, MetadataTextureProperties),
+      GET_MEMBER_NAME_CHECKED(ACesium3DTileset, EnableFeatureIndex),
+      GET_MEMBER_NAME_CHECKED(ACesium3DTileset, EnableGeometryQueries),
+      GET_MEMBER_NAME_CHECKED(ACesium3DTileset, EnableMeshDistanceFields),
+      // The water mask is decoded while the tiles are loaded.
+      GET_MEMBER_NAME_CHECKED(ACesium3DTileset, EnableWaterMask),
+      GET_MEMBER_NAME_CHECKED(ACesium3DTileset, PackWaterMasks)};
+  return names;
+}
+
+FString ACesium3DTileset::GetReloadPropertiesSignature() const {
+  FString signature;
+  for (const FName& name : GetReloadPropertyNames()) {
+    const FProperty* pProperty =
+        FindFProperty<FProperty>(ACesium3DTileset::StaticClass(), name);
+    if (pProperty) {
+      pProperty->ExportTextItem(
+          signature,
+          pProperty->ContainerPtrToValuePtr<void>(this),
+          nullptr,
+          nullptr,
+          PPF_None);
+      signature += TEXT(";");
+    }
+  }
+  return signature;
+}
+
+FString ACesium3DTileset::getShareKey() const {
+  const UWorld* pWorld = this->GetWorld();
+  FString key = pWorld ? pWorld->GetPathName() : FString();
+  key += TEXT("|");
+  key += GetPathNameSafe(this->ResolvedGeoreference);
+  key += TEXT("|");
+  key += this->GetReloadPropertiesSignature();
+  key += TEXT("|");
+  key += GetPathNameSafe(this->Material);
+  key += TEXT(";");
+  key += GetPathNameSafe(this->WaterMaterial);
+  key += TEXT(";");
+  key += GetPathNameSafe(this->FarFieldMaterial);
+
+  TArray<UCesiumRasterOverlay*> rasterOverlays;
+  this->GetComponents<UCesiumRasterOverlay>(rasterOverlays);
+  for (const UCesiumRasterOverlay* pOverlay : rasterOverlays) {
+    if (pOverlay->IsActive()) {
+      key += TEXT("|");
+      key += pOverlay->GetClass()->GetName();
+      key += TEXT(":");
+      appendRasterOverlayProperties(*pOverlay, key);
+    }
+  }
+
+  return key;
+}
+
+const ACesium3DTileset* ACesium3DTileset::getSharedTileset() const {
+  const ACesium3DTileset* pShared = this->_pSharedTileset.Get();
+  if (!pShared || !pShared->_pTileset ||
+      pShared->_shareKey != this->_shareKey ||
+      !pShared->GetActorTransform().Equals(this->GetActorTransform())) {
+    return nullptr;
+  }
+  return pShared;
+}
+
+#if WITH_EDITOR
+void ACesium3DTileset::PostEditChangeProperty(
+    FPropertyChangedEvent& PropertyChangedEvent) {
+  Super::PostEditChangeProperty(PropertyChangedEvent);
+
+  this->_viewUpdateNeeded = true;
+
+  if (!PropertyChangedEvent.Property) {
+    return;
+  }
+
+  FName PropName = PropertyChangedEvent.Property->GetFName();
+  FString PropNameAsString = PropertyChangedEvent.Property->GetName();
+
+  // Any change within BodyInstance, which is a struct, is reported as a
+  // change of one of its members.
+  if (PropertyChangedEvent.MemberProperty &&
+      PropertyChangedEvent.MemberProperty->GetFName() ==
+          GET_MEMBER_NAME_CHECKED(ACesium3DTileset, BodyInstance)) {
+    this->UpdateTileCollisionSettings();
+    return;
+  }
+
+  if (GetReloadPropertyNames().Contains(PropName)) {
+    this->DestroyTileset();
+  } else if (
       PropName == GET_MEMBER_NAME_CHECKED(ACesium3DTileset, Material) ||
-      PropName == GET_MEMBER_NAME_CHECKED(ACesium3DTileset, WaterMaterial) ||
+      PropName == GET_MEMBER_NAME_CHECKED(ACesium3DTileset, WaterMaterial)) {
+    this->UpdateTileMaterials();
+  } else if (
       // For properties nested in structs, GET_MEMBER_NAME_CHECKED will prefix
       // with the struct name, so just do a manual string comparison.
       PropNameAsString == TEXT("RenderCustomDepth") ||
       PropNameAsString == TEXT("CustomDepthStencilValue") ||
       PropNameAsString == TEXT("CustomDepthStencilWriteMask")) {
-    this->DestroyTileset();
+    this->UpdateTileCustomDepthParameters();
   } else if (
       PropName == GET_MEMBER_NAME_CHECKED(ACesium3DTileset, Georeference)) {
     this->InvalidateResolvedGeoreference();
   } else if (
       PropName == GET_MEMBER_NAME_CHECKED(ACesium3DTileset, CreditSystem)) {
     this->InvalidateResolvedCreditSystem();
+  } else if (
+      PropName ==
+      GET_MEMBER_NAME_CHECKED(ACesium3DTileset, FarFieldMaterial)) {
+    this->updateFarFieldMaterial();
   } else if (
       PropName ==
       GET_MEMBER_NAME_CHECKED(ACesium3DTileset, MaximumScreenSpaceError)) {
@@ -1689,10 +4893,25 @@ void ACesium3DTileset::PostEditChangeProperty(
 void ACesium3DTileset::PostEditUndo() {
   Super::PostEditUndo();
 
+  this->_viewUpdateNeeded = true;
+
   // It doesn't appear to be possible to get detailed information about what
-  // changed in the undo/redo operation, so we have to assume the worst and
-  // recreate the tileset.
-  this->DestroyTileset();
+  // changed in the undo/redo operation, so the tileset is recreated if any of
+  // the properties that need it differ from when it was loaded. Everything
+  // else is applied to the loaded tiles again, which does nothing for the
+  // settings that didn't change.
+  if (!this->_pTileset ||
+      this->GetReloadPropertiesSignature() !=
+          this->_reloadPropertiesSignature) {
+    this->DestroyTileset();
+    return;
+  }
+
+  this->InvalidateResolvedGeoreference();
+  this->InvalidateResolvedCreditSystem();
+  this->UpdateTileCollisionSettings();
+  this->UpdateTileMaterials();
+  this->UpdateTileCustomDepthParameters();
 }
 
 void ACesium3DTileset::PostEditImport() {
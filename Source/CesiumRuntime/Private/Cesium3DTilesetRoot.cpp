@@ -7,6 +7,29 @@
 #include "Engine/World.h"
 #include "VecMath.h"
 
+namespace {
+/**
+ * Whether the Engine's own shift of the tile primitives by this offset is as
+ * precise as recomputing their transforms from the tileset transform.
+ *
+ * The primitives use absolute transforms, so the Engine already adds the
+ * offset to each of them, in bulk with the render and physics scenes.
+ * That is only lossless when every component of the offset is exactly
+ * representable, which single-precision vectors can't promise for offsets
+ * beyond 2^24 cm.
+ */
+bool isExactWorldOffset(const FVector& offset) {
+#if ENGINE_MAJOR_VERSION >= 5
+  return true;
+#else
+  constexpr float maximumExactOffset = 16777216.0f;
+  return FMath::Abs(offset.X) <= maximumExactOffset &&
+         FMath::Abs(offset.Y) <= maximumExactOffset &&
+         FMath::Abs(offset.Z) <= maximumExactOffset;
+#endif
+}
+} // namespace
+
 UCesium3DTilesetRoot::UCesium3DTilesetRoot()
     : _worldOriginLocation(0.0),
       _absoluteLocation(0.0, 0.0, 0.0),
@@ -26,7 +49,14 @@ void UCesium3DTilesetRoot::ApplyWorldOffset(
   // with an origin rebase, and we'll lose precision if we update the absolute
   // location here.
 
-  this->_updateTilesetToUnrealRelativeWorldTransform();
+  // The Engine has already shifted every tile primitive by the offset, so
+  // unless that lost precision, only the transform used for new tiles needs to
+  // change. This keeps rebasing from touching each loaded primitive again.
+  if (isExactWorldOffset(InOffset)) {
+    this->_computeTilesetToUnrealRelativeWorldTransform();
+  } else {
+    this->_updateTilesetToUnrealRelativeWorldTransform();
+  }
 }
 
 void UCesium3DTilesetRoot::HandleGeoreferenceUpdated() {
@@ -80,6 +110,11 @@ void UCesium3DTilesetRoot::_updateAbsoluteLocation() {
 }
 
 void UCesium3DTilesetRoot::_updateTilesetToUnrealRelativeWorldTransform() {
+  this->_computeTilesetToUnrealRelativeWorldTransform();
+  this->GetOwner<ACesium3DTileset>()->UpdateTransformFromCesium();
+}
+
+void UCesium3DTilesetRoot::_computeTilesetToUnrealRelativeWorldTransform() {
   ACesium3DTileset* pTileset = this->GetOwner<ACesium3DTileset>();
 
   const glm::dmat4& ellipsoidCenteredToUnrealWorld =
@@ -97,6 +132,4 @@ void UCesium3DTilesetRoot::_updateTilesetToUnrealRelativeWorldTransform() {
 
   this->_tilesetToUnrealRelativeWorld =
       ueAbsoluteToUeLocal * ellipsoidCenteredToUnrealWorld;
-
-  pTileset->UpdateTransformFromCesium();
 }
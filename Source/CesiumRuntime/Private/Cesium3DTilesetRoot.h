@@ -55,6 +55,13 @@ private:
   void _updateAbsoluteLocation();
   void _updateTilesetToUnrealRelativeWorldTransform();
 
+  /**
+   * @brief Recomputes the transform returned by
+   * {@link GetCesiumTilesetToUnrealRelativeWorldTransform} without applying it
+   * to the loaded tiles.
+   */
+  void _computeTilesetToUnrealRelativeWorldTransform();
+
   glm::dvec3 _worldOriginLocation;
   glm::dvec3 _absoluteLocation;
   glm::dmat4 _tilesetToUnrealRelativeWorld;
@@ -0,0 +1,73 @@
+// Copyright 2020-2021 CesiumGS, Inc. and Contributors
+
+#include "CesiumBackgroundPruneCache.h"
+#include "Async/Async.h"
+#include "CesiumRuntimeStats.h"
+#include "CesiumUtility/Tracing.h"
+#include "HAL/PlatformTime.h"
+
+using namespace CesiumAsync;
+
+CesiumBackgroundPruneCache::CesiumBackgroundPruneCache(
+    const std::shared_ptr<ICacheDatabase>& pDatabase,
+    bool pruneInBackground)
+    : _pDatabase(pDatabase),
+      _pruneInBackground(pruneInBackground),
+      _pPruning(std::make_shared<std::atomic<bool>>(false)) {}
+
+std::optional<CacheItem>
+CesiumBackgroundPruneCache::getEntry(const std::string& key) const {
+  const double startTime = FPlatformTime::Seconds();
+  std::optional<CacheItem> maybeItem = this->_pDatabase->getEntry(key);
+  CesiumRuntimeStats::addCacheDiskLookup(
+      maybeItem.has_value(),
+      FPlatformTime::Seconds() - startTime);
+  return maybeItem;
+}
+
+bool CesiumBackgroundPruneCache::storeEntry(
+    const std::string& key,
+    std::time_t expiryTime,
+    const std::string& url,
+    const std::string& requestMethod,
+    const HttpHeaders& requestHeaders,
+    uint16_t statusCode,
+    const HttpHeaders& responseHeaders,
+    const gsl::span<const std::byte>& responseData) {
+  const double startTime = FPlatformTime::Seconds();
+  const bool stored = this->_pDatabase->storeEntry(
+      key,
+      expiryTime,
+      url,
+      requestMethod,
+      requestHeaders,
+      statusCode,
+      responseHeaders,
+      responseData);
+  CesiumRuntimeStats::addCacheWrite(FPlatformTime::Seconds() - startTime);
+  return stored;
+}
+
+bool CesiumBackgroundPruneCache::prune() {
+  if (!this->_pruneInBackground) {
+    return this->_pDatabase->prune();
+  }
+
+  if (this->_pPruning->exchange(true)) {
+    return true;
+  }
+
+  AsyncTask(
+      ENamedThreads::AnyBackgroundThreadNormalTask,
+      [pDatabase = this->_pDatabase, pPruning = this->_pPruning]() {
+        CESIUM_TRACE("Prune request cache");
+        pDatabase->prune();
+        *pPruning = false;
+      });
+
+  return true;
+}
+
+bool CesiumBackgroundPruneCache::clearAll() {
+  return this->_pDatabase->clearAll();
+}
@@ -0,0 +1,65 @@
+// Copyright 2020-2021 CesiumGS, Inc. and Contributors
+
+#pragma once
+
+#include "CesiumAsync/ICacheDatabase.h"
+#include <atomic>
+#include <memory>
+
+/**
+ * @brief A cache database that prunes another cache database on a background
+ * task, rather than on the thread that asks for it to be pruned.
+ *
+ * CachingAssetAccessor prunes its database every so many requests, in the
+ * continuation of one of them, which can stall that request for as long as
+ * pruning a large database takes. With this in between, the request
+ * continues immediately. Only one prune runs at a time; a prune that is
+ * asked for while another is running is skipped.
+ *
+ * It also records the lookups and writes of the other database, and how long
+ * they take, in the Cesium stats.
+ */
+class CesiumBackgroundPruneCache : public CesiumAsync::ICacheDatabase {
+public:
+  /**
+   * @brief Creates the cache.
+   *
+   * @param pDatabase The database to prune.
+   * @param pruneInBackground Whether to prune it on a background task. If
+   * this is false, it is pruned on the calling thread, as usual.
+   */
+  CesiumBackgroundPruneCache(
+      const std::shared_ptr<CesiumAsync::ICacheDatabase>& pDatabase,
+      bool pruneInBackground);
+
+  virtual std::optional<CesiumAsync::CacheItem>
+  getEntry(const std::string& key) const override;
+
+  virtual bool storeEntry(
+      const std::string& key,
+      std::time_t expiryTime,
+      const std::string& url,
+      const std::string& requestMethod,
+      const CesiumAsync::HttpHeaders& requestHeaders,
+      uint16_t statusCode,
+      const CesiumAsync::HttpHeaders& responseHeaders,
+      const gsl::span<const std::byte>& responseData) override;
+
+  /**
+   * @brief Starts pruning the database on a background task, unless it is
+   * already being pruned.
+   *
+   * @return True when pruning in the background, because the result of the
+   * prune isn't known yet. Failures are logged by the other database.
+   */
+  virtual bool prune() override;
+
+  virtual bool clearAll() override;
+
+private:
+  std::shared_ptr<CesiumAsync::ICacheDatabase> _pDatabase;
+  bool _pruneInBackground;
+
+  // Shared with the background task, which may outlive this object.
+  std::shared_ptr<std::atomic<bool>> _pPruning;
+};
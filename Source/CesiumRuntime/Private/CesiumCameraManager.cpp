@@ -2,8 +2,12 @@
 
 #include "CesiumCameraManager.h"
 #include "CesiumRuntime.h"
+#include "Components/SceneCaptureComponent2D.h"
+#include "Engine/SceneCapture2D.h"
+#include "Engine/TextureRenderTarget2D.h"
 #include "Engine/World.h"
 #include "EngineUtils.h"
+#include "GameFramework/PlayerController.h"
 #include <string>
 #include <vector>
 
@@ -93,6 +97,195 @@ bool ACesiumCameraManager::UpdateCamera(
   return false;
 }
 
+bool ACesiumCameraManager::RemoveCamera(int32 cameraId) {
+  return this->_cameras.Remove(cameraId) > 0;
+}
+
 const TMap<int32, FCesiumCamera>& ACesiumCameraManager::GetCameras() const {
   return this->_cameras;
 }
+
+void ACesiumCameraManager::AddSceneCapture(
+    USceneCaptureComponent2D* SceneCapture) {
+  if (!IsValid(SceneCapture)) {
+    return;
+  }
+  this->_sceneCaptures.AddUnique(SceneCapture);
+  this->_sceneCaptureCamerasValid = false;
+}
+
+bool ACesiumCameraManager::RemoveSceneCapture(
+    USceneCaptureComponent2D* SceneCapture) {
+  this->_sceneCaptureCamerasValid = false;
+  return this->_sceneCaptures.Remove(SceneCapture) > 0;
+}
+
+const std::vector<FCesiumCamera>&
+ACesiumCameraManager::GetSceneCaptureCameras() {
+  if (!this->_sceneCaptureCamerasValid ||
+      this->_sceneCaptureCamerasFrame != GFrameCounter) {
+    this->updateSceneCaptureCameras();
+  }
+  return this->_sceneCaptureCameras;
+}
+
+int32 ACesiumCameraManager::AddPointOfInterest(
+    UPARAM(ref) const FCesiumPointOfInterest& PointOfInterest) {
+  int32 pointOfInterestId = this->_currentPointOfInterestId++;
+  this->_pointsOfInterest.Emplace(pointOfInterestId, PointOfInterest);
+  return pointOfInterestId;
+}
+
+bool ACesiumCameraManager::UpdatePointOfInterest(
+    int32 PointOfInterestId,
+    UPARAM(ref) const FCesiumPointOfInterest& PointOfInterest) {
+  FCesiumPointOfInterest* pCurrent =
+      this->_pointsOfInterest.Find(PointOfInterestId);
+  if (pCurrent) {
+    *pCurrent = PointOfInterest;
+    return true;
+  }
+
+  return false;
+}
+
+bool ACesiumCameraManager::RemovePointOfInterest(int32 PointOfInterestId) {
+  return this->_pointsOfInterest.Remove(PointOfInterestId) > 0;
+}
+
+const TMap<int32, FCesiumPointOfInterest>&
+ACesiumCameraManager::GetPointsOfInterest() const {
+  return this->_pointsOfInterest;
+}
+
+const std::vector<FCesiumPointOfInterest>&
+ACesiumCameraManager::GetRemotePlayerPointsOfInterest() {
+  if (!this->_remotePlayerPointsOfInterestValid ||
+      this->_remotePlayerPointsOfInterestFrame != GFrameCounter) {
+    this->updateRemotePlayerPointsOfInterest();
+  }
+  return this->_remotePlayerPointsOfInterest;
+}
+
+void ACesiumCameraManager::updateRemotePlayerPointsOfInterest() {
+  this->_remotePlayerPointsOfInterest.clear();
+  this->_remotePlayerPointsOfInterestFrame = GFrameCounter;
+  this->_remotePlayerPointsOfInterestValid = true;
+
+  UWorld* pWorld = this->GetWorld();
+  if (!this->UseRemotePlayerViewTargets || !IsValid(pWorld)) {
+    return;
+  }
+
+  for (auto playerControllerIt = pWorld->GetPlayerControllerIterator();
+       playerControllerIt;
+       playerControllerIt++) {
+    const TWeakObjectPtr<APlayerController> pPlayerController =
+        *playerControllerIt;
+    if (pPlayerController == nullptr ||
+        pPlayerController->IsLocalController()) {
+      continue;
+    }
+
+    // The view target is what the remote player sees, which is usually, but
+    // not always, its pawn.
+    const AActor* pViewTarget = pPlayerController->GetViewTarget();
+    if (!pViewTarget) {
+      pViewTarget = pPlayerController->GetPawn();
+    }
+    if (!pViewTarget) {
+      continue;
+    }
+
+    FCesiumPointOfInterest& pointOfInterest =
+        this->_remotePlayerPointsOfInterest.emplace_back();
+    pointOfInterest.Location = pViewTarget->GetActorLocation();
+    pointOfInterest.ScreenSpaceErrorScale =
+        this->RemotePlayerScreenSpaceErrorScale;
+  }
+}
+
+namespace {
+
+void addSceneCaptureCamera(
+    std::vector<FCesiumCamera>& cameras,
+    const USceneCaptureComponent2D* pSceneCaptureComponent,
+    float screenSpaceErrorScale,
+    float maximumViewportHeight) {
+  if (!pSceneCaptureComponent) {
+    return;
+  }
+
+  if (pSceneCaptureComponent->ProjectionType !=
+      ECameraProjectionMode::Type::Perspective) {
+    return;
+  }
+
+  UTextureRenderTarget2D* pRenderTarget = pSceneCaptureComponent->TextureTarget;
+  if (!pRenderTarget) {
+    return;
+  }
+
+  FVector2D renderTargetSize(pRenderTarget->SizeX, pRenderTarget->SizeY);
+  if (renderTargetSize.X < 1.0 || renderTargetSize.Y < 1.0) {
+    return;
+  }
+
+  FVector captureLocation = pSceneCaptureComponent->GetComponentLocation();
+  FRotator captureRotation = pSceneCaptureComponent->GetComponentRotation();
+  float captureFov = pSceneCaptureComponent->FOVAngle;
+
+  FCesiumCamera& camera = cameras.emplace_back(
+      renderTargetSize,
+      captureLocation,
+      captureRotation,
+      captureFov);
+  camera.ScreenSpaceErrorScale = screenSpaceErrorScale;
+  camera.MaximumViewportHeight = maximumViewportHeight;
+}
+
+} // namespace
+
+void ACesiumCameraManager::updateSceneCaptureCameras() {
+  this->_sceneCaptureCameras.clear();
+  this->_sceneCaptureCamerasFrame = GFrameCounter;
+  this->_sceneCaptureCamerasValid = true;
+
+  this->_sceneCaptures.RemoveAll(
+      [](const TWeakObjectPtr<USceneCaptureComponent2D>& pSceneCapture) {
+        return !pSceneCapture.IsValid();
+      });
+
+  for (const TWeakObjectPtr<USceneCaptureComponent2D>& pSceneCapture :
+       this->_sceneCaptures) {
+    addSceneCaptureCamera(
+        this->_sceneCaptureCameras,
+        pSceneCapture.Get(),
+        this->SceneCaptureScreenSpaceErrorScale,
+        this->SceneCaptureMaximumViewportHeight);
+  }
+
+  if (!this->SearchForSceneCaptures) {
+    return;
+  }
+
+  UWorld* pWorld = this->GetWorld();
+  if (!IsValid(pWorld)) {
+    return;
+  }
+
+  for (TActorIterator<ASceneCapture2D> actorIterator(pWorld); actorIterator;
+       ++actorIterator) {
+    USceneCaptureComponent2D* pSceneCaptureComponent =
+        actorIterator->GetCaptureComponent2D();
+    if (this->_sceneCaptures.Contains(pSceneCaptureComponent)) {
+      // Already added above.
+      continue;
+    }
+    addSceneCaptureCamera(
+        this->_sceneCaptureCameras,
+        pSceneCaptureComponent,
+        this->SceneCaptureScreenSpaceErrorScale,
+        this->SceneCaptureMaximumViewportHeight);
+  }
+}
@@ -0,0 +1,153 @@
+// Copyright 2020-2021 CesiumGS, Inc. and Contributors
+
+#include "CesiumClusterCacheAssetAccessor.h"
+#include "CesiumAsync/IAssetRequest.h"
+#include "CesiumAsync/IAssetResponse.h"
+#include "CesiumRuntime.h"
+#include "HAL/PlatformTime.h"
+#include <algorithm>
+#include <cctype>
+
+namespace {
+
+// How long, in seconds, requests are made directly after the cache server
+// couldn't be reached.
+constexpr double ServerRetryDelay = 5.0;
+
+bool isHttpUrl(const std::string& url) {
+  const auto startsWith = [&url](const std::string& scheme) {
+    return url.size() > scheme.size() &&
+           std::equal(
+               scheme.begin(),
+               scheme.end(),
+               url.begin(),
+               [](char a, char b) { return a == std::tolower(b); });
+  };
+  return startsWith("http://") || startsWith("https://");
+}
+
+/**
+ * Percent-encodes every character of a URL that isn't unreserved, so that it
+ * can be passed as a query parameter.
+ */
+std::string encodeUrl(const std::string& url) {
+  static const char* const hexDigits = "0123456789ABCDEF";
+
+  std::string encoded;
+  encoded.reserve(url.size() * 3 / 2);
+  for (const char c : url) {
+    const unsigned char u = static_cast<unsigned char>(c);
+    if (std::isalnum(u) || c == '-' || c == '_' || c == '.' || c == '~') {
+      encoded += c;
+    } else {
+      encoded += '%';
+      encoded += hexDigits[u >> 4];
+      encoded += hexDigits[u & 0xF];
+    }
+  }
+  return encoded;
+}
+
+/**
+ * A request made through the cache server, which reports the URL that was
+ * originally requested instead of the URL of the server.
+ */
+class ClusterCacheAssetRequest : public CesiumAsync::IAssetRequest {
+public:
+  ClusterCacheAssetRequest(
+      const std::string& url,
+      std::shared_ptr<CesiumAsync::IAssetRequest>&& pRequest)
+      : _url(url), _pRequest(std::move(pRequest)) {}
+
+  virtual const std::string& method() const override {
+    return this->_pRequest->method();
+  }
+
+  virtual const std::string& url() const override { return this->_url; }
+
+  virtual const CesiumAsync::HttpHeaders& headers() const override {
+    return this->_pRequest->headers();
+  }
+
+  virtual const CesiumAsync::IAssetResponse* response() const override {
+    return this->_pRequest->response();
+  }
+
+private:
+  std::string _url;
+  std::shared_ptr<CesiumAsync::IAssetRequest> _pRequest;
+};
+
+} // namespace
+
+CesiumClusterCacheAssetAccessor::CesiumClusterCacheAssetAccessor(
+    const std::shared_ptr<CesiumAsync::IAssetAccessor>& pAccessor,
+    const std::string& serverUrl)
+    : _pAccessor(pAccessor),
+      _serverUrl(serverUrl),
+      _pServerState(std::make_shared<ServerState>()) {}
+
+CesiumAsync::Future<std::shared_ptr<CesiumAsync::IAssetRequest>>
+CesiumClusterCacheAssetAccessor::get(
+    const CesiumAsync::AsyncSystem& asyncSystem,
+    const std::string& url,
+    const std::vector<CesiumAsync::IAssetAccessor::THeader>& headers) {
+  if (!isHttpUrl(url) ||
+      FPlatformTime::Seconds() < this->_pServerState->retryTime.load()) {
+    return this->_pAccessor->get(asyncSystem, url, headers);
+  }
+
+  return this->_pAccessor
+      ->get(asyncSystem, this->_serverUrl + encodeUrl(url), headers)
+      .thenImmediately(
+          [asyncSystem,
+           pAccessor = this->_pAccessor,
+           pServerState = this->_pServerState,
+           url,
+           headers](std::shared_ptr<CesiumAsync::IAssetRequest>&& pRequest)
+              -> CesiumAsync::Future<
+                  std::shared_ptr<CesiumAsync::IAssetRequest>> {
+            const CesiumAsync::IAssetResponse* pResponse =
+                pRequest ? pRequest->response() : nullptr;
+            if (pResponse && pResponse->statusCode() != 0) {
+              return asyncSystem.createResolvedFuture<
+                  std::shared_ptr<CesiumAsync::IAssetRequest>>(
+                  std::make_shared<ClusterCacheAssetRequest>(
+                      url,
+                      std::move(pRequest)));
+            }
+
+            // Only the first of the requests that fail at once logs it.
+            const double retryTime = pServerState->retryTime.exchange(
+                FPlatformTime::Seconds() + ServerRetryDelay);
+            if (retryTime < FPlatformTime::Seconds()) {
+              UE_LOG(
+                  LogCesium,
+                  Warning,
+                  TEXT(
+                      "The cluster cache server could not be reached, so requests are made directly for %.0f seconds."),
+                  ServerRetryDelay);
+            }
+            return pAccessor->get(asyncSystem, url, headers);
+          });
+}
+
+CesiumAsync::Future<std::shared_ptr<CesiumAsync::IAssetRequest>>
+CesiumClusterCacheAssetAccessor::request(
+    const CesiumAsync::AsyncSystem& asyncSystem,
+    const std::string& verb,
+    const std::string& url,
+    const std::vector<CesiumAsync::IAssetAccessor::THeader>& headers,
+    const gsl::span<const std::byte>& contentPayload) {
+  if (verb == "GET") {
+    return this->get(asyncSystem, url, headers);
+  }
+
+  // Other requests, such as those that create ion tokens, aren't cached.
+  return this->_pAccessor
+      ->request(asyncSystem, verb, url, headers, contentPayload);
+}
+
+void CesiumClusterCacheAssetAccessor::tick() noexcept {
+  this->_pAccessor->tick();
+}
@@ -0,0 +1,58 @@
+// Copyright 2020-2021 CesiumGS, Inc. and Contributors
+
+#pragma once
+
+#include "CesiumAsync/AsyncSystem.h"
+#include "CesiumAsync/IAssetAccessor.h"
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * @brief An asset accessor that sends GET requests for http:// and https://
+ * URLs through a cache server shared by several machines, such as the nodes
+ * of an nDisplay cluster, so that each tile is downloaded only once for all
+ * of them.
+ *
+ * The original URL is percent-encoded and appended to the URL of the server,
+ * so a server URL usually ends with a query parameter, for example
+ * http://cache-host:8080/fetch?url=. The requests that are returned report the
+ * original URL, so that relative URLs in the responses are resolved against
+ * it. When the server can't be reached, requests are made directly for a few
+ * seconds before the server is tried again.
+ */
+class CesiumClusterCacheAssetAccessor : public CesiumAsync::IAssetAccessor {
+public:
+  CesiumClusterCacheAssetAccessor(
+      const std::shared_ptr<CesiumAsync::IAssetAccessor>& pAccessor,
+      const std::string& serverUrl);
+
+  virtual CesiumAsync::Future<std::shared_ptr<CesiumAsync::IAssetRequest>>
+  get(const CesiumAsync::AsyncSystem& asyncSystem,
+      const std::string& url,
+      const std::vector<CesiumAsync::IAssetAccessor::THeader>& headers)
+      override;
+
+  virtual CesiumAsync::Future<std::shared_ptr<CesiumAsync::IAssetRequest>>
+  request(
+      const CesiumAsync::AsyncSystem& asyncSystem,
+      const std::string& verb,
+      const std::string& url,
+      const std::vector<CesiumAsync::IAssetAccessor::THeader>& headers,
+      const gsl::span<const std::byte>& contentPayload) override;
+
+  virtual void tick() noexcept override;
+
+private:
+  struct ServerState {
+    // The FPlatformTime::Seconds before which requests aren't sent to the
+    // server, because it couldn't be reached.
+    std::atomic<double> retryTime{0.0};
+  };
+
+  std::shared_ptr<CesiumAsync::IAssetAccessor> _pAccessor;
+  std::string _serverUrl;
+  std::shared_ptr<ServerState> _pServerState;
+};
@@ -0,0 +1,296 @@
+// Copyright 2020-2021 CesiumGS, Inc. and Contributors
+
+#include "CesiumConversionBenchmark.h"
+#include "CesiumGltf/Model.h"
+#include "CesiumGltfComponent.h"
+#include "CesiumGltfReader/GltfReader.h"
+#include "CesiumRuntime.h"
+#include "CesiumTextureUtility.h"
+#include "CreateModelOptions.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Parse.h"
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <glm/mat4x4.hpp>
+#include <memory>
+
+#if PHYSICS_INTERFACE_PHYSX
+#include "IPhysXCookingModule.h"
+#endif
+
+using namespace CesiumConversionBenchmark;
+
+namespace {
+// The number of vertices along each side of the synthetic grid models, and of
+// pixels along each side of their textures.
+constexpr std::array<int32, 3> SyntheticGridSizes = {32, 128, 512};
+constexpr std::array<int32, 3> SyntheticTextureSizes = {256, 512, 1024};
+
+constexpr int32 DefaultIterations = 10;
+
+const TCHAR* StageNames[size_t(Stage::Count)] = {
+    TEXT("loadPrimitive"),
+    TEXT("computeFlatNormals"),
+    TEXT("computeTangentSpace"),
+    TEXT("loadTextureAnyThreadPart"),
+    TEXT("buildCollisionMesh")};
+
+template <typename T>
+int32 addBufferView(CesiumGltf::Model& model, const std::vector<T>& values) {
+  CesiumGltf::Buffer& buffer = model.buffers[0];
+  const size_t byteOffset = buffer.cesium.data.size();
+  const size_t byteLength = values.size() * sizeof(T);
+  buffer.cesium.data.resize(byteOffset + byteLength);
+  std::memcpy(
+      buffer.cesium.data.data() + byteOffset,
+      values.data(),
+      byteLength);
+  buffer.byteLength = int64_t(buffer.cesium.data.size());
+
+  CesiumGltf::BufferView& bufferView = model.bufferViews.emplace_back();
+  bufferView.buffer = 0;
+  bufferView.byteOffset = int64_t(byteOffset);
+  bufferView.byteLength = int64_t(byteLength);
+  return int32(model.bufferViews.size() - 1);
+}
+
+/**
+ * Creates a textured height field with size x size vertices and texture
+ * coordinates, but no normals, like the terrain tiles converted by the
+ * tilesets.
+ */
+CesiumGltf::Model createGridModel(int32 size, int32 textureSize) {
+  CesiumGltf::Model model;
+  model.buffers.emplace_back();
+
+  std::vector<float> positions;
+  std::vector<float> uvs;
+  positions.reserve(size_t(size) * size * 3);
+  uvs.reserve(size_t(size) * size * 2);
+  const float spacing = 1000.0f / float(size - 1);
+  for (int32 y = 0; y < size; ++y) {
+    for (int32 x = 0; x < size; ++x) {
+      positions.push_back(float(x) * spacing);
+      positions.push_back(float(y) * spacing);
+      positions.push_back(
+          50.0f * std::sin(0.05f * float(x)) * std::cos(0.07f * float(y)));
+      uvs.push_back(float(x) / float(size - 1));
+      uvs.push_back(float(y) / float(size - 1));
+    }
+  }
+
+  std::vector<uint32> indices;
+  indices.reserve(size_t(size - 1) * (size - 1) * 6);
+  for (int32 y = 0; y + 1 < size; ++y) {
+    for (int32 x = 0; x + 1 < size; ++x) {
+      const uint32 i = uint32(y * size + x);
+      indices.insert(
+          indices.end(),
+          {i, i + 1, i + size, i + 1, i + size + 1, i + size});
+    }
+  }
+
+  CesiumGltf::Accessor& position = model.accessors.emplace_back();
+  position.bufferView = addBufferView(model, positions);
+  position.componentType = CesiumGltf::Accessor::ComponentType::FLOAT;
+  position.type = CesiumGltf::Accessor::Type::VEC3;
+  position.count = int64_t(size) * size;
+  position.min = {0.0, 0.0, -50.0};
+  position.max = {1000.0, 1000.0, 50.0};
+
+  CesiumGltf::Accessor& uv = model.accessors.emplace_back();
+  uv.bufferView = addBufferView(model, uvs);
+  uv.componentType = CesiumGltf::Accessor::ComponentType::FLOAT;
+  uv.type = CesiumGltf::Accessor::Type::VEC2;
+  uv.count = int64_t(size) * size;
+
+  CesiumGltf::Accessor& index = model.accessors.emplace_back();
+  index.bufferView = addBufferView(model, indices);
+  index.componentType = CesiumGltf::Accessor::ComponentType::UNSIGNED_INT;
+  index.type = CesiumGltf::Accessor::Type::SCALAR;
+  index.count = int64_t(indices.size());
+
+  CesiumGltf::Image& image = model.images.emplace_back();
+  image.cesium.width = textureSize;
+  image.cesium.height = textureSize;
+  image.cesium.channels = 4;
+  image.cesium.bytesPerChannel = 1;
+  image.cesium.pixelData.resize(size_t(textureSize) * textureSize * 4);
+  for (size_t i = 0; i < image.cesium.pixelData.size(); ++i) {
+    image.cesium.pixelData[i] = std::byte(i % 4 == 3 ? 255 : (i * 7) % 251);
+  }
+
+  CesiumGltf::Texture& texture = model.textures.emplace_back();
+  texture.source = 0;
+
+  CesiumGltf::Material& material = model.materials.emplace_back();
+  material.pbrMetallicRoughness.emplace();
+  material.pbrMetallicRoughness->baseColorTexture.emplace();
+  material.pbrMetallicRoughness->baseColorTexture->index = 0;
+
+  CesiumGltf::MeshPrimitive& primitive =
+      model.meshes.emplace_back().primitives.emplace_back();
+  primitive.attributes["POSITION"] = 0;
+  primitive.attributes["TEXCOORD_0"] = 1;
+  primitive.indices = 2;
+  primitive.material = 0;
+
+  model.nodes.emplace_back().mesh = 0;
+  model.scenes.emplace_back().nodes.push_back(0);
+  model.scene = 0;
+
+  return model;
+}
+
+bool readModel(const FString& path, CesiumGltf::Model& model) {
+  TArray<uint8> data;
+  if (!FFileHelper::LoadFileToArray(data, *path)) {
+    UE_LOG(LogCesium, Warning, TEXT("Could not read %s"), *path);
+    return false;
+  }
+
+  CesiumGltfReader::GltfReader reader;
+  CesiumGltfReader::ModelReaderResult result = reader.readModel(
+      gsl::span<const std::byte>(
+          reinterpret_cast<const std::byte*>(data.GetData()),
+          size_t(data.Num())));
+  if (!result.model) {
+    UE_LOG(
+        LogCesium,
+        Warning,
+        TEXT("Could not load %s as a glTF: %s"),
+        *path,
+        result.errors.empty() ? TEXT("")
+                              : UTF8_TO_TCHAR(result.errors[0].c_str()));
+    return false;
+  }
+
+  model = std::move(*result.model);
+  return true;
+}
+
+void benchmarkModel(
+    const FString& name,
+    const CesiumGltf::Model& model,
+    int32 iterations) {
+  CreateModelOptions options;
+  options.pModel = &model;
+  options.alwaysIncludeTangents = true;
+#if PHYSICS_INTERFACE_PHYSX
+  options.pPhysXCooking = GetPhysXCookingModule()->GetPhysXCooking();
+#endif
+
+  const glm::dmat4 transform(1.0);
+
+  // The first conversion warms up the caches and allocators, and isn't
+  // measured.
+  UCesiumGltfComponent::CreateOffGameThread(transform, options);
+
+  // Each result is freed like the result of a tile that is never shown,
+  // outside of the measured time.
+  Timings timings;
+  options.pBenchmarkTimings = &timings;
+  double seconds = 0.0;
+  for (int32 i = 0; i < iterations; ++i) {
+    const double startSeconds = FPlatformTime::Seconds();
+    std::unique_ptr<UCesiumGltfComponent::HalfConstructed> pResult =
+        UCesiumGltfComponent::CreateOffGameThread(transform, options);
+    seconds += FPlatformTime::Seconds() - startSeconds;
+    pResult.reset();
+  }
+
+  UE_LOG(
+      LogCesium,
+      Display,
+      TEXT("%s: %.3f ms per conversion"),
+      *name,
+      seconds * 1000.0 / double(iterations));
+  for (size_t i = 0; i < size_t(Stage::Count); ++i) {
+    const Timings::StageTimings& stage = timings.stages[i];
+    const double stageSeconds = FPlatformTime::ToSeconds64(stage.cycles);
+    if (stageSeconds <= 0.0) {
+      continue;
+    }
+
+    const int64 vertices = stage.vertices;
+    const int64 bytes = stage.bytes;
+    UE_LOG(
+        LogCesium,
+        Display,
+        TEXT("  %-26s %9.3f ms %9.2f ns/vertex %9.1f MB/s"),
+        StageNames[i],
+        stageSeconds * 1000.0 / double(iterations),
+        vertices > 0 ? stageSeconds * 1.0e9 / double(vertices) : 0.0,
+        double(bytes) / (1024.0 * 1024.0) / stageSeconds);
+  }
+}
+
+void runConversionBenchmark(const TArray<FString>& args) {
+  int32 iterations = DefaultIterations;
+  TArray<FString> files;
+  for (const FString& arg : args) {
+    if (!FParse::Value(*arg, TEXT("Iterations="), iterations)) {
+      files.Add(arg);
+    }
+  }
+  iterations = FMath::Max(iterations, 1);
+
+  // The conversion runs on this thread, so the stages are timed without the
+  // contention of the load threads.
+  if (files.Num() == 0) {
+    for (size_t i = 0; i < SyntheticGridSizes.size(); ++i) {
+      const int32 size = SyntheticGridSizes[i];
+      const int32 textureSize = SyntheticTextureSizes[i];
+      benchmarkModel(
+          FString::Printf(
+              TEXT("Grid of %d vertices with a %dx%d texture"),
+              size * size,
+              textureSize,
+              textureSize),
+          createGridModel(size, textureSize),
+          iterations);
+    }
+    return;
+  }
+
+  for (const FString& file : files) {
+    CesiumGltf::Model model;
+    if (readModel(file, model)) {
+      benchmarkModel(file, model, iterations);
+    }
+  }
+}
+
+FAutoConsoleCommand BenchmarkConversionCommand(
+    TEXT("Cesium.BenchmarkConversion"),
+    TEXT("Converts synthetic glTF models of several sizes, or the given .glb "
+         "files, to Unreal resources a number of times, and logs the time "
+         "per vertex and throughput of each stage of the conversion. Usage: "
+         "Cesium.BenchmarkConversion [Iterations=<count>] [<file.glb> ...]"),
+    FConsoleCommandWithArgsDelegate::CreateStatic(runConversionBenchmark));
+} // namespace
+
+CesiumConversionBenchmark::ScopedStage::ScopedStage(
+    Timings* pTimings,
+    Stage stage,
+    int64 vertices,
+    int64 bytes)
+    : _pTimings(pTimings),
+      _stage(stage),
+      _vertices(vertices),
+      _bytes(bytes),
+      _startCycles(pTimings ? FPlatformTime::Cycles64() : 0) {}
+
+CesiumConversionBenchmark::ScopedStage::~ScopedStage() {
+  if (!this->_pTimings) {
+    return;
+  }
+
+  Timings::StageTimings& stage = this->_pTimings->stages[size_t(this->_stage)];
+  stage.cycles += FPlatformTime::Cycles64() - this->_startCycles;
+  stage.vertices += this->_vertices;
+  stage.bytes += this->_bytes;
+}
@@ -0,0 +1,98 @@
+// Copyright 2020-2021 CesiumGS, Inc. and Contributors
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include <atomic>
+
+/**
+ * @brief Times the stages of the conversions of glTF models to Unreal
+ * resources that are run by the Cesium.BenchmarkConversion console command.
+ *
+ * The command converts synthetic models of several sizes, or the given .glb
+ * files, a number of times, and logs the time per vertex and throughput of
+ * each stage, so that optimizations of the load-thread hot paths can be
+ * measured and compared between versions.
+ */
+namespace CesiumConversionBenchmark {
+
+/**
+ * @brief A timed stage of the conversion.
+ */
+enum class Stage : uint8 {
+  /**
+   * @brief All of the conversion of a primitive, including the stages below
+   * other than the textures.
+   */
+  LoadPrimitive,
+
+  /**
+   * @brief The computation of flat normals for primitives without normals.
+   */
+  FlatNormals,
+
+  /**
+   * @brief The computation of tangents with MikkTSpace.
+   */
+  TangentSpace,
+
+  /**
+   * @brief The conversion of the images of the textures, and their mips.
+   */
+  Textures,
+
+  /**
+   * @brief The cooking of collision meshes.
+   */
+  Collision,
+
+  Count
+};
+
+/**
+ * @brief The time spent in each stage by the conversions of one benchmark,
+ * and the amount of data they processed. The conversions of the tiles that
+ * load meanwhile are not counted, because their options don't refer to it.
+ */
+struct Timings {
+  struct StageTimings {
+    std::atomic<uint64> cycles{0};
+    std::atomic<int64> vertices{0};
+    std::atomic<int64> bytes{0};
+  };
+
+  StageTimings stages[size_t(Stage::Count)];
+};
+
+/**
+ * @brief Times the scope it lives in as the given stage, if the conversion is
+ * benchmarked. Otherwise, it costs nothing. May be used in any thread.
+ */
+class ScopedStage {
+public:
+  /**
+   * @brief Starts timing a stage.
+   *
+   * @param pTimings The timings of the benchmark to add the stage to, which
+   * is the pBenchmarkTimings of the CreateModelOptions, or nullptr if the
+   * conversion isn't benchmarked.
+   * @param stage The stage.
+   * @param vertices The number of vertices processed, or zero.
+   * @param bytes The number of bytes of input processed, which is the vertex
+   * and index data of the geometry stages and the pixels of the textures.
+   */
+  ScopedStage(Timings* pTimings, Stage stage, int64 vertices, int64 bytes);
+  ~ScopedStage();
+
+  ScopedStage(const ScopedStage&) = delete;
+  ScopedStage& operator=(const ScopedStage&) = delete;
+
+private:
+  Timings* _pTimings;
+  Stage _stage;
+  int64 _vertices;
+  int64 _bytes;
+  uint64 _startCycles;
+};
+
+} // namespace CesiumConversionBenchmark
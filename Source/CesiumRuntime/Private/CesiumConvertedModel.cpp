@@ -0,0 +1,1091 @@
+// Copyright 2020-2021 CesiumGS, Inc. and Contributors
+
+#include "CesiumConvertedModel.h"
+#include "CesiumFarFieldProxy.h"
+#include "CesiumGltf/ExtensionKhrTextureBasisu.h"
+#include "CesiumGltf/Model.h"
+#include "CesiumRuntimeSettings.h"
+#include "CesiumTriangleBVH.h"
+#include "CesiumUtility/JsonValue.h"
+#include "CesiumUtility/Tracing.h"
+#include "CreateModelOptions.h"
+#include "Hash/CityHash.h"
+#include "Runtime/Launch/Resources/Version.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+#include <type_traits>
+#include <unordered_set>
+#include <variant>
+
+#if PHYSICS_INTERFACE_PHYSX
+#include "PhysXIncludes.h"
+#else
+#include "Chaos/ChaosArchive.h"
+#endif
+
+using namespace CesiumGltf;
+
+namespace {
+
+constexpr uint32 Magic = 0x314d4343; // "CCM1"
+constexpr uint32 Version = 2;
+constexpr int64 HeaderSize = 2 * sizeof(uint32) + sizeof(uint64);
+
+/**
+ * Hashes the parts of a model that its conversion reads. Unordered
+ * containers are hashed independently of their order.
+ */
+class KeyHasher {
+public:
+  uint64 hash = 0;
+
+  void addBytes(const void* pData, size_t size) {
+    // CityHash takes 32-bit sizes, so large buffers are hashed in chunks.
+    const char* pBytes = static_cast<const char*>(pData);
+    constexpr size_t chunkSize = size_t(1) << 30;
+    do {
+      const size_t chunk = FMath::Min(size, chunkSize);
+      this->hash = CityHash64WithSeed(pBytes, uint32(chunk), this->hash);
+      pBytes += chunk;
+      size -= chunk;
+    } while (size > 0);
+  }
+
+  template <typename T> void add(const T& value) {
+    static_assert(std::is_trivially_copyable_v<T>);
+    this->addBytes(&value, sizeof(T));
+  }
+
+  template <typename T> void add(const std::optional<T>& value) {
+    this->add(value.has_value());
+    if (value) {
+      this->add(*value);
+    }
+  }
+
+  template <typename T> void add(const std::vector<T>& values) {
+    this->add(values.size());
+    for (const T& value : values) {
+      this->add(value);
+    }
+  }
+
+  void add(const std::string& value) {
+    this->add(value.size());
+    this->addBytes(value.data(), value.size());
+  }
+
+  void add(const FString& value) {
+    this->add(std::string(TCHAR_TO_UTF8(*value)));
+  }
+
+  void add(const CesiumUtility::JsonValue& value) {
+    this->add(value.value.index());
+    std::visit(
+        [this](const auto& alternative) { this->addJson(alternative); },
+        value.value);
+  }
+
+  void add(const CesiumGltf::TextureInfo& info) {
+    this->add(info.index);
+    this->add(info.texCoord);
+  }
+
+  template <typename TMap> void addUnordered(const TMap& map) {
+    uint64 sum = 0;
+    for (const auto& entry : map) {
+      KeyHasher entryHasher;
+      entryHasher.add(entry.first);
+      entryHasher.add(entry.second);
+      sum += entryHasher.hash;
+    }
+    this->add(map.size());
+    this->add(sum);
+  }
+
+  template <typename TMap> void addKeys(const TMap& map) {
+    uint64 sum = 0;
+    for (const auto& entry : map) {
+      KeyHasher entryHasher;
+      entryHasher.add(entry.first);
+      sum += entryHasher.hash;
+    }
+    this->add(map.size());
+    this->add(sum);
+  }
+
+private:
+  void addJson(const CesiumUtility::JsonValue::Null&) {}
+  void addJson(const CesiumUtility::JsonValue::Object& object) {
+    this->addUnordered(object);
+  }
+  template <typename T> void addJson(const T& value) { this->add(value); }
+};
+
+void addMaterial(KeyHasher& hasher, const Material& material) {
+  hasher.add(material.pbrMetallicRoughness.has_value());
+  if (material.pbrMetallicRoughness) {
+    hasher.add(material.pbrMetallicRoughness->baseColorFactor);
+    hasher.add(material.pbrMetallicRoughness->metallicFactor);
+    hasher.add(material.pbrMetallicRoughness->roughnessFactor);
+    hasher.add(material.pbrMetallicRoughness->baseColorTexture);
+    hasher.add(material.pbrMetallicRoughness->metallicRoughnessTexture);
+  }
+  hasher.add(material.normalTexture.has_value());
+  if (material.normalTexture) {
+    hasher.add(material.normalTexture->index);
+    hasher.add(material.normalTexture->texCoord);
+    hasher.add(material.normalTexture->scale);
+  }
+  hasher.add(material.occlusionTexture.has_value());
+  if (material.occlusionTexture) {
+    hasher.add(material.occlusionTexture->index);
+    hasher.add(material.occlusionTexture->texCoord);
+    hasher.add(material.occlusionTexture->strength);
+  }
+  hasher.add(material.emissiveTexture);
+  hasher.add(material.emissiveFactor);
+  hasher.add(material.alphaMode);
+  hasher.add(material.alphaCutoff);
+  hasher.add(material.doubleSided);
+  hasher.addUnordered(material.extras);
+  hasher.addKeys(material.extensions);
+}
+
+void addModel(KeyHasher& hasher, const Model& model) {
+  for (const Buffer& buffer : model.buffers) {
+    hasher.add(buffer.cesium.data.size());
+    hasher.addBytes(buffer.cesium.data.data(), buffer.cesium.data.size());
+  }
+
+  for (const Image& image : model.images) {
+    const ImageCesium& cesium = image.cesium;
+    hasher.add(cesium.width);
+    hasher.add(cesium.height);
+    hasher.add(cesium.channels);
+    hasher.add(cesium.bytesPerChannel);
+    hasher.add(cesium.compressedPixelFormat);
+    hasher.add(cesium.mipPositions.size());
+    for (const ImageCesiumMipPosition& mip : cesium.mipPositions) {
+      hasher.add(mip.byteOffset);
+      hasher.add(mip.byteSize);
+    }
+    hasher.add(cesium.pixelData.size());
+    hasher.addBytes(cesium.pixelData.data(), cesium.pixelData.size());
+  }
+
+  for (const BufferView& bufferView : model.bufferViews) {
+    hasher.add(bufferView.buffer);
+    hasher.add(bufferView.byteOffset);
+    hasher.add(bufferView.byteLength);
+    hasher.add(bufferView.byteStride);
+  }
+
+  for (const Accessor& accessor : model.accessors) {
+    hasher.add(accessor.bufferView);
+    hasher.add(accessor.byteOffset);
+    hasher.add(accessor.componentType);
+    hasher.add(accessor.normalized);
+    hasher.add(accessor.count);
+    hasher.add(accessor.type);
+    hasher.add(accessor.min);
+    hasher.add(accessor.max);
+    hasher.add(accessor.sparse.has_value());
+  }
+
+  for (const Mesh& mesh : model.meshes) {
+    hasher.add(mesh.primitives.size());
+    for (const MeshPrimitive& primitive : mesh.primitives) {
+      hasher.add(primitive.mode);
+      hasher.add(primitive.indices);
+      hasher.add(primitive.material);
+      hasher.addUnordered(primitive.attributes);
+      hasher.addUnordered(primitive.extras);
+      hasher.addKeys(primitive.extensions);
+    }
+  }
+
+  for (const Material& material : model.materials) {
+    addMaterial(hasher, material);
+  }
+
+  for (const Texture& texture : model.textures) {
+    hasher.add(texture.source);
+    hasher.add(texture.sampler);
+    const ExtensionKhrTextureBasisu* pKtx =
+        texture.getExtension<ExtensionKhrTextureBasisu>();
+    hasher.add(pKtx ? pKtx->source : int32_t(-1));
+  }
+
+  for (const Sampler& sampler : model.samplers) {
+    hasher.add(sampler.magFilter);
+    hasher.add(sampler.minFilter);
+    hasher.add(sampler.wrapS);
+    hasher.add(sampler.wrapT);
+  }
+
+  for (const Node& node : model.nodes) {
+    hasher.add(node.mesh);
+    hasher.add(node.children);
+    hasher.add(node.matrix);
+    hasher.add(node.translation);
+    hasher.add(node.rotation);
+    hasher.add(node.scale);
+    hasher.addKeys(node.extensions);
+  }
+
+  for (const Scene& scene : model.scenes) {
+    hasher.add(scene.nodes);
+  }
+  hasher.add(model.scene);
+
+  // The extras hold the URL of the tile, its RTC center and its up axis.
+  hasher.addUnordered(model.extras);
+}
+
+void serializeString(FArchive& Ar, std::string& value) {
+  int64 length = int64(value.size());
+  Ar << length;
+  if (Ar.IsLoading()) {
+    if (length < 0 || length > Ar.TotalSize() - Ar.Tell()) {
+      Ar.SetError();
+      return;
+    }
+    value.resize(size_t(length));
+  }
+  Ar.Serialize(value.data(), length);
+}
+
+void serializeTransform(FArchive& Ar, glm::dmat4x4& transform) {
+  for (glm::length_t column = 0; column < 4; ++column) {
+    for (glm::length_t row = 0; row < 4; ++row) {
+      Ar << transform[column][row];
+    }
+  }
+}
+
+template <typename TEnum> void serializeEnum(FArchive& Ar, TEnum& value) {
+  int32 intValue = int32(value);
+  Ar << intValue;
+  value = TEnum(intValue);
+}
+
+template <typename TArrayType>
+bool serializeBytes(FArchive& Ar, TArrayType& bytes) {
+  int64 size = int64(bytes.Num());
+  Ar << size;
+  if (Ar.IsLoading()) {
+    if (size < 0 || size > Ar.TotalSize() - Ar.Tell()) {
+      Ar.SetError();
+      return false;
+    }
+    bytes.SetNumUninitialized(int32(size));
+  }
+  Ar.Serialize(bytes.GetData(), size);
+  return !Ar.IsError();
+}
+
+/**
+ * Writes or reads the platform data of a texture, which must have the bulk
+ * data of all of its mips when it is written.
+ */
+bool serializeTexture(
+    FArchive& Ar,
+    CesiumTextureUtility::LoadedTextureResult& texture) {
+  serializeEnum(Ar, texture.addressX);
+  serializeEnum(Ar, texture.addressY);
+  serializeEnum(Ar, texture.filter);
+  Ar << texture.generateMipsOnGPU;
+  Ar << texture.streamable;
+  Ar << texture.sRGB;
+
+  if (Ar.IsLoading()) {
+    texture.pTextureData = new FTexturePlatformData();
+  }
+  FTexturePlatformData& textureData = *texture.pTextureData;
+
+  int32 sizeX = textureData.SizeX;
+  int32 sizeY = textureData.SizeY;
+  EPixelFormat pixelFormat = textureData.PixelFormat;
+  int32 numMips = textureData.Mips.Num();
+  Ar << sizeX;
+  Ar << sizeY;
+  serializeEnum(Ar, pixelFormat);
+  Ar << numMips;
+  if (Ar.IsError() || numMips < 0 || numMips > MAX_TEXTURE_MIP_COUNT) {
+    return false;
+  }
+  textureData.SizeX = sizeX;
+  textureData.SizeY = sizeY;
+  textureData.PixelFormat = pixelFormat;
+
+  for (int32 i = 0; i < numMips; ++i) {
+    if (Ar.IsLoading()) {
+      textureData.Mips.Add(new FTexture2DMipMap());
+    }
+    FTexture2DMipMap& mip = textureData.Mips[i];
+
+    int32 mipSizeX = mip.SizeX;
+    int32 mipSizeY = mip.SizeY;
+    int64 byteSize = mip.BulkData.GetBulkDataSize();
+    Ar << mipSizeX;
+    Ar << mipSizeY;
+    Ar << byteSize;
+
+    if (Ar.IsLoading()) {
+      if (Ar.IsError() || byteSize <= 0 ||
+          byteSize > Ar.TotalSize() - Ar.Tell()) {
+        return false;
+      }
+      mip.SizeX = mipSizeX;
+      mip.SizeY = mipSizeY;
+      mip.BulkData.Lock(LOCK_READ_WRITE);
+      Ar.Serialize(mip.BulkData.Realloc(byteSize), byteSize);
+      mip.BulkData.Unlock();
+    } else {
+      // The bulk data is gone once the RHI texture is created, unless it was
+      // deferred.
+      if (byteSize <= 0) {
+        return false;
+      }
+      void* pData = mip.BulkData.Lock(LOCK_READ_ONLY);
+      Ar.Serialize(pData, byteSize);
+      mip.BulkData.Unlock();
+    }
+  }
+
+  return !Ar.IsError();
+}
+
+bool serializeRenderData(FArchive& Ar, FStaticMeshRenderData*& pRenderData) {
+  bool hasRenderData = pRenderData != nullptr;
+  Ar << hasRenderData;
+  if (!hasRenderData) {
+    return !Ar.IsError();
+  }
+
+  if (Ar.IsLoading()) {
+    pRenderData = new FStaticMeshRenderData();
+    pRenderData->AllocateLODResources(1);
+  }
+
+  FStaticMeshLODResources& LODResources = pRenderData->LODResources[0];
+  FStaticMeshVertexBuffers& vertexBuffers = LODResources.VertexBuffers;
+  FStaticMeshVertexBuffer& meshBuffer = vertexBuffers.StaticMeshVertexBuffer;
+
+  Ar << pRenderData->Bounds;
+
+  uint32 numVertices = vertexBuffers.PositionVertexBuffer.GetNumVertices();
+  uint32 numTexCoords = meshBuffer.GetNumTexCoords();
+  uint32 numColors = vertexBuffers.ColorVertexBuffer.GetNumVertices();
+  bool highPrecisionTangents = meshBuffer.GetUseHighPrecisionTangentBasis();
+  bool fullPrecisionUVs = meshBuffer.GetUseFullPrecisionUVs();
+  bool hasColorVertexData = LODResources.bHasColorVertexData;
+  Ar << numVertices;
+  Ar << numTexCoords;
+  Ar << numColors;
+  Ar << highPrecisionTangents;
+  Ar << fullPrecisionUVs;
+  Ar << hasColorVertexData;
+
+  if (Ar.IsLoading()) {
+    if (Ar.IsError() || numTexCoords > MAX_STATIC_TEXCOORDS ||
+        (numColors != 0 && numColors != numVertices) ||
+        int64(numVertices) * sizeof(FVector) >
+            Ar.TotalSize() - Ar.Tell()) {
+      return false;
+    }
+    meshBuffer.SetUseHighPrecisionTangentBasis(highPrecisionTangents);
+    meshBuffer.SetUseFullPrecisionUVs(fullPrecisionUVs);
+    vertexBuffers.PositionVertexBuffer.Init(numVertices, false);
+    meshBuffer.Init(numVertices, FMath::Max(numTexCoords, 1u), false);
+    if (numColors > 0) {
+      vertexBuffers.ColorVertexBuffer.Init(numColors, false);
+    }
+    LODResources.bHasColorVertexData = hasColorVertexData;
+    LODResources.bHasDepthOnlyIndices = false;
+    LODResources.bHasReversedIndices = false;
+    LODResources.bHasReversedDepthOnlyIndices = false;
+#if ENGINE_MAJOR_VERSION < 5
+    LODResources.bHasAdjacencyInfo = false;
+#endif
+  }
+
+  if (numVertices > 0) {
+    Ar.Serialize(
+        vertexBuffers.PositionVertexBuffer.GetVertexData(),
+        int64(numVertices) * vertexBuffers.PositionVertexBuffer.GetStride());
+    Ar.Serialize(meshBuffer.GetTangentData(), meshBuffer.GetTangentSize());
+    Ar.Serialize(meshBuffer.GetTexCoordData(), meshBuffer.GetTexCoordSize());
+  }
+  if (numColors > 0) {
+    Ar.Serialize(
+        vertexBuffers.ColorVertexBuffer.GetVertexData(),
+        int64(numColors) * vertexBuffers.ColorVertexBuffer.GetStride());
+  }
+
+  bool is32Bit = LODResources.IndexBuffer.Is32Bit();
+  TArray<uint32> indices;
+  if (!Ar.IsLoading()) {
+    LODResources.IndexBuffer.GetCopy(indices);
+  }
+  Ar << is32Bit;
+  Ar << indices;
+  if (Ar.IsLoading()) {
+    LODResources.IndexBuffer.SetIndices(
+        indices,
+        is32Bit ? EIndexBufferStride::Type::Force32Bit
+                : EIndexBufferStride::Type::Force16Bit);
+  }
+
+  auto& sections = LODResources.Sections;
+  int32 numSections = sections.Num();
+  Ar << numSections;
+  if (Ar.IsError() || numSections < 0 || numSections > 1024) {
+    return false;
+  }
+  for (int32 i = 0; i < numSections; ++i) {
+    FStaticMeshSection& section =
+        Ar.IsLoading() ? sections.AddDefaulted_GetRef() : sections[i];
+    bool enableCollision = section.bEnableCollision;
+    bool castShadow = section.bCastShadow;
+    Ar << section.MaterialIndex;
+    Ar << section.FirstIndex;
+    Ar << section.NumTriangles;
+    Ar << section.MinVertexIndex;
+    Ar << section.MaxVertexIndex;
+    Ar << enableCollision;
+    Ar << castShadow;
+    section.bEnableCollision = enableCollision;
+    section.bCastShadow = castShadow;
+  }
+
+  return !Ar.IsError();
+}
+
+bool serializeCollisionMesh(
+    FArchive& Ar,
+    CesiumCollisionMesh& pCollisionMesh,
+    TArray<uint8>& cooked) {
+  bool hasCollisionMesh = pCollisionMesh != nullptr;
+  Ar << hasCollisionMesh;
+  if (!hasCollisionMesh) {
+    return !Ar.IsError();
+  }
+
+  // A collision mesh without its cooked form can't be written.
+  if (!Ar.IsLoading() && cooked.Num() == 0) {
+    return false;
+  }
+
+  if (!serializeBytes(Ar, cooked)) {
+    return false;
+  }
+
+  if (Ar.IsLoading()) {
+    pCollisionMesh = CesiumConvertedModel::readCollisionMesh(cooked);
+    cooked.Empty();
+    return pCollisionMesh != nullptr;
+  }
+  return true;
+}
+
+template <typename T>
+void serializeShared(FArchive& Ar, std::shared_ptr<T>& pValue) {
+  bool hasValue = pValue != nullptr;
+  Ar << hasValue;
+  if (Ar.IsLoading() && hasValue) {
+    pValue = std::make_shared<T>();
+  }
+}
+
+/**
+ * Maps the pointers of a converted model into the glTF model and its shared
+ * textures to indices, and back.
+ */
+struct ModelContext {
+  const Model& model;
+  const Material& defaultMaterial;
+  std::vector<CesiumTextureUtility::LoadedTextureResult*> textures;
+
+  int32 getTextureIndex(
+      const CesiumTextureUtility::LoadedTextureResult* pTexture) const {
+    auto it = std::find(this->textures.begin(), this->textures.end(), pTexture);
+    return it == this->textures.end() ? -1
+                                      : int32(it - this->textures.begin());
+  }
+
+  bool serializeTextureIndex(
+      FArchive& Ar,
+      CesiumTextureUtility::LoadedTextureResult*& pTexture) const {
+    int32 index = this->getTextureIndex(pTexture);
+    Ar << index;
+    if (Ar.IsLoading()) {
+      if (index >= int32(this->textures.size())) {
+        return false;
+      }
+      pTexture = index >= 0 ? this->textures[size_t(index)] : nullptr;
+    }
+    return true;
+  }
+
+  bool serializeMeshPrimitive(
+      FArchive& Ar,
+      const MeshPrimitive*& pPrimitive) const {
+    int32 meshIndex = -1;
+    int32 primitiveIndex = -1;
+    if (!Ar.IsLoading() && pPrimitive) {
+      for (size_t i = 0; i < this->model.meshes.size(); ++i) {
+        const std::vector<MeshPrimitive>& primitives =
+            this->model.meshes[i].primitives;
+        if (pPrimitive >= primitives.data() &&
+            pPrimitive < primitives.data() + primitives.size()) {
+          meshIndex = int32(i);
+          primitiveIndex = int32(pPrimitive - primitives.data());
+          break;
+        }
+      }
+      if (meshIndex < 0) {
+        return false;
+      }
+    }
+
+    Ar << meshIndex;
+    Ar << primitiveIndex;
+    if (Ar.IsLoading()) {
+      if (meshIndex < 0) {
+        pPrimitive = nullptr;
+        return true;
+      }
+      if (meshIndex >= int32(this->model.meshes.size()) ||
+          primitiveIndex < 0 ||
+          primitiveIndex >=
+              int32(this->model.meshes[meshIndex].primitives.size())) {
+        return false;
+      }
+      pPrimitive = &this->model.meshes[meshIndex].primitives[primitiveIndex];
+    }
+    return true;
+  }
+
+  bool
+  serializeMaterial(FArchive& Ar, const Material*& pMaterial) const {
+    // -2 is no material, and -1 is the default material.
+    int32 materialIndex = -2;
+    if (!Ar.IsLoading() && pMaterial) {
+      const std::vector<Material>& materials = this->model.materials;
+      materialIndex = pMaterial >= materials.data() &&
+                              pMaterial < materials.data() + materials.size()
+                          ? int32(pMaterial - materials.data())
+                          : -1;
+    }
+
+    Ar << materialIndex;
+    if (Ar.IsLoading()) {
+      if (materialIndex >= int32(this->model.materials.size()) ||
+          materialIndex < -2) {
+        return false;
+      }
+      pMaterial = materialIndex >= 0 ? &this->model.materials[materialIndex]
+                  : materialIndex == -1 ? &this->defaultMaterial
+                                        : nullptr;
+    }
+    return true;
+  }
+};
+
+bool serializePrimitive(
+    FArchive& Ar,
+    const ModelContext& context,
+    LoadPrimitiveResult& primitive) {
+  if (!serializeRenderData(Ar, primitive.RenderData) ||
+      !context.serializeMeshPrimitive(Ar, primitive.pMeshPrimitive) ||
+      !context.serializeMaterial(Ar, primitive.pMaterial)) {
+    return false;
+  }
+
+  bool hasModel = primitive.pModel != nullptr;
+  Ar << hasModel;
+  if (Ar.IsLoading()) {
+    primitive.pModel = hasModel ? &context.model : nullptr;
+  }
+
+  serializeTransform(Ar, primitive.transform);
+
+  if (!serializeCollisionMesh(
+          Ar,
+          primitive.pCollisionMesh,
+          primitive.cookedCollisionMesh)) {
+    return false;
+  }
+
+  int32 numMerged = int32(primitive.mergedCollisionMeshes.size());
+  Ar << numMerged;
+  if (Ar.IsError() || numMerged < 0 ||
+      (!Ar.IsLoading() &&
+       primitive.mergedCookedCollisionMeshes.size() != size_t(numMerged)) ||
+      (Ar.IsLoading() && numMerged > Ar.TotalSize() - Ar.Tell())) {
+    return false;
+  }
+  primitive.mergedCollisionMeshes.resize(size_t(numMerged), nullptr);
+  primitive.mergedCookedCollisionMeshes.resize(size_t(numMerged));
+  for (int32 i = 0; i < numMerged; ++i) {
+    if (!serializeCollisionMesh(
+            Ar,
+            primitive.mergedCollisionMeshes[i],
+            primitive.mergedCookedCollisionMeshes[i])) {
+      return false;
+    }
+  }
+  if (Ar.IsLoading()) {
+    primitive.mergedCookedCollisionMeshes.clear();
+  }
+
+  serializeShared(Ar, primitive.pDeferredCollision);
+  if (primitive.pDeferredCollision) {
+    Ar << primitive.pDeferredCollision->positions;
+    Ar << primitive.pDeferredCollision->indices;
+    Ar << primitive.pDeferredCollision->bounds;
+  }
+
+  std::shared_ptr<CesiumFarFieldGeometry> pFarFieldGeometry =
+      std::const_pointer_cast<CesiumFarFieldGeometry>(
+          primitive.pFarFieldGeometry);
+  serializeShared(Ar, pFarFieldGeometry);
+  if (pFarFieldGeometry) {
+    Ar << pFarFieldGeometry->positions;
+    Ar << pFarFieldGeometry->colors;
+    Ar << pFarFieldGeometry->indices;
+  }
+  primitive.pFarFieldGeometry = std::move(pFarFieldGeometry);
+
+  // Only the triangles of the hierarchy are written, and it is built again
+  // from them when it is read.
+  bool hasQueryBVH = primitive.pQueryBVH != nullptr;
+  Ar << hasQueryBVH;
+  if (hasQueryBVH) {
+    TArray<CesiumTriangleBVH::Vector> positions;
+    TArray<uint32> indices;
+    if (!Ar.IsLoading()) {
+      positions = primitive.pQueryBVH->getPositions();
+      indices = primitive.pQueryBVH->getIndices();
+    }
+    Ar << positions;
+    Ar << indices;
+    if (Ar.IsLoading() && !Ar.IsError()) {
+      primitive.pQueryBVH = std::make_shared<const CesiumTriangleBVH>(
+          MoveTemp(positions),
+          MoveTemp(indices));
+    }
+  }
+
+  Ar << primitive.collisionBytes;
+  Ar << primitive.faceFeatureIDs;
+
+  int32 numFeatureBounds = primitive.featureBounds.Num();
+  Ar << numFeatureBounds;
+  if (Ar.IsError() || numFeatureBounds < 0 ||
+      (Ar.IsLoading() && numFeatureBounds > Ar.TotalSize() - Ar.Tell())) {
+    return false;
+  }
+  primitive.featureBounds.SetNum(numFeatureBounds);
+  for (CesiumPrimitiveFeatureBounds& bounds : primitive.featureBounds) {
+    Ar << bounds.featureID;
+    Ar << bounds.bounds;
+  }
+
+  serializeString(Ar, primitive.name);
+  Ar << primitive.collisionOnly;
+  Ar << primitive.pointCloud;
+  Ar << primitive.flatNormalsInMaterial;
+  Ar << primitive.onlyLand;
+  Ar << primitive.onlyWater;
+  Ar << primitive.waterMaskTranslationX;
+  Ar << primitive.waterMaskTranslationY;
+  Ar << primitive.waterMaskScale;
+
+  if (!context.serializeTextureIndex(Ar, primitive.baseColorTexture) ||
+      !context.serializeTextureIndex(
+          Ar,
+          primitive.metallicRoughnessTexture) ||
+      !context.serializeTextureIndex(Ar, primitive.normalTexture) ||
+      !context.serializeTextureIndex(Ar, primitive.emissiveTexture) ||
+      !context.serializeTextureIndex(Ar, primitive.occlusionTexture)) {
+    return false;
+  }
+
+  int32 numParameters = int32(primitive.textureCoordinateParameters.size());
+  Ar << numParameters;
+  if (Ar.IsError() || numParameters < 0 ||
+      (Ar.IsLoading() && numParameters > Ar.TotalSize() - Ar.Tell())) {
+    return false;
+  }
+  if (Ar.IsLoading()) {
+    for (int32 i = 0; i < numParameters; ++i) {
+      std::string name;
+      uint32 value = 0;
+      serializeString(Ar, name);
+      Ar << value;
+      primitive.textureCoordinateParameters[name] = value;
+    }
+  } else {
+    for (const auto& parameter : primitive.textureCoordinateParameters) {
+      std::string name = parameter.first;
+      uint32 value = parameter.second;
+      serializeString(Ar, name);
+      Ar << value;
+    }
+  }
+
+  for (int32_t& uvIndex : primitive.overlayTextureCoordinateIDToUVIndex) {
+    Ar << uvIndex;
+  }
+
+  return !Ar.IsError();
+}
+
+/**
+ * Gets the textures of a converted model that are shared by its primitives,
+ * in the order of their first use.
+ */
+std::vector<CesiumTextureUtility::LoadedTextureResult*>
+getSharedTextures(const LoadModelResult& result) {
+  std::vector<CesiumTextureUtility::LoadedTextureResult*> textures;
+  auto add = [&textures](CesiumTextureUtility::LoadedTextureResult* pTexture) {
+    if (pTexture &&
+        std::find(textures.begin(), textures.end(), pTexture) ==
+            textures.end()) {
+      textures.push_back(pTexture);
+    }
+  };
+
+  for (const LoadNodeResult& node : result.nodeResults) {
+    if (!node.meshResult) {
+      continue;
+    }
+    for (const LoadPrimitiveResult& primitive :
+         node.meshResult->primitiveResults) {
+      add(primitive.baseColorTexture);
+      add(primitive.metallicRoughnessTexture);
+      add(primitive.normalTexture);
+      add(primitive.emissiveTexture);
+      add(primitive.occlusionTexture);
+    }
+  }
+
+  return textures;
+}
+
+void releaseCollisionMesh(CesiumCollisionMesh& pCollisionMesh) {
+#if PHYSICS_INTERFACE_PHYSX
+  if (pCollisionMesh) {
+    pCollisionMesh->release();
+  }
+#endif
+  pCollisionMesh = nullptr;
+}
+
+/**
+ * Frees what was restored of a converted model that turned out not to be
+ * valid.
+ */
+void releaseRestoredModel(
+    LoadModelResult& result,
+    const std::vector<CesiumTextureUtility::LoadedTextureResult*>& textures) {
+  for (LoadNodeResult& node : result.nodeResults) {
+    if (!node.meshResult) {
+      continue;
+    }
+    for (LoadPrimitiveResult& primitive : node.meshResult->primitiveResults) {
+      delete primitive.RenderData;
+      primitive.RenderData = nullptr;
+      releaseCollisionMesh(primitive.pCollisionMesh);
+      for (CesiumCollisionMesh& pMerged : primitive.mergedCollisionMeshes) {
+        releaseCollisionMesh(pMerged);
+      }
+    }
+  }
+
+  for (CesiumTextureUtility::LoadedTextureResult* pTexture : textures) {
+    CesiumTextureUtility::destroyHalfLoadedTexture(pTexture);
+  }
+
+  result = LoadModelResult();
+}
+
+bool serializeModel(
+    FArchive& Ar,
+    ModelContext& context,
+    LoadModelResult& result) {
+  int32 numTextures = int32(context.textures.size());
+  Ar << numTextures;
+  if (Ar.IsError() || numTextures < 0 ||
+      (Ar.IsLoading() && numTextures > Ar.TotalSize() - Ar.Tell())) {
+    return false;
+  }
+  if (Ar.IsLoading()) {
+    context.textures.resize(size_t(numTextures), nullptr);
+  }
+  for (CesiumTextureUtility::LoadedTextureResult*& pTexture :
+       context.textures) {
+    if (Ar.IsLoading()) {
+      pTexture = new CesiumTextureUtility::LoadedTextureResult{};
+    }
+    if (!serializeTexture(Ar, *pTexture)) {
+      return false;
+    }
+  }
+
+  int32 numNodes = int32(result.nodeResults.size());
+  Ar << numNodes;
+  if (Ar.IsError() || numNodes < 0 ||
+      (Ar.IsLoading() && numNodes > Ar.TotalSize() - Ar.Tell())) {
+    return false;
+  }
+  result.nodeResults.resize(size_t(numNodes));
+
+  for (LoadNodeResult& node : result.nodeResults) {
+    bool hasMesh = node.meshResult.has_value();
+    Ar << hasMesh;
+    if (!hasMesh) {
+      continue;
+    }
+    if (Ar.IsLoading()) {
+      node.meshResult.emplace();
+    }
+
+    std::vector<LoadPrimitiveResult>& primitives =
+        node.meshResult->primitiveResults;
+    int32 numPrimitives = int32(primitives.size());
+    Ar << numPrimitives;
+    if (Ar.IsError() || numPrimitives < 0 ||
+        (Ar.IsLoading() && numPrimitives > Ar.TotalSize() - Ar.Tell())) {
+      return false;
+    }
+    primitives.resize(size_t(numPrimitives));
+
+    // The instance transforms are shared by the primitives of the node.
+    std::shared_ptr<const TArray<FTransform>> pInstanceTransforms =
+        numPrimitives > 0 ? primitives[0].pInstanceTransforms : nullptr;
+    bool hasInstances = pInstanceTransforms != nullptr;
+    Ar << hasInstances;
+    if (hasInstances) {
+      TArray<FTransform> instanceTransforms;
+      if (!Ar.IsLoading()) {
+        instanceTransforms = *pInstanceTransforms;
+      }
+      Ar << instanceTransforms;
+      if (Ar.IsLoading()) {
+        pInstanceTransforms = std::make_shared<const TArray<FTransform>>(
+            MoveTemp(instanceTransforms));
+      }
+    }
+
+    for (LoadPrimitiveResult& primitive : primitives) {
+      if (Ar.IsLoading()) {
+        primitive.pInstanceTransforms = pInstanceTransforms;
+      }
+      if (!serializePrimitive(Ar, context, primitive)) {
+        return false;
+      }
+    }
+  }
+
+  return !Ar.IsError();
+}
+
+} // namespace
+
+uint64 CesiumConvertedModel::computeKey(
+    const Model& model,
+    const glm::dmat4x4& transform,
+    const CreateModelOptions& options) {
+  CESIUM_TRACE("CesiumConvertedModel::computeKey");
+
+  KeyHasher hasher;
+  hasher.add(Version);
+  hasher.add(ENGINE_MAJOR_VERSION);
+  hasher.add(ENGINE_MINOR_VERSION);
+
+  hasher.add(transform);
+  hasher.add(options.alwaysIncludeTangents);
+  hasher.add(options.highPrecisionVertexAttributes);
+  hasher.add(options.flatNormalsInMaterial);
+  hasher.add(options.optimizeMeshes);
+  hasher.add(options.mergePrimitives);
+  hasher.add(options.streamTextures);
+  hasher.add(options.maximumTextureSize);
+  hasher.add(options.metadataTextureProperties.Num());
+  for (const FString& property : options.metadataTextureProperties) {
+    hasher.add(property);
+  }
+  hasher.add(options.buildFeatureIndex);
+  hasher.add(options.buildGeometryQueries);
+  hasher.add(options.collisionOnly);
+  hasher.add(options.renderHeightfields);
+  hasher.add(options.deferPhysicsMeshes);
+  hasher.add(options.collisionSimplificationError);
+  hasher.add(options.farFieldSimplificationError);
+#if PHYSICS_INTERFACE_PHYSX
+  hasher.add(options.pPhysXCooking != nullptr);
+#endif
+
+  const UCesiumRuntimeSettings* pSettings =
+      GetDefault<UCesiumRuntimeSettings>();
+  hasher.add(pSettings->TextureCompression);
+  hasher.add(pSettings->GenerateMipmapsOnGPU);
+
+  addModel(hasher, model);
+  return hasher.hash;
+}
+
+bool CesiumConvertedModel::write(
+    const LoadModelResult& result,
+    const Model& model,
+    TArray<uint8>& data) {
+  CESIUM_TRACE("CesiumConvertedModel::write");
+
+  data.Reset();
+
+  // Heightfields aren't written, because sampling them again takes about as
+  // long as reading them.
+  for (const LoadNodeResult& node : result.nodeResults) {
+    if (!node.meshResult) {
+      continue;
+    }
+    for (const LoadPrimitiveResult& primitive :
+         node.meshResult->primitiveResults) {
+      if (primitive.heightfield) {
+        return false;
+      }
+    }
+  }
+
+#if CESIUM_BUILD_NANITE
+  // Nanite resources aren't written, and are built again when converting.
+  for (const LoadNodeResult& node : result.nodeResults) {
+    if (!node.meshResult) {
+      continue;
+    }
+    for (const LoadPrimitiveResult& primitive :
+         node.meshResult->primitiveResults) {
+      if (primitive.RenderData &&
+          primitive.RenderData->NaniteResources.PageStreamingStates.Num() >
+              0) {
+        return false;
+      }
+    }
+  }
+#endif
+
+  // The serialization functions are shared with read, so they take mutable
+  // references, but nothing is modified while writing.
+  LoadModelResult& mutableResult = const_cast<LoadModelResult&>(result);
+  const Material defaultMaterial;
+  ModelContext context{model, defaultMaterial, getSharedTextures(result)};
+
+  TArray<uint8> payload;
+  FMemoryWriter writer(payload);
+  if (!serializeModel(writer, context, mutableResult)) {
+    return false;
+  }
+
+  uint32 magic = Magic;
+  uint32 version = Version;
+  uint64 hash = CityHash64(
+      reinterpret_cast<const char*>(payload.GetData()),
+      uint32(payload.Num()));
+
+  data.Reserve(HeaderSize + payload.Num());
+  FMemoryWriter headerWriter(data);
+  headerWriter << magic;
+  headerWriter << version;
+  headerWriter << hash;
+  data.Append(payload);
+  return true;
+}
+
+bool CesiumConvertedModel::read(
+    const TArray<uint8>& data,
+    const Model& model,
+    const Material& defaultMaterial,
+    LoadModelResult& result) {
+  CESIUM_TRACE("CesiumConvertedModel::read");
+
+  if (data.Num() < HeaderSize) {
+    return false;
+  }
+
+  FMemoryReader reader(data);
+  uint32 magic = 0;
+  uint32 version = 0;
+  uint64 hash = 0;
+  reader << magic;
+  reader << version;
+  reader << hash;
+  if (magic != Magic || version != Version ||
+      hash != CityHash64(
+                  reinterpret_cast<const char*>(data.GetData() + HeaderSize),
+                  uint32(data.Num() - HeaderSize))) {
+    return false;
+  }
+
+  result = LoadModelResult();
+  ModelContext context{model, defaultMaterial, {}};
+  if (!serializeModel(reader, context, result) ||
+      reader.Tell() != reader.TotalSize()) {
+    releaseRestoredModel(result, context.textures);
+    return false;
+  }
+
+  for (CesiumTextureUtility::LoadedTextureResult* pTexture :
+       context.textures) {
+    CesiumTextureUtility::createRHITextureAnyThreadPart(pTexture);
+  }
+
+  return true;
+}
+
+CesiumCollisionMesh
+CesiumConvertedModel::readCollisionMesh(const TArray<uint8>& cooked) {
+  if (cooked.Num() == 0) {
+    return nullptr;
+  }
+
+#if PHYSICS_INTERFACE_PHYSX
+  physx::PxDefaultMemoryInputData input(
+      const_cast<physx::PxU8*>(cooked.GetData()),
+      static_cast<physx::PxU32>(cooked.Num()));
+  return GPhysXSDK ? GPhysXSDK->createTriangleMesh(input) : nullptr;
+#elif ENGINE_MAJOR_VERSION >= 5
+  FMemoryReader reader(cooked);
+  Chaos::FChaosArchive chaosReader(reader);
+  CesiumCollisionMesh pCollisionMesh;
+  chaosReader << pCollisionMesh;
+  return reader.IsError() ? nullptr : pCollisionMesh;
+#else
+  return nullptr;
+#endif
+}
+
+#if !PHYSICS_INTERFACE_PHYSX
+bool CesiumConvertedModel::writeCollisionMesh(
+    const CesiumCollisionMesh& pCollisionMesh,
+    TArray<uint8>& cooked) {
+  cooked.Reset();
+#if ENGINE_MAJOR_VERSION >= 5
+  if (!pCollisionMesh) {
+    return false;
+  }
+  FMemoryWriter writer(cooked);
+  Chaos::FChaosArchive chaosWriter(writer);
+  CesiumCollisionMesh pMesh = pCollisionMesh;
+  chaosWriter << pMesh;
+  return !writer.IsError();
+#else
+  // The serialization of Chaos meshes differs in UE4, which uses PhysX by
+  // default anyway.
+  return false;
+#endif
+}
+#endif
@@ -0,0 +1,111 @@
+// Copyright 2020-2021 CesiumGS, Inc. and Contributors
+
+#pragma once
+
+#include "CesiumGltfPrimitiveComponent.h"
+#include "CesiumRasterOverlays.h"
+#include "CesiumTextureUtility.h"
+#include "CoreMinimal.h"
+#include "StaticMeshResources.h"
+#include <glm/mat4x4.hpp>
+#include <memory>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#if PHYSICS_INTERFACE_PHYSX
+#include "PhysXPublicCore.h"
+#else
+#include "Chaos/TriangleMeshImplicitObject.h"
+#endif
+
+#include "LoadModelResult.h"
+
+struct CreateModelOptions;
+
+namespace CesiumGltf {
+struct Material;
+struct Model;
+} // namespace CesiumGltf
+
+/**
+ * @brief Writes the result of the conversion of a glTF model to Unreal
+ * resources, so that it can be restored later without converting the model
+ * again: its vertex and index buffers, the platform data of its textures and
+ * its cooked collision meshes.
+ *
+ * A converted model starts with the magic "CCM1", a uint32 version and a
+ * uint64 hash of the rest of the data, which is the model in the layout of
+ * Unreal archives. The glTF model isn't written, so a converted model can
+ * only be restored along with the model it was converted from, which is
+ * identified by its key.
+ */
+namespace CesiumConvertedModel {
+
+/**
+ * @brief Computes the key of the converted form of a model: a hash of its
+ * buffers, images and the parts of its structure that the conversion reads,
+ * along with the transform and the options of the conversion and the format
+ * version. Models with the same key are converted to the same resources.
+ */
+uint64 computeKey(
+    const CesiumGltf::Model& model,
+    const glm::dmat4x4& transform,
+    const CreateModelOptions& options);
+
+/**
+ * @brief Writes a converted model.
+ *
+ * The textures of the model must still have the bulk data of their mips,
+ * which is the case when they were loaded with deferRHITexture, and its
+ * collision meshes must have their cooked form.
+ *
+ * @param result The converted model.
+ * @param model The glTF model it was converted from.
+ * @param data Receives the converted model.
+ * @return False if the model can't be written, for example because it has
+ * Nanite resources.
+ */
+bool write(
+    const LoadModelResult& result,
+    const CesiumGltf::Model& model,
+    TArray<uint8>& data);
+
+/**
+ * @brief Restores a converted model, with the RHI textures of its model
+ * textures created when the RHI supports it. The water mask and feature
+ * metadata textures of its primitives aren't written, so they have to be
+ * loaded again.
+ *
+ * @param data The converted model, as written by write.
+ * @param model The glTF model it was converted from.
+ * @param defaultMaterial The material of the primitives without one.
+ * @param result Receives the converted model.
+ * @return False if the data isn't a valid converted model of the model.
+ */
+bool read(
+    const TArray<uint8>& data,
+    const CesiumGltf::Model& model,
+    const CesiumGltf::Material& defaultMaterial,
+    LoadModelResult& result);
+
+/**
+ * @brief Creates a collision mesh from its cooked form, or returns nullptr if
+ * it isn't valid.
+ */
+CesiumCollisionMesh readCollisionMesh(const TArray<uint8>& cooked);
+
+#if !PHYSICS_INTERFACE_PHYSX
+/**
+ * @brief Writes the cooked form of a Chaos collision mesh. PhysX meshes are
+ * cooked into this form in the first place.
+ *
+ * @return False if the mesh can't be written in this version of the engine.
+ */
+bool writeCollisionMesh(
+    const CesiumCollisionMesh& pCollisionMesh,
+    TArray<uint8>& cooked);
+#endif
+
+} // namespace CesiumConvertedModel
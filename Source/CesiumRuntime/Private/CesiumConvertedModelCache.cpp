@@ -0,0 +1,175 @@
+// Copyright 2020-2021 CesiumGS, Inc. and Contributors
+
+#include "CesiumConvertedModelCache.h"
+#include "CesiumRuntime.h"
+#include "CesiumRuntimeSettings.h"
+#include "CesiumUtility/Tracing.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformFilemanager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+namespace {
+const TCHAR* EntryExtension = TEXT(".bin");
+constexpr int32 KeyLength = 16;
+
+FString getCacheDirectory() {
+  const FString& directory =
+      GetDefault<UCesiumRuntimeSettings>()->ConvertedModelCacheDirectory;
+  return directory.IsEmpty()
+             ? FPaths::Combine(
+                   FPaths::ProjectSavedDir(),
+                   TEXT("Cesium/ConvertedModels"))
+             : directory;
+}
+} // namespace
+
+/*static*/ CesiumConvertedModelCache* CesiumConvertedModelCache::get() {
+  static std::unique_ptr<CesiumConvertedModelCache> pCache = []() {
+    const int64 maximumBytes =
+        GetDefault<UCesiumRuntimeSettings>()->ConvertedModelCacheBytes;
+    return maximumBytes > 0 ? std::make_unique<CesiumConvertedModelCache>(
+                                  getCacheDirectory(),
+                                  maximumBytes)
+                            : nullptr;
+  }();
+  return pCache.get();
+}
+
+CesiumConvertedModelCache::CesiumConvertedModelCache(
+    const FString& directory,
+    int64 maximumBytes)
+    : _directory(directory), _maximumBytes(maximumBytes) {
+  CESIUM_TRACE("CesiumConvertedModelCache::CesiumConvertedModelCache");
+
+  IPlatformFile& platformFile = FPlatformFileManager::Get().GetPlatformFile();
+  if (!platformFile.DirectoryExists(*this->_directory)) {
+    platformFile.CreateDirectoryTree(*this->_directory);
+  }
+
+  struct FoundEntry {
+    Entry entry;
+    FDateTime modificationTime;
+  };
+  std::vector<FoundEntry> found;
+  platformFile.IterateDirectoryStat(
+      *this->_directory,
+      [&found](const TCHAR* path, const FFileStatData& stat) {
+        const FString name = FPaths::GetBaseFilename(path);
+        if (!stat.bIsDirectory && name.Len() == KeyLength &&
+            FPaths::GetExtension(path, true) == EntryExtension) {
+          found.push_back(FoundEntry{
+              Entry{FCString::Strtoui64(*name, nullptr, 16), stat.FileSize},
+              stat.ModificationTime});
+        }
+        return true;
+      });
+
+  std::sort(
+      found.begin(),
+      found.end(),
+      [](const FoundEntry& a, const FoundEntry& b) {
+        return a.modificationTime > b.modificationTime;
+      });
+  for (const FoundEntry& entry : found) {
+    this->_entries.push_back(entry.entry);
+    this->_entriesByKey[entry.entry.key] = std::prev(this->_entries.end());
+    this->_totalBytes += entry.entry.bytes;
+  }
+
+  TArray<FString> pathsToDelete;
+  this->prune(pathsToDelete);
+  for (const FString& path : pathsToDelete) {
+    platformFile.DeleteFile(*path);
+  }
+
+  UE_LOG(
+      LogCesium,
+      Display,
+      TEXT("Caching %d converted models (%lld bytes) in %s"),
+      int32(this->_entries.size()),
+      this->_totalBytes,
+      *this->_directory);
+}
+
+bool CesiumConvertedModelCache::find(uint64 key, TArray<uint8>& data) {
+  {
+    std::lock_guard<std::mutex> lock(this->_mutex);
+    auto it = this->_entriesByKey.find(key);
+    if (it == this->_entriesByKey.end()) {
+      return false;
+    }
+    this->_entries.splice(this->_entries.begin(), this->_entries, it->second);
+  }
+
+  CESIUM_TRACE("CesiumConvertedModelCache::find");
+  const FString path = this->getPath(key);
+  if (!FFileHelper::LoadFileToArray(data, *path, FILEREAD_Silent)) {
+    // The file was deleted behind the cache's back.
+    std::lock_guard<std::mutex> lock(this->_mutex);
+    auto it = this->_entriesByKey.find(key);
+    if (it != this->_entriesByKey.end()) {
+      this->_totalBytes -= it->second->bytes;
+      this->_entries.erase(it->second);
+      this->_entriesByKey.erase(it);
+    }
+    return false;
+  }
+
+  IFileManager::Get().SetTimeStamp(*path, FDateTime::UtcNow());
+  return true;
+}
+
+void CesiumConvertedModelCache::add(uint64 key, const TArray<uint8>& data) {
+  if (data.Num() > this->_maximumBytes) {
+    return;
+  }
+
+  CESIUM_TRACE("CesiumConvertedModelCache::add");
+  if (!FFileHelper::SaveArrayToFile(data, *this->getPath(key))) {
+    UE_LOG(
+        LogCesium,
+        Warning,
+        TEXT("Could not write a converted model to the cache in %s"),
+        *this->_directory);
+    return;
+  }
+
+  TArray<FString> pathsToDelete;
+  {
+    std::lock_guard<std::mutex> lock(this->_mutex);
+    auto it = this->_entriesByKey.find(key);
+    if (it != this->_entriesByKey.end()) {
+      this->_totalBytes -= it->second->bytes;
+      this->_entries.erase(it->second);
+    }
+    this->_entries.push_front(Entry{key, int64(data.Num())});
+    this->_entriesByKey[key] = this->_entries.begin();
+    this->_totalBytes += data.Num();
+    this->prune(pathsToDelete);
+  }
+
+  IFileManager& fileManager = IFileManager::Get();
+  for (const FString& path : pathsToDelete) {
+    fileManager.Delete(*path, false, false, true);
+  }
+}
+
+FString CesiumConvertedModelCache::getPath(uint64 key) const {
+  return FPaths::Combine(
+      this->_directory,
+      FString::Printf(TEXT("%016llx%s"), key, EntryExtension));
+}
+
+void CesiumConvertedModelCache::prune(TArray<FString>& pathsToDelete) {
+  while (this->_totalBytes > this->_maximumBytes && !this->_entries.empty()) {
+    const Entry& entry = this->_entries.back();
+    pathsToDelete.Add(this->getPath(entry.key));
+    this->_totalBytes -= entry.bytes;
+    this->_entriesByKey.erase(entry.key);
+    this->_entries.pop_back();
+  }
+}
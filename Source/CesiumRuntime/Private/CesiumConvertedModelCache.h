@@ -0,0 +1,80 @@
+// Copyright 2020-2021 CesiumGS, Inc. and Contributors
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
+/**
+ * @brief An on-disk cache of converted models, shared by all tilesets, in
+ * front of the conversion of glTF models to Unreal resources.
+ *
+ * The request cache only keeps the responses of tiles, so a tile that is
+ * found in it is still converted: its vertices are copied, its tangents and
+ * textures are computed, and its physics meshes are cooked. This cache keeps
+ * the result of the conversion, as written by CesiumConvertedModel::write,
+ * so that a tile whose model was converted before with the same options is
+ * restored instead.
+ *
+ * Each converted model is a file named after its key, as computed by
+ * CesiumConvertedModel::computeKey. When the files add up to more than the
+ * maximum size, the least recently used ones are deleted. Their modification
+ * times are updated when they are used, so that the order is kept from one
+ * session to the next.
+ *
+ * All of its functions may be called from any thread.
+ */
+class CesiumConvertedModelCache {
+public:
+  /**
+   * @brief Gets the cache configured in the Cesium runtime settings, or
+   * nullptr if it is disabled. It is opened when it is first used, which
+   * lists the files in its directory.
+   */
+  static CesiumConvertedModelCache* get();
+
+  /**
+   * @brief Opens the cache in the given directory, which is created if
+   * needed, and deletes its least recently used models beyond the maximum
+   * size.
+   */
+  CesiumConvertedModelCache(const FString& directory, int64 maximumBytes);
+
+  /**
+   * @brief Reads the converted model with the given key, or returns false if
+   * the cache doesn't have it.
+   */
+  bool find(uint64 key, TArray<uint8>& data);
+
+  /**
+   * @brief Writes a converted model to the cache, and deletes the least
+   * recently used models beyond the maximum size.
+   */
+  void add(uint64 key, const TArray<uint8>& data);
+
+private:
+  struct Entry {
+    uint64 key;
+    int64 bytes;
+  };
+
+  FString getPath(uint64 key) const;
+
+  /**
+   * Removes the least recently used entries beyond the maximum size, and
+   * adds the paths of their files to the given array. The mutex must be
+   * locked.
+   */
+  void prune(TArray<FString>& pathsToDelete);
+
+  FString _directory;
+  int64 _maximumBytes;
+
+  // The models in the cache, from the most to the least recently used.
+  std::mutex _mutex;
+  std::list<Entry> _entries;
+  std::unordered_map<uint64, std::list<Entry>::iterator> _entriesByKey;
+  int64 _totalBytes = 0;
+};
@@ -6,6 +6,7 @@
 #include "CesiumRuntime.h"
 #include "Engine/World.h"
 #include "EngineUtils.h"
+#include <algorithm>
 #include <string>
 #include <vector>
 
@@ -141,8 +142,8 @@ ACesiumCreditSystem::GetDefaultCreditSystem(const UObject* WorldContextObject) {
 }
 
 ACesiumCreditSystem::ACesiumCreditSystem()
-    : _pCreditSystem(std::make_shared<Cesium3DTilesSelection::CreditSystem>()),
-      _lastCreditsCount(0) {
+    : _pCreditSystem(
+          std::make_shared<Cesium3DTilesSelection::CreditSystem>()) {
   PrimaryActorTick.bCanEverTick = true;
 }
 
@@ -158,22 +159,46 @@ void ACesiumCreditSystem::Tick(float DeltaTime) {
   const std::vector<Cesium3DTilesSelection::Credit>& creditsToShowThisFrame =
       _pCreditSystem->getCreditsToShowThisFrame();
 
-  // if the credit list has changed, we want to reformat the credits
-  CreditsUpdated =
-      creditsToShowThisFrame.size() != _lastCreditsCount ||
-      _pCreditSystem->getCreditsToNoLongerShowThisFrame().size() > 0;
-  if (CreditsUpdated) {
-    std::string creditString =
-        "<head>\n<meta charset=\"utf-16\"/>\n</head>\n<body style=\"color:white\"><ul>";
-    for (size_t i = 0; i < creditsToShowThisFrame.size(); ++i) {
-      creditString +=
-          "<li>" + _pCreditSystem->getHtml(creditsToShowThisFrame[i]) + "</li>";
+  // The credits are compared as sets, so that credits shown in a different
+  // order don't count as a change. There are only ever a few of them.
+  CreditsUpdated = false;
+  for (int32 i = CreditList.Num() - 1; i >= 0; --i) {
+    if (std::find(
+            creditsToShowThisFrame.begin(),
+            creditsToShowThisFrame.end(),
+            _lastCredits[i]) == creditsToShowThisFrame.end()) {
+      const FString html = MoveTemp(CreditList[i]);
+      CreditList.RemoveAt(i);
+      _lastCredits.erase(_lastCredits.begin() + i);
+      CreditsUpdated = true;
+      OnCreditRemoved.Broadcast(html);
     }
-    creditString += "</ul></body>";
-    Credits = UTF8_TO_TCHAR(creditString.c_str());
+  }
+
+  for (const Cesium3DTilesSelection::Credit& credit : creditsToShowThisFrame) {
+    if (std::find(_lastCredits.begin(), _lastCredits.end(), credit) ==
+        _lastCredits.end()) {
+      _lastCredits.push_back(credit);
+      CreditList.Add(UTF8_TO_TCHAR(_pCreditSystem->getHtml(credit).c_str()));
+      CreditsUpdated = true;
+      OnCreditAdded.Broadcast(CreditList.Last());
+    }
+  }
 
-    _lastCreditsCount = creditsToShowThisFrame.size();
+  if (CreditsUpdated && GenerateCreditsHtml) {
+    updateCreditsHtml();
   }
 
   _pCreditSystem->startNextFrame();
 }
+
+void ACesiumCreditSystem::updateCreditsHtml() {
+  Credits = TEXT("<head>\n<meta charset=\"utf-16\"/>\n</head>\n")
+            TEXT("<body style=\"color:white\"><ul>");
+  for (const FString& html : CreditList) {
+    Credits += TEXT("<li>");
+    Credits += html;
+    Credits += TEXT("</li>");
+  }
+  Credits += TEXT("</ul></body>");
+}
@@ -0,0 +1,168 @@
+// Copyright 2020-2021 CesiumGS, Inc. and Contributors
+
+#include "CesiumDistanceField.h"
+#include "CesiumTriangleBVH.h"
+#include "CesiumUtility/Tracing.h"
+#include "DistanceFieldAtlas.h"
+#include "Engine/StaticMesh.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/Compression.h"
+#include "StaticMeshResources.h"
+
+namespace {
+
+// How far the volume extends past the triangles, as a fraction of their
+// extent, like the volumes that the engine builds.
+constexpr float BoundsExpansion = 0.2f;
+
+// The fewest voxels along each side of the volume, so that flat tiles still
+// have distances above and below them.
+constexpr int32 MinimumVoxels = 4;
+
+// The most voxels along each side of the volume.
+constexpr int32 MaximumVoxels = 64;
+
+int32 getConsoleVariable(const TCHAR* name) {
+  const TConsoleVariableData<int32>* pVariable =
+      IConsoleManager::Get().FindTConsoleVariableDataInt(name);
+  return pVariable ? pVariable->GetValueOnAnyThread() : 0;
+}
+
+} // namespace
+
+/*static*/ bool CesiumDistanceField::isEnabled() {
+  return IsSupported &&
+         getConsoleVariable(TEXT("r.GenerateMeshDistanceFields")) != 0;
+}
+
+/*static*/ FDistanceFieldVolumeData*
+CesiumDistanceField::build(const CesiumTriangleBVH& bvh, int32 resolution) {
+#if ENGINE_MAJOR_VERSION == 4
+  CESIUM_TRACE("CesiumDistanceField::build");
+
+  const FBox meshBounds = bvh.getBounds();
+  if (!meshBounds.IsValid) {
+    return nullptr;
+  }
+
+  resolution = FMath::Clamp(resolution, MinimumVoxels, MaximumVoxels);
+  const FVector expansion =
+      FVector(meshBounds.GetExtent().GetMax() * BoundsExpansion);
+  const FVector meshSize = meshBounds.GetSize() + 2.0f * expansion;
+  const float voxelSize =
+      FMath::Max(meshSize.GetMax() / float(resolution), KINDA_SMALL_NUMBER);
+
+  FIntVector size;
+  FVector volumeSize;
+  for (int32 axis = 0; axis < 3; ++axis) {
+    size[axis] = FMath::Clamp(
+        FMath::CeilToInt(meshSize[axis] / voxelSize),
+        MinimumVoxels,
+        MaximumVoxels);
+    volumeSize[axis] = size[axis] * voxelSize;
+  }
+  const FBox volumeBounds = FBox::BuildAABB(
+      meshBounds.GetCenter(),
+      0.5f * volumeSize);
+
+  // The engine stores the distances in the space of the volume, where its
+  // largest extent is 1.
+  const float localToVolumeScale = 1.0f / volumeBounds.GetExtent().GetMax();
+  const float maximumDistance = volumeSize.Size();
+
+  TArray<float> distances;
+  distances.SetNumUninitialized(size.X * size.Y * size.Z);
+  float minimum = TNumericLimits<float>::Max();
+  float maximum = TNumericLimits<float>::Lowest();
+  for (int32 z = 0; z < size.Z; ++z) {
+    for (int32 y = 0; y < size.Y; ++y) {
+      for (int32 x = 0; x < size.X; ++x) {
+        const FVector center =
+            volumeBounds.Min + (FVector(x, y, z) + 0.5f) * voxelSize;
+        float distance = maximumDistance;
+        bvh.closestDistance(center, maximumDistance, distance);
+
+        // Two-sided triangles are a shell that is half a voxel thick, so
+        // that the surface is found between the voxels on either side.
+        const float volumeDistance =
+            (distance - 0.5f * voxelSize) * localToVolumeScale;
+        distances[(z * size.Y + y) * size.X + x] = volumeDistance;
+        minimum = FMath::Min(minimum, volumeDistance);
+        maximum = FMath::Max(maximum, volumeDistance);
+      }
+    }
+  }
+
+  // The format follows the project settings that the distance field atlas
+  // reads the data with.
+  TArray<uint8> texels;
+  if (getConsoleVariable(TEXT("r.DistanceFieldBuild.EightBit")) != 0) {
+    const float range = FMath::Max(maximum - minimum, KINDA_SMALL_NUMBER);
+    texels.SetNumUninitialized(distances.Num());
+    for (int32 i = 0; i < distances.Num(); ++i) {
+      texels[i] = uint8(FMath::Clamp(
+          FMath::FloorToInt((distances[i] - minimum) / range * 255.0f + 0.5f),
+          0,
+          255));
+    }
+  } else {
+    texels.SetNumUninitialized(distances.Num() * sizeof(FFloat16));
+    FFloat16* pTexels = reinterpret_cast<FFloat16*>(texels.GetData());
+    for (int32 i = 0; i < distances.Num(); ++i) {
+      pTexels[i] = FFloat16(distances[i]);
+    }
+  }
+
+  FDistanceFieldVolumeData* pData = new FDistanceFieldVolumeData();
+  if (getConsoleVariable(TEXT("r.DistanceFieldBuild.Compress")) != 0) {
+    int32 compressedSize =
+        FCompression::CompressMemoryBound(NAME_Zlib, texels.Num());
+    pData->CompressedDistanceFieldVolume.SetNumUninitialized(compressedSize);
+    if (!FCompression::CompressMemory(
+            NAME_Zlib,
+            pData->CompressedDistanceFieldVolume.GetData(),
+            compressedSize,
+            texels.GetData(),
+            texels.Num())) {
+      delete pData;
+      return nullptr;
+    }
+    pData->CompressedDistanceFieldVolume.SetNum(compressedSize);
+  } else {
+    pData->CompressedDistanceFieldVolume = MoveTemp(texels);
+  }
+
+  pData->Size = size;
+  pData->LocalBoundingBox = volumeBounds;
+  pData->DistanceMinMax = FVector2D(minimum, maximum);
+  pData->bMeshWasClosed = false;
+  pData->bBuiltAsIfTwoSided = true;
+  pData->bMeshWasPlane = false;
+  return pData;
+#else
+  return nullptr;
+#endif
+}
+
+/*static*/ void CesiumDistanceField::attach(
+    UStaticMesh* pStaticMesh,
+    FDistanceFieldVolumeData* pData) {
+#if ENGINE_MAJOR_VERSION == 4
+#if ENGINE_MINOR_VERSION < 27
+  FStaticMeshRenderData* pRenderData = pStaticMesh->RenderData.Get();
+#else
+  FStaticMeshRenderData* pRenderData = pStaticMesh->GetRenderData();
+#endif
+  if (!pRenderData || pRenderData->LODResources.Num() == 0 ||
+      pRenderData->LODResources[0].DistanceFieldData) {
+    delete pData;
+    return;
+  }
+
+  FStaticMeshLODResources& lod = pRenderData->LODResources[0];
+  lod.DistanceFieldData = pData;
+  pData->VolumeTexture.Initialize(pStaticMesh);
+#else
+  delete pData;
+#endif
+}
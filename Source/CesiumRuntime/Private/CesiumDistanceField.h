@@ -0,0 +1,62 @@
+// Copyright 2020-2021 CesiumGS, Inc. and Contributors
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Runtime/Launch/Resources/Version.h"
+
+class CesiumTriangleBVH;
+class FDistanceFieldVolumeData;
+class UStaticMesh;
+
+/**
+ * @brief Functions that build low-resolution mesh distance fields for the
+ * primitives of tiles at runtime, so that they are seen by distance field
+ * shadows and ambient occlusion.
+ *
+ * The engine only builds mesh distance fields for static mesh assets in the
+ * editor, so the meshes of tiles have none. These distance fields are built in
+ * the layout of Unreal Engine 4, from the triangles of the geometry query
+ * hierarchy of a primitive, and treat the triangles as two-sided, since tiles
+ * are usually open surfaces.
+ */
+class CesiumDistanceField {
+public:
+  /**
+   * Whether distance fields can be built in this version of the engine. The
+   * sparse, streamed distance fields of Unreal Engine 5 can only be built by
+   * the mesh utilities of the editor.
+   */
+  static constexpr bool IsSupported = ENGINE_MAJOR_VERSION == 4;
+
+  /**
+   * @brief Checks whether the project renders mesh distance fields, with
+   * "Generate Mesh Distance Fields" in its rendering settings.
+   */
+  static bool isEnabled();
+
+  /**
+   * @brief Builds the distance field of the given triangles. May be called
+   * from any thread.
+   *
+   * @param bvh The triangles, in the coordinates of the primitive.
+   * @param resolution The number of voxels along the longest side of the
+   * volume. The volume is at least a few voxels thick along the other sides.
+   * @return The distance field, or nullptr if there are no triangles or if
+   * distance fields are not supported.
+   */
+  static FDistanceFieldVolumeData*
+  build(const CesiumTriangleBVH& bvh, int32 resolution);
+
+  /**
+   * @brief Gives a distance field to the first level of detail of a static
+   * mesh whose resources are initialized, and registers it for rendering.
+   * Must be called from the game thread. The components of the mesh need
+   * their render state to be recreated to use it.
+   *
+   * @param pStaticMesh The static mesh, which takes ownership of the data. If
+   * it already has a distance field, the data is deleted instead.
+   * @param pData The distance field, from build.
+   */
+  static void attach(UStaticMesh* pStaticMesh, FDistanceFieldVolumeData* pData);
+};
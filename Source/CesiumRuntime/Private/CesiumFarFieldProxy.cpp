@@ -0,0 +1,224 @@
+// Copyright 2020-2021 CesiumGS, Inc. and Contributors
+
+#include "CesiumFarFieldProxy.h"
+#include "Async/Async.h"
+#include "CesiumUtility/Tracing.h"
+#include "Misc/ScopeLock.h"
+#include "StaticMeshResources.h"
+#include <glm/matrix.hpp>
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+#include <limits>
+
+namespace {
+
+#if ENGINE_MAJOR_VERSION == 5
+using TMeshVector2 = FVector2f;
+using TMeshVector3 = FVector3f;
+#else
+using TMeshVector2 = FVector2D;
+using TMeshVector3 = FVector;
+#endif
+
+} // namespace
+
+CesiumFarFieldProxy::CesiumFarFieldProxy()
+    : _pState(std::make_shared<SharedState>()) {}
+
+CesiumFarFieldProxy::~CesiumFarFieldProxy() { this->reset(); }
+
+void CesiumFarFieldProxy::build(
+    std::vector<const Cesium3DTilesSelection::Tile*>&& tiles,
+    std::vector<Part>&& parts) {
+  int32 build;
+  {
+    FScopeLock lock(&this->_pState->lock);
+    build = ++this->_pState->latestBuild;
+    this->_pState->building = true;
+  }
+
+  Async(
+      EAsyncExecution::ThreadPool,
+      [pState = this->_pState,
+       build,
+       tiles = std::move(tiles),
+       parts = std::move(parts)]() mutable {
+        FStaticMeshRenderData* pRenderData = createRenderData(parts);
+
+        FScopeLock lock(&pState->lock);
+        if (build != pState->latestBuild) {
+          delete pRenderData;
+          return;
+        }
+
+        if (pState->hasResult) {
+          delete pState->result.pRenderData;
+        }
+        pState->result.tiles = std::move(tiles);
+        pState->result.pRenderData = pRenderData;
+        pState->hasResult = true;
+        pState->building = false;
+      });
+}
+
+bool CesiumFarFieldProxy::isBuilding() const {
+  FScopeLock lock(&this->_pState->lock);
+  return this->_pState->building;
+}
+
+bool CesiumFarFieldProxy::takeResult(Result& result) {
+  FScopeLock lock(&this->_pState->lock);
+  if (!this->_pState->hasResult) {
+    return false;
+  }
+
+  result = std::move(this->_pState->result);
+  this->_pState->result = Result();
+  this->_pState->hasResult = false;
+  return true;
+}
+
+void CesiumFarFieldProxy::reset() {
+  FScopeLock lock(&this->_pState->lock);
+  ++this->_pState->latestBuild;
+  this->_pState->building = false;
+  if (this->_pState->hasResult) {
+    delete this->_pState->result.pRenderData;
+    this->_pState->result = Result();
+    this->_pState->hasResult = false;
+  }
+}
+
+/*static*/ FStaticMeshRenderData*
+CesiumFarFieldProxy::createRenderData(const std::vector<Part>& parts) {
+  CESIUM_TRACE("CesiumFarFieldProxy::createRenderData");
+
+  int32 numVertices = 0;
+  int32 numIndices = 0;
+  for (const Part& part : parts) {
+    numVertices += part.pGeometry->positions.Num();
+    numIndices += part.pGeometry->indices.Num();
+  }
+  if (numVertices == 0 || numIndices == 0) {
+    return nullptr;
+  }
+
+  TArray<TMeshVector3> positions;
+  TArray<FColor> colors;
+  TArray<uint32> indices;
+  positions.Reserve(numVertices);
+  colors.Reserve(numVertices);
+  indices.Reserve(numIndices);
+
+  for (const Part& part : parts) {
+    const CesiumFarFieldGeometry& geometry = *part.pGeometry;
+    const uint32 firstVertex = static_cast<uint32>(positions.Num());
+    for (const auto& position : geometry.positions) {
+      const glm::dvec4 transformed =
+          part.transform * glm::dvec4(position.X, position.Y, position.Z, 1.0);
+      positions.Add(TMeshVector3(
+          static_cast<float>(transformed.x),
+          static_cast<float>(transformed.y),
+          static_cast<float>(transformed.z)));
+    }
+    colors.Append(geometry.colors);
+    colors.SetNum(positions.Num());
+
+    // The winding order of the primitive assumes that its component mirrors
+    // it from the glTF coordinates, which is now baked into the positions.
+    const bool mirrored = glm::determinant(part.transform) < 0.0;
+    for (int32 i = 2; i < geometry.indices.Num(); i += 3) {
+      if (mirrored) {
+        indices.Add(firstVertex + geometry.indices[i]);
+        indices.Add(firstVertex + geometry.indices[i - 1]);
+        indices.Add(firstVertex + geometry.indices[i - 2]);
+      } else {
+        indices.Add(firstVertex + geometry.indices[i - 2]);
+        indices.Add(firstVertex + geometry.indices[i - 1]);
+        indices.Add(firstVertex + geometry.indices[i]);
+      }
+    }
+  }
+
+  // Smooth normals are good enough for the lighting of distant geometry, and
+  // the simplified triangles have no normals of their own.
+  TArray<TMeshVector3> normals;
+  normals.SetNumZeroed(numVertices);
+  for (int32 i = 2; i < indices.Num(); i += 3) {
+    const TMeshVector3& p0 = positions[indices[i - 2]];
+    const TMeshVector3& p1 = positions[indices[i - 1]];
+    const TMeshVector3& p2 = positions[indices[i]];
+    const TMeshVector3 faceNormal =
+        TMeshVector3::CrossProduct(p2 - p0, p1 - p0);
+    normals[indices[i - 2]] += faceNormal;
+    normals[indices[i - 1]] += faceNormal;
+    normals[indices[i]] += faceNormal;
+  }
+
+  FStaticMeshRenderData* RenderData = new FStaticMeshRenderData();
+  RenderData->AllocateLODResources(1);
+  FStaticMeshLODResources& LODResources = RenderData->LODResources[0];
+  FStaticMeshVertexBuffers& vertexBuffers = LODResources.VertexBuffers;
+  LODResources.bHasColorVertexData = true;
+
+  vertexBuffers.PositionVertexBuffer.Init(numVertices, false);
+  vertexBuffers.StaticMeshVertexBuffer.Init(numVertices, 1, false);
+  vertexBuffers.ColorVertexBuffer.InitFromColorArray(
+      colors.GetData(),
+      colors.Num(),
+      sizeof(FColor),
+      false);
+
+  const TMeshVector3 zero(0.0f, 0.0f, 0.0f);
+  const TMeshVector3 up(0.0f, 0.0f, 1.0f);
+  FBox bounds(ForceInit);
+  for (int32 i = 0; i < numVertices; ++i) {
+    vertexBuffers.PositionVertexBuffer.VertexPosition(i) = positions[i];
+    vertexBuffers.StaticMeshVertexBuffer.SetVertexTangents(
+        i,
+        zero,
+        zero,
+        normals[i].IsNearlyZero() ? up : normals[i].GetSafeNormal());
+    vertexBuffers.StaticMeshVertexBuffer.SetVertexUV(
+        i,
+        0,
+        TMeshVector2(0.0f, 0.0f));
+    bounds += FVector(positions[i]);
+  }
+
+  bounds.GetCenterAndExtents(
+      RenderData->Bounds.Origin,
+      RenderData->Bounds.BoxExtent);
+  RenderData->Bounds.SphereRadius = RenderData->Bounds.BoxExtent.Size();
+
+#if ENGINE_MAJOR_VERSION == 5
+  FStaticMeshSectionArray& Sections = LODResources.Sections;
+#else
+  FStaticMeshLODResources::FStaticMeshSectionArray& Sections =
+      LODResources.Sections;
+#endif
+
+  FStaticMeshSection& section = Sections.AddDefaulted_GetRef();
+  section.NumTriangles = indices.Num() / 3;
+  section.FirstIndex = 0;
+  section.MinVertexIndex = 0;
+  section.MaxVertexIndex = numVertices - 1;
+  section.bEnableCollision = false;
+  section.bCastShadow = false;
+  section.MaterialIndex = 0;
+
+  LODResources.IndexBuffer.SetIndices(
+      indices,
+      numVertices >= std::numeric_limits<uint16>::max()
+          ? EIndexBufferStride::Type::Force32Bit
+          : EIndexBufferStride::Type::Force16Bit);
+
+  LODResources.bHasDepthOnlyIndices = false;
+  LODResources.bHasReversedIndices = false;
+  LODResources.bHasReversedDepthOnlyIndices = false;
+#if ENGINE_MAJOR_VERSION < 5
+  LODResources.bHasAdjacencyInfo = false;
+#endif
+
+  return RenderData;
+}
@@ -0,0 +1,123 @@
+// Copyright 2020-2021 CesiumGS, Inc. and Contributors
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/CriticalSection.h"
+#include "Runtime/Launch/Resources/Version.h"
+#include <glm/mat4x4.hpp>
+#include <memory>
+#include <vector>
+
+class FStaticMeshRenderData;
+
+namespace Cesium3DTilesSelection {
+class Tile;
+}
+
+/**
+ * @brief The simplified geometry of a primitive, from which the far-field
+ * proxy of a tileset is built while the primitive is far away.
+ *
+ * The positions are in the coordinates of the primitive, like its vertex
+ * buffer, and the indices already have the winding order of Unreal. The color
+ * of each vertex approximates the base color of the primitive around it.
+ */
+struct CesiumFarFieldGeometry {
+#if ENGINE_MAJOR_VERSION == 5
+  TArray<FVector3f> positions;
+#else
+  TArray<FVector> positions;
+#endif
+  TArray<FColor> colors;
+  TArray<uint32> indices;
+};
+
+/**
+ * @brief Builds the far-field proxy of a tileset: a single mesh that merges
+ * the simplified geometry of its distant tiles, so that they are drawn with a
+ * few draw calls instead of one per primitive.
+ *
+ * The mesh is built on a worker thread, and picked up by the game thread with
+ * takeResult once it is done. Only the latest build is kept.
+ */
+class CesiumFarFieldProxy {
+public:
+  /**
+   * @brief A primitive to merge into the proxy.
+   */
+  struct Part {
+    std::shared_ptr<const CesiumFarFieldGeometry> pGeometry;
+
+    /**
+     * @brief The transformation from the coordinates of the primitive to
+     * those of the tileset's root component.
+     */
+    glm::dmat4 transform;
+  };
+
+  /**
+   * @brief The result of a finished build.
+   */
+  struct Result {
+    /**
+     * @brief The tiles drawn by the proxy, sorted by address. They are only
+     * compared, never dereferenced, because they may have been unloaded
+     * since.
+     */
+    std::vector<const Cesium3DTilesSelection::Tile*> tiles;
+
+    /**
+     * @brief The render data of the proxy, owned by the receiver, or nullptr
+     * if the parts had no triangles.
+     */
+    FStaticMeshRenderData* pRenderData = nullptr;
+  };
+
+  CesiumFarFieldProxy();
+  ~CesiumFarFieldProxy();
+
+  /**
+   * @brief Starts building a proxy for the given tiles from the given parts.
+   * A build that is still in progress is discarded when it finishes.
+   *
+   * @param tiles The tiles drawn by the parts, sorted by address.
+   * @param parts The primitives of the tiles.
+   */
+  void build(
+      std::vector<const Cesium3DTilesSelection::Tile*>&& tiles,
+      std::vector<Part>&& parts);
+
+  /**
+   * @brief Gets whether a build is in progress.
+   */
+  bool isBuilding() const;
+
+  /**
+   * @brief Takes the result of the latest build, if it finished since the last
+   * call.
+   *
+   * @param result Receives the result.
+   * @return Whether there was a result to take.
+   */
+  bool takeResult(Result& result);
+
+  /**
+   * @brief Discards the builds in progress and any result not yet taken.
+   */
+  void reset();
+
+private:
+  struct SharedState {
+    FCriticalSection lock;
+    int32 latestBuild = 0;
+    bool building = false;
+    bool hasResult = false;
+    Result result;
+  };
+
+  static FStaticMeshRenderData*
+  createRenderData(const std::vector<Part>& parts);
+
+  std::shared_ptr<SharedState> _pState;
+};
@@ -0,0 +1,151 @@
+// Copyright 2020-2021 CesiumGS, Inc. and Contributors
+
+#include "CesiumFeatureIndex.h"
+#include "CesiumGeoreference.h"
+#include "CesiumGeospatial/GlobeRectangle.h"
+#include "CesiumGltfComponent.h"
+#include "CesiumGltfPrimitiveComponent.h"
+#include "CesiumPolygonTileExcluder.h"
+#include "CesiumUtility/Math.h"
+#include "VecMath.h"
+#include <algorithm>
+
+using namespace CesiumGeospatial;
+using namespace CesiumUtility;
+
+namespace {
+
+// Only used to estimate the longitude and latitude covered by a box.
+constexpr double EarthRadius = 6378137.0;
+
+/**
+ * Estimates the globe rectangle covered by the given box, in Unreal world
+ * coordinates, from its bounding sphere.
+ */
+GlobeRectangle estimateGlobeRectangle(
+    const FBox& box,
+    const ACesiumGeoreference& georeference) {
+  const glm::dvec3 center =
+      georeference.TransformUnrealToLongitudeLatitudeHeight(
+          VecMath::createVector3D(box.GetCenter()));
+  const double longitude = Math::degreesToRadians(center.x);
+  const double latitude = Math::degreesToRadians(center.y);
+
+  // Unreal units are centimeters.
+  const double angle = box.GetExtent().Size() / 100.0 / EarthRadius;
+  const double south = std::max(latitude - angle, -Math::PI_OVER_TWO);
+  const double north = std::min(latitude + angle, Math::PI_OVER_TWO);
+  const double cosine =
+      std::min(std::cos(south), std::cos(north)) + Math::EPSILON7;
+  const double longitudeAngle = angle / cosine;
+  if (longitudeAngle >= Math::ONE_PI) {
+    return GlobeRectangle(-Math::ONE_PI, south, Math::ONE_PI, north);
+  }
+
+  return GlobeRectangle(
+      Math::convertLongitudeRange(longitude - longitudeAngle),
+      south,
+      Math::convertLongitudeRange(longitude + longitudeAngle),
+      north);
+}
+
+} // namespace
+
+void CesiumFeatureIndex::add(UCesiumGltfComponent* pTile) {
+  this->_tiles.Add(pTile);
+}
+
+void CesiumFeatureIndex::remove(UCesiumGltfComponent* pTile) {
+  this->_tiles.Remove(pTile);
+}
+
+template <typename TMatchesPrimitive, typename TMatchesFeature>
+void CesiumFeatureIndex::find(
+    TMatchesPrimitive&& matchesPrimitive,
+    TMatchesFeature&& matchesFeature,
+    TArray<FCesiumFeatureHandle>& result) const {
+  for (UCesiumGltfComponent* pTile : this->_tiles) {
+    for (USceneComponent* pChild : pTile->GetAttachChildren()) {
+      UCesiumGltfPrimitiveComponent* pPrimitive =
+          Cast<UCesiumGltfPrimitiveComponent>(pChild);
+      if (!pPrimitive || pPrimitive->FeatureBounds.Num() == 0 ||
+          !pPrimitive->IsVisible() ||
+          !matchesPrimitive(pPrimitive->Bounds.GetBox())) {
+        continue;
+      }
+
+      const FTransform& transform = pPrimitive->GetComponentTransform();
+      for (const CesiumPrimitiveFeatureBounds& feature :
+           pPrimitive->FeatureBounds) {
+        const FBox bounds = feature.bounds.TransformBy(transform);
+        if (matchesFeature(bounds)) {
+          FCesiumFeatureHandle& handle = result.AddDefaulted_GetRef();
+          handle.Primitive = pPrimitive;
+          handle.FeatureID = feature.featureID;
+          handle.Bounds = bounds;
+        }
+      }
+    }
+  }
+}
+
+void CesiumFeatureIndex::findInSphere(
+    const FVector& center,
+    float radius,
+    TArray<FCesiumFeatureHandle>& result) const {
+  const float radiusSquared = radius * radius;
+  auto touchesSphere = [&center, radiusSquared](const FBox& box) {
+    return FMath::SphereAABBIntersection(center, radiusSquared, box);
+  };
+  this->find(touchesSphere, touchesSphere, result);
+}
+
+void CesiumFeatureIndex::findInBox(
+    const FBox& box,
+    TArray<FCesiumFeatureHandle>& result) const {
+  auto touchesBox = [&box](const FBox& other) { return box.Intersect(other); };
+  this->find(touchesBox, touchesBox, result);
+}
+
+void CesiumFeatureIndex::findInPolygons(
+    const CesiumPolygonTileExcluder& polygons,
+    const ACesiumGeoreference& georeference,
+    TArray<FCesiumFeatureHandle>& result) const {
+  this->find(
+      [&polygons, &georeference](const FBox& box) {
+        return polygons.classify(estimateGlobeRectangle(box, georeference)) !=
+               CesiumPolygonTileExcluder::Classification::Outside;
+      },
+      [&polygons, &georeference](const FBox& box) {
+        const glm::dvec3 center =
+            georeference.TransformUnrealToLongitudeLatitudeHeight(
+                VecMath::createVector3D(box.GetCenter()));
+        const double longitude = Math::degreesToRadians(center.x);
+        const double latitude = Math::degreesToRadians(center.y);
+        return polygons.classify(
+                   GlobeRectangle(longitude, latitude, longitude, latitude)) ==
+               CesiumPolygonTileExcluder::Classification::Inside;
+      },
+      result);
+}
+
+void CesiumFeatureIndex::findAlongRay(
+    const FVector& start,
+    const FVector& end,
+    TArray<FCesiumFeatureHandle>& result) const {
+  const FVector direction = end - start;
+  auto touchesRay = [&start, &end, &direction](const FBox& box) {
+    return box.IsInside(start) ||
+           FMath::LineBoxIntersection(box, start, end, direction);
+  };
+  const int32 firstResult = result.Num();
+  this->find(touchesRay, touchesRay, result);
+
+  std::sort(
+      result.GetData() + firstResult,
+      result.GetData() + result.Num(),
+      [&start](const FCesiumFeatureHandle& a, const FCesiumFeatureHandle& b) {
+        return a.Bounds.ComputeSquaredDistanceToPoint(start) <
+               b.Bounds.ComputeSquaredDistanceToPoint(start);
+      });
+}
@@ -0,0 +1,75 @@
+// Copyright 2020-2021 CesiumGS, Inc. and Contributors
+
+#pragma once
+
+#include "CesiumFeatureHandle.h"
+#include "Containers/Set.h"
+#include "CoreMinimal.h"
+
+class ACesiumGeoreference;
+class CesiumPolygonTileExcluder;
+class UCesiumGltfComponent;
+class UCesiumGltfPrimitiveComponent;
+
+/**
+ * @brief An index of the features of the loaded tiles of a tileset by their
+ * bounds, for finding the features in a region without reading their
+ * geometry or metadata.
+ *
+ * Tiles are added when they are loaded and removed when they are freed. The
+ * bounds of each feature are computed in the coordinates of its primitive
+ * while the tile is loaded, so the index stays valid when the georeference
+ * changes. A query only transforms the bounds of the features of the
+ * primitives whose own bounds match it. Only the features of primitives that
+ * are visible are found, so that a feature isn't found again in the hidden
+ * ancestors of a rendered tile.
+ */
+class CesiumFeatureIndex {
+public:
+  void add(UCesiumGltfComponent* pTile);
+  void remove(UCesiumGltfComponent* pTile);
+
+  /**
+   * @brief Finds the features whose bounds touch the given sphere.
+   */
+  void findInSphere(
+      const FVector& center,
+      float radius,
+      TArray<FCesiumFeatureHandle>& result) const;
+
+  /**
+   * @brief Finds the features whose bounds touch the given box.
+   */
+  void findInBox(const FBox& box, TArray<FCesiumFeatureHandle>& result) const;
+
+  /**
+   * @brief Finds the features whose bounds are centered inside any of the
+   * given polygons.
+   *
+   * @param polygons The polygons.
+   * @param georeference The georeference, to find the longitude and latitude
+   * of the features.
+   */
+  void findInPolygons(
+      const CesiumPolygonTileExcluder& polygons,
+      const ACesiumGeoreference& georeference,
+      TArray<FCesiumFeatureHandle>& result) const;
+
+  /**
+   * @brief Finds the features whose bounds touch the segment from start to
+   * end, nearest to the start first.
+   */
+  void findAlongRay(
+      const FVector& start,
+      const FVector& end,
+      TArray<FCesiumFeatureHandle>& result) const;
+
+private:
+  template <typename TMatchesPrimitive, typename TMatchesFeature>
+  void find(
+      TMatchesPrimitive&& matchesPrimitive,
+      TMatchesFeature&& matchesFeature,
+      TArray<FCesiumFeatureHandle>& result) const;
+
+  TSet<UCesiumGltfComponent*> _tiles;
+};
@@ -0,0 +1,183 @@
+// Copyright 2020-2021 CesiumGS, Inc. and Contributors
+
+#include "CesiumFileAssetAccessor.h"
+#include "CesiumAsync/IAssetRequest.h"
+#include "CesiumAsync/IAssetResponse.h"
+#include "CesiumUtility/Tracing.h"
+#include "GenericPlatform/GenericPlatformFile.h"
+#include "HAL/PlatformFileManager.h"
+#include "Templates/UniquePtr.h"
+#include <algorithm>
+#include <cctype>
+
+namespace {
+const std::string FileScheme = "file://";
+
+bool isFileUrl(const std::string& url) {
+  return url.size() > FileScheme.size() &&
+         std::equal(
+             FileScheme.begin(),
+             FileScheme.end(),
+             url.begin(),
+             [](char a, char b) { return a == std::tolower(b); });
+}
+
+int32 hexValue(char c) {
+  if (c >= '0' && c <= '9') {
+    return c - '0';
+  }
+  if (c >= 'a' && c <= 'f') {
+    return c - 'a' + 10;
+  }
+  if (c >= 'A' && c <= 'F') {
+    return c - 'A' + 10;
+  }
+  return -1;
+}
+
+/**
+ * Converts a file:// URL to a local path, decoding its percent-encoded
+ * characters and dropping its query string and fragment.
+ */
+FString getFilePath(const std::string& url) {
+  std::string path;
+  path.reserve(url.size() - FileScheme.size());
+
+  for (size_t i = FileScheme.size(); i < url.size(); ++i) {
+    const char c = url[i];
+    if (c == '?' || c == '#') {
+      break;
+    }
+
+    if (c == '%' && i + 2 < url.size()) {
+      const int32 high = hexValue(url[i + 1]);
+      const int32 low = hexValue(url[i + 2]);
+      if (high >= 0 && low >= 0) {
+        path += char(high * 16 + low);
+        i += 2;
+        continue;
+      }
+    }
+
+    path += c;
+  }
+
+  // file:///C:/path has a slash before the drive letter, which isn't part of
+  // the path.
+  if (path.size() >= 3 && path[0] == '/' && std::isalpha(path[1]) &&
+      path[2] == ':') {
+    path.erase(0, 1);
+  }
+
+  return UTF8_TO_TCHAR(path.c_str());
+}
+
+class FileAssetResponse : public CesiumAsync::IAssetResponse {
+public:
+  FileAssetResponse(uint16_t statusCode, std::vector<std::byte>&& data)
+      : _statusCode(statusCode), _data(std::move(data)) {}
+
+  virtual uint16_t statusCode() const override { return this->_statusCode; }
+
+  virtual std::string contentType() const override { return std::string(); }
+
+  virtual const CesiumAsync::HttpHeaders& headers() const override {
+    return this->_headers;
+  }
+
+  virtual gsl::span<const std::byte> data() const override {
+    return gsl::span<const std::byte>(this->_data);
+  }
+
+private:
+  uint16_t _statusCode;
+  std::vector<std::byte> _data;
+  CesiumAsync::HttpHeaders _headers;
+};
+
+class FileAssetRequest : public CesiumAsync::IAssetRequest {
+public:
+  FileAssetRequest(
+      const std::string& url,
+      uint16_t statusCode,
+      std::vector<std::byte>&& data)
+      : _url(url), _method("GET"), _response(statusCode, std::move(data)) {}
+
+  virtual const std::string& method() const override { return this->_method; }
+
+  virtual const std::string& url() const override { return this->_url; }
+
+  virtual const CesiumAsync::HttpHeaders& headers() const override {
+    return this->_headers;
+  }
+
+  virtual const CesiumAsync::IAssetResponse* response() const override {
+    return &this->_response;
+  }
+
+private:
+  std::string _url;
+  std::string _method;
+  CesiumAsync::HttpHeaders _headers;
+  FileAssetResponse _response;
+};
+
+std::shared_ptr<CesiumAsync::IAssetRequest> readFile(const std::string& url) {
+  CESIUM_TRACE("Read local file");
+
+  IPlatformFile& platformFile = FPlatformFileManager::Get().GetPlatformFile();
+  TUniquePtr<IFileHandle> pHandle(platformFile.OpenRead(*getFilePath(url)));
+  if (!pHandle) {
+    return std::make_shared<FileAssetRequest>(
+        url,
+        uint16_t(404),
+        std::vector<std::byte>());
+  }
+
+  std::vector<std::byte> data(size_t(pHandle->Size()));
+  if (!pHandle->Read(reinterpret_cast<uint8*>(data.data()), data.size())) {
+    return std::make_shared<FileAssetRequest>(
+        url,
+        uint16_t(500),
+        std::vector<std::byte>());
+  }
+
+  return std::make_shared<FileAssetRequest>(
+      url,
+      uint16_t(200),
+      std::move(data));
+}
+} // namespace
+
+CesiumFileAssetAccessor::CesiumFileAssetAccessor(
+    const std::shared_ptr<CesiumAsync::IAssetAccessor>& pFallback)
+    : _pFallback(pFallback) {}
+
+CesiumAsync::Future<std::shared_ptr<CesiumAsync::IAssetRequest>>
+CesiumFileAssetAccessor::get(
+    const CesiumAsync::AsyncSystem& asyncSystem,
+    const std::string& url,
+    const std::vector<CesiumAsync::IAssetAccessor::THeader>& headers) {
+  if (isFileUrl(url)) {
+    return asyncSystem.runInWorkerThread([url]() { return readFile(url); });
+  }
+
+  return this->_pFallback->get(asyncSystem, url, headers);
+}
+
+CesiumAsync::Future<std::shared_ptr<CesiumAsync::IAssetRequest>>
+CesiumFileAssetAccessor::request(
+    const CesiumAsync::AsyncSystem& asyncSystem,
+    const std::string& verb,
+    const std::string& url,
+    const std::vector<CesiumAsync::IAssetAccessor::THeader>& headers,
+    const gsl::span<const std::byte>& contentPayload) {
+  if (verb == "GET" && isFileUrl(url)) {
+    return asyncSystem.runInWorkerThread([url]() { return readFile(url); });
+  }
+
+  return this->_pFallback
+      ->request(asyncSystem, verb, url, headers, contentPayload);
+}
+
+void CesiumFileAssetAccessor::tick() noexcept { this->_pFallback->tick(); }
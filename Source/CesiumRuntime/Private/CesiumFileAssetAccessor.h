@@ -0,0 +1,44 @@
+// Copyright 2020-2021 CesiumGS, Inc. and Contributors
+
+#pragma once
+
+#include "CesiumAsync/AsyncSystem.h"
+#include "CesiumAsync/IAssetAccessor.h"
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * @brief An asset accessor that reads file:// URLs straight from the disk on
+ * a worker thread, and passes all other requests to another asset accessor.
+ *
+ * Local files don't go through the HTTP module or the request cache, and
+ * their contents are read directly into the buffer that is handed to the
+ * tile loaders, on the worker thread that decodes them. A file that doesn't
+ * exist gets a response with status code 404.
+ */
+class CesiumFileAssetAccessor : public CesiumAsync::IAssetAccessor {
+public:
+  CesiumFileAssetAccessor(
+      const std::shared_ptr<CesiumAsync::IAssetAccessor>& pFallback);
+
+  virtual CesiumAsync::Future<std::shared_ptr<CesiumAsync::IAssetRequest>>
+  get(const CesiumAsync::AsyncSystem& asyncSystem,
+      const std::string& url,
+      const std::vector<CesiumAsync::IAssetAccessor::THeader>& headers)
+      override;
+
+  virtual CesiumAsync::Future<std::shared_ptr<CesiumAsync::IAssetRequest>>
+  request(
+      const CesiumAsync::AsyncSystem& asyncSystem,
+      const std::string& verb,
+      const std::string& url,
+      const std::vector<CesiumAsync::IAssetAccessor::THeader>& headers,
+      const gsl::span<const std::byte>& contentPayload) override;
+
+  virtual void tick() noexcept override;
+
+private:
+  std::shared_ptr<CesiumAsync::IAssetAccessor> _pFallback;
+};
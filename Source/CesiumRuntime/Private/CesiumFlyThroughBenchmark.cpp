@@ -0,0 +1,612 @@
+// Copyright 2020-2021 CesiumGS, Inc. and Contributors
+
+#include "CesiumFlyThroughBenchmark.h"
+#include "Camera/CameraComponent.h"
+#include "Camera/PlayerCameraManager.h"
+#include "Cesium3DTileset.h"
+#include "CesiumGeoreference.h"
+#include "CesiumRuntime.h"
+#include "CesiumRuntimeStats.h"
+#include "CesiumUtility/Tracing.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "GameFramework/PlayerController.h"
+#include "HAL/FileManager.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformMemory.h"
+#include "HAL/PlatformTime.h"
+#include "Kismet/KismetSystemLibrary.h"
+#include "Misc/CommandLine.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "RHI.h"
+#include "RenderCore.h"
+#include "ShaderPipelineCache.h"
+#include "VecMath.h"
+#include <algorithm>
+#include <glm/common.hpp>
+#include <glm/matrix.hpp>
+#include <glm/trigonometric.hpp>
+
+namespace {
+// The longest time, in seconds, to wait for the views of the last waypoint to
+// reach full detail before the benchmark finishes anyway.
+constexpr double FinalWaypointTimeout = 60.0;
+
+FString resolveProjectPath(const FString& path) {
+  return FPaths::IsRelative(path) ? FPaths::Combine(FPaths::ProjectDir(), path)
+                                  : path;
+}
+
+double getPercentile(std::vector<double> values, double percentile) {
+  if (values.empty()) {
+    return 0.0;
+  }
+  size_t index = size_t(percentile * double(values.size() - 1));
+  std::nth_element(values.begin(), values.begin() + index, values.end());
+  return values[index];
+}
+} // namespace
+
+ACesiumFlyThroughBenchmark::ACesiumFlyThroughBenchmark() {
+  PrimaryActorTick.bCanEverTick = true;
+
+  this->Camera = CreateDefaultSubobject<UCameraComponent>(TEXT("Camera"));
+  this->RootComponent = this->Camera;
+}
+
+bool ACesiumFlyThroughBenchmark::StartBenchmark() {
+  if (!this->ReadPath()) {
+    return false;
+  }
+
+  UE_LOG(
+      LogCesium,
+      Display,
+      TEXT("Starting the fly-through benchmark of %s with %d waypoints"),
+      *this->PathFile,
+      int32(this->_waypoints.size()));
+
+  UWorld* pWorld = this->GetWorld();
+  APlayerController* pController =
+      pWorld ? pWorld->GetFirstPlayerController() : nullptr;
+  if (pController) {
+    pController->SetViewTarget(this);
+  }
+
+  if (this->Deterministic) {
+    for (ACesium3DTileset* pTileset : this->GetBenchmarkTilesets()) {
+      pTileset->PlayMovieSequencer();
+    }
+  }
+
+  if (this->RecordPipelineCache) {
+    IConsoleVariable* pEnabled = IConsoleManager::Get().FindConsoleVariable(
+        TEXT("r.ShaderPipelineCache.Enabled"));
+    IConsoleVariable* pLogPSO = IConsoleManager::Get().FindConsoleVariable(
+        TEXT("r.ShaderPipelineCache.LogPSO"));
+    if (pEnabled && pEnabled->GetInt() == 0) {
+      UE_LOG(
+          LogCesium,
+          Warning,
+          TEXT(
+              "The shader pipeline cache is disabled, so no pipeline states are recorded"));
+    }
+    if (pLogPSO) {
+      pLogPSO->Set(1, ECVF_SetByCode);
+    }
+  }
+
+  this->_samples.clear();
+  this->_waypointReachedTimes.assign(this->_waypoints.size(), -1.0);
+  this->_timesToFullDetail.assign(this->_waypoints.size(), -1.0);
+  this->_running = true;
+  this->_pathTime = 0.0;
+  this->_nextWaypoint = 0;
+  this->_startTime = FPlatformTime::Seconds();
+  this->_lastFrameTime = this->_startTime;
+  this->_lastCesiumSeconds = CesiumRuntimeStats::getGameThreadSeconds();
+  this->_lastBytesDownloaded =
+      CesiumRuntimeStats::getLoadTotals().bytesDownloaded;
+
+  this->MoveCamera(0.0);
+  return true;
+}
+
+void ACesiumFlyThroughBenchmark::BeginPlay() {
+  Super::BeginPlay();
+
+  // Runs started from the command line are automated, so they start right
+  // away and quit when they are done.
+  bool fromCommandLine = false;
+  FString value;
+  if (FParse::Value(FCommandLine::Get(), TEXT("CesiumBenchmarkPath="), value)) {
+    this->PathFile = value;
+    fromCommandLine = true;
+  }
+  if (FParse::Value(
+          FCommandLine::Get(),
+          TEXT("CesiumBenchmarkOutput="),
+          value)) {
+    this->OutputDirectory = value;
+  }
+  if (FParse::Param(
+          FCommandLine::Get(),
+          TEXT("CesiumBenchmarkDeterministic"))) {
+    this->Deterministic = true;
+  }
+  if (FParse::Param(
+          FCommandLine::Get(),
+          TEXT("CesiumBenchmarkRecordPipelineCache"))) {
+    this->RecordPipelineCache = true;
+  }
+
+  this->_quitWhenFinished = this->QuitWhenFinished || fromCommandLine;
+  this->_lastRecordTime = -1.0;
+  this->_waypoints.clear();
+
+  if (this->Record && !fromCommandLine) {
+    this->_startTime = FPlatformTime::Seconds();
+  } else if (this->AutoStart || fromCommandLine) {
+    this->StartBenchmark();
+  }
+}
+
+void ACesiumFlyThroughBenchmark::EndPlay(
+    const EEndPlayReason::Type EndPlayReason) {
+  if (this->_running) {
+    // Keep the results of an interrupted run, but don't quit the game while
+    // it's already ending.
+    this->_quitWhenFinished = false;
+    this->FinishBenchmark();
+  } else if (this->Record && !this->_waypoints.empty()) {
+    this->WritePath();
+  }
+
+  Super::EndPlay(EndPlayReason);
+}
+
+void ACesiumFlyThroughBenchmark::Tick(float DeltaTime) {
+  Super::Tick(DeltaTime);
+
+  if (!this->_running) {
+    if (this->Record) {
+      this->RecordWaypoint(FPlatformTime::Seconds() - this->_startTime);
+    }
+    return;
+  }
+
+  CESIUM_TRACE("ACesiumFlyThroughBenchmark::Tick");
+
+  // The tilesets were updated for the view of the last frame, so its results
+  // are sampled before the camera moves on.
+  this->SampleFrame();
+
+  const double now = FPlatformTime::Seconds();
+  const bool loaded = this->AreTilesetsLoaded();
+  const size_t current = this->_nextWaypoint;
+  if (current > 0 && loaded && this->_timesToFullDetail[current - 1] < 0.0) {
+    this->_timesToFullDetail[current - 1] =
+        now - this->_waypointReachedTimes[current - 1];
+  }
+
+  const Waypoint& last = this->_waypoints.back();
+  if (this->_pathTime >= last.time && current == this->_waypoints.size()) {
+    if (loaded || now - this->_waypointReachedTimes.back() >
+                      FinalWaypointTimeout) {
+      this->FinishBenchmark();
+      return;
+    }
+  }
+
+  this->_pathTime +=
+      this->Deterministic ? double(this->FixedTimeStep) : double(DeltaTime);
+  this->_pathTime = std::min(this->_pathTime, last.time);
+  while (this->_nextWaypoint < this->_waypoints.size() &&
+         this->_waypoints[this->_nextWaypoint].time <= this->_pathTime) {
+    this->_waypointReachedTimes[this->_nextWaypoint] = now;
+    ++this->_nextWaypoint;
+  }
+
+  this->MoveCamera(this->_pathTime);
+}
+
+ACesiumGeoreference*
+ACesiumFlyThroughBenchmark::GetBenchmarkGeoreference() const {
+  return ACesiumGeoreference::GetDefaultGeoreference(this);
+}
+
+TArray<ACesium3DTileset*>
+ACesiumFlyThroughBenchmark::GetBenchmarkTilesets() const {
+  TArray<ACesium3DTileset*> tilesets;
+  if (this->Tilesets.Num() > 0) {
+    for (ACesium3DTileset* pTileset : this->Tilesets) {
+      if (IsValid(pTileset)) {
+        tilesets.Add(pTileset);
+      }
+    }
+  } else if (UWorld* pWorld = this->GetWorld()) {
+    for (TActorIterator<ACesium3DTileset> it(pWorld); it; ++it) {
+      tilesets.Add(*it);
+    }
+  }
+  return tilesets;
+}
+
+bool ACesiumFlyThroughBenchmark::AreTilesetsLoaded() const {
+  for (const ACesium3DTileset* pTileset : this->GetBenchmarkTilesets()) {
+    if (!pTileset->IsLoadComplete()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void ACesiumFlyThroughBenchmark::MoveCamera(double pathTime) {
+  ACesiumGeoreference* pGeoreference = this->GetBenchmarkGeoreference();
+  if (!pGeoreference || this->_waypoints.empty()) {
+    return;
+  }
+
+  auto next = std::upper_bound(
+      this->_waypoints.begin(),
+      this->_waypoints.end(),
+      pathTime,
+      [](double time, const Waypoint& waypoint) {
+        return time < waypoint.time;
+      });
+  const Waypoint& to =
+      next == this->_waypoints.end() ? this->_waypoints.back() : *next;
+  const Waypoint& from = next == this->_waypoints.begin() ? to : *(next - 1);
+
+  const double duration = to.time - from.time;
+  const double t =
+      duration > 0.0 ? std::clamp((pathTime - from.time) / duration, 0.0, 1.0)
+                     : 0.0;
+
+  const glm::dvec3 longitudeLatitudeHeight(
+      glm::mix(from.longitude, to.longitude, t),
+      glm::mix(from.latitude, to.latitude, t),
+      glm::mix(from.height, to.height, t));
+  const double heading =
+      from.heading +
+      t * double(FMath::FindDeltaAngleDegrees(
+              float(from.heading),
+              float(to.heading)));
+  const double pitch = glm::mix(from.pitch, to.pitch, t);
+
+  const glm::dvec3 location =
+      pGeoreference->TransformLongitudeLatitudeHeightToUnreal(
+          longitudeLatitudeHeight);
+  const glm::dmat3 enuToUnreal =
+      pGeoreference->ComputeEastNorthUpToUnreal(location);
+
+  const double cosPitch = glm::cos(glm::radians(pitch));
+  const glm::dvec3 direction =
+      enuToUnreal * glm::dvec3(
+                        cosPitch * glm::sin(glm::radians(heading)),
+                        cosPitch * glm::cos(glm::radians(heading)),
+                        glm::sin(glm::radians(pitch)));
+
+  this->SetActorLocationAndRotation(
+      VecMath::createVector(location),
+      FRotationMatrix::MakeFromXZ(
+          VecMath::createVector(direction),
+          VecMath::createVector(enuToUnreal[2]))
+          .Rotator());
+}
+
+void ACesiumFlyThroughBenchmark::RecordWaypoint(double time) {
+  if (this->_lastRecordTime >= 0.0 &&
+      time - this->_lastRecordTime < double(this->RecordInterval)) {
+    return;
+  }
+
+  ACesiumGeoreference* pGeoreference = this->GetBenchmarkGeoreference();
+  UWorld* pWorld = this->GetWorld();
+  APlayerController* pController =
+      pWorld ? pWorld->GetFirstPlayerController() : nullptr;
+  if (!pGeoreference || !pController || !pController->PlayerCameraManager) {
+    return;
+  }
+
+  const APlayerCameraManager* pCameraManager =
+      pController->PlayerCameraManager;
+  const glm::dvec3 location =
+      VecMath::createVector3D(pCameraManager->GetCameraLocation());
+  const glm::dvec3 longitudeLatitudeHeight =
+      pGeoreference->TransformUnrealToLongitudeLatitudeHeight(location);
+
+  // The East-North-Up axes are orthonormal, so the transpose is the inverse.
+  const glm::dvec3 direction =
+      glm::transpose(pGeoreference->ComputeEastNorthUpToUnreal(location)) *
+      VecMath::createVector3D(pCameraManager->GetCameraRotation().Vector());
+
+  Waypoint waypoint;
+  waypoint.time = time;
+  waypoint.longitude = longitudeLatitudeHeight.x;
+  waypoint.latitude = longitudeLatitudeHeight.y;
+  waypoint.height = longitudeLatitudeHeight.z;
+  waypoint.heading = glm::degrees(glm::atan(direction.x, direction.y));
+  waypoint.pitch =
+      glm::degrees(glm::asin(glm::clamp(direction.z, -1.0, 1.0)));
+  this->_waypoints.push_back(waypoint);
+  this->_lastRecordTime = time;
+}
+
+void ACesiumFlyThroughBenchmark::SampleFrame() {
+  const double now = FPlatformTime::Seconds();
+  const double cesiumSeconds = CesiumRuntimeStats::getGameThreadSeconds();
+  const int64 bytesDownloaded =
+      CesiumRuntimeStats::getLoadTotals().bytesDownloaded;
+
+  FrameSample sample;
+  sample.time = this->_pathTime;
+  sample.frameMilliseconds = (now - this->_lastFrameTime) * 1000.0;
+  sample.gameThreadMilliseconds =
+      FPlatformTime::ToMilliseconds(GGameThreadTime);
+  sample.renderThreadMilliseconds =
+      FPlatformTime::ToMilliseconds(GRenderThreadTime);
+  sample.gpuMilliseconds =
+      FPlatformTime::ToMilliseconds(RHIGetGPUFrameCycles());
+  sample.cesiumMilliseconds =
+      (cesiumSeconds - this->_lastCesiumSeconds) * 1000.0;
+  sample.tilesLoaded = 0;
+  sample.tilesRendered = 0;
+  for (const ACesium3DTileset* pTileset : this->GetBenchmarkTilesets()) {
+    sample.tilesLoaded += pTileset->GetNumberOfTilesLoaded();
+    sample.tilesRendered += pTileset->GetNumberOfTilesRendered();
+  }
+  sample.bytesDownloaded = bytesDownloaded - this->_lastBytesDownloaded;
+  sample.usedPhysicalBytes = FPlatformMemory::GetStats().UsedPhysical;
+  this->_samples.push_back(sample);
+
+  this->_lastFrameTime = now;
+  this->_lastCesiumSeconds = cesiumSeconds;
+  this->_lastBytesDownloaded = bytesDownloaded;
+}
+
+void ACesiumFlyThroughBenchmark::FinishBenchmark() {
+  this->_running = false;
+
+  if (this->Deterministic) {
+    for (ACesium3DTileset* pTileset : this->GetBenchmarkTilesets()) {
+      pTileset->StopMovieSequencer();
+    }
+  }
+
+  this->WriteResults();
+
+  if (this->RecordPipelineCache) {
+    if (FShaderPipelineCache::SavePipelineFileCache(
+            FPipelineFileCache::SaveMode::Incremental)) {
+      UE_LOG(
+          LogCesium,
+          Display,
+          TEXT("Saved the recorded pipeline states into Saved/CollectedPSOs"));
+    } else {
+      UE_LOG(
+          LogCesium,
+          Warning,
+          TEXT(
+              "No pipeline states were saved, the game must be started with -logPSO to record them"));
+    }
+  }
+
+  if (this->_quitWhenFinished) {
+    UKismetSystemLibrary::QuitGame(
+        this,
+        nullptr,
+        EQuitPreference::Quit,
+        false);
+  }
+}
+
+void ACesiumFlyThroughBenchmark::WriteResults() const {
+  const FString directory =
+      this->OutputDirectory.IsEmpty()
+          ? FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("Cesium/Benchmark"))
+          : resolveProjectPath(this->OutputDirectory);
+  IFileManager::Get().MakeDirectory(*directory, true);
+
+  // The names only depend on the path, so that the results of repeated runs
+  // can be found and compared by scripts.
+  const FString name = FPaths::GetBaseFilename(this->PathFile);
+  const FString framesFile =
+      FPaths::Combine(directory, name + TEXT("-Frames.csv"));
+  const FString summaryFile =
+      FPaths::Combine(directory, name + TEXT("-Summary.json"));
+
+  FString frames = TEXT(
+      "Time,FrameMs,GameThreadMs,RenderThreadMs,GpuMs,CesiumGameThreadMs,"
+      "TilesLoaded,TilesRendered,BytesDownloaded,UsedPhysicalBytes\n");
+  std::vector<double> frameTimes;
+  frameTimes.reserve(this->_samples.size());
+  double cesiumMilliseconds = 0.0;
+  int64 bytesDownloaded = 0;
+  int32 peakTilesLoaded = 0;
+  uint64 peakUsedPhysicalBytes = 0;
+  for (const FrameSample& sample : this->_samples) {
+    frames += FString::Printf(
+        TEXT("%.4f,%.3f,%.3f,%.3f,%.3f,%.3f,%d,%d,%lld,%llu\n"),
+        sample.time,
+        sample.frameMilliseconds,
+        sample.gameThreadMilliseconds,
+        sample.renderThreadMilliseconds,
+        sample.gpuMilliseconds,
+        sample.cesiumMilliseconds,
+        sample.tilesLoaded,
+        sample.tilesRendered,
+        sample.bytesDownloaded,
+        sample.usedPhysicalBytes);
+
+    frameTimes.push_back(sample.frameMilliseconds);
+    cesiumMilliseconds += sample.cesiumMilliseconds;
+    bytesDownloaded += sample.bytesDownloaded;
+    peakTilesLoaded = std::max(peakTilesLoaded, sample.tilesLoaded);
+    peakUsedPhysicalBytes =
+        std::max(peakUsedPhysicalBytes, sample.usedPhysicalBytes);
+  }
+
+  const double frameCount = double(std::max(frameTimes.size(), size_t(1)));
+  double totalFrameMilliseconds = 0.0;
+  for (double frameTime : frameTimes) {
+    totalFrameMilliseconds += frameTime;
+  }
+
+  FString waypoints;
+  for (size_t i = 0; i < this->_waypoints.size(); ++i) {
+    const double timeToFullDetail = this->_timesToFullDetail[i];
+    waypoints += FString::Printf(
+        TEXT("%s\n    {\"time\": %.4f, \"timeToFullDetailSeconds\": %s}"),
+        i == 0 ? TEXT("") : TEXT(","),
+        this->_waypoints[i].time,
+        timeToFullDetail >= 0.0
+            ? *FString::Printf(TEXT("%.4f"), timeToFullDetail)
+            : TEXT("null"));
+  }
+
+  FString summary;
+  summary += TEXT("{\n");
+  summary += FString::Printf(
+      TEXT("  \"path\": \"%s\",\n"),
+      *this->PathFile.ReplaceCharWithEscapedChar());
+  summary += FString::Printf(
+      TEXT("  \"deterministic\": %s,\n"),
+      this->Deterministic ? TEXT("true") : TEXT("false"));
+  summary += FString::Printf(
+      TEXT("  \"frames\": %d,\n"),
+      int32(this->_samples.size()));
+  summary += FString::Printf(
+      TEXT("  \"durationSeconds\": %.4f,\n"),
+      this->_lastFrameTime - this->_startTime);
+  summary += FString::Printf(
+      TEXT("  \"frameTimeMs\": {\"mean\": %.3f, \"p50\": %.3f, "
+           "\"p95\": %.3f, \"p99\": %.3f},\n"),
+      totalFrameMilliseconds / frameCount,
+      getPercentile(frameTimes, 0.5),
+      getPercentile(frameTimes, 0.95),
+      getPercentile(frameTimes, 0.99));
+  summary += FString::Printf(
+      TEXT("  \"cesiumGameThreadMs\": {\"mean\": %.3f, \"total\": %.3f},\n"),
+      cesiumMilliseconds / frameCount,
+      cesiumMilliseconds);
+  summary +=
+      FString::Printf(TEXT("  \"bytesDownloaded\": %lld,\n"), bytesDownloaded);
+  summary +=
+      FString::Printf(TEXT("  \"peakTilesLoaded\": %d,\n"), peakTilesLoaded);
+  summary += FString::Printf(
+      TEXT("  \"peakUsedPhysicalBytes\": %llu,\n"),
+      peakUsedPhysicalBytes);
+  summary += FString::Printf(TEXT("  \"waypoints\": [%s\n  ]\n"), *waypoints);
+  summary += TEXT("}\n");
+
+  if (!FFileHelper::SaveStringToFile(frames, *framesFile) ||
+      !FFileHelper::SaveStringToFile(summary, *summaryFile)) {
+    UE_LOG(
+        LogCesium,
+        Warning,
+        TEXT("Could not write the fly-through benchmark results to %s"),
+        *directory);
+    return;
+  }
+
+  UE_LOG(
+      LogCesium,
+      Display,
+      TEXT("Wrote the fly-through benchmark results to %s and %s"),
+      *framesFile,
+      *summaryFile);
+}
+
+bool ACesiumFlyThroughBenchmark::ReadPath() {
+  this->_waypoints.clear();
+
+  const FString path = resolveProjectPath(this->PathFile);
+  TArray<FString> lines;
+  if (!FFileHelper::LoadFileToStringArray(lines, *path)) {
+    UE_LOG(
+        LogCesium,
+        Warning,
+        TEXT("Could not read the fly-through benchmark path %s"),
+        *path);
+    return false;
+  }
+
+  TArray<FString> fields;
+  for (const FString& line : lines) {
+    // Skip the header and any other line that doesn't start with a number.
+    const FString trimmed = line.TrimStartAndEnd();
+    if (trimmed.IsEmpty() ||
+        !(FChar::IsDigit(trimmed[0]) || trimmed[0] == TEXT('-') ||
+          trimmed[0] == TEXT('.'))) {
+      continue;
+    }
+
+    trimmed.ParseIntoArray(fields, TEXT(","), true);
+    if (fields.Num() < 6) {
+      UE_LOG(
+          LogCesium,
+          Warning,
+          TEXT("Ignoring the invalid fly-through benchmark waypoint: %s"),
+          *trimmed);
+      continue;
+    }
+
+    Waypoint waypoint;
+    waypoint.time = FCString::Atod(*fields[0]);
+    waypoint.longitude = FCString::Atod(*fields[1]);
+    waypoint.latitude = FCString::Atod(*fields[2]);
+    waypoint.height = FCString::Atod(*fields[3]);
+    waypoint.heading = FCString::Atod(*fields[4]);
+    waypoint.pitch = FCString::Atod(*fields[5]);
+    this->_waypoints.push_back(waypoint);
+  }
+
+  if (this->_waypoints.empty()) {
+    UE_LOG(
+        LogCesium,
+        Warning,
+        TEXT("The fly-through benchmark path %s has no waypoints"),
+        *path);
+    return false;
+  }
+
+  std::stable_sort(
+      this->_waypoints.begin(),
+      this->_waypoints.end(),
+      [](const Waypoint& a, const Waypoint& b) { return a.time < b.time; });
+  return true;
+}
+
+bool ACesiumFlyThroughBenchmark::WritePath() const {
+  FString contents = TEXT("Time,Longitude,Latitude,Height,Heading,Pitch\n");
+  for (const Waypoint& waypoint : this->_waypoints) {
+    contents += FString::Printf(
+        TEXT("%.4f,%.9f,%.9f,%.3f,%.3f,%.3f\n"),
+        waypoint.time,
+        waypoint.longitude,
+        waypoint.latitude,
+        waypoint.height,
+        waypoint.heading,
+        waypoint.pitch);
+  }
+
+  const FString path = resolveProjectPath(this->PathFile);
+  if (!FFileHelper::SaveStringToFile(contents, *path)) {
+    UE_LOG(
+        LogCesium,
+        Warning,
+        TEXT("Could not write the fly-through benchmark path %s"),
+        *path);
+    return false;
+  }
+
+  UE_LOG(
+      LogCesium,
+      Display,
+      TEXT("Recorded %d fly-through benchmark waypoints to %s"),
+      int32(this->_waypoints.size()),
+      *path);
+  return true;
+}
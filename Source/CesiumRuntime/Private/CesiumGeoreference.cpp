@@ -23,9 +23,11 @@
 #include "VecMath.h"
 #include <glm/ext/matrix_transform.hpp>
 #include <glm/gtc/matrix_inverse.hpp>
+#include <algorithm>
 #include <glm/gtc/quaternion.hpp>
 #include <optional>
 #include <string>
+#include <vector>
 
 #if WITH_EDITOR
 #include "DrawDebugHelpers.h"
@@ -122,7 +124,11 @@ ACesiumGeoreference::ACesiumGeoreference()
         CesiumGeospatial::Ellipsoid::WGS84.getRadii().y,
         CesiumGeospatial::Ellipsoid::WGS84.getRadii().z},
       _geoTransforms(),
-      _insideSublevel(false) {
+      _insideSublevel(false),
+      _cachedSubLevels(),
+      _subLevelsByEcefX(),
+      _maximumSubLevelLoadRadius(0.0),
+      _prefetchingSubLevels() {
   PrimaryActorTick.bCanEverTick = true;
 }
 
@@ -375,7 +381,8 @@ bool ACesiumGeoreference::SwitchToLevel(int32 Index) {
   }
 
   // Deactivate all other streaming levels controlled by Cesium
-  for (const FCesiumSubLevel& subLevel : this->CesiumSubLevels) {
+  for (int32 i = 0; i < this->CesiumSubLevels.Num(); ++i) {
+    const FCesiumSubLevel& subLevel = this->CesiumSubLevels[i];
     if (&subLevel == pLevel) {
       continue;
     }
@@ -389,6 +396,23 @@ bool ACesiumGeoreference::SwitchToLevel(int32 Index) {
 
     ULevelStreaming* pOtherLevel =
         this->_findLevelStreamingByName(subLevel.LevelName);
+    if (!pOtherLevel) {
+      continue;
+    }
+
+    if (this->_prefetchingSubLevels.Contains(i)) {
+      // Keep a prefetched level loaded, but hide it until the camera is within
+      // its load radius. Hiding it must happen immediately for the same
+      // reason as unloading it below.
+      if (pOtherLevel->ShouldBeVisible()) {
+        pOtherLevel->bShouldBlockOnUnload = true;
+        pOtherLevel->SetShouldBeVisible(false);
+      }
+      if (!pOtherLevel->ShouldBeLoaded()) {
+        pOtherLevel->SetShouldBeLoaded(true);
+      }
+      continue;
+    }
 
     if (pOtherLevel->ShouldBeVisible() || pOtherLevel->ShouldBeLoaded()) {
       // We need to unload immediately, not over the course of several frames.
@@ -485,6 +509,15 @@ void ACesiumGeoreference::BeginPlay() {
     return;
   }
 
+  if (this->UseLargeWorldCoordinates && !this->_usesLargeWorldCoordinates()) {
+    UE_LOG(
+        LogCesium,
+        Warning,
+        TEXT(
+            "CesiumGeoreference %s has UseLargeWorldCoordinates enabled, but this Engine version does not support them. KeepWorldOriginNearCamera is used instead."),
+        *this->GetName());
+  }
+
   if (!this->WorldOriginCamera) {
     // Find the first player's camera manager
     APlayerController* pPlayerController = pWorld->GetFirstPlayerController();
@@ -542,6 +575,7 @@ void ACesiumGeoreference::BeginDestroy() {
 }
 
 void ACesiumGeoreference::UpdateGeoreference() {
+  const uint64 previousVersion = this->GetGeoTransformsVersion();
   this->_updateGeoTransforms();
 
   UE_LOG(
@@ -551,6 +585,15 @@ void ACesiumGeoreference::UpdateGeoreference() {
       *this->GetFullName());
 
   OnGeoreferenceUpdated.Broadcast();
+
+  if (this->GetGeoTransformsVersion() != previousVersion) {
+    OnGeoTransformsChanged.Broadcast(this->GetGeoTransformsSnapshot());
+  }
+}
+
+GeoTransformsSnapshot ACesiumGeoreference::GetGeoTransformsSnapshot() const {
+  std::lock_guard<std::mutex> lock(this->_geoTransformsSnapshotMutex);
+  return this->_geoTransformsSnapshot;
 }
 
 #if WITH_EDITOR
@@ -705,37 +748,118 @@ bool ACesiumGeoreference::_updateSublevelState() {
           .GetAbsoluteUnrealWorldToEllipsoidCenteredTransform() *
       cameraAbsolute);
 
+  this->_updateSubLevelIndex();
+
+  // Only the levels whose ECEF X coordinate is within the largest load (and
+  // prefetch) radius of the camera's can be close enough to matter.
+  const double prefetchDistance =
+      FMath::Max(this->SubLevelPrefetchDistance, 0.0);
+  const double searchRadius =
+      this->_maximumSubLevelLoadRadius + prefetchDistance;
+  auto it = std::lower_bound(
+      this->_subLevelsByEcefX.begin(),
+      this->_subLevelsByEcefX.end(),
+      cameraECEF.x - searchRadius,
+      [this](int32 level, double x) {
+        return this->_cachedSubLevels[level].ecef.x < x;
+      });
+
   int32 activeLevel = -1;
   double closestLevelDistance = std::numeric_limits<double>::max();
+  TArray<int32> prefetchingSubLevels;
 
-  for (int32 i = 0; i < this->CesiumSubLevels.Num(); ++i) {
-    const FCesiumSubLevel& level = this->CesiumSubLevels[i];
-    if (!level.Enabled) {
-      continue;
+  for (; it != this->_subLevelsByEcefX.end(); ++it) {
+    const CachedSubLevel& level = this->_cachedSubLevels[*it];
+    if (level.ecef.x > cameraECEF.x + searchRadius) {
+      break;
     }
 
-    glm::dvec3 levelECEF =
-        _geoTransforms.TransformLongitudeLatitudeHeightToEcef(glm::dvec3(
-            level.LevelLongitude,
-            level.LevelLatitude,
-            level.LevelHeight));
-
-    double levelDistance = glm::length(levelECEF - cameraECEF);
-    if (levelDistance < level.LoadRadius &&
+    const double levelDistance = glm::distance(level.ecef, cameraECEF);
+    if (levelDistance < level.loadRadius &&
         levelDistance < closestLevelDistance) {
-      activeLevel = i;
+      if (activeLevel >= 0 && prefetchDistance > 0.0) {
+        prefetchingSubLevels.Add(activeLevel);
+      }
+      activeLevel = *it;
+      closestLevelDistance = levelDistance;
+    } else if (
+        prefetchDistance > 0.0 &&
+        levelDistance < level.loadRadius + prefetchDistance) {
+      prefetchingSubLevels.Add(*it);
     }
   }
 
+  this->_prefetchingSubLevels = MoveTemp(prefetchingSubLevels);
+
   // activeLevel may be -1, in which case all levels will be deactivated.
   return this->SwitchToLevel(activeLevel);
 }
 
+void ACesiumGeoreference::_updateSubLevelIndex() {
+  bool changed = this->_cachedSubLevels.size() !=
+                 size_t(this->CesiumSubLevels.Num());
+  for (int32 i = 0; !changed && i < this->CesiumSubLevels.Num(); ++i) {
+    const FCesiumSubLevel& level = this->CesiumSubLevels[i];
+    const CachedSubLevel& cached = this->_cachedSubLevels[i];
+    changed = cached.longitude != level.LevelLongitude ||
+              cached.latitude != level.LevelLatitude ||
+              cached.height != level.LevelHeight ||
+              cached.loadRadius != level.LoadRadius ||
+              cached.enabled != level.Enabled;
+  }
+
+  if (!changed) {
+    return;
+  }
+
+  this->_cachedSubLevels.clear();
+  this->_cachedSubLevels.reserve(size_t(this->CesiumSubLevels.Num()));
+  this->_subLevelsByEcefX.clear();
+  this->_maximumSubLevelLoadRadius = 0.0;
+
+  for (int32 i = 0; i < this->CesiumSubLevels.Num(); ++i) {
+    const FCesiumSubLevel& level = this->CesiumSubLevels[i];
+    this->_cachedSubLevels.push_back(CachedSubLevel{
+        level.LevelLongitude,
+        level.LevelLatitude,
+        level.LevelHeight,
+        level.LoadRadius,
+        level.Enabled,
+        this->_geoTransforms.TransformLongitudeLatitudeHeightToEcef(
+            glm::dvec3(
+                level.LevelLongitude,
+                level.LevelLatitude,
+                level.LevelHeight))});
+
+    if (level.Enabled) {
+      this->_subLevelsByEcefX.push_back(i);
+      this->_maximumSubLevelLoadRadius =
+          FMath::Max(this->_maximumSubLevelLoadRadius, level.LoadRadius);
+    }
+  }
+
+  std::sort(
+      this->_subLevelsByEcefX.begin(),
+      this->_subLevelsByEcefX.end(),
+      [this](int32 a, int32 b) {
+        return this->_cachedSubLevels[a].ecef.x <
+               this->_cachedSubLevels[b].ecef.x;
+      });
+}
+
 void ACesiumGeoreference::_performOriginRebasing() {
   UWorld* world = this->GetWorld();
   if (!world->IsGameWorld()) {
     return;
   }
+  if (this->_usesLargeWorldCoordinates()) {
+    // Positions are precise anywhere in the world, so keep the origin at zero
+    // instead of shifting every Actor whenever the camera moves far enough.
+    if (!world->OriginLocation.IsZero()) {
+      world->SetNewWorldOrigin(FIntVector::ZeroValue);
+    }
+    return;
+  }
   if (!IsValid(WorldOriginCamera)) {
     return;
   }
@@ -771,6 +895,14 @@ void ACesiumGeoreference::_performOriginRebasing() {
   }
 }
 
+bool ACesiumGeoreference::_usesLargeWorldCoordinates() const {
+#if ENGINE_MAJOR_VERSION >= 5
+  return this->UseLargeWorldCoordinates;
+#else
+  return false;
+#endif
+}
+
 void ACesiumGeoreference::_updateGeoTransforms() {
   glm::dvec3 center(0.0, 0.0, 0.0);
   if (this->OriginPlacement == EOriginPlacement::CartographicOrigin) {
@@ -786,6 +918,31 @@ void ACesiumGeoreference::_updateGeoTransforms() {
           this->_ellipsoidRadii[1],
           this->_ellipsoidRadii[2]),
       center);
+
+  // The sub-level positions depend on the ellipsoid.
+  this->_cachedSubLevels.clear();
+
+  this->_updateGeoTransformsSnapshot();
+}
+
+void ACesiumGeoreference::_updateGeoTransformsSnapshot() {
+  const GeoTransformsSnapshot previous = this->GetGeoTransformsSnapshot();
+  if (previous.GetVersion() > 0 &&
+      previous->GetCenter() == this->_geoTransforms.GetCenter() &&
+      previous->GetEllipsoid().getRadii() ==
+          this->_geoTransforms.GetEllipsoid().getRadii()) {
+    return;
+  }
+
+  // Snapshots are only taken here, on the game thread or while loading, so
+  // the version can't change between reading it and writing it.
+  const uint64 version = previous.GetVersion() + 1;
+  GeoTransformsSnapshot snapshot(this->_geoTransforms, version);
+  {
+    std::lock_guard<std::mutex> lock(this->_geoTransformsSnapshotMutex);
+    this->_geoTransformsSnapshot = std::move(snapshot);
+  }
+  this->_geoTransformsVersion.store(version, std::memory_order_release);
 }
 
 void ACesiumGeoreference::Tick(float DeltaTime) {
@@ -910,6 +1067,141 @@ ACesiumGeoreference::InaccurateTransformUnrealToEcef(const FVector& ue) const {
   return FVector(ecef.x, ecef.y, ecef.z);
 }
 
+namespace {
+/**
+ * Converts an array of points to double precision, transforms them in place
+ * with the given batch transform, and converts them back.
+ */
+template <typename Transform>
+TArray<FVector>
+transformArray(const TArray<FVector>& input, const Transform& transform) {
+  std::vector<glm::dvec3> points(size_t(input.Num()));
+  for (int32 i = 0; i < input.Num(); ++i) {
+    points[size_t(i)] = VecMath::createVector3D(input[i]);
+  }
+
+  transform(gsl::span<const glm::dvec3>(points), gsl::span<glm::dvec3>(points));
+
+  TArray<FVector> output;
+  output.SetNumUninitialized(input.Num());
+  for (int32 i = 0; i < input.Num(); ++i) {
+    const glm::dvec3& point = points[size_t(i)];
+    output[i] = FVector(point.x, point.y, point.z);
+  }
+  return output;
+}
+} // namespace
+
+void ACesiumGeoreference::TransformLongitudeLatitudeHeightToEcef(
+    gsl::span<const glm::dvec3> longitudeLatitudeHeights,
+    gsl::span<glm::dvec3> ecefs) const {
+  this->_geoTransforms.TransformLongitudeLatitudeHeightToEcef(
+      longitudeLatitudeHeights,
+      ecefs);
+}
+
+TArray<FVector>
+ACesiumGeoreference::InaccurateTransformLongitudeLatitudeHeightArrayToEcef(
+    const TArray<FVector>& longitudeLatitudeHeights) const {
+  return transformArray(
+      longitudeLatitudeHeights,
+      [this](gsl::span<const glm::dvec3> input, gsl::span<glm::dvec3> output) {
+        this->TransformLongitudeLatitudeHeightToEcef(input, output);
+      });
+}
+
+void ACesiumGeoreference::TransformEcefToLongitudeLatitudeHeight(
+    gsl::span<const glm::dvec3> ecefs,
+    gsl::span<glm::dvec3> longitudeLatitudeHeights) const {
+  this->_geoTransforms.TransformEcefToLongitudeLatitudeHeight(
+      ecefs,
+      longitudeLatitudeHeights);
+}
+
+TArray<FVector>
+ACesiumGeoreference::InaccurateTransformEcefArrayToLongitudeLatitudeHeight(
+    const TArray<FVector>& ecefs) const {
+  return transformArray(
+      ecefs,
+      [this](gsl::span<const glm::dvec3> input, gsl::span<glm::dvec3> output) {
+        this->TransformEcefToLongitudeLatitudeHeight(input, output);
+      });
+}
+
+void ACesiumGeoreference::TransformLongitudeLatitudeHeightToUnreal(
+    gsl::span<const glm::dvec3> longitudeLatitudeHeights,
+    gsl::span<glm::dvec3> ues) const {
+  this->_geoTransforms.TransformLongitudeLatitudeHeightToUnreal(
+      glm::dvec3(CesiumActors::getWorldOrigin4D(this)),
+      longitudeLatitudeHeights,
+      ues);
+}
+
+TArray<FVector>
+ACesiumGeoreference::InaccurateTransformLongitudeLatitudeHeightArrayToUnreal(
+    const TArray<FVector>& longitudeLatitudeHeights) const {
+  return transformArray(
+      longitudeLatitudeHeights,
+      [this](gsl::span<const glm::dvec3> input, gsl::span<glm::dvec3> output) {
+        this->TransformLongitudeLatitudeHeightToUnreal(input, output);
+      });
+}
+
+void ACesiumGeoreference::TransformUnrealToLongitudeLatitudeHeight(
+    gsl::span<const glm::dvec3> ues,
+    gsl::span<glm::dvec3> longitudeLatitudeHeights) const {
+  this->_geoTransforms.TransformUnrealToLongitudeLatitudeHeight(
+      glm::dvec3(CesiumActors::getWorldOrigin4D(this)),
+      ues,
+      longitudeLatitudeHeights);
+}
+
+TArray<FVector>
+ACesiumGeoreference::InaccurateTransformUnrealArrayToLongitudeLatitudeHeight(
+    const TArray<FVector>& ues) const {
+  return transformArray(
+      ues,
+      [this](gsl::span<const glm::dvec3> input, gsl::span<glm::dvec3> output) {
+        this->TransformUnrealToLongitudeLatitudeHeight(input, output);
+      });
+}
+
+void ACesiumGeoreference::TransformEcefToUnreal(
+    gsl::span<const glm::dvec3> ecefs,
+    gsl::span<glm::dvec3> ues) const {
+  this->_geoTransforms.TransformEcefToUnreal(
+      glm::dvec3(CesiumActors::getWorldOrigin4D(this)),
+      ecefs,
+      ues);
+}
+
+TArray<FVector> ACesiumGeoreference::InaccurateTransformEcefArrayToUnreal(
+    const TArray<FVector>& ecefs) const {
+  return transformArray(
+      ecefs,
+      [this](gsl::span<const glm::dvec3> input, gsl::span<glm::dvec3> output) {
+        this->TransformEcefToUnreal(input, output);
+      });
+}
+
+void ACesiumGeoreference::TransformUnrealToEcef(
+    gsl::span<const glm::dvec3> ues,
+    gsl::span<glm::dvec3> ecefs) const {
+  this->_geoTransforms.TransformUnrealToEcef(
+      glm::dvec3(CesiumActors::getWorldOrigin4D(this)),
+      ues,
+      ecefs);
+}
+
+TArray<FVector> ACesiumGeoreference::InaccurateTransformUnrealArrayToEcef(
+    const TArray<FVector>& ues) const {
+  return transformArray(
+      ues,
+      [this](gsl::span<const glm::dvec3> input, gsl::span<glm::dvec3> output) {
+        this->TransformUnrealToEcef(input, output);
+      });
+}
+
 glm::dquat ACesiumGeoreference::TransformRotatorUnrealToEastNorthUp(
     const glm::dquat& UeRotator,
     const glm::dvec3& UeLocation) const {
@@ -973,6 +1265,29 @@ FMatrix ACesiumGeoreference::InaccurateComputeEastNorthUpToEcef(
   return VecMath::createMatrix(enuToEcef);
 }
 
+GeoTransforms::EastNorthUpFrame ACesiumGeoreference::ComputeEastNorthUpFrame(
+    const glm::dvec3& UnrealLocation) const {
+  return this->_geoTransforms.ComputeEastNorthUpFrame(
+      glm::dvec3(CesiumActors::getWorldOrigin4D(this)),
+      UnrealLocation);
+}
+
+glm::dquat ACesiumGeoreference::TransformRotatorUnrealToEastNorthUp(
+    const GeoTransforms::EastNorthUpFrame& Frame,
+    const glm::dquat& UnrealRotator) const {
+  return this->_geoTransforms.TransformRotatorUnrealToEastNorthUp(
+      Frame,
+      UnrealRotator);
+}
+
+glm::dquat ACesiumGeoreference::TransformRotatorEastNorthUpToUnreal(
+    const GeoTransforms::EastNorthUpFrame& Frame,
+    const glm::dquat& EnuRotator) const {
+  return this->_geoTransforms.TransformRotatorEastNorthUpToUnreal(
+      Frame,
+      EnuRotator);
+}
+
 /**
  * Private Helper Functions
  */
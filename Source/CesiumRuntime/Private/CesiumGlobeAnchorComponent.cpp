@@ -1,9 +1,11 @@
 #include "CesiumGlobeAnchorComponent.h"
+#include "Async/ParallelFor.h"
 #include "CesiumActors.h"
 #include "CesiumCustomVersion.h"
 #include "CesiumGeoreference.h"
 #include "CesiumRuntime.h"
 #include "CesiumTransforms.h"
+#include "CesiumUtility/Tracing.h"
 #include "Components/SceneComponent.h"
 #include "Engine/World.h"
 #include "GameFramework/Actor.h"
@@ -43,11 +45,62 @@
 //
 // ## Origin Rebased
 //
-// * Detected by a call to `ApplyWorldOffset`.
+// * Detected by `FWorldDelegates::OnPreWorldOriginOffset`, which computes the
+// new Actor transforms of all registered anchors in the world in parallel, and
+// then by a call to `ApplyWorldOffset`, which applies this anchor's.
 // * Updates the Actor transform from the existing ECEF transform.
 // * Ignores `AdjustOrientationForGlobeWhenMoving` because the globe position is
 // not changing.
 
+namespace {
+// The registered anchors, so that the new Actor transforms of all of them can
+// be computed at once before a world origin is rebased, instead of one by one
+// as each Actor is shifted. Only touched on the game thread.
+TSet<UCesiumGlobeAnchorComponent*> registeredAnchors;
+FDelegateHandle preWorldOriginOffsetHandle;
+
+// Computes the relative Unreal world transform of an Actor from its globe
+// transform, for the given world OriginLocation.
+FTransform computeActorTransform(
+    const GeoTransforms& geoTransforms,
+    const glm::dmat4& actorToECEF,
+    const glm::dvec3& worldOrigin) {
+  // Transform ECEF to UE absolute world
+  const glm::dmat4& ecefToAbsoluteUnreal =
+      geoTransforms.GetEllipsoidCenteredToAbsoluteUnrealWorldTransform();
+  glm::dmat4 actorToUnreal = ecefToAbsoluteUnreal * actorToECEF;
+
+  // Transform UE absolute world to UE relative world
+  actorToUnreal[3] -= glm::dvec4(worldOrigin, 1.0);
+  actorToUnreal[3].w = 1.0;
+
+  return FTransform(VecMath::createMatrix(actorToUnreal));
+}
+
+// Adjusts the orientation of a new globe transform so that the Object is still
+// "upright" at its new position on the globe.
+glm::dmat4 adjustForGlobeCurvature(
+    const GeoTransforms& geoTransforms,
+    const glm::dmat4& oldTransform,
+    const glm::dmat4& newTransform) {
+  const glm::dvec3 oldPosition = glm::dvec3(oldTransform[3]);
+  const glm::dvec3 newPosition = glm::dvec3(newTransform[3]);
+
+  // Compute the surface normal rotation between the old and new positions.
+  const glm::dquat ellipsoidNormalRotation =
+      geoTransforms.ComputeSurfaceNormalRotation(oldPosition, newPosition);
+
+  // Adjust the new rotation by the surface normal rotation
+  const glm::dmat3 newRotation =
+      glm::mat3_cast(ellipsoidNormalRotation) * glm::dmat3(newTransform);
+  return glm::dmat4(
+      glm::dvec4(newRotation[0], 0.0),
+      glm::dvec4(newRotation[1], 0.0),
+      glm::dvec4(newRotation[2], 0.0),
+      glm::dvec4(newPosition, 1.0));
+}
+} // namespace
+
 ACesiumGeoreference* UCesiumGlobeAnchorComponent::GetGeoreference() const {
   return this->Georeference;
 }
@@ -247,6 +300,118 @@ void UCesiumGlobeAnchorComponent::InaccurateMoveToLongitudeLatitudeHeight(
       VecMath::createVector3D(TargetLongitudeLatitudeHeight));
 }
 
+void UCesiumGlobeAnchorComponent::MoveToLongitudeLatitudeHeights(
+    gsl::span<UCesiumGlobeAnchorComponent* const> Anchors,
+    gsl::span<const glm::dvec3> TargetLongitudeLatitudeHeights) {
+  CESIUM_TRACE("UCesiumGlobeAnchorComponent::MoveToLongitudeLatitudeHeights");
+
+  if (Anchors.size() != TargetLongitudeLatitudeHeights.size()) {
+    UE_LOG(
+        LogCesium,
+        Error,
+        TEXT(
+            "Cannot move %d globe anchors to %d globe positions, there must be one position per anchor."),
+        int32(Anchors.size()),
+        int32(TargetLongitudeLatitudeHeights.size()));
+    return;
+  }
+
+  struct Move {
+    UCesiumGlobeAnchorComponent* pAnchor;
+    USceneComponent* pOwnerRoot;
+    const GeoTransforms* pGeoTransforms;
+    glm::dvec3 worldOrigin;
+    glm::dvec3 longitudeLatitudeHeight;
+    glm::dmat4 actorToECEF;
+    FTransform actorTransform;
+  };
+
+  TArray<Move> moves;
+  moves.Reserve(int32(Anchors.size()));
+
+  for (size_t i = 0; i < Anchors.size(); ++i) {
+    UCesiumGlobeAnchorComponent* pAnchor = Anchors[i];
+    if (!IsValid(pAnchor)) {
+      continue;
+    }
+
+    const AActor* pOwner = pAnchor->GetOwner();
+    USceneComponent* pOwnerRoot =
+        IsValid(pOwner) ? pOwner->GetRootComponent() : nullptr;
+    if (!pAnchor->_actorToECEFIsValid ||
+        !IsValid(pAnchor->ResolvedGeoreference) || !IsValid(pOwnerRoot)) {
+      // Let the one-by-one move handle, or report, whatever keeps this anchor
+      // from being moved along with the others.
+      pAnchor->MoveToLongitudeLatitudeHeight(
+          TargetLongitudeLatitudeHeights[i]);
+      continue;
+    }
+
+    Move& move = moves.Emplace_GetRef();
+    move.pAnchor = pAnchor;
+    move.pOwnerRoot = pOwnerRoot;
+    move.pGeoTransforms = &pAnchor->ResolvedGeoreference->GetGeoTransforms();
+    move.worldOrigin =
+        glm::dvec3(CesiumActors::getWorldOrigin4D(pAnchor->GetOwner()));
+    move.longitudeLatitudeHeight = TargetLongitudeLatitudeHeights[i];
+  }
+
+  // The transform math only reads the anchors, so it can run in parallel.
+  ParallelFor(moves.Num(), [&moves](int32 i) {
+    Move& move = moves[i];
+    const UCesiumGlobeAnchorComponent* pAnchor = move.pAnchor;
+    const GeoTransforms& geoTransforms = *move.pGeoTransforms;
+
+    glm::dmat4 transform = pAnchor->_actorToECEF;
+    transform[3] = glm::dvec4(
+        geoTransforms.TransformLongitudeLatitudeHeightToEcef(
+            move.longitudeLatitudeHeight),
+        1.0);
+    if (pAnchor->AdjustOrientationForGlobeWhenMoving) {
+      transform = adjustForGlobeCurvature(
+          geoTransforms,
+          pAnchor->_actorToECEF,
+          transform);
+    }
+
+    move.actorToECEF = transform;
+    move.actorTransform =
+        computeActorTransform(geoTransforms, transform, move.worldOrigin);
+  });
+
+  // Setting the Actor transforms updates the scene, so it has to happen here
+  // on the game thread.
+  for (Move& move : moves) {
+    UCesiumGlobeAnchorComponent* pAnchor = move.pAnchor;
+
+#if WITH_EDITOR
+    // In the Editor, mark this component modified so Undo works properly.
+    pAnchor->Modify();
+#endif
+
+    pAnchor->_actorToECEF = move.actorToECEF;
+    pAnchor->_updateCartesianProperties();
+    pAnchor->_invalidateCartographicProperties();
+    pAnchor->_setActorTransform(move.pOwnerRoot, move.actorTransform);
+  }
+}
+
+void UCesiumGlobeAnchorComponent::InaccurateMoveToLongitudeLatitudeHeights(
+    const TArray<UCesiumGlobeAnchorComponent*>& Anchors,
+    const TArray<FVector>& TargetLongitudeLatitudeHeights) {
+  TArray<glm::dvec3> targets;
+  targets.Reserve(TargetLongitudeLatitudeHeights.Num());
+  for (const FVector& target : TargetLongitudeLatitudeHeights) {
+    targets.Add(VecMath::createVector3D(target));
+  }
+
+  MoveToLongitudeLatitudeHeights(
+      gsl::span<UCesiumGlobeAnchorComponent* const>(
+          Anchors.GetData(),
+          size_t(Anchors.Num())),
+      gsl::span<const glm::dvec3>(targets.GetData(), size_t(targets.Num())));
+}
+
 void UCesiumGlobeAnchorComponent::ApplyWorldOffset(
     const FVector& InOffset,
     bool bWorldShift) {
@@ -274,6 +439,21 @@ void UCesiumGlobeAnchorComponent::ApplyWorldOffset(
     return;
   }
 
+  // Usually, the new Actor transform was already computed along with those of
+  // all other anchors in the world in _onPreWorldOriginOffset.
+  if (this->_rebasedActorTransform &&
+      pWorld->OriginLocation == this->_rebasedFromWorldOrigin) {
+    const AActor* pOwner = this->GetOwner();
+    USceneComponent* pOwnerRoot =
+        IsValid(pOwner) ? pOwner->GetRootComponent() : nullptr;
+    if (IsValid(pOwnerRoot)) {
+      this->_setActorTransform(pOwnerRoot, *this->_rebasedActorTransform);
+      this->_rebasedActorTransform.reset();
+      return;
+    }
+  }
+  this->_rebasedActorTransform.reset();
+
   // Compute the position that the world origin will have
   // after the rebase, indeed by SUBTRACTING the offset
   const glm::dvec3 oldWorldOriginLocation =
@@ -287,6 +467,11 @@ void UCesiumGlobeAnchorComponent::ApplyWorldOffset(
 }
 
 void UCesiumGlobeAnchorComponent::Serialize(FArchive& Ar) {
+  if (Ar.IsSaving() && this->_cartographicPropertiesAreStale &&
+      IsValid(this->ResolvedGeoreference)) {
+    this->_updateCartographicProperties();
+  }
+
   Super::Serialize(Ar);
 
   Ar.UsingCustomVersion(FCesiumCustomVersion::GUID);
@@ -359,6 +544,13 @@ void UCesiumGlobeAnchorComponent::OnRegister() {
         &UCesiumGlobeAnchorComponent::_onActorTransformChanged);
   }
 
+  if (registeredAnchors.Num() == 0) {
+    preWorldOriginOffsetHandle =
+        FWorldDelegates::OnPreWorldOriginOffset.AddStatic(
+            &UCesiumGlobeAnchorComponent::_onPreWorldOriginOffset);
+  }
+  registeredAnchors.Add(this);
+
   // Resolve the georeference, which will also subscribe to the new georeference
   // (if there is one) and call _onGeoreferenceChanged.
   // This will update the actor transform with the globe position, but only if
@@ -378,6 +570,13 @@ void UCesiumGlobeAnchorComponent::OnUnregister() {
   // Unsubscribe from the ResolvedGeoreference.
   this->InvalidateResolvedGeoreference();
 
+  registeredAnchors.Remove(this);
+  if (registeredAnchors.Num() == 0 && preWorldOriginOffsetHandle.IsValid()) {
+    FWorldDelegates::OnPreWorldOriginOffset.Remove(preWorldOriginOffsetHandle);
+    preWorldOriginOffsetHandle.Reset();
+  }
+  this->_rebasedActorTransform.reset();
+
   // Unsubscribe from the TransformUpdated event.
   const AActor* pOwner = this->GetOwner();
   if (!IsValid(pOwner)) {
@@ -461,6 +660,57 @@ void UCesiumGlobeAnchorComponent::_onActorTransformChanged(
   this->_updateGlobeTransformFromActorTransform();
 }
 
+void UCesiumGlobeAnchorComponent::_onPreWorldOriginOffset(
+    UWorld* InWorld,
+    FIntVector InSrcOrigin,
+    FIntVector InDstOrigin) {
+  CESIUM_TRACE("UCesiumGlobeAnchorComponent::_onPreWorldOriginOffset");
+
+  struct Rebase {
+    UCesiumGlobeAnchorComponent* pAnchor;
+    const GeoTransforms* pGeoTransforms;
+  };
+
+  TArray<Rebase> rebases;
+  for (UCesiumGlobeAnchorComponent* pAnchor : registeredAnchors) {
+    pAnchor->_rebasedActorTransform.reset();
+    if (pAnchor->GetWorld() == InWorld && pAnchor->_actorToECEFIsValid &&
+        IsValid(pAnchor->ResolvedGeoreference)) {
+      rebases.Add(
+          {pAnchor, &pAnchor->ResolvedGeoreference->GetGeoTransforms()});
+    }
+  }
+
+  const glm::dvec3 newWorldOrigin = VecMath::createVector3D(InDstOrigin);
+
+  ParallelFor(rebases.Num(), [&rebases, &newWorldOrigin, InSrcOrigin](int32 i) {
+    UCesiumGlobeAnchorComponent* pAnchor = rebases[i].pAnchor;
+    pAnchor->_rebasedActorTransform = computeActorTransform(
+        *rebases[i].pGeoTransforms,
+        pAnchor->_actorToECEF,
+        newWorldOrigin);
+    pAnchor->_rebasedFromWorldOrigin = InSrcOrigin;
+  });
+}
+
+void UCesiumGlobeAnchorComponent::_setActorTransform(
+    USceneComponent* pOwnerRoot,
+    const FTransform& actorTransform) {
+#if WITH_EDITOR
+  // In the Editor, mark the root component modified so Undo works properly.
+  pOwnerRoot->Modify();
+#endif
+
+  this->_updatingActorTransform = true;
+  pOwnerRoot->SetWorldTransform(
+      actorTransform,
+      false,
+      nullptr,
+      this->TeleportWhenUpdatingTransform ? ETeleportType::TeleportPhysics
+                                          : ETeleportType::None);
+  this->_updatingActorTransform = false;
+}
+
 void UCesiumGlobeAnchorComponent::_onGeoreferenceChanged() {
   if (this->_actorToECEFIsValid) {
     this->_updateActorTransformFromGlobeTransform();
@@ -520,7 +770,7 @@ UCesiumGlobeAnchorComponent::_updateGlobeTransformFromActorTransform() {
   this->_actorToECEFIsValid = true;
 
   this->_updateCartesianProperties();
-  this->_updateCartographicProperties();
+  this->_invalidateCartographicProperties();
 
 #if WITH_EDITOR
   // In the Editor, mark this component modified so Undo works properly.
@@ -566,32 +816,14 @@ FTransform UCesiumGlobeAnchorComponent::_updateActorTransformFromGlobeTransform(
   const GeoTransforms& geoTransforms =
       this->ResolveGeoreference()->GetGeoTransforms();
 
-  // Transform ECEF to UE absolute world
-  const glm::dmat4& ecefToAbsoluteUnreal =
-      geoTransforms.GetEllipsoidCenteredToAbsoluteUnrealWorldTransform();
-  glm::dmat4 actorToUnreal = ecefToAbsoluteUnreal * this->_actorToECEF;
-
-  // Transform UE absolute world to UE relative world
-  actorToUnreal[3] -= newWorldOrigin ? glm::dvec4(*newWorldOrigin, 1.0)
-                                     : CesiumActors::getWorldOrigin4D(pOwner);
-  actorToUnreal[3].w = 1.0;
-
-  FTransform actorTransform = FTransform(VecMath::createMatrix(actorToUnreal));
-
-#if WITH_EDITOR
-  // In the Editor, mark the root component modified so Undo works properly.
-  pOwnerRoot->Modify();
-#endif
+  const glm::dvec3 worldOrigin =
+      newWorldOrigin ? *newWorldOrigin
+                     : glm::dvec3(CesiumActors::getWorldOrigin4D(pOwner));
+  FTransform actorTransform =
+      computeActorTransform(geoTransforms, this->_actorToECEF, worldOrigin);
 
   // Set the Actor transform
-  this->_updatingActorTransform = true;
-  pOwnerRoot->SetWorldTransform(
-      actorTransform,
-      false,
-      nullptr,
-      this->TeleportWhenUpdatingTransform ? ETeleportType::TeleportPhysics
-                                          : ETeleportType::None);
-  this->_updatingActorTransform = false;
+  this->_setActorTransform(pOwnerRoot, actorTransform);
 
   return actorTransform;
 }
@@ -613,27 +845,12 @@ const glm::dmat4& UCesiumGlobeAnchorComponent::_setGlobeTransform(
     return this->_actorToECEF;
   }
 
-  // Save the old position and apply the new transform.
-  const glm::dvec3 oldPosition = glm::dvec3(this->_actorToECEF[3]);
-  const glm::dvec3 newPosition = glm::dvec3(newTransform[3]);
-
   // Adjust the orientation so that the Object is still "upright" at the new
   // position on the globe.
-
-  // Compute the surface normal rotation between the old and new positions.
-  const glm::dquat ellipsoidNormalRotation =
-      this->ResolveGeoreference()
-          ->GetGeoTransforms()
-          .ComputeSurfaceNormalRotation(oldPosition, newPosition);
-
-  // Adjust the new rotation by the surface normal rotation
-  glm::dmat3 newRotation =
-      glm::mat3_cast(ellipsoidNormalRotation) * glm::dmat3(newTransform);
-  this->_actorToECEF = glm::dmat4(
-      glm::dvec4(newRotation[0], 0.0),
-      glm::dvec4(newRotation[1], 0.0),
-      glm::dvec4(newRotation[2], 0.0),
-      glm::dvec4(newPosition, 1.0));
+  this->_actorToECEF = adjustForGlobeCurvature(
+      this->ResolveGeoreference()->GetGeoTransforms(),
+      this->_actorToECEF,
+      newTransform);
 
   // Update the Actor transform from the new globe transform.
   this->_updateActorTransformFromGlobeTransform();
@@ -658,7 +875,7 @@ void UCesiumGlobeAnchorComponent::_applyCartesianProperties() {
   transform[3] = glm::dvec4(this->ECEF_X, this->ECEF_Y, this->ECEF_Z, 1.0);
   this->_setGlobeTransform(transform);
 
-  this->_updateCartographicProperties();
+  this->_invalidateCartographicProperties();
 }
 
 void UCesiumGlobeAnchorComponent::_updateCartesianProperties() {
@@ -726,4 +943,13 @@ void UCesiumGlobeAnchorComponent::_updateCartographicProperties() {
   this->Longitude = llh.x;
   this->Latitude = llh.y;
   this->Height = llh.z;
+  this->_cartographicPropertiesAreStale = false;
+}
+
+void UCesiumGlobeAnchorComponent::_invalidateCartographicProperties() {
+#if WITH_EDITOR
+  this->_updateCartographicProperties();
+#else
+  this->_cartographicPropertiesAreStale = true;
+#endif
 }
@@ -2,6 +2,7 @@
 
 #include "CesiumGltfComponent.h"
 #include "Async/Async.h"
+#include "Async/ParallelFor.h"
 #include "Cesium3DTilesSelection/GltfContent.h"
 #include "Cesium3DTilesSelection/RasterOverlay.h"
 #include "Cesium3DTilesSelection/RasterOverlayTile.h"
@@ -12,15 +13,30 @@
 #include "CesiumGltf/ExtensionMeshPrimitiveExtFeatureMetadata.h"
 #include "CesiumGltf/ExtensionModelExtFeatureMetadata.h"
 #include "CesiumGltf/TextureInfo.h"
+#include "CesiumConversionBenchmark.h"
+#include "CesiumConvertedModel.h"
+#include "CesiumDistanceField.h"
+#include "CesiumFarFieldProxy.h"
 #include "CesiumGltfPrimitiveComponent.h"
+#include "CesiumGltfPrimitivePool.h"
+#include "CesiumHeightfield.h"
+#include "CesiumLifetime.h"
 #include "CesiumMaterialUserData.h"
+#include "CesiumMeshOptimization.h"
 #include "CesiumRasterOverlays.h"
 #include "CesiumRuntime.h"
+#include "CesiumRuntimeStats.h"
+#include "CesiumScratchArray.h"
 #include "CesiumTextureUtility.h"
+#include "CesiumTileBatchComponent.h"
+#include "CesiumTilesetMemoryStatistics.h"
 #include "CesiumTransforms.h"
+#include "CesiumTriangleBVH.h"
 #include "CesiumUtility/Tracing.h"
 #include "CesiumUtility/joinToString.h"
+#include "CesiumWaterMaskAtlas.h"
 #include "CreateModelOptions.h"
+#include "DistanceFieldAtlas.h"
 #include "Engine/CollisionProfile.h"
 #include "Engine/StaticMesh.h"
 #include "HttpModule.h"
@@ -29,6 +45,7 @@
 #include "Materials/Material.h"
 #include "Materials/MaterialInstanceDynamic.h"
 #include "MeshTypes.h"
+#include "PhysicsEngine/BodyInstance.h"
 #include "PhysicsEngine/BodySetup.h"
 #include "PixelFormat.h"
 #include "Runtime/Launch/Resources/Version.h"
@@ -41,9 +58,16 @@
 #include <glm/gtc/quaternion.hpp>
 #include <glm/mat3x3.hpp>
 #include <iostream>
+#include <map>
+#include <memory>
+#include <type_traits>
+#include <unordered_set>
 
 #if PHYSICS_INTERFACE_PHYSX
 #include "IPhysXCooking.h"
+#include "IPhysXCookingModule.h"
+#include "PhysXIncludes.h"
+#include "PhysXPublicCore.h"
 #else
 #include "Chaos/AABBTree.h"
 #include "Chaos/CollisionConvexMesh.h"
@@ -54,6 +78,10 @@
 #include "ScopedTransaction.h"
 #endif
 
+#if CESIUM_BUILD_NANITE
+#include "NaniteBuilder.h"
+#endif
+
 using namespace CesiumGltf;
 
 namespace {
@@ -81,15 +109,199 @@ template <class T> struct IsAccessorView<T> : std::false_type {};
 template <class T>
 struct IsAccessorView<CesiumGltf::AccessorView<T>> : std::true_type {};
 
+template <typename T> class StridedAccessor;
+
+template <class T>
+struct IsAccessorView<StridedAccessor<T>> : std::true_type {};
+
+template <class T> struct IsMeshVector : std::false_type {};
+template <> struct IsMeshVector<TMeshVector2> : std::true_type {};
+template <> struct IsMeshVector<TMeshVector3> : std::true_type {};
+template <> struct IsMeshVector<TMeshVector4> : std::true_type {};
+
+/**
+ * Converts a component of a quantized accessor (KHR_mesh_quantization) to a
+ * float, mapping it to [0, 1] or [-1, 1] if the accessor is normalized.
+ */
+template <typename TComponent>
+static float dequantizeComponent(TComponent value, bool normalized) {
+  if constexpr (std::is_integral_v<TComponent>) {
+    if (normalized) {
+      return FMath::Max(
+          float(value) / float(std::numeric_limits<TComponent>::max()),
+          -1.0f);
+    }
+  }
+  return float(value);
+}
+
+/**
+ * Expands the elements of a quantized accessor into a vector of floats. The
+ * accessor must have the same number of components as TMeshVectorN.
+ */
+template <typename TMeshVectorN> struct DequantizeVisitor {
+  bool normalized;
+  std::vector<TMeshVectorN>& values;
+
+  bool operator()(AccessorView<nullptr_t>&& invalidView) { return false; }
+
+  template <typename TElementView> bool operator()(TElementView&& view) {
+    if (view.status() != CesiumGltf::AccessorViewStatus::Valid) {
+      return false;
+    }
+
+    using TElement = std::decay_t<decltype(view[0])>;
+    constexpr size_t numComponents = sizeof(TMeshVectorN) / sizeof(float);
+    constexpr size_t numElementComponents =
+        sizeof(TElement::value) / sizeof(TElement::value[0]);
+    if constexpr (numComponents != numElementComponents) {
+      return false;
+    } else {
+      this->values.resize(view.size());
+      for (int64_t i = 0; i < view.size(); ++i) {
+        for (size_t j = 0; j < numComponents; ++j) {
+          this->values[i][j] =
+              dequantizeComponent(view[i].value[j], this->normalized);
+        }
+      }
+      return true;
+    }
+  }
+};
+
+/**
+ * An unchecked view of the elements of a glTF accessor, read directly from its
+ * buffer. It has the same interface as an AccessorView, but without the
+ * bounds check on each element access, so callers must check their indices
+ * against the size up front.
+ *
+ * Vertex attributes of the float vector types may also be read from quantized
+ * accessors (KHR_mesh_quantization). Those are expanded to floats once, when
+ * the view is created.
+ */
+template <typename T> class StridedAccessor {
+public:
+  StridedAccessor() = default;
+
+  StridedAccessor(const Model& model, const Accessor& accessor) {
+    if constexpr (IsMeshVector<T>::value) {
+      if (accessor.componentType != Accessor::ComponentType::FLOAT) {
+        this->dequantize(model, accessor);
+        return;
+      }
+    }
+
+    this->_status = CesiumGltf::AccessorView<T>(model, accessor).status();
+    if (this->_status != CesiumGltf::AccessorViewStatus::Valid) {
+      return;
+    }
+
+    const BufferView& bufferView = model.bufferViews[accessor.bufferView];
+    const Buffer& buffer = model.buffers[bufferView.buffer];
+    this->_pData =
+        buffer.cesium.data.data() + bufferView.byteOffset + accessor.byteOffset;
+    this->_stride = accessor.computeByteStride(model);
+    this->_size = accessor.count;
+  }
+
+  StridedAccessor(const Model& model, int32_t accessorID) {
+    const Accessor* pAccessor = Model::getSafe(&model.accessors, accessorID);
+    if (pAccessor) {
+      *this = StridedAccessor(model, *pAccessor);
+    }
+  }
+
+  const T& operator[](int64_t i) const {
+    return *reinterpret_cast<const T*>(this->_pData + i * this->_stride);
+  }
+
+  int64_t size() const { return this->_size; }
+
+  CesiumGltf::AccessorViewStatus status() const { return this->_status; }
+
+private:
+  void dequantize(const Model& model, const Accessor& accessor) {
+    const std::string& expectedType = sizeof(T) == sizeof(TMeshVector2)
+                                          ? Accessor::Type::VEC2
+                                      : sizeof(T) == sizeof(TMeshVector3)
+                                          ? Accessor::Type::VEC3
+                                          : Accessor::Type::VEC4;
+    if (accessor.type != expectedType) {
+      this->_status = CesiumGltf::AccessorViewStatus::WrongSizeT;
+      return;
+    }
+
+    auto pValues = std::make_shared<std::vector<T>>();
+    bool valid = CesiumGltf::createAccessorView(
+        model,
+        accessor,
+        DequantizeVisitor<T>{accessor.normalized, *pValues});
+    if (!valid) {
+      this->_status = CesiumGltf::AccessorViewStatus::WrongSizeT;
+      return;
+    }
+
+    this->_status = CesiumGltf::AccessorViewStatus::Valid;
+    this->_pData = reinterpret_cast<const std::byte*>(pValues->data());
+    this->_stride = sizeof(T);
+    this->_size = static_cast<int64_t>(pValues->size());
+    this->_pDequantized = std::move(pValues);
+  }
+
+  const std::byte* _pData = nullptr;
+  int64_t _stride = 0;
+  int64_t _size = 0;
+  CesiumGltf::AccessorViewStatus _status =
+      CesiumGltf::AccessorViewStatus::InvalidAccessorIndex;
+
+  // The expanded elements of a quantized accessor, shared between copies.
+  std::shared_ptr<const std::vector<T>> _pDequantized;
+};
+
+/**
+ * The glTF accessors of the vertex attributes of a primitive that are copied
+ * into its vertex buffers.
+ */
+struct VertexAttributeSources {
+  StridedAccessor<TMeshVector3> positions;
+  StridedAccessor<TMeshVector3> normals;
+  StridedAccessor<TMeshVector4> tangents;
+
+  // The texture coordinate accessor for each UV channel. Channels whose
+  // accessor is invalid have a size of 0, and are filled with zeros.
+  TArray<StridedAccessor<TMeshVector2>> uvs;
+};
+
+/**
+ * Determines whether the texture coordinates of a primitive can be stored at
+ * half precision. That is accurate to within 1/2048 of a texture's size for
+ * coordinates between -2 and 2, which covers the texture coordinates of
+ * raster overlays and of most non-repeating glTF textures.
+ */
+static bool canUseHalfPrecisionUVs(const VertexAttributeSources& sources) {
+  if (!GVertexElementTypeSupport.IsSupported(VET_Half2)) {
+    return false;
+  }
+
+  for (const StridedAccessor<TMeshVector2>& uvAccessor : sources.uvs) {
+    for (int64_t i = 0; i < uvAccessor.size(); ++i) {
+      const TMeshVector2& uv = uvAccessor[i];
+      if (FMath::Abs(uv.X) > 2.0f || FMath::Abs(uv.Y) > 2.0f) {
+        return false;
+      }
+    }
+  }
+
+  return true;
+}
+
 template <class T>
 static uint32_t updateTextureCoordinates(
     const CesiumGltf::Model& model,
     const CesiumGltf::MeshPrimitive& primitive,
-    bool duplicateVertices,
-    TArray<FStaticMeshBuildVertex>& vertices,
-    const TArray<uint32>& indices,
     const std::optional<T>& texture,
-    std::unordered_map<uint32_t, uint32_t>& textureCoordinateMap) {
+    std::unordered_map<uint32_t, uint32_t>& textureCoordinateMap,
+    VertexAttributeSources& sources) {
   if (!texture) {
     return 0;
   }
@@ -97,21 +309,23 @@ static uint32_t updateTextureCoordinates(
   return updateTextureCoordinates(
       model,
       primitive,
-      duplicateVertices,
-      vertices,
-      indices,
       "TEXCOORD_" + std::to_string(texture.value().texCoord),
-      textureCoordinateMap);
+      textureCoordinateMap,
+      sources);
 }
 
+/**
+ * Assigns a UV channel to the texture coordinates with the given attribute
+ * name, unless they already have one, and returns the channel. The texture
+ * coordinates are copied into the channel later, along with the other vertex
+ * attributes.
+ */
 uint32_t updateTextureCoordinates(
     const CesiumGltf::Model& model,
     const CesiumGltf::MeshPrimitive& primitive,
-    bool duplicateVertices,
-    TArray<FStaticMeshBuildVertex>& vertices,
-    const TArray<uint32>& indices,
     const std::string& attributeName,
-    std::unordered_map<uint32_t, uint32_t>& textureCoordinateMap) {
+    std::unordered_map<uint32_t, uint32_t>& textureCoordinateMap,
+    VertexAttributeSources& sources) {
   auto uvAccessorIt = primitive.attributes.find(attributeName);
   if (uvAccessorIt == primitive.attributes.end()) {
     // Texture not used, texture coordinates don't matter.
@@ -128,46 +342,78 @@ uint32_t updateTextureCoordinates(
   size_t textureCoordinateIndex = textureCoordinateMap.size();
   textureCoordinateMap[uvAccessorID] = textureCoordinateIndex;
 
-  CesiumGltf::AccessorView<TMeshVector2> uvAccessor(model, uvAccessorID);
+  StridedAccessor<TMeshVector2> uvAccessor(model, uvAccessorID);
+  sources.uvs.Add(uvAccessor);
   if (uvAccessor.status() != CesiumGltf::AccessorViewStatus::Valid) {
     return 0;
   }
 
-  if (duplicateVertices) {
-    for (int64_t i = 0; i < indices.Num(); ++i) {
-      FStaticMeshBuildVertex& vertex = vertices[i];
-      uint32 vertexIndex = indices[i];
-      if (vertexIndex >= 0 && vertexIndex < uvAccessor.size()) {
-        vertex.UVs[textureCoordinateIndex] = uvAccessor[vertexIndex];
-      } else {
-        vertex.UVs[textureCoordinateIndex] = TMeshVector2(0.0f, 0.0f);
-      }
-    }
-  } else {
-    for (int64_t i = 0; i < vertices.Num(); ++i) {
-      FStaticMeshBuildVertex& vertex = vertices[i];
-      if (i >= 0 && i < uvAccessor.size()) {
-        vertex.UVs[textureCoordinateIndex] = uvAccessor[i];
-      } else {
-        vertex.UVs[textureCoordinateIndex] = TMeshVector2(0.0f, 0.0f);
-      }
-    }
-  }
-
   return textureCoordinateIndex;
 }
 
+/**
+ * Sets the tangent basis of a vertex from its normal and its glTF tangent,
+ * whose W component is the sign of the bitangent.
+ */
+static void setVertexTangents(
+    FStaticMeshVertexBuffer& meshBuffer,
+    uint32 vertexIndex,
+    const TMeshVector3& normal,
+    const TMeshVector4& tangent) {
+  TMeshVector3 tangentX(tangent.X, tangent.Y, tangent.Z);
+  meshBuffer.SetVertexTangents(
+      vertexIndex,
+      tangentX,
+      TMeshVector3::CrossProduct(normal, tangentX) * tangent.W,
+      normal);
+}
+
+/**
+ * Computes the normal of the triangle that starts at the given vertex of a
+ * primitive with duplicated vertices.
+ */
+static TMeshVector3
+computeFlatNormal(const FPositionVertexBuffer& positions, uint32 firstVertex) {
+  const TMeshVector3& p0 = positions.VertexPosition(firstVertex);
+  const TMeshVector3& p1 = positions.VertexPosition(firstVertex + 1);
+  const TMeshVector3& p2 = positions.VertexPosition(firstVertex + 2);
+  return TMeshVector3::CrossProduct(p1 - p0, p2 - p0).GetSafeNormal();
+}
+
+/**
+ * The data needed by mikktspace to compute the tangents of a range of the
+ * faces of a primitive with duplicated vertices, read from the glTF accessors
+ * and the vertex buffers.
+ */
+struct MikkTSpaceData {
+  const VertexAttributeSources& sources;
+  const TArray<uint32>& indices;
+  FStaticMeshVertexBuffers& buffers;
+  int32 firstFace;
+  int32 numFaces;
+
+  TMeshVector3 getNormal(uint32 vertexIndex) const {
+    if (this->sources.normals.status() ==
+        CesiumGltf::AccessorViewStatus::Valid) {
+      return this->sources.normals[this->indices[vertexIndex]];
+    }
+    return computeFlatNormal(
+        this->buffers.PositionVertexBuffer,
+        vertexIndex - vertexIndex % 3);
+  }
+};
+
 static int mikkGetNumFaces(const SMikkTSpaceContext* Context) {
-  TArray<FStaticMeshBuildVertex>& vertices =
-      *reinterpret_cast<TArray<FStaticMeshBuildVertex>*>(Context->m_pUserData);
-  return vertices.Num() / 3;
+  const MikkTSpaceData& data =
+      *reinterpret_cast<const MikkTSpaceData*>(Context->m_pUserData);
+  return data.numFaces;
 }
 
 static int
 mikkGetNumVertsOfFace(const SMikkTSpaceContext* Context, const int FaceIdx) {
-  TArray<FStaticMeshBuildVertex>& vertices =
-      *reinterpret_cast<TArray<FStaticMeshBuildVertex>*>(Context->m_pUserData);
-  return FaceIdx < (vertices.Num() / 3) ? 3 : 0;
+  const MikkTSpaceData& data =
+      *reinterpret_cast<const MikkTSpaceData*>(Context->m_pUserData);
+  return FaceIdx < data.numFaces ? 3 : 0;
 }
 
 static void mikkGetPosition(
@@ -175,9 +421,11 @@ static void mikkGetPosition(
     float Position[3],
     const int FaceIdx,
     const int VertIdx) {
-  TArray<FStaticMeshBuildVertex>& vertices =
-      *reinterpret_cast<TArray<FStaticMeshBuildVertex>*>(Context->m_pUserData);
-  const TMeshVector3& position = vertices[FaceIdx * 3 + VertIdx].Position;
+  const MikkTSpaceData& data =
+      *reinterpret_cast<const MikkTSpaceData*>(Context->m_pUserData);
+  const uint32 vertexIndex = (data.firstFace + FaceIdx) * 3 + VertIdx;
+  const TMeshVector3& position =
+      data.buffers.PositionVertexBuffer.VertexPosition(vertexIndex);
   Position[0] = position.X;
   Position[1] = position.Y;
   Position[2] = position.Z;
@@ -188,9 +436,10 @@ static void mikkGetNormal(
     float Normal[3],
     const int FaceIdx,
     const int VertIdx) {
-  TArray<FStaticMeshBuildVertex>& vertices =
-      *reinterpret_cast<TArray<FStaticMeshBuildVertex>*>(Context->m_pUserData);
-  const TMeshVector3& normal = vertices[FaceIdx * 3 + VertIdx].TangentZ;
+  const MikkTSpaceData& data =
+      *reinterpret_cast<const MikkTSpaceData*>(Context->m_pUserData);
+  TMeshVector3 normal =
+      data.getNormal((data.firstFace + FaceIdx) * 3 + VertIdx);
   Normal[0] = normal.X;
   Normal[1] = normal.Y;
   Normal[2] = normal.Z;
@@ -201,11 +450,20 @@ static void mikkGetTexCoord(
     float UV[2],
     const int FaceIdx,
     const int VertIdx) {
-  TArray<FStaticMeshBuildVertex>& vertices =
-      *reinterpret_cast<TArray<FStaticMeshBuildVertex>*>(Context->m_pUserData);
-  const TMeshVector2& uv = vertices[FaceIdx * 3 + VertIdx].UVs[0];
-  UV[0] = uv.X;
-  UV[1] = uv.Y;
+  const MikkTSpaceData& data =
+      *reinterpret_cast<const MikkTSpaceData*>(Context->m_pUserData);
+  UV[0] = 0.0f;
+  UV[1] = 0.0f;
+  if (data.sources.uvs.Num() == 0) {
+    return;
+  }
+  const StridedAccessor<TMeshVector2>& uvAccessor = data.sources.uvs[0];
+  uint32 source = data.indices[(data.firstFace + FaceIdx) * 3 + VertIdx];
+  if (source < uvAccessor.size()) {
+    const TMeshVector2& uv = uvAccessor[source];
+    UV[0] = uv.X;
+    UV[1] = uv.Y;
+  }
 }
 
 static void mikkSetTSpaceBasic(
@@ -214,16 +472,17 @@ static void mikkSetTSpaceBasic(
     const float BitangentSign,
     const int FaceIdx,
     const int VertIdx) {
-  TArray<FStaticMeshBuildVertex>& vertices =
-      *reinterpret_cast<TArray<FStaticMeshBuildVertex>*>(Context->m_pUserData);
-  FStaticMeshBuildVertex& vertex = vertices[FaceIdx * 3 + VertIdx];
-  vertex.TangentX = TMeshVector3(Tangent[0], Tangent[1], Tangent[2]);
-  vertex.TangentY =
-      BitangentSign *
-      TMeshVector3::CrossProduct(vertex.TangentZ, vertex.TangentX);
+  MikkTSpaceData& data =
+      *reinterpret_cast<MikkTSpaceData*>(Context->m_pUserData);
+  uint32 vertexIndex = (data.firstFace + FaceIdx) * 3 + VertIdx;
+  setVertexTangents(
+      data.buffers.StaticMeshVertexBuffer,
+      vertexIndex,
+      data.getNormal(vertexIndex),
+      TMeshVector4(Tangent[0], Tangent[1], Tangent[2], BitangentSign));
 }
 
-static void computeTangentSpace(TArray<FStaticMeshBuildVertex>& vertices) {
+static void computeTangentSpace(MikkTSpaceData& data) {
   SMikkTSpaceInterface MikkTInterface{};
   MikkTInterface.m_getNormal = mikkGetNormal;
   MikkTInterface.m_getNumFaces = mikkGetNumFaces;
@@ -235,40 +494,295 @@ static void computeTangentSpace(TArray<FStaticMeshBuildVertex>& vertices) {
 
   SMikkTSpaceContext MikkTContext{};
   MikkTContext.m_pInterface = &MikkTInterface;
-  MikkTContext.m_pUserData = (void*)(&vertices);
+  MikkTContext.m_pUserData = (void*)(&data);
   // MikkTContext.m_bIgnoreDegenerates = false;
   genTangSpaceDefault(&MikkTContext);
 }
 
+/**
+ * The smallest number of faces of a primitive for which mikktspace runs on
+ * multiple threads. Each thread computes the tangents of a contiguous range
+ * of at least this many faces.
+ */
+static constexpr int32 minimumFacesPerTangentTask = 8192;
+
+/**
+ * Computes the tangents of a primitive with duplicated vertices with
+ * mikktspace, on multiple threads for large primitives.
+ *
+ * mikktspace only shares tangents between the faces it is given, so the
+ * faces are split into contiguous ranges, which keeps the faces that share
+ * vertices together, since glTF primitives usually list neighboring faces
+ * together. Each range only writes the tangents of its own duplicated
+ * vertices.
+ */
+static void computeTangentSpace(
+    const VertexAttributeSources& sources,
+    const TArray<uint32>& indices,
+    FStaticMeshVertexBuffers& buffers) {
+  const int32 numFaces = indices.Num() / 3;
+  const int32 numTasks = FMath::Clamp(
+      numFaces / minimumFacesPerTangentTask,
+      1,
+      FMath::Max(FTaskGraphInterface::Get().GetNumWorkerThreads(), 1));
+  const int32 facesPerTask = FMath::DivideAndRoundUp(numFaces, numTasks);
+
+  ParallelFor(
+      numTasks,
+      [&sources, &indices, &buffers, numFaces, facesPerTask](int32 i) {
+        const int32 firstFace = i * facesPerTask;
+        MikkTSpaceData data{
+            sources,
+            indices,
+            buffers,
+            firstFace,
+            FMath::Min(facesPerTask, numFaces - firstFace)};
+        computeTangentSpace(data);
+      },
+      numTasks == 1);
+}
+
+/**
+ * Computes the tangents of a primitive with shared vertices and normals from
+ * the texture coordinates of its faces, without duplicating its vertices.
+ *
+ * The tangent and bitangent of each face are added to its vertices, weighted
+ * by its area in texture space. The tangent of each vertex is then made
+ * orthogonal to its normal, and the sign of its bitangent is found from the
+ * sum of the bitangents. Vertices that are split along texture seams in the
+ * glTF keep separate tangents, as with mikktspace.
+ *
+ * @param vertexSources The glTF vertex of each vertex of the buffers, or an
+ * empty array if they are the same.
+ */
+static void computeIndexedTangents(
+    const VertexAttributeSources& sources,
+    const TArray<uint32>& indices,
+    const TArray<uint32>& vertexSources,
+    FStaticMeshVertexBuffers& buffers) {
+  const FPositionVertexBuffer& positions = buffers.PositionVertexBuffer;
+  FStaticMeshVertexBuffer& meshBuffer = buffers.StaticMeshVertexBuffer;
+  const uint32 numVertices = positions.GetNumVertices();
+  const int32 numFaces = indices.Num() / 3;
+
+  auto getSource = [&vertexSources](uint32 vertex) {
+    return vertexSources.Num() > 0 ? vertexSources[vertex] : vertex;
+  };
+  auto getUV = [&sources, &getSource](uint32 vertex) {
+    if (sources.uvs.Num() == 0) {
+      return TMeshVector2(0.0f, 0.0f);
+    }
+    const StridedAccessor<TMeshVector2>& uvAccessor = sources.uvs[0];
+    const uint32 source = getSource(vertex);
+    return source < uvAccessor.size() ? uvAccessor[source]
+                                      : TMeshVector2(0.0f, 0.0f);
+  };
+
+  // The face tangents are computed in parallel, and added to the vertices
+  // they share afterward.
+  TArray<TMeshVector3> faceTangents;
+  TArray<TMeshVector3> faceBitangents;
+  faceTangents.SetNumUninitialized(numFaces);
+  faceBitangents.SetNumUninitialized(numFaces);
+  ParallelFor(
+      numFaces,
+      [&](int32 face) {
+        const uint32 i0 = indices[3 * face];
+        const uint32 i1 = indices[3 * face + 1];
+        const uint32 i2 = indices[3 * face + 2];
+        const TMeshVector3 edge1 =
+            positions.VertexPosition(i1) - positions.VertexPosition(i0);
+        const TMeshVector3 edge2 =
+            positions.VertexPosition(i2) - positions.VertexPosition(i0);
+        const TMeshVector2 uv0 = getUV(i0);
+        const TMeshVector2 duv1 = getUV(i1) - uv0;
+        const TMeshVector2 duv2 = getUV(i2) - uv0;
+
+        // The determinant is the signed area in texture space, which weights
+        // the face by leaving the tangents unnormalized.
+        const float determinant = duv1.X * duv2.Y - duv2.X * duv1.Y;
+        const float sign = determinant < 0.0f ? -1.0f : 1.0f;
+        faceTangents[face] = (edge1 * duv2.Y - edge2 * duv1.Y) * sign;
+        faceBitangents[face] = (edge2 * duv1.X - edge1 * duv2.X) * sign;
+      },
+      numFaces < minimumFacesPerTangentTask);
+
+  TArray<TMeshVector3> tangents;
+  TArray<TMeshVector3> bitangents;
+  tangents.SetNumZeroed(numVertices);
+  bitangents.SetNumZeroed(numVertices);
+  for (int32 face = 0; face < numFaces; ++face) {
+    for (int32 corner = 0; corner < 3; ++corner) {
+      const uint32 vertex = indices[3 * face + corner];
+      tangents[vertex] += faceTangents[face];
+      bitangents[vertex] += faceBitangents[face];
+    }
+  }
+
+  ParallelFor(
+      int32(numVertices),
+      [&](int32 vertex) {
+        const TMeshVector3& normal =
+            sources.normals[getSource(uint32(vertex))];
+        TMeshVector3 tangent =
+            tangents[vertex] - normal * (normal | tangents[vertex]);
+        if (!tangent.Normalize()) {
+          // Faces without texture coordinates get any tangent orthogonal to
+          // the normal.
+          TMeshVector3 bitangent;
+          normal.FindBestAxisVectors(tangent, bitangent);
+        }
+        const float sign =
+            ((normal ^ tangent) | bitangents[vertex]) < 0.0f ? -1.0f : 1.0f;
+        setVertexTangents(
+            meshBuffer,
+            uint32(vertex),
+            normal,
+            TMeshVector4(tangent.X, tangent.Y, tangent.Z, sign));
+      },
+      numVertices < uint32(minimumFacesPerTangentTask));
+}
+
+/**
+ * Sets flat normals on a primitive with duplicated vertices, along with its
+ * glTF tangents if it has any.
+ */
 static void computeFlatNormals(
-    const TArray<uint32_t>& indices,
-    TArray<FStaticMeshBuildVertex>& vertices) {
-  // Compute flat normals
-  for (int64_t i = 0; i < indices.Num(); i += 3) {
-    FStaticMeshBuildVertex& v0 = vertices[i];
-    FStaticMeshBuildVertex& v1 = vertices[i + 1];
-    FStaticMeshBuildVertex& v2 = vertices[i + 2];
+    const VertexAttributeSources& sources,
+    const TArray<uint32>& indices,
+    FStaticMeshVertexBuffers& buffers) {
+  bool hasTangents =
+      sources.tangents.status() == CesiumGltf::AccessorViewStatus::Valid;
+  FStaticMeshVertexBuffer& meshBuffer = buffers.StaticMeshVertexBuffer;
+  uint32 numVertices = buffers.PositionVertexBuffer.GetNumVertices();
+
+  for (uint32 i = 0; i + 2 < numVertices; i += 3) {
+    TMeshVector3 normal = computeFlatNormal(buffers.PositionVertexBuffer, i);
+    for (uint32 j = i; j < i + 3; ++j) {
+      if (hasTangents) {
+        setVertexTangents(meshBuffer, j, normal, sources.tangents[indices[j]]);
+      } else {
+        meshBuffer.SetVertexTangents(
+            j,
+            TMeshVector3(0.0f),
+            TMeshVector3(0.0f),
+            normal);
+      }
+    }
+  }
+}
+
+/**
+ * Writes the positions, normals, tangents, and texture coordinates of all
+ * vertices directly into the vertex buffers in a single pass, and returns the
+ * squared distance from the given origin to the farthest position. The
+ * buffers must already be initialized with the number of vertices and UV
+ * channels.
+ *
+ * This is specialized at compile time for each combination of attributes, so
+ * that the loop body contains no per-vertex branches other than the bounds
+ * checks of the texture coordinates. The indices must already have been
+ * checked against the number of positions.
+ */
+template <bool DuplicateVertices, bool HasNormals, bool HasTangents>
+static float copyVertexAttributesKernel(
+    const VertexAttributeSources& sources,
+    const TArray<uint32>& indices,
+    const TMeshVector3& origin,
+    FStaticMeshVertexBuffers& buffers) {
+  FPositionVertexBuffer& positions = buffers.PositionVertexBuffer;
+  FStaticMeshVertexBuffer& meshBuffer = buffers.StaticMeshVertexBuffer;
+  const uint32 numVertices = positions.GetNumVertices();
+  const uint32 numUVs = FMath::Min(
+      static_cast<uint32>(sources.uvs.Num()),
+      meshBuffer.GetNumTexCoords());
+  const TMeshVector3 zero(0.0f);
+  float maxDistanceSquared = 0.0f;
+
+  for (uint32 i = 0; i < numVertices; ++i) {
+    uint32 source = DuplicateVertices ? indices[i] : i;
+
+    const TMeshVector3& position = sources.positions[source];
+    positions.VertexPosition(i) = position;
+    maxDistanceSquared =
+        FMath::Max(maxDistanceSquared, (position - origin).SizeSquared());
+
+    if constexpr (HasTangents) {
+      setVertexTangents(
+          meshBuffer,
+          i,
+          sources.normals[source],
+          sources.tangents[source]);
+    } else if constexpr (HasNormals) {
+      meshBuffer.SetVertexTangents(i, zero, zero, sources.normals[source]);
+    } else {
+      // This placeholder is replaced by computeFlatNormals, unless the
+      // material computes the flat normals instead.
+      meshBuffer.SetVertexTangents(i, zero, zero, TMeshVector3(0, 0, 1));
+    }
+
+    if (numUVs == 0) {
+      meshBuffer.SetVertexUV(i, 0, TMeshVector2(0.0f, 0.0f));
+    }
+    for (uint32 uv = 0; uv < numUVs; ++uv) {
+      const StridedAccessor<TMeshVector2>& uvAccessor = sources.uvs[uv];
+      meshBuffer.SetVertexUV(
+          i,
+          uv,
+          source < uvAccessor.size() ? uvAccessor[source]
+                                     : TMeshVector2(0.0f, 0.0f));
+    }
+  }
+
+  return maxDistanceSquared;
+}
 
-    TMeshVector3 v01 = v1.Position - v0.Position;
-    TMeshVector3 v02 = v2.Position - v0.Position;
-    TMeshVector3 normal = TMeshVector3::CrossProduct(v01, v02);
+template <bool DuplicateVertices>
+static float copyVertexAttributes(
+    const VertexAttributeSources& sources,
+    const TArray<uint32>& indices,
+    const TMeshVector3& origin,
+    FStaticMeshVertexBuffers& buffers) {
+  bool hasNormals =
+      sources.normals.status() == CesiumGltf::AccessorViewStatus::Valid;
+  bool hasTangents =
+      sources.tangents.status() == CesiumGltf::AccessorViewStatus::Valid;
+
+  if (!hasNormals) {
+    // Tangents need the normals, so they are set along with the flat normals,
+    // after the copy.
+    return copyVertexAttributesKernel<DuplicateVertices, false, false>(
+        sources,
+        indices,
+        origin,
+        buffers);
+  }
 
-    v0.TangentX = v1.TangentX = v2.TangentX = TMeshVector3(0.0f);
-    v0.TangentY = v1.TangentY = v2.TangentY = TMeshVector3(0.0f);
-    v0.TangentZ = v1.TangentZ = v2.TangentZ = normal.GetSafeNormal();
+  if (hasTangents) {
+    return copyVertexAttributesKernel<DuplicateVertices, true, true>(
+        sources,
+        indices,
+        origin,
+        buffers);
   }
+  return copyVertexAttributesKernel<DuplicateVertices, true, false>(
+      sources,
+      indices,
+      origin,
+      buffers);
 }
 
 #if PHYSICS_INTERFACE_PHYSX
 static void BuildPhysXTriangleMeshes(
     PxTriangleMesh*& pCollisionMesh,
     const IPhysXCooking* pPhysXCooking,
-    const TArray<FStaticMeshBuildVertex>& vertexData,
-    const TArray<uint32>& indices);
+    const TArray<TMeshVector3>& positions,
+    const TArray<uint32>& indices,
+    TArray<uint8>* pCooked);
 #else
 static TSharedPtr<Chaos::FTriangleMeshImplicitObject, ESPMode::ThreadSafe>
 BuildChaosTriangleMeshes(
-    const TArray<FStaticMeshBuildVertex>& vertexData,
+    TArray<TMeshVector3>&& positions,
     const TArray<uint32>& indices);
 #endif
 
@@ -278,7 +792,7 @@ static const CesiumGltf::MaterialPBRMetallicRoughness
 
 struct ColorVisitor {
   bool duplicateVertices;
-  TArray<FStaticMeshBuildVertex>& StaticMeshBuildVertices;
+  TArray<FColor>& colors;
   const TArray<uint32>& indices;
 
   bool operator()(AccessorView<nullptr_t>&& invalidView) { return false; }
@@ -291,23 +805,21 @@ struct ColorVisitor {
     bool success = true;
     if (duplicateVertices) {
       for (int64_t i = 0; success && i < this->indices.Num(); ++i) {
-        FStaticMeshBuildVertex& vertex = this->StaticMeshBuildVertices[i];
         uint32 vertexIndex = this->indices[i];
         if (vertexIndex >= colorView.size()) {
           success = false;
         } else {
-          success =
-              ColorVisitor::convertColor(colorView[vertexIndex], vertex.Color);
+          success = ColorVisitor::convertColor(
+              colorView[vertexIndex],
+              this->colors[i]);
         }
       }
     } else {
-      for (int64_t i = 0; success && i < this->StaticMeshBuildVertices.Num();
-           ++i) {
-        FStaticMeshBuildVertex& vertex = this->StaticMeshBuildVertices[i];
+      for (int64_t i = 0; success && i < this->colors.Num(); ++i) {
         if (i >= colorView.size()) {
           success = false;
         } else {
-          success = ColorVisitor::convertColor(colorView[i], vertex.Color);
+          success = ColorVisitor::convertColor(colorView[i], this->colors[i]);
         }
       }
     }
@@ -358,9 +870,19 @@ struct ColorVisitor {
   }
 };
 
+/**
+ * Gets the loaded texture referenced by the given glTF texture info, or
+ * nullptr if there is none.
+ *
+ * @param model The model.
+ * @param textures The textures of the model, by index, as returned by
+ * loadTextures.
+ * @param gltfTexture The glTF texture info, which may be absent.
+ */
 template <class T>
-static CesiumTextureUtility::LoadedTextureResult* loadTexture(
+static CesiumTextureUtility::LoadedTextureResult* findTexture(
     const CesiumGltf::Model& model,
+    const std::vector<CesiumTextureUtility::LoadedTextureResult*>& textures,
     const std::optional<T>& gltfTexture) {
   if (!gltfTexture || gltfTexture.value().index < 0 ||
       gltfTexture.value().index >= model.textures.size()) {
@@ -375,16 +897,38 @@ static CesiumTextureUtility::LoadedTextureResult* loadTexture(
     return nullptr;
   }
 
-  const CesiumGltf::Texture& texture =
-      model.textures[gltfTexture.value().index];
+  return textures[gltfTexture.value().index];
+}
+
+/**
+ * Copies the texels of the given water mask image into the result, for the
+ * water mask atlas. Returns false if the image doesn't fit in the atlas.
+ */
+static bool keepWaterMaskPixels(
+    const CesiumGltf::ImageCesium& image,
+    LoadPrimitiveResult& primitiveResult) {
+  if (image.channels != 1 || image.bytesPerChannel != 1 ||
+      image.width != image.height || image.width <= 0 ||
+      image.width > CesiumWaterMaskAtlas::MaximumMaskSize ||
+      image.pixelData.size() != size_t(image.width) * image.height) {
+    return false;
+  }
 
-  return CesiumTextureUtility::loadTextureAnyThreadPart(model, texture);
+  primitiveResult.waterMaskSize = image.width;
+  primitiveResult.waterMaskPixels.SetNumUninitialized(
+      image.width * image.height);
+  FMemory::Memcpy(
+      primitiveResult.waterMaskPixels.GetData(),
+      image.pixelData.data(),
+      image.pixelData.size());
+  return true;
 }
 
 static void applyWaterMask(
     const CesiumGltf::Model& model,
     const CesiumGltf::MeshPrimitive& primitive,
-    LoadPrimitiveResult& primitiveResult) {
+    LoadPrimitiveResult& primitiveResult,
+    bool packWaterMask) {
   // Initialize water mask if needed.
   auto onlyWaterIt = primitive.extras.find("OnlyWater");
   auto onlyLandIt = primitive.extras.find("OnlyLand");
@@ -406,8 +950,14 @@ static void applyWaterMask(
         waterMaskInfo.index = waterMaskTextureId;
         if (waterMaskTextureId >= 0 &&
             waterMaskTextureId < model.textures.size()) {
-          primitiveResult.waterMaskTexture =
-              loadTexture(model, std::make_optional(waterMaskInfo));
+          const int32_t source = model.textures[waterMaskTextureId].source;
+          const bool packed =
+              packWaterMask && source >= 0 && source < model.images.size() &&
+              keepWaterMaskPixels(model.images[source].cesium, primitiveResult);
+          if (!packed) {
+            primitiveResult.waterMaskTexture =
+                loadTexture(model, std::make_optional(waterMaskInfo));
+          }
         }
       }
     }
@@ -435,27 +985,139 @@ static void applyWaterMask(
   }
 }
 
-static FCesiumMetadataPrimitive loadMetadataPrimitive(
+/**
+ * The feature IDs of a primitive's first feature table, which is the first
+ * one in its FCesiumMetadataPrimitive.
+ */
+struct FirstFeatureTable {
+  int32 featureIDAccessor = -1;
+  const CesiumGltf::FeatureTable* pFeatureTable = nullptr;
+};
+
+/**
+ * Finds the first feature table of a primitive, without creating the views
+ * of its properties that FCesiumMetadataPrimitive creates.
+ */
+static FirstFeatureTable findFirstFeatureTable(
     const CesiumGltf::Model& model,
     const CesiumGltf::MeshPrimitive& primitive) {
   const CesiumGltf::ExtensionModelExtFeatureMetadata* metadata =
       model.getExtension<CesiumGltf::ExtensionModelExtFeatureMetadata>();
-  if (!metadata) {
-    return FCesiumMetadataPrimitive();
-  }
-
   const CesiumGltf::ExtensionMeshPrimitiveExtFeatureMetadata*
       primitiveMetadata = primitive.getExtension<
           CesiumGltf::ExtensionMeshPrimitiveExtFeatureMetadata>();
-  if (!primitiveMetadata) {
-    return FCesiumMetadataPrimitive();
+  if (!metadata || !primitiveMetadata) {
+    return FirstFeatureTable();
   }
 
-  return FCesiumMetadataPrimitive(
-      model,
-      primitive,
-      *metadata,
-      *primitiveMetadata);
+  for (const CesiumGltf::FeatureIDAttribute& attribute :
+       primitiveMetadata->featureIdAttributes) {
+    if (!attribute.featureIds.attribute) {
+      continue;
+    }
+
+    auto featureID =
+        primitive.attributes.find(attribute.featureIds.attribute.value());
+    if (featureID == primitive.attributes.end()) {
+      continue;
+    }
+
+    const CesiumGltf::Accessor* accessor = model.getSafe<CesiumGltf::Accessor>(
+        &model.accessors,
+        featureID->second);
+    if (!accessor || accessor->type != CesiumGltf::Accessor::Type::SCALAR) {
+      continue;
+    }
+
+    auto featureTable = metadata->featureTables.find(attribute.featureTable);
+    if (featureTable == metadata->featureTables.end()) {
+      continue;
+    }
+
+    return FirstFeatureTable{featureID->second, &featureTable->second};
+  }
+
+  return FirstFeatureTable();
+}
+
+/**
+ * Whether the faces of the given primitive must keep their order and
+ * vertices. The metadata face functions, like
+ * UCesiumMetadataPrimitiveBlueprintLibrary::GetFirstVertexIDFromFaceID, map
+ * a face index to a feature through the glTF's original triangles.
+ */
+static bool hasFaceMetadata(const CesiumGltf::MeshPrimitive& primitive) {
+  return primitive.getExtension<
+             CesiumGltf::ExtensionMeshPrimitiveExtFeatureMetadata>() !=
+         nullptr;
+}
+
+/**
+ * The largest width of a feature metadata texture. The values of the
+ * features beyond it continue on the next rows.
+ */
+static constexpr int64 maximumFeatureMetadataTextureWidth = 4096;
+
+/**
+ * Creates the texture with the values of the given properties of a feature
+ * table, which the material of a primitive uses to style its features. See
+ * ACesium3DTileset::MetadataTextureProperties for its layout.
+ *
+ * @return Whether the texture was created.
+ */
+static bool loadFeatureMetadataTexture(
+    LoadPrimitiveResult& primitiveResult,
+    const FCesiumMetadataFeatureTable& featureTable,
+    const TArray<FString>& propertyNames) {
+  CESIUM_TRACE("loadFeatureMetadataTexture");
+
+  const int64 numFeatures =
+      UCesiumMetadataFeatureTableBlueprintLibrary::GetNumberOfFeatures(
+          featureTable);
+  if (numFeatures <= 0) {
+    return false;
+  }
+
+  const int64 width =
+      FMath::Min(numFeatures, maximumFeatureMetadataTextureWidth);
+  const int64 rowsPerProperty = FMath::DivideAndRoundUp(numFeatures, width);
+  const int64 height = rowsPerProperty * propertyNames.Num();
+  if (height > int64(GetMax2DTextureDimension())) {
+    UE_LOG(
+        LogCesium,
+        Warning,
+        TEXT(
+            "The %d feature metadata properties of %lld features don't fit in a texture, so they can't be styled by the material."),
+        propertyNames.Num(),
+        numFeatures);
+    return false;
+  }
+
+  // Each column of the values is the rows of one property in the texture.
+  // The texels past the last feature get the default value.
+  CesiumScratchArray<float> valuesScratch;
+  TArray<float>& values = *valuesScratch;
+  values.SetNumUninitialized(width * height);
+  UCesiumMetadataFeatureTableBlueprintLibrary::GetPropertyValues<float>(
+      featureTable,
+      gsl::span<const FString>(propertyNames.GetData(), propertyNames.Num()),
+      0,
+      gsl::span<float>(values.GetData(), values.Num()),
+      0.0f);
+
+  primitiveResult.featureMetadataTexture =
+      CesiumTextureUtility::loadFloatTextureAnyThreadPart(
+          static_cast<int32>(width),
+          static_cast<int32>(height),
+          values.GetData());
+  if (!primitiveResult.featureMetadataTexture) {
+    return false;
+  }
+
+  primitiveResult.featureMetadataTextureWidth = static_cast<int32>(width);
+  primitiveResult.featureMetadataRowsPerProperty =
+      static_cast<int32>(rowsPerProperty);
+  return true;
 }
 
 namespace {
@@ -515,38 +1177,983 @@ FName createSafeName(
   return FName(combined.c_str());
 }
 
-} // namespace
-
-template <class TIndexAccessor>
-static void loadPrimitive(
-    LoadPrimitiveResult& primitiveResult,
-    const glm::dmat4x4& transform,
-    const CreatePrimitiveOptions& options,
-    const CesiumGltf::Accessor& positionAccessor,
-    const CesiumGltf::AccessorView<TMeshVector3>& positionView,
-    const TIndexAccessor& indicesView) {
-
-  CESIUM_TRACE("loadPrimitive<T>");
-
-  const Model& model =
-      *options.pMeshOptions->pNodeOptions->pModelOptions->pModel;
-  const Mesh& mesh = *options.pMeshOptions->pMesh;
-  const MeshPrimitive& primitive = *options.pPrimitive;
+/**
+ * @brief The names of the material parameters of a raster overlay.
+ */
+struct OverlayParameterNames {
+  FString overlayName;
+  FName texture;
+  FName translationScale;
+  FName textureCoordinateIndex;
+};
 
-  if (primitive.mode != CesiumGltf::MeshPrimitive::Mode::TRIANGLES &&
-      primitive.mode != CesiumGltf::MeshPrimitive::Mode::TRIANGLE_STRIP) {
-    // TODO: add support for primitive types other than triangles.
-    UE_LOG(
-        LogCesium,
-        Warning,
-        TEXT("Primitive mode %d is not supported"),
-        primitive.mode);
-    return;
+/**
+ * @brief Gets the names of the material parameters of the raster overlay with
+ * the given name.
+ *
+ * The names are created only the first time they are needed for each
+ * overlay, because overlay tiles are attached to and detached from every
+ * primitive of every tile as they stream. Must be called from the game
+ * thread.
+ */
+const OverlayParameterNames&
+getOverlayParameterNames(const std::string& overlayName) {
+  static std::unordered_map<std::string, OverlayParameterNames> cache;
+
+  auto it = cache.find(overlayName);
+  if (it == cache.end()) {
+    OverlayParameterNames names{
+        UTF8_TO_TCHAR(overlayName.c_str()),
+        createSafeName(overlayName, "_Texture"),
+        createSafeName(overlayName, "_TranslationScale"),
+        createSafeName(overlayName, "_TextureCoordinateIndex")};
+    it = cache.emplace(overlayName, std::move(names)).first;
   }
+  return it->second;
+}
 
-  std::string name = "glTF";
+// The names of the parameters of each overlay's material layer.
+const FName LayerTextureParameterName("Texture");
+const FName LayerTranslationScaleParameterName("TranslationScale");
+const FName LayerTextureCoordinateIndexParameterName("TextureCoordinateIndex");
 
-  auto urlIt = model.extras.find("Cesium3DTiles_TileUrl");
+} // namespace
+
+/**
+ * Copies the indices of a TRIANGLES or TRIANGLE_STRIP primitive into a list of
+ * triangles.
+ */
+template <class TIndexAccessor>
+static void copyTriangleIndices(
+    const MeshPrimitive& primitive,
+    const TIndexAccessor& indicesView,
+    TArray<uint32>& indices) {
+  if (primitive.mode == CesiumGltf::MeshPrimitive::Mode::TRIANGLES) {
+    CESIUM_TRACE("copy TRIANGLE indices");
+    indices.SetNum(static_cast<TArray<uint32>::SizeType>(indicesView.size()));
+
+    for (int32 i = 0; i < indicesView.size(); ++i) {
+      indices[i] = indicesView[i];
+    }
+  } else {
+    // assume TRIANGLE_STRIP because all others are rejected earlier.
+    CESIUM_TRACE("copy TRIANGLE_STRIP indices");
+    indices.SetNum(
+        static_cast<TArray<uint32>::SizeType>(3 * (indicesView.size() - 2)));
+    for (int32 i = 0; i < indicesView.size() - 2; ++i) {
+      if (i % 2) {
+        indices[3 * i] = indicesView[i];
+        indices[3 * i + 1] = indicesView[i + 2];
+        indices[3 * i + 2] = indicesView[i + 1];
+      } else {
+        indices[3 * i] = indicesView[i];
+        indices[3 * i + 1] = indicesView[i + 1];
+        indices[3 * i + 2] = indicesView[i + 2];
+      }
+    }
+  }
+}
+
+/**
+ * Checks that all of the given indices refer to one of the given number of
+ * vertices.
+ */
+static bool
+areIndicesInRange(const TArray<uint32>& indices, int64_t numVertices) {
+  uint32 maxIndex = 0;
+  for (uint32 index : indices) {
+    maxIndex = FMath::Max(maxIndex, index);
+  }
+  return indices.Num() == 0 || static_cast<int64_t>(maxIndex) < numVertices;
+}
+
+/**
+ * Estimates the size of a collision mesh from the size of its geometry.
+ */
+static int64 estimateCollisionBytes(
+    const TArray<TMeshVector3>& positions,
+    const TArray<uint32>& indices) {
+  return static_cast<int64>(positions.Num()) * sizeof(TMeshVector3) +
+         static_cast<int64>(indices.Num()) * sizeof(uint32);
+}
+
+/**
+ * Builds the collision mesh of the given geometry. The positions may be moved
+ * into the collision mesh, so they can't be used afterward.
+ *
+ * @param pCooked If not nullptr, receives the cooked form of the collision
+ * mesh, from which CesiumConvertedModel::readCollisionMesh can create it
+ * again, or nothing if it can't be written.
+ */
+static CesiumCollisionMesh buildCollisionMesh(
+    TArray<TMeshVector3>&& positions,
+    const TArray<uint32>& indices
+#if PHYSICS_INTERFACE_PHYSX
+    ,
+    const IPhysXCooking* pPhysXCooking
+#endif
+    ,
+    TArray<uint8>* pCooked = nullptr,
+    CesiumConversionBenchmark::Timings* pBenchmarkTimings = nullptr) {
+  CesiumConversionBenchmark::ScopedStage stage(
+      pBenchmarkTimings,
+      CesiumConversionBenchmark::Stage::Collision,
+      positions.Num(),
+      positions.Num() * sizeof(TMeshVector3) + indices.Num() * sizeof(uint32));
+
+#if PHYSICS_INTERFACE_PHYSX
+  CESIUM_TRACE("PhysX cook");
+  PxTriangleMesh* pCollisionMesh = nullptr;
+  BuildPhysXTriangleMeshes(
+      pCollisionMesh,
+      pPhysXCooking,
+      positions,
+      indices,
+      pCooked);
+  return pCollisionMesh;
+#else
+  CESIUM_TRACE("Chaos cook");
+  CesiumCollisionMesh pCollisionMesh =
+      BuildChaosTriangleMeshes(MoveTemp(positions), indices);
+  if (pCooked) {
+    CesiumConvertedModel::writeCollisionMesh(pCollisionMesh, *pCooked);
+  }
+  return pCollisionMesh;
+#endif
+}
+
+/**
+ * Computes the size of the grid cells in which to cluster the vertices of a
+ * primitive, in the coordinates of the primitive, so that no vertex moves by
+ * more than the given error in meters. Returns zero if the transform is
+ * degenerate.
+ */
+static double
+computeClusterCellSize(const glm::dmat4x4& transform, double maximumError) {
+  double scale = glm::max(
+      glm::length(glm::dvec3(transform[0])),
+      glm::max(
+          glm::length(glm::dvec3(transform[1])),
+          glm::length(glm::dvec3(transform[2]))));
+  if (scale <= 0.0) {
+    return 0.0;
+  }
+
+  // No vertex moves by more than the diagonal of a cell.
+  return maximumError / (scale * glm::sqrt(3.0));
+}
+
+/**
+ * Simplifies the geometry of a collision mesh so that no vertex moves by more
+ * than the given distance in meters, given the transform from the positions
+ * to the tileset's coordinates, which are in meters.
+ */
+static void simplifyCollisionMesh(
+    TArray<TMeshVector3>& positions,
+    TArray<uint32>& indices,
+    TArray<int32>& vertexFeatureIDs,
+    const glm::dmat4x4& transform,
+    double maximumError) {
+  CESIUM_TRACE("simplify collision mesh");
+
+  double cellSize = computeClusterCellSize(transform, maximumError);
+  if (cellSize <= 0.0) {
+    return;
+  }
+
+  TArray<uint32> originalIndices =
+      CesiumMeshOptimization::simplifyByVertexClustering(
+          indices,
+          static_cast<uint32>(positions.Num()),
+          [&positions](uint32 index) {
+            const TMeshVector3& position = positions[index];
+            return glm::dvec3(position.X, position.Y, position.Z);
+          },
+          cellSize);
+
+  TArray<TMeshVector3> simplifiedPositions;
+  simplifiedPositions.SetNumUninitialized(originalIndices.Num());
+  for (int32 i = 0; i < originalIndices.Num(); ++i) {
+    simplifiedPositions[i] = positions[originalIndices[i]];
+  }
+  positions = MoveTemp(simplifiedPositions);
+
+  if (vertexFeatureIDs.Num() > 0) {
+    TArray<int32> simplifiedFeatureIDs;
+    simplifiedFeatureIDs.SetNumUninitialized(originalIndices.Num());
+    for (int32 i = 0; i < originalIndices.Num(); ++i) {
+      simplifiedFeatureIDs[i] = vertexFeatureIDs[originalIndices[i]];
+    }
+    vertexFeatureIDs = MoveTemp(simplifiedFeatureIDs);
+  }
+}
+
+namespace {
+
+struct FeatureIDVisitor {
+  const TArray<uint32>* pVertexSources;
+  TArray<int32>& featureIDs;
+
+  // Feature IDs must be scalars.
+  template <typename T> bool operator()(const AccessorView<T>& invalidView) {
+    return false;
+  }
+
+  template <typename T>
+  bool
+  operator()(const AccessorView<AccessorTypes::SCALAR<T>>& featureIDView) {
+    if (featureIDView.status() != CesiumGltf::AccessorViewStatus::Valid) {
+      return false;
+    }
+
+    for (int32 i = 0; i < this->featureIDs.Num(); ++i) {
+      int64 source = this->pVertexSources ? (*this->pVertexSources)[i] : i;
+      if (source >= featureIDView.size()) {
+        this->featureIDs[i] = -1;
+      } else if constexpr (std::is_floating_point_v<T>) {
+        this->featureIDs[i] =
+            static_cast<int32>(glm::round(featureIDView[source].value[0]));
+      } else {
+        this->featureIDs[i] =
+            static_cast<int32>(featureIDView[source].value[0]);
+      }
+    }
+    return true;
+  }
+};
+
+} // namespace
+
+/**
+ * Gets the feature ID of each vertex of a primitive in its first feature
+ * table, or nothing if it has no feature table.
+ *
+ * @param pVertexSources The glTF vertex of each vertex, or nullptr if they
+ * are the same.
+ */
+static void getVertexFeatureIDs(
+    const CesiumGltf::Model& model,
+    const FirstFeatureTable& featureTable,
+    uint32 numVertices,
+    const TArray<uint32>* pVertexSources,
+    TArray<int32>& vertexFeatureIDs) {
+  if (!featureTable.pFeatureTable) {
+    return;
+  }
+
+  CESIUM_TRACE("get vertex feature IDs");
+  vertexFeatureIDs.SetNumUninitialized(numVertices);
+  if (!CesiumGltf::createAccessorView(
+          model,
+          featureTable.featureIDAccessor,
+          FeatureIDVisitor{pVertexSources, vertexFeatureIDs})) {
+    vertexFeatureIDs.Empty();
+  }
+}
+
+/**
+ * Determines whether the loading of a model was canceled because it is no
+ * longer needed.
+ */
+static bool isCanceled(const CreateModelOptions& options) {
+  return options.pCanceled &&
+         options.pCanceled->load(std::memory_order_relaxed);
+}
+
+/**
+ * Computes the bounds of each feature of a primitive from the positions of
+ * its vertices, for the feature index of the tileset.
+ */
+static void computeFeatureBounds(
+    const TArray<TMeshVector3>& positions,
+    const TArray<int32>& vertexFeatureIDs,
+    TArray<CesiumPrimitiveFeatureBounds>& featureBounds) {
+  CESIUM_TRACE("computeFeatureBounds");
+
+  // The bounds are gathered by feature ID, which are dense in a feature
+  // table. Absurdly large IDs are not worth the memory.
+  constexpr int32 maxFeatureID = 1 << 24;
+  int32 largestFeatureID = -1;
+  for (int32 featureID : vertexFeatureIDs) {
+    largestFeatureID = FMath::Max(largestFeatureID, featureID);
+  }
+  if (largestFeatureID < 0 || largestFeatureID >= maxFeatureID) {
+    return;
+  }
+
+  TArray<FBox> boundsByID;
+  boundsByID.Init(FBox(ForceInit), largestFeatureID + 1);
+  for (int32 i = 0; i < vertexFeatureIDs.Num(); ++i) {
+    const int32 featureID = vertexFeatureIDs[i];
+    if (featureID >= 0) {
+      boundsByID[featureID] += FVector(positions[i]);
+    }
+  }
+
+  for (int32 featureID = 0; featureID < boundsByID.Num(); ++featureID) {
+    if (boundsByID[featureID].IsValid) {
+      featureBounds.Add({featureID, boundsByID[featureID]});
+    }
+  }
+}
+
+/**
+ * Cooks the collision mesh of a primitive, or defers it. The feature ID of
+ * each of its faces is found too, so that hits can be mapped to features
+ * without reading the glTF, as well as the bounds of each feature if the
+ * feature index is enabled, and the hierarchy of its triangles if geometry
+ * queries are enabled.
+ *
+ * @param vertexFeatureIDs The feature ID of each vertex, or nothing if the
+ * primitive has no feature table.
+ */
+static void cookCollisionMesh(
+    LoadPrimitiveResult& primitiveResult,
+    const glm::dmat4x4& transform,
+    const CreatePrimitiveOptions& options,
+    TArray<TMeshVector3>&& positions,
+    TArray<uint32>&& indices,
+    TArray<int32>& vertexFeatureIDs) {
+  primitiveResult.pCollisionMesh = nullptr;
+  primitiveResult.pDeferredCollision = nullptr;
+  primitiveResult.collisionBytes = 0;
+  primitiveResult.faceFeatureIDs.Empty();
+  primitiveResult.featureBounds.Empty();
+  primitiveResult.pQueryBVH = nullptr;
+
+  const CreateModelOptions& modelOptions =
+      *options.pMeshOptions->pNodeOptions->pModelOptions;
+
+  // The bounds and the hierarchy are found from the full geometry, before it
+  // is simplified. Only primitive components are queried, so instanced
+  // primitives have no hierarchy.
+  if (modelOptions.buildFeatureIndex && vertexFeatureIDs.Num() > 0) {
+    computeFeatureBounds(
+        positions,
+        vertexFeatureIDs,
+        primitiveResult.featureBounds);
+  }
+  if (modelOptions.buildGeometryQueries &&
+      !primitiveResult.pInstanceTransforms && positions.Num() > 0 &&
+      indices.Num() > 0) {
+    primitiveResult.pQueryBVH = std::make_shared<const CesiumTriangleBVH>(
+        TArray<TMeshVector3>(positions),
+        TArray<uint32>(indices));
+  }
+
+  if (modelOptions.collisionSimplificationError > 0.0 &&
+      positions.Num() > 0 && indices.Num() > 0 &&
+      !hasFaceMetadata(*options.pPrimitive)) {
+    simplifyCollisionMesh(
+        positions,
+        indices,
+        vertexFeatureIDs,
+        transform,
+        modelOptions.collisionSimplificationError);
+  }
+
+  if (positions.Num() == 0 || indices.Num() == 0 ||
+      isCanceled(modelOptions)) {
+    return;
+  }
+
+  // Physics reports the faces of the collision mesh in the order they were
+  // given, and a face is mapped to the feature of its first vertex.
+  if (vertexFeatureIDs.Num() > 0) {
+    const int32 numFaces = indices.Num() / 3;
+    primitiveResult.faceFeatureIDs.SetNumUninitialized(numFaces);
+    for (int32 i = 0; i < numFaces; ++i) {
+      primitiveResult.faceFeatureIDs[i] = vertexFeatureIDs[indices[3 * i]];
+    }
+  }
+
+  // Only primitive components cook deferred collision meshes, so the
+  // collision of instanced primitives is cooked now.
+  if (modelOptions.deferPhysicsMeshes && !primitiveResult.pInstanceTransforms) {
+    std::shared_ptr<DeferredCollisionMesh> pDeferred =
+        std::make_shared<DeferredCollisionMesh>();
+    pDeferred->bounds = FBox(ForceInit);
+    for (const TMeshVector3& position : positions) {
+      pDeferred->bounds += FVector(position);
+    }
+    pDeferred->positions = MoveTemp(positions);
+    pDeferred->indices = MoveTemp(indices);
+    primitiveResult.pDeferredCollision = std::move(pDeferred);
+    return;
+  }
+
+  int64 collisionBytes = estimateCollisionBytes(positions, indices);
+  primitiveResult.pCollisionMesh = buildCollisionMesh(
+      MoveTemp(positions),
+      indices
+#if PHYSICS_INTERFACE_PHYSX
+      ,
+      modelOptions.pPhysXCooking
+#endif
+      ,
+      modelOptions.pWrittenConvertedModel
+          ? &primitiveResult.cookedCollisionMesh
+          : nullptr,
+      modelOptions.pBenchmarkTimings);
+
+  if (primitiveResult.pCollisionMesh) {
+    primitiveResult.collisionBytes = collisionBytes;
+  }
+}
+
+/**
+ * Computes the average color of the image of the given texture, sampled on a
+ * coarse grid, or white if the image is not available as 8-bit pixels.
+ */
+static FLinearColor computeAverageTextureColor(
+    const Model& model,
+    const std::optional<CesiumGltf::TextureInfo>& textureInfo) {
+  if (!textureInfo) {
+    return FLinearColor::White;
+  }
+
+  const CesiumGltf::Texture* pTexture =
+      Model::getSafe(&model.textures, textureInfo->index);
+  const CesiumGltf::Image* pImage =
+      pTexture ? Model::getSafe(&model.images, pTexture->source) : nullptr;
+  if (!pImage) {
+    return FLinearColor::White;
+  }
+
+  const CesiumGltf::ImageCesium& image = pImage->cesium;
+  if (image.compressedPixelFormat !=
+          CesiumGltf::GpuCompressedPixelFormat::NONE ||
+      image.bytesPerChannel != 1 || image.channels < 3 || image.width <= 0 ||
+      image.height <= 0 ||
+      image.pixelData.size() <
+          size_t(image.width) * size_t(image.height) * size_t(image.channels)) {
+    return FLinearColor::White;
+  }
+
+  constexpr int32 samplesPerSide = 16;
+  const uint8* pPixels = reinterpret_cast<const uint8*>(image.pixelData.data());
+  FLinearColor sum(0.0f, 0.0f, 0.0f, 0.0f);
+  for (int32 y = 0; y < samplesPerSide; ++y) {
+    const int32 row = (2 * y + 1) * image.height / (2 * samplesPerSide);
+    for (int32 x = 0; x < samplesPerSide; ++x) {
+      const int32 column = (2 * x + 1) * image.width / (2 * samplesPerSide);
+      const uint8* pPixel =
+          pPixels + (size_t(row) * size_t(image.width) + size_t(column)) *
+                        size_t(image.channels);
+      sum += FLinearColor(FColor(pPixel[0], pPixel[1], pPixel[2]));
+    }
+  }
+  return sum / float(samplesPerSide * samplesPerSide);
+}
+
+/**
+ * Keeps a simplified copy of a primitive for the far-field proxy of its
+ * tileset, if it is enabled. Each vertex is colored by the base color of the
+ * material. The base color texture only contributes its average color, since
+ * the proxy has no textures.
+ */
+static void buildFarFieldGeometry(
+    LoadPrimitiveResult& primitiveResult,
+    const glm::dmat4x4& transform,
+    const CreatePrimitiveOptions& options,
+    const CesiumGltf::MaterialPBRMetallicRoughness& pbrMetallicRoughness,
+    const FStaticMeshVertexBuffers& vertexBuffers,
+    const TArray<uint32>& indices) {
+  primitiveResult.pFarFieldGeometry = nullptr;
+
+  const CreateModelOptions& modelOptions =
+      *options.pMeshOptions->pNodeOptions->pModelOptions;
+  if (modelOptions.farFieldSimplificationError <= 0.0 ||
+      primitiveResult.pInstanceTransforms || indices.Num() == 0) {
+    return;
+  }
+
+  double cellSize = computeClusterCellSize(
+      transform,
+      modelOptions.farFieldSimplificationError);
+  if (cellSize <= 0.0) {
+    return;
+  }
+
+  CESIUM_TRACE("buildFarFieldGeometry");
+
+  const FPositionVertexBuffer& positions = vertexBuffers.PositionVertexBuffer;
+  TArray<uint32> simplifiedIndices = indices;
+  TArray<uint32> originalIndices =
+      CesiumMeshOptimization::simplifyByVertexClustering(
+          simplifiedIndices,
+          positions.GetNumVertices(),
+          [&positions](uint32 index) {
+            const TMeshVector3& position = positions.VertexPosition(index);
+            return glm::dvec3(position.X, position.Y, position.Z);
+          },
+          cellSize);
+  if (simplifiedIndices.Num() == 0) {
+    return;
+  }
+
+  FLinearColor baseColor = computeAverageTextureColor(
+      *modelOptions.pModel,
+      pbrMetallicRoughness.baseColorTexture);
+  const std::vector<double>& factor = pbrMetallicRoughness.baseColorFactor;
+  if (factor.size() >= 3) {
+    baseColor *= FLinearColor(
+        static_cast<float>(factor[0]),
+        static_cast<float>(factor[1]),
+        static_cast<float>(factor[2]),
+        1.0f);
+  }
+
+  const FColorVertexBuffer& colors = vertexBuffers.ColorVertexBuffer;
+  const bool hasColors = colors.GetNumVertices() > 0;
+
+  std::shared_ptr<CesiumFarFieldGeometry> pGeometry =
+      std::make_shared<CesiumFarFieldGeometry>();
+  pGeometry->positions.SetNumUninitialized(originalIndices.Num());
+  pGeometry->colors.SetNumUninitialized(originalIndices.Num());
+  for (int32 i = 0; i < originalIndices.Num(); ++i) {
+    const uint32 source = originalIndices[i];
+    pGeometry->positions[i] = positions.VertexPosition(source);
+    const FLinearColor color =
+        hasColors ? baseColor * FLinearColor(colors.VertexColor(source))
+                  : baseColor;
+    pGeometry->colors[i] = color.ToFColor(true);
+  }
+  pGeometry->indices = MoveTemp(simplifiedIndices);
+  primitiveResult.pFarFieldGeometry = std::move(pGeometry);
+}
+
+/**
+ * Loads only what is needed to collide with a primitive: its positions and
+ * indices, cooked into a collision mesh. No render data, textures, or
+ * tangents are created.
+ */
+template <class TIndexAccessor>
+static void loadCollisionOnlyPrimitive(
+    LoadPrimitiveResult& primitiveResult,
+    const glm::dmat4x4& transform,
+    const CreatePrimitiveOptions& options,
+    const StridedAccessor<TMeshVector3>& positionView,
+    const TIndexAccessor& indicesView) {
+  CESIUM_TRACE("loadCollisionOnlyPrimitive");
+
+  const Model& model =
+      *options.pMeshOptions->pNodeOptions->pModelOptions->pModel;
+  const MeshPrimitive& primitive = *options.pPrimitive;
+
+  CesiumScratchArray<uint32> indicesScratch;
+  TArray<uint32>& indices = *indicesScratch;
+  copyTriangleIndices(primitive, indicesView, indices);
+  if (!areIndicesInRange(indices, positionView.size())) {
+    UE_LOG(
+        LogCesium,
+        Warning,
+        TEXT("%s: Index out of range of the position buffer"),
+        UTF8_TO_TCHAR(primitiveResult.name.c_str()));
+    return;
+  }
+
+  CesiumScratchArray<TMeshVector3> positionsScratch;
+  TArray<TMeshVector3>& positions = *positionsScratch;
+  positions.SetNum(positionView.size());
+  for (int64_t i = 0; i < positions.Num(); ++i) {
+    positions[i] = positionView[i];
+  }
+
+  // Reverse the winding order for Unreal's left-handed coordinate system, as
+  // for rendered primitives.
+  for (int32 i = 2; i < indices.Num(); i += 3) {
+    std::swap(indices[i - 2], indices[i]);
+  }
+
+  primitiveResult.collisionOnly = true;
+  primitiveResult.pModel = &model;
+  primitiveResult.pMeshPrimitive = &primitive;
+  primitiveResult.transform = transform;
+
+  CesiumScratchArray<int32> vertexFeatureIDsScratch;
+  TArray<int32>& vertexFeatureIDs = *vertexFeatureIDsScratch;
+  getVertexFeatureIDs(
+      model,
+      findFirstFeatureTable(model, primitive),
+      static_cast<uint32>(positions.Num()),
+      nullptr,
+      vertexFeatureIDs);
+
+  cookCollisionMesh(
+      primitiveResult,
+      transform,
+      options,
+      MoveTemp(positions),
+      MoveTemp(indices),
+      vertexFeatureIDs);
+}
+
+/**
+ * Loads a primitive of points, such as a point cloud tile. Each point is a
+ * single vertex, with its position, normal, and color, and the points are
+ * drawn as a point list straight from the vertex buffers rather than being
+ * expanded into triangles. Points have no collision mesh.
+ */
+template <class TIndexAccessor>
+static void loadPointPrimitive(
+    LoadPrimitiveResult& primitiveResult,
+    const glm::dmat4x4& transform,
+    const CreatePrimitiveOptions& options,
+    const StridedAccessor<TMeshVector3>& positionView,
+    const TIndexAccessor& indicesView) {
+  CESIUM_TRACE("loadPointPrimitive");
+
+  const Model& model =
+      *options.pMeshOptions->pNodeOptions->pModelOptions->pModel;
+  const MeshPrimitive& primitive = *options.pPrimitive;
+
+  // Indexed points are drawn in the order of their indices.
+  CesiumScratchArray<uint32> pointSourcesScratch;
+  TArray<uint32>& pointSources = *pointSourcesScratch;
+  pointSources.SetNumUninitialized(static_cast<int32>(indicesView.size()));
+  for (int32 i = 0; i < pointSources.Num(); ++i) {
+    pointSources[i] = static_cast<uint32>(indicesView[i]);
+  }
+  if (!areIndicesInRange(pointSources, positionView.size())) {
+    UE_LOG(
+        LogCesium,
+        Warning,
+        TEXT("%s: Index out of range of the position buffer"),
+        UTF8_TO_TCHAR(primitiveResult.name.c_str()));
+    return;
+  }
+
+  const uint32 numPoints = static_cast<uint32>(pointSources.Num());
+  if (numPoints == 0) {
+    return;
+  }
+
+  StridedAccessor<TMeshVector3> normalView;
+  auto normalAccessorIt = primitive.attributes.find("NORMAL");
+  if (normalAccessorIt != primitive.attributes.end()) {
+    normalView = StridedAccessor<TMeshVector3>(model, normalAccessorIt->second);
+  }
+  const bool hasNormals =
+      normalView.status() == CesiumGltf::AccessorViewStatus::Valid &&
+      normalView.size() >= positionView.size();
+
+  bool hasVertexColors = false;
+  CesiumScratchArray<FColor> colorsScratch;
+  TArray<FColor>& colors = *colorsScratch;
+  auto colorAccessorIt = primitive.attributes.find("COLOR_0");
+  if (colorAccessorIt != primitive.attributes.end()) {
+    CESIUM_TRACE("copy colors");
+    colors.SetNumUninitialized(numPoints);
+    hasVertexColors = CesiumGltf::createAccessorView(
+        model,
+        colorAccessorIt->second,
+        ColorVisitor{true, colors, pointSources});
+  }
+
+  FStaticMeshRenderData* RenderData = new FStaticMeshRenderData();
+  RenderData->AllocateLODResources(1);
+  FStaticMeshLODResources& LODResources = RenderData->LODResources[0];
+  FStaticMeshVertexBuffers& vertexBuffers = LODResources.VertexBuffers;
+  LODResources.bHasColorVertexData = hasVertexColors;
+
+  {
+    CESIUM_TRACE("copy points");
+    vertexBuffers.PositionVertexBuffer.Init(numPoints, false);
+    vertexBuffers.StaticMeshVertexBuffer.Init(numPoints, 1, false);
+    if (hasVertexColors) {
+      vertexBuffers.ColorVertexBuffer.InitFromColorArray(
+          colors.GetData(),
+          colors.Num(),
+          sizeof(FColor),
+          false);
+    }
+
+    // Points without normals face up, so that they are lit like the ground
+    // below them.
+    const TMeshVector3 zero(0.0f, 0.0f, 0.0f);
+    const TMeshVector3 up(0.0f, 0.0f, 1.0f);
+    FBox bounds(ForceInit);
+    for (uint32 i = 0; i < numPoints; ++i) {
+      const uint32 source = pointSources[i];
+      const TMeshVector3& position = positionView[source];
+      vertexBuffers.PositionVertexBuffer.VertexPosition(i) = position;
+      vertexBuffers.StaticMeshVertexBuffer.SetVertexTangents(
+          i,
+          zero,
+          zero,
+          hasNormals ? normalView[source] : up);
+      vertexBuffers.StaticMeshVertexBuffer.SetVertexUV(
+          i,
+          0,
+          TMeshVector2(0.0f, 0.0f));
+      bounds += FVector(position);
+    }
+
+    bounds.GetCenterAndExtents(
+        RenderData->Bounds.Origin,
+        RenderData->Bounds.BoxExtent);
+    RenderData->Bounds.SphereRadius = RenderData->Bounds.BoxExtent.Size();
+  }
+
+#if ENGINE_MAJOR_VERSION == 5
+  FStaticMeshSectionArray& Sections = LODResources.Sections;
+#else
+  FStaticMeshLODResources::FStaticMeshSectionArray& Sections =
+      LODResources.Sections;
+#endif
+
+  // The section only carries the material, the points are not indexed.
+  FStaticMeshSection& section = Sections.AddDefaulted_GetRef();
+  section.bEnableCollision = false;
+  section.bCastShadow = false;
+  section.NumTriangles = 0;
+  section.FirstIndex = 0;
+  section.MinVertexIndex = 0;
+  section.MaxVertexIndex = numPoints - 1;
+  section.MaterialIndex = 0;
+
+  LODResources.IndexBuffer.SetIndices(
+      TArray<uint32>(),
+      EIndexBufferStride::Type::Force16Bit);
+  LODResources.bHasDepthOnlyIndices = false;
+  LODResources.bHasReversedIndices = false;
+  LODResources.bHasReversedDepthOnlyIndices = false;
+#if ENGINE_MAJOR_VERSION < 5
+  LODResources.bHasAdjacencyInfo = false;
+#endif
+
+  int materialID = primitive.material;
+  const CesiumGltf::Material& material =
+      materialID >= 0 && materialID < model.materials.size()
+          ? model.materials[materialID]
+          : defaultMaterial;
+
+  primitiveResult.pointCloud = true;
+  primitiveResult.pModel = &model;
+  primitiveResult.pMeshPrimitive = &primitive;
+  primitiveResult.RenderData = RenderData;
+  primitiveResult.transform = transform;
+  primitiveResult.pMaterial = &material;
+}
+
+/**
+ * The skirt mesh metadata that cesium-native adds to the extras of the
+ * primitives of quantized-mesh terrain tiles.
+ */
+struct SkirtMeshMetadata {
+  // The range of the indices of the triangles that are not skirts.
+  int64 noSkirtIndicesBegin = 0;
+  int64 noSkirtIndicesCount = 0;
+  // How far the skirts hang below the edges of the tile.
+  double skirtHeight = 0.0;
+};
+
+static std::optional<SkirtMeshMetadata>
+getSkirtMeshMetadata(const MeshPrimitive& primitive) {
+  auto metadataIt = primitive.extras.find("skirtMeshMetadata");
+  const CesiumUtility::JsonValue::Object* pMetadata =
+      metadataIt != primitive.extras.end()
+          ? std::get_if<CesiumUtility::JsonValue::Object>(
+                &metadataIt->second.value)
+          : nullptr;
+  if (!pMetadata) {
+    return std::nullopt;
+  }
+
+  auto rangeIt = pMetadata->find("noSkirtRange");
+  const CesiumUtility::JsonValue::Array* pRange =
+      rangeIt != pMetadata->end()
+          ? std::get_if<CesiumUtility::JsonValue::Array>(&rangeIt->second.value)
+          : nullptr;
+  if (!pRange || pRange->size() != 2) {
+    return std::nullopt;
+  }
+
+  SkirtMeshMetadata result;
+  result.noSkirtIndicesBegin =
+      int64((*pRange)[0].getSafeNumberOrDefault<double>(-1.0));
+  result.noSkirtIndicesCount =
+      int64((*pRange)[1].getSafeNumberOrDefault<double>(-1.0));
+  for (const char* edge :
+       {"skirtWestHeight",
+        "skirtSouthHeight",
+        "skirtEastHeight",
+        "skirtNorthHeight"}) {
+    auto heightIt = pMetadata->find(edge);
+    if (heightIt != pMetadata->end()) {
+      result.skirtHeight = FMath::Max(
+          result.skirtHeight,
+          heightIt->second.getSafeNumberOrDefault<double>(0.0));
+    }
+  }
+  return result;
+}
+
+/**
+ * Loads a quantized-mesh terrain primitive as a heightfield, whose surface is
+ * sampled into textures that the material displaces a shared grid with,
+ * instead of converting its vertices into render data. Its collision mesh is
+ * cooked from its triangles, as usual. Returns false if the primitive isn't
+ * a terrain tile that can be sampled, and should be loaded as usual.
+ */
+template <class TIndexAccessor>
+static bool loadHeightfieldPrimitive(
+    LoadPrimitiveResult& primitiveResult,
+    const glm::dmat4x4& transform,
+    const CreatePrimitiveOptions& options,
+    const StridedAccessor<TMeshVector3>& positionView,
+    const TIndexAccessor& indicesView) {
+  const Model& model =
+      *options.pMeshOptions->pNodeOptions->pModelOptions->pModel;
+  const MeshPrimitive& primitive = *options.pPrimitive;
+
+  const std::optional<SkirtMeshMetadata> skirtMeshMetadata =
+      getSkirtMeshMetadata(primitive);
+  if (!skirtMeshMetadata ||
+      primitive.mode != CesiumGltf::MeshPrimitive::Mode::TRIANGLES) {
+    return false;
+  }
+
+  CESIUM_TRACE("loadHeightfieldPrimitive");
+
+  CesiumScratchArray<uint32> indicesScratch;
+  TArray<uint32>& indices = *indicesScratch;
+  copyTriangleIndices(primitive, indicesView, indices);
+  const int64 begin = skirtMeshMetadata->noSkirtIndicesBegin;
+  const int64 count = skirtMeshMetadata->noSkirtIndicesCount;
+  if (!areIndicesInRange(indices, positionView.size()) || begin < 0 ||
+      count < 3 || count % 3 != 0 || begin + count > indices.Num()) {
+    return false;
+  }
+
+  CesiumScratchArray<uint32> surfaceIndicesScratch;
+  TArray<uint32>& surfaceIndices = *surfaceIndicesScratch;
+  surfaceIndices.Append(&indices[int32(begin)], int32(count));
+
+  CesiumHeightfieldTexels texels;
+  if (!CesiumHeightfield::resample(
+          [&positionView](uint32 index) {
+            const TMeshVector3& position = positionView[index];
+            return glm::dvec3(position.X, position.Y, position.Z);
+          },
+          static_cast<uint32>(positionView.size()),
+          surfaceIndices,
+          transform,
+          skirtMeshMetadata->skirtHeight,
+          texels)) {
+    return false;
+  }
+
+  primitiveResult.heightfieldPositionTexture =
+      CesiumTextureUtility::loadDataTextureAnyThreadPart(
+          CesiumHeightfield::TextureSize,
+          CesiumHeightfield::TextureSize,
+          PF_A32B32G32R32F,
+          texels.positions.GetData(),
+          TextureFilter::TF_Nearest);
+  primitiveResult.heightfieldNormalTexture =
+      CesiumTextureUtility::loadDataTextureAnyThreadPart(
+          CesiumHeightfield::TextureSize,
+          CesiumHeightfield::TextureSize,
+          PF_B8G8R8A8,
+          texels.normals.GetData(),
+          TextureFilter::TF_Bilinear);
+
+  int materialID = primitive.material;
+  const CesiumGltf::Material& material =
+      materialID >= 0 && materialID < model.materials.size()
+          ? model.materials[materialID]
+          : defaultMaterial;
+
+  applyWaterMask(
+      model,
+      primitive,
+      primitiveResult,
+      options.pMeshOptions->pNodeOptions->pModelOptions->packWaterMasks);
+
+  // The raster overlays are sampled with the longitudes and latitudes of the
+  // grid, in its second UV channel.
+  for (size_t i = 0;
+       i < primitiveResult.overlayTextureCoordinateIDToUVIndex.size();
+       ++i) {
+    const std::string attributeName = "_CESIUMOVERLAY_" + std::to_string(i);
+    primitiveResult.overlayTextureCoordinateIDToUVIndex[i] =
+        primitive.attributes.find(attributeName) != primitive.attributes.end()
+            ? 1
+            : 0;
+  }
+
+  primitiveResult.heightfield = true;
+  primitiveResult.heightfieldBounds = texels.bounds;
+  primitiveResult.pModel = &model;
+  primitiveResult.pMeshPrimitive = &primitive;
+  primitiveResult.transform = transform;
+  primitiveResult.pMaterial = &material;
+
+  CesiumScratchArray<TMeshVector3> positionsScratch;
+  TArray<TMeshVector3>& positions = *positionsScratch;
+  positions.SetNum(positionView.size());
+  for (int64_t i = 0; i < positions.Num(); ++i) {
+    positions[i] = positionView[i];
+  }
+
+  // Reverse the winding order for Unreal's left-handed coordinate system, as
+  // for rendered primitives.
+  for (int32 i = 2; i < indices.Num(); i += 3) {
+    std::swap(indices[i - 2], indices[i]);
+  }
+
+  CesiumScratchArray<int32> vertexFeatureIDsScratch;
+  TArray<int32>& vertexFeatureIDs = *vertexFeatureIDsScratch;
+  getVertexFeatureIDs(
+      model,
+      findFirstFeatureTable(model, primitive),
+      static_cast<uint32>(positions.Num()),
+      nullptr,
+      vertexFeatureIDs);
+
+  cookCollisionMesh(
+      primitiveResult,
+      transform,
+      options,
+      MoveTemp(positions),
+      MoveTemp(indices),
+      vertexFeatureIDs);
+  return true;
+}
+
+template <class TIndexAccessor>
+static void loadPrimitive(
+    LoadPrimitiveResult& primitiveResult,
+    const glm::dmat4x4& transform,
+    const CreatePrimitiveOptions& options,
+    const CesiumGltf::Accessor& positionAccessor,
+    const StridedAccessor<TMeshVector3>& positionView,
+    const TIndexAccessor& indicesView) {
+
+  CESIUM_TRACE("loadPrimitive<T>");
+
+  const Model& model =
+      *options.pMeshOptions->pNodeOptions->pModelOptions->pModel;
+  const Mesh& mesh = *options.pMeshOptions->pMesh;
+  const MeshPrimitive& primitive = *options.pPrimitive;
+
+  if (primitive.mode != CesiumGltf::MeshPrimitive::Mode::TRIANGLES &&
+      primitive.mode != CesiumGltf::MeshPrimitive::Mode::TRIANGLE_STRIP &&
+      primitive.mode != CesiumGltf::MeshPrimitive::Mode::POINTS) {
+    // TODO: add support for primitive types other than triangles.
+    UE_LOG(
+        LogCesium,
+        Warning,
+        TEXT("Primitive mode %d is not supported"),
+        primitive.mode);
+    return;
+  }
+
+  std::string name = "glTF";
+
+  auto urlIt = model.extras.find("Cesium3DTiles_TileUrl");
   if (urlIt != model.extras.end()) {
     name = urlIt->second.getStringOrDefault("glTF");
     name = constrainLength(name, 256);
@@ -596,16 +2203,52 @@ static void loadPrimitive(
     }
   }
 
+  if (primitive.mode == CesiumGltf::MeshPrimitive::Mode::POINTS) {
+    // Points have nothing to collide with.
+    if (!options.pMeshOptions->pNodeOptions->pModelOptions->collisionOnly) {
+      loadPointPrimitive(
+          primitiveResult,
+          transform,
+          options,
+          positionView,
+          indicesView);
+    }
+    return;
+  }
+
+  if (options.pMeshOptions->pNodeOptions->pModelOptions->collisionOnly) {
+    loadCollisionOnlyPrimitive(
+        primitiveResult,
+        transform,
+        options,
+        positionView,
+        indicesView);
+    return;
+  }
+
+  if (options.pMeshOptions->pNodeOptions->pModelOptions->renderHeightfields &&
+      loadHeightfieldPrimitive(
+          primitiveResult,
+          transform,
+          options,
+          positionView,
+          indicesView)) {
+    return;
+  }
+
+  VertexAttributeSources sources;
+
   auto normalAccessorIt = primitive.attributes.find("NORMAL");
-  CesiumGltf::AccessorView<TMeshVector3> normalAccessor;
   bool hasNormals = false;
   if (normalAccessorIt != primitive.attributes.end()) {
     int normalAccessorID = normalAccessorIt->second;
-    normalAccessor =
-        CesiumGltf::AccessorView<TMeshVector3>(model, normalAccessorID);
+    StridedAccessor<TMeshVector3> normalAccessor(model, normalAccessorID);
     hasNormals =
-        normalAccessor.status() == CesiumGltf::AccessorViewStatus::Valid;
-    if (!hasNormals) {
+        normalAccessor.status() == CesiumGltf::AccessorViewStatus::Valid &&
+        normalAccessor.size() >= positionView.size();
+    if (hasNormals) {
+      sources.normals = normalAccessor;
+    } else {
       UE_LOG(
           LogCesium,
           Warning,
@@ -638,14 +2281,15 @@ static void loadPrimitive(
 
   bool hasTangents = false;
   auto tangentAccessorIt = primitive.attributes.find("TANGENT");
-  CesiumGltf::AccessorView<TMeshVector4> tangentAccessor;
   if (tangentAccessorIt != primitive.attributes.end()) {
     int tangentAccessorID = tangentAccessorIt->second;
-    tangentAccessor =
-        CesiumGltf::AccessorView<TMeshVector4>(model, tangentAccessorID);
+    StridedAccessor<TMeshVector4> tangentAccessor(model, tangentAccessorID);
     hasTangents =
-        tangentAccessor.status() == CesiumGltf::AccessorViewStatus::Valid;
-    if (!hasTangents) {
+        tangentAccessor.status() == CesiumGltf::AccessorViewStatus::Valid &&
+        tangentAccessor.size() >= positionView.size();
+    if (hasTangents) {
+      sources.tangents = tangentAccessor;
+    } else {
       UE_LOG(
           LogCesium,
           Warning,
@@ -654,11 +2298,16 @@ static void loadPrimitive(
     }
   }
 
-  applyWaterMask(model, primitive, primitiveResult);
+  applyWaterMask(
+      model,
+      primitive,
+      primitiveResult,
+      options.pMeshOptions->pNodeOptions->pModelOptions->packWaterMasks);
 
   // The water effect works by animating the normal, and the normal is
   // expressed in tangent space. So if we have water, we need tangents.
-  if (primitiveResult.onlyWater || primitiveResult.waterMaskTexture) {
+  if (primitiveResult.onlyWater || primitiveResult.waterMaskTexture ||
+      primitiveResult.waterMaskSize > 0) {
     needsTangents = true;
   }
 
@@ -674,7 +2323,10 @@ static void loadPrimitive(
     const std::vector<double>& max = positionAccessor.max;
     glm::dvec3 minPosition{std::numeric_limits<double>::max()};
     glm::dvec3 maxPosition{std::numeric_limits<double>::lowest()};
-    if (min.size() != 3 || max.size() != 3) {
+    // The bounds of quantized positions are recomputed from the expanded
+    // values, which don't need to account for normalization.
+    if (min.size() != 3 || max.size() != 3 ||
+        positionAccessor.componentType != Accessor::ComponentType::FLOAT) {
       for (int32_t i = 0; i < positionView.size(); ++i) {
         minPosition.x = glm::min<double>(minPosition.x, positionView[i].X);
         minPosition.y = glm::min<double>(minPosition.y, positionView[i].Y);
@@ -705,100 +2357,98 @@ static void loadPrimitive(
     RenderData->Bounds.SphereRadius = 0.0f;
   }
 
-  TArray<uint32> indices;
-  if (primitive.mode == CesiumGltf::MeshPrimitive::Mode::TRIANGLES) {
-    CESIUM_TRACE("copy TRIANGLE indices");
-    indices.SetNum(static_cast<TArray<uint32>::SizeType>(indicesView.size()));
-
-    for (int32 i = 0; i < indicesView.size(); ++i) {
-      indices[i] = indicesView[i];
-    }
-  } else {
-    // assume TRIANGLE_STRIP because all others are rejected earlier.
-    CESIUM_TRACE("copy TRIANGLE_STRIP indices");
-    indices.SetNum(
-        static_cast<TArray<uint32>::SizeType>(3 * (indicesView.size() - 2)));
-    for (int32 i = 0; i < indicesView.size() - 2; ++i) {
-      if (i % 2) {
-        indices[3 * i] = indicesView[i];
-        indices[3 * i + 1] = indicesView[i + 2];
-        indices[3 * i + 2] = indicesView[i + 1];
-      } else {
-        indices[3 * i] = indicesView[i];
-        indices[3 * i + 1] = indicesView[i + 1];
-        indices[3 * i + 2] = indicesView[i + 2];
-      }
-    }
+  CesiumScratchArray<uint32> indicesScratch;
+  TArray<uint32>& indices = *indicesScratch;
+  copyTriangleIndices(primitive, indicesView, indices);
+  if (!areIndicesInRange(indices, positionView.size())) {
+    UE_LOG(
+        LogCesium,
+        Warning,
+        TEXT("%s: Index out of range of the position buffer"),
+        UTF8_TO_TCHAR(name.c_str()));
+    delete RenderData;
+    return;
   }
 
   // If we don't have normals, the gltf spec prescribes that the client
   // implementation must generate flat normals, which requires duplicating
-  // vertices shared by multiple triangles. If we don't have tangents, but
-  // need them, we need to use a tangent space generation algorithm which
-  // requires duplicated vertices.
-  bool duplicateVertices = !hasNormals || (needsTangents && !hasTangents);
-
-  TArray<FStaticMeshBuildVertex> StaticMeshBuildVertices;
-  StaticMeshBuildVertices.SetNum(
+  // vertices shared by multiple triangles, unless the material computes them
+  // instead. Tangents that are needed but missing are computed with
+  // mikktspace for duplicated vertices, and from the shared vertices
+  // otherwise, so they don't require duplicating them.
+  primitiveResult.flatNormalsInMaterial =
+      !hasNormals && !needsTangents &&
+      options.pMeshOptions->pNodeOptions->pModelOptions->flatNormalsInMaterial;
+  bool duplicateVertices =
+      !hasNormals && !primitiveResult.flatNormalsInMaterial;
+
+  uint32 numVertices = static_cast<uint32>(
       duplicateVertices ? indices.Num() : positionView.size());
 
-  {
-    if (duplicateVertices) {
-      CESIUM_TRACE("copy duplicated positions");
-      for (int64_t i = 0; i < indices.Num(); ++i) {
-        FStaticMeshBuildVertex& vertex = StaticMeshBuildVertices[i];
-        uint32 vertexIndex = indices[i];
-        vertex.Position = positionView[vertexIndex];
-        vertex.UVs[0] = TMeshVector2(0.0f, 0.0f);
-        vertex.UVs[2] = TMeshVector2(0.0f, 0.0f);
-        RenderData->Bounds.SphereRadius = FMath::Max(
-            (vertex.Position - RenderData->Bounds.Origin).Size(),
-            RenderData->Bounds.SphereRadius);
-      }
-    } else {
-      CESIUM_TRACE("copy positions");
-      for (int64_t i = 0; i < StaticMeshBuildVertices.Num(); ++i) {
-        FStaticMeshBuildVertex& vertex = StaticMeshBuildVertices[i];
-        vertex.Position = positionView[i];
-        vertex.UVs[0] = TMeshVector2(0.0f, 0.0f);
-        vertex.UVs[2] = TMeshVector2(0.0f, 0.0f);
-        RenderData->Bounds.SphereRadius = FMath::Max(
-            (vertex.Position - RenderData->Bounds.Origin).Size(),
-            RenderData->Bounds.SphereRadius);
-      }
-    }
+  // The triangles and vertices of meshes with shared vertices may be
+  // reordered to make better use of the GPU's vertex caches. The vertices are
+  // then copied from their original positions in vertexOrder, in the same way
+  // that duplicated vertices are copied from their positions in indices.
+  TArray<uint32> vertexOrder;
+  if (!duplicateVertices &&
+      options.pMeshOptions->pNodeOptions->pModelOptions->optimizeMeshes &&
+      !hasFaceMetadata(primitive)) {
+    CESIUM_TRACE("optimize mesh");
+    CesiumMeshOptimization::optimizeVertexCache(indices, numVertices);
+    CesiumMeshOptimization::optimizeOverdraw(
+        indices,
+        [&positionView](uint32 index) {
+          const TMeshVector3& position = positionView[index];
+          return glm::dvec3(position.X, position.Y, position.Z);
+        });
+    vertexOrder =
+        CesiumMeshOptimization::optimizeVertexFetch(indices, numVertices);
+    numVertices = static_cast<uint32>(vertexOrder.Num());
   }
 
+  bool remapVertices = duplicateVertices || vertexOrder.Num() > 0;
+  const TArray<uint32>& vertexSources =
+      duplicateVertices ? indices : vertexOrder;
+
   bool hasVertexColors = false;
+  CesiumScratchArray<FColor> colorsScratch;
+  TArray<FColor>& colors = *colorsScratch;
 
   auto colorAccessorIt = primitive.attributes.find("COLOR_0");
   if (colorAccessorIt != primitive.attributes.end()) {
     CESIUM_TRACE("copy colors");
     int colorAccessorID = colorAccessorIt->second;
+    colors.SetNumUninitialized(numVertices);
     hasVertexColors = CesiumGltf::createAccessorView(
         model,
         colorAccessorID,
-        ColorVisitor{duplicateVertices, StaticMeshBuildVertices, indices});
+        ColorVisitor{remapVertices, colors, vertexSources});
   }
 
   LODResources.bHasColorVertexData = hasVertexColors;
 
   // We need to copy the texture coordinates associated with each texture (if
-  // any) into the the appropriate UVs slot in FStaticMeshBuildVertex.
+  // any) into the the appropriate UV channel of the vertex buffer. They are
+  // assigned to channels here, and copied along with the other attributes.
 
   std::unordered_map<uint32_t, uint32_t> textureCoordinateMap;
 
   {
-    CESIUM_TRACE("loadTextures");
+    CESIUM_TRACE("findTextures");
+    const std::vector<CesiumTextureUtility::LoadedTextureResult*>& textures =
+        *options.pTextures;
     primitiveResult.baseColorTexture =
-        loadTexture(model, pbrMetallicRoughness.baseColorTexture);
-    primitiveResult.metallicRoughnessTexture =
-        loadTexture(model, pbrMetallicRoughness.metallicRoughnessTexture);
-    primitiveResult.normalTexture = loadTexture(model, material.normalTexture);
+        findTexture(model, textures, pbrMetallicRoughness.baseColorTexture);
+    primitiveResult.metallicRoughnessTexture = findTexture(
+        model,
+        textures,
+        pbrMetallicRoughness.metallicRoughnessTexture);
+    primitiveResult.normalTexture =
+        findTexture(model, textures, material.normalTexture);
     primitiveResult.occlusionTexture =
-        loadTexture(model, material.occlusionTexture);
+        findTexture(model, textures, material.occlusionTexture);
     primitiveResult.emissiveTexture =
-        loadTexture(model, material.emissiveTexture);
+        findTexture(model, textures, material.emissiveTexture);
   }
 
   {
@@ -808,50 +2458,40 @@ static void loadPrimitive(
         updateTextureCoordinates(
             model,
             primitive,
-            duplicateVertices,
-            StaticMeshBuildVertices,
-            indices,
             pbrMetallicRoughness.baseColorTexture,
-            textureCoordinateMap);
+            textureCoordinateMap,
+            sources);
     primitiveResult.textureCoordinateParameters
         ["metallicRoughnessTextureCoordinateIndex"] = updateTextureCoordinates(
         model,
         primitive,
-        duplicateVertices,
-        StaticMeshBuildVertices,
-        indices,
         pbrMetallicRoughness.metallicRoughnessTexture,
-        textureCoordinateMap);
+        textureCoordinateMap,
+        sources);
     primitiveResult
         .textureCoordinateParameters["normalTextureCoordinateIndex"] =
         updateTextureCoordinates(
             model,
             primitive,
-            duplicateVertices,
-            StaticMeshBuildVertices,
-            indices,
             material.normalTexture,
-            textureCoordinateMap);
+            textureCoordinateMap,
+            sources);
     primitiveResult
         .textureCoordinateParameters["occlusionTextureCoordinateIndex"] =
         updateTextureCoordinates(
             model,
             primitive,
-            duplicateVertices,
-            StaticMeshBuildVertices,
-            indices,
             material.occlusionTexture,
-            textureCoordinateMap);
+            textureCoordinateMap,
+            sources);
     primitiveResult
         .textureCoordinateParameters["emissiveTextureCoordinateIndex"] =
         updateTextureCoordinates(
             model,
             primitive,
-            duplicateVertices,
-            StaticMeshBuildVertices,
-            indices,
             material.emissiveTexture,
-            textureCoordinateMap);
+            textureCoordinateMap,
+            sources);
 
     for (size_t i = 0;
          i < primitiveResult.overlayTextureCoordinateIDToUVIndex.size();
@@ -863,11 +2503,9 @@ static void loadPrimitive(
             updateTextureCoordinates(
                 model,
                 primitive,
-                duplicateVertices,
-                StaticMeshBuildVertices,
-                indices,
                 attributeName,
-                textureCoordinateMap);
+                textureCoordinateMap,
+                sources);
       } else {
         primitiveResult.overlayTextureCoordinateIDToUVIndex[i] = 0;
       }
@@ -878,78 +2516,131 @@ static void loadPrimitive(
   // TangentY: Bi-tangent
   // TangentZ: Normal
 
-  if (hasNormals) {
-    if (duplicateVertices) {
-      CESIUM_TRACE("copy normals for duplicated vertices");
-      for (int64_t i = 0; i < indices.Num(); ++i) {
-        FStaticMeshBuildVertex& vertex = StaticMeshBuildVertices[i];
-        uint32 vertexIndex = indices[i];
-        vertex.TangentX = TMeshVector3(0.0f, 0.0f, 0.0f);
-        vertex.TangentY = TMeshVector3(0.0f, 0.0f, 0.0f);
-        vertex.TangentZ = normalAccessor[vertexIndex];
-      }
-    } else {
-      CESIUM_TRACE("copy normals");
-      for (int64_t i = 0; i < StaticMeshBuildVertices.Num(); ++i) {
-        FStaticMeshBuildVertex& vertex = StaticMeshBuildVertices[i];
-        vertex.TangentX = TMeshVector3(0.0f, 0.0f, 0.0f);
-        vertex.TangentY = TMeshVector3(0.0f, 0.0f, 0.0f);
-        vertex.TangentZ = normalAccessor[i];
-      }
+  const FirstFeatureTable firstFeatureTable =
+      findFirstFeatureTable(model, primitive);
+
+  // Materials that style features with the feature metadata texture find
+  // the feature of each vertex in an extra UV channel. Only this feature
+  // table's property views are created on the load thread, the rest of the
+  // metadata is created when it is first queried.
+  const TArray<FString>& metadataTextureProperties =
+      options.pMeshOptions->pNodeOptions->pModelOptions
+          ->metadataTextureProperties;
+  const uint32 featureIdChannel =
+      static_cast<uint32>(textureCoordinateMap.size());
+  bool hasFeatureIdChannel = false;
+  if (metadataTextureProperties.Num() > 0 &&
+      featureIdChannel < MAX_STATIC_TEXCOORDS &&
+      firstFeatureTable.pFeatureTable) {
+    if (loadFeatureMetadataTexture(
+            primitiveResult,
+            FCesiumMetadataFeatureTable(
+                model,
+                model.accessors[firstFeatureTable.featureIDAccessor],
+                *firstFeatureTable.pFeatureTable),
+            metadataTextureProperties)) {
+      hasFeatureIdChannel = true;
+      primitiveResult
+          .textureCoordinateParameters["featureIdTextureCoordinateIndex"] =
+          featureIdChannel;
     }
-  } else {
-    CESIUM_TRACE("compute flat normals");
-    computeFlatNormals(indices, StaticMeshBuildVertices);
   }
 
-  if (hasTangents) {
-    if (duplicateVertices) {
-      CESIUM_TRACE("copy tangents for duplicated vertices");
-      for (int64_t i = 0; i < indices.Num(); ++i) {
-        FStaticMeshBuildVertex& vertex = StaticMeshBuildVertices[i];
-        uint32 vertexIndex = indices[i];
-        const TMeshVector4& tangent = tangentAccessor[vertexIndex];
-        vertex.TangentX = tangent;
-        vertex.TangentY =
-            TMeshVector3::CrossProduct(vertex.TangentZ, vertex.TangentX) *
-            tangent.W;
-      }
-    } else {
-      CESIUM_TRACE("copy tangents");
-      for (int64_t i = 0; i < StaticMeshBuildVertices.Num(); ++i) {
-        FStaticMeshBuildVertex& vertex = StaticMeshBuildVertices[i];
-        const TMeshVector4& tangent = tangentAccessor[i];
-        vertex.TangentX = tangent;
-        vertex.TangentY =
-            TMeshVector3::CrossProduct(vertex.TangentZ, vertex.TangentX) *
-            tangent.W;
-      }
+  FStaticMeshVertexBuffers& vertexBuffers = LODResources.VertexBuffers;
+
+  {
+    CESIUM_TRACE("init buffers");
+    // Unless high precision is requested, tangents are stored with 8 bits
+    // per component, and texture coordinates at half precision when their
+    // range allows it. Positions are always single-precision floats, because
+    // that's all the static mesh vertex factory supports. Feature IDs are
+    // too large for half precision.
+    bool highPrecision = options.pMeshOptions->pNodeOptions->pModelOptions
+                             ->highPrecisionVertexAttributes;
+    vertexBuffers.StaticMeshVertexBuffer.SetUseHighPrecisionTangentBasis(
+        highPrecision);
+    vertexBuffers.StaticMeshVertexBuffer.SetUseFullPrecisionUVs(
+        highPrecision || hasFeatureIdChannel ||
+        !canUseHalfPrecisionUVs(sources));
+
+    uint32 numTexCoords = FMath::Max(
+        hasFeatureIdChannel ? featureIdChannel + 1 : featureIdChannel,
+        1u);
+    vertexBuffers.PositionVertexBuffer.Init(numVertices, false);
+    vertexBuffers.StaticMeshVertexBuffer.Init(numVertices, numTexCoords, false);
+    if (hasVertexColors) {
+      vertexBuffers.ColorVertexBuffer.InitFromColorArray(
+          colors.GetData(),
+          colors.Num(),
+          sizeof(FColor),
+          false);
     }
   }
 
-  if (needsTangents && !hasTangents) {
-    // Use mikktspace to calculate the tangents.
-    // Note that this assumes normals and UVs are already populated.
-    CESIUM_TRACE("compute tangents");
-    computeTangentSpace(StaticMeshBuildVertices);
+  {
+    // The attributes are written directly into the vertex buffers, rather
+    // than into an array of FStaticMeshBuildVertex that is then copied.
+    CESIUM_TRACE("copy vertex attributes");
+    sources.positions = positionView;
+    TMeshVector3 origin(RenderData->Bounds.Origin);
+    float maxDistanceSquared =
+        remapVertices ? copyVertexAttributes<true>(
+                            sources,
+                            vertexSources,
+                            origin,
+                            vertexBuffers)
+                      : copyVertexAttributes<false>(
+                            sources,
+                            indices,
+                            origin,
+                            vertexBuffers);
+    RenderData->Bounds.SphereRadius = FMath::Sqrt(maxDistanceSquared);
   }
 
-  {
-    CESIUM_TRACE("init buffers");
-    LODResources.VertexBuffers.PositionVertexBuffer.Init(
-        StaticMeshBuildVertices,
-        false);
+  // The feature IDs are found before the indices are reordered below, because
+  // the sources of duplicated vertices are the indices.
+  CesiumScratchArray<int32> vertexFeatureIDsScratch;
+  TArray<int32>& vertexFeatureIDs = *vertexFeatureIDsScratch;
+  getVertexFeatureIDs(
+      model,
+      firstFeatureTable,
+      numVertices,
+      remapVertices ? &vertexSources : nullptr,
+      vertexFeatureIDs);
+
+  if (hasFeatureIdChannel && vertexFeatureIDs.Num() > 0) {
+    CESIUM_TRACE("copy feature IDs");
+    for (uint32 i = 0; i < numVertices; ++i) {
+      vertexBuffers.StaticMeshVertexBuffer.SetVertexUV(
+          i,
+          featureIdChannel,
+          TMeshVector2(static_cast<float>(vertexFeatureIDs[i]), 0.0f));
+    }
+  }
 
-    FColorVertexBuffer& ColorVertexBuffer =
-        LODResources.VertexBuffers.ColorVertexBuffer;
-    if (hasVertexColors) {
-      ColorVertexBuffer.Init(StaticMeshBuildVertices, false);
+  if (!hasNormals && duplicateVertices) {
+    CESIUM_TRACE("compute flat normals");
+    CesiumConversionBenchmark::ScopedStage stage(
+        options.pMeshOptions->pNodeOptions->pModelOptions->pBenchmarkTimings,
+        CesiumConversionBenchmark::Stage::FlatNormals,
+        numVertices,
+        numVertices * sizeof(TMeshVector3) + indices.Num() * sizeof(uint32));
+    computeFlatNormals(sources, indices, vertexBuffers);
+  }
+
+  if (needsTangents && !hasTangents) {
+    // Note that this assumes normals and UVs are already populated.
+    CESIUM_TRACE("compute tangents");
+    CesiumConversionBenchmark::ScopedStage stage(
+        options.pMeshOptions->pNodeOptions->pModelOptions->pBenchmarkTimings,
+        CesiumConversionBenchmark::Stage::TangentSpace,
+        numVertices,
+        numVertices * sizeof(TMeshVector3) + indices.Num() * sizeof(uint32));
+    if (duplicateVertices) {
+      computeTangentSpace(sources, indices, vertexBuffers);
+    } else {
+      computeIndexedTangents(sources, indices, vertexOrder, vertexBuffers);
     }
-
-    LODResources.VertexBuffers.StaticMeshVertexBuffer.Init(
-        StaticMeshBuildVertices,
-        textureCoordinateMap.size() == 0 ? 1 : textureCoordinateMap.size(),
-        false);
   }
 
 #if ENGINE_MAJOR_VERSION == 5
@@ -965,7 +2656,7 @@ static void loadPrimitive(
   section.NumTriangles = indices.Num() / 3;
   section.FirstIndex = 0;
   section.MinVertexIndex = 0;
-  section.MaxVertexIndex = StaticMeshBuildVertices.Num() - 1;
+  section.MaxVertexIndex = numVertices - 1;
   section.bEnableCollision = true;
   section.bCastShadow = true;
 
@@ -992,7 +2683,7 @@ static void loadPrimitive(
     CESIUM_TRACE("SetIndices");
     LODResources.IndexBuffer.SetIndices(
         indices,
-        StaticMeshBuildVertices.Num() >= std::numeric_limits<uint16>::max()
+        numVertices >= std::numeric_limits<uint16>::max()
             ? EIndexBufferStride::Type::Force32Bit
             : EIndexBufferStride::Type::Force16Bit);
   }
@@ -1012,25 +2703,29 @@ static void loadPrimitive(
 
   section.MaterialIndex = 0;
 
-  primitiveResult.pCollisionMesh = nullptr;
+  buildFarFieldGeometry(
+      primitiveResult,
+      transform,
+      options,
+      pbrMetallicRoughness,
+      vertexBuffers,
+      indices);
 
-  if (StaticMeshBuildVertices.Num() != 0 && indices.Num() != 0) {
-#if PHYSICS_INTERFACE_PHYSX
-    CESIUM_TRACE("PhysX cook");
-    BuildPhysXTriangleMeshes(
-        primitiveResult.pCollisionMesh,
-        options.pMeshOptions->pNodeOptions->pModelOptions->pPhysXCooking,
-        StaticMeshBuildVertices,
-        indices);
-#else
-    CESIUM_TRACE("Chaos cook");
-    primitiveResult.pCollisionMesh =
-        BuildChaosTriangleMeshes(StaticMeshBuildVertices, indices);
-#endif
+  {
+    CesiumScratchArray<TMeshVector3> positionsScratch;
+    TArray<TMeshVector3>& positions = *positionsScratch;
+    positions.SetNum(numVertices);
+    for (uint32 i = 0; i < numVertices; ++i) {
+      positions[i] = vertexBuffers.PositionVertexBuffer.VertexPosition(i);
+    }
+    cookCollisionMesh(
+        primitiveResult,
+        transform,
+        options,
+        MoveTemp(positions),
+        MoveTemp(indices),
+        vertexFeatureIDs);
   }
-
-  // load primitive metadata
-  primitiveResult.Metadata = loadMetadataPrimitive(model, primitive);
 }
 
 static void loadIndexedPrimitive(
@@ -1038,7 +2733,7 @@ static void loadIndexedPrimitive(
     const glm::dmat4x4& transform,
     const CreatePrimitiveOptions& options,
     const CesiumGltf::Accessor& positionAccessor,
-    const CesiumGltf::AccessorView<TMeshVector3>& positionView) {
+    const StridedAccessor<TMeshVector3>& positionView) {
 
   const Model& model =
       *options.pMeshOptions->pNodeOptions->pModelOptions->pModel;
@@ -1048,7 +2743,7 @@ static void loadIndexedPrimitive(
       model.accessors[primitive.indices];
   if (indexAccessorGltf.componentType ==
       CesiumGltf::Accessor::ComponentType::BYTE) {
-    CesiumGltf::AccessorView<int8_t> indexAccessor(model, primitive.indices);
+    StridedAccessor<int8_t> indexAccessor(model, primitive.indices);
     loadPrimitive(
         primitiveResult,
         transform,
@@ -1059,7 +2754,7 @@ static void loadIndexedPrimitive(
   } else if (
       indexAccessorGltf.componentType ==
       CesiumGltf::Accessor::ComponentType::UNSIGNED_BYTE) {
-    CesiumGltf::AccessorView<uint8_t> indexAccessor(model, primitive.indices);
+    StridedAccessor<uint8_t> indexAccessor(model, primitive.indices);
     loadPrimitive(
         primitiveResult,
         transform,
@@ -1070,7 +2765,7 @@ static void loadIndexedPrimitive(
   } else if (
       indexAccessorGltf.componentType ==
       CesiumGltf::Accessor::ComponentType::SHORT) {
-    CesiumGltf::AccessorView<int16_t> indexAccessor(model, primitive.indices);
+    StridedAccessor<int16_t> indexAccessor(model, primitive.indices);
     loadPrimitive(
         primitiveResult,
         transform,
@@ -1081,7 +2776,7 @@ static void loadIndexedPrimitive(
   } else if (
       indexAccessorGltf.componentType ==
       CesiumGltf::Accessor::ComponentType::UNSIGNED_SHORT) {
-    CesiumGltf::AccessorView<uint16_t> indexAccessor(model, primitive.indices);
+    StridedAccessor<uint16_t> indexAccessor(model, primitive.indices);
     loadPrimitive(
         primitiveResult,
         transform,
@@ -1092,7 +2787,7 @@ static void loadIndexedPrimitive(
   } else if (
       indexAccessorGltf.componentType ==
       CesiumGltf::Accessor::ComponentType::UNSIGNED_INT) {
-    CesiumGltf::AccessorView<uint32_t> indexAccessor(model, primitive.indices);
+    StridedAccessor<uint32_t> indexAccessor(model, primitive.indices);
     loadPrimitive(
         primitiveResult,
         transform,
@@ -1127,9 +2822,13 @@ static void loadPrimitive(
     return;
   }
 
-  CesiumGltf::AccessorView<TMeshVector3> positionView(
-      model,
-      *pPositionAccessor);
+  StridedAccessor<TMeshVector3> positionView(model, *pPositionAccessor);
+
+  CesiumConversionBenchmark::ScopedStage stage(
+      options.pMeshOptions->pNodeOptions->pModelOptions->pBenchmarkTimings,
+      CesiumConversionBenchmark::Stage::LoadPrimitive,
+      positionView.size(),
+      positionView.size() * sizeof(TMeshVector3));
 
   if (primitive.indices < 0 || primitive.indices >= model.accessors.size()) {
     std::vector<uint32_t> syntheticIndexBuffer(positionView.size());
@@ -1154,31 +2853,149 @@ static void loadPrimitive(
   }
 }
 
+namespace {
+/**
+ * A primitive found while traversing the nodes of a model, to be loaded into
+ * its result slot once the traversal is complete. The slot is identified by
+ * indices, because the node results may be reallocated during the traversal,
+ * and the options are stored by value, because the options created during
+ * the traversal don't outlive it.
+ */
+struct PrimitiveLoadJob {
+  size_t nodeIndex;
+  size_t primitiveIndex;
+  glm::dmat4x4 transform;
+  CreateNodeOptions nodeOptions;
+  const CesiumGltf::Mesh* pMesh;
+  const CesiumGltf::MeshPrimitive* pPrimitive;
+  std::shared_ptr<const TArray<FTransform>> pInstanceTransforms;
+};
+} // namespace
+
+/**
+ * Reads the transforms of the instances of a node from its
+ * EXT_mesh_gpu_instancing extension, relative to the node. Returns nullptr if
+ * the node is not instanced or its instances can't be read.
+ */
+static std::shared_ptr<const TArray<FTransform>>
+loadInstanceTransforms(const Model& model, const Node& node) {
+  const CesiumUtility::JsonValue* pExtension =
+      node.getGenericExtension("EXT_mesh_gpu_instancing");
+  const CesiumUtility::JsonValue::Object* pObject =
+      pExtension ? std::get_if<CesiumUtility::JsonValue::Object>(
+                       &pExtension->value)
+                 : nullptr;
+  if (!pObject) {
+    return nullptr;
+  }
+
+  auto attributesIt = pObject->find("attributes");
+  const CesiumUtility::JsonValue::Object* pAttributes =
+      attributesIt != pObject->end()
+          ? std::get_if<CesiumUtility::JsonValue::Object>(
+                &attributesIt->second.value)
+          : nullptr;
+  if (!pAttributes) {
+    return nullptr;
+  }
+
+  auto getAccessorID = [pAttributes](const std::string& name) {
+    auto it = pAttributes->find(name);
+    return it != pAttributes->end()
+               ? static_cast<int32_t>(it->second.getSafeNumberOrDefault(-1))
+               : -1;
+  };
+  const int32_t translationID = getAccessorID("TRANSLATION");
+  const int32_t rotationID = getAccessorID("ROTATION");
+  const int32_t scaleID = getAccessorID("SCALE");
+
+  // Quantized rotations are not supported yet, so those instances are drawn
+  // once, without instancing.
+  AccessorView<AccessorTypes::VEC3<float>> translations(model, translationID);
+  AccessorView<AccessorTypes::VEC4<float>> rotations(model, rotationID);
+  AccessorView<AccessorTypes::VEC3<float>> scales(model, scaleID);
+  const bool hasTranslations =
+      translations.status() == CesiumGltf::AccessorViewStatus::Valid;
+  const bool hasRotations =
+      rotations.status() == CesiumGltf::AccessorViewStatus::Valid;
+  const bool hasScales =
+      scales.status() == CesiumGltf::AccessorViewStatus::Valid;
+  if ((translationID >= 0 && !hasTranslations) ||
+      (rotationID >= 0 && !hasRotations) || (scaleID >= 0 && !hasScales)) {
+    UE_LOG(
+        LogCesium,
+        Warning,
+        TEXT("Unsupported EXT_mesh_gpu_instancing attributes, the node is "
+             "drawn without instancing"));
+    return nullptr;
+  }
+
+  const int64_t count = hasTranslations ? translations.size()
+                        : hasRotations  ? rotations.size()
+                        : hasScales     ? scales.size()
+                                        : 0;
+  if (count == 0 || (hasTranslations && translations.size() != count) ||
+      (hasRotations && rotations.size() != count) ||
+      (hasScales && scales.size() != count)) {
+    return nullptr;
+  }
+
+  CESIUM_TRACE("loadInstanceTransforms");
+  auto pTransforms = std::make_shared<TArray<FTransform>>();
+  pTransforms->SetNum(static_cast<int32>(count));
+  for (int64_t i = 0; i < count; ++i) {
+    FTransform& transform = (*pTransforms)[static_cast<int32>(i)];
+    if (hasTranslations) {
+      const auto& t = translations[i].value;
+      transform.SetTranslation(FVector(t[0], t[1], t[2]));
+    }
+    if (hasRotations) {
+      const auto& r = rotations[i].value;
+      transform.SetRotation(FQuat(r[0], r[1], r[2], r[3]).GetNormalized());
+    }
+    if (hasScales) {
+      const auto& s = scales[i].value;
+      transform.SetScale3D(FVector(s[0], s[1], s[2]));
+    }
+  }
+  return pTransforms;
+}
+
 static void loadMesh(
-    std::optional<LoadMeshResult>& result,
+    std::vector<LoadNodeResult>& loadNodeResults,
     const glm::dmat4x4& transform,
-    const CreateMeshOptions& options) {
+    const CreateMeshOptions& options,
+    std::vector<PrimitiveLoadJob>& jobs,
+    const std::shared_ptr<const TArray<FTransform>>& pInstanceTransforms =
+        nullptr) {
 
   CESIUM_TRACE("loadMesh");
 
-  const Model& model = *options.pNodeOptions->pModelOptions->pModel;
   const Mesh& mesh = *options.pMesh;
 
+  // The mesh belongs to the last node result.
+  size_t nodeIndex = loadNodeResults.size() - 1;
+  std::optional<LoadMeshResult>& result = loadNodeResults.back().meshResult;
   result = LoadMeshResult();
+  result->primitiveResults.resize(mesh.primitives.size());
 
-  for (const CesiumGltf::MeshPrimitive& primitive : mesh.primitives) {
-    CreatePrimitiveOptions primitiveOptions = {&options, &primitive};
-    loadPrimitive(
-        result->primitiveResults.emplace_back(),
+  for (size_t i = 0; i < mesh.primitives.size(); ++i) {
+    jobs.push_back(PrimitiveLoadJob{
+        nodeIndex,
+        i,
         transform,
-        primitiveOptions);
+        *options.pNodeOptions,
+        &mesh,
+        &mesh.primitives[i],
+        pInstanceTransforms});
   }
 }
 
 static void loadNode(
     std::vector<LoadNodeResult>& loadNodeResults,
     const glm::dmat4x4& transform,
-    const CreateNodeOptions& options) {
+    const CreateNodeOptions& options,
+    std::vector<PrimitiveLoadJob>& jobs) {
   static constexpr std::array<double, 16> identityMatrix = {
       1.0,
       0.0,
@@ -1202,7 +3019,7 @@ static void loadNode(
   const Model& model = *options.pModelOptions->pModel;
   const Node& node = *options.pNode;
 
-  LoadNodeResult& result = loadNodeResults.emplace_back();
+  loadNodeResults.emplace_back();
 
   glm::dmat4x4 nodeTransform = transform;
 
@@ -1250,69 +3067,638 @@ static void loadNode(
         nodeTransform * translation * glm::dmat4(rotationQuat) * scale;
   }
 
-  int meshId = node.mesh;
-  if (meshId >= 0 && meshId < model.meshes.size()) {
-    CreateMeshOptions meshOptions = {&options, &model.meshes[meshId]};
-    loadMesh(result.meshResult, nodeTransform, meshOptions);
+  int meshId = node.mesh;
+  if (meshId >= 0 && meshId < model.meshes.size()) {
+    CreateMeshOptions meshOptions = {&options, &model.meshes[meshId]};
+    loadMesh(
+        loadNodeResults,
+        nodeTransform,
+        meshOptions,
+        jobs,
+        loadInstanceTransforms(model, node));
+  }
+
+  for (int childNodeId : node.children) {
+    if (childNodeId >= 0 && childNodeId < model.nodes.size()) {
+      CreateNodeOptions childNodeOptions = {
+          options.pModelOptions,
+          &model.nodes[childNodeId]};
+      loadNode(loadNodeResults, nodeTransform, childNodeOptions, jobs);
+    }
+  }
+}
+
+namespace {
+/**
+ * @brief Apply the transform so that the up-axis of the given model is the
+ * Z-axis.
+ *
+ * By default, the up-axis of a glTF model will the the Y-axis.
+ *
+ * If the tileset that contained the model had the `asset.gltfUpAxis` string
+ * property, then the information about the up-axis has been stored in as a
+ * number property called `gltfUpAxis` in the `extras` of the given model.
+ *
+ * Depending on whether this value is CesiumGeometry::Axis::X, Y, or Z,
+ * the given matrix will be multiplied with a matrix that converts the
+ * respective axis to be the Z-axis, as required by the 3D Tiles standard.
+ *
+ * @param model The glTF model
+ * @param rootTransform The matrix that will be multiplied with the transform
+ */
+void applyGltfUpAxisTransform(
+    const CesiumGltf::Model& model,
+    glm::dmat4x4& rootTransform) {
+
+  auto gltfUpAxisIt = model.extras.find("gltfUpAxis");
+  if (gltfUpAxisIt == model.extras.end()) {
+    // The default up-axis of glTF is the Y-axis, and no other
+    // up-axis was specified. Transform the Y-axis to the Z-axis,
+    // to match the 3D Tiles specification
+    rootTransform *= CesiumGeometry::AxisTransforms::Y_UP_TO_Z_UP;
+    return;
+  }
+  const CesiumUtility::JsonValue& gltfUpAxis = gltfUpAxisIt->second;
+  int gltfUpAxisValue = static_cast<int>(gltfUpAxis.getSafeNumberOrDefault(1));
+  if (gltfUpAxisValue == static_cast<int>(CesiumGeometry::Axis::X)) {
+    rootTransform *= CesiumGeometry::AxisTransforms::X_UP_TO_Z_UP;
+  } else if (gltfUpAxisValue == static_cast<int>(CesiumGeometry::Axis::Y)) {
+    rootTransform *= CesiumGeometry::AxisTransforms::Y_UP_TO_Z_UP;
+  } else if (gltfUpAxisValue == static_cast<int>(CesiumGeometry::Axis::Z)) {
+    // No transform required
+  } else {
+    UE_LOG(
+        LogCesium,
+        VeryVerbose,
+        TEXT("Unknown gltfUpAxis value: {}"),
+        gltfUpAxisValue);
+  }
+}
+} // namespace
+
+/**
+ * Gets the key under which the material instance of the given primitive can be
+ * shared with the other primitives of the same model, or an empty string if it
+ * can't be shared. Primitives with the same key get identical parameters.
+ */
+static FString getSharedMaterialKey(
+    const LoadPrimitiveResult& loadResult,
+    const UMaterialInterface* pBaseMaterial) {
+  // The water mask, the feature metadata texture, and the heightfield
+  // textures are different for every primitive.
+  if ((!loadResult.onlyLand && !loadResult.onlyWater) ||
+      loadResult.featureMetadataTexture || loadResult.heightfield) {
+    return FString();
+  }
+
+  static_assert(maximumOverlayTextureCoordinateIDs == 2);
+  FString key = FString::Printf(
+      TEXT("%p %p %d %d %d %d %f %f %f"),
+      pBaseMaterial,
+      loadResult.pMaterial,
+      static_cast<int32>(loadResult.flatNormalsInMaterial),
+      static_cast<int32>(loadResult.onlyWater),
+      loadResult.overlayTextureCoordinateIDToUVIndex[0],
+      loadResult.overlayTextureCoordinateIDToUVIndex[1],
+      loadResult.waterMaskTranslationX,
+      loadResult.waterMaskTranslationY,
+      loadResult.waterMaskScale);
+
+  std::map<std::string, uint32_t> textureCoordinateParameters(
+      loadResult.textureCoordinateParameters.begin(),
+      loadResult.textureCoordinateParameters.end());
+  for (const auto& parameter : textureCoordinateParameters) {
+    key += FString::Printf(
+        TEXT(" %s=%u"),
+        UTF8_TO_TCHAR(parameter.first.c_str()),
+        parameter.second);
+  }
+
+  return key;
+}
+
+/**
+ * Gets the key under which the given primitive can be merged with the other
+ * primitives of the same model, or an empty string if it can't be merged.
+ * Primitives with the same key have the same transform, material parameters,
+ * and vertex format.
+ */
+static FString getMergeKey(const LoadPrimitiveResult& primitive) {
+  if (!primitive.RenderData || primitive.collisionOnly ||
+      primitive.pointCloud || primitive.pInstanceTransforms) {
+    return FString();
+  }
+
+  // Faces are mapped to feature IDs by their index in the primitive, so
+  // primitives with feature metadata keep their own components.
+  if (hasFaceMetadata(*primitive.pMeshPrimitive)) {
+    return FString();
+  }
+
+  FString key = getSharedMaterialKey(primitive, nullptr);
+  if (key.IsEmpty()) {
+    return key;
+  }
+
+  const FStaticMeshVertexBuffers& vertexBuffers =
+      primitive.RenderData->LODResources[0].VertexBuffers;
+  const FStaticMeshVertexBuffer& meshBuffer =
+      vertexBuffers.StaticMeshVertexBuffer;
+  key += FString::Printf(
+      TEXT(" %u %d %d %d"),
+      meshBuffer.GetNumTexCoords(),
+      static_cast<int32>(meshBuffer.GetUseHighPrecisionTangentBasis()),
+      static_cast<int32>(meshBuffer.GetUseFullPrecisionUVs()),
+      static_cast<int32>(vertexBuffers.ColorVertexBuffer.GetNumVertices() > 0));
+
+  for (glm::length_t column = 0; column < 4; ++column) {
+    for (glm::length_t row = 0; row < 4; ++row) {
+      key += FString::Printf(TEXT(" %.17g"), primitive.transform[column][row]);
+    }
+  }
+
+  return key;
+}
+
+/**
+ * Copies the vertices of one vertex buffer into another with the same format,
+ * starting at the given vertex.
+ */
+static void copyVertexBuffers(
+    const FStaticMeshVertexBuffers& source,
+    FStaticMeshVertexBuffers& target,
+    uint32 firstVertex) {
+  uint32 numVertices = source.PositionVertexBuffer.GetNumVertices();
+  if (numVertices == 0) {
+    return;
+  }
+
+  uint32 positionStride = source.PositionVertexBuffer.GetStride();
+  FMemory::Memcpy(
+      static_cast<uint8*>(target.PositionVertexBuffer.GetVertexData()) +
+          firstVertex * positionStride,
+      source.PositionVertexBuffer.GetVertexData(),
+      numVertices * positionStride);
+
+  const FStaticMeshVertexBuffer& sourceMesh = source.StaticMeshVertexBuffer;
+  FStaticMeshVertexBuffer& targetMesh = target.StaticMeshVertexBuffer;
+  uint32 tangentStride = sourceMesh.GetTangentSize() / numVertices;
+  FMemory::Memcpy(
+      static_cast<uint8*>(targetMesh.GetTangentData()) +
+          firstVertex * tangentStride,
+      sourceMesh.GetTangentData(),
+      sourceMesh.GetTangentSize());
+  uint32 texCoordStride = sourceMesh.GetTexCoordSize() / numVertices;
+  FMemory::Memcpy(
+      static_cast<uint8*>(targetMesh.GetTexCoordData()) +
+          firstVertex * texCoordStride,
+      sourceMesh.GetTexCoordData(),
+      sourceMesh.GetTexCoordSize());
+
+  if (source.ColorVertexBuffer.GetNumVertices() > 0) {
+    uint32 colorStride = source.ColorVertexBuffer.GetStride();
+    FMemory::Memcpy(
+        static_cast<uint8*>(target.ColorVertexBuffer.GetVertexData()) +
+            firstVertex * colorStride,
+        source.ColorVertexBuffer.GetVertexData(),
+        numVertices * colorStride);
+  }
+}
+
+/**
+ * Merges the given primitives, which have the same merge key, into the first
+ * of them, as a single mesh section. The others are left without render data,
+ * so no components are created for them.
+ */
+static void mergePrimitives(const TArray<LoadPrimitiveResult*>& primitives) {
+  LoadPrimitiveResult& target = *primitives[0];
+
+  uint32 numVertices = 0;
+  for (const LoadPrimitiveResult* pPrimitive : primitives) {
+    numVertices += pPrimitive->RenderData->LODResources[0]
+                       .VertexBuffers.PositionVertexBuffer.GetNumVertices();
+  }
+
+  FStaticMeshRenderData* RenderData = new FStaticMeshRenderData();
+  RenderData->AllocateLODResources(1);
+  FStaticMeshLODResources& LODResources = RenderData->LODResources[0];
+  FStaticMeshVertexBuffers& vertexBuffers = LODResources.VertexBuffers;
+
+  const FStaticMeshVertexBuffers& firstBuffers =
+      target.RenderData->LODResources[0].VertexBuffers;
+  vertexBuffers.StaticMeshVertexBuffer.SetUseHighPrecisionTangentBasis(
+      firstBuffers.StaticMeshVertexBuffer.GetUseHighPrecisionTangentBasis());
+  vertexBuffers.StaticMeshVertexBuffer.SetUseFullPrecisionUVs(
+      firstBuffers.StaticMeshVertexBuffer.GetUseFullPrecisionUVs());
+  vertexBuffers.PositionVertexBuffer.Init(numVertices, false);
+  vertexBuffers.StaticMeshVertexBuffer.Init(
+      numVertices,
+      firstBuffers.StaticMeshVertexBuffer.GetNumTexCoords(),
+      false);
+  if (firstBuffers.ColorVertexBuffer.GetNumVertices() > 0) {
+    vertexBuffers.ColorVertexBuffer.Init(numVertices, false);
+  }
+
+  TArray<uint32> indices;
+  CesiumScratchArray<uint32> primitiveIndicesScratch;
+  TArray<uint32>& primitiveIndices = *primitiveIndicesScratch;
+  uint32 firstVertex = 0;
+  RenderData->Bounds = target.RenderData->Bounds;
+  std::shared_ptr<DeferredCollisionMesh> pDeferredCollision =
+      target.pDeferredCollision;
+  std::shared_ptr<CesiumFarFieldGeometry> pFarFieldGeometry;
+  TArray<TMeshVector3> queryPositions;
+  TArray<uint32> queryIndices;
+
+  for (LoadPrimitiveResult* pPrimitive : primitives) {
+    // The hierarchies are built again over the triangles of all the merged
+    // primitives.
+    if (pPrimitive->pQueryBVH) {
+      const uint32 firstPosition = queryPositions.Num();
+      queryPositions.Append(pPrimitive->pQueryBVH->getPositions());
+      for (uint32 index : pPrimitive->pQueryBVH->getIndices()) {
+        queryIndices.Add(firstPosition + index);
+      }
+      pPrimitive->pQueryBVH.reset();
+    }
+
+    const FStaticMeshLODResources& source =
+        pPrimitive->RenderData->LODResources[0];
+    copyVertexBuffers(source.VertexBuffers, vertexBuffers, firstVertex);
+
+    // The indices have already had their winding order reversed.
+    source.IndexBuffer.GetCopy(primitiveIndices);
+    for (uint32 index : primitiveIndices) {
+      indices.Add(firstVertex + index);
+    }
+    firstVertex += source.VertexBuffers.PositionVertexBuffer.GetNumVertices();
+
+    if (pPrimitive == &target) {
+      continue;
+    }
+
+    RenderData->Bounds = RenderData->Bounds + pPrimitive->RenderData->Bounds;
+
+    // The cooked forms of the collision meshes are moved along with them.
+    if (pPrimitive->pCollisionMesh) {
+      if (target.pCollisionMesh) {
+        target.mergedCollisionMeshes.push_back(pPrimitive->pCollisionMesh);
+        target.mergedCookedCollisionMeshes.push_back(
+            MoveTemp(pPrimitive->cookedCollisionMesh));
+      } else {
+        target.pCollisionMesh = pPrimitive->pCollisionMesh;
+        target.cookedCollisionMesh = MoveTemp(pPrimitive->cookedCollisionMesh);
+      }
+    }
+    target.mergedCollisionMeshes.insert(
+        target.mergedCollisionMeshes.end(),
+        pPrimitive->mergedCollisionMeshes.begin(),
+        pPrimitive->mergedCollisionMeshes.end());
+    pPrimitive->mergedCookedCollisionMeshes.resize(
+        pPrimitive->mergedCollisionMeshes.size());
+    target.mergedCookedCollisionMeshes.resize(
+        target.mergedCollisionMeshes.size() -
+        pPrimitive->mergedCollisionMeshes.size());
+    for (TArray<uint8>& cooked : pPrimitive->mergedCookedCollisionMeshes) {
+      target.mergedCookedCollisionMeshes.push_back(MoveTemp(cooked));
+    }
+    target.collisionBytes += pPrimitive->collisionBytes;
+
+    if (pPrimitive->pDeferredCollision) {
+      const DeferredCollisionMesh& mesh = *pPrimitive->pDeferredCollision;
+      if (!pDeferredCollision) {
+        pDeferredCollision = std::make_shared<DeferredCollisionMesh>();
+        pDeferredCollision->bounds = FBox(ForceInit);
+      }
+      uint32 firstPosition = pDeferredCollision->positions.Num();
+      pDeferredCollision->positions.Append(mesh.positions);
+      for (uint32 index : mesh.indices) {
+        pDeferredCollision->indices.Add(firstPosition + index);
+      }
+      pDeferredCollision->bounds += mesh.bounds;
+    }
+
+    if (pPrimitive->pFarFieldGeometry) {
+      if (!pFarFieldGeometry) {
+        pFarFieldGeometry = target.pFarFieldGeometry
+                                ? std::make_shared<CesiumFarFieldGeometry>(
+                                      *target.pFarFieldGeometry)
+                                : std::make_shared<CesiumFarFieldGeometry>();
+      }
+      const CesiumFarFieldGeometry& geometry = *pPrimitive->pFarFieldGeometry;
+      uint32 firstPosition = pFarFieldGeometry->positions.Num();
+      pFarFieldGeometry->positions.Append(geometry.positions);
+      pFarFieldGeometry->colors.Append(geometry.colors);
+      for (uint32 index : geometry.indices) {
+        pFarFieldGeometry->indices.Add(firstPosition + index);
+      }
+    }
+
+    delete pPrimitive->RenderData;
+    pPrimitive->RenderData = nullptr;
+    pPrimitive->pCollisionMesh = nullptr;
+    pPrimitive->mergedCollisionMeshes.clear();
+    pPrimitive->cookedCollisionMesh.Empty();
+    pPrimitive->mergedCookedCollisionMeshes.clear();
+    pPrimitive->collisionBytes = 0;
+    pPrimitive->pDeferredCollision.reset();
+    pPrimitive->pFarFieldGeometry.reset();
+  }
+  target.pDeferredCollision = std::move(pDeferredCollision);
+  if (queryIndices.Num() > 0) {
+    target.pQueryBVH = std::make_shared<const CesiumTriangleBVH>(
+        MoveTemp(queryPositions),
+        MoveTemp(queryIndices));
+  }
+  if (pFarFieldGeometry) {
+    target.pFarFieldGeometry = std::move(pFarFieldGeometry);
+  }
+
+#if ENGINE_MAJOR_VERSION == 5
+  FStaticMeshSectionArray& Sections = LODResources.Sections;
+#else
+  FStaticMeshLODResources::FStaticMeshSectionArray& Sections =
+      LODResources.Sections;
+#endif
+
+  FStaticMeshSection& section = Sections.AddDefaulted_GetRef();
+  section.NumTriangles = indices.Num() / 3;
+  section.FirstIndex = 0;
+  section.MinVertexIndex = 0;
+  section.MaxVertexIndex = numVertices - 1;
+  section.bEnableCollision = true;
+  section.bCastShadow = true;
+  section.MaterialIndex = 0;
+
+  LODResources.IndexBuffer.SetIndices(
+      indices,
+      numVertices >= std::numeric_limits<uint16>::max()
+          ? EIndexBufferStride::Type::Force32Bit
+          : EIndexBufferStride::Type::Force16Bit);
+
+  LODResources.bHasDepthOnlyIndices = false;
+  LODResources.bHasReversedIndices = false;
+  LODResources.bHasReversedDepthOnlyIndices = false;
+#if ENGINE_MAJOR_VERSION < 5
+  LODResources.bHasAdjacencyInfo = false;
+#endif
+
+  delete target.RenderData;
+  target.RenderData = RenderData;
+}
+
+/**
+ * Merges the primitives of a model that can be drawn together, so that fewer
+ * components and draw calls are needed for it.
+ */
+static void mergePrimitives(LoadModelResult& result) {
+  CESIUM_TRACE("mergePrimitives");
+
+  TMap<FString, TArray<LoadPrimitiveResult*>> groups;
+  for (LoadNodeResult& node : result.nodeResults) {
+    if (!node.meshResult) {
+      continue;
+    }
+    for (LoadPrimitiveResult& primitive : node.meshResult->primitiveResults) {
+      FString key = getMergeKey(primitive);
+      if (!key.IsEmpty()) {
+        groups.FindOrAdd(key).Add(&primitive);
+      }
+    }
+  }
+
+  for (const auto& group : groups) {
+    if (group.Value.Num() > 1) {
+      mergePrimitives(group.Value);
+    }
+  }
+}
+
+#if CESIUM_BUILD_NANITE
+/**
+ * Whether the glTF material and water of the given primitive can be rendered
+ * by Nanite, which only supports opaque materials.
+ */
+static bool canBuildNaniteResources(const LoadPrimitiveResult& primitive) {
+  if (!primitive.RenderData || primitive.collisionOnly ||
+      primitive.pointCloud) {
+    return false;
+  }
+  if (!primitive.onlyLand || primitive.onlyWater) {
+    return false;
+  }
+  return !primitive.pMaterial || primitive.pMaterial->alphaMode ==
+                                     CesiumGltf::Material::AlphaMode::OPAQUE;
+}
+
+/**
+ * Builds the Nanite resources of the given render data from its vertex and
+ * index buffers, which are kept as the fallback mesh.
+ */
+static void buildNaniteResources(
+    INaniteBuilderModule& naniteBuilder,
+    FStaticMeshRenderData& renderData) {
+  CESIUM_TRACE("build Nanite resources");
+
+  const FStaticMeshLODResources& lod = renderData.LODResources[0];
+  const FStaticMeshVertexBuffers& vertexBuffers = lod.VertexBuffers;
+  const FStaticMeshVertexBuffer& meshBuffer =
+      vertexBuffers.StaticMeshVertexBuffer;
+  uint32 numVertices = vertexBuffers.PositionVertexBuffer.GetNumVertices();
+  uint32 numTexCoords = meshBuffer.GetNumTexCoords();
+  bool hasColors = vertexBuffers.ColorVertexBuffer.GetNumVertices() > 0;
+
+  CesiumScratchArray<FStaticMeshBuildVertex> verticesScratch;
+  TArray<FStaticMeshBuildVertex>& vertices = *verticesScratch;
+  vertices.SetNum(numVertices);
+  for (uint32 i = 0; i < numVertices; ++i) {
+    FStaticMeshBuildVertex& vertex = vertices[i];
+    vertex.Position = vertexBuffers.PositionVertexBuffer.VertexPosition(i);
+    vertex.TangentX = FVector3f(meshBuffer.VertexTangentX(i));
+    vertex.TangentY = FVector3f(meshBuffer.VertexTangentY(i));
+    vertex.TangentZ = FVector3f(meshBuffer.VertexTangentZ(i));
+    for (uint32 uv = 0; uv < numTexCoords; ++uv) {
+      vertex.UVs[uv] = meshBuffer.GetVertexUV(i, uv);
+    }
+    vertex.Color =
+        hasColors ? vertexBuffers.ColorVertexBuffer.VertexColor(i)
+                  : FColor::White;
+  }
+
+  CesiumScratchArray<uint32> indicesScratch;
+  TArray<uint32>& indices = *indicesScratch;
+  lod.IndexBuffer.GetCopy(indices);
+
+  uint32 numTriangles = indices.Num() / 3;
+  CesiumScratchArray<int32> materialIndicesScratch;
+  TArray<int32>& materialIndices = *materialIndicesScratch;
+  materialIndices.Init(0, numTriangles);
+  TArray<uint32> meshTriangleCounts;
+  meshTriangleCounts.Add(numTriangles);
+
+  FMeshNaniteSettings settings;
+  settings.bEnabled = true;
+
+  if (!naniteBuilder.Build(
+          renderData.NaniteResources,
+          vertices,
+          indices,
+          materialIndices,
+          meshTriangleCounts,
+          numTexCoords,
+          settings)) {
+    UE_LOG(
+        LogCesium,
+        Warning,
+        TEXT("Could not build Nanite resources, the regular mesh is used"));
+    renderData.NaniteResources = Nanite::FResources();
+  }
+}
+
+/**
+ * Builds the Nanite resources of the primitives of a model that Nanite can
+ * render, in parallel.
+ */
+static void buildNaniteResources(
+    INaniteBuilderModule& naniteBuilder,
+    LoadModelResult& result) {
+  CESIUM_TRACE("buildNaniteResources");
+
+  std::vector<FStaticMeshRenderData*> renderDatas;
+  for (LoadNodeResult& node : result.nodeResults) {
+    if (!node.meshResult) {
+      continue;
+    }
+    for (LoadPrimitiveResult& primitive : node.meshResult->primitiveResults) {
+      if (canBuildNaniteResources(primitive)) {
+        renderDatas.push_back(primitive.RenderData);
+      }
+    }
+  }
+
+  ParallelFor(
+      static_cast<int32>(renderDatas.size()),
+      [&naniteBuilder, &renderDatas](int32 i) {
+        buildNaniteResources(naniteBuilder, *renderDatas[i]);
+      },
+      renderDatas.size() < 2);
+}
+#endif
+
+/**
+ * Loads the glTF textures used by the materials of the given primitives. Each
+ * texture is loaded only once, and shared by all of the primitives that use
+ * it.
+ *
+ * @return The loaded textures, by index, or nullptr for the textures that are
+ * not used.
+ */
+static std::vector<CesiumTextureUtility::LoadedTextureResult*> loadTextures(
+    const Model& model,
+    const std::vector<PrimitiveLoadJob>& jobs,
+    const CreateModelOptions& options) {
+  CESIUM_TRACE("loadTextures");
+
+  std::vector<bool> used(model.textures.size(), false);
+  auto markUsed = [&model, &used](const auto& gltfTexture) {
+    if (gltfTexture && gltfTexture->index >= 0 &&
+        gltfTexture->index < model.textures.size()) {
+      used[gltfTexture->index] = true;
+    }
+  };
+
+  for (const PrimitiveLoadJob& job : jobs) {
+    int32_t materialID = job.pPrimitive->material;
+    if (materialID < 0 || materialID >= model.materials.size()) {
+      continue;
+    }
+
+    const CesiumGltf::Material& material = model.materials[materialID];
+    if (material.pbrMetallicRoughness) {
+      markUsed(material.pbrMetallicRoughness->baseColorTexture);
+      markUsed(material.pbrMetallicRoughness->metallicRoughnessTexture);
+    }
+    markUsed(material.normalTexture);
+    markUsed(material.occlusionTexture);
+    markUsed(material.emissiveTexture);
   }
 
-  for (int childNodeId : node.children) {
-    if (childNodeId >= 0 && childNodeId < model.nodes.size()) {
-      CreateNodeOptions childNodeOptions = {
-          options.pModelOptions,
-          &model.nodes[childNodeId]};
-      loadNode(loadNodeResults, nodeTransform, childNodeOptions);
+  std::vector<int32_t> textureIndices;
+  for (size_t i = 0; i < used.size(); ++i) {
+    if (used[i]) {
+      textureIndices.push_back(static_cast<int32_t>(i));
     }
   }
+
+  std::vector<CesiumTextureUtility::LoadedTextureResult*> textures(
+      model.textures.size(),
+      nullptr);
+  ParallelFor(
+      static_cast<int32>(textureIndices.size()),
+      [&model, &textureIndices, &textures, &options](int32 i) {
+        if (isCanceled(options)) {
+          return;
+        }
+        int32_t textureIndex = textureIndices[i];
+        const CesiumGltf::Image* pImage = Model::getSafe(
+            &model.images,
+            model.textures[textureIndex].source);
+        CesiumConversionBenchmark::ScopedStage stage(
+            options.pBenchmarkTimings,
+            CesiumConversionBenchmark::Stage::Textures,
+            0,
+            pImage ? int64(pImage->cesium.pixelData.size()) : 0);
+        textures[textureIndex] = CesiumTextureUtility::loadTextureAnyThreadPart(
+            model,
+            model.textures[textureIndex],
+            options.streamTextures,
+            options.pWrittenConvertedModel != nullptr,
+            options.maximumTextureSize);
+      },
+      textureIndices.size() < 2);
+
+  return textures;
 }
 
-namespace {
 /**
- * @brief Apply the transform so that the up-axis of the given model is the
- * Z-axis.
- *
- * By default, the up-axis of a glTF model will the the Y-axis.
- *
- * If the tileset that contained the model had the `asset.gltfUpAxis` string
- * property, then the information about the up-axis has been stored in as a
- * number property called `gltfUpAxis` in the `extras` of the given model.
- *
- * Depending on whether this value is CesiumGeometry::Axis::X, Y, or Z,
- * the given matrix will be multiplied with a matrix that converts the
- * respective axis to be the Z-axis, as required by the 3D Tiles standard.
- *
- * @param model The glTF model
- * @param rootTransform The matrix that will be multiplied with the transform
+ * Frees the loaded textures that no primitive of the result refers to, which
+ * are those of the primitives that failed to load. The others are owned by
+ * the primitives that refer to them.
  */
-void applyGltfUpAxisTransform(
-    const CesiumGltf::Model& model,
-    glm::dmat4x4& rootTransform) {
-
-  auto gltfUpAxisIt = model.extras.find("gltfUpAxis");
-  if (gltfUpAxisIt == model.extras.end()) {
-    // The default up-axis of glTF is the Y-axis, and no other
-    // up-axis was specified. Transform the Y-axis to the Z-axis,
-    // to match the 3D Tiles specification
-    rootTransform *= CesiumGeometry::AxisTransforms::Y_UP_TO_Z_UP;
-    return;
+static void releaseUnusedTextures(
+    LoadModelResult& result,
+    const std::vector<CesiumTextureUtility::LoadedTextureResult*>& textures) {
+  std::unordered_set<const CesiumTextureUtility::LoadedTextureResult*> used;
+  for (LoadNodeResult& node : result.nodeResults) {
+    if (!node.meshResult) {
+      continue;
+    }
+    for (LoadPrimitiveResult& primitive : node.meshResult->primitiveResults) {
+      // Primitives without render data are never created, except for
+      // heightfields. Merged primitives share the textures of the primitive
+      // they were merged into.
+      if (!primitive.RenderData && !primitive.heightfield) {
+        primitive.baseColorTexture = nullptr;
+        primitive.metallicRoughnessTexture = nullptr;
+        primitive.normalTexture = nullptr;
+        primitive.emissiveTexture = nullptr;
+        primitive.occlusionTexture = nullptr;
+        continue;
+      }
+      used.insert(primitive.baseColorTexture);
+      used.insert(primitive.metallicRoughnessTexture);
+      used.insert(primitive.normalTexture);
+      used.insert(primitive.emissiveTexture);
+      used.insert(primitive.occlusionTexture);
+    }
   }
-  const CesiumUtility::JsonValue& gltfUpAxis = gltfUpAxisIt->second;
-  int gltfUpAxisValue = static_cast<int>(gltfUpAxis.getSafeNumberOrDefault(1));
-  if (gltfUpAxisValue == static_cast<int>(CesiumGeometry::Axis::X)) {
-    rootTransform *= CesiumGeometry::AxisTransforms::X_UP_TO_Z_UP;
-  } else if (gltfUpAxisValue == static_cast<int>(CesiumGeometry::Axis::Y)) {
-    rootTransform *= CesiumGeometry::AxisTransforms::Y_UP_TO_Z_UP;
-  } else if (gltfUpAxisValue == static_cast<int>(CesiumGeometry::Axis::Z)) {
-    // No transform required
-  } else {
-    UE_LOG(
-        LogCesium,
-        VeryVerbose,
-        TEXT("Unknown gltfUpAxis value: {}"),
-        gltfUpAxisValue);
+
+  for (CesiumTextureUtility::LoadedTextureResult* pTexture : textures) {
+    if (pTexture && used.find(pTexture) == used.end()) {
+      CesiumTextureUtility::destroyHalfLoadedTexture(pTexture);
+    }
   }
 }
-} // namespace
 
 static LoadModelResult loadModelAnyThreadPart(
     const glm::dmat4x4& transform,
@@ -1321,6 +3707,7 @@ static LoadModelResult loadModelAnyThreadPart(
 
   const Model& model = *options.pModel;
   LoadModelResult result;
+  std::vector<PrimitiveLoadJob> jobs;
 
   glm::dmat4x4 rootTransform = transform;
 
@@ -1337,28 +3724,82 @@ static LoadModelResult loadModelAnyThreadPart(
     const CesiumGltf::Scene& defaultScene = model.scenes[model.scene];
     for (int nodeId : defaultScene.nodes) {
       CreateNodeOptions nodeOptions = {&options, &model.nodes[nodeId]};
-      loadNode(result.nodeResults, rootTransform, nodeOptions);
+      loadNode(result.nodeResults, rootTransform, nodeOptions, jobs);
     }
   } else if (model.scenes.size() > 0) {
     // There's no default, so show the first scene
     const CesiumGltf::Scene& defaultScene = model.scenes[0];
     for (int nodeId : defaultScene.nodes) {
       CreateNodeOptions nodeOptions = {&options, &model.nodes[nodeId]};
-      loadNode(result.nodeResults, rootTransform, nodeOptions);
+      loadNode(result.nodeResults, rootTransform, nodeOptions, jobs);
     }
   } else if (model.nodes.size() > 0) {
     // No scenes at all, use the first node as the root node.
     CreateNodeOptions nodeOptions = {&options, &model.nodes[0]};
-    loadNode(result.nodeResults, rootTransform, nodeOptions);
+    loadNode(result.nodeResults, rootTransform, nodeOptions, jobs);
   } else if (model.meshes.size() > 0) {
     // No nodes either, show all the meshes.
     for (const CesiumGltf::Mesh& mesh : model.meshes) {
       CreateNodeOptions dummyNodeOptions = {&options, nullptr};
       CreateMeshOptions meshOptions = {&dummyNodeOptions, &mesh};
-      LoadNodeResult& dummyNodeResult = result.nodeResults.emplace_back();
-      loadMesh(dummyNodeResult.meshResult, rootTransform, meshOptions);
+      result.nodeResults.emplace_back();
+      loadMesh(result.nodeResults, rootTransform, meshOptions, jobs);
+    }
+  }
+
+  if (isCanceled(options)) {
+    return LoadModelResult();
+  }
+
+  // Collision-only primitives don't have materials.
+  const std::vector<CesiumTextureUtility::LoadedTextureResult*> textures =
+      options.collisionOnly
+          ? std::vector<CesiumTextureUtility::LoadedTextureResult*>()
+          : loadTextures(model, jobs, options);
+
+  if (isCanceled(options)) {
+    for (CesiumTextureUtility::LoadedTextureResult* pTexture : textures) {
+      CesiumTextureUtility::destroyHalfLoadedTexture(pTexture);
     }
+    return LoadModelResult();
+  }
+
+  // The primitives are independent of each other, so tiles with many
+  // primitives are converted on several worker threads at once.
+  CESIUM_TRACE("loadPrimitives");
+  ParallelFor(
+      static_cast<int32>(jobs.size()),
+      [&jobs, &result, &textures](int32 i) {
+        const PrimitiveLoadJob& job = jobs[i];
+        CreateMeshOptions meshOptions = {&job.nodeOptions, job.pMesh};
+        CreatePrimitiveOptions primitiveOptions = {
+            &meshOptions,
+            job.pPrimitive,
+            &textures};
+        LoadPrimitiveResult& primitiveResult =
+            result.nodeResults[job.nodeIndex]
+                .meshResult->primitiveResults[job.primitiveIndex];
+        primitiveResult.pInstanceTransforms = job.pInstanceTransforms;
+        loadPrimitive(primitiveResult, job.transform, primitiveOptions);
+      },
+      jobs.size() < 2);
+
+  // Once the primitives refer to the textures, the result is kept even if
+  // it was canceled, because the textures have no other owner. Only the
+  // remaining stages are skipped.
+  if (options.mergePrimitives && !isCanceled(options)) {
+    mergePrimitives(result);
+  }
+
+  releaseUnusedTextures(result, textures);
+
+#if CESIUM_BUILD_NANITE
+  // The Nanite resources are built last, so that they include the merged
+  // primitives.
+  if (options.pNaniteBuilder && !isCanceled(options)) {
+    buildNaniteResources(*options.pNaniteBuilder, result);
   }
+#endif
 
   return result;
 }
@@ -1415,6 +3856,11 @@ static void SetGltfParameterValues(
   pMaterial->SetScalarParameterValueByInfo(
       FMaterialParameterInfo("opacityMask", assocation, index),
       1.0);
+  if (loadResult.flatNormalsInMaterial) {
+    pMaterial->SetScalarParameterValueByInfo(
+        FMaterialParameterInfo("flatNormals", assocation, index),
+        1.0);
+  }
 
   applyTexture(
       pMaterial,
@@ -1437,6 +3883,39 @@ static void SetGltfParameterValues(
       FMaterialParameterInfo("occlusionTexture", assocation, index),
       loadResult.occlusionTexture);
 
+  if (loadResult.featureMetadataTexture) {
+    applyTexture(
+        pMaterial,
+        FMaterialParameterInfo("featureMetadataTexture", assocation, index),
+        loadResult.featureMetadataTexture);
+    pMaterial->SetScalarParameterValueByInfo(
+        FMaterialParameterInfo(
+            "featureMetadataTextureWidth",
+            assocation,
+            index),
+        static_cast<float>(loadResult.featureMetadataTextureWidth));
+    pMaterial->SetScalarParameterValueByInfo(
+        FMaterialParameterInfo(
+            "featureMetadataRowsPerProperty",
+            assocation,
+            index),
+        static_cast<float>(loadResult.featureMetadataRowsPerProperty));
+  }
+
+  if (loadResult.heightfield) {
+    pMaterial->SetScalarParameterValueByInfo(
+        FMaterialParameterInfo("heightfield", assocation, index),
+        1.0);
+    applyTexture(
+        pMaterial,
+        FMaterialParameterInfo("heightfieldPositions", assocation, index),
+        loadResult.heightfieldPositionTexture);
+    applyTexture(
+        pMaterial,
+        FMaterialParameterInfo("heightfieldNormals", assocation, index),
+        loadResult.heightfieldNormalTexture);
+  }
+
   if (material.emissiveFactor.size() >= 3) {
     pMaterial->SetVectorParameterValueByInfo(
         FMaterialParameterInfo("emissiveFactor", assocation, index),
@@ -1467,10 +3946,16 @@ void SetWaterParameterValues(
       static_cast<float>(loadResult.onlyWater));
 
   if (!loadResult.onlyLand && !loadResult.onlyWater) {
-    applyTexture(
-        pMaterial,
-        FMaterialParameterInfo("WaterMask", assocation, index),
-        loadResult.waterMaskTexture);
+    if (loadResult.pWaterMaskAtlasTexture) {
+      pMaterial->SetTextureParameterValueByInfo(
+          FMaterialParameterInfo("WaterMask", assocation, index),
+          loadResult.pWaterMaskAtlasTexture);
+    } else {
+      applyTexture(
+          pMaterial,
+          FMaterialParameterInfo("WaterMask", assocation, index),
+          loadResult.waterMaskTexture);
+    }
   }
 
   pMaterial->SetVectorParameterValueByInfo(
@@ -1481,56 +3966,79 @@ void SetWaterParameterValues(
           loadResult.waterMaskScale));
 }
 
-static void loadPrimitiveGameThreadPart(
-    UCesiumGltfComponent* pGltf,
-    LoadPrimitiveResult& loadResult,
-    const glm::dmat4x4& cesiumToUnrealTransform) {
-
-  FName meshName = createSafeName(loadResult.name, "");
-  UCesiumGltfPrimitiveComponent* pMesh =
-      NewObject<UCesiumGltfPrimitiveComponent>(pGltf, meshName);
-  pMesh->overlayTextureCoordinateIDToUVIndex =
-      loadResult.overlayTextureCoordinateIDToUVIndex;
-  pMesh->HighPrecisionNodeTransform = loadResult.transform;
-  pMesh->UpdateTransformFromCesium(cesiumToUnrealTransform);
-
-  pMesh->bUseDefaultCollision = false;
-  pMesh->SetCollisionObjectType(ECollisionChannel::ECC_WorldStatic);
-  pMesh->SetFlags(
-      RF_Transient | RF_DuplicateTransient | RF_TextExportTransient);
-  pMesh->Metadata = std::move(loadResult.Metadata);
-  pMesh->pModel = loadResult.pModel;
-  pMesh->pMeshPrimitive = loadResult.pMeshPrimitive;
-  pMesh->SetRenderCustomDepth(pGltf->CustomDepthParameters.RenderCustomDepth);
-  pMesh->SetCustomDepthStencilWriteMask(
-      pGltf->CustomDepthParameters.CustomDepthStencilWriteMask);
-  pMesh->SetCustomDepthStencilValue(
-      pGltf->CustomDepthParameters.CustomDepthStencilValue);
-
-  UStaticMesh* pStaticMesh = NewObject<UStaticMesh>(pMesh, meshName);
-  pMesh->SetStaticMesh(pStaticMesh);
+/**
+ * Computes the memory used by the vertex and index buffers of the given render
+ * data, and by the material of the given primitive. Its textures are counted
+ * separately, because they may be shared with other primitives.
+ */
+static FCesiumTilesetMemoryStatistics
+getRenderMemoryUsage(const LoadPrimitiveResult& loadResult) {
+  FCesiumTilesetMemoryStatistics usage;
+  usage.Materials = 1;
+
+  // Heightfields are drawn with the shared grid, and have only textures.
+  if (!loadResult.RenderData) {
+    return usage;
+  }
 
-  pStaticMesh->SetFlags(
-      RF_Transient | RF_DuplicateTransient | RF_TextExportTransient);
-  pStaticMesh->NeverStream = true;
+  const FStaticMeshLODResources& lod = loadResult.RenderData->LODResources[0];
+  const FStaticMeshVertexBuffers& vertexBuffers = lod.VertexBuffers;
+  const FStaticMeshVertexBuffer& meshBuffer =
+      vertexBuffers.StaticMeshVertexBuffer;
+
+  int64 numVertices = vertexBuffers.PositionVertexBuffer.GetNumVertices();
+  int64 tangentBytes = meshBuffer.GetUseHighPrecisionTangentBasis() ? 16 : 8;
+  int64 uvBytes = meshBuffer.GetUseFullPrecisionUVs() ? 8 : 4;
+  usage.VertexBufferBytes =
+      numVertices * vertexBuffers.PositionVertexBuffer.GetStride() +
+      numVertices * tangentBytes +
+      numVertices * meshBuffer.GetNumTexCoords() * uvBytes +
+      static_cast<int64>(vertexBuffers.ColorVertexBuffer.GetNumVertices()) *
+          vertexBuffers.ColorVertexBuffer.GetStride();
+  usage.IndexBufferBytes = static_cast<int64>(lod.IndexBuffer.GetNumIndices()) *
+                           (lod.IndexBuffer.Is32Bit() ? 4 : 2);
+
+  return usage;
+}
 
-#if ENGINE_MAJOR_VERSION == 4 && ENGINE_MINOR_VERSION < 27
-  // UE 4.26 or earlier
-  pStaticMesh->bIsBuiltAtRuntime = true;
-  pStaticMesh->RenderData =
-      TUniquePtr<FStaticMeshRenderData>(loadResult.RenderData);
-#elif ENGINE_MAJOR_VERSION == 4
-  // UE 4.27 or later
-  pStaticMesh->SetIsBuiltAtRuntime(true);
-  pStaticMesh->SetRenderData(
-      TUniquePtr<FStaticMeshRenderData>(loadResult.RenderData));
-#else
-  // UE 5
-  pStaticMesh->SetRenderData(
-      TUniquePtr<FStaticMeshRenderData>(loadResult.RenderData));
-#endif
+/**
+ * Gets the textures of the given primitive that have not been created yet.
+ * Each texture is counted in the memory usage of the first primitive that
+ * uses it, which is the one that creates it.
+ */
+static TArray<
+    CesiumTextureUtility::LoadedTextureResult*,
+    TInlineAllocator<9>>
+getUncreatedTextures(const LoadPrimitiveResult& loadResult) {
+  CesiumTextureUtility::LoadedTextureResult* textures[] = {
+      loadResult.baseColorTexture,
+      loadResult.metallicRoughnessTexture,
+      loadResult.normalTexture,
+      loadResult.emissiveTexture,
+      loadResult.occlusionTexture,
+      loadResult.waterMaskTexture,
+      loadResult.featureMetadataTexture,
+      loadResult.heightfieldPositionTexture,
+      loadResult.heightfieldNormalTexture};
+
+  TArray<CesiumTextureUtility::LoadedTextureResult*, TInlineAllocator<9>>
+      result;
+  for (CesiumTextureUtility::LoadedTextureResult* pTexture : textures) {
+    if (pTexture && !pTexture->pTexture) {
+      result.AddUnique(pTexture);
+    }
+  }
+  return result;
+}
 
-  const CesiumGltf::Model& model = *loadResult.pModel;
+/**
+ * Creates the material instance of a primitive, or reuses one from the pool,
+ * and sets its glTF and water parameters.
+ */
+static UMaterialInstanceDynamic* createPrimitiveMaterial(
+    LoadPrimitiveResult& loadResult,
+    UMaterialInterface* pBaseMaterial,
+    CesiumGltfPrimitivePool* pPool) {
   const CesiumGltf::Material& material =
       loadResult.pMaterial ? *loadResult.pMaterial : defaultMaterial;
 
@@ -1541,23 +4049,17 @@ static void loadPrimitiveGameThreadPart(
   const FName ImportedSlotName(
       *(TEXT("CesiumMaterial") + FString::FromInt(nextMaterialId++)));
 
-#if PLATFORM_MAC
-  // TODO: figure out why water material crashes mac
-  UMaterialInterface* pBaseMaterial = pGltf->BaseMaterial;
-#else
-  UMaterialInterface* pBaseMaterial =
-      (loadResult.onlyWater || !loadResult.onlyLand)
-          ? pGltf->BaseMaterialWithWater
-          : pGltf->BaseMaterial;
-#endif
-
-  UMaterialInstanceDynamic* pMaterial = UMaterialInstanceDynamic::Create(
-      pBaseMaterial,
-      nullptr,
-      ImportedSlotName);
+  UMaterialInstanceDynamic* pMaterial =
+      pPool ? pPool->acquireMaterial(pBaseMaterial) : nullptr;
+  if (!pMaterial) {
+    pMaterial = UMaterialInstanceDynamic::Create(
+        pBaseMaterial,
+        nullptr,
+        ImportedSlotName);
 
-  pMaterial->SetFlags(
-      RF_Transient | RF_DuplicateTransient | RF_TextExportTransient);
+    pMaterial->SetFlags(
+        RF_Transient | RF_DuplicateTransient | RF_TextExportTransient);
+  }
 
   SetGltfParameterValues(
       loadResult,
@@ -1634,10 +4136,324 @@ static void loadPrimitiveGameThreadPart(
     }
   }
 
-  pMaterial->TwoSided = true;
-
+  pMaterial->TwoSided = true;
+
+  return pMaterial;
+}
+
+/**
+ * Sets up the collision of a newly-created primitive component, and attaches
+ * and registers it.
+ */
+static UStaticMeshComponent* finishPrimitiveGameThreadPart(
+    UCesiumGltfComponent* pGltf,
+    UStaticMeshComponent* pMesh,
+    UStaticMesh* pStaticMesh,
+    LoadPrimitiveResult& loadResult) {
+  pStaticMesh->CreateBodySetup();
+
+  UBodySetup* pBodySetup = pMesh->GetBodySetup();
+
+  // A reused body setup may still have the physics meshes of its last tile.
+  pBodySetup->ClearPhysicsMeshes();
+
+  // pMesh->UpdateCollisionFromStaticMesh();
+  pBodySetup->CollisionTraceFlag = ECollisionTraceFlag::CTF_UseComplexAsSimple;
+
+  if (loadResult.pCollisionMesh) {
+#if PHYSICS_INTERFACE_PHYSX
+    pBodySetup->TriMeshes.Add(loadResult.pCollisionMesh);
+#else
+    pBodySetup->ChaosTriMeshes.Add(loadResult.pCollisionMesh);
+#endif
+  }
+  for (const CesiumCollisionMesh& pCollisionMesh :
+       loadResult.mergedCollisionMeshes) {
+#if PHYSICS_INTERFACE_PHYSX
+    pBodySetup->TriMeshes.Add(pCollisionMesh);
+#else
+    pBodySetup->ChaosTriMeshes.Add(pCollisionMesh);
+#endif
+  }
+
+  // Mark physics meshes created, no matter if we actually have a collision
+  // mesh or not. We don't want the editor creating collision meshes itself in
+  // the game thread, because that would be slow.
+  pBodySetup->bCreatedPhysicsMeshes = true;
+  if (UCesiumGltfPrimitiveComponent* pPrimitive =
+          Cast<UCesiumGltfPrimitiveComponent>(pMesh)) {
+    pPrimitive->pDeferredCollision = std::move(loadResult.pDeferredCollision);
+    pPrimitive->pQueryBVH = std::move(loadResult.pQueryBVH);
+  }
+
+  if (loadResult.pCollisionMesh) {
+    FCesiumTilesetMemoryStatistics usage;
+    usage.CollisionBytes = loadResult.collisionBytes;
+    pGltf->AddMemoryUsage(usage);
+  }
+
+  pMesh->SetMobility(EComponentMobility::Movable);
+  pMesh->CastShadow = pGltf->GetTileCastShadow();
+  pMesh->LDMaxDrawDistance = pGltf->GetTileCullDistance();
+  pMesh->CachedMaxDrawDistance = pGltf->GetTileCullDistance();
+  pMesh->bVisibleInRayTracing =
+      pGltf->GetSupportRayTracing() && pGltf->GetTileVisibleInRayTracing();
+  if (UCesiumGltfPrimitiveComponent* pPrimitive =
+          Cast<UCesiumGltfPrimitiveComponent>(pMesh)) {
+    pPrimitive->pFarFieldGeometry = std::move(loadResult.pFarFieldGeometry);
+    pPrimitive->TileBatch = pGltf->GetTileBatch();
+  }
+
+  // pMesh->bDrawMeshCollisionIfComplex = true;
+  // pMesh->bDrawMeshCollisionIfSimple = true;
+  pMesh->SetupAttachment(pGltf);
+  pMesh->RegisterComponent();
+
+  // Primitives that are created after their parent has been shown (because
+  // their creation was deferred) need to match its visibility and collision.
+  pMesh->SetVisibility(pGltf->IsVisible(), true);
+  pMesh->SetCollisionEnabled(
+      pGltf->IsVisible() ? ECollisionEnabled::QueryAndPhysics
+                         : ECollisionEnabled::NoCollision);
+
+  return pMesh;
+}
+
+/**
+ * Packs the water mask of the given primitive into the atlas, and maps the
+ * water mask texture coordinates of the primitive to its slot.
+ */
+static void packWaterMask(
+    UCesiumGltfComponent* pGltf,
+    LoadPrimitiveResult& loadResult,
+    CesiumWaterMaskAtlas* pWaterMaskAtlas) {
+  if (loadResult.waterMaskSize <= 0) {
+    return;
+  }
+
+  if (pWaterMaskAtlas) {
+    const CesiumWaterMaskAtlas::Allocation allocation = pWaterMaskAtlas->add(
+        pGltf,
+        loadResult.waterMaskPixels,
+        loadResult.waterMaskSize);
+    if (allocation.pTexture) {
+      loadResult.pWaterMaskAtlasTexture = allocation.pTexture;
+      loadResult.waterMaskTranslationX =
+          allocation.offsetX +
+          allocation.scale * loadResult.waterMaskTranslationX;
+      loadResult.waterMaskTranslationY =
+          allocation.offsetY +
+          allocation.scale * loadResult.waterMaskTranslationY;
+      loadResult.waterMaskScale *= allocation.scale;
+    }
+  }
+
+  if (!loadResult.pWaterMaskAtlasTexture) {
+    UE_LOG(
+        LogCesium,
+        Warning,
+        TEXT("Could not pack a water mask into the water mask atlas"));
+  }
+
+  loadResult.waterMaskPixels.Empty();
+  loadResult.waterMaskSize = 0;
+}
+
+static UStaticMeshComponent* loadPrimitiveGameThreadPart(
+    UCesiumGltfComponent* pGltf,
+    LoadPrimitiveResult& loadResult,
+    const glm::dmat4x4& cesiumToUnrealTransform,
+    CesiumGltfPrimitivePool* pPool,
+    CesiumWaterMaskAtlas* pWaterMaskAtlas) {
+  // Primitives that failed to load, or that were merged into another
+  // primitive, have nothing to create.
+  if (!loadResult.RenderData && !loadResult.collisionOnly &&
+      !loadResult.heightfield) {
+    return nullptr;
+  }
+
+  FName meshName = createSafeName(loadResult.name, "");
+  UStaticMeshComponent* pMesh = nullptr;
+  UCesiumGltfPrimitiveComponent* pPrimitive = nullptr;
+  UCesiumGltfInstancedComponent* pInstanced = nullptr;
+  UStaticMesh* pStaticMesh = nullptr;
+
+  if (loadResult.pInstanceTransforms) {
+    // Instanced primitives are not pooled, because their instance count
+    // differs from one node to the next.
+    pInstanced = NewObject<UCesiumGltfInstancedComponent>(pGltf, meshName);
+    pInstanced->HighPrecisionNodeTransform = loadResult.transform;
+    pInstanced->UpdateTransformFromCesium(cesiumToUnrealTransform);
+    pMesh = pInstanced;
+  } else {
+    pPrimitive = pPool ? pPool->acquirePrimitive() : nullptr;
+    pStaticMesh = pPrimitive ? pPrimitive->GetStaticMesh() : nullptr;
+
+    if (!pPrimitive) {
+      if (pPool) {
+        // Pooled primitives outlive the glTF component they were first
+        // created for, so they must not be owned by it.
+        AActor* pOwner = pGltf->GetOwner();
+        pPrimitive = NewObject<UCesiumGltfPrimitiveComponent>(
+            pOwner,
+            MakeUniqueObjectName(
+                pOwner,
+                UCesiumGltfPrimitiveComponent::StaticClass(),
+                meshName));
+      } else {
+        pPrimitive = NewObject<UCesiumGltfPrimitiveComponent>(pGltf, meshName);
+      }
+    }
+
+    pPrimitive->overlayTextureCoordinateIDToUVIndex =
+        loadResult.overlayTextureCoordinateIDToUVIndex;
+    pPrimitive->HighPrecisionNodeTransform = loadResult.transform;
+    pPrimitive->UpdateTransformFromCesium(cesiumToUnrealTransform);
+    pPrimitive->SharesMaterial = false;
+    pPrimitive->ResetMetadata();
+    pPrimitive->FaceFeatureIDs = MoveTemp(loadResult.faceFeatureIDs);
+    pPrimitive->FeatureBounds = MoveTemp(loadResult.featureBounds);
+    pPrimitive->IsPointCloud = loadResult.pointCloud;
+    pPrimitive->IsHeightfield = loadResult.heightfield;
+    pPrimitive->HeightfieldBounds = loadResult.heightfieldBounds;
+    pPrimitive->pModel = loadResult.pModel;
+    pPrimitive->pMeshPrimitive = loadResult.pMeshPrimitive;
+    pMesh = pPrimitive;
+  }
+
+  bool sharesMaterial = false;
+
+  pMesh->bUseDefaultCollision = false;
+  pMesh->SetCollisionObjectType(pGltf->CollisionObjectType);
+  pMesh->SetCollisionResponseToChannels(pGltf->CollisionResponses);
+  pMesh->SetFlags(
+      RF_Transient | RF_DuplicateTransient | RF_TextExportTransient);
+  pMesh->SetRenderCustomDepth(pGltf->CustomDepthParameters.RenderCustomDepth);
+  pMesh->SetCustomDepthStencilWriteMask(
+      pGltf->CustomDepthParameters.CustomDepthStencilWriteMask);
+  pMesh->SetCustomDepthStencilValue(
+      pGltf->CustomDepthParameters.CustomDepthStencilValue);
+
+  if (!pStaticMesh) {
+    pStaticMesh = NewObject<UStaticMesh>(pMesh, meshName);
+    pMesh->SetStaticMesh(pStaticMesh);
+
+    pStaticMesh->SetFlags(
+        RF_Transient | RF_DuplicateTransient | RF_TextExportTransient);
+    pStaticMesh->NeverStream = true;
+  }
+
+  if (pInstanced) {
+    for (const FTransform& instance : *loadResult.pInstanceTransforms) {
+      pInstanced->AddInstance(instance);
+    }
+  }
+
+  // Without render data, the component has no scene proxy and is only
+  // used for collision.
+  if (loadResult.collisionOnly) {
+    return finishPrimitiveGameThreadPart(
+        pGltf,
+        pMesh,
+        pStaticMesh,
+        loadResult);
+  }
+
+  // Heightfields have no render data, they are drawn with the shared grid.
+  if (loadResult.RenderData) {
+#if ENGINE_MAJOR_VERSION == 4 && ENGINE_MINOR_VERSION < 27
+    // UE 4.26 or earlier
+    pStaticMesh->bIsBuiltAtRuntime = true;
+    pStaticMesh->RenderData =
+        TUniquePtr<FStaticMeshRenderData>(loadResult.RenderData);
+#elif ENGINE_MAJOR_VERSION == 4
+    // UE 4.27 or later
+    pStaticMesh->SetIsBuiltAtRuntime(true);
+    pStaticMesh->SetRenderData(
+        TUniquePtr<FStaticMeshRenderData>(loadResult.RenderData));
+#else
+    // UE 5
+    pStaticMesh->SetRenderData(
+        TUniquePtr<FStaticMeshRenderData>(loadResult.RenderData));
+#endif
+  }
+
+#if PLATFORM_MAC
+  // TODO: figure out why water material crashes mac
+  const bool usesWaterMaterial = false;
+#else
+  const bool usesWaterMaterial = loadResult.onlyWater || !loadResult.onlyLand;
+#endif
+  UMaterialInterface* pBaseMaterial =
+      usesWaterMaterial ? pGltf->BaseMaterialWithWater : pGltf->BaseMaterial;
+
+#if CESIUM_BUILD_NANITE
+  // Nanite only renders opaque materials, so the regular mesh is used with any
+  // other tileset material.
+  if (pBaseMaterial && pBaseMaterial->GetBlendMode() != BLEND_Opaque &&
+      pStaticMesh->GetRenderData()) {
+    pStaticMesh->GetRenderData()->NaniteResources = Nanite::FResources();
+  }
+  pStaticMesh->NaniteSettings.bEnabled = pStaticMesh->HasValidNaniteData();
+#endif
+
+  packWaterMask(pGltf, loadResult, pWaterMaskAtlas);
+
+  // Primitives of this model that use the same glTF material in the same way
+  // get identical parameters, so they share a single material instance. The
+  // first of them owns it, and the textures are shared by all primitives of
+  // the model.
+  const FString sharedMaterialKey =
+      getSharedMaterialKey(loadResult, pBaseMaterial);
+  UMaterialInstanceDynamic* pMaterial =
+      sharedMaterialKey.IsEmpty()
+          ? nullptr
+          : pGltf->FindSharedMaterial(sharedMaterialKey);
+  sharesMaterial = pMaterial != nullptr;
+  if (pPrimitive) {
+    pPrimitive->SharesMaterial = sharesMaterial;
+    pPrimitive->UsesWaterMaterial = usesWaterMaterial;
+  } else {
+    pInstanced->SharesMaterial = sharesMaterial;
+    pInstanced->UsesWaterMaterial = usesWaterMaterial;
+  }
+  const auto newTextures = getUncreatedTextures(loadResult);
+  if (!pMaterial) {
+    pMaterial = createPrimitiveMaterial(loadResult, pBaseMaterial, pPool);
+    if (!sharedMaterialKey.IsEmpty()) {
+      pGltf->AddSharedMaterial(sharedMaterialKey, pMaterial);
+    }
+  }
+
   pStaticMesh->AddMaterial(pMaterial);
 
+  // Measure the buffers before they are handed to the render thread, which
+  // may discard its CPU copies of them.
+  FCesiumTilesetMemoryStatistics usage = getRenderMemoryUsage(loadResult);
+  if (sharesMaterial) {
+    usage.Materials = 0;
+  }
+  for (const CesiumTextureUtility::LoadedTextureResult* pTexture :
+       newTextures) {
+    usage.TextureBytes +=
+        CesiumTextureUtility::getTextureMemoryBytes(pTexture->pTexture);
+    if (pTexture->streamable && pTexture->pTexture) {
+      pGltf->AddStreamedTexture(pTexture->pTexture);
+    }
+  }
+  pGltf->AddMemoryUsage(usage);
+
+  if (loadResult.heightfield) {
+    return finishPrimitiveGameThreadPart(
+        pGltf,
+        pMesh,
+        pStaticMesh,
+        loadResult);
+  }
+
+  // The ray tracing geometry is built when the resources are initialized,
+  // whether or not the primitive is ever visible in ray tracing.
+  pStaticMesh->bSupportRayTracing = pGltf->GetSupportRayTracing();
   pStaticMesh->InitResources();
 
   // Set up RenderData bounds and LOD data
@@ -1648,48 +4464,312 @@ static void loadPrimitiveGameThreadPart(
 #else
   pStaticMesh->GetRenderData()->ScreenSize[0].Default = 1.0f;
 #endif
-  pStaticMesh->CreateBodySetup();
+  return finishPrimitiveGameThreadPart(pGltf, pMesh, pStaticMesh, loadResult);
+}
 
-  UBodySetup* pBodySetup = pMesh->GetBodySetup();
+namespace {
 
-  // pMesh->UpdateCollisionFromStaticMesh();
-  pBodySetup->CollisionTraceFlag = ECollisionTraceFlag::CTF_UseComplexAsSimple;
+template <typename Func>
+void forPrimitiveComponent(
+    UCesiumGltfPrimitiveComponent* pPrimitive,
+    Func&& f) {
+  // A shared material instance is updated through the primitive that owns it.
+  if (pPrimitive->SharesMaterial) {
+    return;
+  }
 
-  if (loadResult.pCollisionMesh) {
-#if PHYSICS_INTERFACE_PHYSX
-    pBodySetup->TriMeshes.Add(loadResult.pCollisionMesh);
+  UMaterialInstanceDynamic* pMaterial =
+      Cast<UMaterialInstanceDynamic>(pPrimitive->GetMaterial(0));
+
+#if ENGINE_MAJOR_VERSION >= 5
+  if (!IsValid(pMaterial)) {
 #else
-    pBodySetup->ChaosTriMeshes.Add(loadResult.pCollisionMesh);
+  if (!pMaterial || pMaterial->IsPendingKillOrUnreachable()) {
 #endif
+    // Don't try to update the material while it's in the process of being
+    // destroyed. This can lead to the render thread freaking out when
+    // it's asked to update a parameter for a material that has been
+    // marked for garbage collection.
+    return;
   }
 
-  // Mark physics meshes created, no matter if we actually have a collision
-  // mesh or not. We don't want the editor creating collision meshes itself in
-  // the game thread, because that would be slow.
-  pBodySetup->bCreatedPhysicsMeshes = true;
+  UMaterialInterface* pBaseMaterial = pMaterial->Parent;
+  UMaterialInstance* pBaseAsMaterialInstance =
+      Cast<UMaterialInstance>(pBaseMaterial);
+  UCesiumMaterialUserData* pCesiumData =
+      pBaseAsMaterialInstance
+          ? pBaseAsMaterialInstance->GetAssetUserData<UCesiumMaterialUserData>()
+          : nullptr;
 
-  pMesh->SetMobility(EComponentMobility::Movable);
+  f(pPrimitive, pMaterial, pCesiumData);
+}
 
-  // pMesh->bDrawMeshCollisionIfComplex = true;
-  // pMesh->bDrawMeshCollisionIfSimple = true;
-  pMesh->SetupAttachment(pGltf);
-  pMesh->RegisterComponent();
+template <typename Func>
+void forEachPrimitiveComponent(UCesiumGltfComponent* pGltf, Func&& f) {
+  for (USceneComponent* pSceneComponent : pGltf->GetAttachChildren()) {
+    UCesiumGltfPrimitiveComponent* pPrimitive =
+        Cast<UCesiumGltfPrimitiveComponent>(pSceneComponent);
+    if (pPrimitive) {
+      forPrimitiveComponent(pPrimitive, f);
+    }
+  }
+}
+
+void applyRasterOverlayTile(
+    UCesiumGltfPrimitiveComponent* pPrimitive,
+    const FRasterOverlayTile& overlayTile) {
+  forPrimitiveComponent(
+      pPrimitive,
+      [&overlayTile](
+          UCesiumGltfPrimitiveComponent* pPrimitive,
+          UMaterialInstanceDynamic* pMaterial,
+          UCesiumMaterialUserData* pCesiumData) {
+        int32 uvIndex = pPrimitive->overlayTextureCoordinateIDToUVIndex
+                            [overlayTile.TextureCoordinateID];
+
+        // If this material uses material layers and has the Cesium user data,
+        // set the parameters on each material layer that maps to this overlay
+        // tile.
+        if (pCesiumData) {
+          for (int32 i = 0; i < pCesiumData->LayerNames.Num(); ++i) {
+            if (pCesiumData->LayerNames[i] != overlayTile.OverlayName) {
+              continue;
+            }
+
+            pMaterial->SetTextureParameterValueByInfo(
+                FMaterialParameterInfo(
+                    LayerTextureParameterName,
+                    EMaterialParameterAssociation::LayerParameter,
+                    i),
+                overlayTile.Texture);
+            pMaterial->SetVectorParameterValueByInfo(
+                FMaterialParameterInfo(
+                    LayerTranslationScaleParameterName,
+                    EMaterialParameterAssociation::LayerParameter,
+                    i),
+                overlayTile.TranslationAndScale);
+            pMaterial->SetScalarParameterValueByInfo(
+                FMaterialParameterInfo(
+                    LayerTextureCoordinateIndexParameterName,
+                    EMaterialParameterAssociation::LayerParameter,
+                    i),
+                uvIndex);
+          }
+        } else {
+          pMaterial->SetTextureParameterValue(
+              overlayTile.TextureParameterName,
+              overlayTile.Texture);
+          pMaterial->SetVectorParameterValue(
+              overlayTile.TranslationScaleParameterName,
+              overlayTile.TranslationAndScale);
+          pMaterial->SetScalarParameterValue(
+              overlayTile.TextureCoordinateIndexParameterName,
+              uvIndex);
+        }
+      });
 }
 
+} // namespace
+
 namespace {
 class HalfConstructedReal : public UCesiumGltfComponent::HalfConstructed {
 public:
-  virtual ~HalfConstructedReal() {}
+  /**
+   * Frees the loaded textures of the model, and the render data and
+   * collision meshes of the primitives that were not created on the game
+   * thread, such as those of a tile whose load was canceled. A texture that
+   * was already created is owned by its UTexture2D, so only its load result
+   * is freed.
+   */
+  virtual ~HalfConstructedReal() {
+    std::unordered_set<CesiumTextureUtility::LoadedTextureResult*> textures;
+    std::vector<LoadNodeResult>& nodes = this->loadModelResult.nodeResults;
+    for (size_t i = 0; i < nodes.size(); ++i) {
+      if (!nodes[i].meshResult) {
+        continue;
+      }
+      std::vector<LoadPrimitiveResult>& primitives =
+          nodes[i].meshResult->primitiveResults;
+      for (size_t j = 0; j < primitives.size(); ++j) {
+        LoadPrimitiveResult& primitive = primitives[j];
+        const bool created = i < this->nextNode ||
+                             (i == this->nextNode && j < this->nextPrimitive);
+        if (!created) {
+          delete primitive.RenderData;
+          primitive.RenderData = nullptr;
+#if PHYSICS_INTERFACE_PHYSX
+          if (primitive.pCollisionMesh) {
+            primitive.pCollisionMesh->release();
+          }
+          for (CesiumCollisionMesh pMerged : primitive.mergedCollisionMeshes) {
+            if (pMerged) {
+              pMerged->release();
+            }
+          }
+#endif
+        }
+        textures.insert(primitive.baseColorTexture);
+        textures.insert(primitive.metallicRoughnessTexture);
+        textures.insert(primitive.normalTexture);
+        textures.insert(primitive.emissiveTexture);
+        textures.insert(primitive.occlusionTexture);
+        textures.insert(primitive.waterMaskTexture);
+        textures.insert(primitive.featureMetadataTexture);
+        textures.insert(primitive.heightfieldPositionTexture);
+        textures.insert(primitive.heightfieldNormalTexture);
+      }
+    }
+
+    for (CesiumTextureUtility::LoadedTextureResult* pTexture : textures) {
+      if (!pTexture) {
+        continue;
+      }
+      if (pTexture->pTexture) {
+        delete pTexture;
+      } else {
+        CesiumTextureUtility::destroyHalfLoadedTexture(pTexture);
+      }
+    }
+  }
   LoadModelResult loadModelResult;
+
+  // The position of the next primitive to create on the game thread.
+  size_t nextNode = 0;
+  size_t nextPrimitive = 0;
+
+  /**
+   * Returns the next primitive to create on the game thread and advances
+   * the position, or nullptr if all primitives have been created.
+   */
+  LoadPrimitiveResult* nextPrimitiveResult() {
+    std::vector<LoadNodeResult>& nodes = this->loadModelResult.nodeResults;
+    while (this->nextNode < nodes.size()) {
+      std::optional<LoadMeshResult>& meshResult =
+          nodes[this->nextNode].meshResult;
+      if (meshResult &&
+          this->nextPrimitive < meshResult->primitiveResults.size()) {
+        return &meshResult->primitiveResults[this->nextPrimitive++];
+      }
+      ++this->nextNode;
+      this->nextPrimitive = 0;
+    }
+    return nullptr;
+  }
 };
 } // namespace
 
+/**
+ * Restores a converted model written by CesiumConvertedModel::write, and
+ * loads the water mask and feature metadata textures of its primitives,
+ * which are not written.
+ *
+ * @return False if the data isn't a valid converted model of the model.
+ */
+static bool restoreConvertedModel(
+    const TArray<uint8>& data,
+    const CreateModelOptions& options,
+    LoadModelResult& result) {
+  CESIUM_TRACE("restoreConvertedModel");
+  const CesiumGltf::Model& model = *options.pModel;
+  if (!CesiumConvertedModel::read(data, model, defaultMaterial, result)) {
+    return false;
+  }
+
+  for (LoadNodeResult& node : result.nodeResults) {
+    if (!node.meshResult) {
+      continue;
+    }
+    for (LoadPrimitiveResult& primitive : node.meshResult->primitiveResults) {
+      if (!primitive.RenderData || !primitive.pMeshPrimitive ||
+          primitive.collisionOnly || primitive.pointCloud) {
+        continue;
+      }
+
+      applyWaterMask(
+          model,
+          *primitive.pMeshPrimitive,
+          primitive,
+          options.packWaterMasks);
+
+      const FirstFeatureTable firstFeatureTable =
+          findFirstFeatureTable(model, *primitive.pMeshPrimitive);
+      if (primitive.textureCoordinateParameters.find(
+              "featureIdTextureCoordinateIndex") !=
+              primitive.textureCoordinateParameters.end() &&
+          firstFeatureTable.pFeatureTable) {
+        loadFeatureMetadataTexture(
+            primitive,
+            FCesiumMetadataFeatureTable(
+                model,
+                model.accessors[firstFeatureTable.featureIDAccessor],
+                *firstFeatureTable.pFeatureTable),
+            options.metadataTextureProperties);
+      }
+    }
+  }
+
+  return true;
+}
+
+/**
+ * Creates the RHI textures of a model that were deferred so that the
+ * converted model could be written, and frees the cooked collision meshes,
+ * which are no longer needed once it is written.
+ */
+static void finishWritingConvertedModel(LoadModelResult& result) {
+  for (LoadNodeResult& node : result.nodeResults) {
+    if (!node.meshResult) {
+      continue;
+    }
+    for (LoadPrimitiveResult& primitive : node.meshResult->primitiveResults) {
+      primitive.cookedCollisionMesh.Empty();
+      primitive.mergedCookedCollisionMeshes.clear();
+      CesiumTextureUtility::createRHITextureAnyThreadPart(
+          primitive.baseColorTexture);
+      CesiumTextureUtility::createRHITextureAnyThreadPart(
+          primitive.metallicRoughnessTexture);
+      CesiumTextureUtility::createRHITextureAnyThreadPart(
+          primitive.normalTexture);
+      CesiumTextureUtility::createRHITextureAnyThreadPart(
+          primitive.emissiveTexture);
+      CesiumTextureUtility::createRHITextureAnyThreadPart(
+          primitive.occlusionTexture);
+    }
+  }
+}
+
 /*static*/ std::unique_ptr<UCesiumGltfComponent::HalfConstructed>
 UCesiumGltfComponent::CreateOffGameThread(
     const glm::dmat4x4& Transform,
     const CreateModelOptions& Options) {
   auto pResult = std::make_unique<HalfConstructedReal>();
+
+  if (Options.pConvertedModel && Options.pModel) {
+    if (restoreConvertedModel(
+            *Options.pConvertedModel,
+            Options,
+            pResult->loadModelResult)) {
+      return pResult;
+    }
+    UE_LOG(
+        LogCesium,
+        Warning,
+        TEXT("Could not restore a converted model, it is converted again"));
+  }
+
   pResult->loadModelResult = loadModelAnyThreadPart(Transform, Options);
+
+  if (Options.pWrittenConvertedModel && Options.pModel) {
+    if (isCanceled(Options) ||
+        !CesiumConvertedModel::write(
+            pResult->loadModelResult,
+            *Options.pModel,
+            *Options.pWrittenConvertedModel)) {
+      Options.pWrittenConvertedModel->Empty();
+    }
+    finishWritingConvertedModel(pResult->loadModelResult);
+  }
+
   return pResult;
 }
 
@@ -1699,9 +4779,13 @@ UCesiumGltfComponent::CreateOffGameThread(
     const glm::dmat4x4& cesiumToUnrealTransform,
     UMaterialInterface* pBaseMaterial,
     UMaterialInterface* pBaseWaterMaterial,
-    FCustomDepthParameters CustomDepthParameters) {
-  HalfConstructedReal* pReal =
-      static_cast<HalfConstructedReal*>(pHalfConstructed.get());
+    FCustomDepthParameters CustomDepthParameters,
+    const FBodyInstance& BodyInstance,
+    bool DeferPrimitiveCreation,
+    CesiumGltfPrimitivePool* pPool,
+    CesiumWaterMaskAtlas* pWaterMaskAtlas,
+    UCesiumTileBatchComponent* pTileBatch,
+    bool SupportRayTracing) {
 
   // TODO: was this a common case before?
   // (This code checked if there were no loaded primitives in the model)
@@ -1717,103 +4801,362 @@ UCesiumGltfComponent::CreateOffGameThread(
     Gltf->BaseMaterial = pBaseMaterial;
   }
 
-  if (pBaseWaterMaterial) {
-    Gltf->BaseMaterialWithWater = pBaseWaterMaterial;
-  }
+  if (pBaseWaterMaterial) {
+    Gltf->BaseMaterialWithWater = pBaseWaterMaterial;
+  }
+
+  Gltf->CustomDepthParameters = CustomDepthParameters;
+  Gltf->CollisionObjectType = BodyInstance.GetObjectType();
+  Gltf->CollisionResponses = BodyInstance.GetResponseToChannels();
+
+  Gltf->SetVisibility(false, true);
+
+  FCesiumTilesetMemoryStatistics usage;
+  usage.TileModels = 1;
+  Gltf->AddMemoryUsage(usage);
+
+  Gltf->ConvertedModelKey = pHalfConstructed->ConvertedModelKey;
+  Gltf->_pPool = pPool;
+  Gltf->_pWaterMaskAtlas = pWaterMaskAtlas;
+  Gltf->_pTileBatch = pTileBatch;
+  Gltf->_supportRayTracing = SupportRayTracing;
+  Gltf->_pPending = std::move(pHalfConstructed);
+  if (!DeferPrimitiveCreation) {
+    HalfConstructedReal* pReal =
+        static_cast<HalfConstructedReal*>(Gltf->_pPending.get());
+    while (LoadPrimitiveResult* pPrimitive = pReal->nextPrimitiveResult()) {
+      loadPrimitiveGameThreadPart(
+          Gltf,
+          *pPrimitive,
+          cesiumToUnrealTransform,
+          pPool,
+          pWaterMaskAtlas);
+    }
+    Gltf->_pPending.reset();
+  }
+
+  Gltf->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+  return Gltf;
+}
+
+bool UCesiumGltfComponent::CreatePendingPrimitives(
+    const glm::dmat4x4& cesiumToUnrealTransform,
+    double endTimeSeconds) {
+  if (!this->_pPending) {
+    return true;
+  }
+
+  HalfConstructedReal* pReal =
+      static_cast<HalfConstructedReal*>(this->_pPending.get());
+
+  do {
+    LoadPrimitiveResult* pPrimitive = pReal->nextPrimitiveResult();
+    if (!pPrimitive) {
+      this->_pPending.reset();
+      return true;
+    }
+
+    UCesiumGltfPrimitiveComponent* pMesh =
+        Cast<UCesiumGltfPrimitiveComponent>(loadPrimitiveGameThreadPart(
+            this,
+            *pPrimitive,
+            cesiumToUnrealTransform,
+            this->_pPool,
+            this->_pWaterMaskAtlas));
+    if (pMesh) {
+      for (const FRasterOverlayTile& overlayTile : this->_overlayTiles) {
+        applyRasterOverlayTile(pMesh, overlayTile);
+      }
+    }
+  } while (FPlatformTime::Seconds() < endTimeSeconds);
+
+  return false;
+}
+
+UCesiumGltfComponent::UCesiumGltfComponent() : USceneComponent() {
+  // Structure to hold one-time initialization
+  struct FConstructorStatics {
+    ConstructorHelpers::FObjectFinder<UMaterialInstance> BaseMaterial;
+    ConstructorHelpers::FObjectFinder<UMaterialInstance> BaseMaterialWithWater;
+    ConstructorHelpers::FObjectFinder<UTexture2D> Transparent1x1;
+    FConstructorStatics()
+        : BaseMaterial(TEXT(
+              "/CesiumForUnreal/Materials/Instances/MI_CesiumThreeOverlaysAndClipping.MI_CesiumThreeOverlaysAndClipping")),
+          BaseMaterialWithWater(TEXT(
+              "/CesiumForUnreal/Materials/Instances/MI_CesiumThreeOverlaysAndClippingAndWater.MI_CesiumThreeOverlaysAndClippingAndWater")),
+          Transparent1x1(
+              TEXT("/CesiumForUnreal/Textures/transparent1x1.transparent1x1")) {
+    }
+  };
+  static FConstructorStatics ConstructorStatics;
+
+  this->BaseMaterial = ConstructorStatics.BaseMaterial.Object;
+  this->BaseMaterialWithWater = ConstructorStatics.BaseMaterialWithWater.Object;
+  this->Transparent1x1 = ConstructorStatics.Transparent1x1.Object;
+
+  PrimaryComponentTick.bCanEverTick = false;
+}
+
+UCesiumGltfComponent::~UCesiumGltfComponent() {
+  UE_LOG(LogCesium, VeryVerbose, TEXT("~UCesiumGltfComponent"));
+}
+
+void UCesiumGltfComponent::BeginDestroy() {
+  CesiumRuntimeStats::removeTileMemoryUsage(this->_memoryUsage);
+  this->_memoryUsage = FCesiumTilesetMemoryStatistics();
+  Super::BeginDestroy();
+}
+
+void UCesiumGltfComponent::AddMemoryUsage(
+    const FCesiumTilesetMemoryStatistics& Usage) {
+  this->_memoryUsage += Usage;
+  this->_memoryUsage.UpdateTotalBytes();
+  CesiumRuntimeStats::addTileMemoryUsage(Usage);
+}
+
+UMaterialInstanceDynamic*
+UCesiumGltfComponent::FindSharedMaterial(const FString& Key) const {
+  UMaterialInstanceDynamic* const* ppMaterial =
+      this->_sharedMaterials.Find(Key);
+  return ppMaterial ? *ppMaterial : nullptr;
+}
+
+void UCesiumGltfComponent::AddSharedMaterial(
+    const FString& Key,
+    UMaterialInstanceDynamic* pMaterial) {
+  this->_sharedMaterials.Add(Key, pMaterial);
+}
+
+void UCesiumGltfComponent::AddStreamedTexture(UTexture2D* pTexture) {
+  this->_streamedTextures.Add(pTexture);
+}
+
+void UCesiumGltfComponent::UpdateTextureStreaming(float ScreenSize) {
+  for (UTexture2D* pTexture : this->_streamedTextures) {
+    // The textures are destroyed with the materials of the primitives, which
+    // may happen before this component is destroyed.
+    if (IsValid(pTexture)) {
+      CesiumTextureUtility::streamTextureMips(pTexture, ScreenSize);
+    }
+  }
+}
+
+void UCesiumGltfComponent::CookDeferredCollision(
+    const TArray<FSphere>& Sources) {
+  if (this->_cookingDeferredCollision) {
+    return;
+  }
+
+  struct CookJob {
+    TWeakObjectPtr<UCesiumGltfPrimitiveComponent> pPrimitive;
+    std::shared_ptr<DeferredCollisionMesh> pDeferred;
+    CesiumCollisionMesh pCollisionMesh = nullptr;
+    int64 collisionBytes = 0;
+  };
+
+  TArray<CookJob> jobs;
+
+  for (USceneComponent* pChild : this->GetAttachChildren()) {
+    UCesiumGltfPrimitiveComponent* pPrimitive =
+        Cast<UCesiumGltfPrimitiveComponent>(pChild);
+    if (!pPrimitive || !pPrimitive->pDeferredCollision) {
+      continue;
+    }
+
+    FBox bounds = pPrimitive->pDeferredCollision->bounds.TransformBy(
+        pPrimitive->GetComponentTransform());
+    bool inRange = false;
+    for (const FSphere& source : Sources) {
+      if (bounds.ComputeSquaredDistanceToPoint(source.Center) <=
+          source.W * source.W) {
+        inRange = true;
+        break;
+      }
+    }
+
+    if (inRange) {
+      jobs.Add({pPrimitive, pPrimitive->pDeferredCollision});
+    }
+  }
+
+  if (jobs.Num() == 0) {
+    return;
+  }
+
+#if PHYSICS_INTERFACE_PHYSX
+  IPhysXCooking* pPhysXCooking = GetPhysXCookingModule()->GetPhysXCooking();
+#endif
+
+  this->_cookingDeferredCollision = true;
+  TWeakObjectPtr<UCesiumGltfComponent> pThis = this;
+
+  Async(
+      EAsyncExecution::ThreadPool,
+      [jobs = MoveTemp(jobs),
+#if PHYSICS_INTERFACE_PHYSX
+       pPhysXCooking,
+#endif
+       pThis]() mutable {
+        CESIUM_TRACE("CookDeferredCollision");
+        for (CookJob& job : jobs) {
+          // Nothing else reads the positions of a deferred mesh once it is
+          // being cooked, so they can be moved into the collision mesh.
+          job.collisionBytes = estimateCollisionBytes(
+              job.pDeferred->positions,
+              job.pDeferred->indices);
+          job.pCollisionMesh = buildCollisionMesh(
+              MoveTemp(job.pDeferred->positions),
+              job.pDeferred->indices
+#if PHYSICS_INTERFACE_PHYSX
+              ,
+              pPhysXCooking
+#endif
+          );
+        }
+
+        AsyncTask(
+            ENamedThreads::GameThread,
+            [jobs = MoveTemp(jobs), pThis]() mutable {
+              for (CookJob& job : jobs) {
+                UCesiumGltfPrimitiveComponent* pPrimitive =
+                    job.pPrimitive.Get();
+                UBodySetup* pBodySetup =
+                    pPrimitive ? pPrimitive->GetBodySetup() : nullptr;
+
+                // The primitive may have been destroyed, or reused by another
+                // tile, while its collision mesh was being cooked.
+                if (!pBodySetup ||
+                    pPrimitive->pDeferredCollision != job.pDeferred) {
+#if PHYSICS_INTERFACE_PHYSX
+                  if (job.pCollisionMesh) {
+                    job.pCollisionMesh->release();
+                  }
+#endif
+                  continue;
+                }
+
+                pPrimitive->pDeferredCollision.reset();
+                if (!job.pCollisionMesh) {
+                  continue;
+                }
+
+                if (UCesiumGltfComponent* pGltf = pThis.Get()) {
+                  FCesiumTilesetMemoryStatistics usage;
+                  usage.CollisionBytes = job.collisionBytes;
+                  pGltf->AddMemoryUsage(usage);
+                }
+
+#if PHYSICS_INTERFACE_PHYSX
+                pBodySetup->TriMeshes.Add(job.pCollisionMesh);
+#else
+                pBodySetup->ChaosTriMeshes.Add(job.pCollisionMesh);
+#endif
+                pPrimitive->RecreatePhysicsState();
+              }
+
+              if (UCesiumGltfComponent* pGltf = pThis.Get()) {
+                pGltf->_cookingDeferredCollision = false;
+              }
+            });
+      });
+}
+
+int32 UCesiumGltfComponent::BuildDistanceFields(
+    const TArray<FSphere>& Sources,
+    int32 MaximumBuilds,
+    int32 Resolution) {
+  struct BuildJob {
+    TWeakObjectPtr<UCesiumGltfPrimitiveComponent> pPrimitive;
+    TWeakObjectPtr<UStaticMesh> pStaticMesh;
+    std::shared_ptr<const CesiumTriangleBVH> pBVH;
+    FDistanceFieldVolumeData* pData = nullptr;
+  };
+
+  TArray<BuildJob> jobs;
 
-  Gltf->CustomDepthParameters = CustomDepthParameters;
+  for (USceneComponent* pChild : this->GetAttachChildren()) {
+    if (jobs.Num() >= MaximumBuilds) {
+      break;
+    }
+
+    UCesiumGltfPrimitiveComponent* pPrimitive =
+        Cast<UCesiumGltfPrimitiveComponent>(pChild);
+    if (!pPrimitive || !pPrimitive->pQueryBVH ||
+        pPrimitive->DistanceFieldRequested || !pPrimitive->GetStaticMesh() ||
+        pPrimitive->IsPointCloud || pPrimitive->IsHeightfield) {
+      continue;
+    }
 
-  for (LoadNodeResult& node : pReal->loadModelResult.nodeResults) {
-    if (node.meshResult) {
-      for (LoadPrimitiveResult& primitive : node.meshResult->primitiveResults) {
-        loadPrimitiveGameThreadPart(Gltf, primitive, cesiumToUnrealTransform);
+    FBox bounds = pPrimitive->pQueryBVH->getBounds().TransformBy(
+        pPrimitive->GetComponentTransform());
+    bool inRange = false;
+    for (const FSphere& source : Sources) {
+      if (bounds.ComputeSquaredDistanceToPoint(source.Center) <=
+          source.W * source.W) {
+        inRange = true;
+        break;
       }
     }
+
+    if (inRange) {
+      pPrimitive->DistanceFieldRequested = true;
+      jobs.Add(
+          {pPrimitive, pPrimitive->GetStaticMesh(), pPrimitive->pQueryBVH});
+    }
   }
 
-  Gltf->SetVisibility(false, true);
-  Gltf->SetCollisionEnabled(ECollisionEnabled::NoCollision);
-  return Gltf;
-}
+  if (jobs.Num() == 0) {
+    return 0;
+  }
 
-UCesiumGltfComponent::UCesiumGltfComponent() : USceneComponent() {
-  // Structure to hold one-time initialization
-  struct FConstructorStatics {
-    ConstructorHelpers::FObjectFinder<UMaterialInstance> BaseMaterial;
-    ConstructorHelpers::FObjectFinder<UMaterialInstance> BaseMaterialWithWater;
-    ConstructorHelpers::FObjectFinder<UTexture2D> Transparent1x1;
-    FConstructorStatics()
-        : BaseMaterial(TEXT(
-              "/CesiumForUnreal/Materials/Instances/MI_CesiumThreeOverlaysAndClipping.MI_CesiumThreeOverlaysAndClipping")),
-          BaseMaterialWithWater(TEXT(
-              "/CesiumForUnreal/Materials/Instances/MI_CesiumThreeOverlaysAndClippingAndWater.MI_CesiumThreeOverlaysAndClippingAndWater")),
-          Transparent1x1(
-              TEXT("/CesiumForUnreal/Textures/transparent1x1.transparent1x1")) {
-    }
-  };
-  static FConstructorStatics ConstructorStatics;
+  const int32 numJobs = jobs.Num();
+  Async(
+      EAsyncExecution::ThreadPool,
+      [jobs = MoveTemp(jobs), Resolution]() mutable {
+        CESIUM_TRACE("BuildDistanceFields");
+        for (BuildJob& job : jobs) {
+          job.pData = CesiumDistanceField::build(*job.pBVH, Resolution);
+        }
 
-  this->BaseMaterial = ConstructorStatics.BaseMaterial.Object;
-  this->BaseMaterialWithWater = ConstructorStatics.BaseMaterialWithWater.Object;
-  this->Transparent1x1 = ConstructorStatics.Transparent1x1.Object;
+        AsyncTask(ENamedThreads::GameThread, [jobs = MoveTemp(jobs)]() {
+          for (const BuildJob& job : jobs) {
+            UCesiumGltfPrimitiveComponent* pPrimitive = job.pPrimitive.Get();
+            UStaticMesh* pStaticMesh = job.pStaticMesh.Get();
+
+            // The primitive may have been destroyed, or reused by another
+            // tile, while its distance field was being built.
+            if (!pPrimitive || !pStaticMesh ||
+                pPrimitive->GetStaticMesh() != pStaticMesh ||
+                pPrimitive->pQueryBVH != job.pBVH) {
+              delete job.pData;
+              continue;
+            }
 
-  PrimaryComponentTick.bCanEverTick = false;
-}
+            if (job.pData) {
+              CesiumDistanceField::attach(pStaticMesh, job.pData);
+              pPrimitive->MarkRenderStateDirty();
+            }
+          }
+        });
+      });
 
-UCesiumGltfComponent::~UCesiumGltfComponent() {
-  UE_LOG(LogCesium, VeryVerbose, TEXT("~UCesiumGltfComponent"));
+  return numJobs;
 }
 
 void UCesiumGltfComponent::UpdateTransformFromCesium(
     const glm::dmat4& cesiumToUnrealTransform) {
   for (USceneComponent* pSceneComponent : this->GetAttachChildren()) {
-    UCesiumGltfPrimitiveComponent* pPrimitive =
-        Cast<UCesiumGltfPrimitiveComponent>(pSceneComponent);
-    if (pPrimitive) {
+    if (UCesiumGltfPrimitiveComponent* pPrimitive =
+            Cast<UCesiumGltfPrimitiveComponent>(pSceneComponent)) {
       pPrimitive->UpdateTransformFromCesium(cesiumToUnrealTransform);
+    } else if (
+        UCesiumGltfInstancedComponent* pInstanced =
+            Cast<UCesiumGltfInstancedComponent>(pSceneComponent)) {
+      pInstanced->UpdateTransformFromCesium(cesiumToUnrealTransform);
     }
   }
 }
 
-namespace {
-
-template <typename Func>
-void forEachPrimitiveComponent(UCesiumGltfComponent* pGltf, Func&& f) {
-  for (USceneComponent* pSceneComponent : pGltf->GetAttachChildren()) {
-    UCesiumGltfPrimitiveComponent* pPrimitive =
-        Cast<UCesiumGltfPrimitiveComponent>(pSceneComponent);
-    if (pPrimitive) {
-      UMaterialInstanceDynamic* pMaterial =
-          Cast<UMaterialInstanceDynamic>(pPrimitive->GetMaterial(0));
-
-#if ENGINE_MAJOR_VERSION >= 5
-      if (!IsValid(pMaterial)) {
-#else
-      if (pMaterial->IsPendingKillOrUnreachable()) {
-#endif
-        // Don't try to update the material while it's in the process of being
-        // destroyed. This can lead to the render thread freaking out when
-        // it's asked to update a parameter for a material that has been
-        // marked for garbage collection.
-        continue;
-      }
-
-      UMaterialInterface* pBaseMaterial = pMaterial->Parent;
-      UMaterialInstance* pBaseAsMaterialInstance =
-          Cast<UMaterialInstance>(pBaseMaterial);
-      UCesiumMaterialUserData* pCesiumData =
-          pBaseAsMaterialInstance
-              ? pBaseAsMaterialInstance
-                    ->GetAssetUserData<UCesiumMaterialUserData>()
-              : nullptr;
-
-      f(pPrimitive, pMaterial, pCesiumData);
-    }
-  }
-} // namespace
-
-} // namespace
-
 void UCesiumGltfComponent::AttachRasterTile(
     const Cesium3DTilesSelection::Tile& tile,
     const Cesium3DTilesSelection::RasterOverlayTile& rasterTile,
@@ -1821,68 +5164,35 @@ void UCesiumGltfComponent::AttachRasterTile(
     const glm::dvec2& translation,
     const glm::dvec2& scale,
     int32 textureCoordinateID) {
+  const OverlayParameterNames& names =
+      getOverlayParameterNames(rasterTile.getOverlay().getName());
+
+  FRasterOverlayTile overlayTile{};
+  overlayTile.OverlayName = names.overlayName;
+  overlayTile.Texture = pTexture;
+  overlayTile.TranslationAndScale =
+      FLinearColor(translation.x, translation.y, scale.x, scale.y);
+  overlayTile.TextureCoordinateID = textureCoordinateID;
+  overlayTile.TextureParameterName = names.texture;
+  overlayTile.TranslationScaleParameterName = names.translationScale;
+  overlayTile.TextureCoordinateIndexParameterName =
+      names.textureCoordinateIndex;
 
-  FLinearColor translationAndScale(
-      translation.x,
-      translation.y,
-      scale.x,
-      scale.y);
-
-  forEachPrimitiveComponent(
-      this,
-      [&rasterTile, pTexture, &translationAndScale, textureCoordinateID](
-          UCesiumGltfPrimitiveComponent* pPrimitive,
-          UMaterialInstanceDynamic* pMaterial,
-          UCesiumMaterialUserData* pCesiumData) {
-        // If this material uses material layers and has the Cesium user data,
-        // set the parameters on each material layer that maps to this overlay
-        // tile.
-        if (pCesiumData) {
-          FString name(
-              UTF8_TO_TCHAR(rasterTile.getOverlay().getName().c_str()));
-
-          for (int32 i = 0; i < pCesiumData->LayerNames.Num(); ++i) {
-            if (pCesiumData->LayerNames[i] != name) {
-              continue;
-            }
+  for (USceneComponent* pSceneComponent : this->GetAttachChildren()) {
+    UCesiumGltfPrimitiveComponent* pPrimitive =
+        Cast<UCesiumGltfPrimitiveComponent>(pSceneComponent);
+    if (pPrimitive) {
+      applyRasterOverlayTile(pPrimitive, overlayTile);
+    }
+  }
 
-            pMaterial->SetTextureParameterValueByInfo(
-                FMaterialParameterInfo(
-                    "Texture",
-                    EMaterialParameterAssociation::LayerParameter,
-                    i),
-                pTexture);
-            pMaterial->SetVectorParameterValueByInfo(
-                FMaterialParameterInfo(
-                    "TranslationScale",
-                    EMaterialParameterAssociation::LayerParameter,
-                    i),
-                translationAndScale);
-            pMaterial->SetScalarParameterValueByInfo(
-                FMaterialParameterInfo(
-                    "TextureCoordinateIndex",
-                    EMaterialParameterAssociation::LayerParameter,
-                    i),
-                pPrimitive
-                    ->overlayTextureCoordinateIDToUVIndex[textureCoordinateID]);
-          }
-        } else {
-          pMaterial->SetTextureParameterValue(
-              createSafeName(rasterTile.getOverlay().getName(), "_Texture"),
-              pTexture);
-          pMaterial->SetVectorParameterValue(
-              createSafeName(
-                  rasterTile.getOverlay().getName(),
-                  "_TranslationScale"),
-              translationAndScale);
-          pMaterial->SetScalarParameterValue(
-              createSafeName(
-                  rasterTile.getOverlay().getName(),
-                  "_TextureCoordinateIndex"),
-              pPrimitive
-                  ->overlayTextureCoordinateIDToUVIndex[textureCoordinateID]);
-        }
+  // Remember the overlay tile for primitives that are created later.
+  this->_overlayTiles.RemoveAll(
+      [&overlayTile](const FRasterOverlayTile& existing) {
+        return existing.OverlayName == overlayTile.OverlayName &&
+               existing.TextureCoordinateID == overlayTile.TextureCoordinateID;
       });
+  this->_overlayTiles.Add(MoveTemp(overlayTile));
 }
 
 void UCesiumGltfComponent::DetachRasterTile(
@@ -1890,9 +5200,16 @@ void UCesiumGltfComponent::DetachRasterTile(
     const Cesium3DTilesSelection::RasterOverlayTile& rasterTile,
     UTexture2D* pTexture) {
 
+  this->_overlayTiles.RemoveAll([pTexture](const FRasterOverlayTile& existing) {
+    return existing.Texture == pTexture;
+  });
+
+  const OverlayParameterNames& names =
+      getOverlayParameterNames(rasterTile.getOverlay().getName());
+
   forEachPrimitiveComponent(
       this,
-      [this, &rasterTile, pTexture](
+      [this, &names](
           UCesiumGltfPrimitiveComponent* pPrimitive,
           UMaterialInstanceDynamic* pMaterial,
           UCesiumMaterialUserData* pCesiumData) {
@@ -1900,23 +5217,21 @@ void UCesiumGltfComponent::DetachRasterTile(
         // clear the parameters on each material layer that maps to this overlay
         // tile.
         if (pCesiumData) {
-          FString name(
-              UTF8_TO_TCHAR(rasterTile.getOverlay().getName().c_str()));
           for (int32 i = 0; i < pCesiumData->LayerNames.Num(); ++i) {
-            if (pCesiumData->LayerNames[i] != name) {
+            if (pCesiumData->LayerNames[i] != names.overlayName) {
               continue;
             }
 
             pMaterial->SetTextureParameterValueByInfo(
                 FMaterialParameterInfo(
-                    "Texture",
+                    LayerTextureParameterName,
                     EMaterialParameterAssociation::LayerParameter,
                     i),
                 this->Transparent1x1);
           }
         } else {
           pMaterial->SetTextureParameterValue(
-              createSafeName(rasterTile.getOverlay().getName(), "_Texture"),
+              names.texture,
               this->Transparent1x1);
         }
       });
@@ -1925,59 +5240,374 @@ void UCesiumGltfComponent::DetachRasterTile(
 void UCesiumGltfComponent::SetCollisionEnabled(
     ECollisionEnabled::Type NewType) {
   for (USceneComponent* pSceneComponent : this->GetAttachChildren()) {
-    UCesiumGltfPrimitiveComponent* pPrimitive =
-        Cast<UCesiumGltfPrimitiveComponent>(pSceneComponent);
+    UStaticMeshComponent* pPrimitive =
+        Cast<UStaticMeshComponent>(pSceneComponent);
     if (pPrimitive) {
       pPrimitive->SetCollisionEnabled(NewType);
     }
   }
 }
 
+/**
+ * Checks whether a primitive has any geometry to collide with, or will have
+ * once its deferred collision mesh is cooked.
+ */
+static bool hasCollisionGeometry(UStaticMeshComponent* pPrimitive) {
+  UCesiumGltfPrimitiveComponent* pGltfPrimitive =
+      Cast<UCesiumGltfPrimitiveComponent>(pPrimitive);
+  if (pGltfPrimitive && pGltfPrimitive->pDeferredCollision) {
+    return true;
+  }
+
+  UBodySetup* pBodySetup = pPrimitive->GetBodySetup();
+  if (!pBodySetup) {
+    return false;
+  }
+
 #if PHYSICS_INTERFACE_PHYSX
-static void BuildPhysXTriangleMeshes(
-    PxTriangleMesh*& pCollisionMesh,
-    const IPhysXCooking* pPhysXCooking,
-    const TArray<FStaticMeshBuildVertex>& vertexData,
-    const TArray<uint32>& indices) {
+  return pBodySetup->TriMeshes.Num() > 0;
+#else
+  return pBodySetup->ChaosTriMeshes.Num() > 0;
+#endif
+}
 
-  if (pPhysXCooking) {
-    int32 vertexCount = vertexData.Num();
-    int32 triangleCount = indices.Num() / 3;
+void UCesiumGltfComponent::SetTileVisibility(bool Visible) {
+  if (this->IsVisible() == Visible) {
+    return;
+  }
+
+  CESIUM_TRACE("SetTileVisibility");
+
+  // The primitives are the only children, so there is no need for
+  // SetVisibility to walk the attachment hierarchy.
+  this->SetVisibility(Visible, false);
+
+  ECollisionEnabled::Type collision =
+      Visible ? ECollisionEnabled::QueryAndPhysics
+              : ECollisionEnabled::NoCollision;
+
+  for (USceneComponent* pSceneComponent : this->GetAttachChildren()) {
+    UStaticMeshComponent* pPrimitive =
+        Cast<UStaticMeshComponent>(pSceneComponent);
+    if (!pPrimitive) {
+      continue;
+    }
+
+    pPrimitive->SetVisibility(Visible, false);
+
+    // Changing the collision of a primitive updates its physics state and
+    // overlaps, which is wasted work when it has nothing to collide with.
+    if (hasCollisionGeometry(pPrimitive)) {
+      pPrimitive->SetCollisionEnabled(collision);
+    }
+  }
+}
+
+void UCesiumGltfComponent::SetTileVisibleInRayTracing(
+    bool VisibleInRayTracing) {
+  if (this->_visibleInRayTracing == VisibleInRayTracing) {
+    return;
+  }
+
+  this->_visibleInRayTracing = VisibleInRayTracing;
+
+  const bool visible = VisibleInRayTracing && this->_supportRayTracing;
+  for (USceneComponent* pSceneComponent : this->GetAttachChildren()) {
+    UPrimitiveComponent* pPrimitive =
+        Cast<UPrimitiveComponent>(pSceneComponent);
+    if (pPrimitive && pPrimitive->bVisibleInRayTracing != visible) {
+      pPrimitive->bVisibleInRayTracing = visible;
+      pPrimitive->MarkRenderStateDirty();
+    }
+  }
+}
+
+void UCesiumGltfComponent::SetTileCastShadow(bool CastShadow) {
+  if (this->_castShadow == CastShadow) {
+    return;
+  }
+
+  this->_castShadow = CastShadow;
+
+  for (USceneComponent* pSceneComponent : this->GetAttachChildren()) {
+    UStaticMeshComponent* pPrimitive =
+        Cast<UStaticMeshComponent>(pSceneComponent);
+    if (pPrimitive) {
+      pPrimitive->SetCastShadow(CastShadow);
+    }
+    if (UCesiumGltfPrimitiveComponent* pGltfPrimitive =
+            Cast<UCesiumGltfPrimitiveComponent>(pPrimitive)) {
+      pGltfPrimitive->UpdateTileBatch();
+    }
+  }
+}
+
+void UCesiumGltfComponent::SetTileCullDistance(float CullDistance) {
+  if (this->_cullDistance == CullDistance) {
+    return;
+  }
+
+  if (this->_cullDistance > 0.0f && CullDistance > 0.0f &&
+      FMath::Abs(CullDistance - this->_cullDistance) <
+          0.1f * this->_cullDistance) {
+    return;
+  }
+
+  this->_cullDistance = CullDistance;
+
+  for (USceneComponent* pSceneComponent : this->GetAttachChildren()) {
+    UStaticMeshComponent* pPrimitive =
+        Cast<UStaticMeshComponent>(pSceneComponent);
+    if (pPrimitive) {
+      pPrimitive->SetCullDistance(CullDistance);
+    }
+    if (UCesiumGltfPrimitiveComponent* pGltfPrimitive =
+            Cast<UCesiumGltfPrimitiveComponent>(pPrimitive)) {
+      pGltfPrimitive->UpdateTileBatch();
+    }
+  }
+}
+
+void UCesiumGltfComponent::SetCollisionSettings(
+    const FBodyInstance& BodyInstance) {
+  this->CollisionObjectType = BodyInstance.GetObjectType();
+  this->CollisionResponses = BodyInstance.GetResponseToChannels();
+
+  for (USceneComponent* pSceneComponent : this->GetAttachChildren()) {
+    UStaticMeshComponent* pPrimitive =
+        Cast<UStaticMeshComponent>(pSceneComponent);
+    if (pPrimitive) {
+      pPrimitive->SetCollisionObjectType(this->CollisionObjectType);
+      pPrimitive->SetCollisionResponseToChannels(this->CollisionResponses);
+    }
+  }
+}
+
+namespace {
+UMaterialInterface* getBaseMaterialOrDefault(UMaterialInterface* pMaterial) {
+  return pMaterial ? pMaterial
+                   : GetDefault<UCesiumGltfComponent>()->BaseMaterial;
+}
+
+UMaterialInterface*
+getBaseWaterMaterialOrDefault(UMaterialInterface* pMaterial) {
+  return pMaterial
+             ? pMaterial
+             : GetDefault<UCesiumGltfComponent>()->BaseMaterialWithWater;
+}
+
+bool haveSameLayers(UMaterialInterface* pOld, UMaterialInterface* pNew) {
+  if (pOld == pNew) {
+    return true;
+  }
+
+#if CESIUM_BUILD_NANITE
+  // Whether the Nanite data of a primitive is kept depends on the blend mode
+  // of its material.
+  if (pOld->GetBlendMode() != pNew->GetBlendMode()) {
+    return false;
+  }
+#endif
+
+  // The raster overlays and the layer parameters of the glTF material are
+  // set by the index of their layer, so the layers must not change.
+  UMaterialInstance* pOldInstance = Cast<UMaterialInstance>(pOld);
+  UMaterialInstance* pNewInstance = Cast<UMaterialInstance>(pNew);
+  UCesiumMaterialUserData* pOldData =
+      pOldInstance ? pOldInstance->GetAssetUserData<UCesiumMaterialUserData>()
+                   : nullptr;
+  UCesiumMaterialUserData* pNewData =
+      pNewInstance ? pNewInstance->GetAssetUserData<UCesiumMaterialUserData>()
+                   : nullptr;
+  if (!pOldData || !pNewData) {
+    return pOldData == pNewData;
+  }
+  return pOldData->LayerNames == pNewData->LayerNames;
+}
+
+TArray<FStaticMaterial>& getStaticMaterials(UStaticMesh* pStaticMesh) {
+#if ENGINE_MAJOR_VERSION == 4 && ENGINE_MINOR_VERSION < 27
+  return pStaticMesh->StaticMaterials;
+#else
+  return pStaticMesh->GetStaticMaterials();
+#endif
+}
+} // namespace
+
+/*static*/ bool UCesiumGltfComponent::CanUpdateMaterials(
+    UMaterialInterface* OldBaseMaterial,
+    UMaterialInterface* OldBaseWaterMaterial,
+    UMaterialInterface* NewBaseMaterial,
+    UMaterialInterface* NewBaseWaterMaterial) {
+  return haveSameLayers(
+             getBaseMaterialOrDefault(OldBaseMaterial),
+             getBaseMaterialOrDefault(NewBaseMaterial)) &&
+         haveSameLayers(
+             getBaseWaterMaterialOrDefault(OldBaseWaterMaterial),
+             getBaseWaterMaterialOrDefault(NewBaseWaterMaterial));
+}
+
+void UCesiumGltfComponent::UpdateMaterials(
+    UMaterialInterface* pBaseMaterial,
+    UMaterialInterface* pBaseWaterMaterial) {
+  pBaseMaterial = getBaseMaterialOrDefault(pBaseMaterial);
+  pBaseWaterMaterial = getBaseWaterMaterialOrDefault(pBaseWaterMaterial);
+  if (pBaseMaterial == this->BaseMaterial &&
+      pBaseWaterMaterial == this->BaseMaterialWithWater) {
+    return;
+  }
+
+  CESIUM_TRACE("UCesiumGltfComponent::UpdateMaterials");
+
+  this->BaseMaterial = pBaseMaterial;
+  this->BaseMaterialWithWater = pBaseWaterMaterial;
+
+  // A material instance that is shared by several primitives is replaced
+  // once, for the first of them, and the others get the same replacement.
+  TMap<UMaterialInstanceDynamic*, UMaterialInstanceDynamic*> replacements;
+  for (USceneComponent* pSceneComponent : this->GetAttachChildren()) {
+    UStaticMeshComponent* pMesh = Cast<UStaticMeshComponent>(pSceneComponent);
+    UStaticMesh* pStaticMesh = pMesh ? pMesh->GetStaticMesh() : nullptr;
+    if (!pStaticMesh) {
+      continue;
+    }
+
+    TArray<FStaticMaterial>& materials = getStaticMaterials(pStaticMesh);
+    UMaterialInstanceDynamic* pOld =
+        materials.Num() > 0
+            ? Cast<UMaterialInstanceDynamic>(materials[0].MaterialInterface)
+            : nullptr;
+    if (!pOld) {
+      continue;
+    }
 
-    // TODO: use PhysX interface directly so we don't need to copy the
-    // vertices (it takes a stride parameter).
-    TArray<FVector> vertices;
-    vertices.SetNum(vertexCount);
+    UMaterialInstanceDynamic*& pNew = replacements.FindOrAdd(pOld);
+    if (!pNew) {
+      UCesiumGltfPrimitiveComponent* pPrimitive =
+          Cast<UCesiumGltfPrimitiveComponent>(pMesh);
+      UCesiumGltfInstancedComponent* pInstanced =
+          Cast<UCesiumGltfInstancedComponent>(pMesh);
+      const bool usesWaterMaterial =
+          pPrimitive ? pPrimitive->UsesWaterMaterial
+                     : pInstanced && pInstanced->UsesWaterMaterial;
+
+      // The parameters include the glTF textures, the water mask and the
+      // raster overlays, so nothing has to be loaded again.
+      pNew = UMaterialInstanceDynamic::Create(
+          usesWaterMaterial ? pBaseWaterMaterial : pBaseMaterial,
+          nullptr,
+          pOld->GetFName());
+      pNew->SetFlags(
+          RF_Transient | RF_DuplicateTransient | RF_TextExportTransient);
+      pNew->CopyParameterOverrides(pOld);
+      pNew->TwoSided = pOld->TwoSided;
+    }
+
+    materials[0].MaterialInterface = pNew;
+    pMesh->MarkRenderStateDirty();
+
+    // Batched primitives have no render state, so their entry in the tile
+    // batch has to be updated before the old instance and its render proxy
+    // are destroyed.
+    if (UCesiumGltfPrimitiveComponent* pPrimitive =
+            Cast<UCesiumGltfPrimitiveComponent>(pMesh)) {
+      pPrimitive->UpdateTileBatch();
+    }
+  }
+
+  // The primitives that are created later share the new instances. Their
+  // keys start with the base material, which has changed too.
+  TMap<FString, UMaterialInstanceDynamic*> sharedMaterials;
+  for (const auto& sharedMaterial : this->_sharedMaterials) {
+    UMaterialInstanceDynamic** ppNew = replacements.Find(sharedMaterial.Value);
+    if (!ppNew) {
+      sharedMaterials.Add(sharedMaterial.Key, sharedMaterial.Value);
+      continue;
+    }
 
-    for (size_t i = 0; i < vertexCount; ++i) {
-      vertices[i] = vertexData[i].Position;
+    FString key = sharedMaterial.Key;
+    const FString oldPrefix =
+        FString::Printf(TEXT("%p "), sharedMaterial.Value->Parent);
+    if (key.StartsWith(oldPrefix, ESearchCase::CaseSensitive)) {
+      key = FString::Printf(TEXT("%p "), (*ppNew)->Parent) +
+            key.RightChop(oldPrefix.Len());
     }
+    sharedMaterials.Add(key, *ppNew);
+  }
+  this->_sharedMaterials = MoveTemp(sharedMaterials);
 
-    TArray<FTriIndices> physicsIndices;
-    physicsIndices.SetNum(triangleCount);
+  for (const auto& replacement : replacements) {
+    CesiumLifetime::destroy(replacement.Key);
+  }
+}
+
+void UCesiumGltfComponent::SetCustomDepthParameters(
+    const FCustomDepthParameters& Parameters) {
+  if (this->CustomDepthParameters == Parameters) {
+    return;
+  }
+
+  this->CustomDepthParameters = Parameters;
 
-    for (size_t i = 0; i < triangleCount; ++i) {
-      physicsIndices[i].v0 = indices[3 * i];
-      physicsIndices[i].v1 = indices[3 * i + 1];
-      physicsIndices[i].v2 = indices[3 * i + 2];
+  for (USceneComponent* pSceneComponent : this->GetAttachChildren()) {
+    UStaticMeshComponent* pMesh = Cast<UStaticMeshComponent>(pSceneComponent);
+    if (pMesh) {
+      pMesh->SetRenderCustomDepth(Parameters.RenderCustomDepth);
+      pMesh->SetCustomDepthStencilWriteMask(
+          Parameters.CustomDepthStencilWriteMask);
+      pMesh->SetCustomDepthStencilValue(Parameters.CustomDepthStencilValue);
     }
+  }
+}
+
+#if PHYSICS_INTERFACE_PHYSX
+static void BuildPhysXTriangleMeshes(
+    PxTriangleMesh*& pCollisionMesh,
+    const IPhysXCooking* pPhysXCooking,
+    const TArray<TMeshVector3>& positions,
+    const TArray<uint32>& indices,
+    TArray<uint8>* pCooked) {
+  physx::PxCooking* pCooking =
+      pPhysXCooking ? pPhysXCooking->GetCooking() : nullptr;
+  if (!pCooking) {
+    return;
+  }
 
-    pPhysXCooking->CreateTriMesh(
-        "PhysXGeneric",
-        EPhysXMeshCookFlags::Default,
-        vertices,
-        physicsIndices,
-        TArray<uint16>(),
-        true,
-        pCollisionMesh);
+  // The positions and triangle indices are already laid out the way PhysX
+  // reads them, so they are cooked in place instead of being copied into the
+  // arrays that IPhysXCooking::CreateTriMesh takes. As with CreateTriMesh,
+  // the normals are flipped for Unreal's left-handed coordinate system.
+  physx::PxTriangleMeshDesc desc;
+  desc.points.count = static_cast<physx::PxU32>(positions.Num());
+  desc.points.stride = sizeof(TMeshVector3);
+  desc.points.data = positions.GetData();
+  desc.triangles.count = static_cast<physx::PxU32>(indices.Num() / 3);
+  desc.triangles.stride = 3 * sizeof(uint32);
+  desc.triangles.data = indices.GetData();
+  desc.flags = physx::PxMeshFlag::eFLIPNORMALS;
+
+  if (pCooked) {
+    // The mesh is cooked into a stream that is kept, and created from it.
+    physx::PxDefaultMemoryOutputStream stream;
+    if (!pCooking->cookTriangleMesh(desc, stream)) {
+      pCooked->Empty();
+      return;
+    }
+    pCooked->SetNumUninitialized(static_cast<int32>(stream.getSize()));
+    FMemory::Memcpy(pCooked->GetData(), stream.getData(), stream.getSize());
+    pCollisionMesh = CesiumConvertedModel::readCollisionMesh(*pCooked);
+    return;
   }
+
+  pCollisionMesh = pCooking->createTriangleMesh(
+      desc,
+      GPhysXSDK->getPhysicsInsertionCallback());
 }
 
 #else
 template <typename TIndex>
 static void fillTriangles(
     TArray<Chaos::TVector<TIndex, 3>>& triangles,
-    const TArray<FStaticMeshBuildVertex>& vertexData,
     const TArray<uint32>& indices,
     int32 triangleCount) {
 
@@ -1992,36 +5622,53 @@ static void fillTriangles(
   }
 }
 
+/**
+ * Creates the particles of a Chaos triangle mesh. When the positions are
+ * already of the particles' type, as in UE5, they are moved into the
+ * particles rather than copied.
+ */
+template <typename TPosition>
+static Chaos::TParticles<Chaos::FRealSingle, 3>
+createParticles(TArray<TPosition>&& positions) {
+  using TParticle = Chaos::TVector<Chaos::FRealSingle, 3>;
+  if constexpr (std::is_same_v<TPosition, TParticle>) {
+    return Chaos::TParticles<Chaos::FRealSingle, 3>(MoveTemp(positions));
+  } else {
+    Chaos::TParticles<Chaos::FRealSingle, 3> particles;
+    particles.AddParticles(positions.Num());
+    for (int32 i = 0; i < positions.Num(); ++i) {
+      particles.X(i) = positions[i];
+    }
+    return particles;
+  }
+}
+
 static TSharedPtr<Chaos::FTriangleMeshImplicitObject, ESPMode::ThreadSafe>
 BuildChaosTriangleMeshes(
-    const TArray<FStaticMeshBuildVertex>& vertexData,
+    TArray<TMeshVector3>&& positions,
     const TArray<uint32>& indices) {
 
-  int32 vertexCount = vertexData.Num();
+  int32 vertexCount = positions.Num();
   int32 triangleCount = indices.Num() / 3;
 
-  Chaos::TParticles<Chaos::FRealSingle, 3> vertices;
-  vertices.AddParticles(vertexCount);
-
-  for (int32 i = 0; i < vertexCount; ++i) {
-    vertices.X(i) = vertexData[i].Position;
-  }
+  Chaos::TParticles<Chaos::FRealSingle, 3> vertices =
+      createParticles(MoveTemp(positions));
 
+  // All triangles use the shape's default material, which is what Chaos
+  // returns for triangles without a material index.
   TArray<uint16> materials;
-  materials.SetNum(triangleCount);
-
-  TArray<int32> faceRemap;
-  faceRemap.SetNum(triangleCount);
 
+  TUniquePtr<TArray<int32>> pFaceRemap = MakeUnique<TArray<int32>>();
+  pFaceRemap->SetNumUninitialized(triangleCount);
   for (int32 i = 0; i < triangleCount; ++i) {
-    faceRemap[i] = i;
+    (*pFaceRemap)[i] = i;
   }
 
-  TUniquePtr<TArray<int32>> pFaceRemap = MakeUnique<TArray<int32>>(faceRemap);
-
+  // The triangles are copied because Chaos stores them as vectors, with the
+  // smallest index type that fits.
   if (vertexCount < TNumericLimits<uint16>::Max()) {
     TArray<Chaos::TVector<uint16, 3>> triangles;
-    fillTriangles(triangles, vertexData, indices, triangleCount);
+    fillTriangles(triangles, indices, triangleCount);
     return MakeShared<Chaos::FTriangleMeshImplicitObject, ESPMode::ThreadSafe>(
         MoveTemp(vertices),
         MoveTemp(triangles),
@@ -2031,7 +5678,7 @@ BuildChaosTriangleMeshes(
         false);
   } else {
     TArray<Chaos::TVector<int32, 3>> triangles;
-    fillTriangles(triangles, vertexData, indices, triangleCount);
+    fillTriangles(triangles, indices, triangleCount);
     return MakeShared<Chaos::FTriangleMeshImplicitObject, ESPMode::ThreadSafe>(
         MoveTemp(vertices),
         MoveTemp(triangles),
@@ -5,12 +5,17 @@
 #include "Components/PrimitiveComponent.h"
 #include "Components/SceneComponent.h"
 #include "CoreMinimal.h"
+#include "CesiumTilesetMemoryStatistics.h"
 #include "CustomDepthParameters.h"
 #include "Interfaces/IHttpRequest.h"
 #include <glm/mat4x4.hpp>
 #include <memory>
 #include "CesiumGltfComponent.generated.h"
 
+class CesiumGltfPrimitivePool;
+class CesiumWaterMaskAtlas;
+class UCesiumTileBatchComponent;
+class UMaterialInstanceDynamic;
 class UMaterialInterface;
 class UTexture2D;
 class UStaticMeshComponent;
@@ -18,6 +23,7 @@ struct CreateModelOptions;
 struct CreateNodeOptions;
 struct CreateMeshOptions;
 struct CreatePrimitiveOptions;
+struct FBodyInstance;
 struct LoadModelResult;
 struct LoadNodeResult;
 struct LoadMeshResult;
@@ -27,6 +33,10 @@ struct LoadPrimitiveResult;
 class IPhysXCooking;
 #endif
 
+#if CESIUM_BUILD_NANITE
+class INaniteBuilderModule;
+#endif
+
 namespace CesiumGltf {
 struct Model;
 }
@@ -52,6 +62,11 @@ struct FRasterOverlayTile {
 
   FLinearColor TranslationAndScale{};
   int32 TextureCoordinateID = -1;
+
+  // The names of the parameters of this overlay in materials without layers.
+  FName TextureParameterName{};
+  FName TranslationScaleParameterName{};
+  FName TextureCoordinateIndexParameterName{};
 };
 
 UCLASS()
@@ -62,19 +77,57 @@ public:
   class HalfConstructed {
   public:
     virtual ~HalfConstructed() = default;
+
+    // The key of the converted model, as computed by
+    // CesiumConvertedModel::computeKey, or zero if it wasn't computed.
+    uint64 ConvertedModelKey = 0;
   };
 
   static std::unique_ptr<HalfConstructed> CreateOffGameThread(
       const glm::dmat4x4& Transform,
       const CreateModelOptions& Options);
 
+  /**
+   * Creates the component for a glTF model that was prepared off the game
+   * thread.
+   *
+   * If DeferPrimitiveCreation is true, only the component itself is created
+   * here. The primitive components are created later by calls to
+   * CreatePendingPrimitives, so that the work can be spread over multiple
+   * frames.
+   *
+   * If a Pool is given, primitive components and materials are taken from it
+   * when available instead of being created. The pool must outlive this
+   * component's pending primitives.
+   *
+   * The primitives get the collision object type and responses of the given
+   * BodyInstance.
+   *
+   * If a WaterMaskAtlas is given, the water masks that were kept for it by
+   * the packWaterMasks option are packed into it. The atlas must outlive this
+   * component's pending primitives, and the masks must be released from it
+   * with this component as the owner.
+   *
+   * If a TileBatch is given, the primitives that it can draw are drawn by it
+   * rather than by scene proxies of their own. It must outlive this
+   * component's pending primitives.
+   *
+   * If SupportRayTracing is false, no ray tracing geometry is built for the
+   * primitives, and they are never visible in ray tracing.
+   */
   static UCesiumGltfComponent* CreateOnGameThread(
       AActor* ParentActor,
       std::unique_ptr<HalfConstructed> HalfConstructed,
       const glm::dmat4x4& CesiumToUnrealTransform,
       UMaterialInterface* BaseMaterial,
       UMaterialInterface* BaseWaterMaterial,
-      FCustomDepthParameters CustomDepthParameters);
+      FCustomDepthParameters CustomDepthParameters,
+      const FBodyInstance& BodyInstance,
+      bool DeferPrimitiveCreation = false,
+      CesiumGltfPrimitivePool* Pool = nullptr,
+      CesiumWaterMaskAtlas* WaterMaskAtlas = nullptr,
+      UCesiumTileBatchComponent* TileBatch = nullptr,
+      bool SupportRayTracing = true);
 
   UCesiumGltfComponent();
   virtual ~UCesiumGltfComponent();
@@ -88,6 +141,26 @@ public:
   UPROPERTY(EditAnywhere, Category = "Rendering")
   FCustomDepthParameters CustomDepthParameters;
 
+  /**
+   * The collision object type of this component's primitives, including the
+   * ones that are created later.
+   */
+  TEnumAsByte<ECollisionChannel> CollisionObjectType =
+      ECollisionChannel::ECC_WorldStatic;
+
+  /**
+   * The collision responses of this component's primitives, including the
+   * ones that are created later.
+   */
+  FCollisionResponseContainer CollisionResponses;
+
+  /**
+   * The key of the converted model of this component, from its
+   * HalfConstructed, so that it can be found in the warm-start snapshot of
+   * the tileset. Zero if the key wasn't computed.
+   */
+  uint64 ConvertedModelKey = 0;
+
   void UpdateTransformFromCesium(const glm::dmat4& CesiumToUnrealTransform);
 
   void AttachRasterTile(
@@ -106,7 +179,245 @@ public:
   UFUNCTION(BlueprintCallable, Category = "Collision")
   virtual void SetCollisionEnabled(ECollisionEnabled::Type NewType);
 
+  /**
+   * Sets the collision object type and responses of all of this component's
+   * primitives to the ones of the given BodyInstance.
+   */
+  void SetCollisionSettings(const FBodyInstance& BodyInstance);
+
+  /**
+   * Whether the material instances of a model created with one pair of base
+   * materials can be moved to another pair by UpdateMaterials, because the
+   * new materials have the same layers as the old ones. If not, the model has
+   * to be created again for the new materials to be used.
+   *
+   * A null material stands for the default one, as in CreateOnGameThread.
+   */
+  static bool CanUpdateMaterials(
+      UMaterialInterface* OldBaseMaterial,
+      UMaterialInterface* OldBaseWaterMaterial,
+      UMaterialInterface* NewBaseMaterial,
+      UMaterialInterface* NewBaseWaterMaterial);
+
+  /**
+   * Changes the base materials of this model, including for the primitives
+   * that are created later. Each material instance is replaced with one
+   * parented to the new base material, with the same parameters, so the glTF
+   * textures, water mask and raster overlays of the primitives are kept. The
+   * new materials must pass CanUpdateMaterials.
+   *
+   * A null material stands for the default one, as in CreateOnGameThread.
+   */
+  void UpdateMaterials(
+      UMaterialInterface* pBaseMaterial,
+      UMaterialInterface* pBaseWaterMaterial);
+
+  /**
+   * Sets the custom depth parameters of all of this component's primitives,
+   * including the ones that are created later.
+   */
+  void SetCustomDepthParameters(const FCustomDepthParameters& Parameters);
+
+  /**
+   * Shows or hides this tile, along with its collision.
+   *
+   * This is a cheaper equivalent of calling SetVisibility with propagation
+   * and then SetCollisionEnabled, for the many tiles that are shown and
+   * hidden each frame. The visibility of each primitive is set directly, and
+   * collision is only toggled for the primitives that have collision
+   * geometry.
+   */
+  void SetTileVisibility(bool Visible);
+
+  /**
+   * Sets whether the primitives of this tile cast shadows, including the ones
+   * that are created later. Nothing is done if this is already the case.
+   */
+  void SetTileCastShadow(bool CastShadow);
+
+  /**
+   * Whether the primitives of this tile cast shadows.
+   */
+  bool GetTileCastShadow() const { return this->_castShadow; }
+
+  /**
+   * Sets the maximum draw distance of the primitives of this tile, in Unreal
+   * units, including the ones that are created later. A distance of 0 means
+   * no limit. Nothing is done if the distance is within 10% of the current
+   * one, so that the render state of the primitives is not recreated for
+   * small changes.
+   */
+  void SetTileCullDistance(float CullDistance);
+
+  /**
+   * The maximum draw distance of the primitives of this tile, or 0 if there
+   * is no limit.
+   */
+  float GetTileCullDistance() const { return this->_cullDistance; }
+
+  /**
+   * Whether ray tracing geometry is built for the primitives of this tile.
+   */
+  bool GetSupportRayTracing() const { return this->_supportRayTracing; }
+
+  /**
+   * Sets whether the primitives of this tile are visible in ray tracing,
+   * including the ones that are created later. Nothing is done if this is
+   * already the case. Primitives without ray tracing geometry are never
+   * visible in ray tracing.
+   */
+  void SetTileVisibleInRayTracing(bool VisibleInRayTracing);
+
+  /**
+   * Whether the primitives of this tile are visible in ray tracing. They are
+   * not until SetTileVisibleInRayTracing is called.
+   */
+  bool GetTileVisibleInRayTracing() const {
+    return this->_visibleInRayTracing;
+  }
+
+  /**
+   * The tile batch that draws the primitives of this tile, or nullptr if
+   * they are drawn by their own scene proxies.
+   */
+  UCesiumTileBatchComponent* GetTileBatch() const {
+    return this->_pTileBatch;
+  }
+
+  /**
+   * Whether this component still has primitives that have not been created
+   * yet, because it was created with DeferPrimitiveCreation.
+   */
+  bool HasPendingPrimitives() const { return this->_pPending != nullptr; }
+
+  /**
+   * Creates pending primitive components until all of them are created or
+   * until the given time, as returned by FPlatformTime::Seconds, is reached.
+   * At least one primitive is created on each call, so that progress is
+   * guaranteed even with a tiny time budget.
+   *
+   * @param CesiumToUnrealTransform The current transformation from the Cesium
+   * world to the Unreal Engine world.
+   * @param EndTimeSeconds The time at which to stop creating primitives.
+   * @return True if there are no more pending primitives.
+   */
+  bool CreatePendingPrimitives(
+      const glm::dmat4x4& CesiumToUnrealTransform,
+      double EndTimeSeconds);
+
+  /**
+   * Cooks the deferred collision meshes of the primitives that are within the
+   * given distance of any of the given locations.
+   *
+   * The meshes are cooked on a worker thread, and each one is added to its
+   * primitive on the game thread once it is done. Primitives that already
+   * have their collision mesh are not affected.
+   *
+   * @param Sources The Unreal world locations of the collision sources, each
+   * with the distance, in Unreal units, from it within which collision meshes
+   * are cooked.
+   */
+  void CookDeferredCollision(const TArray<FSphere>& Sources);
+
+  /**
+   * Builds the mesh distance fields of the primitives that are within the
+   * given distance of any of the given locations, from their geometry query
+   * hierarchies. See CesiumDistanceField.
+   *
+   * The distance fields are built on a worker thread, and each one is given
+   * to the static mesh of its primitive on the game thread once it is done.
+   * Each primitive is only built once.
+   *
+   * @param Sources The Unreal world locations of the cameras, each with the
+   * distance, in Unreal units, from it within which distance fields are
+   * built.
+   * @param MaximumBuilds The most distance fields to start building.
+   * @param Resolution The number of voxels along the longest side of each
+   * distance field.
+   * @return The number of distance fields that were started.
+   */
+  int32 BuildDistanceFields(
+      const TArray<FSphere>& Sources,
+      int32 MaximumBuilds,
+      int32 Resolution);
+
+  /**
+   * Gets the memory used by the Unreal Engine objects created for this model,
+   * excluding the raster overlay textures attached to it.
+   */
+  const FCesiumTilesetMemoryStatistics& GetMemoryUsage() const {
+    return this->_memoryUsage;
+  }
+
+  /**
+   * Adds to the memory used by this model, and to the Cesium stats. The usage
+   * is removed from the stats again when this component is destroyed.
+   */
+  void AddMemoryUsage(const FCesiumTilesetMemoryStatistics& Usage);
+
+  /**
+   * Gets the material instance shared by the primitives of this model whose
+   * materials have the given key, or nullptr if there is none yet.
+   */
+  UMaterialInstanceDynamic* FindSharedMaterial(const FString& Key) const;
+
+  /**
+   * Makes the given material instance, which is owned by one of the
+   * primitives of this model, available to the other primitives whose
+   * materials have the given key.
+   */
+  void
+  AddSharedMaterial(const FString& Key, UMaterialInstanceDynamic* pMaterial);
+
+  /**
+   * Adds a glTF texture of this model, which was loaded as streamable, to the
+   * textures streamed by UpdateTextureStreaming.
+   */
+  void AddStreamedTexture(UTexture2D* pTexture);
+
+  /**
+   * Streams the mips of the streamable glTF textures of this model, so that
+   * only those needed at the given size on screen are resident.
+   *
+   * @param ScreenSize The size of this model on screen, in pixels, or 0 if it
+   * is not rendered.
+   */
+  void UpdateTextureStreaming(float ScreenSize);
+
+  virtual void BeginDestroy() override;
+
 private:
   UPROPERTY()
   UTexture2D* Transparent1x1;
+
+  /**
+   * The raster overlay tiles currently attached to this component, so that
+   * they can also be applied to primitives that are created later.
+   */
+  UPROPERTY()
+  TArray<FRasterOverlayTile> _overlayTiles;
+
+  /**
+   * The material instances that are shared between primitives, by the keys of
+   * their materials.
+   */
+  UPROPERTY()
+  TMap<FString, UMaterialInstanceDynamic*> _sharedMaterials;
+
+  /**
+   * The streamable glTF textures of this model.
+   */
+  UPROPERTY()
+  TArray<UTexture2D*> _streamedTextures;
+
+  std::unique_ptr<HalfConstructed> _pPending;
+  CesiumGltfPrimitivePool* _pPool = nullptr;
+  CesiumWaterMaskAtlas* _pWaterMaskAtlas = nullptr;
+  UCesiumTileBatchComponent* _pTileBatch = nullptr;
+  bool _cookingDeferredCollision = false;
+  bool _castShadow = true;
+  float _cullDistance = 0.0f;
+  bool _supportRayTracing = true;
+  bool _visibleInRayTracing = false;
+  FCesiumTilesetMemoryStatistics _memoryUsage;
 };
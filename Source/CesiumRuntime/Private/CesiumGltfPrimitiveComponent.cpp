@@ -1,12 +1,35 @@
 // Copyright 2020-2021 CesiumGS, Inc. and Contributors
 
 #include "CesiumGltfPrimitiveComponent.h"
+#include "CesiumGltf/ExtensionMeshPrimitiveExtFeatureMetadata.h"
+#include "CesiumGltf/ExtensionModelExtFeatureMetadata.h"
+#include "CesiumHeightfieldSceneProxy.h"
 #include "CesiumLifetime.h"
 #include "CesiumMaterialUserData.h"
+#include "CesiumPointCloudSceneProxy.h"
+#include "CesiumTileBatchComponent.h"
 #include "Engine/StaticMesh.h"
 #include "Materials/MaterialInstanceDynamic.h"
 #include "PhysicsEngine/BodySetup.h"
 
+namespace {
+
+void updateTransformFromCesium(
+    USceneComponent* pComponent,
+    const glm::dmat4& transform) {
+  pComponent->SetUsingAbsoluteLocation(true);
+  pComponent->SetUsingAbsoluteRotation(true);
+  pComponent->SetUsingAbsoluteScale(true);
+
+  pComponent->SetRelativeTransform(FTransform(FMatrix(
+      FVector(transform[0].x, transform[0].y, transform[0].z),
+      FVector(transform[1].x, transform[1].y, transform[1].z),
+      FVector(transform[2].x, transform[2].y, transform[2].z),
+      FVector(transform[3].x, transform[3].y, transform[3].z))));
+}
+
+} // namespace
+
 // Sets default values for this component's properties
 UCesiumGltfPrimitiveComponent::UCesiumGltfPrimitiveComponent() {
   // Set this component to be initialized when the game starts, and to be ticked
@@ -21,18 +44,41 @@ UCesiumGltfPrimitiveComponent::~UCesiumGltfPrimitiveComponent() {}
 
 void UCesiumGltfPrimitiveComponent::UpdateTransformFromCesium(
     const glm::dmat4& CesiumToUnrealTransform) {
-  this->SetUsingAbsoluteLocation(true);
-  this->SetUsingAbsoluteRotation(true);
-  this->SetUsingAbsoluteScale(true);
+  updateTransformFromCesium(
+      this,
+      CesiumToUnrealTransform * this->HighPrecisionNodeTransform);
+}
 
-  const glm::dmat4x4& transform =
-      CesiumToUnrealTransform * this->HighPrecisionNodeTransform;
+const FCesiumMetadataPrimitive&
+UCesiumGltfPrimitiveComponent::GetMetadata() const {
+  if (this->_metadata) {
+    return this->_metadata.GetValue();
+  }
 
-  this->SetRelativeTransform(FTransform(FMatrix(
-      FVector(transform[0].x, transform[0].y, transform[0].z),
-      FVector(transform[1].x, transform[1].y, transform[1].z),
-      FVector(transform[2].x, transform[2].y, transform[2].z),
-      FVector(transform[3].x, transform[3].y, transform[3].z))));
+  const CesiumGltf::ExtensionModelExtFeatureMetadata* pMetadata =
+      this->pModel ? this->pModel->getExtension<
+                         CesiumGltf::ExtensionModelExtFeatureMetadata>()
+                   : nullptr;
+  const CesiumGltf::ExtensionMeshPrimitiveExtFeatureMetadata*
+      pPrimitiveMetadata =
+          this->pMeshPrimitive
+              ? this->pMeshPrimitive->getExtension<
+                    CesiumGltf::ExtensionMeshPrimitiveExtFeatureMetadata>()
+              : nullptr;
+  if (pMetadata && pPrimitiveMetadata) {
+    this->_metadata.Emplace(
+        *this->pModel,
+        *this->pMeshPrimitive,
+        *pMetadata,
+        *pPrimitiveMetadata);
+  } else {
+    this->_metadata.Emplace();
+  }
+  return this->_metadata.GetValue();
+}
+
+void UCesiumGltfPrimitiveComponent::ResetMetadata() {
+  this->_metadata.Reset();
 }
 
 namespace {
@@ -63,6 +109,8 @@ void destroyGltfParameterValues(
       index);
   destroyMaterialTexture(pMaterial, "normalTexture", assocation, index);
   destroyMaterialTexture(pMaterial, "occlusionTexture", assocation, index);
+  destroyMaterialTexture(pMaterial, "heightfieldPositions", assocation, index);
+  destroyMaterialTexture(pMaterial, "heightfieldNormals", assocation, index);
 }
 
 void destroyWaterParameterValues(
@@ -72,13 +120,11 @@ void destroyWaterParameterValues(
   destroyMaterialTexture(pMaterial, "WaterMask", assocation, index);
 }
 
-} // namespace
-
-void UCesiumGltfPrimitiveComponent::BeginDestroy() {
+void destroyGltfTextures(UStaticMeshComponent* pComponent) {
   // This should mirror the logic in loadPrimitiveGameThreadPart in
   // CesiumGltfComponent.cpp
   UMaterialInstanceDynamic* pMaterial =
-      Cast<UMaterialInstanceDynamic>(this->GetMaterial(0));
+      Cast<UMaterialInstanceDynamic>(pComponent->GetMaterial(0));
   if (pMaterial) {
 
     destroyGltfParameterValues(
@@ -112,11 +158,27 @@ void UCesiumGltfPrimitiveComponent::BeginDestroy() {
             waterIndex);
       }
     }
+  }
+}
+
+/**
+ * Destroys the material, glTF textures, static mesh, and body setup of a glTF
+ * primitive, leaving the material and textures alone if they are shared.
+ */
+void destroyPrimitiveResources(
+    UStaticMeshComponent* pComponent,
+    bool sharesMaterial) {
+  if (!sharesMaterial) {
+    destroyGltfTextures(pComponent);
 
-    CesiumLifetime::destroy(pMaterial);
+    UMaterialInstanceDynamic* pMaterial =
+        Cast<UMaterialInstanceDynamic>(pComponent->GetMaterial(0));
+    if (pMaterial) {
+      CesiumLifetime::destroy(pMaterial);
+    }
   }
 
-  UStaticMesh* pMesh = this->GetStaticMesh();
+  UStaticMesh* pMesh = pComponent->GetStaticMesh();
   if (pMesh) {
 #if ENGINE_MAJOR_VERSION == 4 && ENGINE_MINOR_VERSION < 27
     UBodySetup* pBodySetup = pMesh->BodySetup;
@@ -129,6 +191,104 @@ void UCesiumGltfPrimitiveComponent::BeginDestroy() {
 
     CesiumLifetime::destroy(pMesh);
   }
+}
+
+} // namespace
+
+void UCesiumGltfPrimitiveComponent::DestroyGltfTextures() {
+  if (!this->SharesMaterial) {
+    destroyGltfTextures(this);
+  }
+}
+
+void UCesiumGltfPrimitiveComponent::BeginDestroy() {
+  destroyPrimitiveResources(this, this->SharesMaterial);
+  Super::BeginDestroy();
+}
+
+FPrimitiveSceneProxy* UCesiumGltfPrimitiveComponent::CreateSceneProxy() {
+  if (this->IsPointCloud) {
+    return new FCesiumPointCloudSceneProxy(this);
+  }
+  if (this->IsHeightfield) {
+    return new FCesiumHeightfieldSceneProxy(this);
+  }
+  return Super::CreateSceneProxy();
+}
+
+FBoxSphereBounds UCesiumGltfPrimitiveComponent::CalcBounds(
+    const FTransform& LocalToWorld) const {
+  // Heightfields have no render data, so their static mesh has no bounds.
+  if (this->IsHeightfield && this->HeightfieldBounds.IsValid) {
+    return FBoxSphereBounds(this->HeightfieldBounds).TransformBy(LocalToWorld);
+  }
+  return Super::CalcBounds(LocalToWorld);
+}
+
+void UCesiumGltfPrimitiveComponent::SetMaterial(
+    int32 ElementIndex,
+    UMaterialInterface* Material) {
+  Super::SetMaterial(ElementIndex, Material);
+  this->UpdateTileBatch();
+}
+
+void UCesiumGltfPrimitiveComponent::UpdateTileBatch() {
+  UCesiumTileBatchComponent* pTileBatch = this->TileBatch.Get();
+  if (this->_batched && pTileBatch && this->IsRegistered()) {
+    pTileBatch->AddPrimitive(this);
+  }
+}
+
+void UCesiumGltfPrimitiveComponent::OnRegister() {
+  // This is decided before the render state would be created.
+  this->_batched = this->TileBatch.IsValid() &&
+                   UCesiumTileBatchComponent::CanBatch(this);
+  Super::OnRegister();
+  this->UpdateTileBatch();
+}
+
+void UCesiumGltfPrimitiveComponent::OnUnregister() {
+  UCesiumTileBatchComponent* pTileBatch = this->TileBatch.Get();
+  if (this->_batched && pTileBatch) {
+    pTileBatch->RemovePrimitive(this);
+  }
+  this->_batched = false;
+  Super::OnUnregister();
+}
+
+bool UCesiumGltfPrimitiveComponent::ShouldCreateRenderState() const {
+  return !this->_batched && Super::ShouldCreateRenderState();
+}
+
+void UCesiumGltfPrimitiveComponent::OnVisibilityChanged() {
+  Super::OnVisibilityChanged();
+  UCesiumTileBatchComponent* pTileBatch = this->TileBatch.Get();
+  if (this->_batched && pTileBatch) {
+    pTileBatch->UpdatePrimitiveVisibility(this);
+  }
+}
+
+void UCesiumGltfPrimitiveComponent::OnUpdateTransform(
+    EUpdateTransformFlags UpdateTransformFlags,
+    ETeleportType Teleport) {
+  Super::OnUpdateTransform(UpdateTransformFlags, Teleport);
+  this->UpdateTileBatch();
+}
+
+UCesiumGltfInstancedComponent::UCesiumGltfInstancedComponent() {
+  PrimaryComponentTick.bCanEverTick = false;
+}
+
+UCesiumGltfInstancedComponent::~UCesiumGltfInstancedComponent() {}
+
+void UCesiumGltfInstancedComponent::UpdateTransformFromCesium(
+    const glm::dmat4& CesiumToUnrealTransform) {
+  updateTransformFromCesium(
+      this,
+      CesiumToUnrealTransform * this->HighPrecisionNodeTransform);
+}
 
+void UCesiumGltfInstancedComponent::BeginDestroy() {
+  destroyPrimitiveResources(this, this->SharesMaterial);
   Super::BeginDestroy();
 }
@@ -6,11 +6,26 @@
 #include "CesiumGltf/Model.h"
 #include "CesiumMetadataPrimitive.h"
 #include "CesiumRasterOverlays.h"
+#include "Components/InstancedStaticMeshComponent.h"
 #include "Components/StaticMeshComponent.h"
 #include "CoreMinimal.h"
 #include <glm/mat4x4.hpp>
+#include <memory>
 #include "CesiumGltfPrimitiveComponent.generated.h"
 
+class CesiumTriangleBVH;
+class UCesiumTileBatchComponent;
+struct CesiumFarFieldGeometry;
+struct DeferredCollisionMesh;
+
+/**
+ * The bounds of a feature of a primitive, in the coordinates of the primitive.
+ */
+struct CesiumPrimitiveFeatureBounds {
+  int32 featureID;
+  FBox bounds;
+};
+
 UCLASS()
 class UCesiumGltfPrimitiveComponent : public UStaticMeshComponent {
   GENERATED_BODY()
@@ -20,7 +35,51 @@ public:
   UCesiumGltfPrimitiveComponent();
   virtual ~UCesiumGltfPrimitiveComponent();
 
-  FCesiumMetadataPrimitive Metadata;
+  /**
+   * Gets the feature metadata of this primitive. It is created from the glTF
+   * the first time it is needed, rather than when the tile is loaded, because
+   * the metadata of most primitives is never queried. Must be called from the
+   * game thread.
+   */
+  const FCesiumMetadataPrimitive& GetMetadata() const;
+
+  /**
+   * Discards the feature metadata of this primitive, so that it is created
+   * again from its current glTF when it is next needed.
+   */
+  void ResetMetadata();
+
+  /**
+   * The feature ID, in the first feature table of the metadata, of each face
+   * of this primitive's collision mesh, which is the face index of a hit. It
+   * is empty if there is no feature table or collision mesh.
+   */
+  TArray<int32> FaceFeatureIDs;
+
+  /**
+   * The bounds of each feature of this primitive, in the first feature table
+   * of the metadata, if the feature index of the tileset is enabled.
+   */
+  TArray<CesiumPrimitiveFeatureBounds> FeatureBounds;
+
+  /**
+   * Whether this primitive is made of points, which are drawn as a point list
+   * from the vertex buffers of its static mesh instead of as triangles.
+   */
+  bool IsPointCloud = false;
+
+  /**
+   * Whether this primitive is a terrain tile that is drawn as a heightfield,
+   * by displacing a shared grid with the heightfieldPositions texture of its
+   * material, instead of from the render data of its static mesh.
+   */
+  bool IsHeightfield = false;
+
+  /**
+   * The bounds of the heightfield, in the coordinates of this primitive, if
+   * it is one.
+   */
+  FBox HeightfieldBounds{ForceInit};
 
   const CesiumGltf::Model* pModel;
 
@@ -33,6 +92,137 @@ public:
 
   OverlayTextureCoordinateIDMap overlayTextureCoordinateIDToUVIndex;
 
+  /**
+   * Whether this component's material instance, and so its glTF textures, are
+   * owned by another primitive of the same model that uses the same material.
+   * If so, they are left alone when this component is pooled or destroyed.
+   */
+  bool SharesMaterial = false;
+
+  /**
+   * Whether this component's material instance is parented to the water
+   * material of the model, rather than to its regular material, so that the
+   * same choice is made when the materials are changed.
+   */
+  bool UsesWaterMaterial = false;
+
+  /**
+   * The geometry of this primitive's collision mesh, if cooking it was
+   * deferred and it has not been cooked yet.
+   */
+  std::shared_ptr<DeferredCollisionMesh> pDeferredCollision;
+
+  /**
+   * The simplified geometry of this primitive, from which the far-field proxy
+   * of its tileset is built, or nullptr if it has none.
+   */
+  std::shared_ptr<const CesiumFarFieldGeometry> pFarFieldGeometry;
+
+  /**
+   * The hierarchy over the triangles of this primitive that geometry queries
+   * cast rays against, or nullptr if it has none. Queries in progress share
+   * it, so it outlives the component when they need it to.
+   */
+  std::shared_ptr<const CesiumTriangleBVH> pQueryBVH;
+
+  /**
+   * Whether the mesh distance field of this primitive has been built, or is
+   * being built, from pQueryBVH.
+   */
+  bool DistanceFieldRequested = false;
+
+  /**
+   * The tile batch that draws this primitive instead of a scene proxy of its
+   * own, if its tileset uses batched rendering. It must be set before the
+   * component is registered, and the primitive is only batched if
+   * UCesiumTileBatchComponent::CanBatch allows it.
+   */
+  TWeakObjectPtr<UCesiumTileBatchComponent> TileBatch;
+
+  /**
+   * Sends the current state of this primitive to its tile batch, if it is
+   * drawn by one. This is needed after changes that don't go through the
+   * component's render state, such as SetCastShadow and SetCullDistance.
+   */
+  void UpdateTileBatch();
+
+  /**
+   * Updates this component's transform from a new double-precision
+   * transformation from the Cesium world to the Unreal Engine world, as well as
+   * the current HighPrecisionNodeTransform.
+   *
+   * @param CesiumToUnrealTransform The new transformation.
+   */
+  void UpdateTransformFromCesium(const glm::dmat4& CesiumToUnrealTransform);
+
+  /**
+   * Destroys the glTF textures referenced by this component's material. These
+   * textures are shared by the primitives of the same model, which are always
+   * pooled or destroyed together, and are left alone if this component shares
+   * its material. Raster overlay textures, which are owned by the raster
+   * overlay tiles, are not affected.
+   */
+  void DestroyGltfTextures();
+
+  virtual void BeginDestroy() override;
+
+  virtual FPrimitiveSceneProxy* CreateSceneProxy() override;
+
+  virtual FBoxSphereBounds
+  CalcBounds(const FTransform& LocalToWorld) const override;
+
+  virtual void SetMaterial(int32 ElementIndex, UMaterialInterface* Material)
+      override;
+
+protected:
+  virtual void OnRegister() override;
+  virtual void OnUnregister() override;
+  virtual bool ShouldCreateRenderState() const override;
+  virtual void OnVisibilityChanged() override;
+  virtual void OnUpdateTransform(
+      EUpdateTransformFlags UpdateTransformFlags,
+      ETeleportType Teleport) override;
+
+private:
+  mutable TOptional<FCesiumMetadataPrimitive> _metadata;
+
+  // Whether this primitive is drawn by its tile batch, as of when it was
+  // registered.
+  bool _batched = false;
+};
+
+/**
+ * A glTF primitive whose node is instanced with EXT_mesh_gpu_instancing. All
+ * of its instances are drawn together, and the transform of each instance is
+ * relative to the node. Instanced primitives are not pooled, and don't get
+ * raster overlays or feature metadata.
+ */
+UCLASS()
+class UCesiumGltfInstancedComponent : public UInstancedStaticMeshComponent {
+  GENERATED_BODY()
+
+public:
+  UCesiumGltfInstancedComponent();
+  virtual ~UCesiumGltfInstancedComponent();
+
+  /**
+   * The double-precision transformation matrix for this glTF node.
+   */
+  glm::dmat4x4 HighPrecisionNodeTransform;
+
+  /**
+   * Whether this component's material instance is owned by another primitive
+   * of the same model. See UCesiumGltfPrimitiveComponent::SharesMaterial.
+   */
+  bool SharesMaterial = false;
+
+  /**
+   * Whether this component's material instance is parented to the water
+   * material of the model. See
+   * UCesiumGltfPrimitiveComponent::UsesWaterMaterial.
+   */
+  bool UsesWaterMaterial = false;
+
   /**
    * Updates this component's transform from a new double-precision
    * transformation from the Cesium world to the Unreal Engine world, as well as
@@ -0,0 +1,158 @@
+// Copyright 2020-2021 CesiumGS, Inc. and Contributors
+
+#include "CesiumGltfPrimitivePool.h"
+#include "CesiumGltfPrimitiveComponent.h"
+#include "CesiumLifetime.h"
+#include "Engine/StaticMesh.h"
+#include "Materials/MaterialInstanceDynamic.h"
+#include "PhysicsEngine/BodySetup.h"
+
+namespace {
+
+UBodySetup* getBodySetup(UStaticMesh* pStaticMesh) {
+#if ENGINE_MAJOR_VERSION == 4 && ENGINE_MINOR_VERSION < 27
+  return pStaticMesh->BodySetup;
+#else
+  return pStaticMesh->GetBodySetup();
+#endif
+}
+
+TArray<FStaticMaterial>& getStaticMaterials(UStaticMesh* pStaticMesh) {
+#if ENGINE_MAJOR_VERSION == 4 && ENGINE_MINOR_VERSION < 27
+  return pStaticMesh->StaticMaterials;
+#else
+  return pStaticMesh->GetStaticMaterials();
+#endif
+}
+
+} // namespace
+
+CesiumGltfPrimitivePool::~CesiumGltfPrimitivePool() { this->clear(); }
+
+void CesiumGltfPrimitivePool::clear() {
+  // Pooled objects that were destroyed along with their outer are nulled out
+  // by the garbage collector.
+  for (UCesiumGltfPrimitiveComponent* pPrimitive : this->_primitives) {
+    if (pPrimitive) {
+      pPrimitive->DestroyComponent();
+      CesiumLifetime::destroy(pPrimitive);
+    }
+  }
+
+  for (auto& materialsIt : this->_materials) {
+    for (UMaterialInstanceDynamic* pMaterial : materialsIt.Value) {
+      CesiumLifetime::destroy(pMaterial);
+    }
+  }
+
+  this->_primitives.Empty();
+  this->_materials.Empty();
+}
+
+UCesiumGltfPrimitiveComponent* CesiumGltfPrimitivePool::acquirePrimitive() {
+  this->_primitives.Remove(nullptr);
+
+  for (int32 i = 0; i < this->_primitives.Num(); ++i) {
+    UCesiumGltfPrimitiveComponent* pPrimitive = this->_primitives[i];
+    UStaticMesh* pStaticMesh = pPrimitive->GetStaticMesh();
+
+    // The render thread may still be releasing the previous render data.
+    if (pStaticMesh && !pStaticMesh->IsReadyForFinishDestroy()) {
+      continue;
+    }
+
+    this->_primitives.RemoveAtSwap(i);
+    return pPrimitive;
+  }
+
+  return nullptr;
+}
+
+UMaterialInstanceDynamic*
+CesiumGltfPrimitivePool::acquireMaterial(UMaterialInterface* pParent) {
+  TArray<UMaterialInstanceDynamic*>* pMaterials =
+      this->_materials.Find(pParent);
+  if (!pMaterials) {
+    return nullptr;
+  }
+
+  pMaterials->Remove(nullptr);
+  if (pMaterials->Num() == 0) {
+    return nullptr;
+  }
+
+  UMaterialInstanceDynamic* pMaterial = pMaterials->Pop(false);
+  return pMaterial;
+}
+
+bool CesiumGltfPrimitivePool::releasePrimitive(
+    UCesiumGltfPrimitiveComponent* pPrimitive,
+    int32 maximumSize) {
+  if (!pPrimitive || this->_primitives.Num() >= maximumSize) {
+    return false;
+  }
+
+  UStaticMesh* pStaticMesh = pPrimitive->GetStaticMesh();
+  if (!pStaticMesh) {
+    return false;
+  }
+
+  if (pPrimitive->IsRegistered()) {
+    pPrimitive->UnregisterComponent();
+  }
+  pPrimitive->DetachFromComponent(
+      FDetachmentTransformRules::KeepRelativeTransform);
+
+  pPrimitive->DestroyGltfTextures();
+
+  // A shared material instance is pooled or destroyed along with the
+  // primitive that owns it.
+  UMaterialInstanceDynamic* pMaterial =
+      pPrimitive->SharesMaterial
+          ? nullptr
+          : Cast<UMaterialInstanceDynamic>(pPrimitive->GetMaterial(0));
+  if (pMaterial && pMaterial->Parent) {
+    pMaterial->ClearParameterValues();
+    this->_materials.FindOrAdd(pMaterial->Parent).Add(pMaterial);
+  } else if (pMaterial) {
+    CesiumLifetime::destroy(pMaterial);
+  }
+
+  getStaticMaterials(pStaticMesh).Empty();
+  pStaticMesh->ReleaseResources();
+
+  UBodySetup* pBodySetup = getBodySetup(pStaticMesh);
+  if (pBodySetup) {
+    pBodySetup->ClearPhysicsMeshes();
+  }
+
+  pPrimitive->ResetMetadata();
+  pPrimitive->FaceFeatureIDs.Empty();
+  pPrimitive->FeatureBounds.Empty();
+  pPrimitive->IsPointCloud = false;
+  pPrimitive->IsHeightfield = false;
+  pPrimitive->HeightfieldBounds = FBox(ForceInit);
+  pPrimitive->pModel = nullptr;
+  pPrimitive->pMeshPrimitive = nullptr;
+  pPrimitive->pDeferredCollision.reset();
+  pPrimitive->pFarFieldGeometry.reset();
+  pPrimitive->pQueryBVH.reset();
+  pPrimitive->DistanceFieldRequested = false;
+  pPrimitive->SharesMaterial = false;
+  pPrimitive->UsesWaterMaterial = false;
+
+  this->_primitives.Add(pPrimitive);
+  return true;
+}
+
+void CesiumGltfPrimitivePool::AddReferencedObjects(
+    FReferenceCollector& Collector) {
+  Collector.AddReferencedObjects(this->_primitives);
+  for (auto& materialsIt : this->_materials) {
+    Collector.AddReferencedObjects(materialsIt.Value);
+  }
+}
+
+FString CesiumGltfPrimitivePool::GetReferencerName() const {
+  return TEXT("CesiumGltfPrimitivePool");
+}
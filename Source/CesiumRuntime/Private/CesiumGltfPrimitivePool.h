@@ -0,0 +1,78 @@
+// Copyright 2020-2021 CesiumGS, Inc. and Contributors
+
+#pragma once
+
+#include "Containers/Array.h"
+#include "Containers/Map.h"
+#include "UObject/GCObject.h"
+
+class UCesiumGltfPrimitiveComponent;
+class UMaterialInstanceDynamic;
+class UMaterialInterface;
+
+/**
+ * @brief A pool of primitive components, along with their static meshes and
+ * body setups, and of dynamic material instances, so that they can be reused
+ * by newly-loaded tiles instead of being destroyed when a tile is unloaded and
+ * recreated for the next one.
+ *
+ * Reusing these objects avoids a lot of UObject churn, which in turn reduces
+ * the work of the garbage collector. The pool keeps its objects from being
+ * garbage collected while they are in it.
+ */
+class CesiumGltfPrimitivePool : public FGCObject {
+public:
+  CesiumGltfPrimitivePool() = default;
+  ~CesiumGltfPrimitivePool();
+
+  CesiumGltfPrimitivePool(const CesiumGltfPrimitivePool&) = delete;
+  CesiumGltfPrimitivePool& operator=(const CesiumGltfPrimitivePool&) = delete;
+
+  /**
+   * @brief Takes a primitive component out of the pool.
+   *
+   * The returned component is unregistered and detached, and its static mesh
+   * has no render data or materials. Its body setup has no physics meshes.
+   *
+   * @return The component, or nullptr if no pooled component is ready to be
+   * reused.
+   */
+  UCesiumGltfPrimitiveComponent* acquirePrimitive();
+
+  /**
+   * @brief Takes a dynamic material instance with the given parent out of the
+   * pool.
+   *
+   * @param pParent The parent material.
+   * @return The material instance, with all parameters cleared, or nullptr if
+   * there is no pooled material instance with this parent.
+   */
+  UMaterialInstanceDynamic* acquireMaterial(UMaterialInterface* pParent);
+
+  /**
+   * @brief Puts a primitive component, and its material, into the pool.
+   *
+   * The component is unregistered and detached, its glTF textures are
+   * destroyed, and the render resources of its static mesh are released.
+   *
+   * @param pPrimitive The primitive component.
+   * @param maximumSize The maximum number of primitive components in the pool.
+   * @return True if the component was added to the pool; false if the pool is
+   * full, in which case the caller should destroy the component.
+   */
+  bool releasePrimitive(
+      UCesiumGltfPrimitiveComponent* pPrimitive,
+      int32 maximumSize);
+
+  /**
+   * @brief Destroys all the pooled primitive components and materials.
+   */
+  void clear();
+
+  virtual void AddReferencedObjects(FReferenceCollector& Collector) override;
+  virtual FString GetReferencerName() const override;
+
+private:
+  TArray<UCesiumGltfPrimitiveComponent*> _primitives;
+  TMap<UMaterialInterface*, TArray<UMaterialInstanceDynamic*>> _materials;
+};
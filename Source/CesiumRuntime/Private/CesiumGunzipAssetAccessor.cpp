@@ -0,0 +1,201 @@
+// Copyright 2020-2021 CesiumGS, Inc. and Contributors
+
+#include "CesiumGunzipAssetAccessor.h"
+#include "CesiumAsync/IAssetRequest.h"
+#include "CesiumAsync/IAssetResponse.h"
+#include "CesiumUtility/Tracing.h"
+#include <algorithm>
+#include <limits>
+
+THIRD_PARTY_INCLUDES_START
+#include "zlib.h"
+THIRD_PARTY_INCLUDES_END
+
+namespace {
+
+bool isGzipped(gsl::span<const std::byte> data) {
+  // The magic number, followed by the deflate compression method.
+  return data.size() >= 18 && data[0] == std::byte(0x1f) &&
+         data[1] == std::byte(0x8b) && data[2] == std::byte(0x08);
+}
+
+/**
+ * Decompresses gzip data, which may hold several members one after another.
+ * Returns false if the data is truncated or isn't valid.
+ */
+bool gunzip(gsl::span<const std::byte> data, std::vector<std::byte>& result) {
+  CESIUM_TRACE("gunzip");
+
+  if (data.size() > std::numeric_limits<uInt>::max()) {
+    return false;
+  }
+
+  z_stream stream{};
+  // 16 added to the window bits expects a gzip header and trailer.
+  if (inflateInit2(&stream, 16 + MAX_WBITS) != Z_OK) {
+    return false;
+  }
+
+  stream.next_in =
+      reinterpret_cast<Bytef*>(const_cast<std::byte*>(data.data()));
+  stream.avail_in = uInt(data.size());
+
+  // Tiles usually compress to between a quarter and a half of their size.
+  result.resize(data.size() * 4);
+
+  int status = Z_OK;
+  while (status != Z_STREAM_END || stream.avail_in > 0) {
+    if (status == Z_STREAM_END) {
+      // Another member follows.
+      if (inflateReset(&stream) != Z_OK) {
+        break;
+      }
+    }
+
+    if (stream.total_out == result.size()) {
+      result.resize(result.size() * 2);
+    }
+    stream.next_out =
+        reinterpret_cast<Bytef*>(result.data() + stream.total_out);
+    stream.avail_out = uInt(std::min<size_t>(
+        result.size() - stream.total_out,
+        std::numeric_limits<uInt>::max()));
+
+    status = inflate(&stream, Z_NO_FLUSH);
+    if (status != Z_OK && status != Z_STREAM_END) {
+      break;
+    }
+  }
+
+  const bool succeeded = status == Z_STREAM_END && stream.avail_in == 0;
+  result.resize(stream.total_out);
+  inflateEnd(&stream);
+  return succeeded;
+}
+
+class GunzipAssetResponse : public CesiumAsync::IAssetResponse {
+public:
+  GunzipAssetResponse(
+      const CesiumAsync::IAssetResponse& response,
+      std::vector<std::byte>&& data)
+      : _response(response),
+        _headers(response.headers()),
+        _data(std::move(data)) {
+    // The data is no longer encoded.
+    this->_headers.erase("Content-Encoding");
+  }
+
+  virtual uint16_t statusCode() const override {
+    return this->_response.statusCode();
+  }
+
+  virtual std::string contentType() const override {
+    return this->_response.contentType();
+  }
+
+  virtual const CesiumAsync::HttpHeaders& headers() const override {
+    return this->_headers;
+  }
+
+  virtual gsl::span<const std::byte> data() const override {
+    return gsl::span<const std::byte>(this->_data);
+  }
+
+private:
+  const CesiumAsync::IAssetResponse& _response;
+  CesiumAsync::HttpHeaders _headers;
+  std::vector<std::byte> _data;
+};
+
+class GunzipAssetRequest : public CesiumAsync::IAssetRequest {
+public:
+  GunzipAssetRequest(
+      std::shared_ptr<CesiumAsync::IAssetRequest>&& pRequest,
+      std::vector<std::byte>&& data)
+      : _pRequest(std::move(pRequest)),
+        _response(*this->_pRequest->response(), std::move(data)) {}
+
+  virtual const std::string& method() const override {
+    return this->_pRequest->method();
+  }
+
+  virtual const std::string& url() const override {
+    return this->_pRequest->url();
+  }
+
+  virtual const CesiumAsync::HttpHeaders& headers() const override {
+    return this->_pRequest->headers();
+  }
+
+  virtual const CesiumAsync::IAssetResponse* response() const override {
+    return &this->_response;
+  }
+
+private:
+  // Keeps the original response, which the decompressed one refers to,
+  // alive.
+  std::shared_ptr<CesiumAsync::IAssetRequest> _pRequest;
+  GunzipAssetResponse _response;
+};
+
+} // namespace
+
+CesiumGunzipAssetAccessor::CesiumGunzipAssetAccessor(
+    const std::shared_ptr<CesiumAsync::IAssetAccessor>& pAccessor)
+    : _pAccessor(pAccessor) {}
+
+CesiumAsync::Future<std::shared_ptr<CesiumAsync::IAssetRequest>>
+CesiumGunzipAssetAccessor::get(
+    const CesiumAsync::AsyncSystem& asyncSystem,
+    const std::string& url,
+    const std::vector<CesiumAsync::IAssetAccessor::THeader>& headers) {
+  return decompress(
+      asyncSystem,
+      this->_pAccessor->get(asyncSystem, url, headers));
+}
+
+CesiumAsync::Future<std::shared_ptr<CesiumAsync::IAssetRequest>>
+CesiumGunzipAssetAccessor::request(
+    const CesiumAsync::AsyncSystem& asyncSystem,
+    const std::string& verb,
+    const std::string& url,
+    const std::vector<CesiumAsync::IAssetAccessor::THeader>& headers,
+    const gsl::span<const std::byte>& contentPayload) {
+  return decompress(
+      asyncSystem,
+      this->_pAccessor
+          ->request(asyncSystem, verb, url, headers, contentPayload));
+}
+
+void CesiumGunzipAssetAccessor::tick() noexcept { this->_pAccessor->tick(); }
+
+/*static*/ CesiumAsync::Future<std::shared_ptr<CesiumAsync::IAssetRequest>>
+CesiumGunzipAssetAccessor::decompress(
+    const CesiumAsync::AsyncSystem& asyncSystem,
+    CesiumAsync::Future<std::shared_ptr<CesiumAsync::IAssetRequest>>&&
+        future) {
+  return std::move(future).thenImmediately(
+      [asyncSystem](std::shared_ptr<CesiumAsync::IAssetRequest>&& pRequest)
+          -> CesiumAsync::Future<std::shared_ptr<CesiumAsync::IAssetRequest>> {
+        const CesiumAsync::IAssetResponse* pResponse =
+            pRequest ? pRequest->response() : nullptr;
+        if (!pResponse || !isGzipped(pResponse->data())) {
+          return asyncSystem.createResolvedFuture(std::move(pRequest));
+        }
+
+        // The response may have been completed on the game thread or the
+        // HTTP thread, neither of which should be held up by decompressing
+        // it.
+        return asyncSystem.runInWorkerThread(
+            [pRequest = std::move(pRequest)]() mutable
+            -> std::shared_ptr<CesiumAsync::IAssetRequest> {
+              std::vector<std::byte> data;
+              if (!gunzip(pRequest->response()->data(), data)) {
+                return std::move(pRequest);
+              }
+              return std::make_shared<GunzipAssetRequest>(
+                  std::move(pRequest),
+                  std::move(data));
+            });
+      });
+}
@@ -0,0 +1,54 @@
+// Copyright 2020-2021 CesiumGS, Inc. and Contributors
+
+#pragma once
+
+#include "CesiumAsync/AsyncSystem.h"
+#include "CesiumAsync/IAssetAccessor.h"
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * @brief An asset accessor that decompresses gzip-encoded responses on a
+ * worker thread.
+ *
+ * It sits between the cache and the code that reads the responses, so both
+ * the network and the cache hand it responses exactly as the server sent
+ * them. Compressed ones therefore stay compressed on disk. A response counts
+ * as compressed when its data starts with the gzip magic number. This covers
+ * servers that set a Content-Encoding header and servers that serve
+ * pre-compressed files without one. It also avoids decompressing twice when
+ * the HTTP backend has already done it. Responses that aren't compressed, or
+ * that don't decompress, are passed through unchanged.
+ */
+class CesiumGunzipAssetAccessor : public CesiumAsync::IAssetAccessor {
+public:
+  CesiumGunzipAssetAccessor(
+      const std::shared_ptr<CesiumAsync::IAssetAccessor>& pAccessor);
+
+  virtual CesiumAsync::Future<std::shared_ptr<CesiumAsync::IAssetRequest>>
+  get(const CesiumAsync::AsyncSystem& asyncSystem,
+      const std::string& url,
+      const std::vector<CesiumAsync::IAssetAccessor::THeader>& headers)
+      override;
+
+  virtual CesiumAsync::Future<std::shared_ptr<CesiumAsync::IAssetRequest>>
+  request(
+      const CesiumAsync::AsyncSystem& asyncSystem,
+      const std::string& verb,
+      const std::string& url,
+      const std::vector<CesiumAsync::IAssetAccessor::THeader>& headers,
+      const gsl::span<const std::byte>& contentPayload) override;
+
+  virtual void tick() noexcept override;
+
+private:
+  static CesiumAsync::Future<std::shared_ptr<CesiumAsync::IAssetRequest>>
+  decompress(
+      const CesiumAsync::AsyncSystem& asyncSystem,
+      CesiumAsync::Future<std::shared_ptr<CesiumAsync::IAssetRequest>>&&
+          future);
+
+  std::shared_ptr<CesiumAsync::IAssetAccessor> _pAccessor;
+};
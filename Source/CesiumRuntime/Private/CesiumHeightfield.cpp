@@ -0,0 +1,288 @@
+// Copyright 2020-2021 CesiumGS, Inc. and Contributors
+
+#include "CesiumHeightfield.h"
+#include "CesiumGeospatial/Ellipsoid.h"
+#include "CesiumUtility/Math.h"
+#include "CesiumUtility/Tracing.h"
+#include <glm/geometric.hpp>
+#include <glm/matrix.hpp>
+#include <limits>
+#include <optional>
+
+namespace {
+
+// How far outside of a triangle, in grid cells, a sample is still considered
+// to be inside it, so that samples on shared edges aren't missed.
+constexpr double EdgeTolerance = 1e-6;
+
+double cross(const glm::dvec2& a, const glm::dvec2& b) {
+  return a.x * b.y - a.y * b.x;
+}
+
+/**
+ * Interpolates the positions of the triangles at the samples that they
+ * cover, given the grid coordinates of each vertex.
+ */
+void rasterizeTriangles(
+    TFunctionRef<glm::dvec3(uint32)> getPosition,
+    const TArray<glm::dvec2>& gridCoordinates,
+    const TArray<uint32>& indices,
+    TArray<glm::dvec3>& samples,
+    TBitArray<>& covered) {
+  constexpr int32 size = CesiumHeightfield::SamplesPerSide;
+
+  for (int32 i = 2; i < indices.Num(); i += 3) {
+    const glm::dvec2& a = gridCoordinates[indices[i - 2]];
+    const glm::dvec2& b = gridCoordinates[indices[i - 1]];
+    const glm::dvec2& c = gridCoordinates[indices[i]];
+    const double area = cross(b - a, c - a);
+    if (FMath::Abs(area) < 1e-12) {
+      continue;
+    }
+
+    const int32 minX = FMath::Max(
+        FMath::CeilToInt(FMath::Min3(a.x, b.x, c.x) - EdgeTolerance),
+        0);
+    const int32 maxX = FMath::Min(
+        FMath::FloorToInt(FMath::Max3(a.x, b.x, c.x) + EdgeTolerance),
+        size - 1);
+    const int32 minY = FMath::Max(
+        FMath::CeilToInt(FMath::Min3(a.y, b.y, c.y) - EdgeTolerance),
+        0);
+    const int32 maxY = FMath::Min(
+        FMath::FloorToInt(FMath::Max3(a.y, b.y, c.y) + EdgeTolerance),
+        size - 1);
+    if (minX > maxX || minY > maxY) {
+      continue;
+    }
+
+    const glm::dvec3 pa = getPosition(indices[i - 2]);
+    const glm::dvec3 pb = getPosition(indices[i - 1]);
+    const glm::dvec3 pc = getPosition(indices[i]);
+
+    for (int32 y = minY; y <= maxY; ++y) {
+      for (int32 x = minX; x <= maxX; ++x) {
+        const glm::dvec2 p(x, y);
+        const double wb = cross(p - a, c - a) / area;
+        const double wc = cross(b - a, p - a) / area;
+        const double wa = 1.0 - wb - wc;
+        if (wa < -EdgeTolerance || wb < -EdgeTolerance ||
+            wc < -EdgeTolerance) {
+          continue;
+        }
+
+        const int32 index = y * size + x;
+        samples[index] = wa * pa + wb * pb + wc * pc;
+        covered[index] = true;
+      }
+    }
+  }
+}
+
+/**
+ * Gives the samples that no triangle covers the average position of their
+ * covered neighbors, growing the covered area one sample at a time. Returns
+ * false if no sample is covered.
+ */
+bool fillUncoveredSamples(TArray<glm::dvec3>& samples, TBitArray<>& covered) {
+  constexpr int32 size = CesiumHeightfield::SamplesPerSide;
+  const int32 offsets[4][2] = {{-1, 0}, {1, 0}, {0, -1}, {0, 1}};
+
+  bool uncovered = true;
+  while (uncovered) {
+    uncovered = false;
+    bool filled = false;
+    TBitArray<> previous = covered;
+
+    for (int32 y = 0; y < size; ++y) {
+      for (int32 x = 0; x < size; ++x) {
+        const int32 index = y * size + x;
+        if (previous[index]) {
+          continue;
+        }
+
+        glm::dvec3 sum(0.0);
+        int32 count = 0;
+        for (const int32* offset : offsets) {
+          const int32 nx = x + offset[0];
+          const int32 ny = y + offset[1];
+          if (nx >= 0 && nx < size && ny >= 0 && ny < size &&
+              previous[ny * size + nx]) {
+            sum += samples[ny * size + nx];
+            ++count;
+          }
+        }
+
+        if (count > 0) {
+          samples[index] = sum / double(count);
+          covered[index] = true;
+          filled = true;
+        } else {
+          uncovered = true;
+        }
+      }
+    }
+
+    if (uncovered && !filled) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+FColor encodeNormal(const glm::dvec3& normal) {
+  auto encode = [](double value) {
+    return static_cast<uint8>(
+        FMath::Clamp(FMath::RoundToInt(value * 127.5 + 127.5), 0, 255));
+  };
+  return FColor(encode(normal.x), encode(normal.y), encode(normal.z), 255);
+}
+
+} // namespace
+
+/*static*/ bool CesiumHeightfield::resample(
+    TFunctionRef<glm::dvec3(uint32)> getPosition,
+    uint32 numVertices,
+    const TArray<uint32>& indices,
+    const glm::dmat4& transform,
+    double skirtHeight,
+    CesiumHeightfieldTexels& result) {
+  CESIUM_TRACE("CesiumHeightfield::resample");
+
+  if (numVertices == 0 || indices.Num() < 3) {
+    return false;
+  }
+
+  // Find the longitude and latitude of each vertex, and the rectangle that
+  // the grid covers.
+  const CesiumGeospatial::Ellipsoid& ellipsoid =
+      CesiumGeospatial::Ellipsoid::WGS84;
+  TArray<glm::dvec2> gridCoordinates;
+  gridCoordinates.SetNumZeroed(numVertices);
+  TBitArray<> used(false, numVertices);
+  double west = std::numeric_limits<double>::max();
+  double south = std::numeric_limits<double>::max();
+  double east = std::numeric_limits<double>::lowest();
+  double north = std::numeric_limits<double>::lowest();
+  glm::dvec3 centroid(0.0);
+  std::optional<double> firstLongitude;
+
+  for (uint32 index : indices) {
+    if (used[index]) {
+      continue;
+    }
+    used[index] = true;
+
+    const glm::dvec3 position = getPosition(index);
+    const std::optional<CesiumGeospatial::Cartographic> cartographic =
+        ellipsoid.cartesianToCartographic(
+            glm::dvec3(transform * glm::dvec4(position, 1.0)));
+    if (!cartographic) {
+      return false;
+    }
+
+    // The longitudes are unwrapped around the first vertex, so that a tile
+    // on the antimeridian covers a narrow range past 180 degrees rather than
+    // the whole globe.
+    double longitude = cartographic->longitude;
+    if (firstLongitude) {
+      if (longitude - *firstLongitude > CesiumUtility::Math::ONE_PI) {
+        longitude -= CesiumUtility::Math::TWO_PI;
+      } else if (longitude - *firstLongitude < -CesiumUtility::Math::ONE_PI) {
+        longitude += CesiumUtility::Math::TWO_PI;
+      }
+    } else {
+      firstLongitude = longitude;
+    }
+
+    gridCoordinates[index] = glm::dvec2(longitude, cartographic->latitude);
+    west = FMath::Min(west, longitude);
+    south = FMath::Min(south, cartographic->latitude);
+    east = FMath::Max(east, longitude);
+    north = FMath::Max(north, cartographic->latitude);
+    centroid += position;
+  }
+
+  if (east - west <= 0.0 || north - south <= 0.0) {
+    return false;
+  }
+
+  // The samples are placed from west to east and from north to south, like
+  // the texels of a texture.
+  const double cellsPerLongitude = (SamplesPerSide - 1) / (east - west);
+  const double cellsPerLatitude = (SamplesPerSide - 1) / (north - south);
+  for (uint32 index = 0; index < numVertices; ++index) {
+    if (used[index]) {
+      glm::dvec2& coordinates = gridCoordinates[index];
+      coordinates = glm::dvec2(
+          (coordinates.x - west) * cellsPerLongitude,
+          (north - coordinates.y) * cellsPerLatitude);
+    }
+  }
+
+  TArray<glm::dvec3> samples;
+  samples.SetNumZeroed(SamplesPerSide * SamplesPerSide);
+  TBitArray<> covered(false, samples.Num());
+  rasterizeTriangles(getPosition, gridCoordinates, indices, samples, covered);
+  if (!fillUncoveredSamples(samples, covered)) {
+    return false;
+  }
+
+  // The skirt hangs along the direction of the ellipsoid normal at the
+  // center of the tile, in the coordinates of the primitive.
+  int32 numUsed = 0;
+  for (uint32 index = 0; index < numVertices; ++index) {
+    numUsed += used[index] ? 1 : 0;
+  }
+  centroid /= double(numUsed);
+  const glm::dvec3 ecefUp = ellipsoid.geodeticSurfaceNormal(
+      glm::dvec3(transform * glm::dvec4(centroid, 1.0)));
+  glm::dvec3 up = glm::dvec3(glm::inverse(transform) * glm::dvec4(ecefUp, 0.0));
+  const double upLength = glm::length(up);
+  up = upLength > 0.0 ? up / upLength : glm::dvec3(0.0, 0.0, 1.0);
+
+  auto getSample = [&samples](int32 x, int32 y) -> const glm::dvec3& {
+    x = FMath::Clamp(x, 0, SamplesPerSide - 1);
+    y = FMath::Clamp(y, 0, SamplesPerSide - 1);
+    return samples[y * SamplesPerSide + x];
+  };
+
+  result.positions.SetNumUninitialized(TextureSize * TextureSize);
+  result.normals.SetNumUninitialized(TextureSize * TextureSize);
+  result.bounds = FBox(ForceInit);
+
+  for (int32 y = 0; y < TextureSize; ++y) {
+    for (int32 x = 0; x < TextureSize; ++x) {
+      const int32 sampleX = x - 1;
+      const int32 sampleY = y - 1;
+
+      // The normal is the cross product of the central differences toward
+      // the east and toward the north, which faces up.
+      const glm::dvec3 toEast =
+          getSample(sampleX + 1, sampleY) - getSample(sampleX - 1, sampleY);
+      const glm::dvec3 toNorth =
+          getSample(sampleX, sampleY - 1) - getSample(sampleX, sampleY + 1);
+      glm::dvec3 normal = glm::cross(toEast, toNorth);
+      const double normalLength = glm::length(normal);
+      normal = normalLength > 0.0 ? normal / normalLength : up;
+      if (glm::dot(normal, up) < 0.0) {
+        // The coordinates of the primitive are mirrored.
+        normal = -normal;
+      }
+
+      glm::dvec3 position = getSample(sampleX, sampleY);
+      if (x == 0 || y == 0 || x == TextureSize - 1 || y == TextureSize - 1) {
+        position -= up * skirtHeight;
+      }
+
+      const int32 texel = y * TextureSize + x;
+      result.positions[texel] =
+          FLinearColor(float(position.x), float(position.y), float(position.z));
+      result.normals[texel] = encodeNormal(normal);
+      result.bounds += FVector(position.x, position.y, position.z);
+    }
+  }
+
+  return true;
+}
@@ -0,0 +1,76 @@
+// Copyright 2020-2021 CesiumGS, Inc. and Contributors
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Templates/Function.h"
+#include <glm/mat4x4.hpp>
+#include <glm/vec3.hpp>
+
+/**
+ * @brief The texels of a heightfield, which hold the surface of a terrain tile
+ * sampled on a regular grid of longitudes and latitudes.
+ *
+ * The texture is TextureSize texels on a side. Its inner SamplesPerSide
+ * texels on a side are the samples of the surface, from the north-west corner
+ * of the tile in the first texel to its south-east corner in the last one.
+ * The ring of texels around them is the skirt, which hangs below the edges of
+ * the tile to hide the cracks between it and its neighbors.
+ */
+struct CesiumHeightfieldTexels {
+  // The position of each texel, in the coordinates of the primitive.
+  TArray<FLinearColor> positions;
+
+  // The normal of each texel, in the coordinates of the primitive, with each
+  // component mapped from [-1, 1] to [0, 255].
+  TArray<FColor> normals;
+
+  // The bounds of the positions.
+  FBox bounds{ForceInit};
+};
+
+/**
+ * @brief Functions that turn the triangles of a terrain tile into a
+ * heightfield, which is drawn by displacing a grid that is shared by all
+ * heightfields. See FCesiumHeightfieldSceneProxy.
+ */
+class CesiumHeightfield {
+public:
+  /**
+   * The number of samples on each side of a heightfield.
+   */
+  static constexpr int32 SamplesPerSide = 65;
+
+  /**
+   * The number of texels on each side of a heightfield texture, which are the
+   * samples and the skirt around them.
+   */
+  static constexpr int32 TextureSize = SamplesPerSide + 2;
+
+  /**
+   * @brief Samples the surface of a terrain tile into a heightfield.
+   *
+   * The grid covers the longitudes and latitudes of the vertices used by the
+   * triangles, and each sample is interpolated from the triangle it falls in.
+   * Samples that no triangle covers take the position of their neighbors.
+   *
+   * @param getPosition Gets the position of the vertex with the given index,
+   * in the coordinates of the primitive.
+   * @param numVertices The number of vertices.
+   * @param indices The triangle list indices of the surface, without its
+   * skirts, which are already known to be less than numVertices.
+   * @param transform The transform from the coordinates of the primitive to
+   * Earth-centered, Earth-fixed coordinates.
+   * @param skirtHeight How far below the edges of the tile the skirt hangs.
+   * @param result Receives the texels.
+   * @return Whether the surface could be sampled. It can't be if it has no
+   * triangles or if it covers no area.
+   */
+  static bool resample(
+      TFunctionRef<glm::dvec3(uint32)> getPosition,
+      uint32 numVertices,
+      const TArray<uint32>& indices,
+      const glm::dmat4& transform,
+      double skirtHeight,
+      CesiumHeightfieldTexels& result);
+};
@@ -0,0 +1,206 @@
+// Copyright 2020-2021 CesiumGS, Inc. and Contributors
+
+#include "CesiumHeightfieldSceneProxy.h"
+#include "CesiumGltfPrimitiveComponent.h"
+#include "CesiumHeightfield.h"
+#include "LocalVertexFactory.h"
+#include "Materials/Material.h"
+#include "RenderResource.h"
+#include "Rendering/StaticMeshVertexBuffer.h"
+#include "Runtime/Launch/Resources/Version.h"
+#include "SceneManagement.h"
+#include "StaticMeshResources.h"
+
+namespace {
+
+#if ENGINE_MAJOR_VERSION == 5
+using TGridVector3 = FVector3f;
+using TGridVector2 = FVector2f;
+#else
+using TGridVector3 = FVector;
+using TGridVector2 = FVector2D;
+#endif
+
+/**
+ * The grid that every heightfield is drawn with, with a vertex for each
+ * texel of a heightfield texture.
+ */
+class FCesiumHeightfieldGrid : public FRenderResource {
+public:
+  FCesiumHeightfieldGrid()
+      : vertexBuffers(),
+        indexBuffer(),
+        vertexFactory(GMaxRHIFeatureLevel, "FCesiumHeightfieldGrid"),
+        numVertices(0),
+        numTriangles(0) {}
+
+  virtual void InitRHI() override {
+    constexpr int32 size = CesiumHeightfield::TextureSize;
+    constexpr float samplesPerSide = CesiumHeightfield::SamplesPerSide;
+    this->numVertices = size * size;
+
+    this->vertexBuffers.PositionVertexBuffer.Init(this->numVertices);
+    this->vertexBuffers.StaticMeshVertexBuffer.Init(this->numVertices, 2);
+    this->vertexBuffers.ColorVertexBuffer.InitFromSingleColor(
+        FColor::White,
+        this->numVertices);
+
+    for (int32 y = 0; y < size; ++y) {
+      for (int32 x = 0; x < size; ++x) {
+        const uint32 vertex = y * size + x;
+        const float u = (x + 0.5f) / size;
+        const float v = (y + 0.5f) / size;
+        this->vertexBuffers.PositionVertexBuffer.VertexPosition(vertex) =
+            TGridVector3(u, v, 0.0f);
+        this->vertexBuffers.StaticMeshVertexBuffer.SetVertexTangents(
+            vertex,
+            TGridVector3(1.0f, 0.0f, 0.0f),
+            TGridVector3(0.0f, 1.0f, 0.0f),
+            TGridVector3(0.0f, 0.0f, 1.0f));
+        this->vertexBuffers.StaticMeshVertexBuffer.SetVertexUV(
+            vertex,
+            0,
+            TGridVector2(u, v));
+
+        // The skirt takes the coordinates of the edge it hangs from.
+        this->vertexBuffers.StaticMeshVertexBuffer.SetVertexUV(
+            vertex,
+            1,
+            TGridVector2(
+                FMath::Clamp((x - 1) / (samplesPerSide - 1.0f), 0.0f, 1.0f),
+                FMath::Clamp(
+                    1.0f - (y - 1) / (samplesPerSide - 1.0f),
+                    0.0f,
+                    1.0f)));
+      }
+    }
+
+    // The rows of the grid go from north to south, so these triangles wind
+    // counter-clockwise seen from above in the glTF right-handed coordinate
+    // system, and are reversed like those of every other primitive.
+    TArray<uint32> indices;
+    indices.Reserve((size - 1) * (size - 1) * 6);
+    for (int32 y = 0; y < size - 1; ++y) {
+      for (int32 x = 0; x < size - 1; ++x) {
+        const uint32 northWest = y * size + x;
+        const uint32 northEast = northWest + 1;
+        const uint32 southWest = northWest + size;
+        const uint32 southEast = southWest + 1;
+        indices.Append({northEast, southEast, southWest});
+        indices.Append({northWest, northEast, southWest});
+      }
+    }
+    this->numTriangles = indices.Num() / 3;
+    this->indexBuffer.SetIndices(
+        indices,
+        EIndexBufferStride::Type::Force16Bit);
+
+    this->vertexBuffers.PositionVertexBuffer.InitResource();
+    this->vertexBuffers.StaticMeshVertexBuffer.InitResource();
+    this->vertexBuffers.ColorVertexBuffer.InitResource();
+    this->indexBuffer.InitResource();
+
+    FLocalVertexFactory::FDataType data;
+    this->vertexBuffers.PositionVertexBuffer.BindPositionVertexBuffer(
+        &this->vertexFactory,
+        data);
+    this->vertexBuffers.StaticMeshVertexBuffer.BindTangentVertexBuffer(
+        &this->vertexFactory,
+        data);
+    this->vertexBuffers.StaticMeshVertexBuffer.BindPackedTexCoordVertexBuffer(
+        &this->vertexFactory,
+        data);
+    this->vertexBuffers.ColorVertexBuffer.BindColorVertexBuffer(
+        &this->vertexFactory,
+        data);
+    this->vertexFactory.SetData(data);
+    this->vertexFactory.InitResource();
+  }
+
+  virtual void ReleaseRHI() override {
+    this->vertexFactory.ReleaseResource();
+    this->indexBuffer.ReleaseResource();
+    this->vertexBuffers.PositionVertexBuffer.ReleaseResource();
+    this->vertexBuffers.StaticMeshVertexBuffer.ReleaseResource();
+    this->vertexBuffers.ColorVertexBuffer.ReleaseResource();
+  }
+
+  FStaticMeshVertexBuffers vertexBuffers;
+  FRawStaticIndexBuffer indexBuffer;
+  FLocalVertexFactory vertexFactory;
+  uint32 numVertices;
+  uint32 numTriangles;
+};
+
+TGlobalResource<FCesiumHeightfieldGrid> GCesiumHeightfieldGrid;
+
+} // namespace
+
+FCesiumHeightfieldSceneProxy::FCesiumHeightfieldSceneProxy(
+    UCesiumGltfPrimitiveComponent* pComponent)
+    : FPrimitiveSceneProxy(pComponent),
+      _pMaterial(pComponent->GetMaterial(0)),
+      _materialRelevance() {
+  if (!this->_pMaterial) {
+    this->_pMaterial = UMaterial::GetDefaultMaterial(MD_Surface);
+  }
+  this->_materialRelevance =
+      this->_pMaterial->GetRelevance_Concurrent(GetScene().GetFeatureLevel());
+}
+
+SIZE_T FCesiumHeightfieldSceneProxy::GetTypeHash() const {
+  static size_t uniquePointer;
+  return reinterpret_cast<size_t>(&uniquePointer);
+}
+
+void FCesiumHeightfieldSceneProxy::GetDynamicMeshElements(
+    const TArray<const FSceneView*>& Views,
+    const FSceneViewFamily& ViewFamily,
+    uint32 VisibilityMap,
+    FMeshElementCollector& Collector) const {
+  const FCesiumHeightfieldGrid& grid = GCesiumHeightfieldGrid;
+  if (grid.numTriangles == 0) {
+    return;
+  }
+
+  for (int32 viewIndex = 0; viewIndex < Views.Num(); ++viewIndex) {
+    if (!(VisibilityMap & (1 << viewIndex))) {
+      continue;
+    }
+
+    FMeshBatch& mesh = Collector.AllocateMesh();
+    mesh.VertexFactory = &grid.vertexFactory;
+    mesh.MaterialRenderProxy = this->_pMaterial->GetRenderProxy();
+    mesh.Type = PT_TriangleList;
+    mesh.DepthPriorityGroup = SDPG_World;
+    mesh.ReverseCulling = IsLocalToWorldDeterminantNegative();
+    mesh.CastShadow = CastsDynamicShadow();
+    mesh.bCanApplyViewModeOverrides = false;
+
+    FMeshBatchElement& element = mesh.Elements[0];
+    element.IndexBuffer = &grid.indexBuffer;
+    element.FirstIndex = 0;
+    element.NumPrimitives = grid.numTriangles;
+    element.MinVertexIndex = 0;
+    element.MaxVertexIndex = grid.numVertices - 1;
+    element.PrimitiveUniformBuffer = GetUniformBuffer();
+
+    Collector.AddMesh(viewIndex, mesh);
+  }
+}
+
+FPrimitiveViewRelevance
+FCesiumHeightfieldSceneProxy::GetViewRelevance(const FSceneView* View) const {
+  FPrimitiveViewRelevance result;
+  result.bDrawRelevance = IsShown(View);
+  result.bDynamicRelevance = true;
+  result.bShadowRelevance = IsShadowCast(View);
+  result.bRenderInMainPass = ShouldRenderInMainPass();
+  result.bRenderCustomDepth = ShouldRenderCustomDepth();
+  this->_materialRelevance.SetPrimitiveViewRelevance(result);
+  return result;
+}
+
+uint32 FCesiumHeightfieldSceneProxy::GetMemoryFootprint() const {
+  return sizeof(*this) + GetAllocatedSize();
+}
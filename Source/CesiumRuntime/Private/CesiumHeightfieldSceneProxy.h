@@ -0,0 +1,44 @@
+// Copyright 2020-2021 CesiumGS, Inc. and Contributors
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MaterialShared.h"
+#include "PrimitiveSceneProxy.h"
+
+class UCesiumGltfPrimitiveComponent;
+class UMaterialInterface;
+
+/**
+ * @brief Draws a heightfield primitive as a grid that is shared by all
+ * heightfields, which its material displaces in the vertex shader.
+ *
+ * The grid has one vertex per texel of the heightfield textures, see
+ * CesiumHeightfieldTexels. The first UV channel of each vertex is the center
+ * of its texel, where the material samples its position and normal from the
+ * textures, and the second one is its fraction of the longitudes and
+ * latitudes of the tile, from the south-west corner, for the raster overlays.
+ * Since the grid is always the same, a heightfield takes no vertex or index
+ * buffers of its own.
+ */
+class FCesiumHeightfieldSceneProxy final : public FPrimitiveSceneProxy {
+public:
+  FCesiumHeightfieldSceneProxy(UCesiumGltfPrimitiveComponent* pComponent);
+
+  virtual SIZE_T GetTypeHash() const override;
+
+  virtual void GetDynamicMeshElements(
+      const TArray<const FSceneView*>& Views,
+      const FSceneViewFamily& ViewFamily,
+      uint32 VisibilityMap,
+      FMeshElementCollector& Collector) const override;
+
+  virtual FPrimitiveViewRelevance
+  GetViewRelevance(const FSceneView* View) const override;
+
+  virtual uint32 GetMemoryFootprint() const override;
+
+private:
+  UMaterialInterface* _pMaterial;
+  FMaterialRelevance _materialRelevance;
+};
@@ -0,0 +1,250 @@
+// Copyright 2020-2021 CesiumGS, Inc. and Contributors
+
+#include "CesiumIonEndpointCache.h"
+#include "CesiumAsync/IAssetRequest.h"
+#include "CesiumAsync/IAssetResponse.h"
+#include "Dom/JsonObject.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/Base64.h"
+#include "Misc/DateTime.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+#include <algorithm>
+
+namespace {
+
+// How long, in seconds, a response without an access token that expires is
+// kept, such as one for an asset that is hosted elsewhere.
+constexpr double DefaultLifetime = 1800.0;
+
+// How long before its access token expires, in seconds, a response stops
+// being served, so that it isn't used for tiles that are loaded after that.
+constexpr double ExpiryMargin = 60.0;
+
+// How long before its access token expires, in seconds, a response is
+// requested again.
+constexpr double RefreshMargin = 300.0;
+
+// How long, in seconds, a response that isn't served anymore is still
+// refreshed, which covers the lifetime of the tilesets that use its token.
+constexpr double MaximumIdleTime = 3600.0;
+
+// How often, in seconds, the responses are checked for refreshes.
+constexpr double RefreshCheckInterval = 1.0;
+
+/**
+ * Whether the URL is that of an asset endpoint of a Cesium ion server, such
+ * as https://api.cesium.com/v1/assets/1/endpoint?access_token=...
+ */
+bool isEndpointUrl(const std::string& url) {
+  const size_t path = url.find("/v1/assets/");
+  if (path == std::string::npos) {
+    return false;
+  }
+  const size_t end = std::min(url.find('?', path), url.size());
+  const std::string endpoint = "/endpoint";
+  return end >= endpoint.size() &&
+         url.compare(end - endpoint.size(), endpoint.size(), endpoint) == 0;
+}
+
+TSharedPtr<FJsonObject> parseJson(const FString& text) {
+  TSharedPtr<FJsonObject> pRoot;
+  TSharedRef<TJsonReader<>> pReader = TJsonReaderFactory<>::Create(text);
+  if (!FJsonSerializer::Deserialize(pReader, pRoot)) {
+    return nullptr;
+  }
+  return pRoot;
+}
+
+/**
+ * Finds how long, in seconds, the access token of an endpoint response is
+ * valid for, from the expiration time in its JSON Web Token payload.
+ */
+std::optional<double>
+getTokenLifetime(const CesiumAsync::IAssetResponse& response) {
+  const gsl::span<const std::byte> data = response.data();
+  const FUTF8ToTCHAR text(
+      reinterpret_cast<const ANSICHAR*>(data.data()),
+      int32(data.size()));
+  TSharedPtr<FJsonObject> pRoot =
+      parseJson(FString(text.Length(), text.Get()));
+
+  FString token;
+  if (!pRoot || !pRoot->TryGetStringField(TEXT("accessToken"), token)) {
+    return std::nullopt;
+  }
+
+  TArray<FString> parts;
+  if (token.ParseIntoArray(parts, TEXT("."), false) != 3) {
+    return std::nullopt;
+  }
+
+  // The payload is base64url-encoded without padding.
+  FString payload = parts[1].Replace(TEXT("-"), TEXT("+"))
+                        .Replace(TEXT("_"), TEXT("/"));
+  while (payload.Len() % 4 != 0) {
+    payload += TEXT("=");
+  }
+
+  FString claims;
+  if (!FBase64::Decode(payload, claims)) {
+    return std::nullopt;
+  }
+
+  TSharedPtr<FJsonObject> pClaims = parseJson(claims);
+  double expiration = 0.0;
+  if (!pClaims || !pClaims->TryGetNumberField(TEXT("exp"), expiration)) {
+    return std::nullopt;
+  }
+
+  return expiration - double(FDateTime::UtcNow().ToUnixTimestamp());
+}
+
+} // namespace
+
+CesiumIonEndpointCacheAssetAccessor::CesiumIonEndpointCacheAssetAccessor(
+    const std::shared_ptr<CesiumAsync::IAssetAccessor>& pAccessor)
+    : _pAccessor(pAccessor), _pState(std::make_shared<State>()) {}
+
+CesiumAsync::Future<std::shared_ptr<CesiumAsync::IAssetRequest>>
+CesiumIonEndpointCacheAssetAccessor::get(
+    const CesiumAsync::AsyncSystem& asyncSystem,
+    const std::string& url,
+    const std::vector<CesiumAsync::IAssetAccessor::THeader>& headers) {
+  if (!isEndpointUrl(url)) {
+    return this->_pAccessor->get(asyncSystem, url, headers);
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(this->_pState->mutex);
+    this->_pState->asyncSystem = asyncSystem;
+
+    auto it = this->_pState->entries.find(url);
+    const double now = FPlatformTime::Seconds();
+    if (it != this->_pState->entries.end() && now < it->second.expiryTime) {
+      it->second.lastUsedTime = now;
+      return asyncSystem.createResolvedFuture(
+          std::shared_ptr<CesiumAsync::IAssetRequest>(it->second.pRequest));
+    }
+  }
+
+  return requestEndpoint(
+      asyncSystem,
+      this->_pAccessor,
+      this->_pState,
+      url,
+      headers);
+}
+
+CesiumAsync::Future<std::shared_ptr<CesiumAsync::IAssetRequest>>
+CesiumIonEndpointCacheAssetAccessor::request(
+    const CesiumAsync::AsyncSystem& asyncSystem,
+    const std::string& verb,
+    const std::string& url,
+    const std::vector<CesiumAsync::IAssetAccessor::THeader>& headers,
+    const gsl::span<const std::byte>& contentPayload) {
+  if (verb == "GET") {
+    return this->get(asyncSystem, url, headers);
+  }
+
+  return this->_pAccessor
+      ->request(asyncSystem, verb, url, headers, contentPayload);
+}
+
+void CesiumIonEndpointCacheAssetAccessor::tick() noexcept {
+  this->_pAccessor->tick();
+
+  const double now = FPlatformTime::Seconds();
+  if (now < this->_nextRefreshCheckTime) {
+    return;
+  }
+  this->_nextRefreshCheckTime = now + RefreshCheckInterval;
+
+  std::optional<CesiumAsync::AsyncSystem> asyncSystem;
+  std::vector<std::pair<std::string, std::vector<THeader>>> refreshes;
+  {
+    std::lock_guard<std::mutex> lock(this->_pState->mutex);
+    asyncSystem = this->_pState->asyncSystem;
+
+    auto& entries = this->_pState->entries;
+    for (auto it = entries.begin(); it != entries.end();) {
+      Entry& entry = it->second;
+      if (entry.refreshing) {
+        ++it;
+        continue;
+      }
+
+      if (now >= entry.expiryTime) {
+        it = entries.erase(it);
+        continue;
+      }
+
+      if (asyncSystem && now >= entry.refreshTime &&
+          now - entry.lastUsedTime < MaximumIdleTime) {
+        entry.refreshing = true;
+        refreshes.emplace_back(it->first, entry.headers);
+      }
+      ++it;
+    }
+  }
+
+  // The responses are replaced when the new ones arrive, and the old ones are
+  // served until then.
+  for (const auto& [url, headers] : refreshes) {
+    requestEndpoint(
+        *asyncSystem,
+        this->_pAccessor,
+        this->_pState,
+        url,
+        headers);
+  }
+}
+
+/*static*/ CesiumAsync::Future<std::shared_ptr<CesiumAsync::IAssetRequest>>
+CesiumIonEndpointCacheAssetAccessor::requestEndpoint(
+    const CesiumAsync::AsyncSystem& asyncSystem,
+    const std::shared_ptr<CesiumAsync::IAssetAccessor>& pAccessor,
+    const std::shared_ptr<State>& pState,
+    const std::string& url,
+    const std::vector<CesiumAsync::IAssetAccessor::THeader>& headers) {
+  return pAccessor->get(asyncSystem, url, headers)
+      .thenImmediately(
+          [pState, url, headers](
+              std::shared_ptr<CesiumAsync::IAssetRequest>&& pRequest) {
+            const CesiumAsync::IAssetResponse* pResponse =
+                pRequest ? pRequest->response() : nullptr;
+
+            std::lock_guard<std::mutex> lock(pState->mutex);
+            auto it = pState->entries.find(url);
+            if (!pResponse || pResponse->statusCode() != 200) {
+              // A response that couldn't be refreshed is served until it
+              // expires.
+              if (it != pState->entries.end()) {
+                it->second.refreshing = false;
+              }
+              return std::move(pRequest);
+            }
+
+            const double now = FPlatformTime::Seconds();
+            const double lifetime =
+                getTokenLifetime(*pResponse).value_or(DefaultLifetime);
+            if (lifetime <= ExpiryMargin) {
+              if (it != pState->entries.end()) {
+                pState->entries.erase(it);
+              }
+              return std::move(pRequest);
+            }
+
+            Entry& entry = pState->entries[url];
+            if (!entry.pRequest) {
+              entry.lastUsedTime = now;
+            }
+            entry.pRequest = pRequest;
+            entry.headers = headers;
+            entry.expiryTime = now + lifetime - ExpiryMargin;
+            entry.refreshTime =
+                now + std::max(lifetime - RefreshMargin, 0.5 * lifetime);
+            entry.refreshing = false;
+            return std::move(pRequest);
+          });
+}
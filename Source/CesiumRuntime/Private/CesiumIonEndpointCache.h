@@ -0,0 +1,80 @@
+// Copyright 2020-2021 CesiumGS, Inc. and Contributors
+
+#pragma once
+
+#include "CesiumAsync/AsyncSystem.h"
+#include "CesiumAsync/IAssetAccessor.h"
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief An asset accessor that keeps the responses of Cesium ion asset
+ * endpoint requests in memory, so that loading the same asset again with the
+ * same token, such as when a tileset or raster overlay is refreshed or one of
+ * its properties is changed in the editor, doesn't wait for the endpoint to
+ * be resolved over the network.
+ *
+ * The responses are keyed by their URL, which holds the asset ID, the access
+ * token, and the ion server. Each one is kept until shortly before the access
+ * token that it holds expires, and responses that were requested recently are
+ * requested again in the background before then, so that the tiles that are
+ * loaded with the token don't have to wait for a new one either. All other
+ * requests are passed through unchanged.
+ */
+class CesiumIonEndpointCacheAssetAccessor : public CesiumAsync::IAssetAccessor {
+public:
+  CesiumIonEndpointCacheAssetAccessor(
+      const std::shared_ptr<CesiumAsync::IAssetAccessor>& pAccessor);
+
+  virtual CesiumAsync::Future<std::shared_ptr<CesiumAsync::IAssetRequest>>
+  get(const CesiumAsync::AsyncSystem& asyncSystem,
+      const std::string& url,
+      const std::vector<CesiumAsync::IAssetAccessor::THeader>& headers)
+      override;
+
+  virtual CesiumAsync::Future<std::shared_ptr<CesiumAsync::IAssetRequest>>
+  request(
+      const CesiumAsync::AsyncSystem& asyncSystem,
+      const std::string& verb,
+      const std::string& url,
+      const std::vector<CesiumAsync::IAssetAccessor::THeader>& headers,
+      const gsl::span<const std::byte>& contentPayload) override;
+
+  virtual void tick() noexcept override;
+
+private:
+  struct Entry {
+    std::shared_ptr<CesiumAsync::IAssetRequest> pRequest;
+    std::vector<CesiumAsync::IAssetAccessor::THeader> headers;
+    // The FPlatformTime::Seconds after which the response is not served,
+    // after which it is requested again, and at which it was last served.
+    double expiryTime = 0.0;
+    double refreshTime = 0.0;
+    double lastUsedTime = 0.0;
+    bool refreshing = false;
+  };
+
+  struct State {
+    std::mutex mutex;
+    std::unordered_map<std::string, Entry> entries;
+    // The async system of the last endpoint request, which background
+    // refreshes are made with.
+    std::optional<CesiumAsync::AsyncSystem> asyncSystem;
+  };
+
+  static CesiumAsync::Future<std::shared_ptr<CesiumAsync::IAssetRequest>>
+  requestEndpoint(
+      const CesiumAsync::AsyncSystem& asyncSystem,
+      const std::shared_ptr<CesiumAsync::IAssetAccessor>& pAccessor,
+      const std::shared_ptr<State>& pState,
+      const std::string& url,
+      const std::vector<CesiumAsync::IAssetAccessor::THeader>& headers);
+
+  std::shared_ptr<CesiumAsync::IAssetAccessor> _pAccessor;
+  std::shared_ptr<State> _pState;
+  double _nextRefreshCheckTime = 0.0;
+};
@@ -1,27 +1,78 @@
 #include "CesiumLifetime.h"
-#include "Async/Async.h"
+#include "CesiumRuntimeSettings.h"
+#include "CesiumRuntimeStats.h"
+#include "Components/ActorComponent.h"
+#include "Containers/Ticker.h"
 #include "Engine/StaticMesh.h"
 #include "Engine/Texture2D.h"
+#include "HAL/PlatformTime.h"
+#include "Materials/MaterialInterface.h"
 #include "PhysicsEngine/BodySetup.h"
+#include "Runtime/Launch/Resources/Version.h"
 #include "UObject/Object.h"
-#include <algorithm>
 
+/*static*/ TArray<TWeakObjectPtr<UObject>> CesiumLifetime::_queued[uint8(
+    CesiumLifetime::Kind::Count)];
 /*static*/ TArray<TWeakObjectPtr<UObject>> CesiumLifetime::_pending;
-/*static*/ TArray<TWeakObjectPtr<UObject>> CesiumLifetime::_nextPending;
 /*static*/ bool CesiumLifetime::_isScheduled = false;
 
+namespace {
+#if ENGINE_MAJOR_VERSION >= 5
+FTSTicker::FDelegateHandle tickerHandle;
+#else
+FDelegateHandle tickerHandle;
+#endif
+} // namespace
+
 /*static*/ void CesiumLifetime::destroy(UObject* pObject) {
-  if (!runDestruction(pObject)) {
-    // Object is not finished being destroyed, so add it to the pending list.
-    addToPending(pObject);
+  if (!pObject) {
+    return;
   }
+
+  // Marking the object as garbage is cheap, and makes sure nothing uses it
+  // while it waits to be destroyed.
+  markAsGarbage(pObject);
+
+  _queued[uint8(getKind(pObject))].Add(pObject);
+  schedule();
 }
 
-/*static*/ bool CesiumLifetime::runDestruction(UObject* pObject) {
-  if (!pObject) {
-    return true;
+/*static*/ void CesiumLifetime::shutdown() {
+  if (_isScheduled) {
+#if ENGINE_MAJOR_VERSION >= 5
+    FTSTicker::GetCoreTicker().RemoveTicker(tickerHandle);
+#else
+    FTicker::GetCoreTicker().RemoveTicker(tickerHandle);
+#endif
+    _isScheduled = false;
   }
 
+  for (TArray<TWeakObjectPtr<UObject>>& queued : _queued) {
+    queued.Empty();
+  }
+  _pending.Empty();
+}
+
+/*static*/ CesiumLifetime::Kind CesiumLifetime::getKind(UObject* pObject) {
+  if (pObject->IsA<UActorComponent>()) {
+    return Kind::Component;
+  }
+  if (pObject->IsA<UMaterialInterface>()) {
+    return Kind::Material;
+  }
+  if (pObject->IsA<UStaticMesh>()) {
+    return Kind::Mesh;
+  }
+  if (pObject->IsA<UBodySetup>()) {
+    return Kind::BodySetup;
+  }
+  if (pObject->IsA<UTexture>()) {
+    return Kind::Texture;
+  }
+  return Kind::Other;
+}
+
+/*static*/ void CesiumLifetime::markAsGarbage(UObject* pObject) {
 #if ENGINE_MAJOR_VERSION >= 5
   pObject->MarkAsGarbage();
 #else
@@ -29,6 +80,14 @@
     pObject->MarkPendingKill();
   }
 #endif
+}
+
+/*static*/ bool CesiumLifetime::runDestruction(UObject* pObject) {
+  if (!pObject) {
+    return true;
+  }
+
+  markAsGarbage(pObject);
 
   if (pObject->HasAnyFlags(RF_FinishDestroyed)) {
     // Already done being destroyed.
@@ -52,25 +111,68 @@
   return false;
 }
 
-/*static*/ void CesiumLifetime::addToPending(UObject* pObject) {
-  _pending.Add(pObject);
-  if (!_isScheduled) {
-    _isScheduled = true;
-    AsyncTask(ENamedThreads::GameThread, []() {
-      CesiumLifetime::processPending();
-    });
+/*static*/ void CesiumLifetime::schedule() {
+  if (_isScheduled) {
+    return;
   }
-}
+  _isScheduled = true;
 
-/*static*/ void CesiumLifetime::processPending() {
-  _isScheduled = false;
+  // The core ticker runs once per frame, so the objects left over when the
+  // time limit is reached wait for the next frame.
+#if ENGINE_MAJOR_VERSION >= 5
+  tickerHandle = FTSTicker::GetCoreTicker().AddTicker(
+      FTickerDelegate::CreateStatic(&CesiumLifetime::processPending));
+#else
+  tickerHandle = FTicker::GetCoreTicker().AddTicker(
+      FTickerDelegate::CreateStatic(&CesiumLifetime::processPending));
+#endif
+}
 
-  std::swap(_nextPending, _pending);
-  _pending.Empty();
+/*static*/ bool CesiumLifetime::processPending(float /*deltaTime*/) {
+  const float timeLimit =
+      GetDefault<UCesiumRuntimeSettings>()->MaximumDestructionTimePerFrame;
+  const double endTime = FPlatformTime::Seconds() + timeLimit / 1000.0;
+  auto isOutOfTime = [timeLimit, endTime]() {
+    return timeLimit > 0.0f && FPlatformTime::Seconds() >= endTime;
+  };
+
+  // Objects whose destruction was started on an earlier frame are usually
+  // ready by now, and are finished first.
+  int32 kept = 0;
+  for (int32 i = 0; i < _pending.Num(); ++i) {
+    UObject* pObject = _pending[i].Get(true);
+    if (isOutOfTime() || !runDestruction(pObject)) {
+      _pending[kept++] = _pending[i];
+    }
+  }
+  _pending.SetNum(kept, false);
+
+  // Then new objects are destroyed, one kind at a time. Components go first,
+  // because they refer to the materials, meshes and body setups that follow,
+  // and materials refer to the textures. At least one object is destroyed
+  // per frame so that progress is always made.
+  int32 destroyed = 0;
+  for (TArray<TWeakObjectPtr<UObject>>& queued : _queued) {
+    while (queued.Num() > 0 && (destroyed == 0 || !isOutOfTime())) {
+      UObject* pObject = queued.Pop(false).Get(true);
+      if (!runDestruction(pObject)) {
+        // The object isn't finished being destroyed, so check it again on
+        // the next frame.
+        _pending.Add(pObject);
+      }
+      ++destroyed;
+    }
+  }
 
-  for (TWeakObjectPtr<UObject> pObject : _nextPending) {
-    destroy(pObject.Get(true));
+  int32 remaining = _pending.Num();
+  for (const TArray<TWeakObjectPtr<UObject>>& queued : _queued) {
+    remaining += queued.Num();
   }
+
+  CesiumRuntimeStats::updateDestructionStats(remaining, destroyed);
+
+  _isScheduled = remaining > 0;
+  return _isScheduled;
 }
 
 /*static*/ void CesiumLifetime::finalizeDestroy(UObject* pObject) {
@@ -9,15 +9,45 @@ class UTexture;
 
 class CesiumLifetime {
 public:
+  /**
+   * Destroys the given object. It is marked as garbage immediately, and the
+   * rest of its destruction is done on later frames, within the
+   * MaximumDestructionTimePerFrame runtime setting. Must be called from the
+   * game thread.
+   */
   static void destroy(UObject* pObject);
 
+  /**
+   * Stops destroying the objects that are still waiting, which are left to
+   * the garbage collector. Called when the module shuts down.
+   */
+  static void shutdown();
+
 private:
+  // The kinds of objects that are destroyed together.
+  enum class Kind : uint8 {
+    Component,
+    Material,
+    Mesh,
+    BodySetup,
+    Texture,
+    Other,
+    Count
+  };
+
+  static Kind getKind(UObject* pObject);
+  static void markAsGarbage(UObject* pObject);
   static bool runDestruction(UObject* pObject);
-  static void addToPending(UObject* pObject);
-  static void processPending();
+  static void schedule();
+  static bool processPending(float deltaTime);
   static void finalizeDestroy(UObject* pObject);
 
+  // The objects whose destruction hasn't started yet, by kind.
+  static TArray<TWeakObjectPtr<UObject>> _queued[uint8(Kind::Count)];
+
+  // The objects whose destruction has started, and which are waiting for it
+  // to finish asynchronously.
   static TArray<TWeakObjectPtr<UObject>> _pending;
-  static TArray<TWeakObjectPtr<UObject>> _nextPending;
+
   static bool _isScheduled;
 };
@@ -0,0 +1,143 @@
+// Copyright 2020-2021 CesiumGS, Inc. and Contributors
+
+#include "CesiumMemoryCache.h"
+#include "CesiumRuntimeStats.h"
+#include <ctime>
+
+using namespace CesiumAsync;
+
+namespace {
+int64_t getHeadersBytes(const HttpHeaders& headers) {
+  int64_t bytes = 0;
+  for (const auto& header : headers) {
+    bytes += int64_t(header.first.size() + header.second.size());
+  }
+  return bytes;
+}
+
+int64_t getItemBytes(const std::string& key, const CacheItem& item) {
+  return int64_t(key.size() + item.cacheRequest.url.size()) +
+         getHeadersBytes(item.cacheRequest.headers) +
+         getHeadersBytes(item.cacheResponse.headers) +
+         int64_t(item.cacheResponse.data.size());
+}
+} // namespace
+
+CesiumMemoryCache::CesiumMemoryCache(
+    const std::shared_ptr<ICacheDatabase>& pDatabase,
+    int64_t maximumBytes)
+    : _pDatabase(pDatabase),
+      _maximumBytes(maximumBytes),
+      _mutex(),
+      _entries(),
+      _entriesByKey(),
+      _totalBytes(0) {}
+
+std::optional<CacheItem>
+CesiumMemoryCache::getEntry(const std::string& key) const {
+  {
+    std::lock_guard<std::mutex> lock(this->_mutex);
+    auto it = this->_entriesByKey.find(key);
+    if (it != this->_entriesByKey.end()) {
+      this->_entries.splice(this->_entries.begin(), this->_entries, it->second);
+      CesiumRuntimeStats::addCacheMemoryHit();
+      return it->second->item;
+    }
+  }
+
+  std::optional<CacheItem> maybeItem = this->_pDatabase->getEntry(key);
+  if (maybeItem) {
+    this->addEntry(key, CacheItem(*maybeItem));
+  }
+
+  return maybeItem;
+}
+
+bool CesiumMemoryCache::storeEntry(
+    const std::string& key,
+    std::time_t expiryTime,
+    const std::string& url,
+    const std::string& requestMethod,
+    const HttpHeaders& requestHeaders,
+    uint16_t statusCode,
+    const HttpHeaders& responseHeaders,
+    const gsl::span<const std::byte>& responseData) {
+  this->addEntry(
+      key,
+      CacheItem(
+          expiryTime,
+          CacheRequest(HttpHeaders(requestHeaders), requestMethod, url),
+          CacheResponse(
+              statusCode,
+              HttpHeaders(responseHeaders),
+              std::vector<std::byte>(
+                  responseData.begin(),
+                  responseData.end()))));
+
+  return this->_pDatabase->storeEntry(
+      key,
+      expiryTime,
+      url,
+      requestMethod,
+      requestHeaders,
+      statusCode,
+      responseHeaders,
+      responseData);
+}
+
+bool CesiumMemoryCache::prune() {
+  {
+    std::lock_guard<std::mutex> lock(this->_mutex);
+    const std::time_t now = std::time(nullptr);
+    for (auto it = this->_entries.begin(); it != this->_entries.end();) {
+      if (it->item.expiryTime < now) {
+        this->_totalBytes -= it->bytes;
+        this->_entriesByKey.erase(it->key);
+        it = this->_entries.erase(it);
+      } else {
+        ++it;
+      }
+    }
+  }
+
+  return this->_pDatabase->prune();
+}
+
+bool CesiumMemoryCache::clearAll() {
+  {
+    std::lock_guard<std::mutex> lock(this->_mutex);
+    this->_entries.clear();
+    this->_entriesByKey.clear();
+    this->_totalBytes = 0;
+  }
+
+  return this->_pDatabase->clearAll();
+}
+
+void CesiumMemoryCache::addEntry(const std::string& key, CacheItem&& item)
+    const {
+  const int64_t bytes = getItemBytes(key, item);
+  if (bytes > this->_maximumBytes) {
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(this->_mutex);
+
+  auto existing = this->_entriesByKey.find(key);
+  if (existing != this->_entriesByKey.end()) {
+    this->_totalBytes -= existing->second->bytes;
+    this->_entries.erase(existing->second);
+    this->_entriesByKey.erase(existing);
+  }
+
+  this->_entries.push_front(Entry{key, std::move(item), bytes});
+  this->_entriesByKey.emplace(key, this->_entries.begin());
+  this->_totalBytes += bytes;
+
+  while (this->_totalBytes > this->_maximumBytes) {
+    const Entry& oldest = this->_entries.back();
+    this->_totalBytes -= oldest.bytes;
+    this->_entriesByKey.erase(oldest.key);
+    this->_entries.pop_back();
+  }
+}
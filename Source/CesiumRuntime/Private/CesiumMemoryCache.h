@@ -0,0 +1,73 @@
+// Copyright 2020-2021 CesiumGS, Inc. and Contributors
+
+#pragma once
+
+#include "CesiumAsync/CacheItem.h"
+#include "CesiumAsync/ICacheDatabase.h"
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+/**
+ * @brief A cache database that keeps the most recently used responses in
+ * memory in front of another, usually on-disk, cache database.
+ *
+ * Entries are written through to the other database, and entries read from
+ * it are kept in memory too, so that repeated requests for the same response,
+ * such as for tileset.json or tiles that are visited again, are served
+ * without a disk round trip. When the total size of the entries in memory
+ * exceeds the maximum, the least recently used ones are dropped.
+ */
+class CesiumMemoryCache : public CesiumAsync::ICacheDatabase {
+public:
+  /**
+   * @brief Creates the cache.
+   *
+   * @param pDatabase The database in which entries are stored persistently.
+   * @param maximumBytes The maximum number of bytes of responses to keep in
+   * memory.
+   */
+  CesiumMemoryCache(
+      const std::shared_ptr<CesiumAsync::ICacheDatabase>& pDatabase,
+      int64_t maximumBytes);
+
+  virtual std::optional<CesiumAsync::CacheItem>
+  getEntry(const std::string& key) const override;
+
+  virtual bool storeEntry(
+      const std::string& key,
+      std::time_t expiryTime,
+      const std::string& url,
+      const std::string& requestMethod,
+      const CesiumAsync::HttpHeaders& requestHeaders,
+      uint16_t statusCode,
+      const CesiumAsync::HttpHeaders& responseHeaders,
+      const gsl::span<const std::byte>& responseData) override;
+
+  virtual bool prune() override;
+
+  virtual bool clearAll() override;
+
+private:
+  struct Entry {
+    std::string key;
+    CesiumAsync::CacheItem item;
+    int64_t bytes;
+  };
+
+  void addEntry(const std::string& key, CesiumAsync::CacheItem&& item) const;
+
+  std::shared_ptr<CesiumAsync::ICacheDatabase> _pDatabase;
+  int64_t _maximumBytes;
+
+  // The entries in memory, from the most to the least recently used. They
+  // are updated by getEntry, which is const in ICacheDatabase.
+  mutable std::mutex _mutex;
+  mutable std::list<Entry> _entries;
+  mutable std::unordered_map<std::string, std::list<Entry>::iterator>
+      _entriesByKey;
+  mutable int64_t _totalBytes;
+};
@@ -0,0 +1,63 @@
+// Copyright 2020-2021 CesiumGS, Inc. and Contributors
+
+#include "CesiumMemoryPressure.h"
+#include "CesiumRuntime.h"
+#include "CesiumRuntimeSettings.h"
+#include "HAL/PlatformMemory.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/CoreDelegates.h"
+
+namespace {
+// How often, in seconds, the free physical memory is checked against the
+// watermark. Querying it is too slow to do every frame on some platforms.
+constexpr double PollInterval = 1.0;
+} // namespace
+
+FDelegateHandle CesiumMemoryPressure::_trimHandle;
+std::atomic<bool> CesiumMemoryPressure::_signaled{false};
+double CesiumMemoryPressure::_lastSignalTime = -1.0;
+double CesiumMemoryPressure::_lastPollTime = -1.0;
+bool CesiumMemoryPressure::_belowWatermark = false;
+
+void CesiumMemoryPressure::startup() {
+  _trimHandle = FCoreDelegates::GetMemoryTrimDelegate().AddStatic(
+      &CesiumMemoryPressure::onLowMemory);
+}
+
+void CesiumMemoryPressure::shutdown() {
+  FCoreDelegates::GetMemoryTrimDelegate().Remove(_trimHandle);
+  _trimHandle.Reset();
+}
+
+bool CesiumMemoryPressure::isUnderPressure() {
+  const UCesiumRuntimeSettings* pSettings =
+      GetDefault<UCesiumRuntimeSettings>();
+  const double now = FPlatformTime::Seconds();
+
+  if (_signaled.exchange(false)) {
+    if (_lastSignalTime < 0.0 ||
+        now - _lastSignalTime >= pSettings->MemoryPressureDuration) {
+      UE_LOG(
+          LogCesium,
+          Warning,
+          TEXT("Low memory signaled, shrinking Cesium tile caches"));
+    }
+    _lastSignalTime = now;
+  }
+
+  if (pSettings->LowMemoryWatermarkMegabytes <= 0) {
+    _belowWatermark = false;
+  } else if (_lastPollTime < 0.0 || now - _lastPollTime >= PollInterval) {
+    _lastPollTime = now;
+    const uint64 availableMegabytes =
+        FPlatformMemory::GetStats().AvailablePhysical / (1024 * 1024);
+    _belowWatermark =
+        availableMegabytes < uint64(pSettings->LowMemoryWatermarkMegabytes);
+  }
+
+  return _belowWatermark ||
+         (_lastSignalTime >= 0.0 &&
+          now - _lastSignalTime < pSettings->MemoryPressureDuration);
+}
+
+void CesiumMemoryPressure::onLowMemory() { _signaled = true; }
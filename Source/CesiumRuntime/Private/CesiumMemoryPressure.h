@@ -0,0 +1,48 @@
+// Copyright 2020-2021 CesiumGS, Inc. and Contributors
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include <atomic>
+
+/**
+ * Tracks whether the application is low on memory, so that tilesets can
+ * temporarily shrink their caches and pools.
+ *
+ * Memory is considered low for a while after the platform signals it, for
+ * example with a memory warning on iOS or a trim request on Android, and
+ * whenever the free physical memory is below the LowMemoryWatermarkMegabytes
+ * runtime setting.
+ */
+class CesiumMemoryPressure {
+public:
+  /**
+   * Starts listening to the platform's low memory signals. Called when the
+   * module starts up.
+   */
+  static void startup();
+
+  /**
+   * Stops listening to the platform's low memory signals. Called when the
+   * module shuts down.
+   */
+  static void shutdown();
+
+  /**
+   * Whether memory is currently low. Must be called from the game thread.
+   */
+  static bool isUnderPressure();
+
+private:
+  static void onLowMemory();
+
+  static FDelegateHandle _trimHandle;
+
+  // Set by the platform signals, which may arrive on any thread, and cleared
+  // on the game thread once the time of the signal is recorded.
+  static std::atomic<bool> _signaled;
+
+  static double _lastSignalTime;
+  static double _lastPollTime;
+  static bool _belowWatermark;
+};
@@ -0,0 +1,374 @@
+// Copyright 2020-2021 CesiumGS, Inc. and Contributors
+
+#include "CesiumMeshOptimization.h"
+#include "CesiumUtility/Tracing.h"
+#include <algorithm>
+#include <glm/common.hpp>
+#include <glm/geometric.hpp>
+
+namespace {
+
+// The parameters of the scoring function from Tom Forsyth's "Linear-Speed
+// Vertex Cache Optimisation".
+constexpr int32 MaxCacheSize = 32;
+constexpr float CacheDecayPower = 1.5f;
+constexpr float LastTriangleScore = 0.75f;
+constexpr float ValenceBoostScale = 2.0f;
+constexpr float ValenceBoostPower = 0.5f;
+
+// The size of the FIFO cache that is simulated to find the clusters of
+// triangles that are reordered to reduce overdraw.
+constexpr int32 ClusterCacheSize = 16;
+
+float computeVertexScore(int32 cachePosition, uint32 remainingTriangles) {
+  if (remainingTriangles == 0) {
+    // The vertex isn't used by any more triangles.
+    return -1.0f;
+  }
+
+  float score = 0.0f;
+  if (cachePosition >= 0) {
+    if (cachePosition < 3) {
+      // The vertex was used by the last triangle. It gets a fixed score so
+      // that the next triangle doesn't always reuse the most recent edge.
+      score = LastTriangleScore;
+    } else {
+      const float scale = 1.0f / float(MaxCacheSize - 3);
+      score = FMath::Pow(
+          1.0f - float(cachePosition - 3) * scale,
+          CacheDecayPower);
+    }
+  }
+
+  // Vertices with few remaining triangles are boosted, so that they are
+  // finished off rather than left behind as isolated triangles.
+  score += ValenceBoostScale *
+           FMath::Pow(float(remainingTriangles), -ValenceBoostPower);
+  return score;
+}
+
+} // namespace
+
+/*static*/ void CesiumMeshOptimization::optimizeVertexCache(
+    TArray<uint32>& indices,
+    uint32 numVertices) {
+  CESIUM_TRACE("CesiumMeshOptimization::optimizeVertexCache");
+
+  const int32 numTriangles = indices.Num() / 3;
+  if (numTriangles < 2 || numVertices == 0) {
+    return;
+  }
+
+  // Build the list of the triangles that use each vertex.
+  TArray<uint32> remainingTriangles;
+  remainingTriangles.SetNumZeroed(numVertices);
+  for (int32 i = 0; i < numTriangles * 3; ++i) {
+    ++remainingTriangles[indices[i]];
+  }
+
+  TArray<uint32> firstTriangle;
+  firstTriangle.SetNumUninitialized(numVertices);
+  uint32 offset = 0;
+  for (uint32 v = 0; v < numVertices; ++v) {
+    firstTriangle[v] = offset;
+    offset += remainingTriangles[v];
+  }
+
+  TArray<uint32> vertexTriangles;
+  vertexTriangles.SetNumUninitialized(numTriangles * 3);
+  {
+    TArray<uint32> cursor = firstTriangle;
+    for (int32 i = 0; i < numTriangles * 3; ++i) {
+      vertexTriangles[cursor[indices[i]]++] = i / 3;
+    }
+  }
+
+  TArray<float> vertexScores;
+  vertexScores.SetNumUninitialized(numVertices);
+  for (uint32 v = 0; v < numVertices; ++v) {
+    vertexScores[v] = computeVertexScore(-1, remainingTriangles[v]);
+  }
+
+  TArray<float> triangleScores;
+  triangleScores.SetNumUninitialized(numTriangles);
+  int32 bestTriangle = 0;
+  for (int32 t = 0; t < numTriangles; ++t) {
+    triangleScores[t] = vertexScores[indices[t * 3]] +
+                        vertexScores[indices[t * 3 + 1]] +
+                        vertexScores[indices[t * 3 + 2]];
+    if (triangleScores[t] > triangleScores[bestTriangle]) {
+      bestTriangle = t;
+    }
+  }
+
+  TArray<bool> emitted;
+  emitted.Init(false, numTriangles);
+  int32 nextUnemitted = 0;
+
+  TArray<uint32> output;
+  output.Reserve(numTriangles * 3);
+
+  TArray<uint32> cache;
+  TArray<uint32> newCache;
+  cache.Reserve(MaxCacheSize + 3);
+  newCache.Reserve(MaxCacheSize + 3);
+
+  for (int32 emittedCount = 0; emittedCount < numTriangles; ++emittedCount) {
+    if (bestTriangle < 0) {
+      // None of the triangles around the cached vertices remain, so
+      // continue with the next triangle in the original order.
+      while (emitted[nextUnemitted]) {
+        ++nextUnemitted;
+      }
+      bestTriangle = nextUnemitted;
+    }
+
+    const uint32 triangle[3] = {
+        indices[bestTriangle * 3],
+        indices[bestTriangle * 3 + 1],
+        indices[bestTriangle * 3 + 2]};
+    output.Append(triangle, 3);
+    emitted[bestTriangle] = true;
+
+    // Remove the triangle from the remaining triangles of its vertices, and
+    // move the vertices to the front of the cache.
+    newCache.Reset();
+    for (uint32 v : triangle) {
+      uint32* pTriangles = &vertexTriangles[firstTriangle[v]];
+      uint32 count = remainingTriangles[v];
+      for (uint32 j = 0; j < count; ++j) {
+        if (pTriangles[j] == uint32(bestTriangle)) {
+          pTriangles[j] = pTriangles[count - 1];
+          break;
+        }
+      }
+      --remainingTriangles[v];
+      newCache.AddUnique(v);
+    }
+
+    for (uint32 v : cache) {
+      if (v != triangle[0] && v != triangle[1] && v != triangle[2]) {
+        newCache.Add(v);
+      }
+    }
+    Swap(cache, newCache);
+
+    // Update the scores of the vertices that are in the cache, or that have
+    // just fallen out of it, along with the scores of their triangles, and
+    // choose the best of those triangles to emit next.
+    bestTriangle = -1;
+    float bestScore = -1.0f;
+    for (int32 i = 0; i < cache.Num(); ++i) {
+      uint32 v = cache[i];
+      int32 position = i < MaxCacheSize ? i : -1;
+      float score = computeVertexScore(position, remainingTriangles[v]);
+      float delta = score - vertexScores[v];
+      vertexScores[v] = score;
+
+      const uint32* pTriangles = &vertexTriangles[firstTriangle[v]];
+      for (uint32 j = 0; j < remainingTriangles[v]; ++j) {
+        uint32 t = pTriangles[j];
+        triangleScores[t] += delta;
+        if (triangleScores[t] > bestScore) {
+          bestScore = triangleScores[t];
+          bestTriangle = t;
+        }
+      }
+    }
+
+    if (cache.Num() > MaxCacheSize) {
+      cache.SetNum(MaxCacheSize, false);
+    }
+  }
+
+  // Keep any incomplete triangle at the end.
+  for (int32 i = numTriangles * 3; i < indices.Num(); ++i) {
+    output.Add(indices[i]);
+  }
+
+  indices = MoveTemp(output);
+}
+
+/*static*/ void CesiumMeshOptimization::optimizeOverdraw(
+    TArray<uint32>& indices,
+    TFunctionRef<glm::dvec3(uint32)> getPosition) {
+  CESIUM_TRACE("CesiumMeshOptimization::optimizeOverdraw");
+
+  const int32 numTriangles = indices.Num() / 3;
+  if (numTriangles < 2) {
+    return;
+  }
+
+  // A new cluster starts at each triangle whose vertices all miss the
+  // simulated cache.
+  TArray<int32> clusterStarts;
+  {
+    uint32 cache[ClusterCacheSize];
+    std::fill(std::begin(cache), std::end(cache), MAX_uint32);
+    int32 cacheHead = 0;
+
+    for (int32 t = 0; t < numTriangles; ++t) {
+      int32 misses = 0;
+      for (int32 k = 0; k < 3; ++k) {
+        uint32 v = indices[t * 3 + k];
+        if (std::find(std::begin(cache), std::end(cache), v) ==
+            std::end(cache)) {
+          cache[cacheHead] = v;
+          cacheHead = (cacheHead + 1) % ClusterCacheSize;
+          ++misses;
+        }
+      }
+
+      if (t == 0 || misses == 3) {
+        clusterStarts.Add(t);
+      }
+    }
+  }
+
+  if (clusterStarts.Num() < 2) {
+    return;
+  }
+
+  glm::dvec3 meshCentroid(0.0);
+  for (int32 i = 0; i < numTriangles * 3; ++i) {
+    meshCentroid += getPosition(indices[i]);
+  }
+  meshCentroid /= double(numTriangles * 3);
+
+  // Clusters that face away from the center of the mesh are more likely to
+  // occlude the rest of it, so they're sorted to be drawn first.
+  struct Cluster {
+    int32 firstTriangle;
+    int32 numTriangles;
+    double sortKey;
+  };
+
+  TArray<Cluster> clusters;
+  clusters.Reserve(clusterStarts.Num());
+  for (int32 i = 0; i < clusterStarts.Num(); ++i) {
+    Cluster& cluster = clusters.AddDefaulted_GetRef();
+    cluster.firstTriangle = clusterStarts[i];
+    cluster.numTriangles =
+        (i + 1 < clusterStarts.Num() ? clusterStarts[i + 1] : numTriangles) -
+        cluster.firstTriangle;
+
+    glm::dvec3 centroid(0.0);
+    glm::dvec3 normal(0.0);
+    for (int32 t = cluster.firstTriangle;
+         t < cluster.firstTriangle + cluster.numTriangles;
+         ++t) {
+      glm::dvec3 a = getPosition(indices[t * 3]);
+      glm::dvec3 b = getPosition(indices[t * 3 + 1]);
+      glm::dvec3 c = getPosition(indices[t * 3 + 2]);
+      centroid += a + b + c;
+      normal += glm::cross(b - a, c - a);
+    }
+    centroid /= double(cluster.numTriangles * 3);
+
+    double length = glm::length(normal);
+    cluster.sortKey =
+        length > 0.0 ? glm::dot(centroid - meshCentroid, normal / length)
+                     : 0.0;
+  }
+
+  std::stable_sort(
+      clusters.GetData(),
+      clusters.GetData() + clusters.Num(),
+      [](const Cluster& lhs, const Cluster& rhs) {
+        return lhs.sortKey > rhs.sortKey;
+      });
+
+  TArray<uint32> output;
+  output.Reserve(indices.Num());
+  for (const Cluster& cluster : clusters) {
+    output.Append(
+        &indices[cluster.firstTriangle * 3],
+        cluster.numTriangles * 3);
+  }
+
+  // Keep any incomplete triangle at the end.
+  for (int32 i = numTriangles * 3; i < indices.Num(); ++i) {
+    output.Add(indices[i]);
+  }
+
+  indices = MoveTemp(output);
+}
+
+/*static*/ TArray<uint32> CesiumMeshOptimization::optimizeVertexFetch(
+    TArray<uint32>& indices,
+    uint32 numVertices) {
+  CESIUM_TRACE("CesiumMeshOptimization::optimizeVertexFetch");
+
+  TArray<uint32> newIndices;
+  newIndices.Init(MAX_uint32, numVertices);
+
+  TArray<uint32> originalIndices;
+  originalIndices.Reserve(numVertices);
+
+  for (uint32& index : indices) {
+    uint32& newIndex = newIndices[index];
+    if (newIndex == MAX_uint32) {
+      newIndex = originalIndices.Num();
+      originalIndices.Add(index);
+    }
+    index = newIndex;
+  }
+
+  return originalIndices;
+}
+
+/*static*/ TArray<uint32> CesiumMeshOptimization::simplifyByVertexClustering(
+    TArray<uint32>& indices,
+    uint32 numVertices,
+    TFunctionRef<glm::dvec3(uint32)> getPosition,
+    double cellSize) {
+  CESIUM_TRACE("CesiumMeshOptimization::simplifyByVertexClustering");
+
+  using CellKey = TTuple<int64, int64, int64>;
+
+  // The new index of each original vertex, which is the new index of the
+  // vertex that represents its cell.
+  TArray<uint32> newIndices;
+  newIndices.Init(MAX_uint32, numVertices);
+
+  TMap<CellKey, uint32> cells;
+  TArray<uint32> originalIndices;
+
+  const int32 numTriangles = indices.Num() / 3;
+  for (int32 i = 0; i < numTriangles * 3; ++i) {
+    uint32 index = indices[i];
+    if (newIndices[index] != MAX_uint32) {
+      continue;
+    }
+
+    glm::dvec3 cell = glm::floor(getPosition(index) / cellSize);
+    CellKey key(int64(cell.x), int64(cell.y), int64(cell.z));
+    uint32* pCellIndex = cells.Find(key);
+    if (pCellIndex) {
+      newIndices[index] = *pCellIndex;
+    } else {
+      newIndices[index] = originalIndices.Num();
+      cells.Add(key, newIndices[index]);
+      originalIndices.Add(index);
+    }
+  }
+
+  TArray<uint32> output;
+  output.Reserve(numTriangles * 3);
+  for (int32 t = 0; t < numTriangles; ++t) {
+    uint32 a = newIndices[indices[t * 3]];
+    uint32 b = newIndices[indices[t * 3 + 1]];
+    uint32 c = newIndices[indices[t * 3 + 2]];
+    if (a != b && b != c && a != c) {
+      output.Add(a);
+      output.Add(b);
+      output.Add(c);
+    }
+  }
+
+  indices = MoveTemp(output);
+
+  // Vertices whose triangles all collapsed are still included, and are
+  // simply not referenced by any triangle.
+  return originalIndices;
+}
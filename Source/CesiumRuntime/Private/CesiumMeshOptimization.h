@@ -0,0 +1,80 @@
+// Copyright 2020-2021 CesiumGS, Inc. and Contributors
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Templates/Function.h"
+#include <glm/vec3.hpp>
+
+/**
+ * @brief Functions that reorder the triangles and vertices of an indexed
+ * triangle list to make it faster to render.
+ *
+ * All of the functions take triangle list indices that are already known to be
+ * less than the number of vertices, and preserve the winding order of every
+ * triangle.
+ */
+class CesiumMeshOptimization {
+public:
+  /**
+   * @brief Reorders the triangles so that vertices shared by nearby triangles
+   * are more likely to be found in the GPU's post-transform vertex cache.
+   *
+   * This is Tom Forsyth's linear-speed vertex cache optimization, which does
+   * not depend on the exact size of the cache.
+   *
+   * @param indices The triangle list indices, which are reordered in place.
+   * @param numVertices The number of vertices.
+   */
+  static void optimizeVertexCache(TArray<uint32>& indices, uint32 numVertices);
+
+  /**
+   * @brief Reorders clusters of triangles so that those facing outward from the
+   * center of the mesh are drawn first, so that fewer pixels are shaded only
+   * to be hidden later.
+   *
+   * The clusters are the runs of triangles that start with a complete vertex
+   * cache miss, so this mostly preserves the vertex cache efficiency of a
+   * previous call to optimizeVertexCache.
+   *
+   * @param indices The triangle list indices, which are reordered in place.
+   * @param getPosition Gets the position of the vertex with the given index.
+   */
+  static void optimizeOverdraw(
+      TArray<uint32>& indices,
+      TFunctionRef<glm::dvec3(uint32)> getPosition);
+
+  /**
+   * @brief Renumbers the vertices in the order they are first used by the
+   * triangles, so that the vertex data is fetched sequentially. Vertices that
+   * are not used by any triangle are dropped.
+   *
+   * @param indices The triangle list indices, which are renumbered in place.
+   * @param numVertices The number of vertices.
+   * @return The original index of each renumbered vertex.
+   */
+  static TArray<uint32>
+  optimizeVertexFetch(TArray<uint32>& indices, uint32 numVertices);
+
+  /**
+   * @brief Simplifies the triangles by merging all of the vertices that fall
+   * in the same cell of a uniform grid, and removing the triangles that
+   * collapse as a result.
+   *
+   * Each cell is represented by one of its vertices, so no vertex moves by
+   * more than the length of the diagonal of a cell. Like optimizeVertexFetch,
+   * the remaining vertices are renumbered in the order they are first used.
+   *
+   * @param indices The triangle list indices, which are replaced by the
+   * indices of the simplified triangles.
+   * @param numVertices The number of vertices.
+   * @param getPosition Gets the position of the vertex with the given index.
+   * @param cellSize The size of the grid cells, in the units of the positions.
+   * @return The original index of each remaining vertex.
+   */
+  static TArray<uint32> simplifyByVertexClustering(
+      TArray<uint32>& indices,
+      uint32 numVertices,
+      TFunctionRef<glm::dvec3(uint32)> getPosition,
+      double cellSize);
+};
@@ -0,0 +1,737 @@
+// Copyright 2020-2021 CesiumGS, Inc. and Contributors
+
+#include "CesiumMeshoptDecoder.h"
+#include "CesiumGltf/Model.h"
+#include "CesiumRuntime.h"
+#include "CesiumUtility/JsonValue.h"
+#include "CesiumUtility/Tracing.h"
+#include <cmath>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace {
+
+// The first byte of each encoding, whose low four bits are its version.
+constexpr uint8 VertexHeader = 0xa0;
+constexpr uint8 IndexHeader = 0xe0;
+constexpr uint8 SequenceHeader = 0xd0;
+
+// Vertices are encoded in blocks of at most this many bytes or vertices, and
+// each byte of their attributes in groups of 16.
+constexpr size_t VertexBlockSizeBytes = 8192;
+constexpr size_t VertexBlockMaxSize = 256;
+constexpr size_t ByteGroupSize = 16;
+
+// The most bytes that a group of bytes is encoded in, which the tail of the
+// encoding guarantees can be read after any group.
+constexpr size_t ByteGroupDecodeLimit = 24;
+
+// The smallest tail of a vertex encoding.
+constexpr size_t TailMaxSize = 32;
+
+size_t getVertexBlockSize(size_t vertexSize) {
+  size_t result = VertexBlockSizeBytes / vertexSize;
+  result &= ~(ByteGroupSize - 1);
+  return result < VertexBlockMaxSize ? result : VertexBlockMaxSize;
+}
+
+uint8 unzigzag8(uint8 v) { return uint8(-(v & 1) ^ (v >> 1)); }
+
+/**
+ * Decodes a group of 16 bytes, each encoded in the given number of bits, in
+ * which the largest value means that the byte follows the group in full.
+ */
+const uint8* decodeBytesGroup(const uint8* data, uint8* buffer, int32 bits) {
+  if (bits == 0) {
+    FMemory::Memzero(buffer, ByteGroupSize);
+    return data;
+  }
+  if (bits == 8) {
+    FMemory::Memcpy(buffer, data, ByteGroupSize);
+    return data + ByteGroupSize;
+  }
+
+  const int32 valuesPerByte = 8 / bits;
+  const uint8 sentinel = uint8((1 << bits) - 1);
+  const uint8* dataVariable = data + ByteGroupSize / valuesPerByte;
+  for (size_t i = 0; i < ByteGroupSize; i += valuesPerByte) {
+    uint8 byte = *data++;
+    for (int32 j = 0; j < valuesPerByte; ++j) {
+      const uint8 encoded = uint8(byte >> (8 - bits));
+      byte = uint8(byte << bits);
+      if (encoded == sentinel) {
+        *buffer++ = *dataVariable++;
+      } else {
+        *buffer++ = encoded;
+      }
+    }
+  }
+  return dataVariable;
+}
+
+const uint8* decodeBytes(
+    const uint8* data,
+    const uint8* dataEnd,
+    uint8* buffer,
+    size_t bufferSize) {
+  // Two bits for each group give its size: 0, 2, 4 or 8 bits per byte.
+  const size_t headerSize = (bufferSize / ByteGroupSize + 3) / 4;
+  if (size_t(dataEnd - data) < headerSize) {
+    return nullptr;
+  }
+
+  const uint8* header = data;
+  data += headerSize;
+  for (size_t i = 0; i < bufferSize; i += ByteGroupSize) {
+    if (size_t(dataEnd - data) < ByteGroupDecodeLimit) {
+      return nullptr;
+    }
+    const size_t headerOffset = i / ByteGroupSize;
+    const int32 bitsLog2 =
+        (header[headerOffset / 4] >> ((headerOffset % 4) * 2)) & 3;
+    const int32 bits = bitsLog2 == 0 ? 0 : 1 << bitsLog2;
+    data = decodeBytesGroup(data, buffer + i, bits);
+  }
+  return data;
+}
+
+/**
+ * Decodes a block of vertices, whose bytes are stored one byte of the
+ * vertex at a time as deltas from the same byte of the previous vertex.
+ */
+const uint8* decodeVertexBlock(
+    const uint8* data,
+    const uint8* dataEnd,
+    uint8* vertexData,
+    size_t vertexCount,
+    size_t vertexSize,
+    uint8* lastVertex) {
+  uint8 buffer[VertexBlockMaxSize];
+  uint8 transposed[VertexBlockSizeBytes];
+
+  const size_t vertexCountAligned =
+      (vertexCount + ByteGroupSize - 1) & ~(ByteGroupSize - 1);
+  for (size_t k = 0; k < vertexSize; ++k) {
+    data = decodeBytes(data, dataEnd, buffer, vertexCountAligned);
+    if (!data) {
+      return nullptr;
+    }
+
+    size_t vertexOffset = k;
+    uint8 previous = lastVertex[k];
+    for (size_t i = 0; i < vertexCount; ++i) {
+      const uint8 value = uint8(unzigzag8(buffer[i]) + previous);
+      transposed[vertexOffset] = value;
+      previous = value;
+      vertexOffset += vertexSize;
+    }
+  }
+
+  FMemory::Memcpy(vertexData, transposed, vertexCount * vertexSize);
+  FMemory::Memcpy(
+      lastVertex,
+      &transposed[vertexSize * (vertexCount - 1)],
+      vertexSize);
+  return data;
+}
+
+uint32 decodeVByte(const uint8*& data) {
+  const uint8 lead = *data++;
+  if (lead < 128) {
+    return lead;
+  }
+
+  // Each following byte holds seven more bits, and the last one is < 128.
+  uint32 result = lead & 127;
+  uint32 shift = 7;
+  for (int32 i = 0; i < 4; ++i) {
+    const uint8 group = *data++;
+    result |= uint32(group & 127) << shift;
+    shift += 7;
+    if (group < 128) {
+      break;
+    }
+  }
+  return result;
+}
+
+uint32 decodeIndex(const uint8*& data, uint32 last) {
+  const uint32 v = decodeVByte(data);
+  const uint32 delta = (v >> 1) ^ uint32(-int32(v & 1));
+  return last + delta;
+}
+
+void writeIndex(uint8* destination, size_t i, size_t indexSize, uint32 index) {
+  if (indexSize == 2) {
+    const uint16 value = uint16(index);
+    FMemory::Memcpy(destination + i * 2, &value, 2);
+  } else {
+    FMemory::Memcpy(destination + i * 4, &index, 4);
+  }
+}
+
+void writeTriangle(
+    uint8* destination,
+    size_t i,
+    size_t indexSize,
+    uint32 a,
+    uint32 b,
+    uint32 c) {
+  writeIndex(destination, i, indexSize, a);
+  writeIndex(destination, i + 1, indexSize, b);
+  writeIndex(destination, i + 2, indexSize, c);
+}
+
+// The recently used edges and vertices of the triangle codec. They must be
+// updated exactly like the encoder updates them.
+struct IndexFifos {
+  uint32 edges[16][2];
+  uint32 vertices[16];
+  uint32 edgeOffset = 0;
+  uint32 vertexOffset = 0;
+
+  IndexFifos() {
+    FMemory::Memset(this->edges, 0xff, sizeof(this->edges));
+    FMemory::Memset(this->vertices, 0xff, sizeof(this->vertices));
+  }
+
+  void pushEdge(uint32 a, uint32 b) {
+    this->edges[this->edgeOffset][0] = a;
+    this->edges[this->edgeOffset][1] = b;
+    this->edgeOffset = (this->edgeOffset + 1) & 15;
+  }
+
+  void pushVertex(uint32 v, bool condition = true) {
+    this->vertices[this->vertexOffset] = v;
+    this->vertexOffset = (this->vertexOffset + (condition ? 1 : 0)) & 15;
+  }
+};
+
+template <typename T> void decodeFilterOctahedral(T* data, size_t count) {
+  const float maximum = float((1 << (sizeof(T) * 8 - 1)) - 1);
+  for (size_t i = 0; i < count; ++i) {
+    // z is reconstructed from x and y, as it encodes 1 at the same precision.
+    float x = float(data[i * 4 + 0]);
+    float y = float(data[i * 4 + 1]);
+    float z = float(data[i * 4 + 2]) - std::fabs(x) - std::fabs(y);
+
+    // The lower hemisphere is folded onto the upper one.
+    const float t = z < 0.0f ? z : 0.0f;
+    x += x >= 0.0f ? t : -t;
+    y += y >= 0.0f ? t : -t;
+
+    const float length = std::sqrt(x * x + y * y + z * z);
+    const float scale = maximum / length;
+    data[i * 4 + 0] = T(int32(x * scale + (x >= 0.0f ? 0.5f : -0.5f)));
+    data[i * 4 + 1] = T(int32(y * scale + (y >= 0.0f ? 0.5f : -0.5f)));
+    data[i * 4 + 2] = T(int32(z * scale + (z >= 0.0f ? 0.5f : -0.5f)));
+  }
+}
+
+void decodeFilterQuaternion(int16* data, size_t count) {
+  const float scale = 1.0f / std::sqrt(2.0f);
+  for (size_t i = 0; i < count; ++i) {
+    // The high bits of the last component are the scale of the other three,
+    // and its two low bits the index of the largest component, which is
+    // reconstructed from them.
+    const int32 scaleBits = data[i * 4 + 3] | 3;
+    const float componentScale = scale / float(scaleBits);
+    const float x = float(data[i * 4 + 0]) * componentScale;
+    const float y = float(data[i * 4 + 1]) * componentScale;
+    const float z = float(data[i * 4 + 2]) * componentScale;
+    const float ww = 1.0f - x * x - y * y - z * z;
+    const float w = std::sqrt(ww >= 0.0f ? ww : 0.0f);
+
+    const int32 xf = int32(x * 32767.0f + (x >= 0.0f ? 0.5f : -0.5f));
+    const int32 yf = int32(y * 32767.0f + (y >= 0.0f ? 0.5f : -0.5f));
+    const int32 zf = int32(z * 32767.0f + (z >= 0.0f ? 0.5f : -0.5f));
+    const int32 wf = int32(w * 32767.0f + 0.5f);
+
+    const int32 largest = data[i * 4 + 3] & 3;
+    data[i * 4 + ((largest + 1) & 3)] = int16(xf);
+    data[i * 4 + ((largest + 2) & 3)] = int16(yf);
+    data[i * 4 + ((largest + 3) & 3)] = int16(zf);
+    data[i * 4 + ((largest + 0) & 3)] = int16(wf);
+  }
+}
+
+void decodeFilterExponential(uint32* data, size_t count) {
+  for (size_t i = 0; i < count; ++i) {
+    // A 24-bit signed mantissa and an 8-bit signed exponent.
+    const uint32 v = data[i];
+    const int32 mantissa = int32(v << 8) >> 8;
+    const int32 exponent = int32(v) >> 24;
+    const float value = std::ldexp(float(mantissa), exponent);
+    FMemory::Memcpy(&data[i], &value, 4);
+  }
+}
+
+const CesiumUtility::JsonValue*
+findMember(const CesiumUtility::JsonValue::Object& object, const char* name) {
+  auto it = object.find(name);
+  return it != object.end() ? &it->second : nullptr;
+}
+
+// The largest integer that a JSON number holds exactly.
+constexpr double MaximumSafeInteger = 9007199254740992.0;
+
+/**
+ * Gets a non-negative integer member of a JSON object, the default value if
+ * it is missing, or -1 if it isn't a non-negative integer or is too large to
+ * be held exactly, which the callers reject.
+ */
+int64 getInteger(
+    const CesiumUtility::JsonValue::Object& object,
+    const char* name,
+    int64 defaultValue) {
+  const CesiumUtility::JsonValue* pValue = findMember(object, name);
+  if (!pValue) {
+    return defaultValue;
+  }
+  const double value = pValue->getSafeNumberOrDefault<double>(-1.0);
+  if (!(value >= 0.0 && value <= MaximumSafeInteger) ||
+      std::floor(value) != value) {
+    return -1;
+  }
+  return int64(value);
+}
+
+/**
+ * Whether a buffer is marked by EXT_meshopt_compression as a fallback, whose
+ * data is only meant for the clients that can't decode the buffer views.
+ */
+bool isFallbackBuffer(const CesiumGltf::Buffer& buffer) {
+  const CesiumUtility::JsonValue* pExtension =
+      buffer.getGenericExtension("EXT_meshopt_compression");
+  const CesiumUtility::JsonValue::Object* pObject =
+      pExtension
+          ? std::get_if<CesiumUtility::JsonValue::Object>(&pExtension->value)
+          : nullptr;
+  const CesiumUtility::JsonValue* pFallback =
+      pObject ? findMember(*pObject, "fallback") : nullptr;
+  const bool* pBool =
+      pFallback ? std::get_if<bool>(&pFallback->value) : nullptr;
+  return pBool && *pBool;
+}
+
+std::string getString(
+    const CesiumUtility::JsonValue::Object& object,
+    const char* name,
+    const char* defaultValue) {
+  const CesiumUtility::JsonValue* pValue = findMember(object, name);
+  const std::string* pString =
+      pValue ? std::get_if<std::string>(&pValue->value) : nullptr;
+  return pString ? *pString : std::string(defaultValue);
+}
+
+bool applyFilter(
+    const std::string& filter,
+    std::byte* pData,
+    size_t count,
+    size_t stride) {
+  if (filter == "NONE") {
+    return true;
+  }
+  if (filter == "OCTAHEDRAL" && stride == 4) {
+    decodeFilterOctahedral(reinterpret_cast<int8*>(pData), count);
+    return true;
+  }
+  if (filter == "OCTAHEDRAL" && stride == 8) {
+    decodeFilterOctahedral(reinterpret_cast<int16*>(pData), count);
+    return true;
+  }
+  if (filter == "QUATERNION" && stride == 8) {
+    decodeFilterQuaternion(reinterpret_cast<int16*>(pData), count);
+    return true;
+  }
+  if (filter == "EXPONENTIAL" && stride % 4 == 0) {
+    decodeFilterExponential(
+        reinterpret_cast<uint32*>(pData),
+        count * stride / 4);
+    return true;
+  }
+  return false;
+}
+
+/**
+ * Decodes one compressed buffer view into its buffer, or returns false with
+ * a reason if it can't be decoded.
+ */
+bool decodeBufferView(
+    CesiumGltf::Model& model,
+    const CesiumGltf::BufferView& bufferView,
+    const CesiumUtility::JsonValue::Object& extension,
+    const TCHAR*& reason) {
+  const int64 sourceBufferIndex = getInteger(extension, "buffer", -1);
+  const int64 sourceOffset = getInteger(extension, "byteOffset", 0);
+  const int64 sourceLength = getInteger(extension, "byteLength", -1);
+  const int64 stride = getInteger(extension, "byteStride", -1);
+  const int64 count = getInteger(extension, "count", -1);
+  const std::string mode = getString(extension, "mode", "");
+  const std::string filter = getString(extension, "filter", "NONE");
+
+  if (sourceBufferIndex < 0 ||
+      sourceBufferIndex >= int64(model.buffers.size()) || sourceOffset < 0 ||
+      sourceLength < 0 || stride <= 0 || count < 0) {
+    reason = TEXT("invalid extension properties");
+    return false;
+  }
+  const std::vector<std::byte>& source =
+      model.buffers[size_t(sourceBufferIndex)].cesium.data;
+  // The properties are at most 2^53, so their sum doesn't overflow.
+  if (sourceOffset + sourceLength > int64(source.size())) {
+    reason = TEXT("the compressed data is out of range");
+    return false;
+  }
+
+  // The decoded data must fit in the buffer view, which must fit in the
+  // buffer it is decoded into, so that a few bytes of compressed data can't
+  // make it allocate an arbitrary amount of memory.
+  if (bufferView.buffer < 0 ||
+      bufferView.buffer >= int32_t(model.buffers.size()) ||
+      bufferView.byteOffset < 0 || bufferView.byteLength < 0 ||
+      count > bufferView.byteLength / stride) {
+    reason = TEXT("invalid buffer view");
+    return false;
+  }
+
+  CesiumGltf::Buffer& buffer = model.buffers[size_t(bufferView.buffer)];
+  if (bufferView.byteOffset > buffer.byteLength ||
+      bufferView.byteLength > buffer.byteLength - bufferView.byteOffset) {
+    reason = TEXT("the buffer view is out of range");
+    return false;
+  }
+  std::vector<std::byte>& destination = buffer.cesium.data;
+  if (buffer.byteLength > int64(destination.size())) {
+    destination.resize(size_t(buffer.byteLength));
+  }
+
+  // The source may be in the same buffer, which resizing may have moved.
+  const std::byte* pSource =
+      model.buffers[size_t(sourceBufferIndex)].cesium.data.data() +
+      sourceOffset;
+  std::byte* pDestination = destination.data() + bufferView.byteOffset;
+
+  bool decoded = false;
+  if (mode == "ATTRIBUTES") {
+    decoded = stride % 4 == 0 && stride <= int64(VertexBlockMaxSize) &&
+              CesiumMeshoptDecoder::decodeVertexBuffer(
+                  pDestination,
+                  size_t(count),
+                  size_t(stride),
+                  pSource,
+                  size_t(sourceLength));
+    if (decoded &&
+        !applyFilter(filter, pDestination, size_t(count), size_t(stride))) {
+      reason = TEXT("unsupported filter");
+      return false;
+    }
+  } else if (mode == "TRIANGLES") {
+    decoded = (stride == 2 || stride == 4) && count % 3 == 0 &&
+              CesiumMeshoptDecoder::decodeIndexBuffer(
+                  pDestination,
+                  size_t(count),
+                  size_t(stride),
+                  pSource,
+                  size_t(sourceLength));
+  } else if (mode == "INDICES") {
+    decoded = (stride == 2 || stride == 4) &&
+              CesiumMeshoptDecoder::decodeIndexSequence(
+                  pDestination,
+                  size_t(count),
+                  size_t(stride),
+                  pSource,
+                  size_t(sourceLength));
+  } else {
+    reason = TEXT("unsupported mode");
+    return false;
+  }
+
+  if (!decoded) {
+    reason = TEXT("invalid compressed data");
+  }
+  return decoded;
+}
+
+} // namespace
+
+int32 CesiumMeshoptDecoder::decodeModel(CesiumGltf::Model& model) {
+  CESIUM_TRACE("CesiumMeshoptDecoder::decodeModel");
+
+  // Buffers are decoded into in place, so which of them need decoding is
+  // decided before the first one gets data.
+  std::vector<bool> decodeInto(model.buffers.size());
+  for (size_t i = 0; i < model.buffers.size(); ++i) {
+    const CesiumGltf::Buffer& buffer = model.buffers[i];
+    decodeInto[i] = isFallbackBuffer(buffer) ||
+                    int64(buffer.cesium.data.size()) < buffer.byteLength;
+  }
+
+  int32 decodedCount = 0;
+  for (size_t i = 0; i < model.bufferViews.size(); ++i) {
+    CesiumGltf::BufferView& bufferView = model.bufferViews[i];
+    const CesiumUtility::JsonValue* pExtension =
+        bufferView.getGenericExtension("EXT_meshopt_compression");
+    const CesiumUtility::JsonValue::Object* pObject =
+        pExtension ? std::get_if<CesiumUtility::JsonValue::Object>(
+                         &pExtension->value)
+                   : nullptr;
+    if (!pObject) {
+      continue;
+    }
+
+    // An uncompressed fallback is used as it is.
+    const bool hasData = bufferView.buffer >= 0 &&
+                         bufferView.buffer < int32_t(decodeInto.size()) &&
+                         !decodeInto[size_t(bufferView.buffer)];
+    if (!hasData) {
+      const TCHAR* reason = TEXT("");
+      if (decodeBufferView(model, bufferView, *pObject, reason)) {
+        ++decodedCount;
+      } else {
+        UE_LOG(
+            LogCesium,
+            Warning,
+            TEXT("Could not decode EXT_meshopt_compression buffer view %d: %s"),
+            int32(i),
+            reason);
+      }
+    }
+
+    // The model is decoded only once, even if it is prepared again.
+    bufferView.extensions.erase("EXT_meshopt_compression");
+  }
+  return decodedCount;
+}
+
+bool CesiumMeshoptDecoder::decodeVertexBuffer(
+    std::byte* pDestination,
+    size_t vertexCount,
+    size_t vertexSize,
+    const std::byte* pData,
+    size_t dataSize) {
+  if (vertexSize == 0 || vertexSize > VertexBlockMaxSize ||
+      vertexSize % 4 != 0) {
+    return false;
+  }
+
+  const uint8* data = reinterpret_cast<const uint8*>(pData);
+  const uint8* dataEnd = data + dataSize;
+  uint8* vertexData = reinterpret_cast<uint8*>(pDestination);
+
+  if (dataSize < 1 || data[0] != VertexHeader) {
+    return false;
+  }
+  ++data;
+
+  // The tail holds the vertex that the first one is a delta from.
+  const size_t tailSize = vertexSize < TailMaxSize ? TailMaxSize : vertexSize;
+  if (size_t(dataEnd - data) < tailSize) {
+    return false;
+  }
+
+  uint8 lastVertex[VertexBlockMaxSize];
+  FMemory::Memcpy(lastVertex, dataEnd - vertexSize, vertexSize);
+
+  const size_t blockSize = getVertexBlockSize(vertexSize);
+  for (size_t offset = 0; offset < vertexCount; offset += blockSize) {
+    const size_t count = FMath::Min(blockSize, vertexCount - offset);
+    data = decodeVertexBlock(
+        data,
+        dataEnd,
+        vertexData + offset * vertexSize,
+        count,
+        vertexSize,
+        lastVertex);
+    if (!data) {
+      return false;
+    }
+  }
+
+  return size_t(dataEnd - data) == tailSize;
+}
+
+bool CesiumMeshoptDecoder::decodeIndexBuffer(
+    std::byte* pDestination,
+    size_t indexCount,
+    size_t indexSize,
+    const std::byte* pData,
+    size_t dataSize) {
+  if (indexCount % 3 != 0 || (indexSize != 2 && indexSize != 4)) {
+    return false;
+  }
+
+  // The smallest encoding has a header, a byte for each triangle and a table
+  // of 16 bytes.
+  const uint8* buffer = reinterpret_cast<const uint8*>(pData);
+  if (dataSize < 1 + indexCount / 3 + 16 ||
+      (buffer[0] & 0xf0) != IndexHeader) {
+    return false;
+  }
+  const int32 version = buffer[0] & 0x0f;
+  if (version > 1) {
+    return false;
+  }
+
+  uint8* destination = reinterpret_cast<uint8*>(pDestination);
+  IndexFifos fifos;
+  uint32 next = 0;
+  uint32 last = 0;
+
+  // Version 1 encodes the next free index as the last one plus or minus
+  // one with the codes 13 and 14.
+  const int32 maximumVertexCode = version >= 1 ? 13 : 15;
+
+  const uint8* code = buffer + 1;
+  const uint8* data = code + indexCount / 3;
+  const uint8* dataSafeEnd = buffer + dataSize - 16;
+  const uint8* codeAuxTable = dataSafeEnd;
+
+  for (size_t i = 0; i < indexCount; i += 3) {
+    // A triangle reads at most 16 bytes, which the table guarantees exist.
+    if (data > dataSafeEnd) {
+      return false;
+    }
+
+    const uint8 codeTriangle = *code++;
+    if (codeTriangle < 0xf0) {
+      // The triangle shares a recent edge.
+      const int32 edge = codeTriangle >> 4;
+      const uint32 a = fifos.edges[(fifos.edgeOffset - 1 - edge) & 15][0];
+      const uint32 b = fifos.edges[(fifos.edgeOffset - 1 - edge) & 15][1];
+      const int32 vertexCode = codeTriangle & 15;
+
+      if (vertexCode < maximumVertexCode) {
+        const uint32 c =
+            vertexCode == 0
+                ? next
+                : fifos.vertices[(fifos.vertexOffset - 1 - vertexCode) & 15];
+        const bool isNext = vertexCode == 0;
+        next += isNext ? 1 : 0;
+
+        writeTriangle(destination, i, indexSize, a, b, c);
+        fifos.pushVertex(c, isNext);
+        fifos.pushEdge(c, b);
+        fifos.pushEdge(a, c);
+      } else {
+        // 13 and 14 decode to -1 and 1, and 15 to an explicit delta.
+        const uint32 c =
+            vertexCode != 15
+                ? last + uint32(vertexCode - (vertexCode ^ 3))
+                : decodeIndex(data, last);
+        last = c;
+
+        writeTriangle(destination, i, indexSize, a, b, c);
+        fifos.pushVertex(c);
+        fifos.pushEdge(c, b);
+        fifos.pushEdge(a, c);
+      }
+    } else if (codeTriangle < 0xfe) {
+      // The triangle's vertex codes are in the table.
+      const uint8 codeAux = codeAuxTable[codeTriangle & 15];
+      const int32 codeB = codeAux >> 4;
+      const int32 codeC = codeAux & 15;
+
+      const uint32 a = next++;
+      const uint32 b =
+          codeB == 0 ? next
+                     : fifos.vertices[(fifos.vertexOffset - codeB) & 15];
+      next += codeB == 0 ? 1 : 0;
+      const uint32 c =
+          codeC == 0 ? next
+                     : fifos.vertices[(fifos.vertexOffset - codeC) & 15];
+      next += codeC == 0 ? 1 : 0;
+
+      writeTriangle(destination, i, indexSize, a, b, c);
+      fifos.pushVertex(a);
+      fifos.pushVertex(b, codeB == 0);
+      fifos.pushVertex(c, codeC == 0);
+      fifos.pushEdge(b, a);
+      fifos.pushEdge(c, b);
+      fifos.pushEdge(a, c);
+    } else {
+      // The triangle's vertex codes follow in a full byte.
+      const uint8 codeAux = *data++;
+      const int32 codeA = codeTriangle == 0xfe ? 0 : 15;
+      const int32 codeB = codeAux >> 4;
+      const int32 codeC = codeAux & 15;
+
+      // A zero byte restarts the numbering of the vertices.
+      if (codeAux == 0) {
+        next = 0;
+      }
+
+      uint32 a = codeA == 0 ? next++ : 0;
+      uint32 b = codeB == 0
+                     ? next++
+                     : fifos.vertices[(fifos.vertexOffset - codeB) & 15];
+      uint32 c = codeC == 0
+                     ? next++
+                     : fifos.vertices[(fifos.vertexOffset - codeC) & 15];
+
+      if (codeA == 15) {
+        last = a = decodeIndex(data, last);
+      }
+      if (codeB == 15) {
+        last = b = decodeIndex(data, last);
+      }
+      if (codeC == 15) {
+        last = c = decodeIndex(data, last);
+      }
+
+      writeTriangle(destination, i, indexSize, a, b, c);
+      fifos.pushVertex(a);
+      fifos.pushVertex(b, codeB == 0 || codeB == 15);
+      fifos.pushVertex(c, codeC == 0 || codeC == 15);
+      fifos.pushEdge(b, a);
+      fifos.pushEdge(c, b);
+      fifos.pushEdge(a, c);
+    }
+  }
+
+  // All of the data must have been read, up to the table.
+  return data == dataSafeEnd;
+}
+
+bool CesiumMeshoptDecoder::decodeIndexSequence(
+    std::byte* pDestination,
+    size_t indexCount,
+    size_t indexSize,
+    const std::byte* pData,
+    size_t dataSize) {
+  if (indexSize != 2 && indexSize != 4) {
+    return false;
+  }
+
+  // The smallest encoding has a header, a byte for each index and a tail of
+  // four bytes.
+  const uint8* buffer = reinterpret_cast<const uint8*>(pData);
+  if (dataSize < 1 + indexCount + 4 || (buffer[0] & 0xf0) != SequenceHeader ||
+      (buffer[0] & 0x0f) > 1) {
+    return false;
+  }
+
+  uint8* destination = reinterpret_cast<uint8*>(pDestination);
+  const uint8* data = buffer + 1;
+  const uint8* dataSafeEnd = buffer + dataSize - 4;
+
+  // Each index is a delta from the last of one of two baselines.
+  uint32 last[2] = {0, 0};
+  for (size_t i = 0; i < indexCount; ++i) {
+    // An index reads at most five bytes, which the tail guarantees exist.
+    if (data >= dataSafeEnd) {
+      return false;
+    }
+
+    uint32 v = decodeVByte(data);
+    const uint32 baseline = v & 1;
+    v >>= 1;
+    const uint32 delta = (v >> 1) ^ uint32(-int32(v & 1));
+    const uint32 index = last[baseline] + delta;
+    last[baseline] = index;
+    writeIndex(destination, i, indexSize, index);
+  }
+
+  return data == dataSafeEnd;
+}
@@ -0,0 +1,80 @@
+// Copyright 2020-2021 CesiumGS, Inc. and Contributors
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include <cstddef>
+
+namespace CesiumGltf {
+struct Model;
+}
+
+/**
+ * @brief Decodes the buffer views of glTF models that are compressed with
+ * EXT_meshopt_compression.
+ *
+ * The glTF reader of cesium-native leaves these buffer views as they are, so
+ * their accessors read from a fallback buffer that usually has no data.
+ * Decoding them in the load thread, before the model is converted, makes
+ * them readable like any other buffer view. The vertex, triangle and index
+ * sequence codecs of meshoptimizer are supported, with all of its filters.
+ */
+class CesiumMeshoptDecoder {
+public:
+  /**
+   * @brief Decodes every compressed buffer view of the model into the buffer
+   * it refers to, whose data is allocated first if it is missing.
+   *
+   * Buffer views whose buffer already held data before any of them was
+   * decoded, and isn't marked as a fallback, are left as they are, because
+   * the model was written with an uncompressed fallback. A buffer view that
+   * can't be decoded is logged and left without data, so the primitives that
+   * use it are skipped.
+   *
+   * @param model The model, which is modified in place.
+   * @return The number of buffer views that were decoded.
+   */
+  static int32 decodeModel(CesiumGltf::Model& model);
+
+  /**
+   * @brief Decodes a vertex buffer encoded with the vertex codec (the
+   * ATTRIBUTES mode).
+   *
+   * @return Whether the data is a valid encoding of the given number of
+   * vertices of the given size.
+   */
+  static bool decodeVertexBuffer(
+      std::byte* pDestination,
+      size_t vertexCount,
+      size_t vertexSize,
+      const std::byte* pData,
+      size_t dataSize);
+
+  /**
+   * @brief Decodes a triangle list index buffer encoded with the index codec
+   * (the TRIANGLES mode) into 2- or 4-byte indices.
+   *
+   * @return Whether the data is a valid encoding of the given number of
+   * indices, which is a multiple of three.
+   */
+  static bool decodeIndexBuffer(
+      std::byte* pDestination,
+      size_t indexCount,
+      size_t indexSize,
+      const std::byte* pData,
+      size_t dataSize);
+
+  /**
+   * @brief Decodes an index buffer encoded with the index sequence codec (the
+   * INDICES mode) into 2- or 4-byte indices.
+   *
+   * @return Whether the data is a valid encoding of the given number of
+   * indices.
+   */
+  static bool decodeIndexSequence(
+      std::byte* pDestination,
+      size_t indexCount,
+      size_t indexSize,
+      const std::byte* pData,
+      size_t dataSize);
+};
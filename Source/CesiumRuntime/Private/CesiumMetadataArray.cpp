@@ -104,3 +104,36 @@ FString UCesiumMetadataArrayBlueprintLibrary::GetString(
       },
       array._value);
 }
+
+FName UCesiumMetadataArrayBlueprintLibrary::GetName(
+    UPARAM(ref) const FCesiumMetadataArray& array,
+    int64 index,
+    FName defaultValue) {
+  return std::visit(
+      [index, defaultValue](const auto& v) -> FName {
+        if (index < 0 || index >= v.size()) {
+          return defaultValue;
+        }
+        auto value = v[index];
+        return CesiumMetadataConversions<FName, decltype(value)>::convert(
+            value,
+            defaultValue);
+      },
+      array._value);
+}
+
+std::string_view UCesiumMetadataArrayBlueprintLibrary::GetStringView(
+    const FCesiumMetadataArray& array,
+    int64 index,
+    std::string_view defaultValue) {
+  return std::visit(
+      [index, defaultValue](const auto& v) -> std::string_view {
+        if (index < 0 || index >= v.size()) {
+          return defaultValue;
+        }
+        auto value = v[index];
+        return CesiumMetadataConversions<std::string_view, decltype(value)>::
+            convert(value, defaultValue);
+      },
+      array._value);
+}
@@ -135,3 +135,100 @@ UCesiumMetadataFeatureTableBlueprintLibrary::GetProperties(
     UPARAM(ref) const FCesiumMetadataFeatureTable& FeatureTable) {
   return FeatureTable._properties;
 }
+
+template <typename T>
+TArray<T> UCesiumMetadataFeatureTableBlueprintLibrary::getPropertyValuesArray(
+    const FCesiumMetadataFeatureTable& FeatureTable,
+    const FString& PropertyName,
+    int64 FirstFeatureID,
+    int64 NumberOfFeatures,
+    const T& DefaultValue) {
+  TArray<T> values;
+  if (NumberOfFeatures <= 0) {
+    return values;
+  }
+
+  values.SetNum(NumberOfFeatures);
+  GetPropertyValues(
+      FeatureTable,
+      gsl::span<const FString>(&PropertyName, 1),
+      FirstFeatureID,
+      gsl::span<T>(values.GetData(), size_t(values.Num())),
+      DefaultValue);
+  return values;
+}
+
+TArray<bool>
+UCesiumMetadataFeatureTableBlueprintLibrary::GetBooleanPropertyValues(
+    UPARAM(ref) const FCesiumMetadataFeatureTable& FeatureTable,
+    const FString& PropertyName,
+    int64 FirstFeatureID,
+    int64 NumberOfFeatures,
+    bool DefaultValue) {
+  return getPropertyValuesArray(
+      FeatureTable,
+      PropertyName,
+      FirstFeatureID,
+      NumberOfFeatures,
+      DefaultValue);
+}
+
+TArray<int32>
+UCesiumMetadataFeatureTableBlueprintLibrary::GetIntegerPropertyValues(
+    UPARAM(ref) const FCesiumMetadataFeatureTable& FeatureTable,
+    const FString& PropertyName,
+    int64 FirstFeatureID,
+    int64 NumberOfFeatures,
+    int32 DefaultValue) {
+  return getPropertyValuesArray(
+      FeatureTable,
+      PropertyName,
+      FirstFeatureID,
+      NumberOfFeatures,
+      DefaultValue);
+}
+
+TArray<int64>
+UCesiumMetadataFeatureTableBlueprintLibrary::GetInteger64PropertyValues(
+    UPARAM(ref) const FCesiumMetadataFeatureTable& FeatureTable,
+    const FString& PropertyName,
+    int64 FirstFeatureID,
+    int64 NumberOfFeatures,
+    int64 DefaultValue) {
+  return getPropertyValuesArray(
+      FeatureTable,
+      PropertyName,
+      FirstFeatureID,
+      NumberOfFeatures,
+      DefaultValue);
+}
+
+TArray<float>
+UCesiumMetadataFeatureTableBlueprintLibrary::GetFloatPropertyValues(
+    UPARAM(ref) const FCesiumMetadataFeatureTable& FeatureTable,
+    const FString& PropertyName,
+    int64 FirstFeatureID,
+    int64 NumberOfFeatures,
+    float DefaultValue) {
+  return getPropertyValuesArray(
+      FeatureTable,
+      PropertyName,
+      FirstFeatureID,
+      NumberOfFeatures,
+      DefaultValue);
+}
+
+TArray<FString>
+UCesiumMetadataFeatureTableBlueprintLibrary::GetStringPropertyValues(
+    UPARAM(ref) const FCesiumMetadataFeatureTable& FeatureTable,
+    const FString& PropertyName,
+    int64 FirstFeatureID,
+    int64 NumberOfFeatures,
+    const FString& DefaultValue) {
+  return getPropertyValuesArray(
+      FeatureTable,
+      PropertyName,
+      FirstFeatureID,
+      NumberOfFeatures,
+      DefaultValue);
+}
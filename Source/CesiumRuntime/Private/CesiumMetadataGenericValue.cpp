@@ -100,6 +100,29 @@ FString UCesiumMetadataGenericValueBlueprintLibrary::GetString(
       Value._value);
 }
 
+FName UCesiumMetadataGenericValueBlueprintLibrary::GetName(
+    UPARAM(ref) const FCesiumMetadataGenericValue& Value,
+    FName DefaultValue) {
+  return std::visit(
+      [DefaultValue](auto value) -> FName {
+        return CesiumMetadataConversions<FName, decltype(value)>::convert(
+            value,
+            DefaultValue);
+      },
+      Value._value);
+}
+
+std::string_view UCesiumMetadataGenericValueBlueprintLibrary::GetStringView(
+    const FCesiumMetadataGenericValue& Value,
+    std::string_view DefaultValue) {
+  return std::visit(
+      [DefaultValue](auto value) -> std::string_view {
+        return CesiumMetadataConversions<std::string_view, decltype(value)>::
+            convert(value, DefaultValue);
+      },
+      Value._value);
+}
+
 FCesiumMetadataArray UCesiumMetadataGenericValueBlueprintLibrary::GetArray(
     UPARAM(ref) const FCesiumMetadataGenericValue& Value) {
   return std::visit(
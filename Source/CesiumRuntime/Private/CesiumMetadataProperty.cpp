@@ -119,6 +119,28 @@ FString UCesiumMetadataPropertyBlueprintLibrary::GetString(
       Property._property);
 }
 
+FName UCesiumMetadataPropertyBlueprintLibrary::GetName(
+    UPARAM(ref) const FCesiumMetadataProperty& Property,
+    int64 FeatureID,
+    FName DefaultValue) {
+  return std::visit(
+      [FeatureID, DefaultValue](const auto& v) -> FName {
+        return getConvertedValue(v, v.size(), FeatureID, DefaultValue);
+      },
+      Property._property);
+}
+
+std::string_view UCesiumMetadataPropertyBlueprintLibrary::GetStringView(
+    const FCesiumMetadataProperty& Property,
+    int64 FeatureID,
+    std::string_view DefaultValue) {
+  return std::visit(
+      [FeatureID, DefaultValue](const auto& v) -> std::string_view {
+        return getConvertedValue(v, v.size(), FeatureID, DefaultValue);
+      },
+      Property._property);
+}
+
 FCesiumMetadataArray UCesiumMetadataPropertyBlueprintLibrary::GetArray(
     UPARAM(ref) const FCesiumMetadataProperty& Property,
     int64 featureID) {
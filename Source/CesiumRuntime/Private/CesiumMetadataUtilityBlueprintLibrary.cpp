@@ -10,7 +10,7 @@ UCesiumMetadataUtilityBlueprintLibrary::GetPrimitiveMetadata(
     return FCesiumMetadataPrimitive();
   }
 
-  return pGltfComponent->Metadata;
+  return pGltfComponent->GetMetadata();
 }
 
 TMap<FString, FCesiumMetadataGenericValue>
@@ -23,7 +23,7 @@ UCesiumMetadataUtilityBlueprintLibrary::GetMetadataValuesForFace(
     return TMap<FString, FCesiumMetadataGenericValue>();
   }
 
-  const FCesiumMetadataPrimitive& metadata = pGltfComponent->Metadata;
+  const FCesiumMetadataPrimitive& metadata = pGltfComponent->GetMetadata();
   const TArray<FCesiumMetadataFeatureTable>& featureTables =
       UCesiumMetadataPrimitiveBlueprintLibrary::GetFeatureTables(metadata);
   if (featureTables.Num() == 0) {
@@ -50,7 +50,7 @@ UCesiumMetadataUtilityBlueprintLibrary::GetMetadataValuesAsStringForFace(
     return TMap<FString, FString>();
   }
 
-  const FCesiumMetadataPrimitive& metadata = pGltfComponent->Metadata;
+  const FCesiumMetadataPrimitive& metadata = pGltfComponent->GetMetadata();
   const TArray<FCesiumMetadataFeatureTable>& featureTables =
       UCesiumMetadataPrimitiveBlueprintLibrary::GetFeatureTables(metadata);
   if (featureTables.Num() == 0) {
@@ -77,3 +77,55 @@ int64 UCesiumMetadataUtilityBlueprintLibrary::GetFeatureIDForFace(
           Primitive,
           faceID));
 }
+
+int64 UCesiumMetadataUtilityBlueprintLibrary::GetFeatureIDForHit(
+    const FHitResult& Hit) {
+  const UCesiumGltfPrimitiveComponent* pGltfComponent =
+      Cast<UCesiumGltfPrimitiveComponent>(Hit.GetComponent());
+  if (!IsValid(pGltfComponent) || Hit.FaceIndex < 0 ||
+      Hit.FaceIndex >= pGltfComponent->FaceFeatureIDs.Num()) {
+    return -1;
+  }
+
+  return pGltfComponent->FaceFeatureIDs[Hit.FaceIndex];
+}
+
+FCesiumMetadataGenericValue
+UCesiumMetadataUtilityBlueprintLibrary::GetPropertyValueForHit(
+    const FHitResult& Hit,
+    const FString& PropertyName) {
+  int64 featureID = -1;
+  const FCesiumMetadataProperty* pProperty =
+      findPropertyForHit(Hit, PropertyName, featureID);
+  if (!pProperty) {
+    return FCesiumMetadataGenericValue();
+  }
+
+  return UCesiumMetadataPropertyBlueprintLibrary::GetGenericValue(
+      *pProperty,
+      featureID);
+}
+
+const FCesiumMetadataProperty*
+UCesiumMetadataUtilityBlueprintLibrary::findPropertyForHit(
+    const FHitResult& Hit,
+    const FString& PropertyName,
+    int64& FeatureID) {
+  FeatureID = GetFeatureIDForHit(Hit);
+  if (FeatureID < 0) {
+    return nullptr;
+  }
+
+  const UCesiumGltfPrimitiveComponent* pGltfComponent =
+      Cast<UCesiumGltfPrimitiveComponent>(Hit.GetComponent());
+  const TArray<FCesiumMetadataFeatureTable>& featureTables =
+      UCesiumMetadataPrimitiveBlueprintLibrary::GetFeatureTables(
+          pGltfComponent->GetMetadata());
+  if (featureTables.Num() == 0) {
+    return nullptr;
+  }
+
+  return UCesiumMetadataFeatureTableBlueprintLibrary::GetProperties(
+             featureTables[0])
+      .Find(PropertyName);
+}
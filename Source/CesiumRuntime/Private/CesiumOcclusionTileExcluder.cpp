@@ -0,0 +1,102 @@
+// Copyright 2020-2021 CesiumGS, Inc. and Contributors
+
+#include "CesiumOcclusionTileExcluder.h"
+#include "Cesium3DTilesSelection/Tile.h"
+#include "CesiumGltfComponent.h"
+#include "CesiumUtility/Tracing.h"
+#include "Components/PrimitiveComponent.h"
+#include <algorithm>
+
+using namespace Cesium3DTilesSelection;
+
+namespace {
+/**
+ * @brief Returns the last time at which any primitive of the given glTF
+ * component was rendered on screen, or a negative value if it has none.
+ */
+double getLastRenderTimeOnScreen(const UCesiumGltfComponent* pGltf) {
+  double lastRenderTime = -1.0;
+  for (const USceneComponent* pChild : pGltf->GetAttachChildren()) {
+    const UPrimitiveComponent* pPrimitive = Cast<UPrimitiveComponent>(pChild);
+    if (pPrimitive) {
+      lastRenderTime = std::max(
+          lastRenderTime,
+          double(pPrimitive->GetLastRenderTimeOnScreen()));
+    }
+  }
+  return lastRenderTime;
+}
+} // namespace
+
+void CesiumOcclusionTileExcluder::update(
+    double currentTime,
+    double occludedDelay,
+    double retestInterval) {
+  CESIUM_TRACE("CesiumOcclusionTileExcluder::update");
+
+  for (auto it = this->_tiles.begin(); it != this->_tiles.end();) {
+    if (it->second.lastVisitedFrame != this->_frame) {
+      it = this->_tiles.erase(it);
+    } else {
+      ++it;
+    }
+  }
+
+  ++this->_frame;
+  this->_currentTime = currentTime;
+  this->_occludedDelay = occludedDelay;
+  this->_retestInterval = retestInterval;
+}
+
+bool CesiumOcclusionTileExcluder::shouldExclude(
+    const Tile& tile) const noexcept {
+  auto it = this->_tiles.find(&tile);
+  if (it != this->_tiles.end()) {
+    TileState& state = it->second;
+    state.lastVisitedFrame = this->_frame;
+
+    if (state.excludedTime >= 0.0) {
+      if (this->_currentTime - state.excludedTime < this->_retestInterval) {
+        return true;
+      }
+
+      // Let the tile through, so that it is shown and tested again. It gets
+      // the full delay to be rendered before it can be excluded again.
+      state.shownTime = this->_currentTime;
+      state.excludedTime = -1.0;
+      return false;
+    }
+  }
+
+  if (tile.getState() != Tile::LoadState::Done) {
+    return false;
+  }
+
+  const UCesiumGltfComponent* pGltf =
+      static_cast<const UCesiumGltfComponent*>(tile.getRendererResources());
+  if (!pGltf || !pGltf->IsVisible()) {
+    // Tiles that are not shown, for example because they were refined, have
+    // no occlusion results.
+    if (it != this->_tiles.end()) {
+      this->_tiles.erase(it);
+    }
+    return false;
+  }
+
+  if (it == this->_tiles.end()) {
+    this->_tiles.emplace(
+        &tile,
+        TileState{this->_currentTime, -1.0, this->_frame});
+    return false;
+  }
+
+  TileState& state = it->second;
+  const double lastRenderTime =
+      std::max(state.shownTime, getLastRenderTimeOnScreen(pGltf));
+  if (this->_currentTime - lastRenderTime > this->_occludedDelay) {
+    state.excludedTime = this->_currentTime;
+    return true;
+  }
+
+  return false;
+}
@@ -0,0 +1,68 @@
+// Copyright 2020-2021 CesiumGS, Inc. and Contributors
+
+#pragma once
+
+#include "Cesium3DTilesSelection/ITileExcluder.h"
+#include <cstdint>
+#include <unordered_map>
+
+namespace Cesium3DTilesSelection {
+class Tile;
+}
+
+/**
+ * @brief Excludes the tiles that Unreal's occlusion culling found to be
+ * hidden behind other geometry, so that they are neither refined nor have
+ * their descendants loaded.
+ *
+ * A tile is excluded when it has been shown for a while, but none of its
+ * primitives were rendered on screen recently. Excluded tiles are hidden, so
+ * Unreal can no longer test them. Each excluded tile is therefore let through
+ * again after a retest interval, to find out whether it has become visible.
+ *
+ * The occlusion results come from the rendering of the previous frames, so
+ * this must only be used when tiles outside of the view are frustum culled.
+ * Otherwise, those tiles would be excluded as well.
+ */
+class CesiumOcclusionTileExcluder
+    : public Cesium3DTilesSelection::ITileExcluder {
+public:
+  /**
+   * @brief Prepares the excluder for the selection of a new frame.
+   *
+   * @param currentTime The current world time, in seconds. This is the time
+   * that Unreal uses for the last render times of primitives.
+   * @param occludedDelay How long, in seconds, a shown tile must not have been
+   * rendered on screen before it is excluded.
+   * @param retestInterval How long, in seconds, a tile stays excluded before
+   * it is shown again to be tested.
+   */
+  void update(double currentTime, double occludedDelay, double retestInterval);
+
+  virtual bool
+  shouldExclude(const Cesium3DTilesSelection::Tile& tile) const noexcept
+      override;
+
+private:
+  struct TileState {
+    // The time from which the tile was shown, or was let through to be
+    // retested.
+    double shownTime;
+    // The time at which the tile was excluded, or a negative value if it is
+    // not currently excluded.
+    double excludedTime;
+    // The last frame in which the selection visited the tile.
+    int64_t lastVisitedFrame;
+  };
+
+  double _currentTime = 0.0;
+  double _occludedDelay = 0.0;
+  double _retestInterval = 0.0;
+  int64_t _frame = 0;
+
+  // The tiles are only used as keys, and never dereferenced. Tiles that are
+  // no longer visited are removed at the start of the next frame, so that
+  // the entries of unloaded tiles do not accumulate.
+  mutable std::unordered_map<const Cesium3DTilesSelection::Tile*, TileState>
+      _tiles;
+};
@@ -0,0 +1,202 @@
+// Copyright 2020-2021 CesiumGS, Inc. and Contributors
+
+#include "CesiumPipelinePrecache.h"
+#include "CesiumCamera.h"
+#include "Components/StaticMeshComponent.h"
+#include "Engine/StaticMesh.h"
+#include "Runtime/Launch/Resources/Version.h"
+#include "StaticMeshResources.h"
+
+namespace {
+
+#if ENGINE_MAJOR_VERSION == 5
+using TMeshVector2 = FVector2f;
+using TMeshVector3 = FVector3f;
+#else
+using TMeshVector2 = FVector2D;
+using TMeshVector3 = FVector;
+#endif
+
+// How far in front of the camera, in centimeters, the components are placed,
+// and the extent of their bounds around the triangle, which keep them
+// between the near plane and the camera.
+constexpr float DrawDistance = 200.0f;
+constexpr float BoundsExtent = 50.0f;
+
+/**
+ * Creates the render data of a single triangle with all of its vertices at
+ * the origin, with the given vertex layout.
+ */
+FStaticMeshRenderData* createRenderData(
+    int32 numTexCoords,
+    bool fullPrecisionUVs,
+    bool hasVertexColors,
+    bool highPrecisionTangents) {
+  constexpr uint32 numVertices = 3;
+
+  FStaticMeshRenderData* RenderData = new FStaticMeshRenderData();
+  RenderData->AllocateLODResources(1);
+  FStaticMeshLODResources& LODResources = RenderData->LODResources[0];
+  FStaticMeshVertexBuffers& vertexBuffers = LODResources.VertexBuffers;
+  LODResources.bHasColorVertexData = hasVertexColors;
+
+  // These are the same vertex buffers as those of the tile primitives, see
+  // loadPrimitive. Primitives without vertex colors have no color buffer.
+  vertexBuffers.StaticMeshVertexBuffer.SetUseHighPrecisionTangentBasis(
+      highPrecisionTangents);
+  vertexBuffers.StaticMeshVertexBuffer.SetUseFullPrecisionUVs(
+      fullPrecisionUVs);
+  vertexBuffers.PositionVertexBuffer.Init(numVertices, false);
+  vertexBuffers.StaticMeshVertexBuffer.Init(numVertices, numTexCoords, false);
+  if (hasVertexColors) {
+    vertexBuffers.ColorVertexBuffer.InitFromSingleColor(
+        FColor::White,
+        numVertices);
+  }
+
+  for (uint32 i = 0; i < numVertices; ++i) {
+    vertexBuffers.PositionVertexBuffer.VertexPosition(i) =
+        TMeshVector3(0.0f, 0.0f, 0.0f);
+    vertexBuffers.StaticMeshVertexBuffer.SetVertexTangents(
+        i,
+        TMeshVector3(1.0f, 0.0f, 0.0f),
+        TMeshVector3(0.0f, 1.0f, 0.0f),
+        TMeshVector3(0.0f, 0.0f, 1.0f));
+    for (int32 uv = 0; uv < numTexCoords; ++uv) {
+      vertexBuffers.StaticMeshVertexBuffer.SetVertexUV(
+          i,
+          uv,
+          TMeshVector2(0.0f, 0.0f));
+    }
+  }
+
+  RenderData->Bounds = FBoxSphereBounds(
+      FVector::ZeroVector,
+      FVector(BoundsExtent),
+      BoundsExtent * FMath::Sqrt(3.0f));
+
+#if ENGINE_MAJOR_VERSION == 5
+  FStaticMeshSectionArray& Sections = LODResources.Sections;
+#else
+  FStaticMeshLODResources::FStaticMeshSectionArray& Sections =
+      LODResources.Sections;
+#endif
+
+  FStaticMeshSection& section = Sections.AddDefaulted_GetRef();
+  section.NumTriangles = 1;
+  section.FirstIndex = 0;
+  section.MinVertexIndex = 0;
+  section.MaxVertexIndex = numVertices - 1;
+  section.bEnableCollision = false;
+  section.bCastShadow = true;
+  section.MaterialIndex = 0;
+
+  TArray<uint32> indices = {0, 1, 2};
+  LODResources.IndexBuffer.SetIndices(
+      indices,
+      EIndexBufferStride::Type::Force16Bit);
+
+  LODResources.bHasDepthOnlyIndices = false;
+  LODResources.bHasReversedIndices = false;
+  LODResources.bHasReversedDepthOnlyIndices = false;
+#if ENGINE_MAJOR_VERSION < 5
+  LODResources.bHasAdjacencyInfo = false;
+#endif
+
+  return RenderData;
+}
+
+/**
+ * Creates a static mesh from the given render data, which it takes ownership
+ * of.
+ */
+UStaticMesh* createStaticMesh(
+    UObject* pOuter,
+    FStaticMeshRenderData* pRenderData,
+    UMaterialInterface* pMaterial) {
+  UStaticMesh* pStaticMesh = NewObject<UStaticMesh>(pOuter);
+  pStaticMesh->SetFlags(
+      RF_Transient | RF_DuplicateTransient | RF_TextExportTransient);
+  pStaticMesh->NeverStream = true;
+
+#if ENGINE_MAJOR_VERSION == 4 && ENGINE_MINOR_VERSION < 27
+  pStaticMesh->bIsBuiltAtRuntime = true;
+  pStaticMesh->RenderData = TUniquePtr<FStaticMeshRenderData>(pRenderData);
+#elif ENGINE_MAJOR_VERSION == 4
+  pStaticMesh->SetIsBuiltAtRuntime(true);
+  pStaticMesh->SetRenderData(TUniquePtr<FStaticMeshRenderData>(pRenderData));
+#else
+  pStaticMesh->SetRenderData(TUniquePtr<FStaticMeshRenderData>(pRenderData));
+#endif
+
+  pStaticMesh->AddMaterial(pMaterial);
+  pStaticMesh->InitResources();
+  pStaticMesh->CalculateExtendedBounds();
+
+#if ENGINE_MAJOR_VERSION == 4 && ENGINE_MINOR_VERSION < 27
+  pStaticMesh->RenderData->ScreenSize[0].Default = 1.0f;
+#else
+  pStaticMesh->GetRenderData()->ScreenSize[0].Default = 1.0f;
+#endif
+  return pStaticMesh;
+}
+} // namespace
+
+/*static*/ TArray<UStaticMeshComponent*>
+CesiumPipelinePrecache::createComponents(
+    USceneComponent& parent,
+    const TArray<UMaterialInterface*>& materials,
+    bool highPrecisionTangents) {
+  TArray<UStaticMeshComponent*> components;
+  if (materials.Num() == 0) {
+    return components;
+  }
+
+  AActor* pOwner = parent.GetOwner();
+  for (int32 numTexCoords = 1; numTexCoords <= MaximumTextureCoordinates;
+       ++numTexCoords) {
+    for (int32 layout = 0; layout < 4; ++layout) {
+      const bool fullPrecisionUVs = (layout & 1) != 0;
+      const bool hasVertexColors = (layout & 2) != 0;
+      UStaticMesh* pStaticMesh = createStaticMesh(
+          pOwner,
+          createRenderData(
+              numTexCoords,
+              fullPrecisionUVs,
+              hasVertexColors,
+              highPrecisionTangents),
+          materials[0]);
+
+      for (UMaterialInterface* pMaterial : materials) {
+        UStaticMeshComponent* pComponent =
+            NewObject<UStaticMeshComponent>(pOwner);
+        pComponent->SetFlags(
+            RF_Transient | RF_DuplicateTransient | RF_TextExportTransient);
+        pComponent->SetMobility(EComponentMobility::Movable);
+        pComponent->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+        pComponent->bUseAsOccluder = false;
+        pComponent->SetStaticMesh(pStaticMesh);
+        pComponent->SetMaterial(0, pMaterial);
+        pComponent->AttachToComponent(
+            &parent,
+            FAttachmentTransformRules::KeepRelativeTransform);
+        pComponent->RegisterComponent();
+        components.Add(pComponent);
+      }
+    }
+  }
+
+  return components;
+}
+
+/*static*/ void CesiumPipelinePrecache::placeComponents(
+    const TArray<UStaticMeshComponent*>& components,
+    const FCesiumCamera& camera) {
+  const FVector location =
+      camera.Location + camera.Rotation.Vector() * DrawDistance;
+  for (UStaticMeshComponent* pComponent : components) {
+    if (pComponent) {
+      pComponent->SetWorldLocationAndRotation(location, camera.Rotation);
+    }
+  }
+}
@@ -0,0 +1,69 @@
+// Copyright 2020-2021 CesiumGS, Inc. and Contributors
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class UMaterialInterface;
+class USceneComponent;
+class UStaticMeshComponent;
+struct FCesiumCamera;
+
+/**
+ * @brief Functions that draw every combination of the materials of a tileset
+ * and the vertex layouts that tiles can be converted to, so that the shaders
+ * and graphics pipeline states that tiles need are created before the first
+ * tiles are drawn.
+ *
+ * The vertex layout of a tile primitive depends on its vertex buffers: the
+ * number of texture coordinate channels, whether they are full precision,
+ * whether it has vertex colors and the precision of its tangents. On
+ * DX12 and Vulkan, the first tile drawn with a new combination of a material
+ * and a layout, such as the first water tile or the first one with vertex
+ * colors, otherwise stalls the render thread while its pipeline state is
+ * created. The pipeline states are also recorded into the shader pipeline
+ * cache when it is logging, for a bundled cache.
+ *
+ * Each combination is drawn by a component of its own with a single triangle
+ * whose vertices are all at its origin, so it covers no pixels. The bounds of
+ * the components keep them from being culled while they are placed in front
+ * of a camera.
+ */
+class CesiumPipelinePrecache {
+public:
+  /**
+   * The number of frames that the combinations are drawn for, which leaves
+   * time for the render thread to create their scene proxies.
+   */
+  static constexpr int32 FramesToDraw = 4;
+
+  /**
+   * The largest number of texture coordinate channels of the combinations.
+   * Tile primitives have one for each texture coordinate set of the glTF
+   * that their material samples, one for each raster overlay and one for
+   * their feature IDs, which rarely add up to more than four.
+   */
+  static constexpr int32 MaximumTextureCoordinates = 4;
+
+  /**
+   * Creates and registers the components that draw the combinations of the
+   * given materials with the vertex layouts, attached to the given parent.
+   *
+   * @param parent The component to attach the components to.
+   * @param materials The base materials of the tileset.
+   * @param highPrecisionTangents Whether the tiles have high precision
+   * tangents, see ACesium3DTileset::HighPrecisionVertexAttributes.
+   */
+  static TArray<UStaticMeshComponent*> createComponents(
+      USceneComponent& parent,
+      const TArray<UMaterialInterface*>& materials,
+      bool highPrecisionTangents);
+
+  /**
+   * Places the components in front of the given camera, so that they are
+   * drawn in its view.
+   */
+  static void placeComponents(
+      const TArray<UStaticMeshComponent*>& components,
+      const FCesiumCamera& camera);
+};
@@ -0,0 +1,97 @@
+// Copyright 2020-2021 CesiumGS, Inc. and Contributors
+
+#include "CesiumPointCloudSceneProxy.h"
+#include "CesiumGltfPrimitiveComponent.h"
+#include "Engine/StaticMesh.h"
+#include "Materials/Material.h"
+#include "Runtime/Launch/Resources/Version.h"
+#include "SceneManagement.h"
+#include "StaticMeshResources.h"
+
+FCesiumPointCloudSceneProxy::FCesiumPointCloudSceneProxy(
+    UCesiumGltfPrimitiveComponent* pComponent)
+    : FPrimitiveSceneProxy(pComponent),
+      _pVertexFactory(nullptr),
+      _pMaterial(pComponent->GetMaterial(0)),
+      _materialRelevance(),
+      _numPoints(0) {
+  UStaticMesh* pStaticMesh = pComponent->GetStaticMesh();
+#if ENGINE_MAJOR_VERSION == 4 && ENGINE_MINOR_VERSION < 27
+  FStaticMeshRenderData* pRenderData =
+      pStaticMesh ? pStaticMesh->RenderData.Get() : nullptr;
+#else
+  FStaticMeshRenderData* pRenderData =
+      pStaticMesh ? pStaticMesh->GetRenderData() : nullptr;
+#endif
+  if (pRenderData && pRenderData->LODResources.Num() > 0 &&
+      pRenderData->LODVertexFactories.Num() > 0) {
+    this->_pVertexFactory = &pRenderData->LODVertexFactories[0].VertexFactory;
+    this->_numPoints = pRenderData->LODResources[0].GetNumVertices();
+  }
+
+  if (!this->_pMaterial) {
+    this->_pMaterial = UMaterial::GetDefaultMaterial(MD_Surface);
+  }
+  this->_materialRelevance =
+      this->_pMaterial->GetRelevance_Concurrent(GetScene().GetFeatureLevel());
+
+  // Points are too small to cast useful shadows.
+  this->bCastDynamicShadow = false;
+}
+
+SIZE_T FCesiumPointCloudSceneProxy::GetTypeHash() const {
+  static size_t uniquePointer;
+  return reinterpret_cast<size_t>(&uniquePointer);
+}
+
+void FCesiumPointCloudSceneProxy::GetDynamicMeshElements(
+    const TArray<const FSceneView*>& Views,
+    const FSceneViewFamily& ViewFamily,
+    uint32 VisibilityMap,
+    FMeshElementCollector& Collector) const {
+  if (!this->_pVertexFactory || this->_numPoints == 0) {
+    return;
+  }
+
+  for (int32 viewIndex = 0; viewIndex < Views.Num(); ++viewIndex) {
+    if (!(VisibilityMap & (1 << viewIndex))) {
+      continue;
+    }
+
+    FMeshBatch& mesh = Collector.AllocateMesh();
+    mesh.VertexFactory = this->_pVertexFactory;
+    mesh.MaterialRenderProxy = this->_pMaterial->GetRenderProxy();
+    mesh.Type = PT_PointList;
+    mesh.DepthPriorityGroup = SDPG_World;
+    mesh.ReverseCulling = IsLocalToWorldDeterminantNegative();
+    mesh.CastShadow = false;
+    mesh.bCanApplyViewModeOverrides = false;
+
+    // The points are not indexed, so they are drawn in vertex order.
+    FMeshBatchElement& element = mesh.Elements[0];
+    element.IndexBuffer = nullptr;
+    element.FirstIndex = 0;
+    element.NumPrimitives = this->_numPoints;
+    element.MinVertexIndex = 0;
+    element.MaxVertexIndex = this->_numPoints - 1;
+    element.PrimitiveUniformBuffer = GetUniformBuffer();
+
+    Collector.AddMesh(viewIndex, mesh);
+  }
+}
+
+FPrimitiveViewRelevance
+FCesiumPointCloudSceneProxy::GetViewRelevance(const FSceneView* View) const {
+  FPrimitiveViewRelevance result;
+  result.bDrawRelevance = IsShown(View);
+  result.bDynamicRelevance = true;
+  result.bShadowRelevance = false;
+  result.bRenderInMainPass = ShouldRenderInMainPass();
+  result.bRenderCustomDepth = ShouldRenderCustomDepth();
+  this->_materialRelevance.SetPrimitiveViewRelevance(result);
+  return result;
+}
+
+uint32 FCesiumPointCloudSceneProxy::GetMemoryFootprint() const {
+  return sizeof(*this) + GetAllocatedSize();
+}
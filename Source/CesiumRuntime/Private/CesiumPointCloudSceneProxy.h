@@ -0,0 +1,44 @@
+// Copyright 2020-2021 CesiumGS, Inc. and Contributors
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MaterialShared.h"
+#include "PrimitiveSceneProxy.h"
+
+class FLocalVertexFactory;
+class UCesiumGltfPrimitiveComponent;
+class UMaterialInterface;
+
+/**
+ * @brief Draws the points of a point cloud primitive as a point list, straight
+ * from the vertex buffers of its static mesh.
+ *
+ * Each point is a single vertex, so point clouds take a fraction of the memory
+ * and vertex work that expanding the points into triangles would. The points
+ * are drawn with the material of the primitive, whose vertex color is the
+ * color of the point, and cover one pixel each.
+ */
+class FCesiumPointCloudSceneProxy final : public FPrimitiveSceneProxy {
+public:
+  FCesiumPointCloudSceneProxy(UCesiumGltfPrimitiveComponent* pComponent);
+
+  virtual SIZE_T GetTypeHash() const override;
+
+  virtual void GetDynamicMeshElements(
+      const TArray<const FSceneView*>& Views,
+      const FSceneViewFamily& ViewFamily,
+      uint32 VisibilityMap,
+      FMeshElementCollector& Collector) const override;
+
+  virtual FPrimitiveViewRelevance
+  GetViewRelevance(const FSceneView* View) const override;
+
+  virtual uint32 GetMemoryFootprint() const override;
+
+private:
+  const FLocalVertexFactory* _pVertexFactory;
+  UMaterialInterface* _pMaterial;
+  FMaterialRelevance _materialRelevance;
+  uint32 _numPoints;
+};
@@ -2,10 +2,10 @@
 
 #include "CesiumPolygonRasterOverlay.h"
 #include "Cesium3DTilesSelection/RasterizedPolygonsOverlay.h"
-#include "Cesium3DTilesSelection/RasterizedPolygonsTileExcluder.h"
 #include "Cesium3DTilesSelection/Tileset.h"
 #include "CesiumBingMapsRasterOverlay.h"
 #include "CesiumCartographicPolygon.h"
+#include "CesiumPolygonTileExcluder.h"
 
 using namespace CesiumGeospatial;
 using namespace Cesium3DTilesSelection;
@@ -48,7 +48,7 @@ void UCesiumPolygonRasterOverlay::OnAdd(
         static_cast<RasterizedPolygonsOverlay*>(pOverlay);
     assert(this->_pExcluder == nullptr);
     this->_pExcluder =
-        std::make_shared<RasterizedPolygonsTileExcluder>(*pPolygons);
+        std::make_shared<CesiumPolygonTileExcluder>(pPolygons->getPolygons());
     pTileset->getOptions().excluders.push_back(this->_pExcluder);
   }
 }
@@ -0,0 +1,264 @@
+// Copyright 2020-2021 CesiumGS, Inc. and Contributors
+
+#include "CesiumPolygonTileExcluder.h"
+#include "Cesium3DTilesSelection/BoundingVolume.h"
+#include "Cesium3DTilesSelection/Tile.h"
+#include "CesiumUtility/Math.h"
+#include <algorithm>
+#include <cmath>
+
+using namespace Cesium3DTilesSelection;
+using namespace CesiumGeospatial;
+
+namespace {
+// The grid never has more than this many cells on a side, so that polygons
+// spread across the globe don't make it arbitrarily large.
+constexpr int32_t MaximumGridSize = 32;
+
+int32_t toCell(double value, double origin, double cellSize, int32_t count) {
+  if (cellSize <= 0.0) {
+    return 0;
+  }
+  int32_t cell = static_cast<int32_t>(std::floor((value - origin) / cellSize));
+  return std::clamp(cell, 0, count - 1);
+}
+
+/**
+ * Determines if the segment from a to b touches the given bounds, by clipping
+ * it against each of the four sides with the Liang-Barsky algorithm.
+ */
+bool segmentTouchesBounds(
+    const glm::dvec2& a,
+    const glm::dvec2& b,
+    double west,
+    double south,
+    double east,
+    double north) {
+  const glm::dvec2 delta = b - a;
+  const double p[4] = {-delta.x, delta.x, -delta.y, delta.y};
+  const double q[4] = {a.x - west, east - a.x, a.y - south, north - a.y};
+
+  double t0 = 0.0;
+  double t1 = 1.0;
+  for (int32_t i = 0; i < 4; ++i) {
+    if (p[i] == 0.0) {
+      if (q[i] < 0.0) {
+        return false;
+      }
+    } else {
+      const double t = q[i] / p[i];
+      if (p[i] < 0.0) {
+        t0 = std::max(t0, t);
+      } else {
+        t1 = std::min(t1, t);
+      }
+      if (t0 > t1) {
+        return false;
+      }
+    }
+  }
+
+  return true;
+}
+
+bool pointInPolygon(
+    const glm::dvec2& point,
+    const std::vector<glm::dvec2>& vertices) {
+  bool inside = false;
+  for (size_t i = 0, j = vertices.size() - 1; i < vertices.size(); j = i++) {
+    const glm::dvec2& a = vertices[i];
+    const glm::dvec2& b = vertices[j];
+    if ((a.y > point.y) != (b.y > point.y) &&
+        point.x < (b.x - a.x) * (point.y - a.y) / (b.y - a.y) + a.x) {
+      inside = !inside;
+    }
+  }
+  return inside;
+}
+} // namespace
+
+CesiumPolygonTileExcluder::CesiumPolygonTileExcluder(
+    const std::vector<CartographicPolygon>& polygons)
+    : _polygons(),
+      _gridBounds{0.0, 0.0, 0.0, 0.0},
+      _columns(0),
+      _rows(0),
+      _cells() {
+  this->_polygons.reserve(polygons.size());
+
+  for (const CartographicPolygon& polygon : polygons) {
+    const std::vector<glm::dvec2>& vertices = polygon.getVertices();
+    if (vertices.size() < 3) {
+      continue;
+    }
+
+    Bounds bounds{
+        vertices[0].x,
+        vertices[0].y,
+        vertices[0].x,
+        vertices[0].y};
+    for (const glm::dvec2& vertex : vertices) {
+      bounds.west = std::min(bounds.west, vertex.x);
+      bounds.south = std::min(bounds.south, vertex.y);
+      bounds.east = std::max(bounds.east, vertex.x);
+      bounds.north = std::max(bounds.north, vertex.y);
+    }
+
+    if (this->_polygons.empty()) {
+      this->_gridBounds = bounds;
+    } else {
+      this->_gridBounds.west = std::min(this->_gridBounds.west, bounds.west);
+      this->_gridBounds.south = std::min(this->_gridBounds.south, bounds.south);
+      this->_gridBounds.east = std::max(this->_gridBounds.east, bounds.east);
+      this->_gridBounds.north = std::max(this->_gridBounds.north, bounds.north);
+    }
+
+    this->_polygons.push_back(Polygon{bounds, vertices});
+  }
+
+  if (this->_polygons.empty()) {
+    return;
+  }
+
+  const int32_t gridSize = std::clamp(
+      static_cast<int32_t>(
+          std::ceil(std::sqrt(static_cast<double>(this->_polygons.size())))),
+      1,
+      MaximumGridSize);
+  this->_columns = gridSize;
+  this->_rows = gridSize;
+  this->_cells.resize(size_t(this->_columns) * size_t(this->_rows));
+
+  const double cellWidth =
+      (this->_gridBounds.east - this->_gridBounds.west) / this->_columns;
+  const double cellHeight =
+      (this->_gridBounds.north - this->_gridBounds.south) / this->_rows;
+
+  for (size_t i = 0; i < this->_polygons.size(); ++i) {
+    const Bounds& bounds = this->_polygons[i].bounds;
+    const int32_t firstColumn =
+        toCell(bounds.west, this->_gridBounds.west, cellWidth, this->_columns);
+    const int32_t lastColumn =
+        toCell(bounds.east, this->_gridBounds.west, cellWidth, this->_columns);
+    const int32_t firstRow =
+        toCell(bounds.south, this->_gridBounds.south, cellHeight, this->_rows);
+    const int32_t lastRow =
+        toCell(bounds.north, this->_gridBounds.south, cellHeight, this->_rows);
+
+    for (int32_t row = firstRow; row <= lastRow; ++row) {
+      for (int32_t column = firstColumn; column <= lastColumn; ++column) {
+        this->_cells[size_t(row) * size_t(this->_columns) + size_t(column)]
+            .push_back(uint32_t(i));
+      }
+    }
+  }
+}
+
+bool CesiumPolygonTileExcluder::shouldExclude(const Tile& tile) const noexcept {
+  if (this->_polygons.empty()) {
+    return false;
+  }
+
+  const std::optional<GlobeRectangle> maybeRectangle =
+      estimateGlobeRectangle(tile.getBoundingVolume());
+  if (!maybeRectangle) {
+    return false;
+  }
+
+  return this->classify(*maybeRectangle) == Classification::Inside;
+}
+
+CesiumPolygonTileExcluder::Classification CesiumPolygonTileExcluder::classify(
+    const GlobeRectangle& rectangle) const noexcept {
+  const double west = rectangle.getWest();
+  const double south = rectangle.getSouth();
+  const double east = rectangle.getEast();
+  const double north = rectangle.getNorth();
+
+  if (west <= east) {
+    return this->classifyBounds(Bounds{west, south, east, north});
+  }
+
+  // The rectangle crosses the anti-meridian, so classify its two halves.
+  const Classification westHalf = this->classifyBounds(
+      Bounds{west, south, CesiumUtility::Math::ONE_PI, north});
+  const Classification eastHalf = this->classifyBounds(
+      Bounds{-CesiumUtility::Math::ONE_PI, south, east, north});
+  return westHalf == eastHalf ? westHalf : Classification::Intersecting;
+}
+
+CesiumPolygonTileExcluder::Classification
+CesiumPolygonTileExcluder::classifyBounds(const Bounds& bounds) const noexcept {
+  const Bounds& grid = this->_gridBounds;
+  if (this->_polygons.empty() || bounds.west > grid.east ||
+      bounds.east < grid.west || bounds.south > grid.north ||
+      bounds.north < grid.south) {
+    return Classification::Outside;
+  }
+
+  const double cellWidth = (grid.east - grid.west) / this->_columns;
+  const double cellHeight = (grid.north - grid.south) / this->_rows;
+  const int32_t firstColumn =
+      toCell(bounds.west, grid.west, cellWidth, this->_columns);
+  const int32_t lastColumn =
+      toCell(bounds.east, grid.west, cellWidth, this->_columns);
+  const int32_t firstRow =
+      toCell(bounds.south, grid.south, cellHeight, this->_rows);
+  const int32_t lastRow =
+      toCell(bounds.north, grid.south, cellHeight, this->_rows);
+
+  std::vector<uint32_t> candidates;
+  for (int32_t row = firstRow; row <= lastRow; ++row) {
+    for (int32_t column = firstColumn; column <= lastColumn; ++column) {
+      const std::vector<uint32_t>& cell =
+          this->_cells[size_t(row) * size_t(this->_columns) + size_t(column)];
+      candidates.insert(candidates.end(), cell.begin(), cell.end());
+    }
+  }
+  std::sort(candidates.begin(), candidates.end());
+  candidates.erase(
+      std::unique(candidates.begin(), candidates.end()),
+      candidates.end());
+
+  const glm::dvec2 center(
+      (bounds.west + bounds.east) * 0.5,
+      (bounds.south + bounds.north) * 0.5);
+
+  Classification result = Classification::Outside;
+
+  for (uint32_t index : candidates) {
+    const Polygon& polygon = this->_polygons[index];
+    if (bounds.west > polygon.bounds.east ||
+        bounds.east < polygon.bounds.west ||
+        bounds.south > polygon.bounds.north ||
+        bounds.north < polygon.bounds.south) {
+      continue;
+    }
+
+    // If no edge of the polygon touches the rectangle, the rectangle is
+    // either entirely inside or entirely outside of it, which is decided by
+    // any point of the rectangle.
+    const std::vector<glm::dvec2>& vertices = polygon.vertices;
+    bool touches = false;
+    for (size_t i = 0, j = vertices.size() - 1; i < vertices.size(); j = i++) {
+      if (segmentTouchesBounds(
+              vertices[j],
+              vertices[i],
+              bounds.west,
+              bounds.south,
+              bounds.east,
+              bounds.north)) {
+        touches = true;
+        break;
+      }
+    }
+
+    if (touches) {
+      result = Classification::Intersecting;
+    } else if (pointInPolygon(center, vertices)) {
+      return Classification::Inside;
+    }
+  }
+
+  return result;
+}
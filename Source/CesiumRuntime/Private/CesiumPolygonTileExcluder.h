@@ -0,0 +1,71 @@
+// Copyright 2020-2021 CesiumGS, Inc. and Contributors
+
+#pragma once
+
+#include "Cesium3DTilesSelection/ITileExcluder.h"
+#include "CesiumGeospatial/CartographicPolygon.h"
+#include "CesiumGeospatial/GlobeRectangle.h"
+#include <glm/vec2.hpp>
+#include <vector>
+
+/**
+ * @brief Excludes the tiles that lie entirely inside any of a set of
+ * cartographic polygons.
+ *
+ * The bounding rectangles of the polygons are bucketed in a uniform
+ * longitude / latitude grid, so each tile is only tested against the polygons
+ * near it, and then only against the edges of the polygons whose bounding
+ * rectangles it overlaps.
+ */
+class CesiumPolygonTileExcluder : public Cesium3DTilesSelection::ITileExcluder {
+public:
+  /**
+   * @brief How a rectangle lies relative to the polygons.
+   */
+  enum class Classification {
+    /** The rectangle is entirely inside one of the polygons. */
+    Inside,
+    /** The rectangle is entirely outside all of the polygons. */
+    Outside,
+    /** The rectangle crosses the edge of at least one polygon. */
+    Intersecting
+  };
+
+  CesiumPolygonTileExcluder(
+      const std::vector<CesiumGeospatial::CartographicPolygon>& polygons);
+
+  virtual bool
+  shouldExclude(const Cesium3DTilesSelection::Tile& tile) const noexcept
+      override;
+
+  /**
+   * @brief Classifies a globe rectangle against the polygons. Rectangles that
+   * cross the anti-meridian are classified by both of their halves.
+   */
+  Classification
+  classify(const CesiumGeospatial::GlobeRectangle& rectangle) const noexcept;
+
+private:
+  struct Bounds {
+    double west;
+    double south;
+    double east;
+    double north;
+  };
+
+  struct Polygon {
+    Bounds bounds;
+    std::vector<glm::dvec2> vertices;
+  };
+
+  Classification classifyBounds(const Bounds& bounds) const noexcept;
+
+  std::vector<Polygon> _polygons;
+
+  // The grid covers the bounding rectangle of all of the polygons. Each cell
+  // holds the indices of the polygons whose bounding rectangles overlap it.
+  Bounds _gridBounds;
+  int32_t _columns;
+  int32_t _rows;
+  std::vector<std::vector<uint32_t>> _cells;
+};
@@ -0,0 +1,203 @@
+// Copyright 2020-2021 CesiumGS, Inc. and Contributors
+
+#include "CesiumPreloadViewAsyncAction.h"
+#include "Cesium3DTileset.h"
+#include "CesiumCameraManager.h"
+#include "CesiumGeoreference.h"
+#include "CesiumGeospatial/Ellipsoid.h"
+#include "CesiumRuntime.h"
+#include "Engine/World.h"
+#include "TimerManager.h"
+#include "VecMath.h"
+#include <glm/trigonometric.hpp>
+
+namespace {
+// The horizontal field of view of the camera looking down at a globe
+// rectangle.
+constexpr double GlobeRectangleFieldOfViewDegrees = 60.0;
+
+/**
+ * @brief Creates a camera that looks straight down at the given globe
+ * rectangle from high enough to see all of it.
+ */
+FCesiumCamera createGlobeRectangleCamera(
+    ACesiumGeoreference& georeference,
+    double west,
+    double south,
+    double east,
+    double north,
+    const FVector2D& viewportSize) {
+  if (east < west) {
+    // The rectangle crosses the anti-meridian.
+    east += 360.0;
+  }
+
+  const double longitude = (west + east) * 0.5;
+  const double latitude = (south + north) * 0.5;
+
+  const double radius = CesiumGeospatial::Ellipsoid::WGS84.getRadii().x;
+  const double width = glm::radians(east - west) * radius *
+                       glm::cos(glm::radians(latitude));
+  const double height = glm::radians(north - south) * radius;
+
+  const double tanHalfHorizontalFov =
+      glm::tan(glm::radians(GlobeRectangleFieldOfViewDegrees) * 0.5);
+  const double tanHalfVerticalFov = tanHalfHorizontalFov *
+                                    double(viewportSize.Y) /
+                                    double(viewportSize.X);
+  const double cameraHeight = glm::max(
+      width * 0.5 / tanHalfHorizontalFov,
+      height * 0.5 / tanHalfVerticalFov);
+
+  const FVector location = VecMath::createVector(
+      georeference.TransformLongitudeLatitudeHeightToUnreal(
+          glm::dvec3(longitude, latitude, cameraHeight)));
+  const FMatrix enuToUnreal =
+      georeference.InaccurateComputeEastNorthUpToUnreal(location);
+  const FQuat lookDown = FRotator(-90.0f, 0.0f, 0.0f).Quaternion();
+
+  return FCesiumCamera(
+      viewportSize,
+      location,
+      FRotator(enuToUnreal.ToQuat() * lookDown),
+      float(GlobeRectangleFieldOfViewDegrees));
+}
+} // namespace
+
+UCesiumPreloadViewAsyncAction* UCesiumPreloadViewAsyncAction::PreloadView(
+    ACesium3DTileset* Tileset,
+    const FCesiumCamera& Camera,
+    float MaximumScreenSpaceError,
+    float Timeout) {
+  UCesiumPreloadViewAsyncAction* pAction =
+      NewObject<UCesiumPreloadViewAsyncAction>();
+  pAction->_pTileset = Tileset;
+  pAction->_camera = Camera;
+  pAction->_maximumScreenSpaceError = MaximumScreenSpaceError;
+  pAction->_timeout = Timeout;
+  if (Tileset) {
+    pAction->RegisterWithGameInstance(Tileset);
+  }
+  return pAction;
+}
+
+UCesiumPreloadViewAsyncAction*
+UCesiumPreloadViewAsyncAction::PreloadGlobeRectangle(
+    ACesium3DTileset* Tileset,
+    double West,
+    double South,
+    double East,
+    double North,
+    FVector2D ViewportSize,
+    float MaximumScreenSpaceError,
+    float Timeout) {
+  UCesiumPreloadViewAsyncAction* pAction =
+      PreloadView(Tileset, FCesiumCamera(), MaximumScreenSpaceError, Timeout);
+  pAction->_cameraIsGlobeRectangle = true;
+  pAction->_camera.ViewportSize = FVector2D(
+      FMath::Max(ViewportSize.X, 1.0f),
+      FMath::Max(ViewportSize.Y, 1.0f));
+  pAction->_west = West;
+  pAction->_south = South;
+  pAction->_east = East;
+  pAction->_north = North;
+  return pAction;
+}
+
+void UCesiumPreloadViewAsyncAction::Activate() {
+  ACesium3DTileset* pTileset = this->_pTileset.Get();
+  UWorld* pWorld = pTileset ? pTileset->GetWorld() : nullptr;
+  ACesiumCameraManager* pCameraManager =
+      pWorld ? ACesiumCameraManager::GetDefaultCameraManager(pWorld) : nullptr;
+  if (!pCameraManager) {
+    UE_LOG(
+        LogCesium,
+        Warning,
+        TEXT("PreloadView requires a tileset in a world with a camera manager"));
+    this->_finish(false);
+    return;
+  }
+
+  if (this->_cameraIsGlobeRectangle) {
+    ACesiumGeoreference* pGeoreference = pTileset->ResolveGeoreference();
+    if (!pGeoreference) {
+      this->_finish(false);
+      return;
+    }
+    this->_camera = createGlobeRectangleCamera(
+        *pGeoreference,
+        this->_west,
+        this->_south,
+        this->_east,
+        this->_north,
+        this->_camera.ViewportSize);
+  }
+
+  // A smaller maximum screen-space error than the tileset's own selects
+  // finer tiles for this view, just as a taller viewport would.
+  if (this->_maximumScreenSpaceError > 0.0f) {
+    this->_camera.ScreenSpaceErrorScale =
+        pTileset->MaximumScreenSpaceError / this->_maximumScreenSpaceError;
+  }
+
+  this->_pCameraManager = pCameraManager;
+  this->_cameraId = pCameraManager->AddCamera(this->_camera);
+  this->_startTime = pWorld->GetRealTimeSeconds();
+  this->_startFrame = GFrameCounter;
+
+  pWorld->GetTimerManager().SetTimerForNextTick(
+      this,
+      &UCesiumPreloadViewAsyncAction::_poll);
+}
+
+void UCesiumPreloadViewAsyncAction::_poll() {
+  ACesium3DTileset* pTileset = this->_pTileset.Get();
+  UWorld* pWorld = pTileset ? pTileset->GetWorld() : nullptr;
+  if (!pWorld) {
+    this->_finish(false);
+    return;
+  }
+
+  // The load state is only meaningful once the tileset has selected tiles
+  // with the camera registered, which happens in its next tick.
+  if (GFrameCounter > this->_startFrame + 1) {
+    const float progress = pTileset->GetLoadProgress();
+    if (progress != this->_lastProgress) {
+      this->_lastProgress = progress;
+      this->OnProgress.Broadcast(progress);
+    }
+
+    if (pTileset->IsLoadComplete()) {
+      this->_finish(true);
+      return;
+    }
+  }
+
+  if (this->_timeout > 0.0f &&
+      pWorld->GetRealTimeSeconds() - this->_startTime >= this->_timeout) {
+    this->_finish(false);
+    return;
+  }
+
+  pWorld->GetTimerManager().SetTimerForNextTick(
+      this,
+      &UCesiumPreloadViewAsyncAction::_poll);
+}
+
+void UCesiumPreloadViewAsyncAction::_finish(bool completed) {
+  ACesiumCameraManager* pCameraManager = this->_pCameraManager.Get();
+  if (pCameraManager && this->_cameraId >= 0) {
+    pCameraManager->RemoveCamera(this->_cameraId);
+  }
+  this->_cameraId = -1;
+  this->_pCameraManager.Reset();
+
+  const float progress = FMath::Max(this->_lastProgress, 0.0f);
+  if (completed) {
+    this->OnCompleted.Broadcast(progress);
+  } else {
+    this->OnTimedOut.Broadcast(progress);
+  }
+
+  this->SetReadyToDestroy();
+}
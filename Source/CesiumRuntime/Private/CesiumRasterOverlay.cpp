@@ -25,6 +25,21 @@ void UCesiumRasterOverlay::PostEditChangeProperty(
     FPropertyChangedEvent& PropertyChangedEvent) {
   Super::PostEditChangeProperty(PropertyChangedEvent);
 
+  // The quality tier is applied to the overlay without reloading it.
+  const FName propertyName = PropertyChangedEvent.Property
+                                 ? PropertyChangedEvent.Property->GetFName()
+                                 : NAME_None;
+  if (propertyName ==
+          GET_MEMBER_NAME_CHECKED(UCesiumRasterOverlay, QualityTier) ||
+      propertyName ==
+          GET_MEMBER_NAME_CHECKED(UCesiumRasterOverlay, AdaptQualityTier) ||
+      propertyName == GET_MEMBER_NAME_CHECKED(
+                          UCesiumRasterOverlay,
+                          MaximumAdaptiveQualityTier)) {
+    this->applyQualityTier();
+    return;
+  }
+
   this->Refresh();
 }
 #endif
@@ -34,16 +49,32 @@ void UCesiumRasterOverlay::AddToTileset() {
     return;
   }
 
+  // Tilesets that are only loaded for collision have no use for overlays.
+  ACesium3DTileset* pActor = this->GetOwner<ACesium3DTileset>();
+  if (pActor && pActor->GetCollisionOnly()) {
+    return;
+  }
+
+  // The overlay is drawn on tiles created from the data of their parents, so
+  // a tileset that already released the data of some tiles is loaded again,
+  // this time keeping it, and adds the overlay once it is recreated.
+  if (pActor && pActor->HasReleasedTileData()) {
+    pActor->RefreshTileset();
+    return;
+  }
+
   Cesium3DTilesSelection::Tileset* pTileset = FindTileset();
   if (!pTileset) {
     return;
   }
 
   Cesium3DTilesSelection::RasterOverlayOptions options{};
-  options.maximumScreenSpaceError = this->MaximumScreenSpaceError;
-  options.maximumSimultaneousTileLoads = this->MaximumSimultaneousTileLoads;
-  options.maximumTextureSize = this->MaximumTextureSize;
-  options.subTileCacheBytes = this->SubTileCacheBytes;
+  options.maximumScreenSpaceError =
+      this->getEffectiveMaximumScreenSpaceError();
+  options.maximumSimultaneousTileLoads =
+      this->getEffectiveMaximumSimultaneousTileLoads();
+  options.maximumTextureSize = this->getEffectiveMaximumTextureSize();
+  options.subTileCacheBytes = this->getEffectiveSubTileCacheBytes();
   options.loadErrorCallback =
       [this](const Cesium3DTilesSelection::RasterOverlayLoadFailureDetails&
                  details) {
@@ -93,6 +124,10 @@ void UCesiumRasterOverlay::AddToTileset() {
     pTileset->getOverlays().add(std::move(pOverlay));
 
     this->OnAdd(pTileset, this->_pOverlay);
+
+    if (pActor) {
+      pActor->NotifyRasterOverlaysChanged();
+    }
   }
 }
 
@@ -109,6 +144,11 @@ void UCesiumRasterOverlay::RemoveFromTileset() {
   this->OnRemove(pTileset, this->_pOverlay);
   pTileset->getOverlays().remove(this->_pOverlay);
   this->_pOverlay = nullptr;
+
+  ACesium3DTileset* pActor = this->GetOwner<ACesium3DTileset>();
+  if (pActor) {
+    pActor->NotifyRasterOverlaysChanged();
+  }
 }
 
 void UCesiumRasterOverlay::Refresh() {
@@ -142,10 +182,27 @@ void UCesiumRasterOverlay::SetMaximumSimultaneousTileLoads(int32 Value) {
   this->MaximumSimultaneousTileLoads = Value;
 
   if (this->_pOverlay) {
-    this->_pOverlay->getOptions().maximumSimultaneousTileLoads = Value;
+    this->_pOverlay->getOptions().maximumSimultaneousTileLoads =
+        this->getEffectiveMaximumSimultaneousTileLoads();
   }
 }
 
+void UCesiumRasterOverlay::SetTileLoadLimit(int32 Value) {
+  this->_tileLoadLimit = Value;
+
+  if (this->_pOverlay) {
+    this->_pOverlay->getOptions().maximumSimultaneousTileLoads =
+        this->getEffectiveMaximumSimultaneousTileLoads();
+  }
+}
+
+int32 UCesiumRasterOverlay::getEffectiveMaximumSimultaneousTileLoads() const {
+  if (this->_tileLoadLimit < 0) {
+    return this->MaximumSimultaneousTileLoads;
+  }
+  return FMath::Min(this->MaximumSimultaneousTileLoads, this->_tileLoadLimit);
+}
+
 int64 UCesiumRasterOverlay::GetSubTileCacheBytes() const {
   return this->SubTileCacheBytes;
 }
@@ -154,8 +211,81 @@ void UCesiumRasterOverlay::SetSubTileCacheBytes(int64 Value) {
   this->SubTileCacheBytes = Value;
 
   if (this->_pOverlay) {
-    this->_pOverlay->getOptions().subTileCacheBytes = Value;
+    this->_pOverlay->getOptions().subTileCacheBytes =
+        this->getEffectiveSubTileCacheBytes();
+  }
+}
+
+void UCesiumRasterOverlay::SetSubTileCacheLimit(int64 Value) {
+  if (this->_subTileCacheLimit == Value) {
+    return;
   }
+
+  this->_subTileCacheLimit = Value;
+
+  if (this->_pOverlay) {
+    this->_pOverlay->getOptions().subTileCacheBytes =
+        this->getEffectiveSubTileCacheBytes();
+  }
+}
+
+int64 UCesiumRasterOverlay::getEffectiveSubTileCacheBytes() const {
+  if (this->_subTileCacheLimit < 0) {
+    return this->SubTileCacheBytes;
+  }
+  return FMath::Min(this->SubTileCacheBytes, this->_subTileCacheLimit);
+}
+
+int32 UCesiumRasterOverlay::GetQualityTier() const {
+  return this->QualityTier;
+}
+
+void UCesiumRasterOverlay::SetQualityTier(int32 Value) {
+  this->QualityTier = FMath::Clamp(Value, 0, 4);
+  this->applyQualityTier();
+}
+
+int32 UCesiumRasterOverlay::GetEffectiveQualityTier() const {
+  const int32 adaptiveQualityTier = FMath::Min(
+      this->_adaptiveQualityTier,
+      this->GetMaximumAdaptiveQualityTier());
+  return FMath::Max(this->QualityTier, adaptiveQualityTier);
+}
+
+int32 UCesiumRasterOverlay::GetMaximumAdaptiveQualityTier() const {
+  return this->AdaptQualityTier ? this->MaximumAdaptiveQualityTier : 0;
+}
+
+void UCesiumRasterOverlay::SetAdaptiveQualityTier(int32 Value) {
+  this->_adaptiveQualityTier = Value;
+  this->applyQualityTier();
+}
+
+double UCesiumRasterOverlay::getEffectiveMaximumScreenSpaceError() const {
+  return double(this->MaximumScreenSpaceError) *
+         double(1 << this->GetEffectiveQualityTier());
+}
+
+int32 UCesiumRasterOverlay::getEffectiveMaximumTextureSize() const {
+  // Textures smaller than this would make the overlay unrecognizable.
+  const int32 minimumTextureSize = 64;
+  return FMath::Max(
+      this->MaximumTextureSize >> this->GetEffectiveQualityTier(),
+      FMath::Min(this->MaximumTextureSize, minimumTextureSize));
+}
+
+void UCesiumRasterOverlay::applyQualityTier() {
+  if (!this->_pOverlay) {
+    return;
+  }
+
+  // The options are read whenever overlay tiles are mapped to geometry tiles
+  // and loaded, so the overlay tiles that are already loaded are kept.
+  Cesium3DTilesSelection::RasterOverlayOptions& options =
+      this->_pOverlay->getOptions();
+  options.maximumScreenSpaceError =
+      this->getEffectiveMaximumScreenSpaceError();
+  options.maximumTextureSize = this->getEffectiveMaximumTextureSize();
 }
 
 void UCesiumRasterOverlay::Activate(bool bReset) {
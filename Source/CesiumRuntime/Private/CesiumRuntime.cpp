@@ -1,9 +1,27 @@
 // Copyright 2020-2021 CesiumGS, Inc. and Contributors
 
 #include "CesiumRuntime.h"
+#include "Async/Async.h"
 #include "Cesium3DTilesSelection/registerAllTileContentTypes.h"
+#include "CesiumAsync/AsyncSystem.h"
+#include "CesiumAsync/CachingAssetAccessor.h"
+#include "CesiumAsync/SqliteCache.h"
+#include "CesiumBackgroundPruneCache.h"
+#include "CesiumClusterCacheAssetAccessor.h"
+#include "CesiumFileAssetAccessor.h"
+#include "CesiumGunzipAssetAccessor.h"
+#include "CesiumIonEndpointCache.h"
+#include "CesiumLifetime.h"
+#include "CesiumMemoryCache.h"
+#include "CesiumMemoryPressure.h"
+#include "CesiumRuntimeSettings.h"
+#include "CesiumTileBundle.h"
 #include "CesiumUtility/Tracing.h"
+#include "HAL/FileManager.h"
+#include "Misc/Paths.h"
 #include "SpdlogUnrealLoggerSink.h"
+#include "UnrealAssetAccessor.h"
+#include "UnrealTaskProcessor.h"
 #include <Modules/ModuleManager.h>
 #include <spdlog/spdlog.h>
 
@@ -15,6 +33,13 @@
 
 DEFINE_LOG_CATEGORY(LogCesium);
 
+// The asset accessor created in a background task at startup, because opening
+// the request cache can take a while on large cache files.
+static TFuture<std::shared_ptr<CesiumAsync::IAssetAccessor>>
+    futureAssetAccessor;
+
+static void startCreatingAssetAccessor();
+
 void FCesiumRuntimeModule::StartupModule() {
   Cesium3DTilesSelection::registerAllTileContentTypes();
 
@@ -23,6 +48,11 @@ void FCesiumRuntimeModule::StartupModule() {
 
   FModuleManager::Get().LoadModuleChecked(TEXT("HTTP"));
 
+  CesiumMemoryPressure::startup();
+
+  getAsyncSystem();
+  startCreatingAssetAccessor();
+
   CESIUM_TRACE_INIT(
       "cesium-trace-" +
       std::to_string(std::chrono::time_point_cast<std::chrono::microseconds>(
@@ -32,7 +62,15 @@ void FCesiumRuntimeModule::StartupModule() {
       ".json");
 }
 
-void FCesiumRuntimeModule::ShutdownModule() { CESIUM_TRACE_SHUTDOWN(); }
+void FCesiumRuntimeModule::ShutdownModule() {
+  if (futureAssetAccessor.IsValid()) {
+    futureAssetAccessor.Wait();
+  }
+  CesiumMemoryPressure::shutdown();
+  CesiumLifetime::shutdown();
+  UnrealTaskProcessor::shutdown();
+  CESIUM_TRACE_SHUTDOWN();
+}
 
 #undef LOCTEXT_NAMESPACE
 
@@ -41,3 +79,150 @@ IMPLEMENT_MODULE(FCesiumRuntimeModule, CesiumRuntime)
 FCesium3DTilesetIonTroubleshooting OnCesium3DTilesetIonTroubleshooting{};
 FCesiumRasterOverlayIonTroubleshooting
     OnCesiumRasterOverlayIonTroubleshooting{};
+
+static std::string getCacheDatabaseName() {
+  FString BaseDirectory =
+      GetDefault<UCesiumRuntimeSettings>()->RequestCacheDirectory;
+  if (!BaseDirectory.IsEmpty()) {
+    if (!IFileManager::Get().DirectoryExists(*BaseDirectory)) {
+      IFileManager::Get().MakeDirectory(*BaseDirectory, true);
+    }
+  } else {
+#if PLATFORM_ANDROID
+    BaseDirectory = FPaths::ProjectPersistentDownloadDir();
+#elif PLATFORM_IOS
+    BaseDirectory = FPaths::Combine(*FPaths::ProjectSavedDir(), TEXT("Cesium"));
+    if (!IFileManager::Get().DirectoryExists(*BaseDirectory)) {
+      IFileManager::Get().MakeDirectory(*BaseDirectory, true);
+    }
+#else
+    BaseDirectory = FPaths::EngineUserDir();
+#endif
+  }
+
+  FString CesiumDBFile =
+      FPaths::Combine(*BaseDirectory, TEXT("cesium-request-cache.sqlite"));
+  FString PlatformAbsolutePath =
+      IFileManager::Get().ConvertToAbsolutePathForExternalAppForWrite(
+          *CesiumDBFile);
+
+  UE_LOG(
+      LogCesium,
+      Display,
+      TEXT("Caching Cesium requests in %s"),
+      *PlatformAbsolutePath);
+
+  return TCHAR_TO_UTF8(*PlatformAbsolutePath);
+}
+
+static std::shared_ptr<CesiumAsync::ICacheDatabase> createCacheDatabase() {
+  const UCesiumRuntimeSettings* pSettings =
+      GetDefault<UCesiumRuntimeSettings>();
+
+  std::shared_ptr<CesiumAsync::ICacheDatabase> pDatabase =
+      std::make_shared<CesiumAsync::SqliteCache>(
+          spdlog::default_logger(),
+          getCacheDatabaseName(),
+          uint64_t(pSettings->MaximumCachedRequests));
+
+  pDatabase = std::make_shared<CesiumBackgroundPruneCache>(
+      pDatabase,
+      pSettings->PruneRequestCacheInBackground);
+
+  const int64 memoryCacheBytes = pSettings->MemoryCacheBytes;
+  if (memoryCacheBytes > 0) {
+    pDatabase =
+        std::make_shared<CesiumMemoryCache>(pDatabase, memoryCacheBytes);
+  }
+
+  return pDatabase;
+}
+
+static std::shared_ptr<CesiumAsync::IAssetAccessor> createAssetAccessor(
+    const std::shared_ptr<UnrealAssetAccessor>& pHttpAccessor) {
+  CESIUM_TRACE("createAssetAccessor");
+  const UCesiumRuntimeSettings* pSettings =
+      GetDefault<UCesiumRuntimeSettings>();
+
+  std::shared_ptr<CesiumAsync::IAssetAccessor> pNetworkAccessor = pHttpAccessor;
+  if (!pSettings->ClusterCacheServerUrl.IsEmpty()) {
+    UE_LOG(
+        LogCesium,
+        Display,
+        TEXT("Sending Cesium requests through the cluster cache server %s"),
+        *pSettings->ClusterCacheServerUrl);
+    pNetworkAccessor = std::make_shared<CesiumClusterCacheAssetAccessor>(
+        pNetworkAccessor,
+        TCHAR_TO_UTF8(*pSettings->ClusterCacheServerUrl));
+  }
+
+  std::shared_ptr<CesiumAsync::IAssetAccessor> pAssetAccessor =
+      std::make_shared<CesiumAsync::CachingAssetAccessor>(
+          spdlog::default_logger(),
+          pNetworkAccessor,
+          createCacheDatabase(),
+          pSettings->RequestsPerCachePrune);
+
+  std::vector<std::shared_ptr<CesiumTileBundle>> bundles;
+  for (const FString& path : pSettings->TileBundles) {
+    std::shared_ptr<CesiumTileBundle> pBundle = CesiumTileBundle::open(
+        FPaths::ConvertRelativePathToFull(FPaths::ProjectDir(), path));
+    if (pBundle) {
+      bundles.emplace_back(std::move(pBundle));
+    }
+  }
+
+  if (!bundles.empty()) {
+    pAssetAccessor = std::make_shared<CesiumTileBundleAssetAccessor>(
+        std::move(bundles),
+        pAssetAccessor);
+  }
+
+  // Compressed responses are cached as they are, and decompressed each time
+  // they are read.
+  pAssetAccessor = std::make_shared<CesiumGunzipAssetAccessor>(pAssetAccessor);
+
+  if (pSettings->CacheIonEndpoints) {
+    pAssetAccessor =
+        std::make_shared<CesiumIonEndpointCacheAssetAccessor>(pAssetAccessor);
+  }
+
+  // Local files are read directly, without the HTTP module or the cache.
+  return std::make_shared<CesiumFileAssetAccessor>(pAssetAccessor);
+}
+
+static void startCreatingAssetAccessor() {
+  if (!FPlatformProcess::SupportsMultithreading()) {
+    // The asset accessor is created when it is first used instead.
+    return;
+  }
+
+  // The HTTP accessor reads the plugin descriptor and the settings, so it is
+  // created here in the game thread. The settings object already exists by
+  // then, and the background task only reads from it.
+  std::shared_ptr<UnrealAssetAccessor> pHttpAccessor =
+      std::make_shared<UnrealAssetAccessor>();
+  futureAssetAccessor = Async(
+      EAsyncExecution::ThreadPool,
+      [pHttpAccessor = std::move(pHttpAccessor)]() {
+        return createAssetAccessor(pHttpAccessor);
+      });
+}
+
+bool isAssetAccessorReady() noexcept {
+  return !futureAssetAccessor.IsValid() || futureAssetAccessor.IsReady();
+}
+
+const std::shared_ptr<CesiumAsync::IAssetAccessor>& getAssetAccessor() {
+  static std::shared_ptr<CesiumAsync::IAssetAccessor> pAssetAccessor =
+      futureAssetAccessor.IsValid()
+          ? futureAssetAccessor.Get()
+          : createAssetAccessor(std::make_shared<UnrealAssetAccessor>());
+  return pAssetAccessor;
+}
+
+CesiumAsync::AsyncSystem& getAsyncSystem() noexcept {
+  static CesiumAsync::AsyncSystem asyncSystem(
+      std::make_shared<UnrealTaskProcessor>());
+  return asyncSystem;
+}
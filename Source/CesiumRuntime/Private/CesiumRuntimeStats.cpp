@@ -0,0 +1,300 @@
+// Copyright 2020-2021 CesiumGS, Inc. and Contributors
+
+#include "CesiumRuntimeStats.h"
+#include "Cesium3DTilesSelection/ViewUpdateResult.h"
+#include "CesiumTilesetMemoryStatistics.h"
+#include "CoreGlobals.h"
+#include "ProfilingDebugging/CsvProfiler.h"
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+CSV_DEFINE_CATEGORY(Cesium, true);
+
+DEFINE_STAT(STAT_CesiumTileModels);
+DEFINE_STAT(STAT_CesiumMaterials);
+DEFINE_STAT(STAT_CesiumVertexBufferMemory);
+DEFINE_STAT(STAT_CesiumIndexBufferMemory);
+DEFINE_STAT(STAT_CesiumTextureMemory);
+DEFINE_STAT(STAT_CesiumRasterOverlayTextureMemory);
+DEFINE_STAT(STAT_CesiumCollisionMemory);
+DEFINE_STAT(STAT_CesiumTilesVisited);
+DEFINE_STAT(STAT_CesiumCulledTilesVisited);
+DEFINE_STAT(STAT_CesiumTilesCulled);
+DEFINE_STAT(STAT_CesiumTilesRendered);
+DEFINE_STAT(STAT_CesiumTilesLoadingHigh);
+DEFINE_STAT(STAT_CesiumTilesLoadingMedium);
+DEFINE_STAT(STAT_CesiumTilesLoadingLow);
+DEFINE_STAT(STAT_CesiumMaxDepthVisited);
+DEFINE_STAT(STAT_CesiumMainThreadFinalize);
+DEFINE_STAT(STAT_CesiumRequestsInFlight);
+DEFINE_STAT(STAT_CesiumRequestsCompleted);
+DEFINE_STAT(STAT_CesiumRequestsFailed);
+DEFINE_STAT(STAT_CesiumRequestsCoalesced);
+DEFINE_STAT(STAT_CesiumBytesDownloaded);
+DEFINE_STAT(STAT_CesiumRequestLatencyP50);
+DEFINE_STAT(STAT_CesiumRequestLatencyP90);
+DEFINE_STAT(STAT_CesiumRequestLatencyP99);
+DEFINE_STAT(STAT_CesiumCacheMemoryHits);
+DEFINE_STAT(STAT_CesiumCacheDiskHits);
+DEFINE_STAT(STAT_CesiumCacheMisses);
+DEFINE_STAT(STAT_CesiumCacheHitRatio);
+DEFINE_STAT(STAT_CesiumCacheReadTime);
+DEFINE_STAT(STAT_CesiumCacheWriteTime);
+DEFINE_STAT(STAT_CesiumLoadThreadTime);
+DEFINE_STAT(STAT_CesiumGameThreadTime);
+DEFINE_STAT(STAT_CesiumObjectsPendingDestruction);
+DEFINE_STAT(STAT_CesiumObjectsDestroyed);
+
+namespace {
+// The number of the most recent request latencies that the percentiles are
+// computed from.
+constexpr size_t LatencyWindowSize = 1024;
+
+struct RequestCounters {
+  std::atomic<int32> inFlight{0};
+  std::atomic<int64> completed{0};
+  std::atomic<int64> bytesDownloaded{0};
+  std::atomic<int64> requestMicroseconds{0};
+  std::atomic<int64> loadThreadMicroseconds{0};
+  std::atomic<int64> memoryHits{0};
+  std::atomic<int64> diskHits{0};
+  std::atomic<int64> misses{0};
+
+  std::mutex latencyMutex;
+  std::vector<float> latenciesMs;
+  size_t nextLatency = 0;
+  bool latenciesChanged = false;
+
+  double gameThreadSeconds = 0.0;
+
+  uint64 lastUpdateFrame = ~uint64(0);
+};
+
+RequestCounters& getCounters() {
+  static RequestCounters counters;
+  return counters;
+}
+
+float getPercentile(std::vector<float>& values, double percentile) {
+  size_t index = size_t(percentile * double(values.size() - 1));
+  std::nth_element(values.begin(), values.begin() + index, values.end());
+  return values[index];
+}
+} // namespace
+
+void CesiumRuntimeStats::addTileMemoryUsage(
+    const FCesiumTilesetMemoryStatistics& usage) {
+  INC_DWORD_STAT_BY(STAT_CesiumTileModels, usage.TileModels);
+  INC_DWORD_STAT_BY(STAT_CesiumMaterials, usage.Materials);
+  INC_MEMORY_STAT_BY(STAT_CesiumVertexBufferMemory, usage.VertexBufferBytes);
+  INC_MEMORY_STAT_BY(STAT_CesiumIndexBufferMemory, usage.IndexBufferBytes);
+  INC_MEMORY_STAT_BY(STAT_CesiumTextureMemory, usage.TextureBytes);
+  INC_MEMORY_STAT_BY(STAT_CesiumCollisionMemory, usage.CollisionBytes);
+}
+
+void CesiumRuntimeStats::removeTileMemoryUsage(
+    const FCesiumTilesetMemoryStatistics& usage) {
+  DEC_DWORD_STAT_BY(STAT_CesiumTileModels, usage.TileModels);
+  DEC_DWORD_STAT_BY(STAT_CesiumMaterials, usage.Materials);
+  DEC_MEMORY_STAT_BY(STAT_CesiumVertexBufferMemory, usage.VertexBufferBytes);
+  DEC_MEMORY_STAT_BY(STAT_CesiumIndexBufferMemory, usage.IndexBufferBytes);
+  DEC_MEMORY_STAT_BY(STAT_CesiumTextureMemory, usage.TextureBytes);
+  DEC_MEMORY_STAT_BY(STAT_CesiumCollisionMemory, usage.CollisionBytes);
+}
+
+void CesiumRuntimeStats::addRequestStarted(bool coalesced) {
+  if (coalesced) {
+    INC_DWORD_STAT(STAT_CesiumRequestsCoalesced);
+    return;
+  }
+
+  ++getCounters().inFlight;
+  INC_DWORD_STAT(STAT_CesiumRequestsInFlight);
+}
+
+void CesiumRuntimeStats::addRequestCompleted(
+    double latencySeconds,
+    int64 bytes,
+    bool succeeded) {
+  RequestCounters& counters = getCounters();
+  --counters.inFlight;
+  ++counters.completed;
+  counters.bytesDownloaded += bytes;
+  counters.requestMicroseconds += int64(latencySeconds * 1000000.0);
+
+  DEC_DWORD_STAT(STAT_CesiumRequestsInFlight);
+  INC_MEMORY_STAT_BY(STAT_CesiumBytesDownloaded, bytes);
+  if (succeeded) {
+    INC_DWORD_STAT(STAT_CesiumRequestsCompleted);
+  } else {
+    INC_DWORD_STAT(STAT_CesiumRequestsFailed);
+  }
+
+  std::lock_guard<std::mutex> lock(counters.latencyMutex);
+  const float latencyMs = float(latencySeconds * 1000.0);
+  if (counters.latenciesMs.size() < LatencyWindowSize) {
+    counters.latenciesMs.push_back(latencyMs);
+  } else {
+    counters.latenciesMs[counters.nextLatency] = latencyMs;
+  }
+  counters.nextLatency = (counters.nextLatency + 1) % LatencyWindowSize;
+  counters.latenciesChanged = true;
+}
+
+void CesiumRuntimeStats::addCacheMemoryHit() {
+  ++getCounters().memoryHits;
+  INC_DWORD_STAT(STAT_CesiumCacheMemoryHits);
+}
+
+void CesiumRuntimeStats::addCacheDiskLookup(bool hit, double seconds) {
+  if (hit) {
+    ++getCounters().diskHits;
+    INC_DWORD_STAT(STAT_CesiumCacheDiskHits);
+  } else {
+    ++getCounters().misses;
+    INC_DWORD_STAT(STAT_CesiumCacheMisses);
+  }
+  INC_FLOAT_STAT_BY(STAT_CesiumCacheReadTime, float(seconds * 1000.0));
+}
+
+void CesiumRuntimeStats::addCacheWrite(double seconds) {
+  INC_FLOAT_STAT_BY(STAT_CesiumCacheWriteTime, float(seconds * 1000.0));
+}
+
+void CesiumRuntimeStats::addTilePrepared(double seconds) {
+  RequestCounters& counters = getCounters();
+  counters.loadThreadMicroseconds += int64(seconds * 1000000.0);
+  INC_FLOAT_STAT_BY(STAT_CesiumLoadThreadTime, float(seconds * 1000.0));
+}
+
+CesiumRuntimeStats::LoadTotals CesiumRuntimeStats::getLoadTotals() {
+  const RequestCounters& counters = getCounters();
+  LoadTotals totals;
+  totals.requestsCompleted = counters.completed;
+  totals.bytesDownloaded = counters.bytesDownloaded;
+  totals.requestSeconds = double(counters.requestMicroseconds) / 1000000.0;
+  totals.loadThreadSeconds =
+      double(counters.loadThreadMicroseconds) / 1000000.0;
+  return totals;
+}
+
+void CesiumRuntimeStats::addViewUpdateResult(
+    const Cesium3DTilesSelection::ViewUpdateResult& result) {
+#if STATS || CSV_PROFILER
+  const int32 tilesRendered = int32(result.tilesToRenderThisFrame.size());
+  INC_DWORD_STAT_BY(STAT_CesiumTilesVisited, result.tilesVisited);
+  INC_DWORD_STAT_BY(STAT_CesiumCulledTilesVisited, result.culledTilesVisited);
+  INC_DWORD_STAT_BY(STAT_CesiumTilesCulled, result.tilesCulled);
+  INC_DWORD_STAT_BY(STAT_CesiumTilesRendered, tilesRendered);
+  INC_DWORD_STAT_BY(
+      STAT_CesiumTilesLoadingHigh,
+      result.tilesLoadingHighPriority);
+  INC_DWORD_STAT_BY(
+      STAT_CesiumTilesLoadingMedium,
+      result.tilesLoadingMediumPriority);
+  INC_DWORD_STAT_BY(STAT_CesiumTilesLoadingLow, result.tilesLoadingLowPriority);
+
+  // Counter stats are cleared every frame, so the largest depth of all
+  // tilesets is kept by only ever raising it within a frame.
+  static uint64 maxDepthFrame = ~uint64(0);
+  static uint32 maxDepth = 0;
+  if (maxDepthFrame != GFrameCounter) {
+    maxDepthFrame = GFrameCounter;
+    maxDepth = 0;
+  }
+  if (result.maxDepthVisited > maxDepth) {
+    INC_DWORD_STAT_BY(
+        STAT_CesiumMaxDepthVisited,
+        result.maxDepthVisited - maxDepth);
+    maxDepth = result.maxDepthVisited;
+  }
+
+  CSV_CUSTOM_STAT(
+      Cesium,
+      TilesVisited,
+      int32(result.tilesVisited),
+      ECsvCustomStatOp::Accumulate);
+  CSV_CUSTOM_STAT(
+      Cesium,
+      TilesRendered,
+      tilesRendered,
+      ECsvCustomStatOp::Accumulate);
+  CSV_CUSTOM_STAT(
+      Cesium,
+      TilesLoading,
+      int32(
+          result.tilesLoadingHighPriority + result.tilesLoadingMediumPriority +
+          result.tilesLoadingLowPriority),
+      ECsvCustomStatOp::Accumulate);
+#endif
+}
+
+void CesiumRuntimeStats::addGameThreadTime(double seconds) {
+  getCounters().gameThreadSeconds += seconds;
+  INC_FLOAT_STAT_BY(STAT_CesiumGameThreadTime, float(seconds * 1000.0));
+}
+
+double CesiumRuntimeStats::getGameThreadSeconds() {
+  return getCounters().gameThreadSeconds;
+}
+
+void CesiumRuntimeStats::updateRequestStats() {
+#if STATS || CSV_PROFILER
+  RequestCounters& counters = getCounters();
+  if (counters.lastUpdateFrame == GFrameCounter) {
+    return;
+  }
+  counters.lastUpdateFrame = GFrameCounter;
+
+  const int64 memoryHits = counters.memoryHits;
+  const int64 diskHits = counters.diskHits;
+  const int64 lookups = memoryHits + diskHits + counters.misses;
+  const float hitRatio =
+      lookups > 0 ? 100.0f * float(memoryHits + diskHits) / float(lookups)
+                  : 0.0f;
+  SET_FLOAT_STAT(STAT_CesiumCacheHitRatio, hitRatio);
+
+  std::vector<float> latencies;
+  {
+    std::lock_guard<std::mutex> lock(counters.latencyMutex);
+    if (counters.latenciesChanged) {
+      latencies = counters.latenciesMs;
+      counters.latenciesChanged = false;
+    }
+  }
+
+  if (!latencies.empty()) {
+    SET_FLOAT_STAT(STAT_CesiumRequestLatencyP50, getPercentile(latencies, 0.5));
+    SET_FLOAT_STAT(STAT_CesiumRequestLatencyP90, getPercentile(latencies, 0.9));
+    SET_FLOAT_STAT(
+        STAT_CesiumRequestLatencyP99,
+        getPercentile(latencies, 0.99));
+  }
+
+  CSV_CUSTOM_STAT(
+      Cesium,
+      RequestsInFlight,
+      int32(counters.inFlight),
+      ECsvCustomStatOp::Set);
+  CSV_CUSTOM_STAT(
+      Cesium,
+      MegabytesDownloaded,
+      float(double(counters.bytesDownloaded) / (1024.0 * 1024.0)),
+      ECsvCustomStatOp::Set);
+  CSV_CUSTOM_STAT(Cesium, CacheHitRatio, hitRatio, ECsvCustomStatOp::Set);
+#endif
+}
+
+void CesiumRuntimeStats::updateDestructionStats(
+    int32 pending,
+    int32 destroyed) {
+  SET_DWORD_STAT(STAT_CesiumObjectsPendingDestruction, pending);
+  SET_DWORD_STAT(STAT_CesiumObjectsDestroyed, destroyed);
+  CSV_CUSTOM_STAT(
+      Cesium,
+      ObjectsPendingDestruction,
+      pending,
+      ECsvCustomStatOp::Set);
+}
@@ -0,0 +1,272 @@
+// Copyright 2020-2021 CesiumGS, Inc. and Contributors
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Stats/Stats.h"
+
+struct FCesiumTilesetMemoryStatistics;
+
+namespace Cesium3DTilesSelection {
+class ViewUpdateResult;
+}
+
+DECLARE_STATS_GROUP(TEXT("Cesium"), STATGROUP_Cesium, STATCAT_Advanced);
+
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(
+    TEXT("Tile Models"),
+    STAT_CesiumTileModels,
+    STATGROUP_Cesium, );
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(
+    TEXT("Materials"),
+    STAT_CesiumMaterials,
+    STATGROUP_Cesium, );
+DECLARE_MEMORY_STAT_EXTERN(
+    TEXT("Vertex Buffer Memory"),
+    STAT_CesiumVertexBufferMemory,
+    STATGROUP_Cesium, );
+DECLARE_MEMORY_STAT_EXTERN(
+    TEXT("Index Buffer Memory"),
+    STAT_CesiumIndexBufferMemory,
+    STATGROUP_Cesium, );
+DECLARE_MEMORY_STAT_EXTERN(
+    TEXT("Texture Memory"),
+    STAT_CesiumTextureMemory,
+    STATGROUP_Cesium, );
+DECLARE_MEMORY_STAT_EXTERN(
+    TEXT("Raster Overlay Texture Memory"),
+    STAT_CesiumRasterOverlayTextureMemory,
+    STATGROUP_Cesium, );
+DECLARE_MEMORY_STAT_EXTERN(
+    TEXT("Collision Memory"),
+    STAT_CesiumCollisionMemory,
+    STATGROUP_Cesium, );
+
+DECLARE_DWORD_COUNTER_STAT_EXTERN(
+    TEXT("Tiles Visited"),
+    STAT_CesiumTilesVisited,
+    STATGROUP_Cesium, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(
+    TEXT("Culled Tiles Visited"),
+    STAT_CesiumCulledTilesVisited,
+    STATGROUP_Cesium, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(
+    TEXT("Tiles Culled"),
+    STAT_CesiumTilesCulled,
+    STATGROUP_Cesium, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(
+    TEXT("Tiles Rendered"),
+    STAT_CesiumTilesRendered,
+    STATGROUP_Cesium, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(
+    TEXT("Tiles Loading (High Priority)"),
+    STAT_CesiumTilesLoadingHigh,
+    STATGROUP_Cesium, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(
+    TEXT("Tiles Loading (Medium Priority)"),
+    STAT_CesiumTilesLoadingMedium,
+    STATGROUP_Cesium, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(
+    TEXT("Tiles Loading (Low Priority)"),
+    STAT_CesiumTilesLoadingLow,
+    STATGROUP_Cesium, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(
+    TEXT("Max Depth Visited"),
+    STAT_CesiumMaxDepthVisited,
+    STATGROUP_Cesium, );
+DECLARE_CYCLE_STAT_EXTERN(
+    TEXT("Main Thread Tile Finalize"),
+    STAT_CesiumMainThreadFinalize,
+    STATGROUP_Cesium, );
+
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(
+    TEXT("Requests In Flight"),
+    STAT_CesiumRequestsInFlight,
+    STATGROUP_Cesium, );
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(
+    TEXT("Requests Completed"),
+    STAT_CesiumRequestsCompleted,
+    STATGROUP_Cesium, );
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(
+    TEXT("Requests Failed"),
+    STAT_CesiumRequestsFailed,
+    STATGROUP_Cesium, );
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(
+    TEXT("Requests Coalesced"),
+    STAT_CesiumRequestsCoalesced,
+    STATGROUP_Cesium, );
+DECLARE_MEMORY_STAT_EXTERN(
+    TEXT("Bytes Downloaded"),
+    STAT_CesiumBytesDownloaded,
+    STATGROUP_Cesium, );
+DECLARE_FLOAT_ACCUMULATOR_STAT_EXTERN(
+    TEXT("Request Latency P50 (ms)"),
+    STAT_CesiumRequestLatencyP50,
+    STATGROUP_Cesium, );
+DECLARE_FLOAT_ACCUMULATOR_STAT_EXTERN(
+    TEXT("Request Latency P90 (ms)"),
+    STAT_CesiumRequestLatencyP90,
+    STATGROUP_Cesium, );
+DECLARE_FLOAT_ACCUMULATOR_STAT_EXTERN(
+    TEXT("Request Latency P99 (ms)"),
+    STAT_CesiumRequestLatencyP99,
+    STATGROUP_Cesium, );
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(
+    TEXT("Cache Memory Hits"),
+    STAT_CesiumCacheMemoryHits,
+    STATGROUP_Cesium, );
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(
+    TEXT("Cache Disk Hits"),
+    STAT_CesiumCacheDiskHits,
+    STATGROUP_Cesium, );
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(
+    TEXT("Cache Misses"),
+    STAT_CesiumCacheMisses,
+    STATGROUP_Cesium, );
+DECLARE_FLOAT_ACCUMULATOR_STAT_EXTERN(
+    TEXT("Cache Hit Ratio (%)"),
+    STAT_CesiumCacheHitRatio,
+    STATGROUP_Cesium, );
+DECLARE_FLOAT_ACCUMULATOR_STAT_EXTERN(
+    TEXT("Total Cache Read Time (ms)"),
+    STAT_CesiumCacheReadTime,
+    STATGROUP_Cesium, );
+DECLARE_FLOAT_ACCUMULATOR_STAT_EXTERN(
+    TEXT("Total Cache Write Time (ms)"),
+    STAT_CesiumCacheWriteTime,
+    STATGROUP_Cesium, );
+DECLARE_FLOAT_ACCUMULATOR_STAT_EXTERN(
+    TEXT("Total Load Thread Time (ms)"),
+    STAT_CesiumLoadThreadTime,
+    STATGROUP_Cesium, );
+DECLARE_FLOAT_ACCUMULATOR_STAT_EXTERN(
+    TEXT("Total Game Thread Time (ms)"),
+    STAT_CesiumGameThreadTime,
+    STATGROUP_Cesium, );
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(
+    TEXT("Objects Pending Destruction"),
+    STAT_CesiumObjectsPendingDestruction,
+    STATGROUP_Cesium, );
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(
+    TEXT("Objects Destroyed"),
+    STAT_CesiumObjectsDestroyed,
+    STATGROUP_Cesium, );
+
+namespace CesiumRuntimeStats {
+
+/**
+ * The totals of the request and load thread counters since startup, which
+ * are compared between two points in time to measure the recent throughput.
+ */
+struct LoadTotals {
+  /**
+   * The number of requests that finished, successfully or not.
+   */
+  int64 requestsCompleted = 0;
+
+  /**
+   * The number of bytes of content received.
+   */
+  int64 bytesDownloaded = 0;
+
+  /**
+   * The sum of the latencies of the finished requests, in seconds.
+   */
+  double requestSeconds = 0.0;
+
+  /**
+   * The time spent converting tile content in load threads, in seconds.
+   */
+  double loadThreadSeconds = 0.0;
+};
+
+/**
+ * Adds the given memory usage of a tile model to the Cesium stats. Raster
+ * overlay textures are not included, because they are shared between tiles.
+ */
+void addTileMemoryUsage(const FCesiumTilesetMemoryStatistics& Usage);
+
+/**
+ * Removes the given memory usage of a tile model from the Cesium stats.
+ */
+void removeTileMemoryUsage(const FCesiumTilesetMemoryStatistics& Usage);
+
+/**
+ * Records that a request was started, or that it was coalesced with an
+ * identical request already in flight. May be called from any thread.
+ */
+void addRequestStarted(bool coalesced);
+
+/**
+ * Records that a request that was started finished after the given number of
+ * seconds, with the given number of bytes of content. May be called from any
+ * thread.
+ */
+void addRequestCompleted(double latencySeconds, int64 bytes, bool succeeded);
+
+/**
+ * Records that a cache lookup was answered from memory. May be called from
+ * any thread.
+ */
+void addCacheMemoryHit();
+
+/**
+ * Records a lookup in the on-disk cache, and how long it took. May be called
+ * from any thread.
+ */
+void addCacheDiskLookup(bool hit, double seconds);
+
+/**
+ * Records a write to the on-disk cache, and how long it took. May be called
+ * from any thread.
+ */
+void addCacheWrite(double seconds);
+
+/**
+ * Records that the content of a tile was converted to Unreal resources in a
+ * load thread, and how long it took. May be called from any thread.
+ */
+void addTilePrepared(double seconds);
+
+/**
+ * Gets the current totals of the request and load thread counters. May be
+ * called from any thread.
+ */
+LoadTotals getLoadTotals();
+
+/**
+ * Adds the tile counts of the tile selection of one tileset in this frame to
+ * the Cesium stats and the CSV profile. The counts of all tilesets are
+ * summed, except for the maximum depth. Must be called from the game thread.
+ */
+void addViewUpdateResult(
+    const Cesium3DTilesSelection::ViewUpdateResult& result);
+
+/**
+ * Records the time spent updating a tileset in the game thread. Must be
+ * called from the game thread.
+ */
+void addGameThreadTime(double seconds);
+
+/**
+ * Gets the total time spent updating tilesets in the game thread since
+ * startup, in seconds. Must be called from the game thread.
+ */
+double getGameThreadSeconds();
+
+/**
+ * Updates the request latency percentiles and the cache hit ratio, and
+ * records the request and cache counters in the CSV profile. Only does
+ * anything the first time it's called in a frame. Must be called from the
+ * game thread.
+ */
+void updateRequestStats();
+
+/**
+ * Records the number of objects that are waiting to be destroyed by
+ * CesiumLifetime, and the number destroyed this frame. Must be called from
+ * the game thread.
+ */
+void updateDestructionStats(int32 pending, int32 destroyed);
+
+} // namespace CesiumRuntimeStats
@@ -0,0 +1,51 @@
+// Copyright 2020-2021 CesiumGS, Inc. and Contributors
+
+#pragma once
+
+#include "Containers/Array.h"
+
+/**
+ * @brief A temporary array that is borrowed from a pool of the current thread
+ * for the lifetime of the scope, so that the temporaries of converting a
+ * glTF are reused from one tile to the next instead of being allocated and
+ * freed each time.
+ *
+ * The array is empty when it is borrowed, but keeps the capacity of its
+ * earlier uses. Scopes may nest, each of them borrows its own array. An array
+ * that grew past {@link MaximumRetainedBytes} is freed instead of returned to
+ * the pool, so that one huge tile doesn't pin its memory on every thread. An
+ * array that was moved from is returned empty, and just has to grow again.
+ */
+template <typename T> class CesiumScratchArray {
+public:
+  static constexpr SIZE_T MaximumRetainedBytes = 16 * 1024 * 1024;
+
+  CesiumScratchArray() : _array() {
+    TArray<TArray<T>>& pool = getPool();
+    if (pool.Num() > 0) {
+      this->_array = pool.Pop(false);
+    }
+  }
+
+  ~CesiumScratchArray() {
+    if (this->_array.GetAllocatedSize() > MaximumRetainedBytes) {
+      return;
+    }
+    this->_array.Reset();
+    getPool().Add(MoveTemp(this->_array));
+  }
+
+  CesiumScratchArray(const CesiumScratchArray&) = delete;
+  CesiumScratchArray& operator=(const CesiumScratchArray&) = delete;
+
+  TArray<T>& operator*() { return this->_array; }
+  TArray<T>* operator->() { return &this->_array; }
+
+private:
+  static TArray<TArray<T>>& getPool() {
+    thread_local TArray<TArray<T>> pool;
+    return pool;
+  }
+
+  TArray<T> _array;
+};
@@ -0,0 +1,67 @@
+// Copyright 2020-2021 CesiumGS, Inc. and Contributors
+
+#include "CesiumScreenSpaceErrorController.h"
+#include "HAL/PlatformTime.h"
+#include "RHI.h"
+#include "RenderCore.h"
+#include <algorithm>
+
+namespace {
+// How much of each new frame time goes into the smoothed frame time.
+constexpr double FrameTimeSmoothing = 0.1;
+
+// The smallest time, in seconds, between two changes of the error.
+constexpr double MinimumChangeInterval = 0.25;
+
+// The fractions of the target frame time above which the error is raised,
+// and below which it is lowered again.
+constexpr double RaiseThreshold = 1.05;
+constexpr double LowerThreshold = 0.85;
+
+// The factors by which the error is raised and lowered. Lowering is slower,
+// so that the error settles instead of bouncing back over the target.
+constexpr float RaiseFactor = 1.15f;
+constexpr float LowerFactor = 1.05f;
+} // namespace
+
+void CesiumScreenSpaceErrorController::update(
+    float minimumError,
+    float maximumError,
+    float targetFrameRate) {
+  maximumError = std::max(maximumError, minimumError);
+
+  const double frameTime =
+      FPlatformTime::ToSeconds(std::max(
+          {GGameThreadTime, GRenderThreadTime, RHIGetGPUFrameCycles()}));
+
+  const double now = FPlatformTime::Seconds();
+  if (this->_lastChangeTime < 0.0) {
+    this->_smoothedFrameTime = frameTime;
+    this->_lastChangeTime = now;
+    this->_error = minimumError;
+    return;
+  }
+
+  this->_smoothedFrameTime +=
+      FrameTimeSmoothing * (frameTime - this->_smoothedFrameTime);
+  this->_error = std::clamp(this->_error, minimumError, maximumError);
+
+  if (targetFrameRate <= 0.0f ||
+      now - this->_lastChangeTime < MinimumChangeInterval) {
+    return;
+  }
+
+  const double targetFrameTime = 1.0 / double(targetFrameRate);
+  float error = this->_error;
+  if (this->_smoothedFrameTime > RaiseThreshold * targetFrameTime) {
+    error *= RaiseFactor;
+  } else if (this->_smoothedFrameTime < LowerThreshold * targetFrameTime) {
+    error /= LowerFactor;
+  }
+  error = std::clamp(error, minimumError, maximumError);
+
+  if (error != this->_error) {
+    this->_error = error;
+    this->_lastChangeTime = now;
+  }
+}
@@ -0,0 +1,40 @@
+// Copyright 2020-2021 CesiumGS, Inc. and Contributors
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * @brief Adapts the maximum screen-space error of a tileset to the measured
+ * frame time, so that a target frame rate is held by rendering less geometric
+ * detail in busy scenes.
+ *
+ * The frame time is the longest of the game thread, render thread and GPU
+ * times of the last frame, smoothed over several frames. The error is raised
+ * when the frame time is above the target, and lowered again when it is well
+ * below it. Between the two thresholds the error is held, so that it does not
+ * oscillate around the target. Changes are spaced out, because a new error
+ * only affects the frame time once the tiles selected with it are rendered.
+ */
+class CesiumScreenSpaceErrorController {
+public:
+  /**
+   * @brief Updates the error from the frame time of the last frame. Must be
+   * called once per frame from the game thread.
+   *
+   * @param minimumError The error to use when the target is met easily.
+   * @param maximumError The largest error to use.
+   * @param targetFrameRate The frame rate to hold, in frames per second.
+   */
+  void update(float minimumError, float maximumError, float targetFrameRate);
+
+  /**
+   * @brief Gets the maximum screen-space error to use.
+   */
+  float getScreenSpaceError() const { return this->_error; }
+
+private:
+  double _smoothedFrameTime = 0.0;
+  double _lastChangeTime = -1.0;
+  float _error = 0.0f;
+};
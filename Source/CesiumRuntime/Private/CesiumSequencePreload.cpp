@@ -0,0 +1,164 @@
+// Copyright 2020-2021 CesiumGS, Inc. and Contributors
+
+#include "CesiumSequencePreload.h"
+#include "Camera/CameraComponent.h"
+#include "CesiumCamera.h"
+#include "GameFramework/Actor.h"
+#include "LevelSequence.h"
+#include "LevelSequenceActor.h"
+#include "LevelSequencePlayer.h"
+#include "MovieScene.h"
+#include "Sections/MovieSceneCameraCutSection.h"
+#include "Tracks/MovieScene3DTransformTrack.h"
+#if ENGINE_MAJOR_VERSION == 5
+#include "Channels/MovieSceneDoubleChannel.h"
+#else
+#include "Channels/MovieSceneFloatChannel.h"
+#endif
+
+namespace {
+
+#if ENGINE_MAJOR_VERSION == 5
+using TransformChannel = FMovieSceneDoubleChannel;
+using TransformValue = double;
+#else
+using TransformChannel = FMovieSceneFloatChannel;
+using TransformValue = float;
+#endif
+
+const UMovieSceneCameraCutSection*
+findCameraCut(const UMovieSceneTrack& cameraCutTrack, FFrameNumber frame) {
+  for (const UMovieSceneSection* pSection : cameraCutTrack.GetAllSections()) {
+    if (pSection && pSection->IsActive() &&
+        pSection->GetRange().Contains(frame)) {
+      return Cast<UMovieSceneCameraCutSection>(pSection);
+    }
+  }
+  return nullptr;
+}
+
+/**
+ * Evaluates the location and rotation of a transform track at the given
+ * time. Channels without keys leave the given values as they are.
+ */
+void evaluateTransform(
+    const UMovieScene3DTransformTrack& track,
+    FFrameTime time,
+    FVector& location,
+    FRotator& rotation) {
+  for (const UMovieSceneSection* pSection : track.GetAllSections()) {
+    if (!pSection || !pSection->IsActive() ||
+        !pSection->GetRange().Contains(time.FrameNumber)) {
+      continue;
+    }
+
+    // The channels are the translation, the rotation about each axis and
+    // the scale, in that order.
+    const auto channels =
+        pSection->GetChannelProxy().GetChannels<TransformChannel>();
+    if (channels.Num() < 6) {
+      continue;
+    }
+
+    TransformValue values[6] = {
+        TransformValue(location.X),
+        TransformValue(location.Y),
+        TransformValue(location.Z),
+        TransformValue(rotation.Roll),
+        TransformValue(rotation.Pitch),
+        TransformValue(rotation.Yaw)};
+    for (int32 i = 0; i < 6; ++i) {
+      channels[i]->Evaluate(time, values[i]);
+    }
+
+    location = FVector(values[0], values[1], values[2]);
+    rotation = FRotator(values[4], values[5], values[3]);
+    return;
+  }
+}
+
+} // namespace
+
+void CesiumSequencePreload::addUpcomingCameras(
+    ALevelSequenceActor& sequenceActor,
+    float preloadTime,
+    int32 samples,
+    const FCesiumCamera& viewCamera,
+    std::vector<FCesiumCamera>& cameras) {
+  ULevelSequencePlayer* pPlayer = sequenceActor.GetSequencePlayer();
+  ULevelSequence* pSequence = sequenceActor.GetSequence();
+  UMovieScene* pMovieScene = pSequence ? pSequence->GetMovieScene() : nullptr;
+  if (!pPlayer || !pPlayer->IsPlaying() || !pMovieScene ||
+      preloadTime <= 0.0f || samples <= 0) {
+    return;
+  }
+
+  const UMovieSceneTrack* pCameraCutTrack = pMovieScene->GetCameraCutTrack();
+  if (!pCameraCutTrack) {
+    return;
+  }
+
+  const FFrameRate tickResolution = pMovieScene->GetTickResolution();
+  const FFrameTime now = pPlayer->GetCurrentTime().ConvertTo(tickResolution);
+  const double interval =
+      double(preloadTime) * double(pPlayer->GetPlayRate()) / double(samples);
+
+  const size_t firstCamera = cameras.size();
+  for (int32 i = 1; i <= samples; ++i) {
+    const FFrameTime time = now + tickResolution.AsFrameTime(interval * i);
+    const UMovieSceneCameraCutSection* pCameraCut =
+        findCameraCut(*pCameraCutTrack, time.FrameNumber);
+    if (!pCameraCut) {
+      continue;
+    }
+
+    const FMovieSceneObjectBindingID& binding =
+        pCameraCut->GetCameraBindingID();
+    const UMovieScene3DTransformTrack* pTransformTrack =
+        pMovieScene->FindTrack<UMovieScene3DTransformTrack>(binding.GetGuid());
+
+    // A camera that is spawned by the sequence only exists while it is cut
+    // to, so upcoming ones may only be known by their transform tracks.
+    FCesiumCamera camera = viewCamera;
+    bool known = false;
+    for (UObject* pObject : pPlayer->GetBoundObjects(binding)) {
+      const AActor* pActor = Cast<AActor>(pObject);
+      if (!pActor) {
+        continue;
+      }
+      camera.Location = pActor->GetActorLocation();
+      camera.Rotation = pActor->GetActorRotation();
+      const UCameraComponent* pCameraComponent =
+          pActor->FindComponentByClass<UCameraComponent>();
+      if (pCameraComponent) {
+        camera.FieldOfViewDegrees = pCameraComponent->FieldOfView;
+      }
+      known = true;
+      break;
+    }
+
+    if (pTransformTrack) {
+      evaluateTransform(
+          *pTransformTrack,
+          time,
+          camera.Location,
+          camera.Rotation);
+      known = true;
+    }
+
+    if (!known) {
+      continue;
+    }
+
+    if (cameras.size() > firstCamera) {
+      const FCesiumCamera& previous = cameras.back();
+      if (previous.Location.Equals(camera.Location) &&
+          previous.Rotation.Equals(camera.Rotation) &&
+          previous.FieldOfViewDegrees == camera.FieldOfViewDegrees) {
+        continue;
+      }
+    }
+
+    cameras.push_back(camera);
+  }
+}
@@ -0,0 +1,44 @@
+// Copyright 2020-2021 CesiumGS, Inc. and Contributors
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include <vector>
+
+class ALevelSequenceActor;
+struct FCesiumCamera;
+
+/**
+ * @brief Finds the views that a playing Level Sequence will cut to, so that
+ * their tiles can be loaded before the playhead reaches them.
+ */
+namespace CesiumSequencePreload {
+
+/**
+ * @brief Adds the views of the camera cut track of a playing Level Sequence
+ * over the given time ahead of its playhead.
+ *
+ * The track is sampled at regular intervals, and each sample gives the
+ * camera that the track cuts to at that time, with the location and
+ * rotation of its transform track, or its current ones if it isn't
+ * animated. Transform tracks are assumed to be in world coordinates, as they
+ * are for cameras that aren't attached to anything. Samples that give the
+ * same view as the previous one are skipped. Nothing is added if the
+ * sequence isn't playing.
+ *
+ * @param sequenceActor The actor that plays the Level Sequence.
+ * @param preloadTime The time ahead of the playhead, in seconds.
+ * @param samples The number of samples over that time.
+ * @param viewCamera The camera whose viewport and level of detail each view
+ * is given. The field of view is that of the sequence camera if it is
+ * spawned, or else that of this camera.
+ * @param cameras The cameras to add the views to.
+ */
+void addUpcomingCameras(
+    ALevelSequenceActor& sequenceActor,
+    float preloadTime,
+    int32 samples,
+    const FCesiumCamera& viewCamera,
+    std::vector<FCesiumCamera>& cameras);
+
+} // namespace CesiumSequencePreload
@@ -120,8 +120,9 @@ void ACesiumSunSky::_handleTransformUpdated(
     ETeleportType Teleport) {
   // This Actor generally shouldn't move with respect to the globe, but this
   // method will be called on georeference change. We need to update the sun
-  // position for the new UE coordinate system.
-  this->UpdateSun();
+  // position for the new UE coordinate system. It is updated once in the next
+  // Tick, however many times the georeference moves this actor until then.
+  this->_sunUpdatePending = true;
 }
 
 void ACesiumSunSky::OnConstruction(const FTransform& Transform) {
@@ -245,8 +246,10 @@ void ACesiumSunSky::Serialize(FArchive& Ar) {
 void ACesiumSunSky::Tick(float DeltaSeconds) {
   Super::Tick(DeltaSeconds);
 
+  this->_updateSunIfNeeded();
+
   if (this->UpdateAtmosphereAtRuntime) {
-    this->UpdateAtmosphereRadius();
+    this->_updateAtmosphereRadiusIfNeeded();
   }
 }
 
@@ -436,7 +439,70 @@ FVector getViewLocation(UWorld* pWorld) {
 } // namespace
 
 void ACesiumSunSky::UpdateAtmosphereRadius() {
-  FVector location = getViewLocation(this->GetWorld());
+  this->_updateAtmosphereRadius(getViewLocation(this->GetWorld()));
+}
+
+void ACesiumSunSky::_updateSunIfNeeded() {
+  ACesiumGeoreference* pGeoreference = this->GetGeoreference();
+  if (!IsValid(pGeoreference)) {
+    return;
+  }
+
+  // Every input is exactly representable as a double, so they are compared
+  // exactly.
+  const std::array<double, 15> inputs = {
+      this->SolarTime,
+      this->TimeZone,
+      double(this->Day),
+      double(this->Month),
+      double(this->Year),
+      this->NorthOffset,
+      double(this->UseDaylightSavingTime),
+      double(this->DSTStartMonth),
+      double(this->DSTStartDay),
+      double(this->DSTEndMonth),
+      double(this->DSTEndDay),
+      double(this->DSTSwitchHour),
+      double(this->UseLevelDirectionalLight),
+      pGeoreference->OriginLatitude,
+      pGeoreference->OriginLongitude};
+
+  // The inputs are recorded before the update, so that overrides of UpdateSun
+  // that don't call this implementation aren't called every frame.
+  if (!this->_sunUpdatePending && this->_lastSunInputs == inputs &&
+      this->_lastLevelDirectionalLight == this->LevelDirectionalLight) {
+    return;
+  }
+  this->_sunUpdatePending = false;
+  this->_lastSunInputs = inputs;
+  this->_lastLevelDirectionalLight = this->LevelDirectionalLight;
+  this->UpdateSun();
+}
+
+void ACesiumSunSky::_updateAtmosphereRadiusIfNeeded() {
+  ACesiumGeoreference* pGeoreference = this->GetGeoreference();
+  if (!IsValid(pGeoreference)) {
+    return;
+  }
+
+  const FVector location = getViewLocation(this->GetWorld());
+  const std::array<double, 8> inputs = {
+      location.X,
+      location.Y,
+      location.Z,
+      pGeoreference->OriginLatitude,
+      pGeoreference->OriginLongitude,
+      pGeoreference->OriginHeight,
+      this->InscribedGroundThreshold,
+      this->CircumscribedGroundThreshold};
+  if (this->_lastAtmosphereInputs == inputs) {
+    return;
+  }
+  this->_lastAtmosphereInputs = inputs;
+  this->_updateAtmosphereRadius(location);
+}
+
+void ACesiumSunSky::_updateAtmosphereRadius(const FVector& location) {
   glm::dvec3 llh =
       this->GetGeoreference()->TransformUnrealToLongitudeLatitudeHeight(
           VecMath::createVector3D(location));
@@ -444,9 +510,8 @@ void ACesiumSunSky::UpdateAtmosphereRadius() {
   // An atmosphere of this radius should circumscribe all Earth terrain.
   double maxRadius = 6387000.0;
 
-  if (llh.z / 1000.0 > this->CircumscribedGroundThreshold) {
-    this->SetSkyAtmosphereGroundRadius(this->SkyAtmosphere, maxRadius / 1000.0);
-  } else {
+  double radius = maxRadius;
+  if (llh.z / 1000.0 <= this->CircumscribedGroundThreshold) {
     // Find the ellipsoid radius 100m below the surface at this location. See
     // the comment at the top of this file.
     glm::dvec3 ecef = this->GetGeoreference()
@@ -456,17 +521,24 @@ void ACesiumSunSky::UpdateAtmosphereRadius() {
     double minRadius = glm::length(ecef);
 
     if (llh.z / 1000.0 < this->InscribedGroundThreshold) {
-      this->SetSkyAtmosphereGroundRadius(
-          this->SkyAtmosphere,
-          minRadius / 1000.0);
+      radius = minRadius;
     } else {
       double t =
           ((llh.z / 1000.0) - this->InscribedGroundThreshold) /
           (this->CircumscribedGroundThreshold - this->InscribedGroundThreshold);
-      double radius = glm::mix(minRadius, maxRadius, t);
-      this->SetSkyAtmosphereGroundRadius(this->SkyAtmosphere, radius / 1000.0);
+      radius = glm::mix(minRadius, maxRadius, t);
     }
   }
+
+  // While the view moves, the radius changes by less than the 0.1 km that
+  // SetSkyAtmosphereGroundRadius applies on most frames, so it is only
+  // called once the change is large enough to be applied.
+  const float radiusKm = float(radius / 1000.0);
+  if (!this->SkyAtmosphere ||
+      FMath::Abs(this->SkyAtmosphere->BottomRadius - radiusKm) <= 0.1f) {
+    return;
+  }
+  this->SetSkyAtmosphereGroundRadius(this->SkyAtmosphere, radiusKm);
 }
 
 void ACesiumSunSky::GetHMSFromSolarTime(
@@ -0,0 +1,472 @@
+// Copyright 2020-2021 CesiumGS, Inc. and Contributors
+
+#include "CesiumTextureCompression.h"
+#include "CesiumUtility/Tracing.h"
+#include <algorithm>
+#include <glm/common.hpp>
+#include <glm/geometric.hpp>
+#include <glm/vec3.hpp>
+
+namespace {
+
+constexpr int32 BlockSize = 4;
+constexpr int32 BlockPixels = BlockSize * BlockSize;
+
+// The number of power iterations used to find the principal axis of the
+// colors in a block, which converges quickly for 16 colors.
+constexpr int32 PowerIterations = 8;
+
+bool isFormatSupported(EPixelFormat format) {
+  return GPixelFormats[format].Supported;
+}
+
+/**
+ * Reads the 4x4 block of pixels at the given block coordinates. Blocks that
+ * extend past the edge of the image, which only happens for the smallest
+ * mips, repeat the pixels on the edge. RGB pixels are read with an alpha of
+ * 255.
+ */
+void readBlock(
+    const uint8* pPixels,
+    int32 width,
+    int32 height,
+    int32 channels,
+    int32 blockX,
+    int32 blockY,
+    uint8 block[BlockPixels][4]) {
+  for (int32 y = 0; y < BlockSize; ++y) {
+    const int32 pixelY = FMath::Min(blockY * BlockSize + y, height - 1);
+    for (int32 x = 0; x < BlockSize; ++x) {
+      const int32 pixelX = FMath::Min(blockX * BlockSize + x, width - 1);
+      const uint8* pPixel =
+          pPixels + (int64(pixelY) * width + pixelX) * channels;
+      uint8* pBlockPixel = block[y * BlockSize + x];
+      for (int32 c = 0; c < channels; ++c) {
+        pBlockPixel[c] = pPixel[c];
+      }
+      if (channels == 3) {
+        pBlockPixel[3] = 255;
+      }
+    }
+  }
+}
+
+uint16 toRGB565(const glm::vec3& color) {
+  const glm::vec3 clamped = glm::clamp(color, 0.0f, 255.0f);
+  const uint16 r = uint16(FMath::RoundToInt(clamped.x * (31.0f / 255.0f)));
+  const uint16 g = uint16(FMath::RoundToInt(clamped.y * (63.0f / 255.0f)));
+  const uint16 b = uint16(FMath::RoundToInt(clamped.z * (31.0f / 255.0f)));
+  return uint16((r << 11) | (g << 5) | b);
+}
+
+glm::vec3 fromRGB565(uint16 color) {
+  const uint32 r = (color >> 11) & 0x1f;
+  const uint32 g = (color >> 5) & 0x3f;
+  const uint32 b = color & 0x1f;
+  return glm::vec3(
+      float((r << 3) | (r >> 2)),
+      float((g << 2) | (g >> 4)),
+      float((b << 3) | (b >> 2)));
+}
+
+float distanceSquared(const glm::vec3& a, const glm::vec3& b) {
+  const glm::vec3 difference = a - b;
+  return glm::dot(difference, difference);
+}
+
+/**
+ * Chooses the nearest of the four palette colors for each color in the
+ * block, returning the packed 2-bit indices and the total squared error.
+ */
+uint32 chooseColorIndices(
+    const glm::vec3 colors[BlockPixels],
+    uint16 color0,
+    uint16 color1,
+    float& error) {
+  glm::vec3 palette[4];
+  palette[0] = fromRGB565(color0);
+  palette[1] = fromRGB565(color1);
+  if (color0 > color1) {
+    palette[2] = (2.0f * palette[0] + palette[1]) / 3.0f;
+    palette[3] = (palette[0] + 2.0f * palette[1]) / 3.0f;
+  } else {
+    // Both endpoints are the same color, so the three-color mode that this
+    // selects is also a single color.
+    palette[2] = palette[3] = palette[0];
+  }
+
+  uint32 indices = 0;
+  error = 0.0f;
+  for (int32 i = 0; i < BlockPixels; ++i) {
+    uint32 best = 0;
+    float bestDistance = distanceSquared(colors[i], palette[0]);
+    for (uint32 j = 1; j < 4; ++j) {
+      const float distance = distanceSquared(colors[i], palette[j]);
+      if (distance < bestDistance) {
+        best = j;
+        bestDistance = distance;
+      }
+    }
+    indices |= best << (2 * i);
+    error += bestDistance;
+  }
+  return indices;
+}
+
+void findEndpointsFromBoundingBox(
+    const glm::vec3 colors[BlockPixels],
+    glm::vec3& endpoint0,
+    glm::vec3& endpoint1) {
+  glm::vec3 minimum = colors[0];
+  glm::vec3 maximum = colors[0];
+  for (int32 i = 1; i < BlockPixels; ++i) {
+    minimum = glm::min(minimum, colors[i]);
+    maximum = glm::max(maximum, colors[i]);
+  }
+
+  // Insetting the box slightly lowers the error of the colors near its
+  // corners, which are rarely at the exact extremes.
+  const glm::vec3 inset = (maximum - minimum) / 16.0f;
+  endpoint0 = maximum - inset;
+  endpoint1 = minimum + inset;
+}
+
+void findEndpointsFromPrincipalAxis(
+    const glm::vec3 colors[BlockPixels],
+    glm::vec3& endpoint0,
+    glm::vec3& endpoint1) {
+  glm::vec3 mean(0.0f);
+  for (int32 i = 0; i < BlockPixels; ++i) {
+    mean += colors[i];
+  }
+  mean /= float(BlockPixels);
+
+  float covariance[6] = {0.0f};
+  for (int32 i = 0; i < BlockPixels; ++i) {
+    const glm::vec3 d = colors[i] - mean;
+    covariance[0] += d.x * d.x;
+    covariance[1] += d.x * d.y;
+    covariance[2] += d.x * d.z;
+    covariance[3] += d.y * d.y;
+    covariance[4] += d.y * d.z;
+    covariance[5] += d.z * d.z;
+  }
+
+  glm::vec3 axis(1.0f, 1.0f, 1.0f);
+  for (int32 iteration = 0; iteration < PowerIterations; ++iteration) {
+    const glm::vec3 next(
+        covariance[0] * axis.x + covariance[1] * axis.y +
+            covariance[2] * axis.z,
+        covariance[1] * axis.x + covariance[3] * axis.y +
+            covariance[4] * axis.z,
+        covariance[2] * axis.x + covariance[4] * axis.y +
+            covariance[5] * axis.z);
+    const float length = glm::length(next);
+    if (length < 1e-6f) {
+      // The colors are all (nearly) the same.
+      endpoint0 = endpoint1 = mean;
+      return;
+    }
+    axis = next / length;
+  }
+
+  float minimum = TNumericLimits<float>::Max();
+  float maximum = TNumericLimits<float>::Lowest();
+  for (int32 i = 0; i < BlockPixels; ++i) {
+    const float t = glm::dot(colors[i] - mean, axis);
+    minimum = FMath::Min(minimum, t);
+    maximum = FMath::Max(maximum, t);
+  }
+  endpoint0 = mean + axis * maximum;
+  endpoint1 = mean + axis * minimum;
+}
+
+/**
+ * Refines the endpoints for the given indices by a least-squares fit of the
+ * colors to the palette they were assigned to.
+ */
+bool refineEndpoints(
+    const glm::vec3 colors[BlockPixels],
+    uint32 indices,
+    glm::vec3& endpoint0,
+    glm::vec3& endpoint1) {
+  // The weight of endpoint 0 in each of the four palette colors.
+  static constexpr float weights[4] = {1.0f, 0.0f, 2.0f / 3.0f, 1.0f / 3.0f};
+
+  float aa = 0.0f;
+  float ab = 0.0f;
+  float bb = 0.0f;
+  glm::vec3 ax(0.0f);
+  glm::vec3 bx(0.0f);
+  for (int32 i = 0; i < BlockPixels; ++i) {
+    const float a = weights[(indices >> (2 * i)) & 3];
+    const float b = 1.0f - a;
+    aa += a * a;
+    ab += a * b;
+    bb += b * b;
+    ax += a * colors[i];
+    bx += b * colors[i];
+  }
+
+  const float determinant = aa * bb - ab * ab;
+  if (FMath::Abs(determinant) < 1e-6f) {
+    return false;
+  }
+  endpoint0 = (ax * bb - bx * ab) / determinant;
+  endpoint1 = (bx * aa - ax * ab) / determinant;
+  return true;
+}
+
+void writeColorBlock(
+    uint16 color0,
+    uint16 color1,
+    uint32 indices,
+    uint8* pOut) {
+  pOut[0] = uint8(color0 & 0xff);
+  pOut[1] = uint8(color0 >> 8);
+  pOut[2] = uint8(color1 & 0xff);
+  pOut[3] = uint8(color1 >> 8);
+  pOut[4] = uint8(indices & 0xff);
+  pOut[5] = uint8((indices >> 8) & 0xff);
+  pOut[6] = uint8((indices >> 16) & 0xff);
+  pOut[7] = uint8(indices >> 24);
+}
+
+/**
+ * Encodes the RGB channels of a block as a BC1 block, always in four-color
+ * mode so that it can also be used as the color half of a BC3 block.
+ */
+void encodeColorBlock(
+    const uint8 block[BlockPixels][4],
+    bool highQuality,
+    uint8* pOut) {
+  glm::vec3 colors[BlockPixels];
+  for (int32 i = 0; i < BlockPixels; ++i) {
+    colors[i] = glm::vec3(block[i][0], block[i][1], block[i][2]);
+  }
+
+  glm::vec3 endpoint0;
+  glm::vec3 endpoint1;
+  if (highQuality) {
+    findEndpointsFromPrincipalAxis(colors, endpoint0, endpoint1);
+  } else {
+    findEndpointsFromBoundingBox(colors, endpoint0, endpoint1);
+  }
+
+  uint16 color0 = toRGB565(endpoint0);
+  uint16 color1 = toRGB565(endpoint1);
+  if (color0 < color1) {
+    std::swap(color0, color1);
+  }
+
+  float error;
+  uint32 indices = chooseColorIndices(colors, color0, color1, error);
+
+  if (highQuality && color0 != color1 &&
+      refineEndpoints(colors, indices, endpoint0, endpoint1)) {
+    uint16 refined0 = toRGB565(endpoint0);
+    uint16 refined1 = toRGB565(endpoint1);
+    if (refined0 < refined1) {
+      std::swap(refined0, refined1);
+    }
+
+    float refinedError;
+    const uint32 refinedIndices =
+        chooseColorIndices(colors, refined0, refined1, refinedError);
+    if (refinedError < error) {
+      color0 = refined0;
+      color1 = refined1;
+      indices = refinedIndices;
+    }
+  }
+
+  writeColorBlock(color0, color1, indices, pOut);
+}
+
+/**
+ * Computes the eight palette values of a BC4 block, which interpolates six
+ * values between the endpoints if value0 > value1, and otherwise four values
+ * plus 0 and 255.
+ */
+void getChannelPalette(uint8 value0, uint8 value1, int32 palette[8]) {
+  palette[0] = value0;
+  palette[1] = value1;
+  if (value0 > value1) {
+    for (int32 i = 2; i < 8; ++i) {
+      palette[i] = ((8 - i) * value0 + (i - 1) * value1 + 3) / 7;
+    }
+  } else {
+    for (int32 i = 2; i < 6; ++i) {
+      palette[i] = ((6 - i) * value0 + (i - 1) * value1 + 2) / 5;
+    }
+    palette[6] = 0;
+    palette[7] = 255;
+  }
+}
+
+uint64 chooseChannelIndices(
+    const uint8 values[BlockPixels],
+    uint8 value0,
+    uint8 value1,
+    int32& error) {
+  int32 palette[8];
+  getChannelPalette(value0, value1, palette);
+
+  uint64 indices = 0;
+  error = 0;
+  for (int32 i = 0; i < BlockPixels; ++i) {
+    uint64 best = 0;
+    int32 bestDistance = FMath::Abs(values[i] - palette[0]);
+    for (uint64 j = 1; j < 8; ++j) {
+      const int32 distance = FMath::Abs(values[i] - palette[j]);
+      if (distance < bestDistance) {
+        best = j;
+        bestDistance = distance;
+      }
+    }
+    indices |= best << (3 * i);
+    error += bestDistance * bestDistance;
+  }
+  return indices;
+}
+
+/**
+ * Encodes a single channel of a block as a BC4 block, which is also the
+ * alpha half of a BC3 block.
+ */
+void encodeChannelBlock(
+    const uint8 values[BlockPixels],
+    bool highQuality,
+    uint8* pOut) {
+  uint8 minimum = values[0];
+  uint8 maximum = values[0];
+  for (int32 i = 1; i < BlockPixels; ++i) {
+    minimum = FMath::Min(minimum, values[i]);
+    maximum = FMath::Max(maximum, values[i]);
+  }
+
+  uint8 value0 = maximum;
+  uint8 value1 = minimum;
+  int32 error;
+  uint64 indices = 0;
+  if (maximum != minimum) {
+    indices = chooseChannelIndices(values, value0, value1, error);
+
+    if (highQuality) {
+      // Try the mode with exact 0 and 255, fitting its endpoints to the
+      // values in between, which suits blocks with a few extreme values.
+      uint8 innerMinimum = 255;
+      uint8 innerMaximum = 0;
+      for (int32 i = 0; i < BlockPixels; ++i) {
+        if (values[i] != 0 && values[i] != 255) {
+          innerMinimum = FMath::Min(innerMinimum, values[i]);
+          innerMaximum = FMath::Max(innerMaximum, values[i]);
+        }
+      }
+      if (innerMinimum > innerMaximum) {
+        innerMinimum = innerMaximum = 0;
+      }
+
+      int32 innerError;
+      const uint64 innerIndices =
+          chooseChannelIndices(values, innerMinimum, innerMaximum, innerError);
+      if (innerError < error) {
+        value0 = innerMinimum;
+        value1 = innerMaximum;
+        indices = innerIndices;
+      }
+    }
+  }
+
+  pOut[0] = value0;
+  pOut[1] = value1;
+  for (int32 i = 0; i < 6; ++i) {
+    pOut[2 + i] = uint8((indices >> (8 * i)) & 0xff);
+  }
+}
+
+} // namespace
+
+/*static*/ EPixelFormat CesiumTextureCompression::getCompressedFormat(
+    EPixelFormat format,
+    bool hasAlpha) {
+  EPixelFormat compressed = PF_Unknown;
+  switch (format) {
+  case PF_R8G8B8A8:
+    compressed = hasAlpha ? PF_DXT5 : PF_DXT1;
+    break;
+  case PF_R8G8:
+    compressed = PF_BC5;
+    break;
+  case PF_R8:
+    compressed = PF_BC4;
+    break;
+  default:
+    break;
+  }
+
+  return compressed != PF_Unknown && isFormatSupported(compressed)
+             ? compressed
+             : PF_Unknown;
+}
+
+/*static*/ int64 CesiumTextureCompression::getCompressedSize(
+    int32 width,
+    int32 height,
+    EPixelFormat format) {
+  const int64 blocksX = (width + BlockSize - 1) / BlockSize;
+  const int64 blocksY = (height + BlockSize - 1) / BlockSize;
+  const int64 bytesPerBlock = format == PF_DXT1 || format == PF_BC4 ? 8 : 16;
+  return blocksX * blocksY * bytesPerBlock;
+}
+
+/*static*/ void CesiumTextureCompression::compressImage(
+    const uint8* pPixels,
+    int32 width,
+    int32 height,
+    int32 channels,
+    EPixelFormat format,
+    bool highQuality,
+    uint8* pBlocks) {
+  CESIUM_TRACE("CesiumTextureCompression::compressImage");
+
+  const int32 blocksX = (width + BlockSize - 1) / BlockSize;
+  const int32 blocksY = (height + BlockSize - 1) / BlockSize;
+
+  uint8 block[BlockPixels][4];
+  uint8 values[BlockPixels];
+  uint8* pOut = pBlocks;
+
+  auto encodeChannel = [&](int32 channel) {
+    for (int32 i = 0; i < BlockPixels; ++i) {
+      values[i] = block[i][channel];
+    }
+    encodeChannelBlock(values, highQuality, pOut);
+    pOut += 8;
+  };
+
+  for (int32 blockY = 0; blockY < blocksY; ++blockY) {
+    for (int32 blockX = 0; blockX < blocksX; ++blockX) {
+      readBlock(pPixels, width, height, channels, blockX, blockY, block);
+
+      switch (format) {
+      case PF_DXT1:
+        encodeColorBlock(block, highQuality, pOut);
+        pOut += 8;
+        break;
+      case PF_DXT5:
+        encodeChannel(3);
+        encodeColorBlock(block, highQuality, pOut);
+        pOut += 8;
+        break;
+      case PF_BC5:
+        encodeChannel(0);
+        encodeChannel(1);
+        break;
+      default:
+        encodeChannel(0);
+        break;
+      }
+    }
+  }
+}
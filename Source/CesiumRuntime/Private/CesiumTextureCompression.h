@@ -0,0 +1,62 @@
+// Copyright 2020-2021 CesiumGS, Inc. and Contributors
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "PixelFormat.h"
+
+/**
+ * @brief Functions that compress uncompressed images into GPU block-compressed
+ * formats while their textures are loaded.
+ *
+ * Only the formats made of endpoint-and-index blocks are supported: BC1 and
+ * BC3 for color images, and BC4 and BC5 for one- and two-channel images.
+ */
+class CesiumTextureCompression {
+public:
+  /**
+   * @brief Gets the block-compressed format, supported by the current RHI,
+   * that best fits images in the given uncompressed format.
+   *
+   * @param format The uncompressed format, which is PF_R8G8B8A8 (also used
+   * for RGB images), PF_R8G8 or PF_R8.
+   * @param hasAlpha Whether an image in PF_R8G8B8A8 has any pixels that are
+   * not fully opaque.
+   * @return The compressed format, or PF_Unknown if there is none.
+   */
+  static EPixelFormat getCompressedFormat(EPixelFormat format, bool hasAlpha);
+
+  /**
+   * @brief Gets the number of bytes in an image of the given size in a
+   * block-compressed format. Images smaller than a block still take up a
+   * whole block.
+   */
+  static int64
+  getCompressedSize(int32 width, int32 height, EPixelFormat format);
+
+  /**
+   * @brief Compresses an image.
+   *
+   * @param pPixels The uncompressed pixels, in rows of width pixels without
+   * padding.
+   * @param width The width of the image, in pixels.
+   * @param height The height of the image, in pixels.
+   * @param channels The number of 8-bit channels of each pixel. This is 3 or
+   * 4 for BC1 and BC3, where RGB pixels are treated as opaque, 2 for BC5 and
+   * 1 for BC4.
+   * @param format The compressed format returned by getCompressedFormat.
+   * @param highQuality Whether to fit the endpoints of each block to the
+   * principal axis of its colors and refine them, rather than to use the
+   * bounding box of its colors. This takes several times longer.
+   * @param pBlocks Receives the getCompressedSize bytes of the compressed
+   * image.
+   */
+  static void compressImage(
+      const uint8* pPixels,
+      int32 width,
+      int32 height,
+      int32 channels,
+      EPixelFormat format,
+      bool highQuality,
+      uint8* pBlocks);
+};
@@ -0,0 +1,144 @@
+// Copyright 2020-2021 CesiumGS, Inc. and Contributors
+
+#include "CesiumTexturePool.h"
+#include "CesiumLifetime.h"
+#include "CesiumUtility/Tracing.h"
+#include "Engine/Texture2D.h"
+#include "RenderingThread.h"
+
+namespace {
+
+const FTexturePlatformData* getPlatformData(const UTexture2D* pTexture) {
+#if ENGINE_MAJOR_VERSION >= 5
+  return pTexture->GetPlatformData();
+#else
+  return pTexture->PlatformData;
+#endif
+}
+
+FTextureResource* getResource(UTexture2D* pTexture) {
+#if ENGINE_MAJOR_VERSION >= 5
+  return pTexture->GetResource();
+#else
+  return pTexture->Resource;
+#endif
+}
+
+bool matches(
+    const UTexture2D* pTexture,
+    const CesiumTextureUtility::LoadedTextureResult& loadedTexture) {
+  const FTexturePlatformData* pPooled = getPlatformData(pTexture);
+  const FTexturePlatformData* pLoaded = loadedTexture.pTextureData;
+  return pPooled && pLoaded && pPooled->SizeX == pLoaded->SizeX &&
+         pPooled->SizeY == pLoaded->SizeY &&
+         pPooled->PixelFormat == pLoaded->PixelFormat &&
+         pPooled->Mips.Num() == pLoaded->Mips.Num() &&
+         pTexture->AddressX == loadedTexture.addressX &&
+         pTexture->AddressY == loadedTexture.addressY &&
+         pTexture->Filter == loadedTexture.filter;
+}
+
+/**
+ * Replaces the pixels of every mip of the given resource's RHI texture with
+ * the given texture data, and then deletes the texture data.
+ */
+void updateTexture(
+    FTextureResource* pResource,
+    FTexturePlatformData* pTextureData) {
+  ENQUEUE_RENDER_COMMAND(CesiumUpdatePooledTexture)
+  ([pResource, pTextureData](FRHICommandListImmediate& RHICmdList) {
+    CESIUM_TRACE("CesiumUpdatePooledTexture");
+
+    FRHITexture2D* pRHITexture =
+        pResource->TextureRHI ? pResource->TextureRHI->GetTexture2D() : nullptr;
+    if (pRHITexture) {
+      const FPixelFormatInfo& formatInfo =
+          GPixelFormats[pTextureData->PixelFormat];
+      for (int32 i = 0; i < pTextureData->Mips.Num(); ++i) {
+        const FTexture2DMipMap& mip = pTextureData->Mips[i];
+        const uint8* pPixels =
+            static_cast<const uint8*>(mip.BulkData.LockReadOnly());
+        if (pPixels) {
+          const uint32 pitch =
+              FMath::DivideAndRoundUp(mip.SizeX, formatInfo.BlockSizeX) *
+              formatInfo.BlockBytes;
+          RHIUpdateTexture2D(
+              pRHITexture,
+              i,
+              FUpdateTextureRegion2D(0, 0, 0, 0, mip.SizeX, mip.SizeY),
+              pitch,
+              pPixels);
+        }
+        mip.BulkData.Unlock();
+      }
+    }
+
+    delete pTextureData;
+  });
+}
+
+} // namespace
+
+CesiumTexturePool::~CesiumTexturePool() { this->clear(); }
+
+void CesiumTexturePool::clear() {
+  for (UTexture2D* pTexture : this->_textures) {
+    if (pTexture) {
+      CesiumLifetime::destroy(pTexture);
+    }
+  }
+  this->_textures.Empty();
+}
+
+UTexture2D* CesiumTexturePool::acquireTexture(
+    CesiumTextureUtility::LoadedTextureResult& loadedTexture) {
+  if (loadedTexture.rhiTexture) {
+    // The RHI texture already exists, so there's nothing to gain.
+    return nullptr;
+  }
+
+  // Textures that were destroyed elsewhere are nulled out by the garbage
+  // collector.
+  this->_textures.Remove(nullptr);
+
+  for (int32 i = 0; i < this->_textures.Num(); ++i) {
+    UTexture2D* pTexture = this->_textures[i];
+    if (!matches(pTexture, loadedTexture)) {
+      continue;
+    }
+
+    FTextureResource* pResource = getResource(pTexture);
+    if (!pResource) {
+      continue;
+    }
+
+    this->_textures.RemoveAtSwap(i);
+
+    updateTexture(pResource, loadedTexture.pTextureData);
+    loadedTexture.pTextureData = nullptr;
+    loadedTexture.pTexture = pTexture;
+    return pTexture;
+  }
+
+  return nullptr;
+}
+
+bool CesiumTexturePool::releaseTexture(
+    UTexture2D* pTexture,
+    int32 maximumSize) {
+  if (!pTexture || this->_textures.Num() >= maximumSize ||
+      !getResource(pTexture)) {
+    return false;
+  }
+
+  this->_textures.Add(pTexture);
+  return true;
+}
+
+void CesiumTexturePool::AddReferencedObjects(FReferenceCollector& Collector) {
+  Collector.AddReferencedObjects(this->_textures);
+}
+
+FString CesiumTexturePool::GetReferencerName() const {
+  return TEXT("CesiumTexturePool");
+}
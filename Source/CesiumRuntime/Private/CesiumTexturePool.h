@@ -0,0 +1,65 @@
+// Copyright 2020-2021 CesiumGS, Inc. and Contributors
+
+#pragma once
+
+#include "CesiumTextureUtility.h"
+#include "Containers/Array.h"
+#include "UObject/GCObject.h"
+
+class UTexture2D;
+
+/**
+ * @brief A pool of textures, so that textures of the same size, format and
+ * sampler settings can be reused by newly-loaded raster overlay tiles instead
+ * of being destroyed when a tile is unloaded and recreated for the next one.
+ *
+ * A reused texture keeps its UObject and its RHI texture, whose pixels are
+ * replaced in place on the render thread. The pool keeps its textures from
+ * being garbage collected while they are in it.
+ */
+class CesiumTexturePool : public FGCObject {
+public:
+  CesiumTexturePool() = default;
+  ~CesiumTexturePool();
+
+  CesiumTexturePool(const CesiumTexturePool&) = delete;
+  CesiumTexturePool& operator=(const CesiumTexturePool&) = delete;
+
+  /**
+   * @brief Takes a texture that matches the given loaded texture out of the
+   * pool, and replaces its pixels with those of the loaded texture.
+   *
+   * On success, the pTexture of the loaded texture is set to the pooled
+   * texture, and its pTextureData is handed over to the render thread, which
+   * deletes it once the pixels are uploaded.
+   *
+   * @param loadedTexture The texture loaded by
+   * CesiumTextureUtility::loadTextureAnyThreadPart, without an RHI texture.
+   * @return The texture, which the caller must now keep from being garbage
+   * collected, or nullptr if there is no pooled texture with the same size,
+   * format and sampler settings.
+   */
+  UTexture2D*
+  acquireTexture(CesiumTextureUtility::LoadedTextureResult& loadedTexture);
+
+  /**
+   * @brief Puts a texture into the pool.
+   *
+   * @param pTexture The texture.
+   * @param maximumSize The maximum number of textures in the pool.
+   * @return True if the texture was added to the pool; false if the pool is
+   * full, in which case the caller should destroy the texture.
+   */
+  bool releaseTexture(UTexture2D* pTexture, int32 maximumSize);
+
+  /**
+   * @brief Destroys all the pooled textures.
+   */
+  void clear();
+
+  virtual void AddReferencedObjects(FReferenceCollector& Collector) override;
+  virtual FString GetReferencerName() const override;
+
+private:
+  TArray<UTexture2D*> _textures;
+};
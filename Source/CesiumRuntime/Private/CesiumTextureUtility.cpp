@@ -2,7 +2,15 @@
 
 #include "CesiumTextureUtility.h"
 #include "CesiumRuntime.h"
+#include "CesiumRuntimeSettings.h"
+#include "CesiumTextureCompression.h"
+#include "DeviceProfiles/DeviceProfile.h"
+#include "DeviceProfiles/DeviceProfileManager.h"
+#include "GenerateMips.h"
 #include "PixelFormat.h"
+#include "RenderGraphBuilder.h"
+#include "RenderTargetPool.h"
+#include "RenderingThread.h"
 
 #include <CesiumGltf/ExtensionKhrTextureBasisu.h>
 #include <CesiumGltf/ImageCesium.h>
@@ -13,6 +21,218 @@
 
 using namespace CesiumGltf;
 
+/**
+ * Gets the block-compressed format that an uncompressed image should be
+ * compressed to, according to the runtime settings, or PF_Unknown if it
+ * should be left uncompressed.
+ */
+static EPixelFormat
+getRuntimeCompressedFormat(const ImageCesium& image, EPixelFormat format) {
+  if (GetDefault<UCesiumRuntimeSettings>()->TextureCompression ==
+          ECesiumTextureCompression::None ||
+      !image.mipPositions.empty() || image.bytesPerChannel != 1 ||
+      image.width % 4 != 0 || image.height % 4 != 0) {
+    return PF_Unknown;
+  }
+
+  bool hasAlpha = false;
+  if (image.channels == 4) {
+    for (size_t i = 3; i < image.pixelData.size(); i += 4) {
+      if (image.pixelData[i] != std::byte(255)) {
+        hasAlpha = true;
+        break;
+      }
+    }
+  }
+
+  return CesiumTextureCompression::getCompressedFormat(format, hasAlpha);
+}
+
+/**
+ * Expands RGB pixels to RGBA pixels with an alpha of 255, in a single pass
+ * over the source.
+ */
+static void
+expandRGBToRGBA(const uint8* pRGB, uint8* pRGBA, int64 pixelCount) {
+  int64 i = 0;
+
+  // Four pixels at a time, as three 32-bit loads and four 32-bit stores,
+  // relying on the little-endian byte order of all supported platforms.
+  for (; i + 4 <= pixelCount; i += 4) {
+    uint32 source[3];
+    FMemory::Memcpy(source, pRGB + i * 3, sizeof(source));
+
+    const uint32 opaque = 0xff000000;
+    const uint32 destination[4] = {
+        source[0] | opaque,
+        (source[0] >> 24) | (source[1] << 8) | opaque,
+        (source[1] >> 16) | (source[2] << 16) | opaque,
+        (source[2] >> 8) | opaque};
+    FMemory::Memcpy(pRGBA + i * 4, destination, sizeof(destination));
+  }
+
+  for (; i < pixelCount; ++i) {
+    pRGBA[i * 4] = pRGB[i * 3];
+    pRGBA[i * 4 + 1] = pRGB[i * 3 + 1];
+    pRGBA[i * 4 + 2] = pRGB[i * 3 + 2];
+    pRGBA[i * 4 + 3] = 255;
+  }
+}
+
+/**
+ * Creates the block-compressed mips of an uncompressed image. The first mip
+ * is compressed straight from the decoded pixels, so only the smaller mips
+ * generated from it need uncompressed scratch space, and the full-size image
+ * is never copied.
+ *
+ * @return False if the smaller mips could not be generated, in which case
+ * only the first mip is created.
+ */
+static bool createCompressedMips(
+    const ImageCesium& image,
+    bool generateMips,
+    EPixelFormat compressedFormat,
+    FTexturePlatformData& textureData) {
+  CESIUM_TRACE("Compress mips.");
+
+  const bool highQuality =
+      GetDefault<UCesiumRuntimeSettings>()->TextureCompression ==
+      ECesiumTextureCompression::HighQuality;
+
+  const int32 channels = image.channels;
+
+  auto addMip = [&](const uint8* pPixels, int32 width, int32 height) {
+    FTexture2DMipMap* pLevel = new FTexture2DMipMap();
+    textureData.Mips.Add(pLevel);
+    pLevel->SizeX = width;
+    pLevel->SizeY = height;
+    pLevel->BulkData.Lock(LOCK_READ_WRITE);
+
+    void* pBlocks = pLevel->BulkData.Realloc(
+        CesiumTextureCompression::getCompressedSize(
+            width,
+            height,
+            compressedFormat));
+    CesiumTextureCompression::compressImage(
+        pPixels,
+        width,
+        height,
+        channels,
+        compressedFormat,
+        highQuality,
+        static_cast<uint8*>(pBlocks));
+  };
+
+  int32 width = image.width;
+  int32 height = image.height;
+  const uint8* pLastMip =
+      reinterpret_cast<const uint8*>(image.pixelData.data());
+  addMip(pLastMip, width, height);
+
+  if (!generateMips) {
+    return true;
+  }
+
+  TArray<uint8> lastMip;
+  TArray<uint8> mip;
+  while (width > 1 || height > 1) {
+    const int32 mipWidth = FMath::Max(width >> 1, 1);
+    const int32 mipHeight = FMath::Max(height >> 1, 1);
+    mip.SetNumUninitialized(mipWidth * mipHeight * channels, false);
+
+    if (!stbir_resize_uint8(
+            pLastMip,
+            width,
+            height,
+            0,
+            mip.GetData(),
+            mipWidth,
+            mipHeight,
+            0,
+            channels)) {
+      for (int32_t i = 1; i < textureData.Mips.Num(); ++i) {
+        textureData.Mips[i].BulkData.Unlock();
+      }
+      textureData.Mips.RemoveAt(1, textureData.Mips.Num() - 1);
+      return false;
+    }
+
+    addMip(mip.GetData(), mipWidth, mipHeight);
+
+    Swap(lastMip, mip);
+    pLastMip = lastMip.GetData();
+    width = mipWidth;
+    height = mipHeight;
+  }
+
+  return true;
+}
+
+/**
+ * Creates the RHI texture of a loaded texture on the calling thread, using
+ * the RHI's asynchronous texture creation, so that the game thread part of
+ * the load only has to wrap it.
+ */
+static void createRHITextureAsync(
+    CesiumTextureUtility::LoadedTextureResult& result) {
+  CESIUM_TRACE("Create RHI texture.");
+
+  FTexturePlatformData& textureData = *result.pTextureData;
+  const int32 numMips = textureData.Mips.Num();
+
+  TArray<void*, TInlineAllocator<16>> mipData;
+  mipData.SetNum(numMips);
+  for (int32 i = 0; i < numMips; ++i) {
+    mipData[i] = textureData.Mips[i].BulkData.Lock(LOCK_READ_ONLY);
+  }
+
+  // The game thread part sets the same sRGB flag on the UTexture2D.
+  const ETextureCreateFlags flags =
+      result.sRGB ? TexCreate_ShaderResource | TexCreate_SRGB
+                  : TexCreate_ShaderResource;
+
+#if ENGINE_MAJOR_VERSION >= 5
+  FGraphEventRef completionEvent;
+  result.rhiTexture = RHIAsyncCreateTexture2D(
+      textureData.SizeX,
+      textureData.SizeY,
+      textureData.PixelFormat,
+      numMips,
+      flags,
+      ERHIAccess::SRVMask,
+      mipData.GetData(),
+      numMips,
+      completionEvent);
+
+  // The mip data has to stay alive until the upload is complete.
+  if (completionEvent) {
+    completionEvent->Wait();
+  }
+#else
+  result.rhiTexture = RHIAsyncCreateTexture2D(
+      textureData.SizeX,
+      textureData.SizeY,
+      textureData.PixelFormat,
+      numMips,
+      flags,
+      mipData.GetData(),
+      numMips);
+#endif
+
+  for (int32 i = 0; i < numMips; ++i) {
+    textureData.Mips[i].BulkData.Unlock();
+  }
+
+  // Outside the editor, FTexture2DResource discards the bulk data once it is
+  // uploaded too. The editor may need it to recreate the resource, and
+  // streamed textures need it to stream their mips back in.
+  if (result.rhiTexture && !result.streamable && !GIsEditor) {
+    for (int32 i = 0; i < numMips; ++i) {
+      textureData.Mips[i].BulkData.RemoveBulkData();
+    }
+  }
+}
+
 static FTexturePlatformData*
 createTexturePlatformData(int32 sizeX, int32 sizeY, EPixelFormat format) {
   if (sizeX > 0 && sizeY > 0 &&
@@ -29,15 +249,80 @@ createTexturePlatformData(int32 sizeX, int32 sizeY, EPixelFormat format) {
   }
 }
 
+/**
+ * Halves the size of an uncompressed image until neither of its sides is
+ * larger than the given size, in a single resize from the decoded pixels.
+ *
+ * @return False if the image doesn't need to be, or can't be, downscaled. It
+ * can't be if it is block compressed, if it already has mips, or if it has
+ * more than one byte per channel.
+ */
+static bool downscaleImage(
+    const ImageCesium& image,
+    int32 maximumSize,
+    ImageCesium& result) {
+  if (maximumSize <= 0 ||
+      (image.width <= maximumSize && image.height <= maximumSize) ||
+      image.compressedPixelFormat != GpuCompressedPixelFormat::NONE ||
+      !image.mipPositions.empty() || image.bytesPerChannel != 1 ||
+      image.channels < 1 || image.channels > 4 ||
+      image.pixelData.size() <
+          size_t(image.width) * image.height * image.channels) {
+    return false;
+  }
+
+  CESIUM_TRACE("Downscale image.");
+
+  result.width = image.width;
+  result.height = image.height;
+  while (result.width > maximumSize || result.height > maximumSize) {
+    result.width = FMath::Max(result.width >> 1, 1);
+    result.height = FMath::Max(result.height >> 1, 1);
+  }
+  result.channels = image.channels;
+  result.bytesPerChannel = 1;
+  result.pixelData.resize(
+      size_t(result.width) * result.height * result.channels);
+
+  return stbir_resize_uint8(
+             reinterpret_cast<const unsigned char*>(image.pixelData.data()),
+             image.width,
+             image.height,
+             0,
+             reinterpret_cast<unsigned char*>(result.pixelData.data()),
+             result.width,
+             result.height,
+             0,
+             image.channels) != 0;
+}
+
 /*static*/ CesiumTextureUtility::LoadedTextureResult*
 CesiumTextureUtility::loadTextureAnyThreadPart(
     const CesiumGltf::ImageCesium& image,
     const TextureAddress& addressX,
     const TextureAddress& addressY,
-    const TextureFilter& filter) {
+    const TextureFilter& filter,
+    bool streamable,
+    bool pooled,
+    bool deferRHITexture,
+    int32 maximumSize) {
 
   CESIUM_TRACE("CesiumTextureUtility::loadTextureAnyThreadPart");
 
+  // Oversized images are downscaled before anything else, so that neither
+  // their copy nor their mips are made at full size.
+  ImageCesium downscaled;
+  if (downscaleImage(image, maximumSize, downscaled)) {
+    return loadTextureAnyThreadPart(
+        downscaled,
+        addressX,
+        addressY,
+        filter,
+        streamable,
+        pooled,
+        deferRHITexture);
+  }
+
   EPixelFormat pixelFormat;
   if (image.compressedPixelFormat != GpuCompressedPixelFormat::NONE) {
     switch (image.compressedPixelFormat) {
@@ -93,9 +378,16 @@ CesiumTextureUtility::loadTextureAnyThreadPart(
     };
   }
 
+  const EPixelFormat compressedFormat =
+      image.compressedPixelFormat == GpuCompressedPixelFormat::NONE
+          ? getRuntimeCompressedFormat(image, pixelFormat)
+          : PF_Unknown;
+
   LoadedTextureResult* pResult = new LoadedTextureResult{};
-  pResult->pTextureData =
-      createTexturePlatformData(image.width, image.height, pixelFormat);
+  pResult->pTextureData = createTexturePlatformData(
+      image.width,
+      image.height,
+      compressedFormat != PF_Unknown ? compressedFormat : pixelFormat);
   if (!pResult->pTextureData) {
     return nullptr;
   }
@@ -147,6 +439,16 @@ CesiumTextureUtility::loadTextureAnyThreadPart(
         height = 1;
       }
     }
+  } else if (compressedFormat != PF_Unknown) {
+    // Compressed textures can't be written by the GPU mip generation, so
+    // their mips are always generated here.
+    if (!createCompressedMips(
+            image,
+            pResult->filter == TextureFilter::TF_Trilinear,
+            compressedFormat,
+            *pResult->pTextureData)) {
+      pResult->filter = TextureFilter::TF_Bilinear;
+    }
   } else {
     int32_t width = image.width;
     int32_t height = image.height;
@@ -163,14 +465,34 @@ CesiumTextureUtility::loadTextureAnyThreadPart(
       pLevel0->SizeY = height;
       pLevel0->BulkData.Lock(LOCK_READ_WRITE);
 
-      pLastMipData = pLevel0->BulkData.Realloc(image.pixelData.size());
-      FMemory::Memcpy(
-          pLastMipData,
-          image.pixelData.data(),
-          image.pixelData.size());
+      if (channels == 3) {
+        // PF_R8G8B8A8 is used for RGB images too, so they are expanded as
+        // they are copied.
+        const int64 pixelCount = FMath::Min(
+            int64(width) * height,
+            int64(image.pixelData.size() / 3));
+        pLastMipData = pLevel0->BulkData.Realloc(int64(width) * height * 4);
+        expandRGBToRGBA(
+            reinterpret_cast<const uint8*>(image.pixelData.data()),
+            static_cast<uint8*>(pLastMipData),
+            pixelCount);
+        channels = 4;
+      } else {
+        pLastMipData = pLevel0->BulkData.Realloc(image.pixelData.size());
+        FMemory::Memcpy(
+            pLastMipData,
+            image.pixelData.data(),
+            image.pixelData.size());
+      }
     }
 
-    if (pResult->filter == TextureFilter::TF_Trilinear) {
+    // Streamed textures need the bulk data of every mip, so their mips are
+    // always generated here.
+    if (pResult->filter == TextureFilter::TF_Trilinear && !streamable &&
+        GetDefault<UCesiumRuntimeSettings>()->GenerateMipmapsOnGPU &&
+        RHISupportsComputeShaders(GMaxRHIShaderPlatform)) {
+      pResult->generateMipsOnGPU = true;
+    } else if (pResult->filter == TextureFilter::TF_Trilinear) {
       CESIUM_TRACE("Generate new mips.");
 
       // Generate mip levels.
@@ -226,13 +548,83 @@ CesiumTextureUtility::loadTextureAnyThreadPart(
     pResult->pTextureData->Mips[i].BulkData.Unlock();
   }
 
+  pResult->streamable = streamable && pResult->pTextureData->Mips.Num() > 1;
+
+  if (!pooled && !deferRHITexture) {
+    createRHITextureAnyThreadPart(pResult);
+  }
+
+  return pResult;
+}
+
+/*static*/ void CesiumTextureUtility::createRHITextureAnyThreadPart(
+    LoadedTextureResult* pTexture) {
+  if (pTexture && pTexture->pTextureData && !pTexture->rhiTexture &&
+      GRHISupportsAsyncTextureCreation && !pTexture->generateMipsOnGPU) {
+    createRHITextureAsync(*pTexture);
+  }
+}
+
+/*static*/ CesiumTextureUtility::LoadedTextureResult*
+CesiumTextureUtility::loadFloatTextureAnyThreadPart(
+    int32 width,
+    int32 height,
+    const float* data) {
+  CESIUM_TRACE("CesiumTextureUtility::loadFloatTextureAnyThreadPart");
+  return loadDataTextureAnyThreadPart(
+      width,
+      height,
+      PF_R32_FLOAT,
+      data,
+      TextureFilter::TF_Nearest);
+}
+
+/*static*/ CesiumTextureUtility::LoadedTextureResult*
+CesiumTextureUtility::loadDataTextureAnyThreadPart(
+    int32 width,
+    int32 height,
+    EPixelFormat format,
+    const void* data,
+    TextureFilter filter) {
+  CESIUM_TRACE("CesiumTextureUtility::loadDataTextureAnyThreadPart");
+
+  FTexturePlatformData* pTextureData =
+      createTexturePlatformData(width, height, format);
+  if (!pTextureData) {
+    return nullptr;
+  }
+
+  LoadedTextureResult* pResult = new LoadedTextureResult{};
+  pResult->pTextureData = pTextureData;
+  pResult->addressX = TextureAddress::TA_Clamp;
+  pResult->addressY = TextureAddress::TA_Clamp;
+  pResult->filter = filter;
+  pResult->sRGB = false;
+
+  FTexture2DMipMap* pLevel0 = new FTexture2DMipMap();
+  pTextureData->Mips.Add(pLevel0);
+  pLevel0->SizeX = width;
+  pLevel0->SizeY = height;
+  pLevel0->BulkData.Lock(LOCK_READ_WRITE);
+  const int64 byteSize =
+      int64(width) * height * GPixelFormats[format].BlockBytes;
+  FMemory::Memcpy(pLevel0->BulkData.Realloc(byteSize), data, byteSize);
+  pLevel0->BulkData.Unlock();
+
+  if (GRHISupportsAsyncTextureCreation) {
+    createRHITextureAsync(*pResult);
+  }
+
   return pResult;
 }
 
 /*static*/ CesiumTextureUtility::LoadedTextureResult*
 CesiumTextureUtility::loadTextureAnyThreadPart(
     const CesiumGltf::Model& model,
-    const CesiumGltf::Texture& texture) {
+    const CesiumGltf::Texture& texture,
+    bool streamable,
+    bool deferRHITexture,
+    int32 maximumSize) {
 
   const CesiumGltf::ExtensionKhrTextureBasisu* pKtxExtension =
       texture.getExtension<CesiumGltf::ExtensionKhrTextureBasisu>();
@@ -330,7 +722,297 @@ CesiumTextureUtility::loadTextureAnyThreadPart(
     }
   }
 
-  return loadTextureAnyThreadPart(image, addressX, addressY, filter);
+  return loadTextureAnyThreadPart(
+      image,
+      addressX,
+      addressY,
+      filter,
+      streamable,
+      false,
+      deferRHITexture,
+      maximumSize);
+}
+
+/**
+ * Replaces the RHI texture of the given texture, which only has its first
+ * mip, with one that has a complete mip chain generated on the GPU.
+ */
+static void generateMipsOnGPU(UTexture2D* pTexture) {
+#if ENGINE_MAJOR_VERSION >= 5
+  FTextureResource* pResource = pTexture->GetResource();
+#else
+  FTextureResource* pResource = pTexture->Resource;
+#endif
+  if (!pResource) {
+    return;
+  }
+
+  FTextureReferenceRHIRef pTextureReference =
+      pTexture->TextureReference.TextureReferenceRHI;
+
+  ENQUEUE_RENDER_COMMAND(CesiumGenerateMips)
+  ([pResource, pTextureReference](FRHICommandListImmediate& RHICmdList) {
+    CESIUM_TRACE("CesiumGenerateMips");
+
+    FRHITexture2D* pSource =
+        pResource->TextureRHI ? pResource->TextureRHI->GetTexture2D() : nullptr;
+    if (!pSource) {
+      return;
+    }
+
+    FIntPoint size = pSource->GetSizeXY();
+    uint32 numMips = FMath::FloorLog2(FMath::Max(size.X, size.Y)) + 1;
+
+#if ENGINE_MAJOR_VERSION >= 5
+    FRHIResourceCreateInfo createInfo(TEXT("CesiumMippedTexture"));
+#else
+    FRHIResourceCreateInfo createInfo;
+#endif
+    FTexture2DRHIRef pMipped = RHICreateTexture2D(
+        size.X,
+        size.Y,
+        pSource->GetFormat(),
+        numMips,
+        1,
+        TexCreate_ShaderResource | TexCreate_UAV,
+        createInfo);
+    if (!pMipped) {
+      return;
+    }
+
+    FRHICopyTextureInfo copyInfo;
+    copyInfo.Size = FIntVector(size.X, size.Y, 1);
+    copyInfo.NumMips = 1;
+    RHICmdList.Transition(
+        FRHITransitionInfo(pSource, ERHIAccess::Unknown, ERHIAccess::CopySrc));
+    RHICmdList.Transition(
+        FRHITransitionInfo(pMipped, ERHIAccess::Unknown, ERHIAccess::CopyDest));
+    RHICmdList.CopyTexture(pSource, pMipped, copyInfo);
+    RHICmdList.Transition(
+        FRHITransitionInfo(pSource, ERHIAccess::CopySrc, ERHIAccess::SRVMask));
+
+    FRDGBuilder graphBuilder(RHICmdList);
+    FRDGTextureRef pMippedRDG = graphBuilder.RegisterExternalTexture(
+        CreateRenderTarget(pMipped, TEXT("CesiumMippedTexture")));
+    FGenerateMips::Execute(
+        graphBuilder,
+        pMippedRDG,
+        TStaticSamplerState<SF_Bilinear, AM_Clamp, AM_Clamp, AM_Clamp>::
+            GetRHI());
+    graphBuilder.Execute();
+
+    RHICmdList.Transition(
+        FRHITransitionInfo(pMipped, ERHIAccess::Unknown, ERHIAccess::SRVMask));
+
+    // Materials may sample either the resource's texture or the reference.
+    pResource->TextureRHI = pMipped;
+    RHIUpdateTextureReference(pTextureReference, pMipped);
+  });
+}
+
+static ESamplerAddressMode convertAddressMode(TextureAddress address) {
+  switch (address) {
+  case TextureAddress::TA_Clamp:
+    return AM_Clamp;
+  case TextureAddress::TA_Mirror:
+    return AM_Mirror;
+  case TextureAddress::TA_Wrap:
+  default:
+    return AM_Wrap;
+  }
+}
+
+/**
+ * A texture resource for the textures of tiles. It either wraps an RHI
+ * texture that was already created, with all of its mips, by
+ * createRHITextureAsync, or creates one from the bulk data of the mips.
+ *
+ * Streamed textures keep the bulk data of all of their mips, so that the RHI
+ * texture can be recreated with fewer or more of its mips resident. Tile
+ * materials sample the texture reference, so they follow the new texture
+ * without being updated.
+ */
+class FCesiumTextureResource : public FTextureResource {
+public:
+  FCesiumTextureResource(
+      FTexture2DRHIRef pTexture,
+      const FTexturePlatformData* pTextureData,
+      FTextureReference* pTextureReference,
+      ESamplerFilter filter,
+      TextureAddress addressX,
+      TextureAddress addressY,
+      bool sRGB)
+      : _pTexture(pTexture),
+        _pTextureData(pTextureData),
+        _pTextureReference(pTextureReference),
+        _filter(filter),
+        _addressX(convertAddressMode(addressX)),
+        _addressY(convertAddressMode(addressY)) {
+    const EPixelFormat format = pTextureData->PixelFormat;
+    this->bSRGB = sRGB;
+    this->bGreyScaleFormat = format == PF_G8 || format == PF_BC4;
+  }
+
+  virtual uint32 GetSizeX() const override {
+    return this->_pTextureData->SizeX;
+  }
+
+  virtual uint32 GetSizeY() const override {
+    return this->_pTextureData->SizeY;
+  }
+
+  virtual void InitRHI() override {
+    if (!this->_pTexture) {
+      this->_pTexture = this->createTexture(this->_firstMip);
+    }
+
+    this->TextureRHI = this->_pTexture;
+    this->SamplerStateRHI =
+        GetOrCreateSamplerState(FSamplerStateInitializerRHI(
+            this->_filter,
+            this->_addressX,
+            this->_addressY));
+
+    // The texture reference is initialized on the render thread, so it is
+    // only read here.
+    this->TextureReferenceRHI = this->_pTextureReference->TextureReferenceRHI;
+    if (this->TextureReferenceRHI) {
+      RHIUpdateTextureReference(this->TextureReferenceRHI, this->TextureRHI);
+    }
+  }
+
+  virtual void ReleaseRHI() override {
+    if (this->TextureReferenceRHI) {
+      RHIUpdateTextureReference(this->TextureReferenceRHI, nullptr);
+    }
+    this->_pTexture.SafeRelease();
+    FTextureResource::ReleaseRHI();
+  }
+
+  /**
+   * Requests that only the mips from the given one down are resident. Must be
+   * called from the game thread.
+   */
+  void StreamMips(int32 firstMip) {
+    if (firstMip == this->_requestedFirstMip) {
+      return;
+    }
+    this->_requestedFirstMip = firstMip;
+
+    FCesiumTextureResource* pResource = this;
+    ENQUEUE_RENDER_COMMAND(CesiumStreamMips)
+    ([pResource, firstMip](FRHICommandListImmediate& RHICmdList) {
+      pResource->setFirstMip(firstMip);
+    });
+  }
+
+private:
+  void setFirstMip(int32 firstMip) {
+    CESIUM_TRACE("CesiumStreamMips");
+
+    this->_firstMip = firstMip;
+    if (!this->TextureRHI) {
+      // The resource isn't initialized yet, or was already released, so the
+      // new first mip is picked up when it is initialized.
+      return;
+    }
+
+    FTexture2DRHIRef pTexture = this->createTexture(firstMip);
+    if (!pTexture) {
+      return;
+    }
+
+    this->_pTexture = pTexture;
+    this->TextureRHI = pTexture;
+    if (this->TextureReferenceRHI) {
+      RHIUpdateTextureReference(this->TextureReferenceRHI, this->TextureRHI);
+    }
+  }
+
+  FTexture2DRHIRef createTexture(int32 firstMip) const {
+    const TIndirectArray<FTexture2DMipMap>& mips = this->_pTextureData->Mips;
+    const EPixelFormat format = this->_pTextureData->PixelFormat;
+    const FPixelFormatInfo& formatInfo = GPixelFormats[format];
+    const int32 numMips = mips.Num() - firstMip;
+    if (numMips <= 0) {
+      return nullptr;
+    }
+
+#if ENGINE_MAJOR_VERSION >= 5
+    FRHIResourceCreateInfo createInfo(TEXT("CesiumTexture"));
+#else
+    FRHIResourceCreateInfo createInfo;
+#endif
+    FTexture2DRHIRef pTexture = RHICreateTexture2D(
+        mips[firstMip].SizeX,
+        mips[firstMip].SizeY,
+        format,
+        numMips,
+        1,
+        this->bSRGB ? TexCreate_ShaderResource | TexCreate_SRGB
+                    : TexCreate_ShaderResource,
+        createInfo);
+    if (!pTexture) {
+      return nullptr;
+    }
+
+    // Copy each mip a row of blocks at a time, because the RHI may pad the
+    // rows of the locked texture.
+    for (int32 i = 0; i < numMips; ++i) {
+      const FTexture2DMipMap& mip = mips[firstMip + i];
+      const uint8* pSource =
+          static_cast<const uint8*>(mip.BulkData.LockReadOnly());
+      if (pSource) {
+        const int32 rowBytes =
+            FMath::DivideAndRoundUp(mip.SizeX, formatInfo.BlockSizeX) *
+            formatInfo.BlockBytes;
+        const int32 rows =
+            FMath::DivideAndRoundUp(mip.SizeY, formatInfo.BlockSizeY);
+
+        uint32 destinationStride = 0;
+        uint8* pDestination = static_cast<uint8*>(RHILockTexture2D(
+            pTexture,
+            i,
+            RLM_WriteOnly,
+            destinationStride,
+            false));
+        for (int32 row = 0; row < rows; ++row) {
+          FMemory::Memcpy(
+              pDestination + int64(row) * destinationStride,
+              pSource + int64(row) * rowBytes,
+              rowBytes);
+        }
+        RHIUnlockTexture2D(pTexture, i, false);
+      }
+      mip.BulkData.Unlock();
+    }
+
+    return pTexture;
+  }
+
+  FTexture2DRHIRef _pTexture;
+  const FTexturePlatformData* _pTextureData;
+  FTextureReference* _pTextureReference;
+  ESamplerFilter _filter;
+  ESamplerAddressMode _addressX;
+  ESamplerAddressMode _addressY;
+
+  // The first resident mip, accessed only by the render thread.
+  int32 _firstMip = 0;
+
+  // The first resident mip that was last requested, accessed only by the game
+  // thread.
+  int32 _requestedFirstMip = 0;
+};
+
+/*static*/ void CesiumTextureUtility::destroyHalfLoadedTexture(
+    LoadedTextureResult* pHalfLoadedTexture) {
+  if (!pHalfLoadedTexture) {
+    return;
+  }
+
+  delete pHalfLoadedTexture->pTextureData;
+  delete pHalfLoadedTexture;
 }
 
 /*static*/ bool CesiumTextureUtility::loadTextureGameThreadPart(
@@ -355,8 +1037,83 @@ CesiumTextureUtility::loadTextureAnyThreadPart(
     pTexture->AddressX = pHalfLoadedTexture->addressX;
     pTexture->AddressY = pHalfLoadedTexture->addressY;
     pTexture->Filter = pHalfLoadedTexture->filter;
-    pTexture->UpdateResource();
+    pTexture->SRGB = pHalfLoadedTexture->sRGB;
+
+    if (pHalfLoadedTexture->rhiTexture || pHalfLoadedTexture->streamable) {
+      // The RHI texture is already resident, or is created by the resource,
+      // so UpdateResource isn't needed.
+      if (!pTexture->TextureReference.IsInitialized_GameThread()) {
+        pTexture->TextureReference.BeginInit_GameThread();
+      }
+
+      FCesiumTextureResource* pResource = new FCesiumTextureResource(
+          pHalfLoadedTexture->rhiTexture,
+          pHalfLoadedTexture->pTextureData,
+          &pTexture->TextureReference,
+          UDeviceProfileManager::Get()
+              .GetActiveProfile()
+              ->GetTextureLODSettings()
+              ->GetSamplerFilter(pTexture),
+          pHalfLoadedTexture->addressX,
+          pHalfLoadedTexture->addressY,
+          pHalfLoadedTexture->sRGB);
+#if ENGINE_MAJOR_VERSION >= 5
+      pTexture->SetResource(pResource);
+#else
+      pTexture->Resource = pResource;
+#endif
+      BeginInitResource(pResource);
+      pHalfLoadedTexture->rhiTexture.SafeRelease();
+    } else {
+      pTexture->UpdateResource();
+
+      if (pHalfLoadedTexture->generateMipsOnGPU) {
+        generateMipsOnGPU(pTexture);
+      }
+    }
   }
 
   return true;
 }
+
+/*static*/ int64
+CesiumTextureUtility::getTextureMemoryBytes(const UTexture2D* pTexture) {
+  if (!pTexture) {
+    return 0;
+  }
+  return static_cast<int64>(pTexture->CalcTextureMemorySizeEnum(TMC_AllMips));
+}
+
+/*static*/ void CesiumTextureUtility::streamTextureMips(
+    UTexture2D* pTexture,
+    float screenSize) {
+#if ENGINE_MAJOR_VERSION >= 5
+  FTextureResource* pResource = pTexture->GetResource();
+  const FTexturePlatformData* pTextureData = pTexture->GetPlatformData();
+#else
+  FTextureResource* pResource = pTexture->Resource;
+  const FTexturePlatformData* pTextureData = pTexture->PlatformData;
+#endif
+  if (!pResource || !pTextureData) {
+    return;
+  }
+
+  // Keep the smallest mip that is still at least as large as the tile on
+  // screen. Block-compressed textures also need their first mip to be a
+  // whole number of blocks.
+  const FPixelFormatInfo& formatInfo = GPixelFormats[pTextureData->PixelFormat];
+  const float wantedSize = FMath::Max(screenSize, MinimumStreamedMipSize);
+  int32 firstMip = 0;
+  while (firstMip + 1 < pTextureData->Mips.Num()) {
+    const FTexture2DMipMap& nextMip = pTextureData->Mips[firstMip + 1];
+    if (FMath::Max(nextMip.SizeX, nextMip.SizeY) < wantedSize ||
+        nextMip.SizeX % formatInfo.BlockSizeX != 0 ||
+        nextMip.SizeY % formatInfo.BlockSizeY != 0) {
+      break;
+    }
+    ++firstMip;
+  }
+
+  // Only streamable textures are created with this resource type.
+  static_cast<FCesiumTextureResource*>(pResource)->StreamMips(firstMip);
+}
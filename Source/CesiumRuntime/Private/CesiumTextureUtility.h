@@ -15,19 +15,120 @@ public:
     TextureAddress addressY;
     TextureFilter filter;
     UTexture2D* pTexture;
+
+    // Whether only the first mip was loaded, and the others should be
+    // generated on the GPU once the texture is created.
+    bool generateMipsOnGPU = false;
+
+    // The RHI texture, with all of its mips, if it was already created
+    // asynchronously by the load thread part.
+    FTexture2DRHIRef rhiTexture;
+
+    // Whether the texture keeps the bulk data of all of its mips, so that
+    // they can be streamed by streamTextureMips.
+    bool streamable = false;
+
+    // Whether the texture holds colors that are converted from sRGB when it
+    // is sampled, rather than data.
+    bool sRGB = true;
   };
 
+  /**
+   * The size, in pixels, of the smallest mip that streamTextureMips keeps
+   * resident when the texture is larger.
+   */
+  static constexpr float MinimumStreamedMipSize = 64.0f;
+
   // TODO: documentation
+  //
+  // A pooled texture may be written into a texture from a CesiumTexturePool
+  // instead of being created, so its RHI texture is never created
+  // asynchronously. If deferRHITexture is true, the bulk data of the mips is
+  // kept until createRHITextureAnyThreadPart is called.
+  //
+  // If maximumSize is greater than zero, an uncompressed image with a side
+  // larger than it is halved until it fits, before its mips are made.
   static LoadedTextureResult* loadTextureAnyThreadPart(
       const CesiumGltf::ImageCesium& image,
       const TextureAddress& addressX,
       const TextureAddress& addressY,
-      const TextureFilter& filter);
+      const TextureFilter& filter,
+      bool streamable = false,
+      bool pooled = false,
+      bool deferRHITexture = false,
+      int32 maximumSize = 0);
 
   static LoadedTextureResult* loadTextureAnyThreadPart(
       const CesiumGltf::Model& model,
-      const CesiumGltf::Texture& texture);
+      const CesiumGltf::Texture& texture,
+      bool streamable = false,
+      bool deferRHITexture = false,
+      int32 maximumSize = 0);
+
+  /**
+   * Creates the RHI texture of a texture whose platform data was loaded
+   * without it, if the RHI can create textures asynchronously. Otherwise, it
+   * is created by loadTextureGameThreadPart as usual. May be called from any
+   * thread.
+   */
+  static void createRHITextureAnyThreadPart(LoadedTextureResult* pTexture);
+
+  /**
+   * Creates a texture with one 32-bit floating point channel, for data that
+   * is read by materials rather than for colors. The texture has no mips, is
+   * not converted from sRGB, and is sampled with nearest filtering and
+   * clamped texture coordinates.
+   *
+   * @param width The width of the texture, in texels.
+   * @param height The height of the texture, in texels.
+   * @param data The texels, row by row. It must hold width * height values.
+   */
+  static LoadedTextureResult*
+  loadFloatTextureAnyThreadPart(int32 width, int32 height, const float* data);
+
+  /**
+   * Creates a texture of the given uncompressed pixel format, for data that
+   * is read by materials, like loadFloatTextureAnyThreadPart does, but with
+   * the given filter.
+   *
+   * @param width The width of the texture, in texels.
+   * @param height The height of the texture, in texels.
+   * @param format The pixel format of the texels, which must not be a block
+   * compressed one.
+   * @param data The texels, row by row.
+   * @param filter The filter that the texture is sampled with.
+   */
+  static LoadedTextureResult* loadDataTextureAnyThreadPart(
+      int32 width,
+      int32 height,
+      EPixelFormat format,
+      const void* data,
+      TextureFilter filter);
 
   static bool
   loadTextureGameThreadPart(LoadedTextureResult* pHalfLoadedTexture);
+
+  /**
+   * Frees a texture that was loaded by one of the AnyThreadPart functions
+   * but never passed to loadTextureGameThreadPart, including its platform
+   * data and mips. Does nothing if the texture is nullptr.
+   */
+  static void destroyHalfLoadedTexture(LoadedTextureResult* pHalfLoadedTexture);
+
+  /**
+   * Gets the number of bytes used by all of the mips of the given texture on
+   * the GPU, or 0 if the texture is nullptr.
+   */
+  static int64 getTextureMemoryBytes(const UTexture2D* pTexture);
+
+  /**
+   * Streams the mips of a texture that was loaded as streamable, so that only
+   * the mips needed to cover the given size on screen are resident on the
+   * GPU. Must be called from the game thread.
+   *
+   * @param pTexture The texture.
+   * @param screenSize The size of the texture on screen, in pixels, or 0 if it
+   * is not visible. At least the mips down to MinimumStreamedMipSize are kept.
+   */
+  static void streamTextureMips(UTexture2D* pTexture, float screenSize);
 };
@@ -0,0 +1,194 @@
+// Copyright 2020-2021 CesiumGS, Inc. and Contributors
+
+#include "CesiumTileBatchComponent.h"
+#include "CesiumGltfPrimitiveComponent.h"
+#include "CesiumTileBatchSceneProxy.h"
+#include "CesiumUtility/Tracing.h"
+#include "Engine/StaticMesh.h"
+#include "Materials/Material.h"
+#include "Runtime/Launch/Resources/Version.h"
+#include "SceneInterface.h"
+#include "StaticMeshResources.h"
+
+namespace {
+
+FStaticMeshRenderData*
+getRenderData(const UCesiumGltfPrimitiveComponent* pPrimitive) {
+  UStaticMesh* pStaticMesh = pPrimitive->GetStaticMesh();
+  if (!pStaticMesh) {
+    return nullptr;
+  }
+#if ENGINE_MAJOR_VERSION == 4 && ENGINE_MINOR_VERSION < 27
+  return pStaticMesh->RenderData.Get();
+#else
+  return pStaticMesh->GetRenderData();
+#endif
+}
+
+/**
+ * Creates the render state of a primitive from its static mesh, materials,
+ * and current component state.
+ */
+CesiumTileBatchEntry createEntry(
+    const UCesiumGltfPrimitiveComponent* pPrimitive,
+    ERHIFeatureLevel::Type featureLevel) {
+  CesiumTileBatchEntry entry;
+
+  FStaticMeshRenderData* pRenderData = getRenderData(pPrimitive);
+  if (!pRenderData || pRenderData->LODResources.Num() == 0 ||
+      pRenderData->LODVertexFactories.Num() == 0) {
+    return entry;
+  }
+
+  const FStaticMeshLODResources& resources = pRenderData->LODResources[0];
+  entry.pResources = &resources;
+  entry.pVertexFactory = &pRenderData->LODVertexFactories[0].VertexFactory;
+
+  entry.sections.Reserve(resources.Sections.Num());
+  for (const FStaticMeshSection& section : resources.Sections) {
+    UMaterialInterface* pMaterial =
+        pPrimitive->GetMaterial(section.MaterialIndex);
+    if (!pMaterial) {
+      pMaterial = UMaterial::GetDefaultMaterial(MD_Surface);
+    }
+    entry.materialRelevance |= pMaterial->GetRelevance_Concurrent(featureLevel);
+
+    CesiumTileBatchSection& batchSection = entry.sections.Emplace_GetRef();
+    batchSection.pMaterial = pMaterial->GetRenderProxy();
+    batchSection.firstIndex = section.FirstIndex;
+    batchSection.numTriangles = section.NumTriangles;
+    batchSection.minVertexIndex = section.MinVertexIndex;
+    batchSection.maxVertexIndex = section.MaxVertexIndex;
+  }
+
+  entry.localToWorld = pPrimitive->GetComponentTransform().ToMatrixWithScale();
+  entry.localBounds = pPrimitive->GetStaticMesh()->GetBounds();
+  entry.worldBounds = entry.localBounds.TransformBy(entry.localToWorld);
+  entry.maximumDrawDistance = pPrimitive->CachedMaxDrawDistance;
+  entry.visible = pPrimitive->IsVisible();
+  entry.castShadow = pPrimitive->CastShadow;
+  entry.reverseCulling = entry.localToWorld.Determinant() < 0.0f;
+  return entry;
+}
+
+} // namespace
+
+UCesiumTileBatchComponent::UCesiumTileBatchComponent() {
+  PrimaryComponentTick.bCanEverTick = false;
+  SetCollisionEnabled(ECollisionEnabled::NoCollision);
+  SetGenerateOverlapEvents(false);
+  Mobility = EComponentMobility::Movable;
+}
+
+UCesiumTileBatchComponent::~UCesiumTileBatchComponent() {}
+
+/*static*/ bool UCesiumTileBatchComponent::CanBatch(
+    const UCesiumGltfPrimitiveComponent* Primitive) {
+  if (!Primitive || Primitive->IsPointCloud || Primitive->IsHeightfield) {
+    return false;
+  }
+
+#if ENGINE_MAJOR_VERSION == 5
+  // Nanite meshes are drawn by the Nanite scene proxy.
+  if (Primitive->GetStaticMesh() &&
+      Primitive->GetStaticMesh()->HasValidNaniteData()) {
+    return false;
+  }
+#endif
+
+  FStaticMeshRenderData* pRenderData = getRenderData(Primitive);
+  return pRenderData && pRenderData->LODResources.Num() > 0 &&
+         pRenderData->LODVertexFactories.Num() > 0;
+}
+
+void UCesiumTileBatchComponent::AddPrimitive(
+    UCesiumGltfPrimitiveComponent* Primitive) {
+  this->_primitives.Add(Primitive);
+
+  FCesiumTileBatchSceneProxy* pProxy =
+      static_cast<FCesiumTileBatchSceneProxy*>(this->SceneProxy);
+  if (!pProxy || !this->GetScene()) {
+    // The primitive is added when the scene proxy is created.
+    return;
+  }
+
+  CESIUM_TRACE("UCesiumTileBatchComponent::AddPrimitive");
+
+  const void* pKey = Primitive;
+  CesiumTileBatchEntry entry =
+      createEntry(Primitive, this->GetScene()->GetFeatureLevel());
+  ENQUEUE_RENDER_COMMAND(CesiumSetTileBatchEntry)
+  ([pProxy, pKey, entry = MoveTemp(entry)](
+       FRHICommandListImmediate& RHICmdList) mutable {
+    pProxy->setEntry_RenderThread(pKey, MoveTemp(entry));
+  });
+}
+
+void UCesiumTileBatchComponent::RemovePrimitive(
+    UCesiumGltfPrimitiveComponent* Primitive) {
+  if (this->_primitives.Remove(Primitive) == 0) {
+    return;
+  }
+
+  FCesiumTileBatchSceneProxy* pProxy =
+      static_cast<FCesiumTileBatchSceneProxy*>(this->SceneProxy);
+  if (!pProxy) {
+    return;
+  }
+
+  const void* pKey = Primitive;
+  ENQUEUE_RENDER_COMMAND(CesiumRemoveTileBatchEntry)
+  ([pProxy, pKey](FRHICommandListImmediate& RHICmdList) {
+    pProxy->removeEntry_RenderThread(pKey);
+  });
+}
+
+void UCesiumTileBatchComponent::UpdatePrimitiveVisibility(
+    UCesiumGltfPrimitiveComponent* Primitive) {
+  FCesiumTileBatchSceneProxy* pProxy =
+      static_cast<FCesiumTileBatchSceneProxy*>(this->SceneProxy);
+  if (!pProxy || !this->_primitives.Contains(Primitive)) {
+    return;
+  }
+
+  const void* pKey = Primitive;
+  const bool visible = Primitive->IsVisible();
+  ENQUEUE_RENDER_COMMAND(CesiumSetTileBatchEntryVisible)
+  ([pProxy, pKey, visible](FRHICommandListImmediate& RHICmdList) {
+    pProxy->setEntryVisible_RenderThread(pKey, visible);
+  });
+}
+
+FPrimitiveSceneProxy* UCesiumTileBatchComponent::CreateSceneProxy() {
+  CESIUM_TRACE("UCesiumTileBatchComponent::CreateSceneProxy");
+
+  const ERHIFeatureLevel::Type featureLevel =
+      this->GetScene() ? this->GetScene()->GetFeatureLevel()
+                       : GMaxRHIFeatureLevel;
+
+  TArray<TPair<const void*, CesiumTileBatchEntry>> entries;
+  entries.Reserve(this->_primitives.Num());
+  for (UCesiumGltfPrimitiveComponent* pPrimitive : this->_primitives) {
+    entries.Emplace(pPrimitive, createEntry(pPrimitive, featureLevel));
+  }
+
+  return new FCesiumTileBatchSceneProxy(this, MoveTemp(entries));
+}
+
+FBoxSphereBounds
+UCesiumTileBatchComponent::CalcBounds(const FTransform& LocalToWorld) const {
+  // The primitives are culled one by one by the scene proxy, so the bounds of
+  // the component only need to contain them without being kept up to date.
+  return FBoxSphereBounds(
+      FVector::ZeroVector,
+      FVector(HALF_WORLD_MAX),
+      HALF_WORLD_MAX);
+}
+
+void UCesiumTileBatchComponent::GetUsedMaterials(
+    TArray<UMaterialInterface*>& OutMaterials,
+    bool bGetDebugMaterials) const {
+  for (UCesiumGltfPrimitiveComponent* pPrimitive : this->_primitives) {
+    pPrimitive->GetUsedMaterials(OutMaterials, bGetDebugMaterials);
+  }
+}
@@ -0,0 +1,67 @@
+// Copyright 2020-2021 CesiumGS, Inc. and Contributors
+
+#pragma once
+
+#include "Components/PrimitiveComponent.h"
+#include "CoreMinimal.h"
+#include "CesiumTileBatchComponent.generated.h"
+
+class UCesiumGltfPrimitiveComponent;
+
+/**
+ * The component that draws the batched primitives of a tileset, so that
+ * they don't need render states of their own. See
+ * ACesium3DTileset::UseBatchedRendering.
+ *
+ * The primitives stay registered components, with their collision and
+ * metadata, but they don't create a scene proxy. Instead, they add
+ * themselves to this component when they are registered and remove
+ * themselves when they are unregistered, and any change to their transform,
+ * visibility, materials, shadows, or draw distance is sent to the scene
+ * proxy of this component with a render command.
+ */
+UCLASS()
+class UCesiumTileBatchComponent : public UPrimitiveComponent {
+  GENERATED_BODY()
+
+public:
+  UCesiumTileBatchComponent();
+  virtual ~UCesiumTileBatchComponent();
+
+  /**
+   * Whether the given primitive can be drawn by a tile batch. Point clouds,
+   * heightfields, Nanite meshes, and primitives without render data are
+   * drawn by their own scene proxies.
+   */
+  static bool CanBatch(const UCesiumGltfPrimitiveComponent* Primitive);
+
+  /**
+   * Adds a primitive to this batch, or updates it if it has already been
+   * added. The primitive must be registered and satisfy CanBatch.
+   */
+  void AddPrimitive(UCesiumGltfPrimitiveComponent* Primitive);
+
+  /**
+   * Removes a primitive from this batch, if it has been added.
+   */
+  void RemovePrimitive(UCesiumGltfPrimitiveComponent* Primitive);
+
+  /**
+   * Shows or hides a primitive of this batch according to its visibility.
+   */
+  void UpdatePrimitiveVisibility(UCesiumGltfPrimitiveComponent* Primitive);
+
+  virtual FPrimitiveSceneProxy* CreateSceneProxy() override;
+
+  virtual FBoxSphereBounds
+  CalcBounds(const FTransform& LocalToWorld) const override;
+
+  virtual void GetUsedMaterials(
+      TArray<UMaterialInterface*>& OutMaterials,
+      bool bGetDebugMaterials = false) const override;
+
+private:
+  // The primitives of this batch. They are not referenced by this set,
+  // because they always remove themselves before they are destroyed.
+  TSet<UCesiumGltfPrimitiveComponent*> _primitives;
+};
@@ -0,0 +1,200 @@
+// Copyright 2020-2021 CesiumGS, Inc. and Contributors
+
+#include "CesiumTileBatchSceneProxy.h"
+#include "CesiumTileBatchComponent.h"
+#include "Runtime/Launch/Resources/Version.h"
+#include "SceneManagement.h"
+#include "StaticMeshResources.h"
+
+FCesiumTileBatchSceneProxy::FCesiumTileBatchSceneProxy(
+    UCesiumTileBatchComponent* pComponent,
+    TArray<TPair<const void*, CesiumTileBatchEntry>>&& entries)
+    : FPrimitiveSceneProxy(pComponent),
+      _entries(),
+      _keys(),
+      _indices(),
+      _materialRelevance() {
+  this->_entries.Reserve(entries.Num());
+  this->_keys.Reserve(entries.Num());
+  for (TPair<const void*, CesiumTileBatchEntry>& entry : entries) {
+    this->addEntry(entry.Key, MoveTemp(entry.Value));
+  }
+
+  // The materials of the entries change after the proxy is created, so they
+  // can't be checked against the ones the component reported.
+  this->bVerifyUsedMaterials = false;
+}
+
+void FCesiumTileBatchSceneProxy::setEntry_RenderThread(
+    const void* pKey,
+    CesiumTileBatchEntry&& entry) {
+  check(IsInRenderingThread());
+
+  const int32* pIndex = this->_indices.Find(pKey);
+  if (pIndex) {
+    this->_materialRelevance |= entry.materialRelevance;
+    this->_entries[*pIndex] = MoveTemp(entry);
+  } else {
+    this->addEntry(pKey, MoveTemp(entry));
+  }
+}
+
+void FCesiumTileBatchSceneProxy::removeEntry_RenderThread(const void* pKey) {
+  check(IsInRenderingThread());
+
+  int32 index;
+  if (!this->_indices.RemoveAndCopyValue(pKey, index)) {
+    return;
+  }
+
+  // The last entry takes the place of the removed one.
+  this->_entries.RemoveAtSwap(index, 1, false);
+  this->_keys.RemoveAtSwap(index, 1, false);
+  if (index < this->_keys.Num()) {
+    this->_indices[this->_keys[index]] = index;
+  }
+}
+
+void FCesiumTileBatchSceneProxy::setEntryVisible_RenderThread(
+    const void* pKey,
+    bool visible) {
+  check(IsInRenderingThread());
+
+  const int32* pIndex = this->_indices.Find(pKey);
+  if (pIndex) {
+    this->_entries[*pIndex].visible = visible;
+  }
+}
+
+SIZE_T FCesiumTileBatchSceneProxy::GetTypeHash() const {
+  static size_t uniquePointer;
+  return reinterpret_cast<size_t>(&uniquePointer);
+}
+
+void FCesiumTileBatchSceneProxy::GetDynamicMeshElements(
+    const TArray<const FSceneView*>& Views,
+    const FSceneViewFamily& ViewFamily,
+    uint32 VisibilityMap,
+    FMeshElementCollector& Collector) const {
+  for (int32 viewIndex = 0; viewIndex < Views.Num(); ++viewIndex) {
+    if (!(VisibilityMap & (1 << viewIndex))) {
+      continue;
+    }
+
+    const FSceneView* pView = Views[viewIndex];
+    const FVector viewOrigin = pView->ViewMatrices.GetViewOrigin();
+
+    for (const CesiumTileBatchEntry& entry : this->_entries) {
+      if (!entry.visible || !entry.pResources || !entry.pVertexFactory) {
+        continue;
+      }
+
+      const float maximumDistance = entry.maximumDrawDistance;
+      if (maximumDistance > 0.0f &&
+          FVector::DistSquared(entry.worldBounds.Origin, viewOrigin) >
+              FMath::Square(maximumDistance + entry.worldBounds.SphereRadius)) {
+        continue;
+      }
+
+      // The meshes of the main views are also drawn into the shadow maps, so
+      // entries outside of the frustum are still drawn there if they cast
+      // shadows.
+      const bool inFrustum = pView->ViewFrustum.IntersectBox(
+          entry.worldBounds.Origin,
+          entry.worldBounds.BoxExtent);
+      if (!inFrustum && !entry.castShadow) {
+        continue;
+      }
+
+      FDynamicPrimitiveUniformBuffer& uniformBuffer =
+          Collector.AllocateOneFrameResource<FDynamicPrimitiveUniformBuffer>();
+#if ENGINE_MAJOR_VERSION == 5
+      uniformBuffer.Set(
+          entry.localToWorld,
+          entry.localToWorld,
+          entry.worldBounds,
+          entry.localBounds,
+          entry.localBounds,
+          true,
+          false,
+          false);
+#else
+      uniformBuffer.Set(
+          entry.localToWorld,
+          entry.localToWorld,
+          entry.worldBounds,
+          entry.localBounds,
+          entry.localBounds,
+          true,
+          false,
+          false,
+          false);
+#endif
+
+      for (const CesiumTileBatchSection& section : entry.sections) {
+        if (section.numTriangles == 0 || !section.pMaterial) {
+          continue;
+        }
+
+        FMeshBatch& mesh = Collector.AllocateMesh();
+        mesh.VertexFactory = entry.pVertexFactory;
+        mesh.MaterialRenderProxy = section.pMaterial;
+        mesh.Type = PT_TriangleList;
+        mesh.DepthPriorityGroup = SDPG_World;
+        mesh.ReverseCulling = entry.reverseCulling;
+        mesh.CastShadow = entry.castShadow;
+        mesh.bUseForMaterial = inFrustum;
+        mesh.bUseForDepthPass = inFrustum;
+        mesh.bCanApplyViewModeOverrides = false;
+
+        FMeshBatchElement& element = mesh.Elements[0];
+        element.IndexBuffer = &entry.pResources->IndexBuffer;
+        element.FirstIndex = section.firstIndex;
+        element.NumPrimitives = section.numTriangles;
+        element.MinVertexIndex = section.minVertexIndex;
+        element.MaxVertexIndex = section.maxVertexIndex;
+        element.PrimitiveUniformBufferResource = &uniformBuffer.UniformBuffer;
+
+        Collector.AddMesh(viewIndex, mesh);
+      }
+    }
+  }
+}
+
+FPrimitiveViewRelevance
+FCesiumTileBatchSceneProxy::GetViewRelevance(const FSceneView* View) const {
+  FPrimitiveViewRelevance result;
+  result.bDrawRelevance = IsShown(View);
+  result.bDynamicRelevance = true;
+  result.bShadowRelevance = IsShadowCast(View);
+  result.bRenderInMainPass = ShouldRenderInMainPass();
+  result.bRenderCustomDepth = ShouldRenderCustomDepth();
+  this->_materialRelevance.SetPrimitiveViewRelevance(result);
+  return result;
+}
+
+bool FCesiumTileBatchSceneProxy::CanBeOccluded() const {
+  // The bounds of the proxy cover the whole tileset, so an occlusion query
+  // would never hide it, and the entries are culled one by one instead.
+  return false;
+}
+
+uint32 FCesiumTileBatchSceneProxy::GetMemoryFootprint() const {
+  uint32 result = sizeof(*this) + GetAllocatedSize();
+  result += this->_entries.GetAllocatedSize();
+  result += this->_keys.GetAllocatedSize();
+  result += this->_indices.GetAllocatedSize();
+  for (const CesiumTileBatchEntry& entry : this->_entries) {
+    result += entry.sections.GetAllocatedSize();
+  }
+  return result;
+}
+
+void FCesiumTileBatchSceneProxy::addEntry(
+    const void* pKey,
+    CesiumTileBatchEntry&& entry) {
+  this->_materialRelevance |= entry.materialRelevance;
+  this->_indices.Add(pKey, this->_entries.Num());
+  this->_keys.Add(pKey);
+  this->_entries.Add(MoveTemp(entry));
+}
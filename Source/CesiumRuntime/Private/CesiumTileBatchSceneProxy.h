@@ -0,0 +1,108 @@
+// Copyright 2020-2021 CesiumGS, Inc. and Contributors
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MaterialShared.h"
+#include "PrimitiveSceneProxy.h"
+
+class FLocalVertexFactory;
+class FMaterialRenderProxy;
+class UCesiumTileBatchComponent;
+struct FStaticMeshLODResources;
+
+/**
+ * @brief A section of a primitive in a {@link FCesiumTileBatchSceneProxy},
+ * which is drawn with one material.
+ */
+struct CesiumTileBatchSection {
+  const FMaterialRenderProxy* pMaterial = nullptr;
+  uint32 firstIndex = 0;
+  uint32 numTriangles = 0;
+  uint32 minVertexIndex = 0;
+  uint32 maxVertexIndex = 0;
+};
+
+/**
+ * @brief The render state of a primitive in a
+ * {@link FCesiumTileBatchSceneProxy}, which is created on the game thread
+ * and then copied to the render thread.
+ *
+ * The resources, vertex factory, and materials are those of the primitive's
+ * static mesh and material instances, which outlive the entry because the
+ * primitive removes it before releasing them.
+ */
+struct CesiumTileBatchEntry {
+  const FStaticMeshLODResources* pResources = nullptr;
+  const FLocalVertexFactory* pVertexFactory = nullptr;
+  TArray<CesiumTileBatchSection> sections;
+  FMaterialRelevance materialRelevance;
+  FMatrix localToWorld = FMatrix::Identity;
+  FBoxSphereBounds localBounds = FBoxSphereBounds(ForceInit);
+  FBoxSphereBounds worldBounds = FBoxSphereBounds(ForceInit);
+  // The maximum draw distance, in Unreal units, or 0 for no limit.
+  float maximumDrawDistance = 0.0f;
+  bool visible = true;
+  bool castShadow = true;
+  bool reverseCulling = false;
+};
+
+/**
+ * @brief Draws all of the batched primitives of a tileset from a single
+ * scene proxy.
+ *
+ * The primitives are added, updated, shown, hidden, and removed with render
+ * commands, so none of them needs a scene proxy of its own, which saves the
+ * game-thread registration and render-thread proxy creation of each
+ * primitive. Each frame, the primitives are culled against the frustum and
+ * draw distance of each view, and the ones that remain are drawn with a
+ * primitive uniform buffer of their own.
+ */
+class FCesiumTileBatchSceneProxy final : public FPrimitiveSceneProxy {
+public:
+  FCesiumTileBatchSceneProxy(
+      UCesiumTileBatchComponent* pComponent,
+      TArray<TPair<const void*, CesiumTileBatchEntry>>&& entries);
+
+  /**
+   * @brief Adds the entry of a primitive, or replaces it if there already is
+   * one with the same key.
+   */
+  void setEntry_RenderThread(const void* pKey, CesiumTileBatchEntry&& entry);
+
+  /**
+   * @brief Removes the entry of a primitive, if there is one.
+   */
+  void removeEntry_RenderThread(const void* pKey);
+
+  /**
+   * @brief Shows or hides the entry of a primitive, if there is one.
+   */
+  void setEntryVisible_RenderThread(const void* pKey, bool visible);
+
+  virtual SIZE_T GetTypeHash() const override;
+
+  virtual void GetDynamicMeshElements(
+      const TArray<const FSceneView*>& Views,
+      const FSceneViewFamily& ViewFamily,
+      uint32 VisibilityMap,
+      FMeshElementCollector& Collector) const override;
+
+  virtual FPrimitiveViewRelevance
+  GetViewRelevance(const FSceneView* View) const override;
+
+  virtual bool CanBeOccluded() const override;
+
+  virtual uint32 GetMemoryFootprint() const override;
+
+private:
+  void addEntry(const void* pKey, CesiumTileBatchEntry&& entry);
+
+  TArray<CesiumTileBatchEntry> _entries;
+  TArray<const void*> _keys;
+  TMap<const void*, int32> _indices;
+
+  // The combined relevance of the materials of all entries that were ever
+  // added, which is never narrowed, so that removing an entry is cheap.
+  FMaterialRelevance _materialRelevance;
+};
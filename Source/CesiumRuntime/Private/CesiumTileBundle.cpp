@@ -0,0 +1,309 @@
+// Copyright 2020-2021 CesiumGS, Inc. and Contributors
+
+#include "CesiumTileBundle.h"
+#include "Async/MappedFileHandle.h"
+#include "CesiumAsync/IAssetRequest.h"
+#include "CesiumAsync/IAssetResponse.h"
+#include "CesiumRuntime.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformFileManager.h"
+#include "Misc/FileHelper.h"
+#include "Serialization/Archive.h"
+#include <cstring>
+
+static_assert(
+    PLATFORM_LITTLE_ENDIAN,
+    "Tile bundles are read and written on little-endian platforms only.");
+
+namespace {
+constexpr char BundleMagic[4] = {'C', 'T', 'B', '1'};
+constexpr uint32_t BundleVersion = 1;
+constexpr uint64_t HeaderSize = 12;
+constexpr uint64_t EntryHeaderSize = 24;
+
+template <typename T>
+bool readValue(
+    const std::byte* pData,
+    uint64_t size,
+    uint64_t& offset,
+    T& value) {
+  if (offset + sizeof(T) > size) {
+    return false;
+  }
+  std::memcpy(&value, pData + offset, sizeof(T));
+  offset += sizeof(T);
+  return true;
+}
+
+template <typename T> void writeValue(FArchive& archive, T value) {
+  archive.Serialize(&value, sizeof(T));
+}
+
+class BundleAssetResponse : public CesiumAsync::IAssetResponse {
+public:
+  BundleAssetResponse(
+      const std::string& contentType,
+      gsl::span<const std::byte> data)
+      : _contentType(contentType), _data(data) {}
+
+  virtual uint16_t statusCode() const override { return 200; }
+
+  virtual std::string contentType() const override {
+    return this->_contentType;
+  }
+
+  virtual const CesiumAsync::HttpHeaders& headers() const override {
+    return this->_headers;
+  }
+
+  virtual gsl::span<const std::byte> data() const override {
+    return this->_data;
+  }
+
+private:
+  std::string _contentType;
+  gsl::span<const std::byte> _data;
+  CesiumAsync::HttpHeaders _headers;
+};
+
+class BundleAssetRequest : public CesiumAsync::IAssetRequest {
+public:
+  BundleAssetRequest(
+      const std::shared_ptr<CesiumTileBundle>& pBundle,
+      const std::string& url,
+      const std::string& contentType,
+      gsl::span<const std::byte> data)
+      : _pBundle(pBundle),
+        _url(url),
+        _method("GET"),
+        _response(contentType, data) {}
+
+  virtual const std::string& method() const override { return this->_method; }
+
+  virtual const std::string& url() const override { return this->_url; }
+
+  virtual const CesiumAsync::HttpHeaders& headers() const override {
+    return this->_headers;
+  }
+
+  virtual const CesiumAsync::IAssetResponse* response() const override {
+    return &this->_response;
+  }
+
+private:
+  // Keeps the bundle, and so the memory that the response's data points to,
+  // alive for as long as the request.
+  std::shared_ptr<CesiumTileBundle> _pBundle;
+  std::string _url;
+  std::string _method;
+  CesiumAsync::HttpHeaders _headers;
+  BundleAssetResponse _response;
+};
+} // namespace
+
+std::shared_ptr<CesiumTileBundle> CesiumTileBundle::open(const FString& path) {
+  std::shared_ptr<CesiumTileBundle> pBundle(new CesiumTileBundle());
+
+  IPlatformFile& platformFile = FPlatformFileManager::Get().GetPlatformFile();
+  pBundle->_pMappedFile = platformFile.OpenMapped(*path);
+  if (pBundle->_pMappedFile) {
+    pBundle->_pMappedRegion = pBundle->_pMappedFile->MapRegion(
+        0,
+        pBundle->_pMappedFile->GetFileSize());
+  }
+
+  if (pBundle->_pMappedRegion) {
+    pBundle->_pData = reinterpret_cast<const std::byte*>(
+        pBundle->_pMappedRegion->GetMappedPtr());
+    pBundle->_size = uint64_t(pBundle->_pMappedRegion->GetMappedSize());
+  } else if (FFileHelper::LoadFileToArray(pBundle->_loadedFile, *path)) {
+    pBundle->_pData =
+        reinterpret_cast<const std::byte*>(pBundle->_loadedFile.GetData());
+    pBundle->_size = uint64_t(pBundle->_loadedFile.Num());
+  } else {
+    UE_LOG(LogCesium, Error, TEXT("Could not open tile bundle %s"), *path);
+    return nullptr;
+  }
+
+  if (!pBundle->readIndex()) {
+    UE_LOG(LogCesium, Error, TEXT("Tile bundle %s is not valid"), *path);
+    return nullptr;
+  }
+
+  UE_LOG(
+      LogCesium,
+      Display,
+      TEXT("Serving %d responses from tile bundle %s"),
+      int32(pBundle->_entries.size()),
+      *path);
+
+  return pBundle;
+}
+
+bool CesiumTileBundle::write(
+    const FString& path,
+    const std::vector<EntryToWrite>& entries) {
+  TUniquePtr<FArchive> pArchive(IFileManager::Get().CreateFileWriter(*path));
+  if (!pArchive) {
+    return false;
+  }
+
+  uint64_t dataOffset = HeaderSize;
+  for (const EntryToWrite& entry : entries) {
+    dataOffset +=
+        EntryHeaderSize + entry.url.size() + entry.contentType.size();
+  }
+
+  pArchive->Serialize(const_cast<char*>(BundleMagic), sizeof(BundleMagic));
+  writeValue(*pArchive, BundleVersion);
+  writeValue(*pArchive, uint32_t(entries.size()));
+
+  for (const EntryToWrite& entry : entries) {
+    writeValue(*pArchive, uint32_t(entry.url.size()));
+    writeValue(*pArchive, uint32_t(entry.contentType.size()));
+    writeValue(*pArchive, dataOffset);
+    writeValue(*pArchive, uint64_t(entry.data.size()));
+    pArchive->Serialize(
+        const_cast<char*>(entry.url.data()),
+        int64(entry.url.size()));
+    pArchive->Serialize(
+        const_cast<char*>(entry.contentType.data()),
+        int64(entry.contentType.size()));
+    dataOffset += entry.data.size();
+  }
+
+  for (const EntryToWrite& entry : entries) {
+    pArchive->Serialize(
+        const_cast<std::byte*>(entry.data.data()),
+        int64(entry.data.size()));
+  }
+
+  return pArchive->Close();
+}
+
+CesiumTileBundle::~CesiumTileBundle() {
+  delete this->_pMappedRegion;
+  delete this->_pMappedFile;
+}
+
+bool CesiumTileBundle::find(
+    const std::string& url,
+    gsl::span<const std::byte>& data,
+    const std::string*& pContentType) const {
+  auto it = this->_entries.find(url);
+  if (it == this->_entries.end()) {
+    return false;
+  }
+
+  data = gsl::span<const std::byte>(
+      this->_pData + it->second.offset,
+      size_t(it->second.size));
+  pContentType = &it->second.contentType;
+  return true;
+}
+
+bool CesiumTileBundle::readIndex() {
+  if (this->_size < HeaderSize ||
+      std::memcmp(this->_pData, BundleMagic, sizeof(BundleMagic)) != 0) {
+    return false;
+  }
+
+  uint64_t offset = sizeof(BundleMagic);
+  uint32_t version = 0;
+  uint32_t count = 0;
+  if (!readValue(this->_pData, this->_size, offset, version) ||
+      version != BundleVersion ||
+      !readValue(this->_pData, this->_size, offset, count)) {
+    return false;
+  }
+
+  this->_entries.reserve(count);
+
+  for (uint32_t i = 0; i < count; ++i) {
+    uint32_t urlLength = 0;
+    uint32_t contentTypeLength = 0;
+    Entry entry;
+    if (!readValue(this->_pData, this->_size, offset, urlLength) ||
+        !readValue(this->_pData, this->_size, offset, contentTypeLength) ||
+        !readValue(this->_pData, this->_size, offset, entry.offset) ||
+        !readValue(this->_pData, this->_size, offset, entry.size) ||
+        offset + urlLength + contentTypeLength > this->_size ||
+        entry.offset > this->_size ||
+        entry.size > this->_size - entry.offset) {
+      return false;
+    }
+
+    const char* pStrings =
+        reinterpret_cast<const char*>(this->_pData + offset);
+    std::string url(pStrings, urlLength);
+    entry.contentType.assign(pStrings + urlLength, contentTypeLength);
+    offset += uint64_t(urlLength) + contentTypeLength;
+
+    this->_entries.emplace(std::move(url), std::move(entry));
+  }
+
+  return true;
+}
+
+CesiumTileBundleAssetAccessor::CesiumTileBundleAssetAccessor(
+    std::vector<std::shared_ptr<CesiumTileBundle>>&& bundles,
+    const std::shared_ptr<CesiumAsync::IAssetAccessor>& pFallback)
+    : _bundles(std::move(bundles)), _pFallback(pFallback) {}
+
+CesiumAsync::Future<std::shared_ptr<CesiumAsync::IAssetRequest>>
+CesiumTileBundleAssetAccessor::get(
+    const CesiumAsync::AsyncSystem& asyncSystem,
+    const std::string& url,
+    const std::vector<CesiumAsync::IAssetAccessor::THeader>& headers) {
+  std::shared_ptr<CesiumAsync::IAssetRequest> pRequest =
+      this->findRequest(url);
+  if (pRequest) {
+    return asyncSystem.createResolvedFuture(std::move(pRequest));
+  }
+
+  return this->_pFallback->get(asyncSystem, url, headers);
+}
+
+CesiumAsync::Future<std::shared_ptr<CesiumAsync::IAssetRequest>>
+CesiumTileBundleAssetAccessor::request(
+    const CesiumAsync::AsyncSystem& asyncSystem,
+    const std::string& verb,
+    const std::string& url,
+    const std::vector<CesiumAsync::IAssetAccessor::THeader>& headers,
+    const gsl::span<const std::byte>& contentPayload) {
+  if (verb == "GET") {
+    std::shared_ptr<CesiumAsync::IAssetRequest> pRequest =
+        this->findRequest(url);
+    if (pRequest) {
+      return asyncSystem.createResolvedFuture(std::move(pRequest));
+    }
+  }
+
+  return this->_pFallback
+      ->request(asyncSystem, verb, url, headers, contentPayload);
+}
+
+void CesiumTileBundleAssetAccessor::tick() noexcept {
+  this->_pFallback->tick();
+}
+
+std::shared_ptr<CesiumAsync::IAssetRequest>
+CesiumTileBundleAssetAccessor::findRequest(const std::string& url) const {
+  const size_t queryStart = url.find('?');
+
+  for (const std::shared_ptr<CesiumTileBundle>& pBundle : this->_bundles) {
+    gsl::span<const std::byte> data;
+    const std::string* pContentType = nullptr;
+    if (pBundle->find(url, data, pContentType) ||
+        (queryStart != std::string::npos &&
+         pBundle->find(url.substr(0, queryStart), data, pContentType))) {
+      return std::make_shared<BundleAssetRequest>(
+          pBundle,
+          url,
+          *pContentType,
+          data);
+    }
+  }
+
+  return nullptr;
+}
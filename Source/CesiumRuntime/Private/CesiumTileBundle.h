@@ -0,0 +1,127 @@
+// Copyright 2020-2021 CesiumGS, Inc. and Contributors
+
+#pragma once
+
+#include "CesiumAsync/AsyncSystem.h"
+#include "CesiumAsync/IAssetAccessor.h"
+#include "Containers/UnrealString.h"
+#include <cstddef>
+#include <gsl/span>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class IMappedFileHandle;
+class IMappedFileRegion;
+
+/**
+ * @brief A read-only archive of responses, by URL, that is memory-mapped so
+ * that its responses can be served without any copies.
+ *
+ * A bundle starts with a header of the magic "CTB1", a uint32 version (1)
+ * and a uint32 number of entries. Each entry follows, as a uint32 URL
+ * length, a uint32 content type length, a uint64 offset and a uint64 size of
+ * its data from the start of the file, then the URL and content type in
+ * UTF-8. The data of the entries follows the index. All integers are
+ * little-endian.
+ */
+class CesiumTileBundle {
+public:
+  /**
+   * @brief An entry to write to a bundle.
+   */
+  struct EntryToWrite {
+    std::string url;
+    std::string contentType;
+    gsl::span<const std::byte> data;
+  };
+
+  /**
+   * @brief Opens a bundle, and reads its index.
+   *
+   * @param path The path of the bundle file.
+   * @return The bundle, or nullptr if it couldn't be opened or isn't valid.
+   */
+  static std::shared_ptr<CesiumTileBundle> open(const FString& path);
+
+  /**
+   * @brief Writes the given entries to a new bundle file.
+   *
+   * @return Whether the file was written.
+   */
+  static bool
+  write(const FString& path, const std::vector<EntryToWrite>& entries);
+
+  ~CesiumTileBundle();
+
+  /**
+   * @brief Finds the data and content type of the response for a URL, or
+   * returns false if the bundle doesn't have it.
+   */
+  bool find(
+      const std::string& url,
+      gsl::span<const std::byte>& data,
+      const std::string*& pContentType) const;
+
+private:
+  struct Entry {
+    uint64_t offset;
+    uint64_t size;
+    std::string contentType;
+  };
+
+  CesiumTileBundle() = default;
+
+  bool readIndex();
+
+  // The file is mapped when the platform supports it, and read into memory
+  // otherwise.
+  IMappedFileHandle* _pMappedFile = nullptr;
+  IMappedFileRegion* _pMappedRegion = nullptr;
+  TArray64<uint8> _loadedFile;
+
+  const std::byte* _pData = nullptr;
+  uint64_t _size = 0;
+
+  std::unordered_map<std::string, Entry> _entries;
+};
+
+/**
+ * @brief An asset accessor that serves GET requests for the URLs in a set of
+ * tile bundles straight from the bundles, and passes all other requests to
+ * another asset accessor.
+ *
+ * A URL that is not in a bundle is looked up again without its query string,
+ * so that bundles don't depend on access tokens and other parameters that
+ * change between sessions.
+ */
+class CesiumTileBundleAssetAccessor : public CesiumAsync::IAssetAccessor {
+public:
+  CesiumTileBundleAssetAccessor(
+      std::vector<std::shared_ptr<CesiumTileBundle>>&& bundles,
+      const std::shared_ptr<CesiumAsync::IAssetAccessor>& pFallback);
+
+  virtual CesiumAsync::Future<std::shared_ptr<CesiumAsync::IAssetRequest>>
+  get(const CesiumAsync::AsyncSystem& asyncSystem,
+      const std::string& url,
+      const std::vector<CesiumAsync::IAssetAccessor::THeader>& headers)
+      override;
+
+  virtual CesiumAsync::Future<std::shared_ptr<CesiumAsync::IAssetRequest>>
+  request(
+      const CesiumAsync::AsyncSystem& asyncSystem,
+      const std::string& verb,
+      const std::string& url,
+      const std::vector<CesiumAsync::IAssetAccessor::THeader>& headers,
+      const gsl::span<const std::byte>& contentPayload) override;
+
+  virtual void tick() noexcept override;
+
+private:
+  std::shared_ptr<CesiumAsync::IAssetRequest>
+  findRequest(const std::string& url) const;
+
+  std::vector<std::shared_ptr<CesiumTileBundle>> _bundles;
+  std::shared_ptr<CesiumAsync::IAssetAccessor> _pFallback;
+};
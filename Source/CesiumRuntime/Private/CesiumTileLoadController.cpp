@@ -0,0 +1,88 @@
+// Copyright 2020-2021 CesiumGS, Inc. and Contributors
+
+#include "CesiumTileLoadController.h"
+#include "HAL/PlatformMisc.h"
+#include "HAL/PlatformTime.h"
+#include <algorithm>
+
+namespace {
+// How often, in seconds, the limit is adjusted. Shorter intervals contain too
+// few finished requests to measure the latency reliably.
+constexpr double UpdateInterval = 0.5;
+
+// The fraction of the load thread time above which the load threads are
+// considered saturated.
+constexpr double LoadThreadSaturation = 0.85;
+
+// How much the latency may rise above the baseline before the network is
+// considered congested.
+constexpr double CongestedLatencyFactor = 2.0;
+
+// How quickly the baseline latency follows the measured latency upwards, per
+// update, so that it adapts when the network gets slower for good.
+constexpr double BaselineDrift = 1.02;
+} // namespace
+
+void CesiumTileLoadController::update(
+    int32 minimum,
+    int32 maximum,
+    int32 pendingLoads) {
+  minimum = std::max(minimum, 1);
+  maximum = std::max(maximum, minimum);
+
+  const double now = FPlatformTime::Seconds();
+  if (this->_lastUpdateTime < 0.0) {
+    this->_lastTotals = CesiumRuntimeStats::getLoadTotals();
+    this->_lastUpdateTime = now;
+    this->_limit = 0.5 * double(minimum + maximum);
+    return;
+  }
+
+  this->_limit = std::clamp(this->_limit, double(minimum), double(maximum));
+
+  const double interval = now - this->_lastUpdateTime;
+  if (interval < UpdateInterval) {
+    return;
+  }
+
+  const CesiumRuntimeStats::LoadTotals totals =
+      CesiumRuntimeStats::getLoadTotals();
+  const int64 completed =
+      totals.requestsCompleted - this->_lastTotals.requestsCompleted;
+  const double loadThreadSeconds =
+      totals.loadThreadSeconds - this->_lastTotals.loadThreadSeconds;
+  const double requestSeconds =
+      totals.requestSeconds - this->_lastTotals.requestSeconds;
+  const double throughput =
+      double(totals.bytesDownloaded - this->_lastTotals.bytesDownloaded) /
+      interval;
+  this->_lastTotals = totals;
+  this->_lastUpdateTime = now;
+
+  const double loadThreads =
+      double(std::max(FPlatformMisc::NumberOfWorkerThreadsToSpawn(), 1));
+  const bool loadThreadsSaturated =
+      loadThreadSeconds > LoadThreadSaturation * loadThreads * interval;
+
+  bool congested = false;
+  if (completed > 0) {
+    const double latency = requestSeconds / double(completed);
+    this->_baselineLatency =
+        this->_baselineLatency > 0.0
+            ? std::min(latency, this->_baselineLatency * BaselineDrift)
+            : latency;
+    congested = latency > CongestedLatencyFactor * this->_baselineLatency &&
+                throughput <= this->_lastThroughput * 1.05;
+    this->_lastThroughput = throughput;
+  }
+
+  if (loadThreadsSaturated) {
+    this->_limit *= 0.75;
+  } else if (congested) {
+    this->_limit *= 0.85;
+  } else if (pendingLoads > 0) {
+    this->_limit += std::max(1.0, this->_limit / 8.0);
+  }
+
+  this->_limit = std::clamp(this->_limit, double(minimum), double(maximum));
+}
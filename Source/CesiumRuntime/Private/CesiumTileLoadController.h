@@ -0,0 +1,46 @@
+// Copyright 2020-2021 CesiumGS, Inc. and Contributors
+
+#pragma once
+
+#include "CesiumRuntimeStats.h"
+#include "CoreMinimal.h"
+
+/**
+ * @brief Adapts the number of simultaneous tile loads of a tileset to the
+ * network and CPU that are actually available.
+ *
+ * The request and load thread counters of CesiumRuntimeStats are sampled at
+ * a regular interval. The limit is lowered when the load threads are
+ * saturated, because more requests would only queue up more content to
+ * convert. It is also lowered when the request latency rises well above the
+ * lowest latency seen recently without a gain in throughput, because the
+ * network is then congested. Otherwise, it is raised whenever tiles are
+ * waiting for a free load slot.
+ *
+ * The counters are shared by all tilesets, so the tilesets in a world adapt to
+ * their combined load.
+ */
+class CesiumTileLoadController {
+public:
+  /**
+   * @brief Updates the limit from the measurements since the last update.
+   * Must be called once per frame from the game thread.
+   *
+   * @param minimum The smallest limit to use.
+   * @param maximum The largest limit to use.
+   * @param pendingLoads The number of tiles waiting for a free load slot.
+   */
+  void update(int32 minimum, int32 maximum, int32 pendingLoads);
+
+  /**
+   * @brief Gets the number of simultaneous tile loads to use.
+   */
+  int32 getLimit() const { return FMath::RoundToInt(this->_limit); }
+
+private:
+  CesiumRuntimeStats::LoadTotals _lastTotals;
+  double _lastUpdateTime = -1.0;
+  double _baselineLatency = 0.0;
+  double _lastThroughput = 0.0;
+  double _limit = 0.0;
+};
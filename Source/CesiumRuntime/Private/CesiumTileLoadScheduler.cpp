@@ -0,0 +1,153 @@
+// Copyright 2020-2021 CesiumGS, Inc. and Contributors
+
+#include "CesiumTileLoadScheduler.h"
+#include "Cesium3DTileset.h"
+#include "CesiumRuntimeSettings.h"
+#include <algorithm>
+
+namespace {
+
+// The weight of the geometry tiles that a tileset is waiting for. Every
+// tileset has some weight, so that it can start loading new tiles at once.
+double getGeometryLoadWeight(
+    const FCesiumTileLoadDemand& demand,
+    const UCesiumRuntimeSettings& settings) {
+  return 1.0 +
+         double(settings.VisibleTileLoadWeight) *
+             demand.TilesLoadingHighPriority +
+         double(settings.RefiningTileLoadWeight) *
+             demand.TilesLoadingMediumPriority +
+         double(settings.PreloadTileLoadWeight) *
+             demand.TilesLoadingLowPriority;
+}
+
+// The weight of the raster overlay tiles that a tileset is waiting for.
+double getRasterOverlayLoadWeight(
+    const FCesiumTileLoadDemand& demand,
+    const UCesiumRuntimeSettings& settings) {
+  if (demand.RasterOverlays <= 0) {
+    return 0.0;
+  }
+  return 1.0 + double(settings.RasterOverlayTileLoadWeight) *
+                   demand.TilesWaitingForRasterOverlays;
+}
+
+double getMemoryWeight(const FCesiumTileLoadDemand& demand) {
+  return 1.0 + demand.TilesRendered;
+}
+
+} // namespace
+
+void UCesiumTileLoadScheduler::ReportDemand(
+    const ACesium3DTileset* Tileset,
+    const FCesiumTileLoadDemand& Demand) {
+  TilesetEntry& entry = this->findOrAddEntry(Tileset);
+  entry.demand = Demand;
+  entry.lastUpdateFrame = GFrameCounter;
+}
+
+void UCesiumTileLoadScheduler::RemoveTileset(const ACesium3DTileset* Tileset) {
+  this->_tilesets.RemoveAllSwap([Tileset](const TilesetEntry& entry) {
+    return entry.pTileset.Get() == Tileset;
+  });
+}
+
+bool UCesiumTileLoadScheduler::GetAllocation(
+    const ACesium3DTileset* Tileset,
+    int32& OutMaximumSimultaneousTileLoads,
+    int32& OutMaximumSimultaneousRasterOverlayTileLoads,
+    int64& OutMaximumCachedBytes) {
+  const UCesiumRuntimeSettings* pSettings =
+      GetDefault<UCesiumRuntimeSettings>();
+  if (!pSettings->UseSharedTileLoadBudget) {
+    return false;
+  }
+
+  // A tileset that has not reported any demand yet still gets a share, so the
+  // allocations need to be recomputed when it is first seen.
+  if (!this->findEntry(Tileset)) {
+    this->findOrAddEntry(Tileset).lastUpdateFrame = GFrameCounter;
+    this->_allocationsValid = false;
+  }
+
+  if (!this->_allocationsValid || this->_allocationFrame != GFrameCounter) {
+    this->updateAllocations();
+    this->_allocationFrame = GFrameCounter;
+    this->_allocationsValid = true;
+  }
+
+  TilesetEntry* pEntry = this->findEntry(Tileset);
+  if (!pEntry) {
+    return false;
+  }
+
+  pEntry->lastUpdateFrame = GFrameCounter;
+
+  OutMaximumSimultaneousTileLoads = pEntry->maximumSimultaneousTileLoads;
+  OutMaximumSimultaneousRasterOverlayTileLoads =
+      pEntry->maximumSimultaneousRasterOverlayTileLoads;
+  OutMaximumCachedBytes = pEntry->maximumCachedBytes;
+  return true;
+}
+
+UCesiumTileLoadScheduler::TilesetEntry*
+UCesiumTileLoadScheduler::findEntry(const ACesium3DTileset* pTileset) {
+  return this->_tilesets.FindByPredicate(
+      [pTileset](const TilesetEntry& entry) {
+        return entry.pTileset.Get() == pTileset;
+      });
+}
+
+UCesiumTileLoadScheduler::TilesetEntry&
+UCesiumTileLoadScheduler::findOrAddEntry(const ACesium3DTileset* pTileset) {
+  TilesetEntry* pEntry = this->findEntry(pTileset);
+  if (pEntry) {
+    return *pEntry;
+  }
+
+  TilesetEntry& entry = this->_tilesets.AddDefaulted_GetRef();
+  entry.pTileset = pTileset;
+  return entry;
+}
+
+void UCesiumTileLoadScheduler::updateAllocations() {
+  // Tilesets that were destroyed, or that have stopped updating, no longer
+  // take part in the allocation.
+  uint64 currentFrame = GFrameCounter;
+  this->_tilesets.RemoveAllSwap([currentFrame](const TilesetEntry& entry) {
+    return !entry.pTileset.IsValid() ||
+           entry.lastUpdateFrame + 2 < currentFrame;
+  });
+
+  const UCesiumRuntimeSettings& settings =
+      *GetDefault<UCesiumRuntimeSettings>();
+
+  double totalLoadWeight = 0.0;
+  double totalMemoryWeight = 0.0;
+  for (const TilesetEntry& entry : this->_tilesets) {
+    totalLoadWeight += getGeometryLoadWeight(entry.demand, settings) +
+                       getRasterOverlayLoadWeight(entry.demand, settings);
+    totalMemoryWeight += getMemoryWeight(entry.demand);
+  }
+
+  double totalLoads = double(settings.SharedMaximumSimultaneousTileLoads);
+  double totalBytes = double(settings.SharedMaximumCachedBytes);
+
+  for (TilesetEntry& entry : this->_tilesets) {
+    double geometryLoads = totalLoads *
+                           getGeometryLoadWeight(entry.demand, settings) /
+                           totalLoadWeight;
+    entry.maximumSimultaneousTileLoads = std::max(1, int32(geometryLoads));
+
+    // The overlays of a tileset share its raster overlay loads evenly.
+    double overlayLoads = totalLoads *
+                          getRasterOverlayLoadWeight(entry.demand, settings) /
+                          totalLoadWeight;
+    int32 overlays = std::max(entry.demand.RasterOverlays, 1);
+    entry.maximumSimultaneousRasterOverlayTileLoads =
+        std::max(1, int32(overlayLoads / overlays));
+
+    entry.maximumCachedBytes = int64(
+        totalBytes * getMemoryWeight(entry.demand) / totalMemoryWeight);
+  }
+}
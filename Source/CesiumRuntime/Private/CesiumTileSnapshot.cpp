@@ -0,0 +1,179 @@
+// Copyright 2020-2021 CesiumGS, Inc. and Contributors
+
+#include "CesiumTileSnapshot.h"
+#include "CesiumRuntime.h"
+#include "CesiumUtility/Tracing.h"
+#include "HAL/FileManager.h"
+#include "Hash/CityHash.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/MemoryReader.h"
+#include "Templates/UniquePtr.h"
+
+namespace {
+constexpr uint32 ManifestMagic = 0x31535443; // "CTS1"
+constexpr uint32 ManifestVersion = 1;
+const TCHAR* ManifestName = TEXT("manifest.bin");
+const TCHAR* EntryExtension = TEXT(".bin");
+} // namespace
+
+CesiumTileSnapshot::CesiumTileSnapshot(const FString& directory)
+    : _directory(directory) {
+  IFileManager& fileManager = IFileManager::Get();
+  if (!fileManager.DirectoryExists(*this->_directory)) {
+    fileManager.MakeDirectory(*this->_directory, true);
+  }
+  this->readManifest();
+}
+
+/*static*/ FString
+CesiumTileSnapshot::getDirectory(const FString& name, const FString& source) {
+  const FTCHARToUTF8 utf8(*source);
+  const uint64 sourceHash = CityHash64(utf8.Get(), uint32(utf8.Length()));
+  return FPaths::Combine(
+      FPaths::ProjectSavedDir(),
+      TEXT("Cesium/Snapshots"),
+      FString::Printf(TEXT("%s-%016llx"), *name, sourceHash));
+}
+
+bool CesiumTileSnapshot::find(uint64 key, TArray<uint8>& data) const {
+  {
+    std::lock_guard<std::mutex> lock(this->_mutex);
+    if (this->_keys.find(key) == this->_keys.end()) {
+      return false;
+    }
+  }
+
+  CESIUM_TRACE("CesiumTileSnapshot::find");
+  return FFileHelper::LoadFileToArray(data, *this->getPath(key));
+}
+
+void CesiumTileSnapshot::add(uint64 key, const TArray<uint8>& data) {
+  CESIUM_TRACE("CesiumTileSnapshot::add");
+  if (!FFileHelper::SaveArrayToFile(data, *this->getPath(key))) {
+    UE_LOG(
+        LogCesium,
+        Warning,
+        TEXT("Could not write a converted model to the snapshot in %s"),
+        *this->_directory);
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(this->_mutex);
+  this->_keys.insert(key);
+}
+
+void CesiumTileSnapshot::save(const TSet<uint64>& keys) {
+  CESIUM_TRACE("CesiumTileSnapshot::save");
+
+  std::lock_guard<std::mutex> lock(this->_mutex);
+
+  TArray<uint64> savedKeys;
+  for (uint64 key : keys) {
+    if (this->_keys.find(key) != this->_keys.end()) {
+      savedKeys.Add(key);
+    }
+  }
+
+  TUniquePtr<FArchive> pArchive(
+      IFileManager::Get().CreateFileWriter(*this->getManifestPath()));
+  if (!pArchive) {
+    UE_LOG(
+        LogCesium,
+        Warning,
+        TEXT("Could not write the manifest of the snapshot in %s"),
+        *this->_directory);
+    return;
+  }
+
+  uint32 magic = ManifestMagic;
+  uint32 version = ManifestVersion;
+  uint32 count = uint32(savedKeys.Num());
+  *pArchive << magic;
+  *pArchive << version;
+  *pArchive << count;
+  for (uint64& key : savedKeys) {
+    *pArchive << key;
+  }
+  pArchive->Close();
+
+  // The models that aren't in the manifest would never be restored.
+  TArray<FString> files;
+  IFileManager& fileManager = IFileManager::Get();
+  fileManager.FindFiles(
+      files,
+      *FPaths::Combine(this->_directory, FString(TEXT("*")) + EntryExtension),
+      true,
+      false);
+  TSet<FString> savedFiles;
+  for (uint64 key : savedKeys) {
+    savedFiles.Add(FPaths::GetCleanFilename(this->getPath(key)));
+  }
+  for (const FString& file : files) {
+    if (file != ManifestName && !savedFiles.Contains(file)) {
+      fileManager.Delete(*FPaths::Combine(this->_directory, file));
+    }
+  }
+
+  this->_keys.clear();
+  this->_keys.insert(savedKeys.begin(), savedKeys.end());
+
+  UE_LOG(
+      LogCesium,
+      Display,
+      TEXT("Saved a snapshot of %d tiles in %s"),
+      savedKeys.Num(),
+      *this->_directory);
+}
+
+FString CesiumTileSnapshot::getPath(uint64 key) const {
+  return FPaths::Combine(
+      this->_directory,
+      FString::Printf(TEXT("%016llx%s"), key, EntryExtension));
+}
+
+FString CesiumTileSnapshot::getManifestPath() const {
+  return FPaths::Combine(this->_directory, ManifestName);
+}
+
+void CesiumTileSnapshot::readManifest() {
+  TArray<uint8> data;
+  if (!FFileHelper::LoadFileToArray(
+          data,
+          *this->getManifestPath(),
+          FILEREAD_Silent)) {
+    return;
+  }
+
+  FMemoryReader reader(data);
+  uint32 magic = 0;
+  uint32 version = 0;
+  uint32 count = 0;
+  reader << magic;
+  reader << version;
+  reader << count;
+  if (reader.IsError() || magic != ManifestMagic ||
+      version != ManifestVersion ||
+      int64(count) * sizeof(uint64) != reader.TotalSize() - reader.Tell()) {
+    UE_LOG(
+        LogCesium,
+        Warning,
+        TEXT("The snapshot manifest in %s is not valid, and is ignored"),
+        *this->_directory);
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(this->_mutex);
+  for (uint32 i = 0; i < count; ++i) {
+    uint64 key = 0;
+    reader << key;
+    this->_keys.insert(key);
+  }
+
+  UE_LOG(
+      LogCesium,
+      Display,
+      TEXT("Restoring up to %d tiles from the snapshot in %s"),
+      int32(count),
+      *this->_directory);
+}
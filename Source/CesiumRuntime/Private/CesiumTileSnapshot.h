@@ -0,0 +1,71 @@
+// Copyright 2020-2021 CesiumGS, Inc. and Contributors
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include <mutex>
+#include <unordered_set>
+
+/**
+ * @brief A snapshot on disk of the converted models of the tiles that a
+ * tileset showed when it was last played, so that they are restored instead
+ * of being converted again when it is played next.
+ *
+ * Each converted model is a file named after its key, as computed by
+ * CesiumConvertedModel::computeKey, in the directory of the snapshot. The
+ * directory also has a manifest of the keys of the snapshot, which starts
+ * with the magic "CTS1", a uint32 version (1) and a uint32 number of keys,
+ * followed by the uint64 keys. Only the models in the manifest are restored,
+ * along with the ones added since the snapshot was opened, so that models
+ * left behind by an interrupted session aren't trusted.
+ *
+ * The models are read and written by the load threads, so all of its
+ * functions may be called from any thread.
+ */
+class CesiumTileSnapshot {
+public:
+  /**
+   * @brief Opens the snapshot in the given directory, which is created if
+   * needed, and reads its manifest.
+   */
+  explicit CesiumTileSnapshot(const FString& directory);
+
+  /**
+   * @brief Gets the directory of the snapshot of a tileset, under
+   * Saved/Cesium/Snapshots.
+   *
+   * @param name The name of the tileset actor.
+   * @param source The URL or Cesium ion asset of the tileset, so that a
+   * tileset whose source changes doesn't restore the models of the old one.
+   */
+  static FString getDirectory(const FString& name, const FString& source);
+
+  /**
+   * @brief Reads the converted model with the given key, or returns false if
+   * the snapshot doesn't have it.
+   */
+  bool find(uint64 key, TArray<uint8>& data) const;
+
+  /**
+   * @brief Writes a converted model to the snapshot.
+   */
+  void add(uint64 key, const TArray<uint8>& data);
+
+  /**
+   * @brief Writes the manifest of the snapshot with the given keys, which are
+   * those of the tiles shown when the tileset stops playing, and deletes the
+   * other models in the directory.
+   */
+  void save(const TSet<uint64>& keys);
+
+private:
+  FString getPath(uint64 key) const;
+  FString getManifestPath() const;
+  void readManifest();
+
+  FString _directory;
+
+  // The keys of the models that can be restored.
+  mutable std::mutex _mutex;
+  std::unordered_set<uint64> _keys;
+};
@@ -0,0 +1,152 @@
+// Copyright 2020-2021 CesiumGS, Inc. and Contributors
+
+#include "CesiumTileTrace.h"
+#include "Cesium3DTilesSelection/Tile.h"
+#include "CoreGlobals.h"
+#include "Hash/CityHash.h"
+#include "HAL/PlatformTime.h"
+#include "ProfilingDebugging/CountersTrace.h"
+#include <atomic>
+
+#if UE_TRACE_ENABLED
+
+UE_TRACE_CHANNEL_DEFINE(CesiumChannel)
+
+UE_TRACE_EVENT_BEGIN(Cesium, TileStage)
+  UE_TRACE_EVENT_FIELD(uint64, Cycle)
+  UE_TRACE_EVENT_FIELD(uint64, Key)
+  UE_TRACE_EVENT_FIELD(uint8, Stage)
+UE_TRACE_EVENT_END()
+
+UE_TRACE_EVENT_BEGIN(Cesium, TileLink)
+  UE_TRACE_EVENT_FIELD(uint64, Cycle)
+  UE_TRACE_EVENT_FIELD(uint64, ModelKey)
+  UE_TRACE_EVENT_FIELD(uint64, TileKey)
+UE_TRACE_EVENT_END()
+
+TRACE_DECLARE_INT_COUNTER(
+    CesiumRequestsInFlight,
+    TEXT("Cesium/Requests In Flight"));
+TRACE_DECLARE_INT_COUNTER(
+    CesiumTilesInLoadThreads,
+    TEXT("Cesium/Tiles In Load Threads"));
+TRACE_DECLARE_INT_COUNTER(
+    CesiumTilesLoadingHigh,
+    TEXT("Cesium/Tiles Loading (High Priority)"));
+TRACE_DECLARE_INT_COUNTER(
+    CesiumTilesLoadingMedium,
+    TEXT("Cesium/Tiles Loading (Medium Priority)"));
+TRACE_DECLARE_INT_COUNTER(
+    CesiumTilesLoadingLow,
+    TEXT("Cesium/Tiles Loading (Low Priority)"));
+TRACE_DECLARE_INT_COUNTER(
+    CesiumPendingPrimitiveComponents,
+    TEXT("Cesium/Components With Pending Primitives"));
+
+namespace {
+std::atomic<int32> requestsInFlight{0};
+std::atomic<int32> tilesInLoadThreads{0};
+
+// The queue depths added by the tilesets in the current frame, which are
+// only accessed by the game thread.
+struct QueueDepths {
+  uint64 frame = ~uint64(0);
+  int32 loadingHighPriority = 0;
+  int32 loadingMediumPriority = 0;
+  int32 loadingLowPriority = 0;
+  int32 pendingPrimitiveComponents = 0;
+};
+
+QueueDepths queueDepths;
+} // namespace
+
+#endif
+
+bool CesiumTileTrace::isEnabled() {
+#if UE_TRACE_ENABLED
+  return UE_TRACE_CHANNELEXPR_IS_ENABLED(CesiumChannel);
+#else
+  return false;
+#endif
+}
+
+uint64
+CesiumTileTrace::getTileKey(const Cesium3DTilesSelection::Tile& tile) {
+  const std::string id =
+      Cesium3DTilesSelection::TileIdUtilities::createTileIdString(
+          tile.getTileID());
+  return CityHash64(id.data(), uint32(id.size()));
+}
+
+uint64 CesiumTileTrace::getRequestKey(const std::string& url) {
+  return CityHash64(url.data(), uint32(url.size()));
+}
+
+uint64 CesiumTileTrace::getModelKey(const CesiumGltf::Model& model) {
+  return uint64(reinterpret_cast<UPTRINT>(&model));
+}
+
+void CesiumTileTrace::recordStage(Stage stage, uint64 key) {
+#if UE_TRACE_ENABLED
+  switch (stage) {
+  case Stage::RequestStarted:
+    ++requestsInFlight;
+    break;
+  case Stage::ResponseReceived:
+    --requestsInFlight;
+    break;
+  case Stage::LoadThreadStarted:
+    ++tilesInLoadThreads;
+    break;
+  case Stage::LoadThreadFinished:
+    --tilesInLoadThreads;
+    break;
+  default:
+    break;
+  }
+
+  UE_TRACE_LOG(Cesium, TileStage, CesiumChannel)
+      << TileStage.Cycle(FPlatformTime::Cycles64()) << TileStage.Key(key)
+      << TileStage.Stage(uint8(stage));
+#endif
+}
+
+void CesiumTileTrace::recordLink(uint64 modelKey, uint64 tileKey) {
+#if UE_TRACE_ENABLED
+  UE_TRACE_LOG(Cesium, TileLink, CesiumChannel)
+      << TileLink.Cycle(FPlatformTime::Cycles64())
+      << TileLink.ModelKey(modelKey) << TileLink.TileKey(tileKey);
+#endif
+}
+
+void CesiumTileTrace::addQueueDepths(
+    int32 loadingHighPriority,
+    int32 loadingMediumPriority,
+    int32 loadingLowPriority,
+    int32 pendingPrimitiveComponents) {
+#if UE_TRACE_ENABLED
+  if (queueDepths.frame != GFrameCounter) {
+    if (queueDepths.frame != ~uint64(0)) {
+      TRACE_COUNTER_SET(CesiumRequestsInFlight, requestsInFlight.load());
+      TRACE_COUNTER_SET(CesiumTilesInLoadThreads, tilesInLoadThreads.load());
+      TRACE_COUNTER_SET(
+          CesiumTilesLoadingHigh,
+          queueDepths.loadingHighPriority);
+      TRACE_COUNTER_SET(
+          CesiumTilesLoadingMedium,
+          queueDepths.loadingMediumPriority);
+      TRACE_COUNTER_SET(CesiumTilesLoadingLow, queueDepths.loadingLowPriority);
+      TRACE_COUNTER_SET(
+          CesiumPendingPrimitiveComponents,
+          queueDepths.pendingPrimitiveComponents);
+    }
+    queueDepths = QueueDepths();
+    queueDepths.frame = GFrameCounter;
+  }
+
+  queueDepths.loadingHighPriority += loadingHighPriority;
+  queueDepths.loadingMediumPriority += loadingMediumPriority;
+  queueDepths.loadingLowPriority += loadingLowPriority;
+  queueDepths.pendingPrimitiveComponents += pendingPrimitiveComponents;
+#endif
+}
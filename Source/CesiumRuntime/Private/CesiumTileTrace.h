@@ -0,0 +1,100 @@
+// Copyright 2020-2021 CesiumGS, Inc. and Contributors
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Trace/Trace.h"
+#include <string>
+
+namespace Cesium3DTilesSelection {
+class Tile;
+}
+
+namespace CesiumGltf {
+struct Model;
+}
+
+#if UE_TRACE_ENABLED
+UE_TRACE_CHANNEL_EXTERN(CesiumChannel)
+#endif
+
+/**
+ * @brief Records the lifecycle of tiles on the Cesium channel of Unreal
+ * Insights, for example with `-trace=cpu,counters,cesium`.
+ *
+ * Each stage of a tile is a `Cesium.TileStage` event with the key of the
+ * tile, so that one tile can be followed from its request to its eviction,
+ * and the Insights counters under "Cesium" show the depth of the queue of
+ * each stage. Nothing is recorded while the channel is disabled.
+ *
+ * Tiles are keyed by a hash of their tile ID. For tiles identified by their
+ * content URL, the request events have the same key, because they are keyed
+ * by a hash of the URL. The load-thread events are keyed by the glTF model,
+ * since the tile isn't known in the load thread, and a `Cesium.TileLink`
+ * event links that key to the tile's once it reaches the main thread.
+ */
+namespace CesiumTileTrace {
+
+/**
+ * @brief A stage of the lifecycle of a tile.
+ */
+enum class Stage : uint8 {
+  RequestStarted,
+  ResponseReceived,
+  LoadThreadStarted,
+  LoadThreadFinished,
+  MainThreadStarted,
+  MainThreadFinished,
+  Shown,
+  Hidden,
+  Evicted
+};
+
+/**
+ * @brief Whether the Cesium channel is enabled, so that keys only need to
+ * be computed while something is recorded.
+ */
+bool isEnabled();
+
+/**
+ * @brief Gets the key of a tile, which is a hash of its tile ID.
+ */
+uint64 getTileKey(const Cesium3DTilesSelection::Tile& tile);
+
+/**
+ * @brief Gets the key of a request, which is a hash of its URL.
+ */
+uint64 getRequestKey(const std::string& url);
+
+/**
+ * @brief Gets the key of the load-thread stages of a tile, from the model of
+ * its content.
+ */
+uint64 getModelKey(const CesiumGltf::Model& model);
+
+/**
+ * @brief Records that the tile or request with the given key reached a
+ * stage. May be called from any thread.
+ */
+void recordStage(Stage stage, uint64 key);
+
+/**
+ * @brief Records that the load-thread stages with the given key belong to
+ * the tile with the given key. May be called from any thread.
+ */
+void recordLink(uint64 modelKey, uint64 tileKey);
+
+/**
+ * @brief Adds the queue depths of one tileset in this frame to the counters:
+ * the tiles waiting to be loaded by priority, and the glTF components whose
+ * primitives are still waiting to be created. The counters are set to the
+ * sums over all tilesets at the next frame. Must be called from the game
+ * thread.
+ */
+void addQueueDepths(
+    int32 loadingHighPriority,
+    int32 loadingMediumPriority,
+    int32 loadingLowPriority,
+    int32 pendingPrimitiveComponents);
+
+} // namespace CesiumTileTrace
@@ -0,0 +1,337 @@
+// Copyright 2020-2021 CesiumGS, Inc. and Contributors
+
+#include "CesiumTriangleBVH.h"
+#include "CesiumUtility/Tracing.h"
+#include <algorithm>
+
+namespace {
+
+// The most triangles in a leaf, which are tested one by one.
+constexpr int32 MaximumLeafTriangles = 4;
+
+// The most nodes waiting to be visited, which is more than the depth of any
+// hierarchy that is split at the median.
+constexpr int32 MaximumStackSize = 64;
+
+/**
+ * Finds the distance along a ray at which it enters a box, or returns false
+ * if it misses the box or enters it beyond maximumDistance.
+ */
+bool intersectBox(
+    const FVector& origin,
+    const FVector& inverseDirection,
+    const FVector& min,
+    const FVector& max,
+    float maximumDistance,
+    float& entry) {
+  double tMin = 0.0;
+  double tMax = maximumDistance;
+  for (int32 axis = 0; axis < 3; ++axis) {
+    double t0 = (min[axis] - origin[axis]) * inverseDirection[axis];
+    double t1 = (max[axis] - origin[axis]) * inverseDirection[axis];
+    if (t0 > t1) {
+      std::swap(t0, t1);
+    }
+    tMin = FMath::Max(tMin, t0);
+    tMax = FMath::Min(tMax, t1);
+    if (tMin > tMax) {
+      return false;
+    }
+  }
+  entry = float(tMin);
+  return true;
+}
+
+/**
+ * Intersects a ray with a triangle from either side with the Möller–Trumbore
+ * algorithm, giving the distance along the ray to the hit.
+ */
+bool intersectTriangle(
+    const FVector& origin,
+    const FVector& direction,
+    const FVector& v0,
+    const FVector& v1,
+    const FVector& v2,
+    float& distance) {
+  const FVector edge1 = v1 - v0;
+  const FVector edge2 = v2 - v0;
+  const FVector p = FVector::CrossProduct(direction, edge2);
+  const double determinant = FVector::DotProduct(edge1, p);
+  if (FMath::Abs(determinant) < 1e-12) {
+    return false;
+  }
+
+  const double inverseDeterminant = 1.0 / determinant;
+  const FVector s = origin - v0;
+  const double u = FVector::DotProduct(s, p) * inverseDeterminant;
+  if (u < 0.0 || u > 1.0) {
+    return false;
+  }
+
+  const FVector q = FVector::CrossProduct(s, edge1);
+  const double v = FVector::DotProduct(direction, q) * inverseDeterminant;
+  if (v < 0.0 || u + v > 1.0) {
+    return false;
+  }
+
+  distance = float(FVector::DotProduct(edge2, q) * inverseDeterminant);
+  return distance >= 0.0f;
+}
+
+/**
+ * Finds the squared distance from a point to the nearest point of a box, which
+ * is zero for a point inside it.
+ */
+double squaredDistanceToBox(
+    const FVector& point,
+    const FVector& min,
+    const FVector& max) {
+  double squaredDistance = 0.0;
+  for (int32 axis = 0; axis < 3; ++axis) {
+    const double d = FMath::Max3(
+        double(min[axis]) - point[axis],
+        0.0,
+        double(point[axis]) - max[axis]);
+    squaredDistance += d * d;
+  }
+  return squaredDistance;
+}
+
+} // namespace
+
+CesiumTriangleBVH::CesiumTriangleBVH(
+    TArray<Vector>&& positions,
+    TArray<uint32>&& indices)
+    : _positions(MoveTemp(positions)) {
+  CESIUM_TRACE("CesiumTriangleBVH::CesiumTriangleBVH");
+
+  // Triangles with an index out of range are left out.
+  const int32 numPositions = this->_positions.Num();
+  TArray<int32> triangles;
+  TArray<Vector> centroids;
+  triangles.Reserve(indices.Num() / 3);
+  centroids.SetNumUninitialized(indices.Num() / 3);
+  for (int32 i = 0; i < centroids.Num(); ++i) {
+    const uint32 i0 = indices[3 * i];
+    const uint32 i1 = indices[3 * i + 1];
+    const uint32 i2 = indices[3 * i + 2];
+    if (i0 >= uint32(numPositions) || i1 >= uint32(numPositions) ||
+        i2 >= uint32(numPositions)) {
+      continue;
+    }
+    centroids[i] = (this->_positions[i0] + this->_positions[i1] +
+                    this->_positions[i2]) /
+                   3.0f;
+    triangles.Add(i);
+  }
+
+  if (triangles.Num() == 0) {
+    this->_positions.Empty();
+    return;
+  }
+
+  this->_nodes.Reserve(2 * triangles.Num() / MaximumLeafTriangles + 1);
+  this->buildNode(indices, triangles, centroids, 0, triangles.Num());
+
+  // The triangles of each leaf are stored together.
+  this->_indices.SetNumUninitialized(3 * triangles.Num());
+  for (int32 i = 0; i < triangles.Num(); ++i) {
+    const int32 triangle = triangles[i];
+    this->_indices[3 * i] = indices[3 * triangle];
+    this->_indices[3 * i + 1] = indices[3 * triangle + 1];
+    this->_indices[3 * i + 2] = indices[3 * triangle + 2];
+  }
+}
+
+bool CesiumTriangleBVH::raycast(
+    const FVector& origin,
+    const FVector& direction,
+    float maximumDistance,
+    Hit& hit) const {
+  if (this->_nodes.Num() == 0) {
+    return false;
+  }
+
+  const FVector inverseDirection(
+      direction.X != 0.0f ? 1.0 / direction.X : BIG_NUMBER,
+      direction.Y != 0.0f ? 1.0 / direction.Y : BIG_NUMBER,
+      direction.Z != 0.0f ? 1.0 / direction.Z : BIG_NUMBER);
+
+  float nearest = maximumDistance;
+  int32 nearestTriangle = INDEX_NONE;
+
+  int32 stack[MaximumStackSize];
+  int32 stackSize = 0;
+  stack[stackSize++] = 0;
+  while (stackSize > 0) {
+    const Node& node = this->_nodes[stack[--stackSize]];
+    float entry;
+    if (!intersectBox(
+            origin,
+            inverseDirection,
+            FVector(node.min),
+            FVector(node.max),
+            nearest,
+            entry)) {
+      continue;
+    }
+
+    if (node.count == 0) {
+      const int32 first = int32(&node - this->_nodes.GetData()) + 1;
+      stack[stackSize++] = node.index;
+      stack[stackSize++] = first;
+      continue;
+    }
+
+    for (int32 i = node.index; i < node.index + node.count; ++i) {
+      float distance;
+      if (intersectTriangle(
+              origin,
+              direction,
+              FVector(this->_positions[this->_indices[3 * i]]),
+              FVector(this->_positions[this->_indices[3 * i + 1]]),
+              FVector(this->_positions[this->_indices[3 * i + 2]]),
+              distance) &&
+          distance <= nearest) {
+        nearest = distance;
+        nearestTriangle = i;
+      }
+    }
+  }
+
+  if (nearestTriangle == INDEX_NONE) {
+    return false;
+  }
+
+  const FVector v0(this->_positions[this->_indices[3 * nearestTriangle]]);
+  const FVector v1(this->_positions[this->_indices[3 * nearestTriangle + 1]]);
+  const FVector v2(this->_positions[this->_indices[3 * nearestTriangle + 2]]);
+  FVector normal = FVector::CrossProduct(v1 - v0, v2 - v0).GetSafeNormal();
+  if (FVector::DotProduct(normal, direction) > 0.0) {
+    normal = -normal;
+  }
+
+  hit.distance = nearest;
+  hit.normal = normal;
+  return true;
+}
+
+bool CesiumTriangleBVH::closestDistance(
+    const FVector& point,
+    float maximumDistance,
+    float& distance) const {
+  if (this->_nodes.Num() == 0) {
+    return false;
+  }
+
+  double nearestSquared = double(maximumDistance) * maximumDistance;
+  bool found = false;
+
+  int32 stack[MaximumStackSize];
+  int32 stackSize = 0;
+  stack[stackSize++] = 0;
+  while (stackSize > 0) {
+    const Node& node = this->_nodes[stack[--stackSize]];
+    if (squaredDistanceToBox(point, FVector(node.min), FVector(node.max)) >
+        nearestSquared) {
+      continue;
+    }
+
+    if (node.count == 0) {
+      const int32 first = int32(&node - this->_nodes.GetData()) + 1;
+      stack[stackSize++] = node.index;
+      stack[stackSize++] = first;
+      continue;
+    }
+
+    for (int32 i = node.index; i < node.index + node.count; ++i) {
+      const FVector closest = FMath::ClosestPointOnTriangleToPoint(
+          point,
+          FVector(this->_positions[this->_indices[3 * i]]),
+          FVector(this->_positions[this->_indices[3 * i + 1]]),
+          FVector(this->_positions[this->_indices[3 * i + 2]]));
+      const double squared = FVector::DistSquared(point, closest);
+      if (squared <= nearestSquared) {
+        nearestSquared = squared;
+        found = true;
+      }
+    }
+  }
+
+  if (found) {
+    distance = float(FMath::Sqrt(nearestSquared));
+  }
+  return found;
+}
+
+FBox CesiumTriangleBVH::getBounds() const {
+  if (this->_nodes.Num() == 0) {
+    return FBox(ForceInit);
+  }
+  return FBox(FVector(this->_nodes[0].min), FVector(this->_nodes[0].max));
+}
+
+int64 CesiumTriangleBVH::getSizeBytes() const {
+  return int64(sizeof(CesiumTriangleBVH)) +
+         this->_positions.GetAllocatedSize() +
+         this->_indices.GetAllocatedSize() + this->_nodes.GetAllocatedSize();
+}
+
+int32 CesiumTriangleBVH::buildNode(
+    const TArray<uint32>& indices,
+    TArray<int32>& triangles,
+    const TArray<Vector>& centroids,
+    int32 first,
+    int32 count) {
+  const int32 nodeIndex = this->_nodes.AddUninitialized();
+
+  Vector min(BIG_NUMBER);
+  Vector max(-BIG_NUMBER);
+  Vector centroidMin(BIG_NUMBER);
+  Vector centroidMax(-BIG_NUMBER);
+  for (int32 i = first; i < first + count; ++i) {
+    const int32 triangle = triangles[i];
+    for (int32 corner = 0; corner < 3; ++corner) {
+      const Vector& position = this->_positions[indices[3 * triangle + corner]];
+      min = min.ComponentMin(position);
+      max = max.ComponentMax(position);
+    }
+    centroidMin = centroidMin.ComponentMin(centroids[triangle]);
+    centroidMax = centroidMax.ComponentMax(centroids[triangle]);
+  }
+
+  this->_nodes[nodeIndex].min = min;
+  this->_nodes[nodeIndex].max = max;
+
+  if (count <= MaximumLeafTriangles) {
+    this->_nodes[nodeIndex].index = first;
+    this->_nodes[nodeIndex].count = count;
+    return nodeIndex;
+  }
+
+  // Split at the median centroid along the longest axis of the centroids, so
+  // that the depth of the hierarchy is logarithmic in the triangles.
+  const Vector extent = centroidMax - centroidMin;
+  const int32 axis = extent.X >= extent.Y && extent.X >= extent.Z ? 0
+                     : extent.Y >= extent.Z                       ? 1
+                                                                  : 2;
+  const int32 half = count / 2;
+  std::nth_element(
+      triangles.GetData() + first,
+      triangles.GetData() + first + half,
+      triangles.GetData() + first + count,
+      [&centroids, axis](int32 a, int32 b) {
+        return centroids[a][axis] < centroids[b][axis];
+      });
+
+  this->buildNode(indices, triangles, centroids, first, half);
+  const int32 second = this->buildNode(
+      indices,
+      triangles,
+      centroids,
+      first + half,
+      count - half);
+  this->_nodes[nodeIndex].index = second;
+  this->_nodes[nodeIndex].count = 0;
+  return nodeIndex;
+}
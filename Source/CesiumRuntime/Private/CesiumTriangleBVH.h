@@ -0,0 +1,116 @@
+// Copyright 2020-2021 CesiumGS, Inc. and Contributors
+
+#pragma once
+
+#include "Containers/Array.h"
+#include "Math/Box.h"
+#include "Math/Vector.h"
+
+/**
+ * @brief A bounding volume hierarchy over the triangles of a primitive, so
+ * that rays can be cast against its geometry without the physics engine.
+ *
+ * The hierarchy is built once, usually in a load thread, and never changes
+ * afterward, so it can be read from any number of threads at once. The
+ * positions are in the coordinates of the primitive, like its vertex buffer.
+ */
+class CesiumTriangleBVH {
+public:
+#if ENGINE_MAJOR_VERSION == 5
+  using Vector = FVector3f;
+#else
+  using Vector = FVector;
+#endif
+
+  /**
+   * @brief The nearest intersection of a ray with the triangles.
+   */
+  struct Hit {
+    // The distance along the ray to the hit, in units of its direction.
+    float distance = 0.0f;
+    // The unit normal of the triangle that was hit, facing the ray.
+    FVector normal = FVector::ZeroVector;
+  };
+
+  /**
+   * @brief Builds the hierarchy over the given triangles.
+   *
+   * @param positions The positions of the vertices.
+   * @param indices Three indices into positions for each triangle.
+   */
+  CesiumTriangleBVH(TArray<Vector>&& positions, TArray<uint32>&& indices);
+
+  /**
+   * @brief Finds the nearest triangle that the given ray hits, from either
+   * side.
+   *
+   * @param origin The start of the ray, in the coordinates of the primitive.
+   * @param direction The direction of the ray, which needs not be a unit
+   * vector.
+   * @param maximumDistance The length of the ray, in units of direction.
+   * @param hit Receives the nearest hit, if there is one.
+   * @return Whether the ray hits a triangle.
+   */
+  bool raycast(
+      const FVector& origin,
+      const FVector& direction,
+      float maximumDistance,
+      Hit& hit) const;
+
+  /**
+   * @brief Finds the distance from the given point to the nearest triangle.
+   *
+   * @param point The point, in the coordinates of the primitive.
+   * @param maximumDistance The farthest a triangle may be to be found.
+   * @param distance Receives the distance to the nearest triangle, if there
+   * is one within maximumDistance.
+   * @return Whether there is a triangle within maximumDistance.
+   */
+  bool closestDistance(
+      const FVector& point,
+      float maximumDistance,
+      float& distance) const;
+
+  /**
+   * @brief Gets the positions of the vertices.
+   */
+  const TArray<Vector>& getPositions() const { return this->_positions; }
+
+  /**
+   * @brief Gets the indices of the triangles, in the order of the hierarchy.
+   */
+  const TArray<uint32>& getIndices() const { return this->_indices; }
+
+  /**
+   * @brief Gets the bounds of the triangles, in the coordinates of the
+   * primitive.
+   */
+  FBox getBounds() const;
+
+  /**
+   * @brief Gets the approximate number of bytes used by the hierarchy.
+   */
+  int64 getSizeBytes() const;
+
+private:
+  struct Node {
+    Vector min;
+    Vector max;
+    // For a leaf, the index of its first triangle. Otherwise, the index of
+    // its second child, as its first one follows it.
+    int32 index;
+    // The number of triangles of a leaf, or zero for other nodes.
+    int32 count;
+  };
+
+  int32 buildNode(
+      const TArray<uint32>& indices,
+      TArray<int32>& triangles,
+      const TArray<Vector>& centroids,
+      int32 first,
+      int32 count);
+
+  TArray<Vector> _positions;
+  TArray<uint32> _indices;
+  TArray<Node> _nodes;
+};
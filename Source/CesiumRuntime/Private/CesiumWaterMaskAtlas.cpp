@@ -0,0 +1,182 @@
+// Copyright 2020-2021 CesiumGS, Inc. and Contributors
+
+#include "CesiumWaterMaskAtlas.h"
+#include "CesiumLifetime.h"
+#include "CesiumUtility/Tracing.h"
+#include "Engine/Texture2D.h"
+
+namespace {
+
+// The width and height of the atlas textures, and of their slots, which hold
+// a mask and its border.
+constexpr int32 PageSize = 2048;
+constexpr int32 SlotSize = CesiumWaterMaskAtlas::MaximumMaskSize + 2;
+constexpr int32 SlotsPerRow = PageSize / SlotSize;
+constexpr int32 SlotsPerPage = SlotsPerRow * SlotsPerRow;
+
+FTexturePlatformData* getPlatformData(UTexture2D* pTexture) {
+#if ENGINE_MAJOR_VERSION >= 5
+  return pTexture->GetPlatformData();
+#else
+  return pTexture->PlatformData;
+#endif
+}
+
+/**
+ * Copies a mask into a new buffer with a border of one texel around it that
+ * repeats its edges.
+ */
+uint8* createBorderedMask(const TArray<uint8>& pixels, int32 size) {
+  const int32 borderedSize = size + 2;
+  uint8* pBordered = new uint8[borderedSize * borderedSize];
+  for (int32 y = 0; y < borderedSize; ++y) {
+    const int32 sourceY = FMath::Clamp(y - 1, 0, size - 1);
+    const uint8* pSourceRow = pixels.GetData() + sourceY * size;
+    uint8* pRow = pBordered + y * borderedSize;
+    pRow[0] = pSourceRow[0];
+    FMemory::Memcpy(pRow + 1, pSourceRow, size);
+    pRow[borderedSize - 1] = pSourceRow[size - 1];
+  }
+  return pBordered;
+}
+
+} // namespace
+
+CesiumWaterMaskAtlas::~CesiumWaterMaskAtlas() { this->clear(); }
+
+CesiumWaterMaskAtlas::Allocation CesiumWaterMaskAtlas::add(
+    const void* pOwner,
+    const TArray<uint8>& pixels,
+    int32 size) {
+  CESIUM_TRACE("CesiumWaterMaskAtlas::add");
+
+  Allocation allocation;
+  if (size <= 0 || size > MaximumMaskSize || pixels.Num() != size * size) {
+    return allocation;
+  }
+
+  // Textures that were destroyed elsewhere are nulled out by the garbage
+  // collector.
+  this->_pages.RemoveAll([](const Page& page) { return !page.pTexture; });
+
+  Page* pPage = this->_pages.FindByPredicate(
+      [](const Page& page) { return page.used < SlotsPerPage; });
+  if (!pPage) {
+    pPage = this->createPage();
+    if (!pPage) {
+      return allocation;
+    }
+  }
+
+  const int32 slot = pPage->owners.Find(nullptr);
+  check(slot != INDEX_NONE);
+  pPage->owners[slot] = pOwner;
+  ++pPage->used;
+
+  const int32 slotX = (slot % SlotsPerRow) * SlotSize;
+  const int32 slotY = (slot / SlotsPerRow) * SlotSize;
+  const int32 borderedSize = size + 2;
+
+  // The region and the texels are deleted once the render thread has
+  // uploaded them.
+  FUpdateTextureRegion2D* pRegion = new FUpdateTextureRegion2D(
+      slotX,
+      slotY,
+      0,
+      0,
+      borderedSize,
+      borderedSize);
+  pPage->pTexture->UpdateTextureRegions(
+      0,
+      1,
+      pRegion,
+      uint32(borderedSize),
+      1,
+      createBorderedMask(pixels, size),
+      [](uint8* pData, const FUpdateTextureRegion2D* pRegions) {
+        delete[] pData;
+        delete pRegions;
+      });
+
+  allocation.pTexture = pPage->pTexture;
+  allocation.offsetX = double(slotX + 1) / double(PageSize);
+  allocation.offsetY = double(slotY + 1) / double(PageSize);
+  allocation.scale = double(size) / double(PageSize);
+  return allocation;
+}
+
+void CesiumWaterMaskAtlas::release(const void* pOwner) {
+  for (int32 i = this->_pages.Num() - 1; i >= 0; --i) {
+    Page& page = this->_pages[i];
+    for (const void*& pSlotOwner : page.owners) {
+      if (pSlotOwner == pOwner) {
+        pSlotOwner = nullptr;
+        --page.used;
+      }
+    }
+
+    if (page.used == 0) {
+      if (page.pTexture) {
+        CesiumLifetime::destroy(page.pTexture);
+      }
+      this->_pages.RemoveAtSwap(i);
+    }
+  }
+}
+
+void CesiumWaterMaskAtlas::clear() {
+  for (Page& page : this->_pages) {
+    if (page.pTexture) {
+      CesiumLifetime::destroy(page.pTexture);
+    }
+  }
+  this->_pages.Empty();
+}
+
+int64 CesiumWaterMaskAtlas::getTextureBytes() const {
+  return int64(this->_pages.Num()) * PageSize * PageSize;
+}
+
+CesiumWaterMaskAtlas::Page* CesiumWaterMaskAtlas::createPage() {
+  CESIUM_TRACE("CesiumWaterMaskAtlas::createPage");
+
+  UTexture2D* pTexture = UTexture2D::CreateTransient(PageSize, PageSize, PF_R8);
+  if (!pTexture) {
+    return nullptr;
+  }
+
+  // The pixels of a transient texture are not initialized.
+  FTexturePlatformData* pPlatformData = getPlatformData(pTexture);
+  if (pPlatformData && pPlatformData->Mips.Num() > 0) {
+    FByteBulkData& bulkData = pPlatformData->Mips[0].BulkData;
+    FMemory::Memzero(
+        bulkData.Lock(LOCK_READ_WRITE),
+        bulkData.GetBulkDataSize());
+    bulkData.Unlock();
+  }
+
+  pTexture->SetFlags(
+      RF_Transient | RF_DuplicateTransient | RF_TextExportTransient);
+  pTexture->AddressX = TextureAddress::TA_Clamp;
+  pTexture->AddressY = TextureAddress::TA_Clamp;
+  pTexture->Filter = TextureFilter::TF_Bilinear;
+  pTexture->SRGB = false;
+  pTexture->NeverStream = true;
+  pTexture->UpdateResource();
+
+  Page& page = this->_pages.AddDefaulted_GetRef();
+  page.pTexture = pTexture;
+  page.owners.Init(nullptr, SlotsPerPage);
+  return &page;
+}
+
+void CesiumWaterMaskAtlas::AddReferencedObjects(
+    FReferenceCollector& Collector) {
+  for (Page& page : this->_pages) {
+    Collector.AddReferencedObject(page.pTexture);
+  }
+}
+
+FString CesiumWaterMaskAtlas::GetReferencerName() const {
+  return TEXT("CesiumWaterMaskAtlas");
+}
@@ -0,0 +1,95 @@
+// Copyright 2020-2021 CesiumGS, Inc. and Contributors
+
+#pragma once
+
+#include "Containers/Array.h"
+#include "UObject/GCObject.h"
+
+class UTexture2D;
+
+/**
+ * @brief Packs the water masks of terrain tiles into the slots of a few large
+ * atlas textures, so that tiles with both land and water don't each need a
+ * texture of their own for their water mask.
+ *
+ * Each slot holds a mask of up to MaximumMaskSize texels square, surrounded
+ * by a border of one texel that repeats its edges, so that bilinear filtering
+ * doesn't blend in the masks of the neighboring slots. The atlas textures
+ * have no mips for the same reason. Pages are added as needed, and destroyed
+ * once their last slot is released. The atlas keeps its textures from being
+ * garbage collected.
+ */
+class CesiumWaterMaskAtlas : public FGCObject {
+public:
+  /**
+   * @brief The largest width and height of a water mask that fits in a slot.
+   * Quantized-mesh water masks are 256 texels square.
+   */
+  static constexpr int32 MaximumMaskSize = 256;
+
+  /**
+   * @brief A water mask in the atlas.
+   */
+  struct Allocation {
+    // The atlas texture that holds the mask.
+    UTexture2D* pTexture = nullptr;
+
+    // The texture coordinates of the origin of the mask in the atlas texture.
+    double offsetX = 0.0;
+    double offsetY = 0.0;
+
+    // The size of the mask in the texture coordinates of the atlas texture.
+    double scale = 1.0;
+  };
+
+  CesiumWaterMaskAtlas() = default;
+  ~CesiumWaterMaskAtlas();
+
+  CesiumWaterMaskAtlas(const CesiumWaterMaskAtlas&) = delete;
+  CesiumWaterMaskAtlas& operator=(const CesiumWaterMaskAtlas&) = delete;
+
+  /**
+   * @brief Copies a water mask into a free slot of the atlas. Must be called
+   * from the game thread.
+   *
+   * @param pOwner The object that the mask belongs to, which releases it with
+   * release.
+   * @param pixels The texels of the mask, one byte each, row by row.
+   * @param size The width and height of the mask, which must not be greater
+   * than MaximumMaskSize.
+   * @return The allocation, whose pTexture is nullptr if the mask could not be
+   * added.
+   */
+  Allocation add(const void* pOwner, const TArray<uint8>& pixels, int32 size);
+
+  /**
+   * @brief Frees the slots of all the masks that belong to the given object.
+   * Must be called from the game thread.
+   */
+  void release(const void* pOwner);
+
+  /**
+   * @brief Destroys all the atlas textures.
+   */
+  void clear();
+
+  /**
+   * @brief Gets the number of bytes used by the atlas textures on the GPU.
+   */
+  int64 getTextureBytes() const;
+
+  virtual void AddReferencedObjects(FReferenceCollector& Collector) override;
+  virtual FString GetReferencerName() const override;
+
+private:
+  struct Page {
+    UTexture2D* pTexture = nullptr;
+    // The owner of each slot, or nullptr if it is free.
+    TArray<const void*> owners;
+    int32 used = 0;
+  };
+
+  Page* createPage();
+
+  TArray<Page> _pages;
+};
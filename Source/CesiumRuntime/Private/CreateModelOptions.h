@@ -2,12 +2,62 @@
 
 #pragma once
 
+#include <atomic>
+
+namespace CesiumConversionBenchmark {
+struct Timings;
+}
+
 struct CreateModelOptions {
   const CesiumGltf::Model* pModel = nullptr;
   bool alwaysIncludeTangents = false;
+  bool highPrecisionVertexAttributes = false;
+  bool flatNormalsInMaterial = false;
+  bool optimizeMeshes = false;
+  bool mergePrimitives = false;
+  bool streamTextures = false;
+  // The largest width or height of the glTF textures, which larger ones are
+  // downscaled to, or zero for no limit.
+  int32 maximumTextureSize = 0;
+  // Whether to keep the texels of water masks for the water mask atlas rather
+  // than loading each one into a texture.
+  bool packWaterMasks = false;
+  // The feature metadata properties to store in a texture for the material.
+  TArray<FString> metadataTextureProperties;
+  // Whether to compute the bounds of each feature for the feature index.
+  bool buildFeatureIndex = false;
+  // Whether to build a bounding volume hierarchy over the triangles of each
+  // primitive, so that rays can be cast against it without physics.
+  bool buildGeometryQueries = false;
+  bool collisionOnly = false;
+  // Whether to draw quantized-mesh terrain tiles as heightfields, which are
+  // sampled into textures rather than converted into render data.
+  bool renderHeightfields = false;
+  bool deferPhysicsMeshes = false;
+  double collisionSimplificationError = 0.0;
+  // The maximum error, in meters, of the simplified geometry kept for the
+  // far-field proxy, or zero to keep none.
+  double farFieldSimplificationError = 0.0;
+  // Set when the model is no longer needed, so that the rest of its loading
+  // is skipped. The result is then empty.
+  const std::atomic<bool>* pCanceled = nullptr;
+  // A converted model written by CesiumConvertedModel::write for this model
+  // and these options, which is restored instead of converting the model. It
+  // is converted anyway if the data isn't valid.
+  const TArray<uint8>* pConvertedModel = nullptr;
+  // If not nullptr, receives the converted model once the model is converted,
+  // or nothing if it can't be written.
+  TArray<uint8>* pWrittenConvertedModel = nullptr;
+  // If not nullptr, receives the time spent in each stage of the conversion,
+  // when it is run by the Cesium.BenchmarkConversion command.
+  CesiumConversionBenchmark::Timings* pBenchmarkTimings = nullptr;
 #if PHYSICS_INTERFACE_PHYSX
   IPhysXCooking* pPhysXCooking = nullptr;
 #endif
+#if CESIUM_BUILD_NANITE
+  // The builder of Nanite resources, or nullptr to not build them.
+  INaniteBuilderModule* pNaniteBuilder = nullptr;
+#endif
 };
 
 struct CreateNodeOptions {
@@ -23,4 +73,8 @@ struct CreateMeshOptions {
 struct CreatePrimitiveOptions {
   const CreateMeshOptions* pMeshOptions = nullptr;
   const CesiumGltf::MeshPrimitive* pPrimitive = nullptr;
+
+  // The textures of the model, by index, which are shared by its primitives.
+  const std::vector<CesiumTextureUtility::LoadedTextureResult*>* pTextures =
+      nullptr;
 };
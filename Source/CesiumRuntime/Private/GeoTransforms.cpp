@@ -9,11 +9,58 @@
 // ONLY used for logging!
 #include "CesiumRuntime.h"
 
+#include "Async/ParallelFor.h"
 #include "GeoTransforms.h"
+#include <algorithm>
+#include <cassert>
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_inverse.hpp>
 #include <glm/gtx/quaternion.hpp>
 
+namespace {
+// Batches of up to this many points are transformed on the calling thread.
+// Larger ones are split into tasks of this many points.
+constexpr size_t PointsPerTask = 4096;
+
+/**
+ * Calls transformRange(begin, end) for ranges of points that together cover
+ * all count points, in parallel if there are enough of them.
+ */
+template <typename TransformRange>
+void forEachPointRange(size_t count, const TransformRange& transformRange) {
+  if (count <= PointsPerTask) {
+    transformRange(size_t(0), count);
+    return;
+  }
+
+  const int32 taskCount = int32((count + PointsPerTask - 1) / PointsPerTask);
+  ParallelFor(taskCount, [count, &transformRange](int32 task) {
+    const size_t begin = size_t(task) * PointsPerTask;
+    transformRange(begin, std::min(count, begin + PointsPerTask));
+  });
+}
+
+/**
+ * Applies an affine transform, given as its rotation and translation, to
+ * each of the input points. The points don't depend on each other, so the
+ * loop can be vectorized by the compiler.
+ */
+void transformPoints(
+    const glm::dmat3& rotation,
+    const glm::dvec3& translation,
+    gsl::span<const glm::dvec3> input,
+    gsl::span<glm::dvec3> output) {
+  assert(input.size() == output.size());
+  forEachPointRange(
+      std::min(input.size(), output.size()),
+      [&rotation, &translation, input, output](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+          output[i] = rotation * input[i] + translation;
+        }
+      });
+}
+} // namespace
+
 void GeoTransforms::setCenter(const glm::dvec3& center) noexcept {
   if (this->_center != center) {
     this->_center = center;
@@ -50,6 +97,16 @@ glm::dquat GeoTransforms::ComputeSurfaceNormalRotationUnreal(
   return glm::rotation(oldEllipsoidNormalUnreal, newEllipsoidNormalUnreal);
 }
 
+glm::dquat GeoTransforms::ComputeSurfaceNormalRotationUnreal(
+    const EastNorthUpFrame& oldFrame,
+    const glm::dvec3& newPosition) const {
+  const glm::dmat3 ecefToUnreal =
+      glm::dmat3(this->GetEllipsoidCenteredToAbsoluteUnrealWorldTransform());
+  const glm::dvec3 newEllipsoidNormalUnreal = glm::normalize(
+      ecefToUnreal * this->ComputeGeodeticSurfaceNormal(newPosition));
+  return glm::rotation(oldFrame.surfaceNormalUnreal, newEllipsoidNormalUnreal);
+}
+
 void GeoTransforms::updateTransforms() noexcept {
   this->_georeferencedToEcef =
       CesiumGeospatial::Transforms::eastNorthUpToFixedFrame(
@@ -173,3 +230,122 @@ GeoTransforms::ComputeEastNorthUpToEcef(const glm::dvec3& ecef) const noexcept {
   return glm::dmat3(
       CesiumGeospatial::Transforms::eastNorthUpToFixedFrame(ecef, _ellipsoid));
 }
+
+GeoTransforms::EastNorthUpFrame GeoTransforms::ComputeEastNorthUpFrame(
+    const glm::dvec3& origin,
+    const glm::dvec3& ue) const noexcept {
+  EastNorthUpFrame frame;
+  frame.ecef = this->TransformUnrealToEcef(origin, ue);
+  frame.eastNorthUpToUnreal = this->ComputeEastNorthUpToUnreal(origin, ue);
+  frame.eastNorthUpToUnrealRotation = glm::quat_cast(frame.eastNorthUpToUnreal);
+  frame.unrealToEastNorthUpRotation =
+      glm::quat_cast(glm::affineInverse(frame.eastNorthUpToUnreal));
+  frame.surfaceNormalUnreal = glm::normalize(
+      glm::dmat3(this->_ecefToUeAbs) *
+      this->ComputeGeodeticSurfaceNormal(frame.ecef));
+  return frame;
+}
+
+glm::dquat GeoTransforms::TransformRotatorUnrealToEastNorthUp(
+    const EastNorthUpFrame& frame,
+    const glm::dquat& UERotator) const noexcept {
+  return frame.eastNorthUpToUnrealRotation * UERotator;
+}
+
+glm::dquat GeoTransforms::TransformRotatorEastNorthUpToUnreal(
+    const EastNorthUpFrame& frame,
+    const glm::dquat& ENURotator) const noexcept {
+  return frame.unrealToEastNorthUpRotation * ENURotator;
+}
+
+void GeoTransforms::TransformLongitudeLatitudeHeightToEcef(
+    gsl::span<const glm::dvec3> longitudeLatitudeHeights,
+    gsl::span<glm::dvec3> ecefs) const noexcept {
+  assert(longitudeLatitudeHeights.size() == ecefs.size());
+  forEachPointRange(
+      std::min(longitudeLatitudeHeights.size(), ecefs.size()),
+      [this, longitudeLatitudeHeights, ecefs](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+          ecefs[i] = this->TransformLongitudeLatitudeHeightToEcef(
+              longitudeLatitudeHeights[i]);
+        }
+      });
+}
+
+void GeoTransforms::TransformEcefToLongitudeLatitudeHeight(
+    gsl::span<const glm::dvec3> ecefs,
+    gsl::span<glm::dvec3> longitudeLatitudeHeights) const noexcept {
+  assert(ecefs.size() == longitudeLatitudeHeights.size());
+  forEachPointRange(
+      std::min(ecefs.size(), longitudeLatitudeHeights.size()),
+      [this, ecefs, longitudeLatitudeHeights](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+          longitudeLatitudeHeights[i] =
+              this->TransformEcefToLongitudeLatitudeHeight(ecefs[i]);
+        }
+      });
+}
+
+void GeoTransforms::TransformLongitudeLatitudeHeightToUnreal(
+    const glm::dvec3& origin,
+    gsl::span<const glm::dvec3> longitudeLatitudeHeights,
+    gsl::span<glm::dvec3> ues) const noexcept {
+  assert(longitudeLatitudeHeights.size() == ues.size());
+  const glm::dmat3 rotation(this->_ecefToUeAbs);
+  const glm::dvec3 translation = glm::dvec3(this->_ecefToUeAbs[3]) - origin;
+  forEachPointRange(
+      std::min(longitudeLatitudeHeights.size(), ues.size()),
+      [this, &rotation, &translation, longitudeLatitudeHeights, ues](
+          size_t begin,
+          size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+          ues[i] = rotation * this->TransformLongitudeLatitudeHeightToEcef(
+                                  longitudeLatitudeHeights[i]) +
+                   translation;
+        }
+      });
+}
+
+void GeoTransforms::TransformUnrealToLongitudeLatitudeHeight(
+    const glm::dvec3& origin,
+    gsl::span<const glm::dvec3> ues,
+    gsl::span<glm::dvec3> longitudeLatitudeHeights) const noexcept {
+  assert(ues.size() == longitudeLatitudeHeights.size());
+  const glm::dmat3 rotation(this->_ueAbsToEcef);
+  const glm::dvec3 translation =
+      glm::dvec3(this->_ueAbsToEcef[3]) + rotation * origin;
+  forEachPointRange(
+      std::min(ues.size(), longitudeLatitudeHeights.size()),
+      [this, &rotation, &translation, ues, longitudeLatitudeHeights](
+          size_t begin,
+          size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+          longitudeLatitudeHeights[i] =
+              this->TransformEcefToLongitudeLatitudeHeight(
+                  rotation * ues[i] + translation);
+        }
+      });
+}
+
+void GeoTransforms::TransformEcefToUnreal(
+    const glm::dvec3& origin,
+    gsl::span<const glm::dvec3> ecefs,
+    gsl::span<glm::dvec3> ues) const noexcept {
+  transformPoints(
+      glm::dmat3(this->_ecefToUeAbs),
+      glm::dvec3(this->_ecefToUeAbs[3]) - origin,
+      ecefs,
+      ues);
+}
+
+void GeoTransforms::TransformUnrealToEcef(
+    const glm::dvec3& origin,
+    gsl::span<const glm::dvec3> ues,
+    gsl::span<glm::dvec3> ecefs) const noexcept {
+  const glm::dmat3 rotation(this->_ueAbsToEcef);
+  transformPoints(
+      rotation,
+      glm::dvec3(this->_ueAbsToEcef[3]) + rotation * origin,
+      ues,
+      ecefs);
+}
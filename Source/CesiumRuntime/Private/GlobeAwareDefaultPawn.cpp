@@ -2,7 +2,12 @@
 
 #include "GlobeAwareDefaultPawn.h"
 #include "Camera/CameraComponent.h"
+#include "Camera/PlayerCameraManager.h"
+#include "Cesium3DTilesSelection/Tileset.h"
+#include "Cesium3DTileset.h"
 #include "CesiumActors.h"
+#include "CesiumCamera.h"
+#include "CesiumCameraManager.h"
 #include "CesiumCustomVersion.h"
 #include "CesiumGeoreference.h"
 #include "CesiumGeospatial/Ellipsoid.h"
@@ -13,6 +18,7 @@
 #include "CesiumUtility/Math.h"
 #include "DrawDebugHelpers.h"
 #include "Engine/World.h"
+#include "EngineUtils.h"
 #include "GameFramework/PlayerController.h"
 #include "VecMath.h"
 #include <glm/ext/matrix_transform.hpp>
@@ -91,6 +97,10 @@ void AGlobeAwareDefaultPawn::FlyToLocationECEF(
     return;
   }
 
+  this->_bHoldingFlight = false;
+  this->_bFlightHoldFinished = false;
+  this->_flightHoldTime = 0.0;
+
   PitchAtDestination = glm::clamp(PitchAtDestination, -89.99f, 89.99f);
   // Compute source location in ECEF
   glm::dvec3 ECEFSource = this->GlobeAnchor->GetECEF();
@@ -184,6 +194,8 @@ void AGlobeAwareDefaultPawn::FlyToLocationECEF(
   // Tell the tick we will be flying from now
   this->_bFlyingToLocation = true;
   this->_bCanInterruptFlight = CanInterruptByMoving;
+
+  this->_updateFlightCameras(0.0);
 }
 
 void AGlobeAwareDefaultPawn::InaccurateFlyToLocationECEF(
@@ -262,9 +274,39 @@ void AGlobeAwareDefaultPawn::_handleFlightStep(float DeltaSeconds) {
   // double check that we don't have an empty list of keypoints
   if (this->_keypoints.size() == 0) {
     this->_bFlyingToLocation = false;
+    this->_removeFlightCameras();
     return;
   }
 
+  // Hold before the final approach until the tiles are loaded, or until the
+  // hold times out. The flight time does not advance while holding.
+  const double finalApproachTime =
+      this->FlyToDuration * static_cast<double>(this->FlyToFinalApproachStart);
+  if (this->FlyToHoldUntilLoaded && !this->_bFlightHoldFinished &&
+      this->_currentFlyTime >= finalApproachTime) {
+    if (!this->_bHoldingFlight) {
+      this->_bHoldingFlight = true;
+      this->_flightHoldTime = 0.0;
+      this->_currentFlyTime = finalApproachTime;
+      this->OnFlightHoldStarted.Broadcast();
+    } else {
+      this->_flightHoldTime += static_cast<double>(DeltaSeconds);
+      this->_currentFlyTime = finalApproachTime;
+    }
+
+    if (this->_flightHoldTime <
+            static_cast<double>(this->FlyToHoldTimeout) &&
+        !this->_areTilesetsLoaded()) {
+      this->_updateFlightCameras(this->_computeFlightPercentage(
+          this->_currentFlyTime / this->FlyToDuration));
+      return;
+    }
+
+    this->_bHoldingFlight = false;
+    this->_bFlightHoldFinished = true;
+    this->OnFlightHoldEnded.Broadcast();
+  }
+
   // If we reached the end, set actual destination location and orientation
   if (this->_currentFlyTime >= this->FlyToDuration) {
     const glm::dvec3& finalPoint = _keypoints.back();
@@ -272,45 +314,170 @@ void AGlobeAwareDefaultPawn::_handleFlightStep(float DeltaSeconds) {
     Controller->SetControlRotation(this->_flyToDestinationRotation.Rotator());
     this->_bFlyingToLocation = false;
     this->_currentFlyTime = 0.0;
+    this->_removeFlightCameras();
     return;
   }
 
   // We're currently in flight. Interpolate the position and orientation:
 
   double rawPercentage = this->_currentFlyTime / this->FlyToDuration;
+  double flyPercentage = this->_computeFlightPercentage(rawPercentage);
+
+  // Set Location
+  this->GlobeAnchor->MoveToECEF(
+      this->_computeFlightPositionECEF(flyPercentage));
+
+  // Interpolate rotation in the ESU frame. The local ESU ControlRotation will
+  // be transformed to the appropriate world rotation as we fly.
+  FQuat currentQuat = FQuat::Slerp(
+      this->_flyToSourceRotation,
+      this->_flyToDestinationRotation,
+      flyPercentage);
+  Controller->SetControlRotation(currentQuat.Rotator());
+
+  this->_updateFlightCameras(flyPercentage);
+}
 
+double
+AGlobeAwareDefaultPawn::_computeFlightPercentage(double rawPercentage) const {
   // In order to accelerate at start and slow down at end, we use a progress
   // profile curve
-  double flyPercentage = rawPercentage;
-  if (this->FlyToProgressCurve != NULL) {
-    flyPercentage = glm::clamp(
-        static_cast<double>(
-            this->FlyToProgressCurve->GetFloatValue(rawPercentage)),
-        0.0,
-        1.0);
+  if (this->FlyToProgressCurve == NULL) {
+    return rawPercentage;
   }
+  return glm::clamp(
+      static_cast<double>(
+          this->FlyToProgressCurve->GetFloatValue(rawPercentage)),
+      0.0,
+      1.0);
+}
 
+glm::dvec3
+AGlobeAwareDefaultPawn::_computeFlightPositionECEF(double flyPercentage) const {
   // Find the keypoint indexes corresponding to the current percentage
-  int lastIndex = glm::floor(flyPercentage * (this->_keypoints.size() - 1));
-  double segmentPercentage =
-      flyPercentage * (this->_keypoints.size() - 1) - lastIndex;
-  int nextIndex = lastIndex + 1;
+  const int lastKeypoint = int(this->_keypoints.size()) - 1;
+  int lastIndex = glm::min(
+      int(glm::floor(flyPercentage * lastKeypoint)),
+      glm::max(lastKeypoint - 1, 0));
+  double segmentPercentage = flyPercentage * lastKeypoint - lastIndex;
+  int nextIndex = glm::min(lastIndex + 1, lastKeypoint);
 
   // Get the current position by interpolating linearly between those two points
   const glm::dvec3& lastPosition = this->_keypoints[lastIndex];
   const glm::dvec3& nextPosition = this->_keypoints[nextIndex];
-  glm::dvec3 currentPosition =
-      glm::mix(lastPosition, nextPosition, segmentPercentage);
-  // Set Location
-  this->GlobeAnchor->MoveToECEF(currentPosition);
+  return glm::mix(lastPosition, nextPosition, segmentPercentage);
+}
 
-  // Interpolate rotation in the ESU frame. The local ESU ControlRotation will
-  // be transformed to the appropriate world rotation as we fly.
-  FQuat currentQuat = FQuat::Slerp(
+bool AGlobeAwareDefaultPawn::_computeFlightCamera(
+    double flyPercentage,
+    FCesiumCamera& camera) const {
+  const APlayerController* pPlayerController =
+      Cast<APlayerController>(this->Controller);
+  const ACesiumGeoreference* pGeoreference = this->GetGeoreference();
+  if (!pPlayerController || !IsValid(pGeoreference)) {
+    return false;
+  }
+
+  int32 sizeX, sizeY;
+  pPlayerController->GetViewportSize(sizeX, sizeY);
+  if (sizeX < 1 || sizeY < 1) {
+    return false;
+  }
+
+  float fieldOfView = 90.0f;
+  if (pPlayerController->PlayerCameraManager) {
+    fieldOfView = pPlayerController->PlayerCameraManager->GetFOVAngle();
+  }
+
+  const FVector location =
+      VecMath::createVector(pGeoreference->TransformEcefToUnreal(
+          this->_computeFlightPositionECEF(flyPercentage)));
+
+  // The flight rotations are expressed in East-South-Up coordinates, just
+  // like the control rotation in GetViewRotation.
+  const FQuat localRotation = FQuat::Slerp(
       this->_flyToSourceRotation,
       this->_flyToDestinationRotation,
       flyPercentage);
-  Controller->SetControlRotation(currentQuat.Rotator());
+  const FMatrix enuAdjustmentMatrix =
+      pGeoreference->InaccurateComputeEastNorthUpToUnreal(location);
+
+  camera = FCesiumCamera(
+      FVector2D(sizeX, sizeY),
+      location,
+      FRotator(enuAdjustmentMatrix.ToQuat() * localRotation),
+      fieldOfView);
+  return true;
+}
+
+bool AGlobeAwareDefaultPawn::_areTilesetsLoaded() const {
+  for (TActorIterator<ACesium3DTileset> it(this->GetWorld()); it; ++it) {
+    Cesium3DTilesSelection::Tileset* pTileset = it->GetTileset();
+    if (pTileset && pTileset->computeLoadProgress() < 100.0f) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void AGlobeAwareDefaultPawn::_updateFlightCameras(double flyPercentage) {
+  if (!this->FlyToPrefetch || !this->_bFlyingToLocation ||
+      !this->GetWorld()->IsGameWorld()) {
+    this->_removeFlightCameras();
+    return;
+  }
+
+  ACesiumCameraManager* pCameraManager =
+      this->_pFlightCameraManager.IsValid()
+          ? this->_pFlightCameraManager.Get()
+          : ACesiumCameraManager::GetDefaultCameraManager(this);
+  if (!pCameraManager) {
+    return;
+  }
+
+  // The cameras along the path are evenly spaced between the pawn and the
+  // destination, so they move ahead with the pawn. The last camera looks
+  // from the destination with full detail.
+  const int32 sampleCount = FMath::Max(this->FlyToPrefetchSampleCount, 0);
+  const size_t cameraCount = size_t(sampleCount) + 1;
+  if (this->_pFlightCameraManager.Get() != pCameraManager ||
+      this->_flightCameraIds.size() != cameraCount) {
+    this->_removeFlightCameras();
+    this->_pFlightCameraManager = pCameraManager;
+  }
+
+  for (int32 i = 0; i <= sampleCount; ++i) {
+    const double percentage =
+        i == sampleCount
+            ? 1.0
+            : flyPercentage + (1.0 - flyPercentage) * double(i + 1) /
+                                  double(sampleCount + 1);
+
+    FCesiumCamera camera;
+    if (!this->_computeFlightCamera(percentage, camera)) {
+      return;
+    }
+    if (i < sampleCount) {
+      camera.ScreenSpaceErrorScale = this->FlyToPrefetchScreenSpaceErrorScale;
+    }
+
+    if (size_t(i) < this->_flightCameraIds.size()) {
+      pCameraManager->UpdateCamera(this->_flightCameraIds[i], camera);
+    } else {
+      this->_flightCameraIds.push_back(pCameraManager->AddCamera(camera));
+    }
+  }
+}
+
+void AGlobeAwareDefaultPawn::_removeFlightCameras() {
+  ACesiumCameraManager* pCameraManager = this->_pFlightCameraManager.Get();
+  if (pCameraManager) {
+    for (int32 cameraId : this->_flightCameraIds) {
+      pCameraManager->RemoveCamera(cameraId);
+    }
+  }
+  this->_flightCameraIds.clear();
+  this->_pFlightCameraManager.Reset();
 }
 
 void AGlobeAwareDefaultPawn::Tick(float DeltaSeconds) {
@@ -319,6 +486,12 @@ void AGlobeAwareDefaultPawn::Tick(float DeltaSeconds) {
   _handleFlightStep(DeltaSeconds);
 }
 
+void AGlobeAwareDefaultPawn::EndPlay(
+    const EEndPlayReason::Type EndPlayReason) {
+  this->_removeFlightCameras();
+  Super::EndPlay(EndPlayReason);
+}
+
 void AGlobeAwareDefaultPawn::PostLoad() {
   Super::PostLoad();
 
@@ -380,6 +553,8 @@ void AGlobeAwareDefaultPawn::_interruptFlight() {
   }
 
   this->_bFlyingToLocation = false;
+  this->_bHoldingFlight = false;
+  this->_removeFlightCameras();
 
   // fix camera roll to 0.0
   FRotator currentRotator = Controller->GetControlRotation();
@@ -2,27 +2,118 @@
 
 #pragma once
 
+#if PHYSICS_INTERFACE_PHYSX
+using CesiumCollisionMesh = PxTriangleMesh*;
+#else
+using CesiumCollisionMesh =
+    TSharedPtr<Chaos::FTriangleMeshImplicitObject, ESPMode::ThreadSafe>;
+#endif
+
+struct CesiumFarFieldGeometry;
+class CesiumTriangleBVH;
+
+/**
+ * The geometry of a primitive's collision mesh, kept until the mesh is cooked
+ * when cooking is deferred.
+ */
+struct DeferredCollisionMesh {
+#if ENGINE_MAJOR_VERSION == 5
+  TArray<FVector3f> positions;
+#else
+  TArray<FVector> positions;
+#endif
+  TArray<uint32> indices;
+  FBox bounds;
+};
+
 struct LoadPrimitiveResult {
-  FCesiumMetadataPrimitive Metadata{};
   FStaticMeshRenderData* RenderData = nullptr;
   const CesiumGltf::Model* pModel = nullptr;
   const CesiumGltf::MeshPrimitive* pMeshPrimitive = nullptr;
   const CesiumGltf::Material* pMaterial = nullptr;
   glm::dmat4x4 transform{1.0};
-#if PHYSICS_INTERFACE_PHYSX
-  PxTriangleMesh* pCollisionMesh = nullptr;
-#else
-  TSharedPtr<Chaos::FTriangleMeshImplicitObject, ESPMode::ThreadSafe>
-      pCollisionMesh = nullptr;
-#endif
+  CesiumCollisionMesh pCollisionMesh = nullptr;
+
+  // The collision meshes of the primitives that were merged into this one.
+  std::vector<CesiumCollisionMesh> mergedCollisionMeshes{};
+
+  // The cooked form of pCollisionMesh and of each of mergedCollisionMeshes,
+  // if the converted model is written so that it can be restored without
+  // cooking them again. Otherwise, they are empty.
+  TArray<uint8> cookedCollisionMesh;
+  std::vector<TArray<uint8>> mergedCookedCollisionMeshes{};
+
+  // The geometry to cook into pCollisionMesh later, if cooking was deferred.
+  std::shared_ptr<DeferredCollisionMesh> pDeferredCollision = nullptr;
+
+  // The simplified geometry of this primitive for the far-field proxy, or
+  // nullptr if it is not kept.
+  std::shared_ptr<const CesiumFarFieldGeometry> pFarFieldGeometry = nullptr;
+
+  // The hierarchy over the full geometry of this primitive that rays are cast
+  // against by geometry queries, or nullptr if they are not enabled.
+  std::shared_ptr<const CesiumTriangleBVH> pQueryBVH = nullptr;
+
+  // The approximate size of pCollisionMesh, in bytes.
+  int64 collisionBytes = 0;
+
+  // The feature ID of each face of the collision mesh in the first feature
+  // table, or nothing if there is no feature table.
+  TArray<int32> faceFeatureIDs;
+
+  // The bounds of each feature in the first feature table, if the feature
+  // index is enabled.
+  TArray<CesiumPrimitiveFeatureBounds> featureBounds;
   std::string name{};
 
+  // True if this primitive has a collision mesh, but no render data,
+  // materials, or textures.
+  bool collisionOnly = false;
+
+  // True if this primitive is made of points, which are drawn as a point list
+  // from the vertex buffers, without indices or collision.
+  bool pointCloud = false;
+
+  // True if this primitive is a terrain tile that is drawn as a heightfield,
+  // from heightfieldPositionTexture and heightfieldNormalTexture, rather than
+  // from render data. See CesiumHeightfield.
+  bool heightfield = false;
+  CesiumTextureUtility::LoadedTextureResult* heightfieldPositionTexture =
+      nullptr;
+  CesiumTextureUtility::LoadedTextureResult* heightfieldNormalTexture =
+      nullptr;
+
+  // The bounds of the heightfield, in the coordinates of the primitive.
+  FBox heightfieldBounds{ForceInit};
+
+  // The transforms of the instances of this primitive, relative to its node,
+  // if the node is instanced with EXT_mesh_gpu_instancing. They are shared by
+  // the primitives of the node.
+  std::shared_ptr<const TArray<FTransform>> pInstanceTransforms = nullptr;
+
+  // True if this primitive has no normals and shares its vertices between
+  // triangles, so the material must compute flat normals.
+  bool flatNormalsInMaterial = false;
+
   CesiumTextureUtility::LoadedTextureResult* baseColorTexture = nullptr;
   CesiumTextureUtility::LoadedTextureResult* metallicRoughnessTexture = nullptr;
   CesiumTextureUtility::LoadedTextureResult* normalTexture = nullptr;
   CesiumTextureUtility::LoadedTextureResult* emissiveTexture = nullptr;
   CesiumTextureUtility::LoadedTextureResult* occlusionTexture = nullptr;
   CesiumTextureUtility::LoadedTextureResult* waterMaskTexture = nullptr;
+
+  // The texels of the water mask, when it is packed into the water mask atlas
+  // of the tileset instead of being loaded into waterMaskTexture, along with
+  // its width and height. Once it is packed, the atlas texture holding it.
+  TArray<uint8> waterMaskPixels;
+  int32 waterMaskSize = 0;
+  UTexture2D* pWaterMaskAtlasTexture = nullptr;
+
+  // The values of the feature metadata properties that are styled by the
+  // material, and the layout of the texture. It is owned by this primitive.
+  CesiumTextureUtility::LoadedTextureResult* featureMetadataTexture = nullptr;
+  int32 featureMetadataTextureWidth = 0;
+  int32 featureMetadataRowsPerProperty = 0;
   std::unordered_map<std::string, uint32_t> textureCoordinateParameters;
 
   bool onlyLand = true;
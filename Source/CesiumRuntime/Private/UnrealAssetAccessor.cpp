@@ -4,6 +4,10 @@
 #include "CesiumAsync/AsyncSystem.h"
 #include "CesiumAsync/IAssetRequest.h"
 #include "CesiumAsync/IAssetResponse.h"
+#include "CesiumRuntimeSettings.h"
+#include "CesiumRuntimeStats.h"
+#include "CesiumTileTrace.h"
+#include "HAL/PlatformTime.h"
 #include "HttpManager.h"
 #include "HttpModule.h"
 #include "Interfaces/IHttpRequest.h"
@@ -11,9 +15,22 @@
 #include "Interfaces/IPluginManager.h"
 #include "Misc/App.h"
 #include "Misc/EngineVersion.h"
+#include <algorithm>
 #include <cstddef>
+#include <deque>
+#include <mutex>
 #include <optional>
 #include <set>
+#include <unordered_map>
+
+static std::string toUtf8(const TCHAR* pText, int32 length) {
+  FTCHARToUTF8 converted(pText, length);
+  return std::string(converted.Get(), converted.Length());
+}
+
+static std::string toUtf8(const FString& text) {
+  return toUtf8(*text, text.Len());
+}
 
 static CesiumAsync::HttpHeaders
 parseHeaders(const TArray<FString>& unrealHeaders) {
@@ -21,32 +38,54 @@ parseHeaders(const TArray<FString>& unrealHeaders) {
   for (const FString& header : unrealHeaders) {
     int32_t separator = -1;
     if (header.FindChar(':', separator)) {
-      FString fstrKey = header.Left(separator);
-      FString fstrValue = header.Right(header.Len() - separator - 2);
-      std::string key = std::string(TCHAR_TO_UTF8(*fstrKey));
-      std::string value = std::string(TCHAR_TO_UTF8(*fstrValue));
-      result.insert({std::move(key), std::move(value)});
+      // Convert the key and value straight out of the header, rather than
+      // copying them into FStrings first.
+      int32_t valueStart = FMath::Min(separator + 2, header.Len());
+      result.insert(
+          {toUtf8(*header, separator),
+           toUtf8(*header + valueStart, header.Len() - valueStart)});
     }
   }
 
   return result;
 }
 
+static void setDelegateThreadPolicy(
+    IHttpRequest& request,
+    bool completeOnHttpThread) {
+#if ENGINE_MAJOR_VERSION >= 5
+  // The promise may be resolved from any thread, so there is no need to wait
+  // for the game thread to tick the HTTP manager before the response is
+  // processed.
+  if (completeOnHttpThread) {
+    request.SetDelegateThreadPolicy(
+        EHttpRequestDelegateThreadPolicy::CompleteOnHttpThread);
+  }
+#endif
+}
+
+// The headers, URL and method of requests are only converted to their
+// cesium-native representations the first time they are asked for, because
+// most of them never are. A response may be read by several threads when
+// identical requests are coalesced, so the conversions are guarded by
+// once_flags.
+
 class UnrealAssetResponse : public CesiumAsync::IAssetResponse {
 public:
-  UnrealAssetResponse(FHttpResponsePtr pResponse)
-      : _pResponse(pResponse),
-        _headers(parseHeaders(pResponse->GetAllHeaders())) {}
+  UnrealAssetResponse(FHttpResponsePtr pResponse) : _pResponse(pResponse) {}
 
   virtual uint16_t statusCode() const override {
     return this->_pResponse->GetResponseCode();
   }
 
   virtual std::string contentType() const override {
-    return TCHAR_TO_UTF8(*this->_pResponse->GetContentType());
+    return toUtf8(this->_pResponse->GetContentType());
   }
 
   virtual const CesiumAsync::HttpHeaders& headers() const override {
+    std::call_once(this->_headersParsed, [this]() {
+      this->_headers = parseHeaders(this->_pResponse->GetAllHeaders());
+    });
     return this->_headers;
   }
 
@@ -59,40 +98,490 @@ public:
 
 private:
   FHttpResponsePtr _pResponse;
-  CesiumAsync::HttpHeaders _headers;
+  mutable std::once_flag _headersParsed;
+  mutable CesiumAsync::HttpHeaders _headers;
 };
 
 class UnrealAssetRequest : public CesiumAsync::IAssetRequest {
 public:
   UnrealAssetRequest(FHttpRequestPtr pRequest, FHttpResponsePtr pResponse)
-      : _pRequest(pRequest),
-        _pResponse(std::make_unique<UnrealAssetResponse>(pResponse)) {
-    this->_headers = parseHeaders(this->_pRequest->GetAllHeaders());
-    this->_url = TCHAR_TO_UTF8(*this->_pRequest->GetURL());
-    this->_method = TCHAR_TO_UTF8(*this->_pRequest->GetVerb());
-  }
+      : _pRequest(pRequest), _response(pResponse) {}
 
-  virtual const std::string& method() const { return this->_method; }
+  virtual const std::string& method() const {
+    std::call_once(this->_methodConverted, [this]() {
+      this->_method = toUtf8(this->_pRequest->GetVerb());
+    });
+    return this->_method;
+  }
 
-  virtual const std::string& url() const { return this->_url; }
+  virtual const std::string& url() const {
+    std::call_once(this->_urlConverted, [this]() {
+      this->_url = toUtf8(this->_pRequest->GetURL());
+    });
+    return this->_url;
+  }
 
   virtual const CesiumAsync::HttpHeaders& headers() const override {
-    return _headers;
+    std::call_once(this->_headersParsed, [this]() {
+      this->_headers = parseHeaders(this->_pRequest->GetAllHeaders());
+    });
+    return this->_headers;
   }
 
   virtual const CesiumAsync::IAssetResponse* response() const override {
-    return this->_pResponse.get();
+    return &this->_response;
   }
 
 private:
   FHttpRequestPtr _pRequest;
-  std::unique_ptr<UnrealAssetResponse> _pResponse;
-  std::string _url;
-  std::string _method;
-  CesiumAsync::HttpHeaders _headers;
+  UnrealAssetResponse _response;
+  mutable std::once_flag _urlConverted;
+  mutable std::string _url;
+  mutable std::once_flag _methodConverted;
+  mutable std::string _method;
+  mutable std::once_flag _headersParsed;
+  mutable CesiumAsync::HttpHeaders _headers;
+};
+
+namespace {
+using RequestPromise =
+    CesiumAsync::Promise<std::shared_ptr<CesiumAsync::IAssetRequest>>;
+
+/**
+ * A GET request that is in flight, along with the promises of all of the
+ * callers waiting for its response. Its HTTP requests and whether it was
+ * canceled are only accessed with the mutex of the registry locked, because
+ * they are changed by get and cancel while the requests complete on the HTTP
+ * threads.
+ */
+struct PendingRequest {
+  TSharedPtr<IHttpRequest, ESPMode::ThreadSafe> pRequest;
+  std::vector<RequestPromise> promises;
+  bool canceled = false;
+
+  // The scheme, host and port of the URL, which the limit on the requests
+  // in flight to each server applies to.
+  std::string host;
+
+  // Whether the request is waiting in the queue of the registry, rather than
+  // being in flight.
+  bool queued = false;
+
+  uint64 traceKey = 0;
+
+  // The URL and headers, for sending a hedged copy of the request.
+  std::string url;
+  std::vector<CesiumAsync::IAssetAccessor::THeader> headers;
+
+  // The FPlatformTime::Seconds when the request was sent.
+  double sentTime = 0.0;
+
+  // The number of HTTP requests in flight for this request, which is 2 while
+  // a hedged copy is in flight alongside the original.
+  int32 inFlight = 0;
+
+  // The hedged copy of the request, if one was sent, and whether it has been
+  // started. It may only be canceled once it has.
+  TSharedPtr<IHttpRequest, ESPMode::ThreadSafe> pHedge;
+  bool hedgeStarted = false;
+
+  // Whether the promises have been settled by one of the HTTP requests.
+  bool settled = false;
+};
+
+// The number of recent latencies that the hedging delay is computed from,
+// and the number that are needed before any request is hedged.
+constexpr size_t LatencySamples = 256;
+constexpr size_t MinimumLatencySamples = 32;
+
+/**
+ * Creates the HTTP request for a GET request, without sending it.
+ */
+TSharedRef<IHttpRequest, ESPMode::ThreadSafe> createHttpRequest(
+    const std::string& url,
+    const std::vector<CesiumAsync::IAssetAccessor::THeader>& headers,
+    const FString& userAgent,
+    bool completeOnHttpThread) {
+  FHttpModule& httpModule = FHttpModule::Get();
+  TSharedRef<IHttpRequest, ESPMode::ThreadSafe> pRequest =
+      httpModule.CreateRequest();
+  pRequest->SetURL(UTF8_TO_TCHAR(url.c_str()));
+
+  for (const CesiumAsync::IAssetAccessor::THeader& header : headers) {
+    pRequest->SetHeader(
+        UTF8_TO_TCHAR(header.first.c_str()),
+        UTF8_TO_TCHAR(header.second.c_str()));
+  }
+
+  pRequest->AppendToHeader(TEXT("User-Agent"), userAgent);
+
+  // CesiumGunzipAssetAccessor decompresses the responses on a worker
+  // thread, after they are cached. Backends that decompress responses
+  // themselves, such as libcurl when it is configured to accept compressed
+  // content, simply hand over the decompressed data.
+  if (pRequest->GetHeader(TEXT("Accept-Encoding")).IsEmpty()) {
+    pRequest->SetHeader(TEXT("Accept-Encoding"), TEXT("gzip"));
+  }
+  setDelegateThreadPolicy(*pRequest, completeOnHttpThread);
+  return pRequest;
+}
+
+/**
+ * Finds the scheme, host and port of a URL, such as https://example.com:8080
+ * for https://example.com:8080/tiles/0/0/0.terrain.
+ */
+std::string getHost(const std::string& url) {
+  const size_t scheme = url.find("://");
+  const size_t start = scheme == std::string::npos ? 0 : scheme + 3;
+  const size_t end = url.find_first_of("/?#", start);
+  return url.substr(0, end);
+}
+
+/**
+ * Sends an HTTP request that the registry lets start.
+ */
+void startRequest(IHttpRequest& request, uint64 traceKey) {
+  CesiumRuntimeStats::addRequestStarted(false);
+  CesiumTileTrace::recordStage(
+      CesiumTileTrace::Stage::RequestStarted,
+      traceKey);
+  request.ProcessRequest();
+}
+
+std::string getRequestKey(
+    const std::string& url,
+    const std::vector<CesiumAsync::IAssetAccessor::THeader>& headers) {
+  std::string key = url;
+  for (const CesiumAsync::IAssetAccessor::THeader& header : headers) {
+    key += '\n';
+    key += header.first;
+    key += ": ";
+    key += header.second;
+  }
+  return key;
+}
+
+void addRequestCompleted(
+    double startTime,
+    const FHttpResponsePtr& pResponse,
+    bool succeeded) {
+  CesiumRuntimeStats::addRequestCompleted(
+      FPlatformTime::Seconds() - startTime,
+      pResponse ? int64(pResponse->GetContent().Num()) : 0,
+      succeeded);
+}
+
+const char* getFailureMessage(const IHttpRequest& request) {
+  switch (request.GetStatus()) {
+  case EHttpRequestStatus::Failed_ConnectionError:
+    return "Connection failed.";
+  default:
+    return "Request failed.";
+  }
+}
+} // namespace
+
+/**
+ * The GET requests in flight, by URL and headers. This is shared with the
+ * completion delegates of the requests, so that it outlives the accessor
+ * until they have all run.
+ */
+struct UnrealAssetAccessor::RequestRegistry {
+  std::mutex mutex;
+  std::unordered_map<std::string, std::shared_ptr<PendingRequest>> pending;
+
+  // The most GET requests in flight to each host, and in total, or 0 for no
+  // limit. Requests beyond them wait in the queue, in the order they were
+  // made.
+  int32 maximumPerHost = 0;
+  int32 maximumInFlight = 0;
+  int32 inFlight = 0;
+  std::unordered_map<std::string, int32> inFlightByHost;
+  std::deque<std::shared_ptr<PendingRequest>> queue;
+
+  // Whether requests that take longer than most are hedged, by sending a
+  // copy of them and using whichever response arrives first. See
+  // UCesiumRuntimeSettings::HedgeSlowRequests.
+  bool hedge = false;
+  double hedgePercentile = 95.0;
+  double minimumHedgeDelay = 0.5;
+  double maximumHedgeFraction = 0.05;
+
+  // The latencies, in seconds, of the most recent requests that succeeded,
+  // as a ring buffer, and the number of requests sent and hedged.
+  std::vector<double> latencies;
+  size_t nextLatency = 0;
+  int64 requestsSent = 0;
+  int64 requestsHedged = 0;
+
+  /**
+   * Takes a slot for the given request if the limits allow it to start now.
+   * Otherwise, queues it until release gives it one. Must be called with the
+   * mutex locked.
+   *
+   * @return Whether the request may start now.
+   */
+  bool admit(const std::shared_ptr<PendingRequest>& pRequest) {
+    if (!this->hasSlot(pRequest->host)) {
+      pRequest->queued = true;
+      this->queue.push_back(pRequest);
+      return false;
+    }
+    this->takeSlot(*pRequest);
+    return true;
+  }
+
+  /**
+   * Gives back the slot of a request that was in flight, and takes the
+   * queued requests that may start now in its place.
+   */
+  std::vector<std::shared_ptr<PendingRequest>>
+  release(const std::string& host) {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    --this->inFlight;
+    auto it = this->inFlightByHost.find(host);
+    if (it != this->inFlightByHost.end() && --it->second <= 0) {
+      this->inFlightByHost.erase(it);
+    }
+
+    std::vector<std::shared_ptr<PendingRequest>> started;
+    for (auto queued = this->queue.begin(); queued != this->queue.end();) {
+      if (this->maximumInFlight > 0 &&
+          this->inFlight >= this->maximumInFlight) {
+        break;
+      }
+      if (!this->hasSlot((*queued)->host)) {
+        ++queued;
+        continue;
+      }
+      (*queued)->queued = false;
+      this->takeSlot(**queued);
+      started.push_back(std::move(*queued));
+      queued = this->queue.erase(queued);
+    }
+    return started;
+  }
+
+  /**
+   * Removes a canceled request from the queue, if it is queued, and takes the
+   * promises waiting for it, since it will never be sent. Must be called with
+   * the mutex locked.
+   */
+  std::vector<RequestPromise> unqueue(PendingRequest& request) {
+    if (!request.queued) {
+      return {};
+    }
+    request.queued = false;
+    request.pRequest.Reset();
+    this->queue.erase(
+        std::remove_if(
+            this->queue.begin(),
+            this->queue.end(),
+            [&request](const std::shared_ptr<PendingRequest>& pQueued) {
+              return pQueued.get() == &request;
+            }),
+        this->queue.end());
+    return std::move(request.promises);
+  }
+
+  /**
+   * Removes a completed request from the registry, if it's still there, and
+   * takes the promises waiting for it.
+   */
+  std::vector<RequestPromise>
+  finish(const std::string& key, PendingRequest& request) {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    auto it = this->pending.find(key);
+    if (it != this->pending.end() && it->second.get() == &request) {
+      this->pending.erase(it);
+    }
+    return std::move(request.promises);
+  }
+
+  /**
+   * Handles the completion of an HTTP request for a GET request, which is
+   * either the original one or its hedged copy. The first of them to succeed,
+   * or the last of them to fail, settles the promises, and the other one is
+   * canceled.
+   */
+  void complete(
+      const std::string& key,
+      PendingRequest& pending,
+      const FHttpRequestPtr& pRequest,
+      const FHttpResponsePtr& pResponse,
+      bool connectedSuccessfully) {
+    FHttpRequestPtr pOther;
+    bool settle;
+    bool canceled;
+    {
+      std::lock_guard<std::mutex> lock(this->mutex);
+      canceled = pending.canceled;
+      --pending.inFlight;
+      settle = !pending.settled &&
+               (connectedSuccessfully || pending.inFlight == 0);
+      if (settle) {
+        pending.settled = true;
+        if (pending.inFlight > 0) {
+          pOther = pRequest == pending.pRequest
+                       ? (pending.hedgeStarted ? pending.pHedge : nullptr)
+                       : pending.pRequest;
+        }
+      }
+
+      // Only the latencies of the original requests are counted, so that
+      // hedging doesn't lower the delay after which requests are hedged.
+      // When the hedged copy succeeds first, the original is canceled after
+      // having been in flight since it was sent, which is counted instead.
+      if (settle && connectedSuccessfully) {
+        this->addLatency(FPlatformTime::Seconds() - pending.sentTime);
+      }
+
+      // The completion delegates of the HTTP requests hold this request, so
+      // the HTTP requests are released once neither is in flight, rather
+      // than kept alive by the two of them together.
+      if (pending.inFlight == 0) {
+        pending.pRequest.Reset();
+        pending.pHedge.Reset();
+      }
+    }
+
+    // The requests waiting for this one's slot are sent before its response
+    // is handled.
+    for (const std::shared_ptr<PendingRequest>& pStarted :
+         this->release(pending.host)) {
+      startRequest(*pStarted->pRequest, pStarted->traceKey);
+    }
+
+    if (pOther) {
+      pOther->CancelRequest();
+    }
+
+    if (!settle) {
+      return;
+    }
+
+    std::vector<RequestPromise> promises = this->finish(key, pending);
+    if (connectedSuccessfully) {
+      std::shared_ptr<CesiumAsync::IAssetRequest> pAssetRequest =
+          std::make_shared<UnrealAssetRequest>(pRequest, pResponse);
+      for (const RequestPromise& waiting : promises) {
+        waiting.resolve(
+            std::shared_ptr<CesiumAsync::IAssetRequest>(pAssetRequest));
+      }
+    } else {
+      const char* message =
+          canceled ? "Request canceled." : getFailureMessage(*pRequest);
+      for (const RequestPromise& waiting : promises) {
+        waiting.reject(std::runtime_error(message));
+      }
+    }
+  }
+
+  /**
+   * Finds the requests that have been in flight for longer than the hedging
+   * delay, within the budget for hedged requests, and creates their hedged
+   * copies, which the caller sends.
+   */
+  std::vector<std::pair<std::string, std::shared_ptr<PendingRequest>>>
+  takeHedges(const FString& userAgent, bool completeOnHttpThread) {
+    std::vector<std::pair<std::string, std::shared_ptr<PendingRequest>>>
+        hedges;
+
+    std::lock_guard<std::mutex> lock(this->mutex);
+    if (!this->hedge || this->latencies.size() < MinimumLatencySamples) {
+      return hedges;
+    }
+
+    std::vector<double> sorted = this->latencies;
+    const size_t percentile = FMath::Clamp<size_t>(
+        size_t(this->hedgePercentile / 100.0 * double(sorted.size())),
+        0,
+        sorted.size() - 1);
+    std::nth_element(
+        sorted.begin(),
+        sorted.begin() + percentile,
+        sorted.end());
+    const double delay =
+        FMath::Max(sorted[percentile], this->minimumHedgeDelay);
+    const double now = FPlatformTime::Seconds();
+
+    for (const auto& pair : this->pending) {
+      PendingRequest& pending = *pair.second;
+      if (pending.queued || pending.pHedge || pending.inFlight != 1 ||
+          now - pending.sentTime < delay) {
+        continue;
+      }
+      if (double(this->requestsHedged + 1) >
+          this->maximumHedgeFraction * double(this->requestsSent)) {
+        break;
+      }
+      if (!this->hasSlot(pending.host)) {
+        continue;
+      }
+
+      ++this->requestsHedged;
+      ++this->inFlight;
+      ++this->inFlightByHost[pending.host];
+      ++pending.inFlight;
+      pending.pHedge = createHttpRequest(
+          pending.url,
+          pending.headers,
+          userAgent,
+          completeOnHttpThread);
+      hedges.emplace_back(pair.first, pair.second);
+    }
+
+    return hedges;
+  }
+
+private:
+  void addLatency(double latency) {
+    if (this->latencies.size() < LatencySamples) {
+      this->latencies.push_back(latency);
+    } else {
+      this->latencies[this->nextLatency] = latency;
+      this->nextLatency = (this->nextLatency + 1) % LatencySamples;
+    }
+  }
+
+  bool hasSlot(const std::string& host) const {
+    if (this->maximumInFlight > 0 && this->inFlight >= this->maximumInFlight) {
+      return false;
+    }
+    if (this->maximumPerHost <= 0) {
+      return true;
+    }
+    auto it = this->inFlightByHost.find(host);
+    return it == this->inFlightByHost.end() ||
+           it->second < this->maximumPerHost;
+  }
+
+  void takeSlot(PendingRequest& request) {
+    ++this->inFlight;
+    ++this->inFlightByHost[request.host];
+    ++this->requestsSent;
+    ++request.inFlight;
+    request.sentTime = FPlatformTime::Seconds();
+  }
 };
 
-UnrealAssetAccessor::UnrealAssetAccessor() : _userAgent() {
+UnrealAssetAccessor::UnrealAssetAccessor()
+    : _userAgent(),
+      _completeOnHttpThread(false),
+      _pRegistry(std::make_shared<RequestRegistry>()) {
+  const UCesiumRuntimeSettings* pSettings =
+      GetDefault<UCesiumRuntimeSettings>();
+#if ENGINE_MAJOR_VERSION >= 5
+  this->_completeOnHttpThread = pSettings->CompleteRequestsOnHttpThread;
+#endif
+  this->_pRegistry->maximumPerHost = pSettings->MaximumRequestsPerHost;
+  this->_pRegistry->maximumInFlight = pSettings->MaximumRequestsInFlight;
+  this->_pRegistry->hedge = pSettings->HedgeSlowRequests;
+  this->_pRegistry->hedgePercentile = pSettings->HedgeRequestPercentile;
+  this->_pRegistry->minimumHedgeDelay = pSettings->MinimumHedgeDelay;
+  this->_pRegistry->maximumHedgeFraction =
+      pSettings->MaximumHedgedRequestFraction;
+
   FString OsVersion, OsSubVersion;
   FPlatformMisc::GetOSVersions(OsVersion, OsSubVersion);
 
@@ -124,50 +613,169 @@ UnrealAssetAccessor::get(
     const std::string& url,
     const std::vector<CesiumAsync::IAssetAccessor::THeader>& headers) {
 
-  CESIUM_TRACE_BEGIN_IN_TRACK("requestAsset");
-
   const FString& userAgent = this->_userAgent;
+  const bool completeOnHttpThread = this->_completeOnHttpThread;
+  const std::shared_ptr<RequestRegistry>& pRegistry = this->_pRegistry;
 
   return asyncSystem.createFuture<std::shared_ptr<CesiumAsync::IAssetRequest>>(
-      [&url, &headers, &userAgent](const auto& promise) {
-        FHttpModule& httpModule = FHttpModule::Get();
-        TSharedRef<IHttpRequest, ESPMode::ThreadSafe> pRequest =
-            httpModule.CreateRequest();
-        pRequest->SetURL(UTF8_TO_TCHAR(url.c_str()));
-
-        for (const CesiumAsync::IAssetAccessor::THeader& header : headers) {
-          pRequest->SetHeader(
-              UTF8_TO_TCHAR(header.first.c_str()),
-              UTF8_TO_TCHAR(header.second.c_str()));
+      [&url, &headers, &userAgent, completeOnHttpThread, &pRegistry](
+          const auto& promise) {
+        std::string key = getRequestKey(url, headers);
+
+        std::shared_ptr<PendingRequest> pPending;
+        {
+          std::lock_guard<std::mutex> lock(pRegistry->mutex);
+          auto it = pRegistry->pending.find(key);
+          if (it != pRegistry->pending.end()) {
+            // The same URL is already being requested with the same headers,
+            // so wait for that response instead of requesting it again.
+            it->second->promises.push_back(promise);
+            CesiumRuntimeStats::addRequestStarted(true);
+            return;
+          }
+
+          pPending = std::make_shared<PendingRequest>();
+          pPending->promises.push_back(promise);
+          pPending->host = getHost(url);
+          pPending->url = url;
+          pPending->headers = headers;
+          pRegistry->pending.emplace(key, pPending);
         }
 
-        pRequest->AppendToHeader(TEXT("User-Agent"), userAgent);
+        CESIUM_TRACE_BEGIN_IN_TRACK("requestAsset");
+
+        const uint64 traceKey = CesiumTileTrace::isEnabled()
+                                    ? CesiumTileTrace::getRequestKey(url)
+                                    : 0;
+        pPending->traceKey = traceKey;
+
+        TSharedRef<IHttpRequest, ESPMode::ThreadSafe> pRequest =
+            createHttpRequest(url, headers, userAgent, completeOnHttpThread);
 
         pRequest->OnProcessRequestComplete().BindLambda(
-            [promise, CESIUM_TRACE_LAMBDA_CAPTURE_TRACK()](
+            [pRegistry,
+             pPending,
+             key,
+             traceKey,
+             startTime = FPlatformTime::Seconds(),
+             CESIUM_TRACE_LAMBDA_CAPTURE_TRACK()](
                 FHttpRequestPtr pRequest,
                 FHttpResponsePtr pResponse,
                 bool connectedSuccessfully) mutable {
               CESIUM_TRACE_USE_CAPTURED_TRACK();
               CESIUM_TRACE_END_IN_TRACK("requestAsset");
-
-              if (connectedSuccessfully) {
-                promise.resolve(
-                    std::make_unique<UnrealAssetRequest>(pRequest, pResponse));
-              } else {
-                switch (pRequest->GetStatus()) {
-                case EHttpRequestStatus::Failed_ConnectionError:
-                  promise.reject(std::runtime_error("Connection failed."));
-                default:
-                  promise.reject(std::runtime_error("Request failed."));
-                }
-              }
+              CesiumTileTrace::recordStage(
+                  CesiumTileTrace::Stage::ResponseReceived,
+                  traceKey);
+              addRequestCompleted(startTime, pResponse, connectedSuccessfully);
+              pRegistry->complete(
+                  key,
+                  *pPending,
+                  pRequest,
+                  pResponse,
+                  connectedSuccessfully);
             });
 
-        pRequest->ProcessRequest();
+        bool canceled;
+        bool admitted = false;
+        {
+          std::lock_guard<std::mutex> lock(pRegistry->mutex);
+          canceled = pPending->canceled;
+          if (!canceled) {
+            pPending->pRequest = pRequest;
+            admitted = pRegistry->admit(pPending);
+          }
+        }
+
+        if (canceled) {
+          // The request was canceled before it could be started.
+          CESIUM_TRACE_END_IN_TRACK("requestAsset");
+          for (const RequestPromise& waiting :
+               pRegistry->finish(key, *pPending)) {
+            waiting.reject(std::runtime_error("Request canceled."));
+          }
+          return;
+        }
+
+        // Otherwise, the request is sent when a slot is released.
+        if (admitted) {
+          startRequest(*pRequest, traceKey);
+        }
       });
 }
 
+bool UnrealAssetAccessor::cancel(
+    const std::string& url,
+    const std::vector<CesiumAsync::IAssetAccessor::THeader>& headers) {
+  std::shared_ptr<PendingRequest> pPending;
+  std::vector<RequestPromise> promises;
+  FHttpRequestPtr pRequest;
+  FHttpRequestPtr pHedge;
+  {
+    std::lock_guard<std::mutex> lock(this->_pRegistry->mutex);
+    auto it = this->_pRegistry->pending.find(getRequestKey(url, headers));
+    if (it == this->_pRegistry->pending.end()) {
+      return false;
+    }
+
+    pPending = it->second;
+    this->_pRegistry->pending.erase(it);
+    pPending->canceled = true;
+    promises = this->_pRegistry->unqueue(*pPending);
+
+    // The request is set by get under the lock, possibly on another thread.
+    pRequest = pPending->pRequest;
+    if (pPending->hedgeStarted) {
+      pHedge = pPending->pHedge;
+    }
+  }
+
+  // A queued request was never sent, so it can't be canceled.
+  for (const RequestPromise& waiting : promises) {
+    waiting.reject(std::runtime_error("Request canceled."));
+  }
+
+  if (pRequest) {
+    pRequest->CancelRequest();
+  }
+  if (pHedge) {
+    pHedge->CancelRequest();
+  }
+
+  return true;
+}
+
+void UnrealAssetAccessor::cancelAll() {
+  std::vector<FHttpRequestPtr> canceled;
+  std::vector<RequestPromise> promises;
+  {
+    std::lock_guard<std::mutex> lock(this->_pRegistry->mutex);
+    canceled.reserve(this->_pRegistry->pending.size());
+    for (auto& pair : this->_pRegistry->pending) {
+      PendingRequest& pending = *pair.second;
+      pending.canceled = true;
+      for (RequestPromise& waiting : this->_pRegistry->unqueue(pending)) {
+        promises.push_back(std::move(waiting));
+      }
+      if (pending.pRequest) {
+        canceled.push_back(pending.pRequest);
+      }
+      if (pending.hedgeStarted && pending.pHedge) {
+        canceled.push_back(pending.pHedge);
+      }
+    }
+    this->_pRegistry->pending.clear();
+  }
+
+  for (const RequestPromise& waiting : promises) {
+    waiting.reject(std::runtime_error("Request canceled."));
+  }
+
+  for (const FHttpRequestPtr& pRequest : canceled) {
+    pRequest->CancelRequest();
+  }
+}
+
 CesiumAsync::Future<std::shared_ptr<CesiumAsync::IAssetRequest>>
 UnrealAssetAccessor::request(
     const CesiumAsync::AsyncSystem& asyncSystem,
@@ -177,10 +785,15 @@ UnrealAssetAccessor::request(
     const gsl::span<const std::byte>& contentPayload) {
 
   const FString& userAgent = this->_userAgent;
+  const bool completeOnHttpThread = this->_completeOnHttpThread;
 
   return asyncSystem.createFuture<std::shared_ptr<CesiumAsync::IAssetRequest>>(
-      [&verb, &url, &headers, &userAgent, &contentPayload](
-          const auto& promise) {
+      [&verb,
+       &url,
+       &headers,
+       &userAgent,
+       &contentPayload,
+       completeOnHttpThread](const auto& promise) {
         FHttpModule& httpModule = FHttpModule::Get();
         TSharedRef<IHttpRequest, ESPMode::ThreadSafe> pRequest =
             httpModule.CreateRequest();
@@ -194,34 +807,83 @@ UnrealAssetAccessor::request(
         }
 
         pRequest->AppendToHeader(TEXT("User-Agent"), userAgent);
+        setDelegateThreadPolicy(*pRequest, completeOnHttpThread);
 
         pRequest->SetContent(TArray<uint8>(
             reinterpret_cast<const uint8*>(contentPayload.data()),
             contentPayload.size()));
 
         pRequest->OnProcessRequestComplete().BindLambda(
-            [promise](
+            [promise, startTime = FPlatformTime::Seconds()](
                 FHttpRequestPtr pRequest,
                 FHttpResponsePtr pResponse,
                 bool connectedSuccessfully) {
+              addRequestCompleted(startTime, pResponse, connectedSuccessfully);
+
               if (connectedSuccessfully) {
                 promise.resolve(
                     std::make_unique<UnrealAssetRequest>(pRequest, pResponse));
               } else {
-                switch (pRequest->GetStatus()) {
-                case EHttpRequestStatus::Failed_ConnectionError:
-                  promise.reject(std::runtime_error("Connection failed."));
-                default:
-                  promise.reject(std::runtime_error("Request failed."));
-                }
+                promise.reject(
+                    std::runtime_error(getFailureMessage(*pRequest)));
               }
             });
 
+        CesiumRuntimeStats::addRequestStarted(false);
         pRequest->ProcessRequest();
       });
 }
 
 void UnrealAssetAccessor::tick() noexcept {
+  CesiumRuntimeStats::updateRequestStats();
+  this->hedgeSlowRequests();
+
+  // Requests completed on the HTTP thread don't need the manager to be ticked
+  // to deliver their responses, and the engine ticks it anyway.
+  if (this->_completeOnHttpThread) {
+    return;
+  }
+
   FHttpManager& manager = FHttpModule::Get().GetHttpManager();
   manager.Tick(0.0f);
 }
+
+void UnrealAssetAccessor::hedgeSlowRequests() {
+  const std::shared_ptr<RequestRegistry>& pRegistry = this->_pRegistry;
+  for (const auto& [key, pPending] : pRegistry->takeHedges(
+           this->_userAgent,
+           this->_completeOnHttpThread)) {
+    // The hedged copy is released by the registry once it completes, which
+    // may happen before it is canceled below.
+    FHttpRequestPtr pHedge = pPending->pHedge;
+    pHedge->OnProcessRequestComplete().BindLambda(
+        [pRegistry,
+         pPending = pPending,
+         key = key,
+         startTime = FPlatformTime::Seconds()](
+            FHttpRequestPtr pRequest,
+            FHttpResponsePtr pResponse,
+            bool connectedSuccessfully) {
+          addRequestCompleted(startTime, pResponse, connectedSuccessfully);
+          pRegistry->complete(
+              key,
+              *pPending,
+              pRequest,
+              pResponse,
+              connectedSuccessfully);
+        });
+    startRequest(*pHedge, pPending->traceKey);
+
+    // The original request may have completed, or been canceled, while the
+    // hedged copy was being started, without being able to cancel it.
+    bool cancelHedge;
+    {
+      std::lock_guard<std::mutex> lock(pRegistry->mutex);
+      pPending->hedgeStarted = true;
+      cancelHedge = pPending->settled || pPending->canceled;
+    }
+    if (cancelHedge) {
+      pHedge->CancelRequest();
+    }
+  }
+}
@@ -2,7 +2,130 @@
 
 #include "UnrealTaskProcessor.h"
 #include "Async/Async.h"
+#include "CesiumRuntimeSettings.h"
+#include "HAL/PlatformProcess.h"
+#include "Misc/IQueuedWork.h"
+#include "Misc/QueuedThreadPool.h"
+#include <mutex>
+
+namespace {
+// Decoding tiles can recurse deeply, so the workers get larger stacks than
+// the 32 KiB default.
+constexpr uint32 WorkerStackSize = 1024 * 1024;
+
+class CesiumQueuedWork : public IQueuedWork {
+public:
+  CesiumQueuedWork(std::function<void()>&& f) : _f(std::move(f)) {}
+
+  virtual void DoThreadedWork() override {
+    this->_f();
+    delete this;
+  }
+
+  virtual void Abandon() override { delete this; }
+
+private:
+  std::function<void()> _f;
+};
+
+struct WorkerPool {
+  std::mutex mutex;
+  FQueuedThreadPool* pPool = nullptr;
+  bool created = false;
+};
+
+WorkerPool& getWorkerPool() {
+  static WorkerPool pool;
+  return pool;
+}
+
+EThreadPriority getThreadPriority(ECesiumWorkerThreadPriority priority) {
+  switch (priority) {
+  case ECesiumWorkerThreadPriority::BelowNormal:
+    return TPri_BelowNormal;
+  case ECesiumWorkerThreadPriority::Lowest:
+    return TPri_Lowest;
+  case ECesiumWorkerThreadPriority::Normal:
+  default:
+    return TPri_Normal;
+  }
+}
+
+ENamedThreads::Type getNamedThread(ECesiumWorkerThreadPriority priority) {
+  switch (priority) {
+  case ECesiumWorkerThreadPriority::BelowNormal:
+    return ENamedThreads::AnyBackgroundHiPriTask;
+  case ECesiumWorkerThreadPriority::Lowest:
+    return ENamedThreads::AnyBackgroundThreadNormalTask;
+  case ECesiumWorkerThreadPriority::Normal:
+  default:
+    return ENamedThreads::AnyThread;
+  }
+}
+
+/**
+ * Gets the worker thread pool, creating it the first time it is needed, or
+ * returns nullptr if tasks should run on the task graph. Must be called with
+ * the pool's mutex locked.
+ */
+FQueuedThreadPool* getOrCreatePool(WorkerPool& pool) {
+  if (pool.created) {
+    return pool.pPool;
+  }
+  pool.created = true;
+
+  const UCesiumRuntimeSettings* pSettings =
+      GetDefault<UCesiumRuntimeSettings>();
+  if (pSettings->WorkerThreadCount <= 0 ||
+      !FPlatformProcess::SupportsMultithreading()) {
+    return nullptr;
+  }
+
+  FQueuedThreadPool* pThreadPool = FQueuedThreadPool::Allocate();
+  if (!pThreadPool->Create(
+          uint32(pSettings->WorkerThreadCount),
+          WorkerStackSize,
+          getThreadPriority(pSettings->WorkerThreadPriority),
+          TEXT("CesiumWorkerThreadPool"))) {
+    delete pThreadPool;
+    return nullptr;
+  }
+
+  pool.pPool = pThreadPool;
+  return pThreadPool;
+}
+} // namespace
 
 void UnrealTaskProcessor::startTask(std::function<void()> f) {
-  AsyncTask(ENamedThreads::Type::AnyThread, [f]() { f(); });
+  WorkerPool& pool = getWorkerPool();
+  {
+    std::lock_guard<std::mutex> lock(pool.mutex);
+    FQueuedThreadPool* pThreadPool = getOrCreatePool(pool);
+    if (pThreadPool) {
+      pThreadPool->AddQueuedWork(new CesiumQueuedWork(std::move(f)));
+      return;
+    }
+  }
+
+  AsyncTask(
+      getNamedThread(
+          GetDefault<UCesiumRuntimeSettings>()->WorkerThreadPriority),
+      [f]() { f(); });
+}
+
+void UnrealTaskProcessor::shutdown() {
+  WorkerPool& pool = getWorkerPool();
+
+  FQueuedThreadPool* pThreadPool = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(pool.mutex);
+    pThreadPool = pool.pPool;
+    pool.pPool = nullptr;
+    pool.created = true;
+  }
+
+  if (pThreadPool) {
+    pThreadPool->Destroy();
+    delete pThreadPool;
+  }
 }
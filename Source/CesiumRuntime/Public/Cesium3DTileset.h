@@ -5,9 +5,13 @@
 #include "Cesium3DTilesSelection/ViewState.h"
 #include "Cesium3DTilesSelection/ViewUpdateResult.h"
 #include "Cesium3DTilesetLoadFailureDetails.h"
+#include "CesiumCamera.h"
 #include "CesiumCreditSystem.h"
 #include "CesiumExclusionZone.h"
+#include "CesiumFeatureHandle.h"
+#include "CesiumGeometryHit.h"
 #include "CesiumGeoreference.h"
+#include "CesiumTilesetMemoryStatistics.h"
 #include "CoreMinimal.h"
 #include "CustomDepthParameters.h"
 #include "GameFramework/Actor.h"
@@ -15,16 +19,30 @@
 #include <PhysicsEngine/BodyInstance.h>
 #include <chrono>
 #include <glm/mat4x4.hpp>
+#include <unordered_map>
 #include <vector>
 #include "Cesium3DTileset.generated.h"
 
 class UMaterialInterface;
+class ACesiumCartographicPolygon;
 class ACesiumCartographicSelection;
+class ALevelSequenceActor;
+class CesiumFarFieldProxy;
+class CesiumOcclusionTileExcluder;
+class CesiumScreenSpaceErrorController;
+class CesiumTileLoadController;
+class UnrealResourcePreparer;
+class UCesiumTileBatchComponent;
+class UCesiumTileLoadScheduler;
+class UStaticMeshComponent;
 struct FCesiumCamera;
 
 namespace Cesium3DTilesSelection {
+class ITileExcluder;
+class RasterOverlay;
 class Tileset;
 class TilesetView;
+struct TilesetOptions;
 } // namespace Cesium3DTilesSelection
 
 /**
@@ -201,6 +219,82 @@ public:
       meta = (ClampMin = 0.0))
   float MaximumScreenSpaceError = 16.0;
 
+  /**
+   * Whether to raise the maximum screen-space error above "Maximum Screen
+   * Space Error" when the frame rate drops below the "Target Frame Rate".
+   *
+   * This works like dynamic resolution, but for geometric detail: in busy
+   * scenes, coarser tiles are rendered to hold the frame rate, and the detail
+   * comes back once the frame time allows it. The frame time is the longest
+   * of the game thread, render thread and GPU times.
+   */
+  UPROPERTY(
+      EditAnywhere,
+      BlueprintReadWrite,
+      Category = "Cesium|Level of Detail")
+  bool AdaptScreenSpaceError = false;
+
+  /**
+   * The frame rate, in frames per second, to hold when "Adapt Screen Space
+   * Error" is enabled.
+   */
+  UPROPERTY(
+      EditAnywhere,
+      BlueprintReadWrite,
+      Category = "Cesium|Level of Detail",
+      meta = (EditCondition = "AdaptScreenSpaceError", ClampMin = 1.0))
+  float TargetFrameRate = 72.0f;
+
+  /**
+   * The largest maximum screen-space error to use when "Adapt Screen Space
+   * Error" is enabled.
+   */
+  UPROPERTY(
+      EditAnywhere,
+      BlueprintReadWrite,
+      Category = "Cesium|Level of Detail",
+      meta = (EditCondition = "AdaptScreenSpaceError", ClampMin = 0.0))
+  float MaximumAdaptiveScreenSpaceError = 64.0f;
+
+  /**
+   * How much lower than the maximum screen-space error the error of a tile
+   * must drop before the tiles it was refined into are replaced by it again.
+   *
+   * When the camera hovers near the error at which a tile is refined, the
+   * tile would otherwise be refined and coarsened back and forth. With a
+   * value of 1.5, for example, a tile that is refined at an error of 16 is
+   * only shown again instead of its descendants once its error is below
+   * 16 / 1.5. A value of 1 disables this.
+   */
+  UPROPERTY(
+      EditAnywhere,
+      BlueprintReadWrite,
+      Category = "Cesium|Level of Detail",
+      meta = (ClampMin = 1.0))
+  float LodHysteresis = 1.0f;
+
+  /**
+   * The minimum time, in seconds, that a tile stays rendered once it is
+   * shown, before it is replaced by its ancestor or its descendants. This
+   * keeps tiles that were only just shown from popping back out when the
+   * selection changes its mind, such as in slow camera pans. A value of 0
+   * disables this.
+   */
+  UPROPERTY(
+      EditAnywhere,
+      BlueprintReadWrite,
+      Category = "Cesium|Level of Detail",
+      meta = (ClampMin = 0.0))
+  float MinimumTileResidency = 0.0f;
+
+  /**
+   * Gets the maximum screen-space error that is currently used to select
+   * tiles. This is the "Maximum Screen Space Error", unless it is raised by
+   * "Adapt Screen Space Error".
+   */
+  UFUNCTION(BlueprintCallable, Category = "Cesium|Level of Detail")
+  float GetEffectiveScreenSpaceError() const;
+
   /**
    * Whether to preload ancestor tiles.
    *
@@ -241,6 +335,9 @@ public:
    * many of these tasks are processed at the same time. A higher value
    * may cause the tiles to be loaded and rendered more quickly, at the
    * cost of a higher network- and processing load.
+   *
+   * When "Adapt Simultaneous Tile Loads" is enabled, this is the largest
+   * number of loads the adaptation may use.
    */
   UPROPERTY(
       EditAnywhere,
@@ -249,6 +346,29 @@ public:
       meta = (ClampMin = 0))
   int32 MaximumSimultaneousTileLoads = 20;
 
+  /**
+   * Whether to adapt the number of tiles loaded at once to the network and
+   * CPU that are available, between the Minimum and Maximum Simultaneous Tile
+   * Loads.
+   *
+   * The number is lowered when the request latency rises without a gain in
+   * download throughput, or when the load threads that convert tile content
+   * are saturated. It is raised while tiles are waiting to be loaded.
+   */
+  UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Cesium|Tile Loading")
+  bool AdaptSimultaneousTileLoads = false;
+
+  /**
+   * The smallest number of tiles that may be loaded at once when "Adapt
+   * Simultaneous Tile Loads" is enabled.
+   */
+  UPROPERTY(
+      EditAnywhere,
+      BlueprintReadWrite,
+      Category = "Cesium|Tile Loading",
+      meta = (EditCondition = "AdaptSimultaneousTileLoads", ClampMin = 1))
+  int32 MinimumSimultaneousTileLoads = 4;
+
   /**
    * @brief The maximum number of bytes that may be cached.
    *
@@ -261,6 +381,211 @@ public:
   UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Cesium|Tile Loading")
   int64 MaximumCachedBytes = 256 * 1024 * 1024;
 
+  /**
+   * Whether MaximumCachedBytes limits the memory actually used by the Unreal
+   * Engine objects created for the tiles, rather than the size of the loaded
+   * tile data.
+   *
+   * Decoded textures, vertex buffers, and collision meshes are often much
+   * larger than the data they are created from. When this is enabled, the
+   * cache limit given to the tile selection is reduced by the ratio between
+   * the two, so that tiles are unloaded once the measured memory, as returned
+   * by GetMemoryStatistics, exceeds MaximumCachedBytes.
+   */
+  UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Cesium|Tile Loading")
+  bool LimitCacheByMeasuredMemory = false;
+
+  /**
+   * The number of bytes that the textures of the raster overlays of this
+   * tileset should use, or 0 for no limit.
+   *
+   * While the overlay textures use more than this, the tileset raises the
+   * quality tier of the raster overlays that have AdaptQualityTier enabled,
+   * one tier at a time, which quarters the size of the overlay textures that
+   * are loaded from then on. Memory pressure, and a frame rate below the
+   * TargetFrameRate even at the MaximumAdaptiveScreenSpaceError, raise the
+   * tier as well. The tier is lowered again once the textures use less than
+   * three quarters of this.
+   */
+  UPROPERTY(
+      EditAnywhere,
+      BlueprintReadWrite,
+      Category = "Cesium|Tile Loading",
+      meta = (ClampMin = 0))
+  int64 MaximumRasterOverlayTextureBytes = 0;
+
+  /**
+   * The maximum number of milliseconds per frame that may be spent on the
+   * game thread creating the Unreal objects for tiles that finished loading.
+   *
+   * When many tiles finish loading in the same frame, for example after a
+   * teleport, creating their meshes, materials, and physics bodies can cause
+   * a noticeable hitch. When this value is greater than zero, that work is
+   * spread over multiple frames, with the tiles closest to a camera completed
+   * first. A tile may briefly be shown with only some of its primitives while
+   * it is being completed. When this value is zero, all tiles are completed
+   * in the frame in which they finish loading.
+   */
+  UPROPERTY(
+      EditAnywhere,
+      BlueprintReadWrite,
+      Category = "Cesium|Tile Loading",
+      meta = (ClampMin = 0.0))
+  float MainThreadLoadingTimeLimit = 0.0f;
+
+  /**
+   * The maximum number of primitive components, along with their static
+   * meshes and materials, that are kept for reuse after the tiles that
+   * created them are unloaded.
+   *
+   * Reusing these objects avoids the cost of constructing and garbage
+   * collecting them as the camera moves and tiles are loaded and unloaded.
+   * Pooled objects use memory even when no tile needs them. Set this to zero
+   * to disable pooling.
+   */
+  UPROPERTY(
+      EditAnywhere,
+      BlueprintReadWrite,
+      Category = "Cesium|Tile Loading",
+      meta = (ClampMin = 0))
+  int32 MaximumPooledPrimitives = 0;
+
+  /**
+   * Whether to release the decoded glTF data of tiles once their Unreal
+   * meshes, textures and physics bodies have been created.
+   *
+   * The decoded images of each tile are freed, along with its vertex and
+   * index buffers when it has no feature metadata, which roughly halves the
+   * CPU memory used by each loaded tile. Tiles with feature metadata keep
+   * their buffers so that metadata can still be queried. The data is always
+   * kept while the tileset has raster overlays, because tiles that are more
+   * detailed than their geometry are created from their parent's data. When
+   * a raster overlay is added after some tile data was released, the tileset
+   * is loaded again.
+   */
+  UPROPERTY(
+      EditAnywhere,
+      BlueprintReadWrite,
+      Category = "Cesium|Tile Loading")
+  bool ReleaseTileDataAfterLoad = false;
+
+  /**
+   * Whether to keep a snapshot on disk of the converted meshes, textures and
+   * physics meshes of the tiles that are shown when play ends, so that they
+   * are restored instead of being converted again when play starts next.
+   *
+   * The snapshot is in Saved/Cesium/Snapshots, and is specific to this
+   * tileset and its source. A tile is only restored when its glTF and the
+   * settings of the tileset that affect its conversion are unchanged. The
+   * tiles are still requested and parsed, so this mostly speeds up the first
+   * frames of tilesets whose tiles are expensive to convert. Takes effect the
+   * next time the tileset is loaded.
+   */
+  UPROPERTY(
+      EditAnywhere,
+      BlueprintReadWrite,
+      Category = "Cesium|Tile Loading")
+  bool UseWarmStartSnapshot = false;
+
+  /**
+   * The maximum number of raster overlay textures that are kept for reuse
+   * after the overlay tiles that created them are unloaded.
+   *
+   * A reused texture has its pixels replaced in place by those of the next
+   * overlay tile with the same size and format, which avoids creating a
+   * texture object and GPU resource for every overlay tile that streams in.
+   * Pooled textures use memory even when no tile needs them. Set this to
+   * zero to disable pooling.
+   */
+  UPROPERTY(
+      EditAnywhere,
+      BlueprintReadWrite,
+      Category = "Cesium|Tile Loading",
+      meta = (ClampMin = 0))
+  int32 MaximumPooledOverlayTextures = 0;
+
+  /**
+   * The number of seconds ahead of each camera to start loading tiles.
+   *
+   * When this value is greater than zero, each camera is extrapolated along
+   * its current velocity over this time, and the predicted view is used to
+   * select tiles in addition to the actual one. This lets tiles be loaded
+   * before a fast-moving camera arrives. The predicted views select tiles at
+   * a lower level of detail than the actual views, so they compete less for
+   * loading with the tiles needed right now. When this value is zero, only
+   * the actual camera views are used.
+   */
+  UPROPERTY(
+      EditAnywhere,
+      BlueprintReadWrite,
+      Category = "Cesium|Tile Loading",
+      meta = (ClampMin = 0.0))
+  float PredictiveLoadingTime = 0.0f;
+
+  /**
+   * The number of seconds ahead of the playhead of each playing Level
+   * Sequence to start loading tiles.
+   *
+   * When this value is greater than zero, the camera cut track of each Level
+   * Sequence that plays in the world is sampled over this time ahead of its
+   * playhead, and the views of the cameras it cuts to are used to select
+   * tiles in addition to the actual ones. This lets the tiles for camera cuts
+   * and fast moves be loaded before they are rendered. While a movie is
+   * captured, each frame still waits for the tiles of its own views only,
+   * and the upcoming views only start loading once those are loaded, so that
+   * they load while the frame renders.
+   */
+  UPROPERTY(
+      EditAnywhere,
+      BlueprintReadWrite,
+      Category = "Cesium|Tile Loading",
+      meta = (ClampMin = 0.0))
+  float SequencerPreloadTime = 0.0f;
+
+  /**
+   * The number of views sampled over the SequencerPreloadTime ahead of the
+   * playhead of each playing Level Sequence.
+   */
+  UPROPERTY(
+      EditAnywhere,
+      BlueprintReadWrite,
+      Category = "Cesium|Tile Loading",
+      meta = (ClampMin = 1, ClampMax = 32))
+  int32 SequencerPreloadSamples = 4;
+
+  /**
+   * Whether to skip the tile selection, and the updates of the tiles that
+   * follow it, in frames where no camera, selection option or transform has
+   * changed and no tile is loading, reusing the result of the last
+   * selection.
+   *
+   * A view that stays still, such as a monitor left on the same scene, then
+   * costs almost nothing per frame once its tiles are loaded. The selection
+   * always runs while occlusion culling is enabled, because its results
+   * change without the views changing.
+   */
+  UPROPERTY(
+      EditAnywhere,
+      BlueprintReadWrite,
+      Category = "Cesium|Tile Loading")
+  bool SkipUnchangedViewUpdates = false;
+
+  /**
+   * Whether to select tiles once for both eyes of a stereo (VR) view, instead
+   * of once for each eye.
+   *
+   * When enabled, a single view whose frustum contains both eyes' frustums
+   * is used, with at least the detail of the more detailed eye. This nearly
+   * halves the cost of tile selection in VR, and keeps the eyes from loading
+   * slightly different levels of detail. It has no effect when stereo
+   * rendering is not enabled.
+   */
+  UPROPERTY(
+      EditAnywhere,
+      BlueprintReadWrite,
+      Category = "Cesium|Tile Loading")
+  bool CombineStereoViews = false;
+
   /**
    * The number of loading descendents a tile should allow before deciding to
    * render itself instead of waiting.
@@ -279,6 +604,72 @@ public:
       meta = (ClampMin = 0))
   int32 LoadingDescendantLimit = 20;
 
+  /**
+   * Whether to skip levels of detail when loading the tiles of a view.
+   *
+   * Without this, the levels of detail between the ones that are rendered
+   * and the desired one are loaded one after the other, so when the camera
+   * jumps close to the ground, it takes as many rounds of requests as the
+   * tree is deep before the desired detail appears. With this, once the
+   * rendered tiles meet the "Base Screen Space Error", only every few levels
+   * are loaded on the way down, and ancestors are not preloaded.
+   *
+   * The levels are skipped by raising the "Loading Descendant Limit" so that
+   * a tile is only loaded instead of its descendants when they are more
+   * levels below it than are skipped, which assumes that each level of the
+   * tileset halves the geometric error and splits each tile into four.
+   */
+  UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Cesium|Tile Loading")
+  bool SkipLevelOfDetail = false;
+
+  /**
+   * The screen-space error that the rendered tiles must meet before levels
+   * of detail are skipped. Coarser levels are loaded one after the other, so
+   * that a view is quickly covered by something.
+   */
+  UPROPERTY(
+      EditAnywhere,
+      BlueprintReadWrite,
+      Category = "Cesium|Tile Loading",
+      meta = (EditCondition = "SkipLevelOfDetail", ClampMin = 0.0))
+  float BaseScreenSpaceError = 1024.0f;
+
+  /**
+   * How many times lower the screen-space error of a tile that is loaded
+   * must be than that of the loaded ancestor it replaces, when skipping
+   * levels of detail. A factor of 16 skips about four levels.
+   */
+  UPROPERTY(
+      EditAnywhere,
+      BlueprintReadWrite,
+      Category = "Cesium|Tile Loading",
+      meta = (EditCondition = "SkipLevelOfDetail", ClampMin = 1.0))
+  float SkipScreenSpaceErrorFactor = 16.0f;
+
+  /**
+   * The least number of levels to skip between the tiles that are loaded
+   * when skipping levels of detail.
+   */
+  UPROPERTY(
+      EditAnywhere,
+      BlueprintReadWrite,
+      Category = "Cesium|Tile Loading",
+      meta = (EditCondition = "SkipLevelOfDetail", ClampMin = 0))
+  int32 SkipLevels = 1;
+
+  /**
+   * Whether to load only the desired level of detail when skipping levels of
+   * detail, without any of the levels between it and the rendered tiles.
+   * The tiles that are already rendered stay rendered until the desired
+   * ones are loaded.
+   */
+  UPROPERTY(
+      EditAnywhere,
+      BlueprintReadWrite,
+      Category = "Cesium|Tile Loading",
+      meta = (EditCondition = "SkipLevelOfDetail"))
+  bool ImmediatelyLoadDesiredLevelOfDetail = false;
+
   /**
    * Whether to cull tiles that are outside the frustum.
    *
@@ -304,6 +695,44 @@ public:
   UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Cesium|Tile Culling")
   bool EnableFogCulling = true;
 
+  /**
+   * Whether to cull tiles that the Unreal Engine found to be hidden behind
+   * other geometry, such as terrain or buildings.
+   *
+   * Occluded tiles are neither refined nor have their descendants loaded,
+   * which saves a lot of loading in dense cities and valleys. The occlusion
+   * results come from previous frames, so a tile that becomes visible may
+   * be missing until it is tested again after the Occlusion Retest Interval.
+   *
+   * This only has an effect when "Enable Frustum Culling" is true. Tiles that
+   * are only in the view of a predicted camera, or a camera that is not
+   * rendered, are never rendered on screen either, so they are culled too.
+   */
+  UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Cesium|Tile Culling")
+  bool EnableOcclusionCulling = false;
+
+  /**
+   * How long, in seconds, a tile must not have been rendered on screen before
+   * it is culled as occluded.
+   */
+  UPROPERTY(
+      EditAnywhere,
+      BlueprintReadWrite,
+      Category = "Cesium|Tile Culling",
+      meta = (EditCondition = "EnableOcclusionCulling", ClampMin = 0.0))
+  float OcclusionCullingDelay = 0.25f;
+
+  /**
+   * How long, in seconds, a tile that was culled as occluded stays culled
+   * before it is shown again to test whether it is still occluded.
+   */
+  UPROPERTY(
+      EditAnywhere,
+      BlueprintReadWrite,
+      Category = "Cesium|Tile Culling",
+      meta = (EditCondition = "EnableOcclusionCulling", ClampMin = 0.0))
+  float OcclusionRetestInterval = 1.0f;
+
   /**
    * Whether a specified screen-space error should be enforced for tiles that
    * are outside the frustum or hidden in fog.
@@ -398,6 +827,38 @@ public:
   UPROPERTY(EditAnywhere, Category = "Cesium|Debug")
   bool UpdateInEditor = true;
 
+  /**
+   * If true, this tileset is updated in the editor less eagerly, so that an
+   * idle editor doesn't spend its time selecting tiles:
+   *
+   *  - Only the editor viewports that are visible and realtime are used.
+   *  - The tile selection is skipped while no camera, property or transform
+   *    has changed and the tiles needed for the current views are loaded,
+   *    even if SkipUnchangedViewUpdates is disabled.
+   *  - The tileset is updated at most MaximumEditorUpdateRate times per
+   *    second.
+   *
+   * This has no effect while playing (including Play-in-Editor).
+   */
+  UPROPERTY(
+      EditAnywhere,
+      Category = "Cesium|Debug",
+      meta = (EditCondition = "UpdateInEditor"))
+  bool ThrottleEditorUpdates = false;
+
+  /**
+   * The maximum number of times per second that this tileset is updated in
+   * the editor when ThrottleEditorUpdates is enabled. If this is 0, it is
+   * updated every frame.
+   */
+  UPROPERTY(
+      EditAnywhere,
+      Category = "Cesium|Debug",
+      meta =
+          (EditCondition = "UpdateInEditor && ThrottleEditorUpdates",
+           ClampMin = 0.0))
+  float MaximumEditorUpdateRate = 30.0f;
+
   /**
    * If true, stats about tile selection are printed to the Output Log.
    */
@@ -407,6 +868,10 @@ public:
   /**
    * Define the collision profile for all the 3D tiles created inside this
    * actor.
+   *
+   * Tiles get this profile when they are created. After changing it outside
+   * of the editor, call UpdateTileCollisionSettings to apply it to the tiles
+   * that already exist.
    */
   UPROPERTY(
       EditAnywhere,
@@ -415,6 +880,13 @@ public:
       meta = (ShowOnlyInnerProperties, SkipUCSModifiedProperties))
   FBodyInstance BodyInstance;
 
+  /**
+   * Applies the collision object type and responses of BodyInstance to all of
+   * the tiles of this tileset that are already loaded.
+   */
+  UFUNCTION(BlueprintCallable, Category = "Collision")
+  void UpdateTileCollisionSettings();
+
 private:
   /**
    * The type of source from which to load this tileset.
@@ -486,6 +958,29 @@ private:
   UFUNCTION(CallInEditor, Category = "Cesium")
   void TroubleshootToken();
 
+  /**
+   * Whether this tileset shares its tiles with the other tilesets in the same
+   * world that load the same tileset in the same way, such as copies of it in
+   * several streaming levels.
+   *
+   * Of the tilesets with this option that have the same source, georeference
+   * and transform, and the same values of the properties that reload the
+   * tileset, materials and raster overlays, only the first one loads and
+   * draws the tiles. The others load nothing, so the tiles are downloaded and
+   * kept in memory only once. The tiles are selected for all of the views of
+   * the world either way. The options that apply without reloading, such as
+   * MaximumScreenSpaceError, are those of the tileset that loads the tiles.
+   * When it is destroyed or reloaded, such as when its level is unloaded,
+   * one of the others loads the tiles in its place.
+   */
+  UPROPERTY(
+      EditAnywhere,
+      BlueprintGetter = GetShareTileset,
+      BlueprintSetter = SetShareTileset,
+      Category = "Cesium",
+      AdvancedDisplay)
+  bool ShareTileset = false;
+
   /**
    * Whether to generate physics meshes for this tileset.
    *
@@ -500,6 +995,82 @@ private:
       Category = "Cesium|Physics")
   bool CreatePhysicsMeshes = true;
 
+  /**
+   * Whether to load this tileset only for collision, for example on a
+   * dedicated server.
+   *
+   * When this is enabled, only the physics meshes of tiles are created. No
+   * render data, materials, textures, or raster overlays are loaded, and tiles
+   * are selected around the pawns of the player controllers rather than from
+   * the player cameras and viewports. Tiles are selected in every direction
+   * around each pawn, as if it had a square viewport of
+   * CollisionOnlyViewportSize pixels and a 90 degree field of view. Tiles are
+   * also selected around the points of interest of the camera manager.
+   * CreatePhysicsMeshes must also be enabled for the tiles to have collision.
+   */
+  UPROPERTY(
+      EditAnywhere,
+      BlueprintGetter = GetCollisionOnly,
+      BlueprintSetter = SetCollisionOnly,
+      Category = "Cesium|Physics")
+  bool CollisionOnly = false;
+
+  /**
+   * The size, in pixels, of the virtual viewport used to select tiles around
+   * each pawn when CollisionOnly is enabled. Larger values load more detailed
+   * physics meshes farther from the pawns.
+   */
+  UPROPERTY(
+      EditAnywhere,
+      BlueprintGetter = GetCollisionOnlyViewportSize,
+      BlueprintSetter = SetCollisionOnlyViewportSize,
+      Category = "Cesium|Physics",
+      meta = (ClampMin = 1.0, EditCondition = "CollisionOnly"))
+  float CollisionOnlyViewportSize = 1024.0f;
+
+  /**
+   * The distance, in Unreal units, from a collision source within which the
+   * physics meshes of tiles are created.
+   *
+   * When this value is greater than zero, physics meshes are not cooked when
+   * tiles are loaded. Instead, they are cooked in the background for rendered
+   * tiles that come within this distance of the pawn of a player controller,
+   * of an actor added with AddCollisionSource, or of a point of interest of
+   * the camera manager with no radius of its own, and are then kept until the
+   * tile is unloaded. This saves the time and memory spent on physics meshes
+   * for distant tiles that nothing collides with. When this value is zero,
+   * physics meshes are created for all tiles as they are loaded.
+   */
+  UPROPERTY(
+      EditAnywhere,
+      BlueprintGetter = GetCollisionRadius,
+      BlueprintSetter = SetCollisionRadius,
+      Category = "Cesium|Physics",
+      meta = (ClampMin = 0.0))
+  float CollisionRadius = 0.0f;
+
+  /**
+   * The maximum distance, in meters, that the vertices of physics meshes may
+   * be moved when they are simplified.
+   *
+   * When this value is greater than zero, the triangles of each tile are
+   * simplified before they are cooked into a physics mesh, by merging the
+   * vertices that are closer together than this distance. This makes
+   * detailed tiles, such as those from photogrammetry, much faster to cook
+   * and to trace against, and reduces their physics memory. Rendering is not
+   * affected. When this value is zero, physics meshes use the full detail of
+   * the rendered triangles. Primitives with feature metadata are not
+   * simplified, so that the face index of a hit still refers to the
+   * same face of the glTF for the metadata face functions.
+   */
+  UPROPERTY(
+      EditAnywhere,
+      BlueprintGetter = GetCollisionSimplificationError,
+      BlueprintSetter = SetCollisionSimplificationError,
+      Category = "Cesium|Physics",
+      meta = (ClampMin = 0.0))
+  float CollisionSimplificationError = 0.0f;
+
   /**
    * Whether to always generate a correct tangent space basis for tiles that
    * don't have them.
@@ -508,7 +1079,9 @@ private:
    * with a normal map. However, a custom, user-supplied material may need a
    * tangent space basis for other purposes. When this property is set to true,
    * tiles lacking an explicit tangent vector will have one computed
-   * automatically using the MikkTSpace algorithm. When this property is false,
+   * automatically. Tiles with normals get tangents computed from their shared
+   * vertices, and tiles that need flat normals use the MikkTSpace algorithm on
+   * their duplicated vertices. When this property is false,
    * load time will be improved by skipping the generation of the tangent
    * vector, but the tangent space basis will be unreliable.
    *
@@ -523,12 +1096,31 @@ private:
   bool AlwaysIncludeTangents = false;
 
   /**
-   * Whether to generate smooth normals when normals are missing in the glTF.
+   * Whether to store the tangent space basis and texture coordinates of
+   * tiles at full precision.
    *
-   * According to the Gltf spec: "When normals are not specified, client
-   * implementations should calculate flat normals." However, calculating flat
-   * normals requires duplicating vertices. This option allows the gltfs to be
-   * sent with explicit smooth normals when the original gltf was missing
+   * By default, normals and tangents are stored with 8 bits per component,
+   * and texture coordinates are stored at half precision when they are all
+   * between -2 and 2, which is enough for raster overlays and most glTF
+   * textures. Quantized glTF attributes (KHR_mesh_quantization) are expanded
+   * into these formats. Enabling this property roughly doubles the memory
+   * used by those parts of the vertex buffers, and may be needed by custom
+   * materials that use texture coordinates for other purposes.
+   */
+  UPROPERTY(
+      EditAnywhere,
+      BlueprintGetter = GetHighPrecisionVertexAttributes,
+      BlueprintSetter = SetHighPrecisionVertexAttributes,
+      Category = "Cesium|Rendering")
+  bool HighPrecisionVertexAttributes = false;
+
+  /**
+   * Whether to generate smooth normals when normals are missing in the glTF.
+   *
+   * According to the Gltf spec: "When normals are not specified, client
+   * implementations should calculate flat normals." However, calculating flat
+   * normals requires duplicating vertices. This option allows the gltfs to be
+   * sent with explicit smooth normals when the original gltf was missing
    * normals.
    */
   UPROPERTY(
@@ -538,6 +1130,303 @@ private:
       Category = "Cesium|Rendering")
   bool GenerateSmoothNormals = false;
 
+  /**
+   * Whether the tileset's material computes flat normals for tiles that are
+   * missing normals in the glTF.
+   *
+   * Computing flat normals on the CPU requires duplicating every vertex that
+   * is shared by multiple triangles, which increases the vertex count of
+   * typical meshes several times. When this property is true, primitives
+   * without normals keep their shared vertices, and their materials have the
+   * "flatNormals" scalar parameter set to 1. The material must then compute
+   * a world-space normal from the screen-space derivatives of the absolute
+   * world position, for example with the cross product of DDY and DDX, and
+   * use it instead of the vertex normal, which is only a placeholder.
+   *
+   * Primitives that need generated tangents, such as those with a normal map,
+   * are still duplicated. This property has no effect when "Generate Smooth
+   * Normals" is set, because those tiles then have normals.
+   */
+  UPROPERTY(
+      EditAnywhere,
+      BlueprintGetter = GetComputeFlatNormalsInMaterial,
+      BlueprintSetter = SetComputeFlatNormalsInMaterial,
+      Category = "Cesium|Rendering")
+  bool ComputeFlatNormalsInMaterial = false;
+
+  /**
+   * Whether to reorder the triangles and vertices of tiles to render them
+   * more efficiently.
+   *
+   * When this property is true, the triangles of each primitive are
+   * reordered while the tile is loaded so that shared vertices are more
+   * likely to be found in the GPU's post-transform vertex cache, and so that
+   * outward-facing triangles are drawn first to reduce overdraw. The
+   * vertices are then stored in the order they are used. This reduces vertex
+   * shader invocations for tilesets whose triangles are poorly ordered, at
+   * the cost of additional load time. Primitives whose vertices are
+   * duplicated for each triangle, such as those that need flat normals or
+   * generated tangents, are not reordered. Neither are primitives with
+   * feature metadata, whose features are found from the original order of
+   * their faces.
+   */
+  UPROPERTY(
+      EditAnywhere,
+      BlueprintGetter = GetOptimizeMeshes,
+      BlueprintSetter = SetOptimizeMeshes,
+      Category = "Cesium|Rendering")
+  bool OptimizeMeshes = false;
+
+  /**
+   * Whether to merge the primitives of a tile that can be drawn together into
+   * a single mesh.
+   *
+   * When this property is true, primitives with the same node transform, the
+   * same glTF material, and compatible vertex formats are combined into one
+   * component with a single mesh section while the tile is loaded. This
+   * reduces the number of draw calls and scene proxies for tiles made of many
+   * small primitives, at the cost of additional load time. Primitives with
+   * feature metadata are never merged, so that faces can still be mapped to
+   * their feature IDs, and neither are primitives with a water mask.
+   */
+  UPROPERTY(
+      EditAnywhere,
+      BlueprintGetter = GetMergePrimitives,
+      BlueprintSetter = SetMergePrimitives,
+      Category = "Cesium|Rendering")
+  bool MergePrimitives = false;
+
+  /**
+   * Whether to build Nanite meshes for the tiles of this tileset.
+   *
+   * When this property is true, Nanite resources are built for each primitive
+   * while its tile is loaded, so that dense meshes are rendered by Nanite. The
+   * regular mesh is kept as the fallback for platforms without Nanite
+   * support. Primitives with translucent or masked glTF materials, or with
+   * water, are not built, and neither are primitives whose tileset material
+   * is not opaque.
+   *
+   * Building Nanite resources is slow, and it is only possible in the editor
+   * with Unreal Engine 5. Elsewhere, this property has no effect.
+   */
+  UPROPERTY(
+      EditAnywhere,
+      BlueprintGetter = GetBuildNaniteMeshes,
+      BlueprintSetter = SetBuildNaniteMeshes,
+      Category = "Cesium|Rendering")
+  bool BuildNaniteMeshes = false;
+
+  /**
+   * Whether to draw the tiles of this tileset with a single component,
+   * rather than with a scene proxy for each of their primitives.
+   *
+   * When this property is true, the primitives of the tiles are still
+   * components, with their collision and metadata, but they are drawn by a
+   * single scene proxy that is told about them with render commands, and
+   * that culls them against each view itself. This saves the game-thread and
+   * render-thread cost of registering, moving, showing, and hiding a scene
+   * proxy for each primitive, which dominates when many thousands of
+   * primitives are rendered.
+   *
+   * Batched primitives are not drawn in custom depth, ray tracing, or hit
+   * proxies, and are not occlusion culled. Point clouds and Nanite meshes
+   * are always drawn by their own scene proxies.
+   */
+  UPROPERTY(
+      EditAnywhere,
+      BlueprintGetter = GetUseBatchedRendering,
+      BlueprintSetter = SetUseBatchedRendering,
+      Category = "Cesium|Rendering")
+  bool UseBatchedRendering = false;
+
+  /**
+   * Whether to draw quantized-mesh terrain tiles as heightfields.
+   *
+   * When this property is true, the surface of each terrain tile is sampled
+   * on a regular grid of longitudes and latitudes into two small textures,
+   * instead of being converted into vertex and index buffers, and all of the
+   * tiles are drawn with a single shared grid mesh. This nearly eliminates
+   * the conversion time and vertex memory of terrain. The collision meshes
+   * are still cooked from the triangles of the tiles.
+   *
+   * The tiles are only displaced by the Material of this tileset, which must
+   * move each vertex of the grid to the position that it samples from the
+   * "heightfieldPositions" texture at its first UV channel, in the local
+   * space of the primitive, and may read the local space normal from the
+   * "heightfieldNormals" texture. Its "heightfield" scalar parameter is 1 for
+   * heightfields. The raster overlays are sampled with the second UV
+   * channel, which is exact for overlays in the geographic projection. Tiles
+   * that are not quantized-mesh terrain are drawn as usual.
+   *
+   * The materials that come with the plugin don't displace the grid, so a
+   * custom material with the "heightfieldPositions" texture parameter is
+   * needed. Without one, a warning is logged and the terrain tiles are drawn
+   * as meshes.
+   */
+  UPROPERTY(
+      EditAnywhere,
+      BlueprintGetter = GetRenderTerrainAsHeightfields,
+      BlueprintSetter = SetRenderTerrainAsHeightfields,
+      Category = "Cesium|Rendering")
+  bool RenderTerrainAsHeightfields = false;
+
+  /**
+   * Whether to stream the mips of the glTF textures of the tiles of this
+   * tileset.
+   *
+   * When this property is true, each tile only keeps the mips of its textures
+   * that are needed for its size on screen resident on the GPU, and tiles
+   * that are loaded but not rendered keep only their smallest mips. This
+   * makes texture memory follow screen coverage rather than the number of
+   * loaded tiles. Streamed textures keep a CPU copy of all of their mips, so
+   * that they can be streamed back in, and always have their mips generated
+   * on the CPU.
+   */
+  UPROPERTY(
+      EditAnywhere,
+      BlueprintGetter = GetStreamTileTextures,
+      BlueprintSetter = SetStreamTileTextures,
+      Category = "Cesium|Rendering")
+  bool StreamTileTextures = false;
+
+  /**
+   * The largest width or height, in texels, of the glTF textures of the tiles
+   * of this tileset. If this is 0, textures keep their size.
+   *
+   * Larger textures are halved until they fit when they are loaded, before
+   * their mips are made, which saves the time to make them and the memory
+   * and upload bandwidth of their largest mips. The limit is for the default
+   * MaximumScreenSpaceError of 16, and scales inversely with it, since a
+   * tileset that accepts twice the error in pixels accepts texels that are
+   * twice as large on screen too. Textures that are already block compressed
+   * or that come with their own mips keep their size.
+   */
+  UPROPERTY(
+      EditAnywhere,
+      BlueprintGetter = GetMaximumTextureSize,
+      BlueprintSetter = SetMaximumTextureSize,
+      Category = "Cesium|Rendering",
+      meta = (ClampMin = 0))
+  int32 MaximumTextureSize = 0;
+
+  /**
+   * The names of the feature metadata properties that are copied to the GPU
+   * for styling features in the tileset's material.
+   *
+   * When this property is not empty, the values of these properties in the
+   * first feature table of each primitive with feature metadata are stored in
+   * a single-channel floating point texture, which is set as the
+   * "featureMetadataTexture" parameter of its material. Each property uses
+   * "featureMetadataRowsPerProperty" rows of the texture, in the order given
+   * here, and each of those rows holds the values of
+   * "featureMetadataTextureWidth" consecutive features. The value of
+   * property P for feature F is then at texel (F % Width, P * RowsPerProperty
+   * + F / Width). The feature ID of each vertex is stored in the U coordinate
+   * of the UV channel given by the "featureIdTextureCoordinateIndex"
+   * parameter. Values that can't be converted to a number are zero.
+   *
+   * This lets materials color or hide features by their properties without
+   * any per-feature work on the CPU, at the cost of a texture and a UV
+   * channel for each primitive with feature metadata.
+   */
+  UPROPERTY(
+      EditAnywhere,
+      BlueprintGetter = GetMetadataTextureProperties,
+      BlueprintSetter = SetMetadataTextureProperties,
+      Category = "Cesium|Rendering")
+  TArray<FString> MetadataTextureProperties;
+
+  /**
+   * Whether to keep the bounds of the features of the loaded tiles, so that
+   * the features in a region or along a ray can be found with
+   * FindFeaturesInSphere, FindFeaturesInBox, FindFeaturesInPolygon, and
+   * FindFeaturesAlongRay without tracing against or reading the tiles.
+   *
+   * The features are the ones of the first feature table of each primitive,
+   * and their bounds are computed while the tiles are loaded.
+   */
+  UPROPERTY(
+      EditAnywhere,
+      BlueprintGetter = GetEnableFeatureIndex,
+      BlueprintSetter = SetEnableFeatureIndex,
+      Category = "Cesium|Metadata")
+  bool EnableFeatureIndex = false;
+
+  /**
+   * Whether to keep a bounding volume hierarchy over the triangles of each
+   * loaded tile, so that RaycastBatch and SampleHeights can cast rays against
+   * the tiles on worker threads, without physics meshes.
+   *
+   * The hierarchies are built from the full geometry of the tiles while they
+   * are loaded, and take about as much memory as their positions and
+   * indices.
+   */
+  UPROPERTY(
+      EditAnywhere,
+      BlueprintGetter = GetEnableGeometryQueries,
+      BlueprintSetter = SetEnableGeometryQueries,
+      Category = "Cesium|Queries")
+  bool EnableGeometryQueries = false;
+
+  /**
+   * Whether to build low-resolution mesh distance fields for the tiles near
+   * the cameras, so that they cast distance field shadows and ambient
+   * occlusion. The project must have "Generate Mesh Distance Fields" enabled.
+   *
+   * The distance fields are built on worker threads, from the same hierarchy
+   * over the triangles of each tile as EnableGeometryQueries, which is kept
+   * for each tile when this is enabled. Each tile is only built once, when it
+   * first comes within the MeshDistanceFieldRadius. Only supported in Unreal
+   * Engine 4, since the distance fields of Unreal Engine 5 can only be built
+   * in the editor.
+   */
+  UPROPERTY(
+      EditAnywhere,
+      BlueprintGetter = GetEnableMeshDistanceFields,
+      BlueprintSetter = SetEnableMeshDistanceFields,
+      Category = "Cesium|Rendering")
+  bool EnableMeshDistanceFields = false;
+
+  /**
+   * The distance, in Unreal units, from the nearest camera within which the
+   * mesh distance fields of tiles are built, when EnableMeshDistanceFields is
+   * true.
+   */
+  UPROPERTY(
+      EditAnywhere,
+      BlueprintGetter = GetMeshDistanceFieldRadius,
+      BlueprintSetter = SetMeshDistanceFieldRadius,
+      Category = "Cesium|Rendering",
+      meta = (EditCondition = "EnableMeshDistanceFields", ClampMin = 0.0))
+  float MeshDistanceFieldRadius = 100000.0f;
+
+  /**
+   * The number of voxels along the longest side of the mesh distance field
+   * of each tile, when EnableMeshDistanceFields is true.
+   */
+  UPROPERTY(
+      EditAnywhere,
+      BlueprintGetter = GetMeshDistanceFieldResolution,
+      BlueprintSetter = SetMeshDistanceFieldResolution,
+      Category = "Cesium|Rendering",
+      meta =
+          (EditCondition = "EnableMeshDistanceFields",
+           ClampMin = 4,
+           ClampMax = 64))
+  int32 MeshDistanceFieldResolution = 16;
+
+  /**
+   * The most mesh distance fields that are started in each frame, nearest
+   * tiles first, when EnableMeshDistanceFields is true.
+   */
+  UPROPERTY(
+      EditAnywhere,
+      BlueprintGetter = GetMaximumMeshDistanceFieldBuildsPerFrame,
+      BlueprintSetter = SetMaximumMeshDistanceFieldBuildsPerFrame,
+      Category = "Cesium|Rendering",
+      meta = (EditCondition = "EnableMeshDistanceFields", ClampMin = 1))
+  int32 MaximumMeshDistanceFieldBuildsPerFrame = 4;
+
   /**
    * Whether to request and render the water mask.
    *
@@ -552,12 +1441,33 @@ private:
       meta = (EditCondition = "PlatformName != TEXT(\"Mac\")"))
   bool EnableWaterMask = false;
 
+  /**
+   * Whether to pack the water masks of tiles into a few shared atlas
+   * textures, instead of creating a texture for the water mask of each tile
+   * with both land and water.
+   *
+   * This saves a texture object and GPU allocation per tile in views with a
+   * lot of coastline. The atlas textures are allocated in pages of about 50
+   * water masks, and a page is kept until its last tile is unloaded.
+   */
+  UPROPERTY(
+      EditAnywhere,
+      BlueprintGetter = GetPackWaterMasks,
+      BlueprintSetter = SetPackWaterMasks,
+      Category = "Cesium|Rendering",
+      meta = (EditCondition = "EnableWaterMask"))
+  bool PackWaterMasks = false;
+
   /**
    * A custom Material to use to render this tileset, in order to implement
    * custom visual effects.
    *
    * The custom material should generally be created by copying the
    * "M_CesiumOverlay" material and customizing it as desired.
+   *
+   * The tiles that are already loaded switch to a new material in place if it
+   * has the same material layers as the old one. Otherwise, the tileset is
+   * loaded again.
    */
   UPROPERTY(
       EditAnywhere,
@@ -576,6 +1486,9 @@ private:
    * "M_CesiumOverlayWater" material and customizing it as desired. For best
    * results, any changes to the above material should also be duplicated in the
    * Water Material.
+   *
+   * As with Material, a change is applied in place to the tiles that are
+   * already loaded when the material layers allow it.
    */
   UPROPERTY(
       EditAnywhere,
@@ -584,6 +1497,185 @@ private:
       Category = "Cesium|Rendering")
   UMaterialInterface* WaterMaterial = nullptr;
 
+  /**
+   * The distance, in Unreal units, from the nearest camera beyond which tiles
+   * no longer cast shadows. If this is 0, tiles cast shadows at any distance.
+   *
+   * Distant tiles are small on screen, but they are still rendered into the
+   * shadow cascades of directional lights, which can take a large part of the
+   * GPU time in wide views of terrain.
+   */
+  UPROPERTY(
+      EditAnywhere,
+      BlueprintGetter = GetMaximumShadowDistance,
+      BlueprintSetter = SetMaximumShadowDistance,
+      Category = "Cesium|Rendering",
+      meta = (ClampMin = 0.0))
+  float MaximumShadowDistance = 0.0f;
+
+  /**
+   * The geometric error, in meters, above which tiles no longer cast shadows.
+   * If this is 0, tiles cast shadows at any level of detail.
+   *
+   * Tiles with a large geometric error are the coarse ones that are only
+   * selected far from the camera, so this limits shadow casting to the
+   * detailed tiles nearby without depending on the scale of the tileset.
+   */
+  UPROPERTY(
+      EditAnywhere,
+      BlueprintGetter = GetMaximumShadowGeometricError,
+      BlueprintSetter = SetMaximumShadowGeometricError,
+      Category = "Cesium|Rendering",
+      meta = (ClampMin = 0.0))
+  float MaximumShadowGeometricError = 0.0f;
+
+  /**
+   * The distance, in Unreal units, from the nearest camera beyond which tiles
+   * are no longer visible in ray tracing, when it is enabled. If this is 0,
+   * tiles are visible in ray tracing at any distance.
+   *
+   * Distant tiles add little to ray-traced reflections, shadows, and global
+   * illumination, but each one is an instance in the ray tracing scene.
+   */
+  UPROPERTY(
+      EditAnywhere,
+      BlueprintGetter = GetMaximumRayTracingDistance,
+      BlueprintSetter = SetMaximumRayTracingDistance,
+      Category = "Cesium|Rendering",
+      meta = (ClampMin = 0.0))
+  float MaximumRayTracingDistance = 0.0f;
+
+  /**
+   * The geometric error, in meters, above which tiles have no ray tracing
+   * geometry, when ray tracing is enabled. If this is 0, tiles have ray
+   * tracing geometry at any level of detail.
+   *
+   * The ray tracing geometry of a tile is built on the GPU when the tile is
+   * loaded, which causes spikes when many tiles are streamed in. Like the
+   * MaximumShadowGeometricError, this leaves out the coarse tiles that are
+   * only selected far from the camera. It applies to the tiles that are
+   * loaded after it is changed.
+   */
+  UPROPERTY(
+      EditAnywhere,
+      BlueprintGetter = GetMaximumRayTracingGeometricError,
+      BlueprintSetter = SetMaximumRayTracingGeometricError,
+      Category = "Cesium|Rendering",
+      meta = (ClampMin = 0.0))
+  float MaximumRayTracingGeometricError = 0.0f;
+
+  /**
+   * The largest number of tiles that become visible in ray tracing in each
+   * frame, nearest first, when ray tracing is enabled. If this is 0, there is
+   * no limit.
+   *
+   * The others are rendered without being visible in ray tracing until a
+   * later frame, which spreads the work of adding them to the ray tracing
+   * scene, and of building their ray tracing geometry where the engine
+   * builds it on first use, over several frames.
+   */
+  UPROPERTY(
+      EditAnywhere,
+      BlueprintGetter = GetMaximumRayTracingTilesPerFrame,
+      BlueprintSetter = SetMaximumRayTracingTilesPerFrame,
+      Category = "Cesium|Rendering",
+      meta = (ClampMin = 0))
+  int32 MaximumRayTracingTilesPerFrame = 0;
+
+  /**
+   * Scales the maximum draw distance that is given to the primitives of each
+   * tile. If this is 0, tiles have no maximum draw distance.
+   *
+   * The draw distance of a tile is the distance at which its parent no longer
+   * needs to be refined for the MaximumScreenSpaceError, computed from the
+   * geometric error of the parent and the bounds of the tile. Beyond it, the
+   * tile selection would show the parent instead. With a draw distance, the
+   * engine also culls the tile in the views where Cesium does not select
+   * tiles, such as the shadow depths of distant cascades, reflection
+   * captures, and scene captures. A value of 2 leaves a margin for the tiles
+   * that are still shown while their parent loads.
+   */
+  UPROPERTY(
+      EditAnywhere,
+      BlueprintGetter = GetTileCullDistanceScale,
+      BlueprintSetter = SetTileCullDistanceScale,
+      Category = "Cesium|Rendering",
+      meta = (ClampMin = 0.0))
+  float TileCullDistanceScale = 0.0f;
+
+  /**
+   * The maximum distance, in meters, that the vertices of the far-field proxy
+   * may be moved when tiles are simplified into it. If this is 0, there is no
+   * far-field proxy.
+   *
+   * When this value is greater than zero, a simplified, untextured copy of
+   * each tile is kept when it is loaded. The tiles beyond the
+   * FarFieldDistance, or with a geometric error of at least the
+   * FarFieldGeometricError, are then merged into a single mesh that is drawn
+   * instead of them, which replaces many draw calls with one. The proxy is
+   * only colored by the base color of the tiles, so this is meant for tiles
+   * that are small on screen. The tiles it draws are hidden, so they don't
+   * collide either.
+   */
+  UPROPERTY(
+      EditAnywhere,
+      BlueprintGetter = GetFarFieldSimplificationError,
+      BlueprintSetter = SetFarFieldSimplificationError,
+      Category = "Cesium|Far Field",
+      meta = (ClampMin = 0.0))
+  float FarFieldSimplificationError = 0.0f;
+
+  /**
+   * The distance, in Unreal units, from the nearest camera beyond which tiles
+   * are drawn by the far-field proxy. If this is 0, the distance is not
+   * taken into account.
+   */
+  UPROPERTY(
+      EditAnywhere,
+      BlueprintGetter = GetFarFieldDistance,
+      BlueprintSetter = SetFarFieldDistance,
+      Category = "Cesium|Far Field",
+      meta = (ClampMin = 0.0))
+  float FarFieldDistance = 0.0f;
+
+  /**
+   * The geometric error, in meters, from which tiles are drawn by the
+   * far-field proxy. If this is 0, the geometric error is not taken into
+   * account.
+   */
+  UPROPERTY(
+      EditAnywhere,
+      BlueprintGetter = GetFarFieldGeometricError,
+      BlueprintSetter = SetFarFieldGeometricError,
+      Category = "Cesium|Far Field",
+      meta = (ClampMin = 0.0))
+  float FarFieldGeometricError = 0.0f;
+
+  /**
+   * The minimum time, in seconds, between two rebuilds of the far-field
+   * proxy. The proxy is rebuilt in the background when the distant tiles
+   * change, and those tiles are drawn normally until it is done.
+   */
+  UPROPERTY(
+      EditAnywhere,
+      BlueprintGetter = GetFarFieldUpdateInterval,
+      BlueprintSetter = SetFarFieldUpdateInterval,
+      Category = "Cesium|Far Field",
+      meta = (ClampMin = 0.0))
+  float FarFieldUpdateInterval = 1.0f;
+
+  /**
+   * The material of the far-field proxy, which should use the vertex color as
+   * its base color. If this is null, the engine's vertex color material is
+   * used.
+   */
+  UPROPERTY(
+      EditAnywhere,
+      BlueprintGetter = GetFarFieldMaterial,
+      BlueprintSetter = SetFarFieldMaterial,
+      Category = "Cesium|Far Field")
+  UMaterialInterface* FarFieldMaterial = nullptr;
+
   UPROPERTY(
       EditAnywhere,
       BlueprintGetter = GetCustomDepthParameters,
@@ -624,26 +1716,184 @@ public:
   UFUNCTION(BlueprintGetter, Category = "Cesium")
   FString GetIonAssetEndpointUrl() const { return IonAssetEndpointUrl; }
 
-  UFUNCTION(BlueprintSetter, Category = "Cesium")
-  void SetIonAssetEndpointUrl(const FString& InIonAssetEndpointUrl);
+  UFUNCTION(BlueprintSetter, Category = "Cesium")
+  void SetIonAssetEndpointUrl(const FString& InIonAssetEndpointUrl);
+
+  UFUNCTION(BlueprintGetter, Category = "Cesium")
+  bool GetShareTileset() const { return ShareTileset; }
+
+  UFUNCTION(BlueprintSetter, Category = "Cesium")
+  void SetShareTileset(bool bShareTileset);
+
+  UFUNCTION(BlueprintGetter, Category = "Cesium|Physics")
+  bool GetCreatePhysicsMeshes() const { return CreatePhysicsMeshes; }
+
+  UFUNCTION(BlueprintSetter, Category = "Cesium|Physics")
+  void SetCreatePhysicsMeshes(bool bCreatePhysicsMeshes);
+
+  UFUNCTION(BlueprintGetter, Category = "Cesium|Physics")
+  bool GetCollisionOnly() const { return CollisionOnly; }
+
+  UFUNCTION(BlueprintSetter, Category = "Cesium|Physics")
+  void SetCollisionOnly(bool bCollisionOnly);
+
+  UFUNCTION(BlueprintGetter, Category = "Cesium|Physics")
+  float GetCollisionOnlyViewportSize() const {
+    return CollisionOnlyViewportSize;
+  }
+
+  UFUNCTION(BlueprintSetter, Category = "Cesium|Physics")
+  void SetCollisionOnlyViewportSize(float InCollisionOnlyViewportSize);
+
+  UFUNCTION(BlueprintGetter, Category = "Cesium|Physics")
+  float GetCollisionRadius() const { return CollisionRadius; }
+
+  UFUNCTION(BlueprintSetter, Category = "Cesium|Physics")
+  void SetCollisionRadius(float InCollisionRadius);
+
+  UFUNCTION(BlueprintGetter, Category = "Cesium|Physics")
+  float GetCollisionSimplificationError() const {
+    return CollisionSimplificationError;
+  }
+
+  UFUNCTION(BlueprintSetter, Category = "Cesium|Physics")
+  void SetCollisionSimplificationError(float InCollisionSimplificationError);
+
+  /**
+   * Adds an actor, such as a projectile or an AI-controlled vehicle, around
+   * which the physics meshes of tiles are created when CollisionRadius is
+   * greater than zero. The pawns of player controllers are always used and
+   * do not need to be added.
+   */
+  UFUNCTION(BlueprintCallable, Category = "Cesium|Physics")
+  void AddCollisionSource(AActor* Actor);
+
+  /**
+   * Removes an actor added with AddCollisionSource.
+   */
+  UFUNCTION(BlueprintCallable, Category = "Cesium|Physics")
+  void RemoveCollisionSource(AActor* Actor);
+
+  UFUNCTION(BlueprintGetter, Category = "Cesium|Rendering")
+  bool GetAlwaysIncludeTangents() const { return AlwaysIncludeTangents; }
+
+  UFUNCTION(BlueprintSetter, Category = "Cesium|Rendering")
+  void SetAlwaysIncludeTangents(bool bAlwaysIncludeTangents);
+
+  UFUNCTION(BlueprintGetter, Category = "Cesium|Rendering")
+  bool GetHighPrecisionVertexAttributes() const {
+    return HighPrecisionVertexAttributes;
+  }
+
+  UFUNCTION(BlueprintSetter, Category = "Cesium|Rendering")
+  void SetHighPrecisionVertexAttributes(bool bHighPrecisionVertexAttributes);
+
+  UFUNCTION(BlueprintGetter, Category = "Cesium|Rendering")
+  bool GetGenerateSmoothNormals() const { return GenerateSmoothNormals; }
+
+  UFUNCTION(BlueprintSetter, Category = "Cesium|Rendering")
+  void SetGenerateSmoothNormals(bool bGenerateSmoothNormals);
+
+  UFUNCTION(BlueprintGetter, Category = "Cesium|Rendering")
+  bool GetComputeFlatNormalsInMaterial() const {
+    return ComputeFlatNormalsInMaterial;
+  }
+
+  UFUNCTION(BlueprintSetter, Category = "Cesium|Rendering")
+  void SetComputeFlatNormalsInMaterial(bool bComputeFlatNormalsInMaterial);
+
+  UFUNCTION(BlueprintGetter, Category = "Cesium|Rendering")
+  bool GetOptimizeMeshes() const { return OptimizeMeshes; }
+
+  UFUNCTION(BlueprintSetter, Category = "Cesium|Rendering")
+  void SetOptimizeMeshes(bool bOptimizeMeshes);
+
+  UFUNCTION(BlueprintGetter, Category = "Cesium|Rendering")
+  bool GetMergePrimitives() const { return MergePrimitives; }
+
+  UFUNCTION(BlueprintSetter, Category = "Cesium|Rendering")
+  void SetMergePrimitives(bool bMergePrimitives);
+
+  UFUNCTION(BlueprintGetter, Category = "Cesium|Rendering")
+  bool GetBuildNaniteMeshes() const { return BuildNaniteMeshes; }
+
+  UFUNCTION(BlueprintSetter, Category = "Cesium|Rendering")
+  void SetBuildNaniteMeshes(bool bBuildNaniteMeshes);
+
+  UFUNCTION(BlueprintGetter, Category = "Cesium|Rendering")
+  bool GetUseBatchedRendering() const { return UseBatchedRendering; }
+
+  UFUNCTION(BlueprintSetter, Category = "Cesium|Rendering")
+  void SetUseBatchedRendering(bool bUseBatchedRendering);
+
+  UFUNCTION(BlueprintGetter, Category = "Cesium|Rendering")
+  bool GetRenderTerrainAsHeightfields() const {
+    return RenderTerrainAsHeightfields;
+  }
+
+  UFUNCTION(BlueprintSetter, Category = "Cesium|Rendering")
+  void SetRenderTerrainAsHeightfields(bool bRenderTerrainAsHeightfields);
+
+  UFUNCTION(BlueprintGetter, Category = "Cesium|Rendering")
+  bool GetStreamTileTextures() const { return StreamTileTextures; }
+
+  UFUNCTION(BlueprintSetter, Category = "Cesium|Rendering")
+  void SetStreamTileTextures(bool bStreamTileTextures);
+
+  UFUNCTION(BlueprintGetter, Category = "Cesium|Rendering")
+  int32 GetMaximumTextureSize() const { return MaximumTextureSize; }
+
+  UFUNCTION(BlueprintSetter, Category = "Cesium|Rendering")
+  void SetMaximumTextureSize(int32 InMaximumTextureSize);
+
+  UFUNCTION(BlueprintGetter, Category = "Cesium|Rendering")
+  const TArray<FString>& GetMetadataTextureProperties() const {
+    return MetadataTextureProperties;
+  }
+
+  UFUNCTION(BlueprintSetter, Category = "Cesium|Rendering")
+  void SetMetadataTextureProperties(const TArray<FString>& Properties);
+
+  UFUNCTION(BlueprintGetter, Category = "Cesium|Metadata")
+  bool GetEnableFeatureIndex() const { return EnableFeatureIndex; }
+
+  UFUNCTION(BlueprintSetter, Category = "Cesium|Metadata")
+  void SetEnableFeatureIndex(bool bEnableFeatureIndex);
+
+  UFUNCTION(BlueprintGetter, Category = "Cesium|Queries")
+  bool GetEnableGeometryQueries() const { return EnableGeometryQueries; }
+
+  UFUNCTION(BlueprintSetter, Category = "Cesium|Queries")
+  void SetEnableGeometryQueries(bool bEnableGeometryQueries);
+
+  UFUNCTION(BlueprintGetter, Category = "Cesium|Rendering")
+  bool GetEnableMeshDistanceFields() const { return EnableMeshDistanceFields; }
+
+  UFUNCTION(BlueprintSetter, Category = "Cesium|Rendering")
+  void SetEnableMeshDistanceFields(bool bEnableMeshDistanceFields);
 
-  UFUNCTION(BlueprintGetter, Category = "Cesium|Physics")
-  bool GetCreatePhysicsMeshes() const { return CreatePhysicsMeshes; }
+  UFUNCTION(BlueprintGetter, Category = "Cesium|Rendering")
+  float GetMeshDistanceFieldRadius() const { return MeshDistanceFieldRadius; }
 
-  UFUNCTION(BlueprintSetter, Category = "Cesium|Physics")
-  void SetCreatePhysicsMeshes(bool bCreatePhysicsMeshes);
+  UFUNCTION(BlueprintSetter, Category = "Cesium|Rendering")
+  void SetMeshDistanceFieldRadius(float InMeshDistanceFieldRadius);
 
   UFUNCTION(BlueprintGetter, Category = "Cesium|Rendering")
-  bool GetAlwaysIncludeTangents() const { return AlwaysIncludeTangents; }
+  int32 GetMeshDistanceFieldResolution() const {
+    return MeshDistanceFieldResolution;
+  }
 
   UFUNCTION(BlueprintSetter, Category = "Cesium|Rendering")
-  void SetAlwaysIncludeTangents(bool bAlwaysIncludeTangents);
+  void SetMeshDistanceFieldResolution(int32 InMeshDistanceFieldResolution);
 
   UFUNCTION(BlueprintGetter, Category = "Cesium|Rendering")
-  bool GetGenerateSmoothNormals() const { return GenerateSmoothNormals; }
+  int32 GetMaximumMeshDistanceFieldBuildsPerFrame() const {
+    return MaximumMeshDistanceFieldBuildsPerFrame;
+  }
 
   UFUNCTION(BlueprintSetter, Category = "Cesium|Rendering")
-  void SetGenerateSmoothNormals(bool bGenerateSmoothNormals);
+  void SetMaximumMeshDistanceFieldBuildsPerFrame(
+      int32 InMaximumMeshDistanceFieldBuildsPerFrame);
 
   UFUNCTION(BlueprintGetter, Category = "Cesium|Rendering")
   bool GetEnableWaterMask() const { return EnableWaterMask; }
@@ -651,6 +1901,12 @@ public:
   UFUNCTION(BlueprintSetter, Category = "Cesium|Rendering")
   void SetEnableWaterMask(bool bEnableMask);
 
+  UFUNCTION(BlueprintGetter, Category = "Cesium|Rendering")
+  bool GetPackWaterMasks() const { return PackWaterMasks; }
+
+  UFUNCTION(BlueprintSetter, Category = "Cesium|Rendering")
+  void SetPackWaterMasks(bool bPackWaterMasks);
+
   UFUNCTION(BlueprintGetter, Category = "Cesium|Rendering")
   UMaterialInterface* GetMaterial() const { return Material; }
 
@@ -663,6 +1919,84 @@ public:
   UFUNCTION(BlueprintSetter, Category = "Cesium|Rendering")
   void SetWaterMaterial(UMaterialInterface* InMaterial);
 
+  UFUNCTION(BlueprintGetter, Category = "Cesium|Rendering")
+  float GetMaximumShadowDistance() const { return MaximumShadowDistance; }
+
+  UFUNCTION(BlueprintSetter, Category = "Cesium|Rendering")
+  void SetMaximumShadowDistance(float InMaximumShadowDistance);
+
+  UFUNCTION(BlueprintGetter, Category = "Cesium|Rendering")
+  float GetMaximumShadowGeometricError() const {
+    return MaximumShadowGeometricError;
+  }
+
+  UFUNCTION(BlueprintSetter, Category = "Cesium|Rendering")
+  void SetMaximumShadowGeometricError(float InMaximumShadowGeometricError);
+
+  UFUNCTION(BlueprintGetter, Category = "Cesium|Rendering")
+  float GetMaximumRayTracingDistance() const {
+    return MaximumRayTracingDistance;
+  }
+
+  UFUNCTION(BlueprintSetter, Category = "Cesium|Rendering")
+  void SetMaximumRayTracingDistance(float InMaximumRayTracingDistance);
+
+  UFUNCTION(BlueprintGetter, Category = "Cesium|Rendering")
+  float GetMaximumRayTracingGeometricError() const {
+    return MaximumRayTracingGeometricError;
+  }
+
+  UFUNCTION(BlueprintSetter, Category = "Cesium|Rendering")
+  void SetMaximumRayTracingGeometricError(
+      float InMaximumRayTracingGeometricError);
+
+  UFUNCTION(BlueprintGetter, Category = "Cesium|Rendering")
+  int32 GetMaximumRayTracingTilesPerFrame() const {
+    return MaximumRayTracingTilesPerFrame;
+  }
+
+  UFUNCTION(BlueprintSetter, Category = "Cesium|Rendering")
+  void SetMaximumRayTracingTilesPerFrame(
+      int32 InMaximumRayTracingTilesPerFrame);
+
+  UFUNCTION(BlueprintGetter, Category = "Cesium|Rendering")
+  float GetTileCullDistanceScale() const { return TileCullDistanceScale; }
+
+  UFUNCTION(BlueprintSetter, Category = "Cesium|Rendering")
+  void SetTileCullDistanceScale(float InTileCullDistanceScale);
+
+  UFUNCTION(BlueprintGetter, Category = "Cesium|Far Field")
+  float GetFarFieldSimplificationError() const {
+    return FarFieldSimplificationError;
+  }
+
+  UFUNCTION(BlueprintSetter, Category = "Cesium|Far Field")
+  void SetFarFieldSimplificationError(float InFarFieldSimplificationError);
+
+  UFUNCTION(BlueprintGetter, Category = "Cesium|Far Field")
+  float GetFarFieldDistance() const { return FarFieldDistance; }
+
+  UFUNCTION(BlueprintSetter, Category = "Cesium|Far Field")
+  void SetFarFieldDistance(float InFarFieldDistance);
+
+  UFUNCTION(BlueprintGetter, Category = "Cesium|Far Field")
+  float GetFarFieldGeometricError() const { return FarFieldGeometricError; }
+
+  UFUNCTION(BlueprintSetter, Category = "Cesium|Far Field")
+  void SetFarFieldGeometricError(float InFarFieldGeometricError);
+
+  UFUNCTION(BlueprintGetter, Category = "Cesium|Far Field")
+  float GetFarFieldUpdateInterval() const { return FarFieldUpdateInterval; }
+
+  UFUNCTION(BlueprintSetter, Category = "Cesium|Far Field")
+  void SetFarFieldUpdateInterval(float InFarFieldUpdateInterval);
+
+  UFUNCTION(BlueprintGetter, Category = "Cesium|Far Field")
+  UMaterialInterface* GetFarFieldMaterial() const { return FarFieldMaterial; }
+
+  UFUNCTION(BlueprintSetter, Category = "Cesium|Far Field")
+  void SetFarFieldMaterial(UMaterialInterface* InMaterial);
+
   UFUNCTION(BlueprintGetter, Category = "Rendering")
   FCustomDepthParameters GetCustomDepthParameters() const {
     return CustomDepthParameters;
@@ -671,6 +2005,114 @@ public:
   UFUNCTION(BlueprintSetter, Category = "Rendering")
   void SetCustomDepthParameters(FCustomDepthParameters InCustomDepthParameters);
 
+  /**
+   * Gets the memory used by the Unreal Engine objects created for the tiles
+   * that are currently loaded, including their raster overlay textures.
+   */
+  UFUNCTION(BlueprintCallable, Category = "Cesium|Tile Loading")
+  FCesiumTilesetMemoryStatistics GetMemoryStatistics() const;
+
+  /**
+   * Gets the percentage, from 0 to 100, of the tiles needed for the current
+   * views that were loaded as of the last tile selection.
+   */
+  UFUNCTION(BlueprintCallable, Category = "Cesium|Tile Loading")
+  float GetLoadProgress() const;
+
+  /**
+   * Whether all tiles needed for the current views, including the raster
+   * overlay tiles draped over them, were loaded as of the last tile
+   * selection.
+   */
+  UFUNCTION(BlueprintCallable, Category = "Cesium|Tile Loading")
+  bool IsLoadComplete() const;
+
+  /**
+   * Gets the number of tiles selected for rendering in the current views as
+   * of the last tile selection.
+   */
+  UFUNCTION(BlueprintCallable, Category = "Cesium|Tile Loading")
+  int32 GetNumberOfTilesRendered() const;
+
+  /**
+   * Gets the number of tiles whose content is currently loaded.
+   */
+  UFUNCTION(BlueprintCallable, Category = "Cesium|Tile Loading")
+  int32 GetNumberOfTilesLoaded() const;
+
+  /**
+   * Gets the components that draw the tiles selected for rendering as of the
+   * last tile selection, such as to bake them into static mesh assets.
+   *
+   * Point clouds and heightfields are left out, because they aren't drawn
+   * from the vertices of their static meshes.
+   */
+  void GetRenderedTileMeshComponents(
+      TArray<UStaticMeshComponent*>& OutComponents) const;
+
+  /**
+   * Finds the features of the visible tiles whose bounds touch the given
+   * sphere, in Unreal world coordinates. EnableFeatureIndex must be true.
+   */
+  UFUNCTION(BlueprintCallable, Category = "Cesium|Metadata")
+  TArray<FCesiumFeatureHandle>
+  FindFeaturesInSphere(const FVector& Center, float Radius) const;
+
+  /**
+   * Finds the features of the visible tiles whose bounds touch the given
+   * box, in Unreal world coordinates. EnableFeatureIndex must be true.
+   */
+  UFUNCTION(BlueprintCallable, Category = "Cesium|Metadata")
+  TArray<FCesiumFeatureHandle> FindFeaturesInBox(const FBox& Box) const;
+
+  /**
+   * Finds the features of the visible tiles whose bounds are centered inside
+   * the given cartographic polygon. EnableFeatureIndex must be true.
+   */
+  UFUNCTION(BlueprintCallable, Category = "Cesium|Metadata")
+  TArray<FCesiumFeatureHandle>
+  FindFeaturesInPolygon(ACesiumCartographicPolygon* Polygon);
+
+  /**
+   * Finds the features of the visible tiles whose bounds touch the segment
+   * from Start to End, in Unreal world coordinates, nearest to Start first.
+   * EnableFeatureIndex must be true.
+   */
+  UFUNCTION(BlueprintCallable, Category = "Cesium|Metadata")
+  TArray<FCesiumFeatureHandle>
+  FindFeaturesAlongRay(const FVector& Start, const FVector& End) const;
+
+  /**
+   * Casts a ray from each of Starts to the End with the same index, in Unreal
+   * world coordinates, against the geometry of the visible tiles.
+   * EnableGeometryQueries must be true.
+   *
+   * The rays are cast on worker threads, against the tiles that are visible
+   * when this is called, and OnComplete is called on the game thread with the
+   * nearest hit of each ray once they are all cast.
+   */
+  UFUNCTION(BlueprintCallable, Category = "Cesium|Queries")
+  void RaycastBatch(
+      const TArray<FVector>& Starts,
+      const TArray<FVector>& Ends,
+      const FCesiumGeometryQueryDelegate& OnComplete);
+
+  /**
+   * Finds the surface of the visible tiles above or below each of the given
+   * Unreal world locations, by casting a ray down the ellipsoid normal
+   * through it, from MaximumDistance above it to MaximumDistance below it.
+   * EnableGeometryQueries must be true.
+   *
+   * Like RaycastBatch, the rays are cast on worker threads, and OnComplete is
+   * called on the game thread with a hit for each location, whose Height is
+   * its height above the ellipsoid.
+   */
+  UFUNCTION(BlueprintCallable, Category = "Cesium|Queries")
+  void SampleHeights(
+      const TArray<FVector>& Locations,
+      float MaximumDistance,
+      const FCesiumGeometryQueryDelegate& OnComplete);
+
   UFUNCTION(BlueprintCallable, Category = "Cesium|Rendering")
   void PlayMovieSequencer();
 
@@ -689,6 +2131,26 @@ public:
    */
   const glm::dmat4& GetCesiumTilesetToUnrealRelativeWorldTransform() const;
 
+  /**
+   * This method is not supposed to be called by clients. It is currently
+   * only required by the UnrealResourcePreparer, which calls it when it
+   * releases the decoded data of a tile, see ReleaseTileDataAfterLoad.
+   */
+  void NotifyTileDataReleased() { this->_tileDataReleased = true; }
+
+  /**
+   * Whether the decoded data of some of the loaded tiles was released, see
+   * ReleaseTileDataAfterLoad.
+   */
+  bool HasReleasedTileData() const { return this->_tileDataReleased; }
+
+  /**
+   * This method is not supposed to be called by clients. It is called by the
+   * raster overlays when they are added to or removed from the tileset, so
+   * that the next tile selection isn't skipped, see SkipUnchangedViewUpdates.
+   */
+  void NotifyRasterOverlaysChanged() { this->_viewUpdateNeeded = true; }
+
   Cesium3DTilesSelection::Tileset* GetTileset() { return this->_pTileset; }
   const Cesium3DTilesSelection::Tileset* GetTileset() const {
     return this->_pTileset;
@@ -742,7 +2204,170 @@ private:
 
   std::vector<FCesiumCamera> GetCameras() const;
   std::vector<FCesiumCamera> GetPlayerCameras() const;
-  std::vector<FCesiumCamera> GetSceneCaptures() const;
+
+  /**
+   * Gets a camera at the location of the pawn of each player controller, used
+   * to select tiles when CollisionOnly is enabled.
+   */
+  std::vector<FCesiumCamera> GetPawnCameras() const;
+
+  /**
+   * Gets the cameras that select tiles in every direction around the points
+   * of interest of the camera manager.
+   *
+   * @param includeRemotePlayers Whether to include the points of interest of
+   * remote players, which the pawn cameras already cover when CollisionOnly is
+   * enabled.
+   */
+  std::vector<FCesiumCamera>
+  GetPointOfInterestCameras(bool includeRemotePlayers) const;
+
+  /**
+   * Cooks the deferred physics meshes of the given tiles that are within the
+   * CollisionRadius of a collision source.
+   *
+   * @param tiles The tiles rendered in the current frame.
+   */
+  void cookDeferredCollision(
+      const std::vector<Cesium3DTilesSelection::Tile*>& tiles);
+
+  /**
+   * Casts rays against the hierarchies of the visible primitives on a worker
+   * thread, for RaycastBatch and SampleHeights.
+   *
+   * @param starts The start of each ray, in Unreal world coordinates.
+   * @param ends The end of each ray, in Unreal world coordinates.
+   * @param onComplete Called on the game thread with the nearest hit of each
+   * ray, as long as this tileset still exists.
+   */
+  void castGeometryQueryRays(
+      TArray<FVector>&& starts,
+      TArray<FVector>&& ends,
+      TFunction<void(TArray<FCesiumGeometryHit>&&)>&& onComplete);
+
+  /**
+   * Streams the texture mips of the given tiles for their size on the screens
+   * of the given cameras, when StreamTileTextures is enabled.
+   *
+   * @param tiles The tiles rendered in the current frame.
+   * @param cameras The cameras the tiles were selected for.
+   */
+  void updateTextureStreaming(
+      const std::vector<Cesium3DTilesSelection::Tile*>& tiles,
+      const std::vector<FCesiumCamera>& cameras);
+
+  /**
+   * Sets whether each of the given tiles casts shadows, according to the
+   * MaximumShadowDistance and MaximumShadowGeometricError.
+   *
+   * @param tiles The tiles rendered in the current frame.
+   * @param cameras The cameras the tiles were selected for.
+   */
+  void updateShadowCasting(
+      const std::vector<Cesium3DTilesSelection::Tile*>& tiles,
+      const std::vector<FCesiumCamera>& cameras);
+
+  /**
+   * Sets whether each of the given tiles is visible in ray tracing, according
+   * to the MaximumRayTracingDistance, letting at most
+   * MaximumRayTracingTilesPerFrame of them in, nearest first. Nothing is done
+   * if ray tracing is not enabled. The selection keeps running while tiles
+   * wait to be let in, see needsViewUpdate.
+   *
+   * @param tiles The tiles rendered in the current frame.
+   * @param cameras The cameras the tiles were selected for.
+   */
+  void updateRayTracing(
+      const std::vector<Cesium3DTilesSelection::Tile*>& tiles,
+      const std::vector<FCesiumCamera>& cameras);
+
+  /**
+   * Starts building the mesh distance fields of the given tiles that are
+   * within the MeshDistanceFieldRadius of a camera, nearest first, up to
+   * MaximumMeshDistanceFieldBuildsPerFrame of them. The selection keeps
+   * running while the budget runs out, see needsViewUpdate.
+   *
+   * @param tiles The tiles rendered in the current frame.
+   * @param cameras The cameras the tiles were selected for.
+   */
+  void buildDistanceFields(
+      const std::vector<Cesium3DTilesSelection::Tile*>& tiles,
+      const std::vector<FCesiumCamera>& cameras);
+
+  /**
+   * Sets the maximum draw distance of each of the given tiles from the
+   * geometric error of its parent, according to the TileCullDistanceScale.
+   *
+   * @param tiles The tiles rendered in the current frame.
+   * @param frustums The views the tiles were selected for.
+   */
+  void updateCullDistances(
+      const std::vector<Cesium3DTilesSelection::Tile*>& tiles,
+      const std::vector<Cesium3DTilesSelection::ViewState>& frustums);
+
+  /**
+   * Rebuilds the far-field proxy when the distant tiles among the given tiles
+   * have changed, and shows it in place of the tiles it draws once it is
+   * built. While the proxy does not draw exactly the rendered tiles it was
+   * built from, it is hidden and those tiles are shown.
+   *
+   * @param tiles The tiles rendered in the current frame.
+   * @param cameras The cameras the tiles were selected for.
+   */
+  void updateFarField(
+      const std::vector<Cesium3DTilesSelection::Tile*>& tiles,
+      const std::vector<FCesiumCamera>& cameras);
+
+  /**
+   * Hides the far-field proxy and discards it, and shows the tiles it drew.
+   * This must be called before those tiles are unloaded.
+   */
+  void resetFarField();
+
+  /**
+   * Gives the FarFieldMaterial to the far-field proxy that is already built,
+   * if any. The proxies built later use it from the start.
+   */
+  void updateFarFieldMaterial();
+
+  /**
+   * Draws the combinations of the materials of this tileset and the vertex
+   * layouts of tiles in front of the first camera for a few frames, the
+   * first time it is ticked in a game, when PrecachePipelineStates is
+   * enabled. See CesiumPipelinePrecache.
+   *
+   * @param cameras The cameras that tiles are selected for.
+   */
+  void updatePipelinePrecache(const std::vector<FCesiumCamera>& cameras);
+
+  /**
+   * Destroys the components that draw the combinations, if any, so that they
+   * are drawn again with the current materials in the next tick.
+   */
+  void resetPipelinePrecache();
+
+  /**
+   * Adds a predicted camera for each of the given cameras, extrapolated by
+   * its velocity over the PredictiveLoadingTime.
+   *
+   * The velocity of each camera is estimated from its location in the
+   * previous frame, so this must be called once per frame.
+   *
+   * @param cameras The cameras of the current frame.
+   * @param deltaTime The time since the previous frame, in seconds.
+   */
+  void
+  AddPredictedCameras(std::vector<FCesiumCamera>& cameras, float deltaTime);
+
+  /**
+   * Gets the upcoming views of the Level Sequences that are playing, for the
+   * SequencerPreloadTime.
+   *
+   * @param cameras The cameras of the current frame, the first of which
+   * gives the viewport and the level of detail of the upcoming views.
+   */
+  std::vector<FCesiumCamera>
+  getSequencerPreloadCameras(const std::vector<FCesiumCamera>& cameras) const;
 
 public:
   /**
@@ -762,6 +2387,18 @@ private:
    */
   void updateTilesetOptionsFromProperties();
 
+  /**
+   * Adds or removes the occlusion excluder in the given options, according
+   * to EnableOcclusionCulling, and prepares it for the next traversal.
+   */
+  void updateOcclusionExcluder(Cesium3DTilesSelection::TilesetOptions& options);
+
+  /**
+   * Updates the load progress and completeness returned by GetLoadProgress
+   * and IsLoadComplete from the result of the last tile selection.
+   */
+  void updateLoadState(const Cesium3DTilesSelection::ViewUpdateResult& result);
+
   /**
    * Update all the "_last..." fields of this instance based
    * on the given ViewUpdateResult, printing a log message
@@ -781,6 +2418,83 @@ private:
   void
   showTilesToRender(const std::vector<Cesium3DTilesSelection::Tile*>& tiles);
 
+  /**
+   * Applies the result of a tile selection to the Unreal scene, by hiding the
+   * tiles that are no longer rendered and showing the tiles that are.
+   *
+   * With LodHysteresis or MinimumTileResidency, some of the tiles that were
+   * rendered in the last frame may be kept instead of the ancestors or
+   * descendants that the selection replaced them with.
+   *
+   * @param result The result of the selection for the current frame.
+   * @param frustums The views the tiles were selected for.
+   * @return The tiles that are rendered in the current frame.
+   */
+  const std::vector<Cesium3DTilesSelection::Tile*>& applyViewUpdateResult(
+      const Cesium3DTilesSelection::ViewUpdateResult& result,
+      const std::vector<Cesium3DTilesSelection::ViewState>& frustums);
+
+  /**
+   * Computes the tiles to render from the tiles selected in the current
+   * frame and the tiles rendered in the last frame, according to
+   * LodHysteresis and MinimumTileResidency.
+   */
+  std::vector<Cesium3DTilesSelection::Tile*> selectTilesToRender(
+      const std::vector<Cesium3DTilesSelection::Tile*>& selectedTiles,
+      const std::vector<Cesium3DTilesSelection::Tile*>& previousTiles,
+      const std::vector<Cesium3DTilesSelection::ViewState>& frustums) const;
+
+  /**
+   * Checks whether the rendered tiles meet the BaseScreenSpaceError, so that
+   * levels of detail may be skipped in the next frame. Tiles that are not
+   * loaded yet are left out, and nothing meets it if no tile is loaded.
+   */
+  bool isBaseLevelOfDetailLoaded(
+      const std::vector<Cesium3DTilesSelection::Tile*>& tiles,
+      const std::vector<Cesium3DTilesSelection::ViewState>& frustums) const;
+
+  /**
+   * Gets the scheduler that shares a tile loading budget among the tilesets
+   * in this tileset's world.
+   */
+  UCesiumTileLoadScheduler* GetTileLoadScheduler() const;
+
+  /**
+   * Checks whether memory is low, and empties the pools of reusable objects
+   * when it has just become low. While it is low, the caches of the tileset
+   * and its raster overlays are shrunk, and streamed textures keep fewer
+   * mips.
+   */
+  void updateMemoryPressure();
+
+  /**
+   * Adapts the maximum screen-space error to the measured frame time, when
+   * AdaptScreenSpaceError is enabled.
+   */
+  void updateScreenSpaceErrorController();
+
+  /**
+   * Chooses the quality tier of the raster overlays that have
+   * AdaptQualityTier enabled, from the memory used by the overlay textures,
+   * memory pressure, and the adapted screen-space error.
+   */
+  void updateRasterOverlayQuality();
+
+  /**
+   * Adapts the number of simultaneous tile loads to the measured request and
+   * load thread throughput, when AdaptSimultaneousTileLoads is enabled. The
+   * new number is used from the next frame on.
+   */
+  void updateTileLoadController(
+      const Cesium3DTilesSelection::ViewUpdateResult& result);
+
+  /**
+   * Reports the loading demand of the given selection to the tile load
+   * scheduler, so that it can be taken into account in the next frame.
+   */
+  void reportTileLoadDemand(
+      const Cesium3DTilesSelection::ViewUpdateResult& result);
+
   /**
    * Will be called after the tileset is loaded or spawned, to register
    * a delegate that calls OnFocusEditorViewportOnThis when this
@@ -801,10 +2515,101 @@ private:
    * was given in the root tile.
    */
   void OnFocusEditorViewportOnThis();
+
+  /**
+   * Whether this tileset's updates are throttled, because
+   * ThrottleEditorUpdates is enabled and it is in an editor world.
+   */
+  bool isThrottlingEditorUpdates() const;
 #endif
 
+  /**
+   * The properties that can only be applied by loading the tileset again.
+   * The others are applied in place to the tiles that are already loaded.
+   */
+  static const TArray<FName>& GetReloadPropertyNames();
+
+  /**
+   * Gets the values of the properties in GetReloadPropertyNames as text, so
+   * that PostEditUndo can tell whether any of them changed, and so that
+   * tilesets can tell whether they may share their tiles.
+   */
+  FString GetReloadPropertiesSignature() const;
+
+  /**
+   * Gets the text that tilesets with ShareTileset must have in common to
+   * share their tiles, apart from their transforms.
+   */
+  FString getShareKey() const;
+
+  /**
+   * The tileset that loads the tiles for this one, if this one shares them
+   * with it and they are still compatible, or nullptr.
+   */
+  const ACesium3DTileset* getSharedTileset() const;
+
+  /**
+   * Whether the tile selection has to run again, because a camera, a
+   * selection option, a raster overlay, a tile excluder or the transform of
+   * the tileset changed since the last selection, or because tiles are still
+   * loading or being created, or work on them is waiting for the budget of
+   * later frames. Records the given views for the next call.
+   */
+  bool needsViewUpdate(
+      const std::vector<FCesiumCamera>& cameras,
+      const glm::dmat4& unrealWorldToTileset);
+
+  /**
+   * Adds the credits of the last tile selection to the current frame of the
+   * credit system, in a frame where the selection is skipped, so that they
+   * stay shown.
+   */
+  void addLastViewCredits();
+
+  /**
+   * Gets the transformation from Unreal world to the tileset, which is only
+   * inverted again when the tileset or the georeference moves.
+   */
+  const glm::dmat4& getUnrealWorldToTileset();
+
+  /**
+   * Applies Material and WaterMaterial to the tiles that are already loaded,
+   * or destroys the tileset if the material layers changed, so that it is
+   * loaded again with the new materials.
+   */
+  void UpdateTileMaterials();
+
+  /**
+   * Applies CustomDepthParameters to the tiles that are already loaded.
+   */
+  void UpdateTileCustomDepthParameters();
+
+  /**
+   * Creates the pending primitives of recently loaded tiles, within the
+   * MainThreadLoadingTimeLimit.
+   *
+   * @param frustums The views used to prioritize the tiles closest to a
+   * camera.
+   */
+  void createPendingTilePrimitives(
+      const std::vector<Cesium3DTilesSelection::ViewState>& frustums);
+
 private:
   Cesium3DTilesSelection::Tileset* _pTileset;
+  std::shared_ptr<UnrealResourcePreparer> _pResourcePreparer;
+  std::shared_ptr<CesiumOcclusionTileExcluder> _pOcclusionExcluder;
+  std::shared_ptr<CesiumTileLoadController> _pTileLoadController;
+  std::shared_ptr<CesiumScreenSpaceErrorController>
+      _pScreenSpaceErrorController;
+  std::shared_ptr<CesiumFarFieldProxy> _pFarFieldProxy;
+
+  // Whether memory was low as of the last tick, see updateMemoryPressure.
+  bool _underMemoryPressure = false;
+
+  // The quality tier of adaptive raster overlays, see
+  // updateRasterOverlayQuality.
+  int32 _rasterOverlayQualityTier = 0;
+  double _lastRasterOverlayQualityChangeTime = -1.0;
 
   // For debug output
   uint32_t _lastTilesRendered;
@@ -817,8 +2622,27 @@ private:
   uint32_t _lastTilesCulled;
   uint32_t _lastMaxDepthVisited;
 
+  // The load state as of the last tile selection, see GetLoadProgress and
+  // IsLoadComplete.
+  float _lastLoadProgress;
+  bool _lastLoadComplete;
+  int32 _lastNumberOfTilesRendered;
+
   std::chrono::high_resolution_clock::time_point _startTime;
 
+  UPROPERTY(Transient)
+  TArray<TWeakObjectPtr<AActor>> _collisionSources;
+
+  // The Level Sequence actors in the world when play began, whose upcoming
+  // views are preloaded.
+  UPROPERTY(Transient)
+  TArray<TWeakObjectPtr<ALevelSequenceActor>> _levelSequenceActors;
+
+  // The camera locations of the previous frame, and the smoothed camera
+  // velocities, used for predictive loading.
+  std::vector<FVector> _previousCameraLocations;
+  std::vector<FVector> _cameraVelocities;
+
   bool _captureMovieMode;
   bool _beforeMoviePreloadAncestors;
   bool _beforeMoviePreloadSiblings;
@@ -838,4 +2662,111 @@ private:
   // Unreal Engine, then this field may be removed, and the
   // tilesToNoLongerRenderThisFrame may be hidden immediately.
   std::vector<Cesium3DTilesSelection::Tile*> _tilesToNoLongerRenderNextFrame;
+
+  // The tiles rendered in the last frame, and, when LodHysteresis or
+  // MinimumTileResidency are used, the world time at which each of them was
+  // shown.
+  std::vector<Cesium3DTilesSelection::Tile*> _renderedTiles;
+  std::unordered_map<const Cesium3DTilesSelection::Tile*, double>
+      _tileShownTimes;
+
+  // Whether the tiles rendered in the last frame met the base screen-space
+  // error, when SkipLevelOfDetail is used.
+  bool _baseLevelOfDetailLoaded = false;
+
+  // Whether the data of some loaded tiles was released, see
+  // HasReleasedTileData.
+  bool _tileDataReleased = false;
+
+  // The component that draws the far-field proxy, the tiles that it draws
+  // sorted by address, and the world time of the last rebuild. The tiles are
+  // hidden while the proxy is shown, see updateFarField.
+  UPROPERTY(Transient)
+  UStaticMeshComponent* _pFarFieldComponent = nullptr;
+  std::vector<const Cesium3DTilesSelection::Tile*> _farFieldTiles;
+  bool _farFieldShown = false;
+  double _lastFarFieldBuildTime = -1.0;
+
+  // The components that draw the combinations of materials and vertex
+  // layouts while the pipeline states are precached, and the number of
+  // frames left to draw them, or -1 if they haven't been drawn yet, see
+  // updatePipelinePrecache.
+  UPROPERTY(Transient)
+  TArray<UStaticMeshComponent*> _pipelinePrecacheComponents;
+  int32 _pipelinePrecacheFramesLeft = -1;
+
+  // The component that draws the batched primitives of the tiles, if
+  // UseBatchedRendering is true.
+  UPROPERTY(Transient)
+  UCesiumTileBatchComponent* _pTileBatch = nullptr;
+
+  // The getShareKey as of when this tileset started sharing its tiles, and
+  // the tileset that loads them, if it isn't this one.
+  FString _shareKey;
+  TWeakObjectPtr<ACesium3DTileset> _pSharedTileset;
+
+#if WITH_EDITOR
+  // The GetReloadPropertiesSignature as of when the tileset was loaded.
+  FString _reloadPropertiesSignature;
+
+  double _lastEditorUpdateTime = 0.0;
+#endif
+
+  /**
+   * The options of the tile selection that change from frame to frame
+   * without reloading the tileset, see needsViewUpdate.
+   */
+  struct ViewUpdateOptions {
+    double maximumScreenSpaceError = 0.0;
+    int64 maximumCachedBytes = 0;
+    int32 maximumSimultaneousTileLoads = 0;
+    int32 loadingDescendantLimit = 0;
+    double culledScreenSpaceError = 0.0;
+    bool preloadAncestors = false;
+    bool preloadSiblings = false;
+    bool forbidHoles = false;
+    bool enableFrustumCulling = false;
+    bool enableFogCulling = false;
+    bool enforceCulledScreenSpaceError = false;
+    bool captureMovieMode = false;
+    int32 rasterOverlayQualityTier = 0;
+
+    // The excluders are held weakly, so that one that was destroyed doesn't
+    // compare equal to a new one created at the same address.
+    std::vector<std::weak_ptr<Cesium3DTilesSelection::ITileExcluder>>
+        excluders;
+    std::vector<const Cesium3DTilesSelection::RasterOverlay*> overlays;
+
+    bool operator==(const ViewUpdateOptions& other) const;
+  };
+
+  // The state of the last tile selection, see needsViewUpdate.
+  bool _viewUpdateNeeded = true;
+  std::vector<FCesiumCamera> _lastViewCameras;
+  glm::dmat4 _lastViewUnrealWorldToTileset{1.0};
+  ViewUpdateOptions _lastViewOptions;
+  bool _lastViewLoadingLowPriority = false;
+
+  // The credits that the last tile selection added to the credit system,
+  // see addLastViewCredits.
+  std::vector<Cesium3DTilesSelection::Credit> _lastViewCredits;
+
+  // Whether updateRayTracing or buildDistanceFields left work for later
+  // frames because of their per-frame limits.
+  bool _rayTracingTilesPending = false;
+  bool _distanceFieldBuildsPending = false;
+  const Cesium3DTilesSelection::ViewUpdateResult* _pLastViewUpdateResult =
+      nullptr;
+
+  // The selection of a frame captured by the movie sequencer, which is kept
+  // apart from the one the tileset makes for the upcoming views afterward.
+  Cesium3DTilesSelection::ViewUpdateResult _capturedViewUpdateResult;
+
+  // The Unreal world to tileset transformation, see getUnrealWorldToTileset.
+  glm::dmat4 _tilesetToUnrealRelativeWorld{1.0};
+  glm::dmat4 _unrealWorldToTileset{1.0};
+
+  // The views of the tile selection, kept so that their capacity is reused
+  // from frame to frame.
+  std::vector<Cesium3DTilesSelection::ViewState> _frustums;
 };
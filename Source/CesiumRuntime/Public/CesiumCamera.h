@@ -55,6 +55,28 @@ public:
   UPROPERTY(BlueprintReadWrite, Category = "Cesium")
   float OverrideAspectRatio = 0.0f;
 
+  /**
+   * @brief The factor by which to scale the screen-space error of tiles in
+   * this view.
+   *
+   * Values below one select coarser tiles for this view, so that a secondary
+   * view, such as a minimap, needs fewer tiles and competes less with the
+   * main view for loading and memory. Values above one select finer tiles.
+   */
+  UPROPERTY(BlueprintReadWrite, Category = "Cesium")
+  float ScreenSpaceErrorScale = 1.0f;
+
+  /**
+   * @brief The largest viewport height, in pixels, that tiles are selected
+   * for in this view.
+   *
+   * A taller viewport selects tiles as if it were this tall, which keeps a
+   * high-resolution render target from requiring more detail than this. When
+   * this is 0.0f, the full viewport height is used.
+   */
+  UPROPERTY(BlueprintReadWrite, Category = "Cesium")
+  float MaximumViewportHeight = 0.0f;
+
   /**
    * @brief Construct an uninitialized FCesiumCamera object.
    */
@@ -3,11 +3,15 @@
 #pragma once
 
 #include "CesiumCamera.h"
+#include "CesiumPointOfInterest.h"
 #include "Containers/Map.h"
 #include "GameFramework/Actor.h"
+#include <vector>
 
 #include "CesiumCameraManager.generated.h"
 
+class USceneCaptureComponent2D;
+
 /**
  * @brief Manages custom {@link FCesiumCamera}s for all
  * {@link Cesium3DTileset}s in the world.
@@ -51,19 +55,226 @@ public:
   UFUNCTION(BlueprintCallable, Category = "Cesium")
   bool UpdateCamera(int32 CameraId, UPARAM(ref) const FCesiumCamera& Camera);
 
+  /**
+   * @brief Unregister the specified camera, so that it is no longer used for
+   * tile selection.
+   *
+   * @param CameraId The ID of the camera, as returned by AddCamera during
+   * registration.
+   * @return Whether the removal was successful. If false, the CameraId was
+   * invalid.
+   */
+  UFUNCTION(BlueprintCallable, Category = "Cesium")
+  bool RemoveCamera(int32 CameraId);
+
   /**
    * @brief Get a read-only map of the current camera IDs to cameras.
    */
   UFUNCTION(BlueprintCallable, Category = "Cesium")
   const TMap<int32, FCesiumCamera>& GetCameras() const;
 
+  /**
+   * @brief Whether tilesets select tiles only for the cameras registered with
+   * AddCamera, instead of also selecting them for the views of local players,
+   * editor viewports and scene captures.
+   *
+   * This makes the selection independent of the local views, so that several
+   * machines rendering one scene, such as the nodes of an nDisplay cluster,
+   * each select the same tiles when the frustums of all of them are
+   * registered on every one. Their levels of detail then match at the
+   * boundaries between their screens. Points of interest are still used.
+   */
+  UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Cesium")
+  bool UseOnlyRegisteredCameras = false;
+
+  /**
+   * @brief Whether to search the world for Scene Capture 2D actors each frame
+   * and use them for tile selection.
+   *
+   * When this is true, every perspective Scene Capture 2D actor with a render
+   * target is used in addition to any registered with AddSceneCapture. The
+   * search is done at most once per frame and shared by all tilesets. Set this
+   * to false in large levels to avoid the search entirely, and register the
+   * scene captures that should be used with AddSceneCapture instead.
+   */
+  UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Cesium")
+  bool SearchForSceneCaptures = true;
+
+  /**
+   * @brief The ScreenSpaceErrorScale of the cameras of scene captures.
+   *
+   * Values below one select coarser tiles for scene captures, so that they
+   * compete less with the player's view for loading and memory.
+   */
+  UPROPERTY(
+      EditAnywhere,
+      BlueprintReadWrite,
+      Category = "Cesium",
+      meta = (ClampMin = 0.0))
+  float SceneCaptureScreenSpaceErrorScale = 1.0f;
+
+  /**
+   * @brief The MaximumViewportHeight of the cameras of scene captures.
+   *
+   * When this is greater than zero, scene captures with taller render targets
+   * select tiles as if their render targets were this tall.
+   */
+  UPROPERTY(
+      EditAnywhere,
+      BlueprintReadWrite,
+      Category = "Cesium",
+      meta = (ClampMin = 0.0))
+  float SceneCaptureMaximumViewportHeight = 0.0f;
+
+  /**
+   * @brief Register a scene capture component whose view should be used by
+   * tilesets to select tiles.
+   *
+   * The component's location, rotation, field of view, and render target size
+   * are read each frame, so it only needs to be registered once. The
+   * component does not need to belong to a Scene Capture 2D actor.
+   *
+   * @param SceneCapture The scene capture component to register.
+   */
+  UFUNCTION(BlueprintCallable, Category = "Cesium")
+  void AddSceneCapture(USceneCaptureComponent2D* SceneCapture);
+
+  /**
+   * @brief Unregister a scene capture component previously registered with
+   * AddSceneCapture.
+   *
+   * @param SceneCapture The scene capture component to unregister.
+   * @return Whether the component was registered.
+   */
+  UFUNCTION(BlueprintCallable, Category = "Cesium")
+  bool RemoveSceneCapture(USceneCaptureComponent2D* SceneCapture);
+
+  /**
+   * @brief Gets the cameras for all scene captures that should be used for
+   * tile selection this frame.
+   *
+   * The list is computed once per frame and then reused, so that many
+   * tilesets can query it cheaply.
+   */
+  const std::vector<FCesiumCamera>& GetSceneCaptureCameras();
+
+  /**
+   * @brief Register a point of interest that tilesets should load tiles
+   * around in every direction.
+   *
+   * Points of interest are used, for example, on servers to load tiles, and
+   * cook their physics meshes, around actors that no local camera views.
+   *
+   * @param PointOfInterest The current state for the new point of interest.
+   * @return The generated ID for this point of interest. Use this ID to refer
+   * to the point of interest in the future when calling
+   * UpdatePointOfInterest.
+   */
+  UFUNCTION(BlueprintCallable, Category = "Cesium")
+  int32 AddPointOfInterest(
+      UPARAM(ref) const FCesiumPointOfInterest& PointOfInterest);
+
+  /**
+   * @brief Update the state of the specified point of interest.
+   *
+   * @param PointOfInterestId The ID of the point of interest, as returned by
+   * AddPointOfInterest during registration.
+   * @param PointOfInterest The new, updated state of the point of interest.
+   * @return Whether the updating was successful. If false, the
+   * PointOfInterestId was invalid.
+   */
+  UFUNCTION(BlueprintCallable, Category = "Cesium")
+  bool UpdatePointOfInterest(
+      int32 PointOfInterestId,
+      UPARAM(ref) const FCesiumPointOfInterest& PointOfInterest);
+
+  /**
+   * @brief Unregister the specified point of interest, so that it is no
+   * longer used for tile selection.
+   *
+   * @param PointOfInterestId The ID of the point of interest, as returned by
+   * AddPointOfInterest during registration.
+   * @return Whether the removal was successful. If false, the
+   * PointOfInterestId was invalid.
+   */
+  UFUNCTION(BlueprintCallable, Category = "Cesium")
+  bool RemovePointOfInterest(int32 PointOfInterestId);
+
+  /**
+   * @brief Get a read-only map of the current point of interest IDs to points
+   * of interest.
+   */
+  UFUNCTION(BlueprintCallable, Category = "Cesium")
+  const TMap<int32, FCesiumPointOfInterest>& GetPointsOfInterest() const;
+
+  /**
+   * @brief Whether the view targets of player controllers that are not local,
+   * such as those of the clients of a listen server, are used as points of
+   * interest.
+   *
+   * Tiles are otherwise only selected for the views of local players, so the
+   * tiles around remote players are never loaded on the server, and they have
+   * no collision there.
+   */
+  UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Cesium")
+  bool UseRemotePlayerViewTargets = false;
+
+  /**
+   * @brief The ScreenSpaceErrorScale of the points of interest of remote
+   * players.
+   */
+  UPROPERTY(
+      EditAnywhere,
+      BlueprintReadWrite,
+      Category = "Cesium",
+      meta = (ClampMin = 0.0, EditCondition = "UseRemotePlayerViewTargets"))
+  float RemotePlayerScreenSpaceErrorScale = 1.0f;
+
+  /**
+   * @brief The size, in pixels, of the square virtual viewports with a 90
+   * degree field of view that tiles are selected for around each point of
+   * interest. Larger values load more detailed tiles farther from the points.
+   */
+  UPROPERTY(
+      EditAnywhere,
+      BlueprintReadWrite,
+      Category = "Cesium",
+      meta = (ClampMin = 1.0))
+  float PointOfInterestViewportSize = 1024.0f;
+
+  /**
+   * @brief Gets the points of interest of the view targets of remote
+   * players, when UseRemotePlayerViewTargets is enabled.
+   *
+   * The list is computed once per frame and then reused, so that many
+   * tilesets can query it cheaply.
+   */
+  const std::vector<FCesiumPointOfInterest>& GetRemotePlayerPointsOfInterest();
+
   virtual bool ShouldTickIfViewportsOnly() const override;
 
   virtual void Tick(float DeltaTime) override;
 
 private:
+  void updateSceneCaptureCameras();
+  void updateRemotePlayerPointsOfInterest();
+
   int32 _currentCameraId = 0;
   TMap<int32, FCesiumCamera> _cameras;
 
+  int32 _currentPointOfInterestId = 0;
+  TMap<int32, FCesiumPointOfInterest> _pointsOfInterest;
+
+  std::vector<FCesiumPointOfInterest> _remotePlayerPointsOfInterest;
+  uint64 _remotePlayerPointsOfInterestFrame = 0;
+  bool _remotePlayerPointsOfInterestValid = false;
+
+  UPROPERTY(Transient)
+  TArray<TWeakObjectPtr<USceneCaptureComponent2D>> _sceneCaptures;
+
+  std::vector<FCesiumCamera> _sceneCaptureCameras;
+  uint64 _sceneCaptureCamerasFrame = 0;
+  bool _sceneCaptureCamerasValid = false;
+
   static FName DEFAULT_CAMERAMANAGER_TAG;
 };
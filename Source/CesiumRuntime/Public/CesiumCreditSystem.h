@@ -2,17 +2,24 @@
 
 #pragma once
 
+#include "Cesium3DTilesSelection/CreditSystem.h"
 #include "Engine/Blueprint.h"
 #include "GameFramework/Actor.h"
 #include "UObject/Class.h"
 #include "UObject/ConstructorHelpers.h"
 #include <memory>
+#include <vector>
 
 #include "CesiumCreditSystem.generated.h"
 
-namespace Cesium3DTilesSelection {
-class CreditSystem;
-}
+/**
+ * The delegate for the credit events of ACesiumCreditSystem, which receives
+ * the HTML of the credit that was added or removed.
+ */
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(
+    FCesiumCreditChanged,
+    const FString&,
+    Html);
 
 /**
  * Manages credits / atttribution for Cesium data sources. These credits
@@ -30,17 +37,47 @@ public:
   ACesiumCreditSystem();
 
   /**
-   * The credits text to display.
+   * The credits text to display, as a single HTML document listing all of
+   * CreditList. It is only built when GenerateCreditsHtml is true.
    */
   UPROPERTY(BlueprintReadOnly, Category = "Cesium")
   FString Credits = "";
 
   /**
-   * Whether the credit string has changed since last frame.
+   * Whether the credits have changed since last frame.
    */
   UPROPERTY(BlueprintReadOnly, Category = "Cesium")
   bool CreditsUpdated = false;
 
+  /**
+   * The HTML of each credit to display. A credit that is still shown keeps
+   * its place when others are added or removed, and new credits are added at
+   * the end, so a widget can update only the entries that changed, with
+   * OnCreditAdded and OnCreditRemoved.
+   */
+  UPROPERTY(BlueprintReadOnly, Category = "Cesium")
+  TArray<FString> CreditList;
+
+  /**
+   * Whether to build the Credits document when the credits change. Widgets
+   * that only use CreditList and the credit events can turn this off to
+   * skip building and parsing the whole document.
+   */
+  UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Cesium")
+  bool GenerateCreditsHtml = true;
+
+  /**
+   * Called when a credit is added to CreditList.
+   */
+  UPROPERTY(BlueprintAssignable, Category = "Cesium")
+  FCesiumCreditChanged OnCreditAdded;
+
+  /**
+   * Called when a credit is removed from CreditList.
+   */
+  UPROPERTY(BlueprintAssignable, Category = "Cesium")
+  FCesiumCreditChanged OnCreditRemoved;
+
   // Called every frame
   virtual bool ShouldTickIfViewportsOnly() const override;
   virtual void Tick(float DeltaTime) override;
@@ -62,5 +99,8 @@ private:
   // the underlying cesium-native credit system that is managed by this actor.
   std::shared_ptr<Cesium3DTilesSelection::CreditSystem> _pCreditSystem;
 
-  size_t _lastCreditsCount;
+  // The credit of each entry of CreditList.
+  std::vector<Cesium3DTilesSelection::Credit> _lastCredits;
+
+  void updateCreditsHtml();
 };
@@ -0,0 +1,39 @@
+// Copyright 2020-2021 CesiumGS, Inc. and Contributors
+
+#pragma once
+
+#include "Components/PrimitiveComponent.h"
+#include "CoreMinimal.h"
+#include "UObject/ObjectMacros.h"
+#include "CesiumFeatureHandle.generated.h"
+
+/**
+ * A feature of a loaded tile, as found by the feature queries of a
+ * Cesium3DTileset. The metadata of the feature can be read from the metadata
+ * of its primitive, see
+ * UCesiumMetadataUtilityBlueprintLibrary::GetPrimitiveMetadata.
+ */
+USTRUCT(BlueprintType)
+struct CESIUMRUNTIME_API FCesiumFeatureHandle {
+  GENERATED_USTRUCT_BODY()
+
+  /**
+   * The glTF primitive component that the feature is part of. It is null once
+   * the tile of the feature is unloaded.
+   */
+  UPROPERTY(BlueprintReadOnly, Category = "Cesium|Metadata")
+  TWeakObjectPtr<UPrimitiveComponent> Primitive;
+
+  /**
+   * The ID of the feature in the first feature table of the primitive.
+   */
+  UPROPERTY(BlueprintReadOnly, Category = "Cesium|Metadata")
+  int64 FeatureID = -1;
+
+  /**
+   * The bounds of the vertices of the feature in this primitive, in Unreal
+   * world coordinates, as of the query.
+   */
+  UPROPERTY(BlueprintReadOnly, Category = "Cesium|Metadata")
+  FBox Bounds = FBox(ForceInit);
+};
@@ -0,0 +1,217 @@
+// Copyright 2020-2021 CesiumGS, Inc. and Contributors
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include <vector>
+#include "CesiumFlyThroughBenchmark.generated.h"
+
+class ACesium3DTileset;
+class ACesiumGeoreference;
+class UCameraComponent;
+
+/**
+ * Replays a recorded camera path over a set of tilesets and writes the
+ * performance measured along the way, so that plugin versions and tileset
+ * settings can be compared.
+ *
+ * The path is a CSV file with one waypoint per line:
+ *
+ *   Time,Longitude,Latitude,Height,Heading,Pitch
+ *
+ * with the time in seconds since the start of the path, the location in
+ * degrees and meters above the WGS84 ellipsoid, and the heading from north
+ * and pitch above the horizon in degrees. Such a file is written by this
+ * actor when Record is enabled, from the view of the first player.
+ *
+ * When the path has been replayed, two files are written to the
+ * OutputDirectory: a CSV file with the frame time, game, render, and GPU
+ * thread times, Cesium game thread time, tiles loaded and rendered, bytes
+ * downloaded, and used memory of each frame, and a JSON file with a summary
+ * and the time each waypoint took to reach full detail.
+ *
+ * The path, output directory, deterministic mode, and pipeline cache
+ * recording can be set from the command line of a packaged or -game build
+ * with -CesiumBenchmarkPath=, -CesiumBenchmarkOutput=,
+ * -CesiumBenchmarkDeterministic, and -CesiumBenchmarkRecordPipelineCache,
+ * which also starts the benchmark and quits when it is done, for automated
+ * runs.
+ */
+UCLASS(ClassGroup = (Cesium))
+class CESIUMRUNTIME_API ACesiumFlyThroughBenchmark : public AActor {
+  GENERATED_BODY()
+
+public:
+  ACesiumFlyThroughBenchmark();
+
+  /**
+   * The camera that the path is replayed with. It becomes the view target of
+   * the first player while the benchmark runs.
+   */
+  UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Cesium")
+  UCameraComponent* Camera;
+
+  /**
+   * The CSV file of the camera path to replay, or to record into. A relative
+   * path is relative to the project directory.
+   */
+  UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Cesium")
+  FString PathFile;
+
+  /**
+   * The directory to write the results into. If this is empty, they are
+   * written into Saved/Cesium/Benchmark in the project directory.
+   */
+  UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Cesium")
+  FString OutputDirectory;
+
+  /**
+   * The tilesets to measure. If this is empty, all tilesets in the world are
+   * measured.
+   */
+  UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Cesium")
+  TArray<ACesium3DTileset*> Tilesets;
+
+  /**
+   * Whether to replay the path the same way in every run, for regression
+   * comparisons.
+   *
+   * The path is then advanced by a fixed time step per frame, and the
+   * tilesets load all of the tiles of each view before it is rendered, like
+   * when rendering a movie. The frame times then include the loading, and
+   * every frame shows the full detail.
+   */
+  UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Cesium")
+  bool Deterministic = false;
+
+  /**
+   * The time, in seconds, that the path is advanced by per frame in the
+   * Deterministic mode.
+   */
+  UPROPERTY(
+      EditAnywhere,
+      BlueprintReadWrite,
+      Category = "Cesium",
+      meta = (ClampMin = 0.001))
+  float FixedTimeStep = 1.0f / 30.0f;
+
+  /**
+   * Whether to start replaying the path when play begins.
+   */
+  UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Cesium")
+  bool AutoStart = false;
+
+  /**
+   * Whether to quit the game once the path has been replayed.
+   */
+  UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Cesium")
+  bool QuitWhenFinished = false;
+
+  /**
+   * Whether to record the view of the first player into the PathFile while
+   * playing, instead of replaying it. The file is written when play ends.
+   */
+  UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Cesium")
+  bool Record = false;
+
+  /**
+   * The time, in seconds, between two recorded waypoints.
+   */
+  UPROPERTY(
+      EditAnywhere,
+      BlueprintReadWrite,
+      Category = "Cesium",
+      meta = (ClampMin = 0.01))
+  float RecordInterval = 0.5f;
+
+  /**
+   * Whether to record the graphics pipeline states that are created while the
+   * path is replayed into the shader pipeline cache, so that they can be
+   * bundled with the game and created before the tiles need them.
+   *
+   * The game must be started with -logPSO, or r.ShaderPipelineCache.LogPSO
+   * must be enabled in its configuration. The recording is saved into
+   * Saved/CollectedPSOs when the benchmark finishes. To bundle it, expand it
+   * with the ShaderPipelineCacheTools commandlet together with the shader
+   * info of the cooked build, and place the result in
+   * Build/<Platform>/PipelineCaches in the project directory.
+   */
+  UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Cesium")
+  bool RecordPipelineCache = false;
+
+  /**
+   * Starts replaying the path from its beginning.
+   *
+   * @return Whether the path could be read.
+   */
+  UFUNCTION(BlueprintCallable, Category = "Cesium")
+  bool StartBenchmark();
+
+  /**
+   * Whether the path is being replayed.
+   */
+  UFUNCTION(BlueprintCallable, Category = "Cesium")
+  bool IsRunning() const { return this->_running; }
+
+  virtual void Tick(float DeltaTime) override;
+
+protected:
+  virtual void BeginPlay() override;
+  virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+private:
+  struct Waypoint {
+    double time;
+    double longitude;
+    double latitude;
+    double height;
+    double heading;
+    double pitch;
+  };
+
+  struct FrameSample {
+    double time;
+    double frameMilliseconds;
+    double gameThreadMilliseconds;
+    double renderThreadMilliseconds;
+    double gpuMilliseconds;
+    double cesiumMilliseconds;
+    int32 tilesLoaded;
+    int32 tilesRendered;
+    int64 bytesDownloaded;
+    uint64 usedPhysicalBytes;
+  };
+
+  ACesiumGeoreference* GetBenchmarkGeoreference() const;
+  TArray<ACesium3DTileset*> GetBenchmarkTilesets() const;
+  bool AreTilesetsLoaded() const;
+
+  void MoveCamera(double pathTime);
+  void RecordWaypoint(double time);
+  void SampleFrame();
+  void FinishBenchmark();
+  void WriteResults() const;
+
+  bool ReadPath();
+  bool WritePath() const;
+
+  std::vector<Waypoint> _waypoints;
+  std::vector<FrameSample> _samples;
+
+  // The wall time at which each waypoint was reached, and the time its views
+  // took to reach full detail from then, or -1 if they did not before the
+  // next waypoint.
+  std::vector<double> _waypointReachedTimes;
+  std::vector<double> _timesToFullDetail;
+
+  bool _running = false;
+  bool _quitWhenFinished = false;
+  double _pathTime = 0.0;
+  double _startTime = 0.0;
+  double _lastRecordTime = -1.0;
+  double _lastFrameTime = 0.0;
+  double _lastCesiumSeconds = 0.0;
+  int64 _lastBytesDownloaded = 0;
+  size_t _nextWaypoint = 0;
+};
@@ -0,0 +1,62 @@
+// Copyright 2020-2021 CesiumGS, Inc. and Contributors
+
+#pragma once
+
+#include "Containers/Array.h"
+#include "Math/Vector.h"
+#include "UObject/ObjectMacros.h"
+
+#include "CesiumGeometryHit.generated.h"
+
+/**
+ * @brief The result of casting one ray of a geometry query of a
+ * {@link Cesium3DTileset} against the geometry of its tiles.
+ */
+USTRUCT(BlueprintType)
+struct CESIUMRUNTIME_API FCesiumGeometryHit {
+  GENERATED_USTRUCT_BODY()
+
+public:
+  /**
+   * @brief Whether the ray hit a tile. If not, the other members are not
+   * set.
+   */
+  UPROPERTY(BlueprintReadOnly, Category = "Cesium")
+  bool bBlockingHit = false;
+
+  /**
+   * @brief The Unreal world location of the hit.
+   */
+  UPROPERTY(BlueprintReadOnly, Category = "Cesium")
+  FVector Location = FVector::ZeroVector;
+
+  /**
+   * @brief The unit normal of the triangle that was hit, in Unreal world
+   * coordinates, facing the start of the ray.
+   */
+  UPROPERTY(BlueprintReadOnly, Category = "Cesium")
+  FVector Normal = FVector::ZeroVector;
+
+  /**
+   * @brief The distance from the start of the ray to the hit, in Unreal
+   * units.
+   */
+  UPROPERTY(BlueprintReadOnly, Category = "Cesium")
+  float Distance = 0.0f;
+
+  /**
+   * @brief The height of the hit above the WGS84 ellipsoid, in meters. This
+   * is only set by SampleHeights.
+   */
+  UPROPERTY(BlueprintReadOnly, Category = "Cesium")
+  float Height = 0.0f;
+};
+
+/**
+ * The delegate that receives the results of a geometry query of a
+ * {@link Cesium3DTileset}, one for each of its rays, in the same order.
+ */
+DECLARE_DYNAMIC_DELEGATE_OneParam(
+    FCesiumGeometryQueryDelegate,
+    const TArray<FCesiumGeometryHit>&,
+    Hits);
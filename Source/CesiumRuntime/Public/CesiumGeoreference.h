@@ -10,7 +10,10 @@
 #include "GeoTransforms.h"
 #include "OriginPlacement.h"
 #include "UObject/WeakInterfacePtr.h"
+#include <atomic>
 #include <glm/mat3x3.hpp>
+#include <mutex>
+#include <vector>
 #include "CesiumGeoreference.generated.h"
 
 class APlayerCameraManager;
@@ -22,6 +25,14 @@ class FLevelCollectionModel;
  */
 DECLARE_DYNAMIC_MULTICAST_DELEGATE(FGeoreferenceUpdated);
 
+/**
+ * The delegate for the ACesiumGeoreference::OnGeoTransformsChanged, which is
+ * triggered from UpdateGeoreference with the new snapshot.
+ */
+DECLARE_MULTICAST_DELEGATE_OneParam(
+    FGeoTransformsChanged,
+    const GeoTransformsSnapshot&);
+
 /**
  * Controls how global geospatial coordinates are mapped to coordinates in the
  * Unreal Engine level. Internally, Cesium uses a global Earth-centered,
@@ -72,6 +83,21 @@ public:
   UPROPERTY(EditAnywhere, Category = "CesiumSublevels")
   bool ShowLoadRadii = true;
 
+  /*
+   * How far in meters beyond a sub-level's LoadRadius the camera may be for
+   * the level to start loading in the background. The level is only shown
+   * once the camera is within its LoadRadius, but by then it has usually
+   * finished loading, so switching to it doesn't wait on level streaming.
+   *
+   * Prefetched levels use memory while they are loaded. Zero disables
+   * prefetching.
+   */
+  UPROPERTY(
+      EditAnywhere,
+      Category = "CesiumSublevels",
+      meta = (ClampMin = 0.0))
+  double SubLevelPrefetchDistance = 0.0;
+
   /*
    * Switches to the specified level. Sets the georeference origin to the given
    * level's origin, shows the given level, and hides all other levels.
@@ -79,6 +105,9 @@ public:
    * If Index is negative or otherwise outside the range of valid indices, all
    * levels other than the PersistentLevel are deactivated.
    *
+   * Levels that are being prefetched because the camera is within
+   * SubLevelPrefetchDistance of them stay loaded, but hidden.
+   *
    * This function is meant to be called from within the game, not in the
    * Editor.
    *
@@ -165,6 +194,22 @@ public:
   // UPROPERTY(EditAnywhere, Category = "Cesium", AdvancedDisplay)
   bool EditOriginInViewport = false;
 
+  /**
+   * If true, the world is laid out in Unreal Engine 5's double-precision Large
+   * World Coordinates instead of being rebased to stay near the camera.
+   *
+   * Tiles, globe anchors, and the georeference transforms are all computed in
+   * double precision, so with Large World Coordinates their positions stay
+   * precise anywhere on the globe. The world origin is then kept at zero, and
+   * `KeepWorldOriginNearCamera` is ignored, which avoids the hitches of
+   * shifting every Actor in the world on each origin rebase.
+   *
+   * This has no effect in Unreal Engine 4, which only has single-precision
+   * world coordinates.
+   */
+  UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Cesium")
+  bool UseLargeWorldCoordinates = false;
+
   /**
    * If true, the world origin is periodically rebased to keep it near the
    * camera.
@@ -172,8 +217,15 @@ public:
    * This is important for maintaining vertex precision in large worlds. Setting
    * it to false can lead to jiterring artifacts when the camera gets far away
    * from the origin.
+   *
+   * This is ignored when `UseLargeWorldCoordinates` is enabled in Unreal
+   * Engine 5.
    */
-  UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Cesium")
+  UPROPERTY(
+      EditAnywhere,
+      BlueprintReadWrite,
+      Category = "Cesium",
+      meta = (EditCondition = "!UseLargeWorldCoordinates"))
   bool KeepWorldOriginNearCamera = true;
 
 #if WITH_EDITOR
@@ -401,6 +453,141 @@ public:
   UFUNCTION(BlueprintCallable, Category = "Cesium")
   FVector InaccurateTransformUnrealToEcef(const FVector& Unreal) const;
 
+  /*
+   * BATCH CONVERSION FUNCTIONS
+   *
+   * These convert many points in one call, which is much faster than calling
+   * the functions above for each point. Large batches are converted in
+   * parallel. In the C++ functions, the output span must be the same size as
+   * the input span, and may be the same span.
+   */
+
+  /**
+   * Transforms each longitude in degrees (x), latitude in degrees (y), and
+   * height in meters (z) into Earth-Centered, Earth-Fixed (ECEF) coordinates.
+   */
+  void TransformLongitudeLatitudeHeightToEcef(
+      gsl::span<const glm::dvec3> LongitudeLatitudeHeights,
+      gsl::span<glm::dvec3> Ecefs) const;
+
+  /**
+   * Transforms each longitude in degrees (x), latitude in degrees (y), and
+   * height in meters (z) into Earth-Centered, Earth-Fixed (ECEF) coordinates.
+   *
+   * This function peforms the computation in single-precision. When using
+   * the C++ API, corresponding double-precision function
+   * TransformLongitudeLatitudeHeightToEcef can be used.
+   */
+  UFUNCTION(BlueprintCallable, Category = "Cesium")
+  TArray<FVector> InaccurateTransformLongitudeLatitudeHeightArrayToEcef(
+      const TArray<FVector>& LongitudeLatitudeHeights) const;
+
+  /**
+   * Transforms each Earth-Centered, Earth-Fixed (ECEF) position into WGS84
+   * longitude in degrees (x), latitude in degrees (y), and height above the
+   * ellipsoid in meters (z).
+   */
+  void TransformEcefToLongitudeLatitudeHeight(
+      gsl::span<const glm::dvec3> Ecefs,
+      gsl::span<glm::dvec3> LongitudeLatitudeHeights) const;
+
+  /**
+   * Transforms each Earth-Centered, Earth-Fixed (ECEF) position into WGS84
+   * longitude in degrees (x), latitude in degrees (y), and height above the
+   * ellipsoid in meters (z).
+   *
+   * This function peforms the computation in single-precision. When using
+   * the C++ API, corresponding double-precision function
+   * TransformEcefToLongitudeLatitudeHeight can be used.
+   */
+  UFUNCTION(BlueprintCallable, Category = "Cesium")
+  TArray<FVector> InaccurateTransformEcefArrayToLongitudeLatitudeHeight(
+      const TArray<FVector>& Ecefs) const;
+
+  /**
+   * Transforms each longitude in degrees (x), latitude in degrees (y), and
+   * height above the ellipsoid in meters (z) into Unreal world coordinates
+   * (relative to the floating origin).
+   */
+  void TransformLongitudeLatitudeHeightToUnreal(
+      gsl::span<const glm::dvec3> LongitudeLatitudeHeights,
+      gsl::span<glm::dvec3> Unreals) const;
+
+  /**
+   * Transforms each longitude in degrees (x), latitude in degrees (y), and
+   * height above the ellipsoid in meters (z) into Unreal world coordinates
+   * (relative to the floating origin).
+   *
+   * This function peforms the computation in single-precision. When using
+   * the C++ API, corresponding double-precision function
+   * TransformLongitudeLatitudeHeightToUnreal can be used.
+   */
+  UFUNCTION(BlueprintCallable, Category = "Cesium")
+  TArray<FVector> InaccurateTransformLongitudeLatitudeHeightArrayToUnreal(
+      const TArray<FVector>& LongitudeLatitudeHeights) const;
+
+  /**
+   * Transforms each Unreal world position (relative to the floating origin)
+   * into longitude in degrees (x), latitude in degrees (y), and height above
+   * the ellipsoid in meters (z).
+   */
+  void TransformUnrealToLongitudeLatitudeHeight(
+      gsl::span<const glm::dvec3> Unreals,
+      gsl::span<glm::dvec3> LongitudeLatitudeHeights) const;
+
+  /**
+   * Transforms each Unreal world position (relative to the floating origin)
+   * into longitude in degrees (x), latitude in degrees (y), and height above
+   * the ellipsoid in meters (z).
+   *
+   * This function peforms the computation in single-precision. When using
+   * the C++ API, corresponding double-precision function
+   * TransformUnrealToLongitudeLatitudeHeight can be used.
+   */
+  UFUNCTION(BlueprintCallable, Category = "Cesium")
+  TArray<FVector> InaccurateTransformUnrealArrayToLongitudeLatitudeHeight(
+      const TArray<FVector>& Unreals) const;
+
+  /**
+   * Transforms each point from Earth-Centered, Earth-Fixed (ECEF) into Unreal
+   * relative world (relative to the floating origin).
+   */
+  void TransformEcefToUnreal(
+      gsl::span<const glm::dvec3> Ecefs,
+      gsl::span<glm::dvec3> Unreals) const;
+
+  /**
+   * Transforms each point from Earth-Centered, Earth-Fixed (ECEF) into Unreal
+   * relative world (relative to the floating origin).
+   *
+   * This function peforms the computation in single-precision. When using
+   * the C++ API, corresponding double-precision function
+   * TransformEcefToUnreal can be used.
+   */
+  UFUNCTION(BlueprintCallable, Category = "Cesium")
+  TArray<FVector>
+  InaccurateTransformEcefArrayToUnreal(const TArray<FVector>& Ecefs) const;
+
+  /**
+   * Transforms each point from Unreal relative world (relative to the
+   * floating origin) to Earth-Centered, Earth-Fixed (ECEF).
+   */
+  void TransformUnrealToEcef(
+      gsl::span<const glm::dvec3> Unreals,
+      gsl::span<glm::dvec3> Ecefs) const;
+
+  /**
+   * Transforms each point from Unreal relative world (relative to the
+   * floating origin) to Earth-Centered, Earth-Fixed (ECEF).
+   *
+   * This function peforms the computation in single-precision. When using
+   * the C++ API, corresponding double-precision function
+   * TransformUnrealToEcef can be used.
+   */
+  UFUNCTION(BlueprintCallable, Category = "Cesium")
+  TArray<FVector>
+  InaccurateTransformUnrealArrayToEcef(const TArray<FVector>& Unreals) const;
+
   /**
    * Transforms a rotator from Unreal world to East-North-Up at the given
    * Unreal world location (relative to the floating origin).
@@ -481,6 +668,34 @@ public:
   UFUNCTION(BlueprintCallable, Category = "Cesium")
   FMatrix InaccurateComputeEastNorthUpToEcef(const FVector& Ecef) const;
 
+  /**
+   * Computes the East-North-Up frame at the specified Unreal world location
+   * (relative to the floating origin). Pass it to the frame versions of
+   * TransformRotatorUnrealToEastNorthUp and
+   * TransformRotatorEastNorthUpToUnreal to convert many rotators around that
+   * location without rebuilding the frame for each of them.
+   *
+   * The frame must be recomputed when the georeference origin changes.
+   */
+  GeoTransforms::EastNorthUpFrame
+  ComputeEastNorthUpFrame(const glm::dvec3& UnrealLocation) const;
+
+  /**
+   * Transforms a rotator from Unreal world to East-North-Up in a frame
+   * computed by ComputeEastNorthUpFrame.
+   */
+  glm::dquat TransformRotatorUnrealToEastNorthUp(
+      const GeoTransforms::EastNorthUpFrame& Frame,
+      const glm::dquat& UnrealRotator) const;
+
+  /**
+   * Transforms a rotator from East-North-Up to Unreal world in a frame
+   * computed by ComputeEastNorthUpFrame.
+   */
+  glm::dquat TransformRotatorEastNorthUpToUnreal(
+      const GeoTransforms::EastNorthUpFrame& Frame,
+      const glm::dquat& EnuRotator) const;
+
   /**
    * @brief Computes the normal of the plane tangent to the surface of the
    * ellipsoid that is used by this instance, at the provided position.
@@ -540,6 +755,29 @@ public:
     return _geoTransforms;
   }
 
+  /**
+   * Returns a snapshot of the GeoTransforms, which, unlike GetGeoTransforms,
+   * may be called from any thread, and stays valid and unchanged however the
+   * Georeference changes afterward.
+   */
+  GeoTransformsSnapshot GetGeoTransformsSnapshot() const;
+
+  /**
+   * Returns the version of the latest snapshot of the GeoTransforms. This may
+   * be called from any thread, and is cheap enough to poll, so that code
+   * holding a snapshot can tell when it should take a new one.
+   */
+  uint64 GetGeoTransformsVersion() const noexcept {
+    return this->_geoTransformsVersion.load(std::memory_order_acquire);
+  }
+
+  /**
+   * A delegate that is called on the game thread, with the new snapshot,
+   * whenever the origin or the ellipsoid of the Georeference changes, so that
+   * systems that hand snapshots to worker threads can refresh them.
+   */
+  FGeoTransformsChanged OnGeoTransformsChanged;
+
 protected:
   // Called when the game starts or when spawned
   virtual void BeginPlay() override;
@@ -568,8 +806,51 @@ private:
 
   GeoTransforms _geoTransforms;
 
+  // The latest snapshot of _geoTransforms, which is guarded by the mutex
+  // since it is read from any thread, and its version.
+  mutable std::mutex _geoTransformsSnapshotMutex;
+  GeoTransformsSnapshot _geoTransformsSnapshot;
+  std::atomic<uint64> _geoTransformsVersion{0};
+
   bool _insideSublevel;
 
+  /**
+   * @brief The ECEF position of a sub-level, cached along with the properties
+   * it depends on, so that it is only recomputed when they change.
+   */
+  struct CachedSubLevel {
+    double longitude;
+    double latitude;
+    double height;
+    double loadRadius;
+    bool enabled;
+    glm::dvec3 ecef;
+  };
+
+  /**
+   * @brief The cached positions of the sub-levels, in the order of
+   * `CesiumSubLevels`.
+   */
+  std::vector<CachedSubLevel> _cachedSubLevels;
+
+  /**
+   * @brief The indices of the enabled sub-levels, sorted by the ECEF X
+   * coordinate of their positions, so that the levels near the camera are
+   * found by a binary search rather than by measuring the distance to each.
+   */
+  std::vector<int32> _subLevelsByEcefX;
+
+  /**
+   * @brief The largest LoadRadius of the enabled sub-levels.
+   */
+  double _maximumSubLevelLoadRadius;
+
+  /**
+   * @brief The indices of the sub-levels that are loaded in the background
+   * because the camera is near, but not within the LoadRadius of, them.
+   */
+  TArray<int32> _prefetchingSubLevels;
+
 #if WITH_EDITOR
   FDelegateHandle _newCurrentLevelSubscription;
 #endif
@@ -637,15 +918,37 @@ private:
    * This will only be done if origin rebasing is enabled via
    * `KeepWorldOriginNearCamera`, and the actor is either *not* in a sublevel,
    * or `OriginRebaseInsideSublevels` is enabled.
+   *
+   * With Large World Coordinates, this only moves the world origin back to
+   * zero if it isn't there already.
    */
   void _performOriginRebasing();
 
+  /**
+   * @brief Updates the cached sub-level positions and the index of them if any
+   * sub-level was added, removed, moved, enabled or disabled, or given a new
+   * load radius.
+   */
+  void _updateSubLevelIndex();
+
+  /**
+   * @brief Whether `UseLargeWorldCoordinates` is enabled and supported by this
+   * Engine version.
+   */
+  bool _usesLargeWorldCoordinates() const;
+
   /**
    * Updates _geoTransforms based on the current ellipsoid and center, and
    * returns the old transforms.
    */
   void _updateGeoTransforms();
 
+  /**
+   * Takes a new snapshot of _geoTransforms if its origin or ellipsoid differs
+   * from that of the latest one.
+   */
+  void _updateGeoTransformsSnapshot();
+
   /**
    * @brief Finds the ULevelStreaming with given name.
    *
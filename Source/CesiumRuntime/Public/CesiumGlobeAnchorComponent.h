@@ -5,6 +5,7 @@
 #include "Components/ActorComponent.h"
 #include <glm/gtx/quaternion.hpp>
 #include <glm/vec3.hpp>
+#include <gsl/span>
 #include <optional>
 #include "CesiumGlobeAnchorComponent.generated.h"
 
@@ -160,6 +161,36 @@ public:
   void InaccurateMoveToLongitudeLatitudeHeight(
       const FVector& TargetLongitudeLatitudeHeight);
 
+  /**
+   * Moves each of the given anchors' Actors to the longitude in degrees (x),
+   * latitude in degrees (y), and height in meters (z) at the same index, just
+   * like calling MoveToLongitudeLatitudeHeight on each of them.
+   *
+   * This is much faster for many anchors: their new globe and Actor
+   * transforms are computed in parallel, and only the Actor transforms
+   * themselves are set one anchor after the other.
+   *
+   * @param Anchors The anchors to move. Null entries are skipped.
+   * @param TargetLongitudeLatitudeHeights The new positions, one per anchor.
+   */
+  static void MoveToLongitudeLatitudeHeights(
+      gsl::span<UCesiumGlobeAnchorComponent* const> Anchors,
+      gsl::span<const glm::dvec3> TargetLongitudeLatitudeHeights);
+
+  /**
+   * Moves each of the given anchors' Actors to the longitude in degrees (x),
+   * latitude in degrees (y), and height in meters (z) at the same index, just
+   * like calling MoveToLongitudeLatitudeHeight on each of them, but computing
+   * the new transforms in parallel.
+   *
+   * This function is inaccurate because large coordinate values are represented
+   * as singe-precision floating point numbers.
+   */
+  UFUNCTION(BlueprintCallable, Category = "Cesium")
+  static void InaccurateMoveToLongitudeLatitudeHeights(
+      const TArray<UCesiumGlobeAnchorComponent*>& Anchors,
+      const TArray<FVector>& TargetLongitudeLatitudeHeights);
+
 private:
   /**
    * The Earth-Centered Earth-Fixed X-coordinate of this component in meters.
@@ -372,6 +403,52 @@ private:
    */
   bool _updatingActorTransform = false;
 
+  /**
+   * Whether the Longitude, Latitude, and Height properties are out of date
+   * with the globe transform. Outside the Editor nothing shows them, so they
+   * are only recomputed when this component is saved.
+   */
+  bool _cartographicPropertiesAreStale = false;
+
+  /**
+   * The Actor transform for the world origin that an origin rebase in
+   * progress is moving to, computed along with those of all other anchors in
+   * the world before the rebase started. Only used while the world origin is
+   * still `_rebasedFromWorldOrigin`.
+   */
+  std::optional<FTransform> _rebasedActorTransform;
+
+  /**
+   * The world origin that `_rebasedActorTransform` was computed to move away
+   * from.
+   */
+  FIntVector _rebasedFromWorldOrigin;
+
+  /**
+   * Called before a world's origin is rebased. Computes the new Actor
+   * transforms of all anchors registered in that world in parallel, so that
+   * `ApplyWorldOffset` only has to apply them.
+   */
+  static void _onPreWorldOriginOffset(
+      UWorld* InWorld,
+      FIntVector InSrcOrigin,
+      FIntVector InDstOrigin);
+
+  /**
+   * Sets the transform of the Actor's root component, without reacting to it
+   * in _onActorTransformChanged.
+   */
+  void _setActorTransform(
+      USceneComponent* pOwnerRoot,
+      const FTransform& actorTransform);
+
+  /**
+   * Updates the Longitude, Latitude, and Height properties from the current
+   * globe transform in the Editor, where they are visible, or marks them
+   * stale otherwise.
+   */
+  void _invalidateCartographicProperties();
+
   /**
    * Called when the root transform of the Actor to which this Component is
    * attached has changed. So:
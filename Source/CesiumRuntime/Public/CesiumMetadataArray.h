@@ -292,4 +292,43 @@ public:
       UPARAM(ref) const FCesiumMetadataArray& Array,
       int64 Index,
       const FString& DefaultValue);
+
+  /**
+   * Retrieves an element from a string array as an interned name, which is
+   * only allocated the first time each distinct string is seen.
+   *
+   * Elements that are not strings, or are longer than a name can be, return
+   * the `DefaultValue`. Names are compared without regard to case, so use
+   * GetString or GetStringView for elements that differ only in case.
+   *
+   * @param Index The index of the array element to retrieve.
+   * @param DefaultValue The default value to use if the index is invalid
+   * or the element is not a string.
+   * @return The element value.
+   */
+  UFUNCTION(
+      BlueprintCallable,
+      BlueprintPure,
+      Category = "Cesium|Metadata|Array")
+  static FName GetName(
+      UPARAM(ref) const FCesiumMetadataArray& Array,
+      int64 Index,
+      FName DefaultValue = NAME_None);
+
+  /**
+   * Retrieves an element from a string array without copying or converting
+   * it. The view holds UTF-8 and points into the buffers of the glTF, so it
+   * is only valid as long as the tile that the array belongs to is loaded.
+   *
+   * Elements that are not strings return the `DefaultValue`.
+   *
+   * @param Index The index of the array element to retrieve.
+   * @param DefaultValue The default value to use if the index is invalid
+   * or the element is not a string.
+   * @return The element value.
+   */
+  static std::string_view GetStringView(
+      const FCesiumMetadataArray& Array,
+      int64 Index,
+      std::string_view DefaultValue = std::string_view());
 };
@@ -211,7 +211,28 @@ struct CesiumMetadataConversions<
 template <> struct CesiumMetadataConversions<FString, std::string_view> {
   static FString
   convert(const std::string_view& from, const FString& defaultValue) {
-    return FString(UTF8_TO_TCHAR(std::string(from.data(), from.size()).data()));
+    FUTF8ToTCHAR converted(from.data(), static_cast<int32>(from.size()));
+    return FString(converted.Length(), converted.Get());
+  }
+};
+
+//
+// Conversions to FName
+//
+
+// string_view -> FName
+// The string is converted on the stack, so looking up a name that was already
+// interned, such as a value of an enum-like string property, doesn't allocate.
+// Strings that are too long to be a name return the default value. Names
+// ignore case, so strings that differ only in case convert to the same name;
+// use std::string_view or FString where case matters.
+template <> struct CesiumMetadataConversions<FName, std::string_view> {
+  static FName convert(const std::string_view& from, FName defaultValue) {
+    FUTF8ToTCHAR converted(from.data(), static_cast<int32>(from.size()));
+    if (converted.Length() >= NAME_SIZE) {
+      return defaultValue;
+    }
+    return FName(converted.Length(), converted.Get());
   }
 };
 
@@ -7,6 +7,7 @@
 #include "CesiumMetadataProperty.h"
 #include "Kismet/BlueprintFunctionLibrary.h"
 #include "UObject/ObjectMacros.h"
+#include <gsl/span>
 #include "CesiumMetadataFeatureTable.generated.h"
 
 namespace CesiumGltf {
@@ -123,4 +124,206 @@ public:
       Category = "Cesium|Metadata|FeatureTable")
   static const TMap<FString, FCesiumMetadataProperty>&
   GetProperties(UPARAM(ref) const FCesiumMetadataFeatureTable& FeatureTable);
+
+  /**
+   * Gets the values of the named property for a range of consecutive
+   * features, converted as by GetBoolean on the property. This is much faster
+   * than querying the features one by one.
+   *
+   * @param PropertyName The name of the property.
+   * @param FirstFeatureID The ID of the first feature in the range.
+   * @param NumberOfFeatures The number of features in the range.
+   * @param DefaultValue The value to use for feature IDs that are invalid or
+   * whose values cannot be converted, and for all features if the property
+   * does not exist.
+   */
+  UFUNCTION(
+      BlueprintCallable,
+      BlueprintPure,
+      Category = "Cesium|Metadata|FeatureTable")
+  static TArray<bool> GetBooleanPropertyValues(
+      UPARAM(ref) const FCesiumMetadataFeatureTable& FeatureTable,
+      const FString& PropertyName,
+      int64 FirstFeatureID,
+      int64 NumberOfFeatures,
+      bool DefaultValue = false);
+
+  /**
+   * Gets the values of the named property for a range of consecutive
+   * features, converted as by GetInteger on the property. This is much faster
+   * than querying the features one by one.
+   *
+   * @param PropertyName The name of the property.
+   * @param FirstFeatureID The ID of the first feature in the range.
+   * @param NumberOfFeatures The number of features in the range.
+   * @param DefaultValue The value to use for feature IDs that are invalid or
+   * whose values cannot be converted, and for all features if the property
+   * does not exist.
+   */
+  UFUNCTION(
+      BlueprintCallable,
+      BlueprintPure,
+      Category = "Cesium|Metadata|FeatureTable")
+  static TArray<int32> GetIntegerPropertyValues(
+      UPARAM(ref) const FCesiumMetadataFeatureTable& FeatureTable,
+      const FString& PropertyName,
+      int64 FirstFeatureID,
+      int64 NumberOfFeatures,
+      int32 DefaultValue = 0);
+
+  /**
+   * Gets the values of the named property for a range of consecutive
+   * features, converted as by GetInteger64 on the property. This is much faster
+   * than querying the features one by one.
+   *
+   * @param PropertyName The name of the property.
+   * @param FirstFeatureID The ID of the first feature in the range.
+   * @param NumberOfFeatures The number of features in the range.
+   * @param DefaultValue The value to use for feature IDs that are invalid or
+   * whose values cannot be converted, and for all features if the property
+   * does not exist.
+   */
+  UFUNCTION(
+      BlueprintCallable,
+      BlueprintPure,
+      Category = "Cesium|Metadata|FeatureTable")
+  static TArray<int64> GetInteger64PropertyValues(
+      UPARAM(ref) const FCesiumMetadataFeatureTable& FeatureTable,
+      const FString& PropertyName,
+      int64 FirstFeatureID,
+      int64 NumberOfFeatures,
+      int64 DefaultValue = 0);
+
+  /**
+   * Gets the values of the named property for a range of consecutive
+   * features, converted as by GetFloat on the property. This is much faster
+   * than querying the features one by one.
+   *
+   * @param PropertyName The name of the property.
+   * @param FirstFeatureID The ID of the first feature in the range.
+   * @param NumberOfFeatures The number of features in the range.
+   * @param DefaultValue The value to use for feature IDs that are invalid or
+   * whose values cannot be converted, and for all features if the property
+   * does not exist.
+   */
+  UFUNCTION(
+      BlueprintCallable,
+      BlueprintPure,
+      Category = "Cesium|Metadata|FeatureTable")
+  static TArray<float> GetFloatPropertyValues(
+      UPARAM(ref) const FCesiumMetadataFeatureTable& FeatureTable,
+      const FString& PropertyName,
+      int64 FirstFeatureID,
+      int64 NumberOfFeatures,
+      float DefaultValue = 0.0f);
+
+  /**
+   * Gets the values of the named property for a range of consecutive
+   * features, converted as by GetString on the property. This is much faster
+   * than querying the features one by one.
+   *
+   * @param PropertyName The name of the property.
+   * @param FirstFeatureID The ID of the first feature in the range.
+   * @param NumberOfFeatures The number of features in the range.
+   * @param DefaultValue The value to use for feature IDs that are invalid or
+   * whose values cannot be converted, and for all features if the property
+   * does not exist.
+   */
+  UFUNCTION(
+      BlueprintCallable,
+      BlueprintPure,
+      Category = "Cesium|Metadata|FeatureTable")
+  static TArray<FString> GetStringPropertyValues(
+      UPARAM(ref) const FCesiumMetadataFeatureTable& FeatureTable,
+      const FString& PropertyName,
+      int64 FirstFeatureID,
+      int64 NumberOfFeatures,
+      const FString& DefaultValue = "");
+
+  /**
+   * Fills preallocated arrays with the values of many properties for a range
+   * of consecutive features, converted to the given type. See
+   * UCesiumMetadataPropertyBlueprintLibrary::GetValues.
+   *
+   * @param FeatureTable The feature table to read.
+   * @param PropertyNames The names of the properties to read.
+   * @param FirstFeatureID The ID of the first feature in the range.
+   * @param Values The values to fill, one column for each property, in the
+   * order of PropertyNames. Each column holds one value for each feature in
+   * the range, so the number of features is the size of this span divided by
+   * the number of properties.
+   * @param DefaultValue The value to use for feature IDs that are invalid or
+   * whose values cannot be converted, and for all features of a property that
+   * does not exist.
+   * @return Whether all of the properties exist.
+   */
+  template <typename T>
+  static bool GetPropertyValues(
+      const FCesiumMetadataFeatureTable& FeatureTable,
+      gsl::span<const FString> PropertyNames,
+      int64 FirstFeatureID,
+      gsl::span<T> Values,
+      const T& DefaultValue) {
+    if (PropertyNames.empty()) {
+      return true;
+    }
+
+    const size_t count = Values.size() / PropertyNames.size();
+    bool allFound = true;
+    for (size_t i = 0; i < PropertyNames.size(); ++i) {
+      gsl::span<T> column = Values.subspan(i * count, count);
+      const FCesiumMetadataProperty* pProperty =
+          FeatureTable._properties.Find(PropertyNames[i]);
+      if (pProperty) {
+        UCesiumMetadataPropertyBlueprintLibrary::GetValues(
+            *pProperty,
+            FirstFeatureID,
+            column,
+            DefaultValue);
+      } else {
+        std::fill(column.begin(), column.end(), DefaultValue);
+        allFound = false;
+      }
+    }
+    return allFound;
+  }
+
+  /**
+   * Fills a preallocated array with the values of the named property for the
+   * given features, converted to the given type. See
+   * UCesiumMetadataPropertyBlueprintLibrary::GetValuesForFeatureIDs.
+   *
+   * @return Whether the property exists. If it does not, all values are set
+   * to the DefaultValue.
+   */
+  template <typename T>
+  static bool GetPropertyValuesForFeatureIDs(
+      const FCesiumMetadataFeatureTable& FeatureTable,
+      const FString& PropertyName,
+      gsl::span<const int64> FeatureIDs,
+      gsl::span<T> Values,
+      const T& DefaultValue) {
+    const FCesiumMetadataProperty* pProperty =
+        FeatureTable._properties.Find(PropertyName);
+    if (!pProperty) {
+      std::fill(Values.begin(), Values.end(), DefaultValue);
+      return false;
+    }
+
+    UCesiumMetadataPropertyBlueprintLibrary::GetValuesForFeatureIDs(
+        *pProperty,
+        FeatureIDs,
+        Values,
+        DefaultValue);
+    return true;
+  }
+
+private:
+  template <typename T>
+  static TArray<T> getPropertyValuesArray(
+      const FCesiumMetadataFeatureTable& FeatureTable,
+      const FString& PropertyName,
+      int64 FirstFeatureID,
+      int64 NumberOfFeatures,
+      const T& DefaultValue);
 };
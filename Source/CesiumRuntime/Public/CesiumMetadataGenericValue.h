@@ -305,6 +305,39 @@ public:
       UPARAM(ref) const FCesiumMetadataGenericValue& Value,
       const FString& DefaultValue);
 
+  /**
+   * Gets a string value as an interned name, which is only allocated the
+   * first time each distinct string is seen.
+   *
+   * Values that are not strings, or are longer than a name can be, return the
+   * `DefaultValue`. Names ignore case, so strings that differ only in case
+   * get the same name.
+   *
+   * @param DefaultValue The default value to use if the value is not a string.
+   * @return The value.
+   */
+  UFUNCTION(
+      BlueprintCallable,
+      BlueprintPure,
+      Category = "Cesium|Metadata|GenericValue")
+  static FName GetName(
+      UPARAM(ref) const FCesiumMetadataGenericValue& Value,
+      FName DefaultValue = NAME_None);
+
+  /**
+   * Gets a string value without copying or converting it. The view holds
+   * UTF-8 and points into the buffers of the glTF, so it is only valid as long
+   * as the tile that the value belongs to is loaded.
+   *
+   * Values that are not strings return the `DefaultValue`.
+   *
+   * @param DefaultValue The default value to use if the value is not a string.
+   * @return The value.
+   */
+  static std::string_view GetStringView(
+      const FCesiumMetadataGenericValue& Value,
+      std::string_view DefaultValue = std::string_view());
+
   /**
    * Gets the value as an array.
    * If the property is not an array type, this method returns an empty array.
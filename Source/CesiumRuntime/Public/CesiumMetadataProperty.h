@@ -5,10 +5,13 @@
 #include "CesiumGltf/MetadataPropertyView.h"
 #include "CesiumGltf/PropertyTypeTraits.h"
 #include "CesiumMetadataArray.h"
+#include "CesiumMetadataConversions.h"
 #include "CesiumMetadataGenericValue.h"
 #include "CesiumMetadataValueType.h"
 #include "Kismet/BlueprintFunctionLibrary.h"
 #include "UObject/ObjectMacros.h"
+#include <algorithm>
+#include <gsl/span>
 #include <string_view>
 #include <variant>
 #include "CesiumMetadataProperty.generated.h"
@@ -340,6 +343,50 @@ public:
       int64 FeatureID,
       const FString& DefaultValue = "");
 
+  /**
+   * Retrieves the value of a string property for the feature with the given
+   * ID as an interned name, which is only allocated the first time each
+   * distinct string is seen. This suits properties with a few distinct
+   * values, such as categories, that are compared or switched on repeatedly.
+   *
+   * Properties that are not strings return the `defaultValue`, as do values
+   * that are longer than a name can be. Names are compared without regard to
+   * case, so properties whose values differ only in case should be read with
+   * GetString or GetStringView instead.
+   *
+   * @param featureID The ID of the feature.
+   * @param defaultValue The default value to use if the feature ID is invalid
+   * or the property is not a string.
+   * @return The property value.
+   */
+  UFUNCTION(
+      BlueprintCallable,
+      BlueprintPure,
+      Category = "Cesium|Metadata|Property")
+  static FName GetName(
+      UPARAM(ref) const FCesiumMetadataProperty& Property,
+      int64 FeatureID,
+      FName DefaultValue = NAME_None);
+
+  /**
+   * Retrieves the value of a string property for the feature with the given
+   * ID without copying or converting it. The view holds UTF-8 and points into
+   * the buffers of the glTF, so it is only valid as long as the tile that the
+   * property belongs to is loaded.
+   *
+   * Properties that are not strings return the `DefaultValue`. To read many
+   * strings at once, use GetValues with std::string_view.
+   *
+   * @param FeatureID The ID of the feature.
+   * @param DefaultValue The default value to use if the feature ID is invalid
+   * or the property is not a string.
+   * @return The property value.
+   */
+  static std::string_view GetStringView(
+      const FCesiumMetadataProperty& Property,
+      int64 FeatureID,
+      std::string_view DefaultValue = std::string_view());
+
   /**
    * Retrieves the value of the property for the feature with the given ID.
    * If the property is not an array type, this method returns an empty array.
@@ -372,4 +419,86 @@ public:
   static FCesiumMetadataGenericValue GetGenericValue(
       UPARAM(ref) const FCesiumMetadataProperty& Property,
       int64 FeatureID);
+
+  /**
+   * Retrieves the values of the property for a range of consecutive features
+   * and converts them to the given type, with the same conversions as the
+   * typed getters such as GetFloat.
+   *
+   * The type of the property is only resolved once for the whole range, and
+   * the values are read directly from the property's buffers, which is much
+   * faster than querying the features one by one. With std::string_view or
+   * FName, string values are read without allocating, see GetStringView and
+   * GetName.
+   *
+   * @param Property The property to read.
+   * @param FirstFeatureID The ID of the feature for the first value.
+   * @param Values The values to fill, one for each feature starting at
+   * FirstFeatureID.
+   * @param DefaultValue The value to use for feature IDs that are invalid or
+   * whose values cannot be converted.
+   */
+  template <typename T>
+  static void GetValues(
+      const FCesiumMetadataProperty& Property,
+      int64 FirstFeatureID,
+      gsl::span<T> Values,
+      const T& DefaultValue) {
+    std::visit(
+        [FirstFeatureID, Values, &DefaultValue](const auto& view) {
+          const int64 size = view.size();
+          for (size_t i = 0; i < Values.size(); ++i) {
+            Values[i] = getConvertedValue(
+                view,
+                size,
+                FirstFeatureID + int64(i),
+                DefaultValue);
+          }
+        },
+        Property._property);
+  }
+
+  /**
+   * Retrieves the values of the property for the given features and converts
+   * them to the given type. See GetValues.
+   *
+   * @param Property The property to read.
+   * @param FeatureIDs The IDs of the features to read.
+   * @param Values The values to fill, one for each of the FeatureIDs.
+   * @param DefaultValue The value to use for feature IDs that are invalid or
+   * whose values cannot be converted.
+   */
+  template <typename T>
+  static void GetValuesForFeatureIDs(
+      const FCesiumMetadataProperty& Property,
+      gsl::span<const int64> FeatureIDs,
+      gsl::span<T> Values,
+      const T& DefaultValue) {
+    std::visit(
+        [FeatureIDs, Values, &DefaultValue](const auto& view) {
+          const int64 size = view.size();
+          const size_t count = std::min(FeatureIDs.size(), Values.size());
+          for (size_t i = 0; i < count; ++i) {
+            Values[i] =
+                getConvertedValue(view, size, FeatureIDs[i], DefaultValue);
+          }
+        },
+        Property._property);
+  }
+
+private:
+  template <typename T, typename TView>
+  static T getConvertedValue(
+      const TView& view,
+      int64 size,
+      int64 featureID,
+      const T& defaultValue) {
+    if (featureID < 0 || featureID >= size) {
+      return defaultValue;
+    }
+    auto value = view.get(featureID);
+    return CesiumMetadataConversions<T, decltype(value)>::convert(
+        value,
+        defaultValue);
+  }
 };
@@ -4,6 +4,7 @@
 #include "CesiumMetadataGenericValue.h"
 #include "CesiumMetadataPrimitive.h"
 #include "Containers/UnrealString.h"
+#include "Engine/EngineTypes.h"
 #include "Kismet/BlueprintFunctionLibrary.h"
 #include "UObject/ObjectMacros.h"
 #include "CesiumMetadataUtilityBlueprintLibrary.generated.h"
@@ -63,4 +64,75 @@ public:
       UPARAM(ref) const FCesiumMetadataPrimitive& Primitive,
       UPARAM(ref) const FCesiumMetadataFeatureTable& FeatureTable,
       int64 faceID);
+
+  /**
+   * Gets the ID of the feature that was hit by a trace, in the first feature
+   * table of the hit glTF primitive component, or -1 if the component is not
+   * a Cesium glTF primitive component or has no feature table. The trace must
+   * return the face index, which requires a complex trace with "Return Face
+   * Index" set.
+   *
+   * This uses a table from faces to features that is built when the tile is
+   * loaded, so it is much faster than GetFeatureIDForFace.
+   */
+  UFUNCTION(
+      BlueprintCallable,
+      BlueprintPure,
+      Category = "Cesium|Metadata|Utility")
+  static int64 GetFeatureIDForHit(const FHitResult& Hit);
+
+  /**
+   * Gets the value of a single property of the feature that was hit by a
+   * trace, as found by GetFeatureIDForHit. The value is empty if there is no
+   * such feature or property.
+   *
+   * Unlike GetMetadataValuesForFace, this doesn't read every property of the
+   * feature, so it is suitable for picking under the cursor every frame.
+   */
+  UFUNCTION(
+      BlueprintCallable,
+      BlueprintPure,
+      Category = "Cesium|Metadata|Utility")
+  static FCesiumMetadataGenericValue
+  GetPropertyValueForHit(const FHitResult& Hit, const FString& PropertyName);
+
+  /**
+   * Gets the value of a single property of the feature that was hit by a
+   * trace, as found by GetFeatureIDForHit, converted to the given type. See
+   * UCesiumMetadataPropertyBlueprintLibrary::GetValues.
+   *
+   * @return The value, or the DefaultValue if there is no such feature or
+   * property, or if the value can't be converted.
+   */
+  template <typename T>
+  static T GetPropertyValueForHitAs(
+      const FHitResult& Hit,
+      const FString& PropertyName,
+      const T& DefaultValue) {
+    int64 featureID = -1;
+    const FCesiumMetadataProperty* pProperty =
+        findPropertyForHit(Hit, PropertyName, featureID);
+    if (!pProperty) {
+      return DefaultValue;
+    }
+
+    T value = DefaultValue;
+    UCesiumMetadataPropertyBlueprintLibrary::GetValues(
+        *pProperty,
+        featureID,
+        gsl::span<T>(&value, 1),
+        DefaultValue);
+    return value;
+  }
+
+private:
+  /**
+   * Finds the named property of the first feature table of the glTF
+   * primitive component that was hit, and the ID of the feature that was
+   * hit, or returns nullptr if there is no such feature or property.
+   */
+  static const FCesiumMetadataProperty* findPropertyForHit(
+      const FHitResult& Hit,
+      const FString& PropertyName,
+      int64& FeatureID);
 };
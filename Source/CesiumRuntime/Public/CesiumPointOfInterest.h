@@ -0,0 +1,45 @@
+// Copyright 2020-2021 CesiumGS, Inc. and Contributors
+
+#pragma once
+
+#include "Math/Vector.h"
+#include "UObject/ObjectMacros.h"
+
+#include "CesiumPointOfInterest.generated.h"
+
+/**
+ * @brief A location that {@link Cesium3DTileset}s should load tiles around
+ * in every direction, even though no camera looks from it, such as the view
+ * target of a remote player on a server.
+ */
+USTRUCT(BlueprintType)
+struct CESIUMRUNTIME_API FCesiumPointOfInterest {
+  GENERATED_USTRUCT_BODY()
+
+public:
+  /**
+   * @brief The Unreal location of the point of interest.
+   */
+  UPROPERTY(BlueprintReadWrite, Category = "Cesium")
+  FVector Location = FVector::ZeroVector;
+
+  /**
+   * @brief The distance, in Unreal units, from this point within which the
+   * deferred physics meshes of tiles are cooked.
+   *
+   * This is only used by tilesets whose CollisionRadius is greater than zero.
+   * When this is 0.0f, the CollisionRadius of the tileset is used.
+   */
+  UPROPERTY(BlueprintReadWrite, Category = "Cesium")
+  float Radius = 0.0f;
+
+  /**
+   * @brief The factor by which to scale the screen-space error of tiles
+   * selected for this point.
+   *
+   * Values below one select coarser tiles around this point, so that it
+   * competes less with the views of local players for loading and memory.
+   */
+  UPROPERTY(BlueprintReadWrite, Category = "Cesium")
+  float ScreenSpaceErrorScale = 1.0f;
+};
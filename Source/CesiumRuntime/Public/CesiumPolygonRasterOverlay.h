@@ -7,10 +7,7 @@
 #include "CesiumPolygonRasterOverlay.generated.h"
 
 class ACesiumCartographicPolygon;
-
-namespace Cesium3DTilesSelection {
-class RasterizedPolygonsTileExcluder;
-}
+class CesiumPolygonTileExcluder;
 
 /**
  * A raster overlay that rasterizes polygons and drapes them over the tileset.
@@ -37,6 +34,9 @@ public:
    * enabled when this overlay will be used for clipping. But when this overlay
    * is used for other effects, this option should be disabled to avoid missing
    * tiles.
+   *
+   * Tiles are classified against the polygons' bounding rectangles first, so
+   * only the tiles near a polygon are tested against its edges.
    */
   UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Cesium")
   bool ExcludeTilesInside = true;
@@ -54,6 +54,5 @@ protected:
       Cesium3DTilesSelection::RasterOverlay* pOverlay) override;
 
 private:
-  std::shared_ptr<Cesium3DTilesSelection::RasterizedPolygonsTileExcluder>
-      _pExcluder;
+  std::shared_ptr<CesiumPolygonTileExcluder> _pExcluder;
 };
@@ -0,0 +1,132 @@
+// Copyright 2020-2021 CesiumGS, Inc. and Contributors
+
+#pragma once
+
+#include "CesiumCamera.h"
+#include "CoreMinimal.h"
+#include "Kismet/BlueprintAsyncActionBase.h"
+#include "CesiumPreloadViewAsyncAction.generated.h"
+
+class ACesium3DTileset;
+class ACesiumCameraManager;
+
+/**
+ * The delegate for the outputs of UCesiumPreloadViewAsyncAction, which
+ * receives the load progress of the tileset, from 0 to 100.
+ */
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(
+    FCesiumPreloadViewDelegate,
+    float,
+    LoadProgress);
+
+/**
+ * Loads the tiles needed for a view that is not rendered, such as the
+ * destination of a teleport, and reports when they are all loaded.
+ *
+ * While the action runs, its view is registered with the
+ * {@link ACesiumCameraManager}, so every tileset in the world selects and
+ * loads tiles for it, in addition to the views that are rendered. The action
+ * completes when the given tileset has loaded all tiles needed for all of
+ * its views, including their raster overlay tiles. Load latency can then be
+ * hidden behind a transition by rendering the view only after it completes.
+ */
+UCLASS()
+class CESIUMRUNTIME_API UCesiumPreloadViewAsyncAction
+    : public UBlueprintAsyncActionBase {
+  GENERATED_BODY()
+
+public:
+  /**
+   * Loads the tiles of the given tileset needed to render the view of the
+   * given camera.
+   *
+   * @param Tileset The tileset whose loading is awaited.
+   * @param Camera The view to load tiles for, in Unreal world coordinates.
+   * @param MaximumScreenSpaceError The maximum screen-space error to load
+   * tiles for, or 0.0 to use the MaximumScreenSpaceError of the tileset.
+   * @param Timeout The longest time, in seconds, to wait for the tiles, or
+   * 0.0 to wait for as long as it takes.
+   */
+  UFUNCTION(
+      BlueprintCallable,
+      Category = "Cesium",
+      meta = (BlueprintInternalUseOnly = "true"))
+  static UCesiumPreloadViewAsyncAction* PreloadView(
+      ACesium3DTileset* Tileset,
+      const FCesiumCamera& Camera,
+      float MaximumScreenSpaceError = 0.0f,
+      float Timeout = 0.0f);
+
+  /**
+   * Loads the tiles of the given tileset needed to render the given globe
+   * rectangle, as seen from straight above it.
+   *
+   * @param Tileset The tileset whose loading is awaited.
+   * @param West The westernmost longitude of the rectangle, in degrees.
+   * @param South The southernmost latitude of the rectangle, in degrees.
+   * @param East The easternmost longitude of the rectangle, in degrees.
+   * @param North The northernmost latitude of the rectangle, in degrees.
+   * @param ViewportSize The size of the viewport, in pixels, that the
+   * rectangle is rendered in.
+   * @param MaximumScreenSpaceError The maximum screen-space error to load
+   * tiles for, or 0.0 to use the MaximumScreenSpaceError of the tileset.
+   * @param Timeout The longest time, in seconds, to wait for the tiles, or
+   * 0.0 to wait for as long as it takes.
+   */
+  UFUNCTION(
+      BlueprintCallable,
+      Category = "Cesium",
+      meta = (BlueprintInternalUseOnly = "true"))
+  static UCesiumPreloadViewAsyncAction* PreloadGlobeRectangle(
+      ACesium3DTileset* Tileset,
+      double West,
+      double South,
+      double East,
+      double North,
+      FVector2D ViewportSize = FVector2D(1024.0f, 1024.0f),
+      float MaximumScreenSpaceError = 0.0f,
+      float Timeout = 0.0f);
+
+  /**
+   * Called whenever the load progress changes.
+   */
+  UPROPERTY(BlueprintAssignable)
+  FCesiumPreloadViewDelegate OnProgress;
+
+  /**
+   * Called when all tiles needed for the view are loaded.
+   */
+  UPROPERTY(BlueprintAssignable)
+  FCesiumPreloadViewDelegate OnCompleted;
+
+  /**
+   * Called when the tiles could not be loaded before the timeout, or when
+   * the tileset was destroyed first.
+   */
+  UPROPERTY(BlueprintAssignable)
+  FCesiumPreloadViewDelegate OnTimedOut;
+
+  virtual void Activate() override;
+
+private:
+  void _poll();
+  void _finish(bool completed);
+
+  TWeakObjectPtr<ACesium3DTileset> _pTileset;
+  TWeakObjectPtr<ACesiumCameraManager> _pCameraManager;
+
+  FCesiumCamera _camera;
+  bool _cameraIsGlobeRectangle = false;
+  double _west = 0.0;
+  double _south = 0.0;
+  double _east = 0.0;
+  double _north = 0.0;
+
+  float _maximumScreenSpaceError = 0.0f;
+  float _timeout = 0.0f;
+
+  int32 _cameraId = -1;
+  double _startTime = 0.0;
+  uint64 _startFrame = 0;
+  float _lastProgress = -1.0f;
+};
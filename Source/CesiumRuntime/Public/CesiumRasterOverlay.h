@@ -91,12 +91,53 @@ public:
   UFUNCTION(BlueprintCallable, Category = "Cesium")
   void SetMaximumSimultaneousTileLoads(int32 Value);
 
+  /**
+   * Limits the number of overlay tiles that may simultaneously be loading to
+   * less than MaximumSimultaneousTileLoads, for example because the overlay
+   * shares a budget with other tilesets and overlays. A negative value
+   * removes the limit.
+   */
+  void SetTileLoadLimit(int32 Value);
+
   UFUNCTION(BlueprintCallable, Category = "Cesium")
   int64 GetSubTileCacheBytes() const;
 
   UFUNCTION(BlueprintCallable, Category = "Cesium")
   void SetSubTileCacheBytes(int64 Value);
 
+  /**
+   * Limits the number of bytes of the sub-tile cache to less than
+   * SubTileCacheBytes, for example because memory is low. A negative value
+   * removes the limit.
+   */
+  void SetSubTileCacheLimit(int64 Value);
+
+  UFUNCTION(BlueprintCallable, Category = "Cesium")
+  int32 GetQualityTier() const;
+
+  UFUNCTION(BlueprintCallable, Category = "Cesium")
+  void SetQualityTier(int32 Value);
+
+  /**
+   * Gets the quality tier that is currently applied to this overlay, which is
+   * the larger of QualityTier and, when AdaptQualityTier is enabled, the tier
+   * chosen by the tileset.
+   */
+  UFUNCTION(BlueprintCallable, Category = "Cesium")
+  int32 GetEffectiveQualityTier() const;
+
+  /**
+   * Gets the largest quality tier that the tileset may choose for this
+   * overlay, or 0 if AdaptQualityTier is disabled.
+   */
+  int32 GetMaximumAdaptiveQualityTier() const;
+
+  /**
+   * Sets the quality tier chosen by the tileset from its memory use and
+   * frame time, which is applied when AdaptQualityTier is enabled.
+   */
+  void SetAdaptiveQualityTier(int32 Value);
+
   virtual void Activate(bool bReset) override;
   virtual void Deactivate() override;
   virtual void OnComponentDestroyed(bool bDestroyingHierarchy) override;
@@ -164,6 +205,44 @@ protected:
       Category = "Cesium")
   int64 SubTileCacheBytes = 16 * 1024 * 1024;
 
+  /**
+   * The quality tier of this overlay. Each tier halves the
+   * MaximumTextureSize and doubles the MaximumScreenSpaceError of the overlay
+   * tiles, which quarters the memory used by their textures.
+   *
+   * Unlike changes to those properties, a change to the tier does not reload
+   * the overlay. Overlay tiles that are already loaded are kept, and the new
+   * tier is used for the overlay tiles that are loaded from then on.
+   */
+  UPROPERTY(
+      EditAnywhere,
+      BlueprintGetter = GetQualityTier,
+      BlueprintSetter = SetQualityTier,
+      Category = "Cesium",
+      meta = (ClampMin = 0, ClampMax = 4))
+  int32 QualityTier = 0;
+
+  /**
+   * Whether the tileset may lower the quality of this overlay, by raising its
+   * quality tier above QualityTier, when the textures of its raster overlays
+   * use more than its MaximumRasterOverlayTextureBytes, when memory is low, or
+   * when the frame rate stays below its TargetFrameRate even at the
+   * MaximumAdaptiveScreenSpaceError.
+   */
+  UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Cesium")
+  bool AdaptQualityTier = false;
+
+  /**
+   * The largest quality tier that the tileset may choose for this overlay
+   * when AdaptQualityTier is enabled.
+   */
+  UPROPERTY(
+      EditAnywhere,
+      BlueprintReadWrite,
+      Category = "Cesium",
+      meta = (ClampMin = 0, ClampMax = 4, EditCondition = "AdaptQualityTier"))
+  int32 MaximumAdaptiveQualityTier = 2;
+
 #if WITH_EDITOR
   // Called when properties are changed in the editor
   virtual void
@@ -184,5 +263,14 @@ protected:
       Cesium3DTilesSelection::RasterOverlay* pOverlay) {}
 
 private:
+  int32 getEffectiveMaximumSimultaneousTileLoads() const;
+  int64 getEffectiveSubTileCacheBytes() const;
+  double getEffectiveMaximumScreenSpaceError() const;
+  int32 getEffectiveMaximumTextureSize() const;
+  void applyQualityTier();
+
   Cesium3DTilesSelection::RasterOverlay* _pOverlay;
+  int32 _tileLoadLimit = -1;
+  int64 _subTileCacheLimit = -1;
+  int32 _adaptiveQualityTier = 0;
 };
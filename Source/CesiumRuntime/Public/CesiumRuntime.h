@@ -4,10 +4,16 @@
 
 #include "CoreMinimal.h"
 #include "Modules/ModuleManager.h"
+#include <memory>
 
 class ACesium3DTileset;
 class UCesiumRasterOverlay;
 
+namespace CesiumAsync {
+class AsyncSystem;
+class IAssetAccessor;
+} // namespace CesiumAsync
+
 DECLARE_LOG_CATEGORY_EXTERN(LogCesium, Log, All);
 
 class FCesiumRuntimeModule : public IModuleInterface {
@@ -38,3 +44,26 @@ DECLARE_MULTICAST_DELEGATE_OneParam(
 
 CESIUMRUNTIME_API extern FCesiumRasterOverlayIonTroubleshooting
     OnCesiumRasterOverlayIonTroubleshooting;
+
+/**
+ * Gets the asset accessor shared by all tilesets and raster overlays. It
+ * answers requests from the configured tile bundles and the request cache
+ * before making them over HTTP.
+ *
+ * The asset accessor and its request cache are created in a background task
+ * when the module starts up. If they aren't ready yet, this waits for them.
+ */
+CESIUMRUNTIME_API const std::shared_ptr<CesiumAsync::IAssetAccessor>&
+getAssetAccessor();
+
+/**
+ * Whether the asset accessor returned by {@link getAssetAccessor} is ready,
+ * so that getting it doesn't wait for the request cache to be opened. Must be
+ * called from the game thread.
+ */
+CESIUMRUNTIME_API bool isAssetAccessorReady() noexcept;
+
+/**
+ * Gets the async system shared by all tilesets and raster overlays.
+ */
+CESIUMRUNTIME_API CesiumAsync::AsyncSystem& getAsyncSystem() noexcept;
@@ -6,6 +6,93 @@
 #include "Engine/DeveloperSettings.h"
 #include "CesiumRuntimeSettings.generated.h"
 
+/**
+ * How uncompressed tile and raster overlay textures are block-compressed
+ * while they are loaded.
+ */
+UENUM()
+enum class ECesiumTextureCompression : uint8 {
+  /** The textures are uploaded uncompressed. */
+  None,
+
+  /** The endpoints of each block are taken from its bounding box. */
+  Fast,
+
+  /**
+   * The endpoints of each block are fit to the principal axis of its colors
+   * and refined, which looks better but takes several times longer.
+   */
+  HighQuality
+};
+
+/**
+ * The GPU format that KTX2 textures with Basis Universal compression are
+ * transcoded to while they are loaded.
+ */
+UENUM()
+enum class ECesiumKtx2TranscodeTarget : uint8 {
+  /**
+   * The format is picked from the formats supported by the platform, in the
+   * same way for every kind of texture.
+   */
+  Default,
+
+  /** The textures are transcoded to uncompressed RGBA, 32 bits per texel. */
+  Uncompressed,
+
+  /** BC1 (DXT1), RGB at 4 bits per texel. */
+  BC1,
+
+  /** BC3 (DXT5), RGBA at 8 bits per texel. */
+  BC3,
+
+  /** BC4, a single channel at 4 bits per texel. */
+  BC4,
+
+  /** BC5, two channels at 8 bits per texel, suited to normal maps. */
+  BC5,
+
+  /** BC7, RGBA at 8 bits per texel, at a higher quality than BC1 and BC3. */
+  BC7,
+
+  /** ETC1, RGB at 4 bits per texel. */
+  ETC1,
+
+  /** ETC2, RGBA at 8 bits per texel. */
+  ETC2,
+
+  /** ETC2 EAC R11, a single channel at 4 bits per texel. */
+  ETC2_R11,
+
+  /** ETC2 EAC RG11, two channels at 8 bits per texel. */
+  ETC2_RG11,
+
+  /** ASTC with 4x4 blocks, RGBA at 8 bits per texel. */
+  ASTC_4x4,
+
+  /** PVRTC2, RGBA at 4 bits per texel. */
+  PVRTC2
+};
+
+/**
+ * The priority of the threads that cesium-native's worker thread tasks, such
+ * as decoding tiles and creating their meshes, run on.
+ */
+UENUM()
+enum class ECesiumWorkerThreadPriority : uint8 {
+  /** The tasks run at the same priority as Unreal's other tasks. */
+  Normal,
+
+  /**
+   * The tasks run below the priority of Unreal's other tasks, so that they
+   * don't delay animation, physics and rendering tasks.
+   */
+  BelowNormal,
+
+  /** The tasks run at the lowest priority, when nothing else needs to. */
+  Lowest
+};
+
 /**
  * Stores runtime settings for the Cesium plugin.
  */
@@ -37,4 +124,465 @@ public:
       Category = "Cesium ion",
       meta = (DisplayName = "Default Cesium ion Access Token"))
   FString DefaultIonAccessToken;
+
+  /**
+   * Whether all the tilesets in a world, and their raster overlays, share a
+   * single budget of simultaneous tile loads and cached bytes. When this is
+   * false, each tileset is only limited by its own properties.
+   */
+  UPROPERTY(Config, EditAnywhere, Category = "Tile Loading")
+  bool UseSharedTileLoadBudget = false;
+
+  /**
+   * The total number of tiles that may simultaneously be loading across all
+   * the tilesets and raster overlays in a world, when the shared budget is
+   * used.
+   */
+  UPROPERTY(
+      Config,
+      EditAnywhere,
+      Category = "Tile Loading",
+      meta = (ClampMin = 1, EditCondition = "UseSharedTileLoadBudget"))
+  int32 SharedMaximumSimultaneousTileLoads = 40;
+
+  /**
+   * The total number of bytes that the tilesets in a world may use to cache
+   * tiles, when the shared budget is used.
+   */
+  UPROPERTY(
+      Config,
+      EditAnywhere,
+      Category = "Tile Loading",
+      meta = (ClampMin = 0, EditCondition = "UseSharedTileLoadBudget"))
+  int64 SharedMaximumCachedBytes = 1024 * 1024 * 1024;
+
+  /**
+   * The weight, in the shared budget, of each tile that is needed to render
+   * the current view at the required level of detail.
+   *
+   * The load slots of the shared budget are divided among the tilesets, and
+   * between the geometry and the raster overlays of each tileset, in
+   * proportion to the sum of the weights of the tiles they are waiting for.
+   */
+  UPROPERTY(
+      Config,
+      EditAnywhere,
+      Category = "Tile Loading",
+      meta = (ClampMin = 0.0, EditCondition = "UseSharedTileLoadBudget"))
+  float VisibleTileLoadWeight = 4.0f;
+
+  /**
+   * The weight, in the shared budget, of each rendered tile whose raster
+   * overlays are still loading, and that is shown with the coarser overlays
+   * of its ancestors until they are. This is above the weight of refining
+   * and preloading tiles by default, so that the tiles on the screen are
+   * textured before more geometry is loaded.
+   */
+  UPROPERTY(
+      Config,
+      EditAnywhere,
+      Category = "Tile Loading",
+      meta = (ClampMin = 0.0, EditCondition = "UseSharedTileLoadBudget"))
+  float RasterOverlayTileLoadWeight = 4.0f;
+
+  /**
+   * The weight, in the shared budget, of each tile that is needed to refine
+   * the current view.
+   */
+  UPROPERTY(
+      Config,
+      EditAnywhere,
+      Category = "Tile Loading",
+      meta = (ClampMin = 0.0, EditCondition = "UseSharedTileLoadBudget"))
+  float RefiningTileLoadWeight = 2.0f;
+
+  /**
+   * The weight, in the shared budget, of each tile that is loaded
+   * speculatively, such as ancestor and sibling tiles.
+   */
+  UPROPERTY(
+      Config,
+      EditAnywhere,
+      Category = "Tile Loading",
+      meta = (ClampMin = 0.0, EditCondition = "UseSharedTileLoadBudget"))
+  float PreloadTileLoadWeight = 1.0f;
+
+  /**
+   * Whether tile and raster overlay requests are completed on Unreal's HTTP
+   * thread, so that their responses are handed to the load threads as soon as
+   * they arrive rather than when the game thread next ticks the HTTP manager.
+   * This helps most when the frame rate is low, such as in the editor. It is
+   * only supported in Unreal Engine 5; earlier versions always complete
+   * requests on the game thread.
+   */
+  UPROPERTY(
+      Config,
+      EditAnywhere,
+      Category = "Tile Loading",
+      meta = (DisplayName = "Complete Requests on HTTP Thread"))
+  bool CompleteRequestsOnHttpThread = false;
+
+  /**
+   * The maximum number of tile and raster overlay requests that are in flight
+   * to each server at once, or 0 for no limit. Further requests wait in a
+   * queue, in the order they were made, and are sent as earlier ones
+   * complete. Keeping this at or below the engine's own limit on the
+   * connections to each host, such as MaxHostConnections in the [HTTP.Curl]
+   * section of the Engine configuration, lets every request reuse an open
+   * connection instead of waiting inside the HTTP backend. Whether
+   * connections are kept alive and HTTP/2 is used is up to that backend.
+   * Changes take effect the next time Unreal is started.
+   */
+  UPROPERTY(
+      Config,
+      EditAnywhere,
+      Category = "Tile Loading",
+      meta = (ClampMin = 0))
+  int32 MaximumRequestsPerHost = 0;
+
+  /**
+   * The maximum number of tile and raster overlay requests that are in flight
+   * at once to all servers, or 0 for no limit. This keeps bursts of requests,
+   * such as when the camera jumps, from overflowing the engine's global limits
+   * on HTTP requests. Changes take effect the next time Unreal is started.
+   */
+  UPROPERTY(
+      Config,
+      EditAnywhere,
+      Category = "Tile Loading",
+      meta = (ClampMin = 0))
+  int32 MaximumRequestsInFlight = 0;
+
+  /**
+   * Whether tile and raster overlay requests that take much longer than most
+   * are hedged. A copy of such a request is sent, whichever of the two
+   * responses arrives first is used, and the other request is canceled. This
+   * cuts the few very slow responses that keep a view from refining, such as
+   * those from a congested CDN edge, for a small amount of extra bandwidth.
+   * Changes take effect the next time Unreal is started.
+   */
+  UPROPERTY(Config, EditAnywhere, Category = "Tile Loading")
+  bool HedgeSlowRequests = false;
+
+  /**
+   * The percentile of the latencies of recent requests after which a request
+   * that is still in flight is hedged.
+   */
+  UPROPERTY(
+      Config,
+      EditAnywhere,
+      Category = "Tile Loading",
+      meta =
+          (EditCondition = "HedgeSlowRequests",
+           ClampMin = 50.0,
+           ClampMax = 99.9))
+  float HedgeRequestPercentile = 95.0f;
+
+  /**
+   * The shortest time, in seconds, that a request is in flight before it is
+   * hedged, however fast the other requests are.
+   */
+  UPROPERTY(
+      Config,
+      EditAnywhere,
+      Category = "Tile Loading",
+      meta = (ClampMin = 0.0, EditCondition = "HedgeSlowRequests"))
+  float MinimumHedgeDelay = 0.5f;
+
+  /**
+   * The largest fraction of the requests that are sent that may be hedged,
+   * which bounds the extra bandwidth.
+   */
+  UPROPERTY(
+      Config,
+      EditAnywhere,
+      Category = "Tile Loading",
+      meta =
+          (EditCondition = "HedgeSlowRequests", ClampMin = 0.0, ClampMax = 1.0))
+  float MaximumHedgedRequestFraction = 0.05f;
+
+  /**
+   * The number of threads that cesium-native's worker thread tasks, such as
+   * decoding tiles and creating their meshes, run on. When this is 0, they
+   * run on Unreal's task graph alongside the engine's own tasks. Changes take
+   * effect the next time Unreal is started.
+   */
+  UPROPERTY(
+      Config,
+      EditAnywhere,
+      Category = "Tile Loading",
+      meta = (ClampMin = 0, ClampMax = 64))
+  int32 WorkerThreadCount = 0;
+
+  /**
+   * The priority of the worker thread tasks. On the task graph, tasks that
+   * are below normal priority run on its background threads. Changes take
+   * effect the next time Unreal is started.
+   */
+  UPROPERTY(Config, EditAnywhere, Category = "Tile Loading")
+  ECesiumWorkerThreadPriority WorkerThreadPriority =
+      ECesiumWorkerThreadPriority::Normal;
+
+  /**
+   * The maximum time, in milliseconds, spent each frame destroying the
+   * components, meshes, materials and textures of unloaded tiles. When many
+   * tiles are unloaded at once, such as when a tileset is refreshed, the
+   * rest are destroyed on later frames. Set this to 0 to destroy them all as
+   * soon as possible.
+   */
+  UPROPERTY(
+      Config,
+      EditAnywhere,
+      Category = "Tile Loading",
+      meta = (ClampMin = 0.0))
+  float MaximumDestructionTimePerFrame = 2.0f;
+
+  /**
+   * The maximum number of bytes of recently used responses, such as
+   * tileset.json files and tiles, that are kept in memory in front of the
+   * on-disk request cache. Requests for these are answered without reading
+   * the disk. Set this to 0 to only use the on-disk cache. Changes take effect
+   * the next time Unreal is started.
+   */
+  UPROPERTY(
+      Config,
+      EditAnywhere,
+      Category = "Tile Loading",
+      meta = (ClampMin = 0))
+  int64 MemoryCacheBytes = 64 * 1024 * 1024;
+
+  /**
+   * The free physical memory, in megabytes, below which the tilesets respond
+   * to memory pressure as if the platform had signaled low memory. Set this
+   * to 0 to only respond to the platform's signals, such as memory warnings
+   * on iOS and trim requests on Android.
+   */
+  UPROPERTY(
+      Config,
+      EditAnywhere,
+      Category = "Memory Pressure",
+      meta = (ClampMin = 0))
+  int32 LowMemoryWatermarkMegabytes = 0;
+
+  /**
+   * The fraction of their usual cache sizes that tilesets and raster overlays
+   * keep while memory is low. The tiles and overlay tiles beyond it that are
+   * not visible are unloaded, the pooled primitives and textures are
+   * destroyed, and the mips of streamed tile textures are halved.
+   */
+  UPROPERTY(
+      Config,
+      EditAnywhere,
+      Category = "Memory Pressure",
+      meta = (ClampMin = 0.0, ClampMax = 1.0))
+  float MemoryPressureCacheFraction = 0.25f;
+
+  /**
+   * How long, in seconds, memory is considered low after the platform last
+   * signaled it. The usual cache sizes are restored afterwards.
+   */
+  UPROPERTY(
+      Config,
+      EditAnywhere,
+      Category = "Memory Pressure",
+      meta = (ClampMin = 0.0))
+  float MemoryPressureDuration = 30.0f;
+
+  /**
+   * The directory in which the on-disk request cache,
+   * cesium-request-cache.sqlite, is stored. If this is empty, a
+   * platform-specific default is used, such as the engine user directory on
+   * desktop platforms. Changes take effect the next time Unreal is started.
+   */
+  UPROPERTY(Config, EditAnywhere, Category = "Request Cache")
+  FString RequestCacheDirectory;
+
+  /**
+   * The maximum number of responses kept in the on-disk request cache. When
+   * it is pruned, the least recently used responses beyond this number are
+   * deleted. Changes take effect the next time Unreal is started.
+   */
+  UPROPERTY(
+      Config,
+      EditAnywhere,
+      Category = "Request Cache",
+      meta = (ClampMin = 1))
+  int32 MaximumCachedRequests = 4096;
+
+  /**
+   * The number of requests after which the request cache is pruned. Changes
+   * take effect the next time Unreal is started.
+   */
+  UPROPERTY(
+      Config,
+      EditAnywhere,
+      Category = "Request Cache",
+      meta = (ClampMin = 1))
+  int32 RequestsPerCachePrune = 10000;
+
+  /**
+   * Whether the request cache is pruned on a background task. When this is
+   * false, it is pruned in the continuation of the request that triggers it,
+   * which is delayed until the prune is done.
+   */
+  UPROPERTY(Config, EditAnywhere, Category = "Request Cache")
+  bool PruneRequestCacheInBackground = true;
+
+  /**
+   * The tile bundles whose responses are served without any network requests
+   * or request cache lookups. Paths that are relative are relative to the
+   * project directory. A bundle holds the responses to a set of URLs, which
+   * are memory-mapped and given to the tile loaders without being copied.
+   * Requests for any other URL are made as usual. Changes take effect the
+   * next time Unreal is started.
+   */
+  UPROPERTY(Config, EditAnywhere, Category = "Request Cache")
+  TArray<FString> TileBundles;
+
+  /**
+   * The URL of a cache server shared by several machines, such as the nodes
+   * of an nDisplay cluster, that GET requests for http:// and https:// URLs
+   * are sent through, so that each tile is downloaded only once for all of
+   * them. The original URL is percent-encoded and appended to this URL, which
+   * usually ends with a query parameter, such as
+   * http://cache-host:8080/fetch?url=. Requests are made directly while the
+   * server can't be reached. If this is empty, no cache server is used.
+   * Changes take effect the next time Unreal is started.
+   */
+  UPROPERTY(Config, EditAnywhere, Category = "Request Cache")
+  FString ClusterCacheServerUrl;
+
+  /**
+   * Whether the responses that resolve Cesium ion assets to the URLs and
+   * access tokens of their tiles are kept in memory, so that loading an
+   * asset again with the same token skips that request. They are kept until
+   * shortly before their tokens expire, and are requested again in the
+   * background before then. Changes take effect the next time Unreal is
+   * started.
+   */
+  UPROPERTY(Config, EditAnywhere, Category = "Request Cache")
+  bool CacheIonEndpoints = true;
+
+  /**
+   * The maximum number of bytes of converted tiles kept on disk, so that
+   * tiles whose glTF was converted to Unreal meshes, textures and physics
+   * meshes before are restored instead of being converted again. The least
+   * recently used tiles beyond it are deleted. Set this to 0 to disable the
+   * cache. Changes take effect the next time Unreal is started.
+   */
+  UPROPERTY(
+      Config,
+      EditAnywhere,
+      Category = "Converted Model Cache",
+      meta = (ClampMin = 0))
+  int64 ConvertedModelCacheBytes = 0;
+
+  /**
+   * The directory in which the converted tiles are cached. If this is empty,
+   * Saved/Cesium/ConvertedModels in the project directory is used. Changes
+   * take effect the next time Unreal is started.
+   */
+  UPROPERTY(Config, EditAnywhere, Category = "Converted Model Cache")
+  FString ConvertedModelCacheDirectory;
+
+  /**
+   * Whether the mipmaps of uncompressed tile and raster overlay textures are
+   * generated on the GPU. When this is false, they are generated on the CPU
+   * while the tiles are loaded, and uploaded with the first mip. Platforms
+   * without compute shaders always generate them on the CPU.
+   */
+  UPROPERTY(
+      Config,
+      EditAnywhere,
+      Category = "Textures",
+      meta = (DisplayName = "Generate Mipmaps on GPU"))
+  bool GenerateMipmapsOnGPU = false;
+
+  /**
+   * Whether uncompressed tile and raster overlay textures are compressed to
+   * BC1, BC3, BC4 or BC5 while they are loaded, which uses a quarter to an
+   * eighth of the GPU memory. Textures are left uncompressed on platforms
+   * that do not support these formats. Compressed textures always have their
+   * mipmaps generated on the CPU.
+   */
+  UPROPERTY(Config, EditAnywhere, Category = "Textures")
+  ECesiumTextureCompression TextureCompression =
+      ECesiumTextureCompression::None;
+
+  /**
+   * Whether KTX2 textures with UASTC compression are transcoded to the
+   * formats that preserve their quality, such as BC7 and ASTC, rather than
+   * to the smallest ones, when their target is Default.
+   *
+   * Like the other settings, the KTX2 targets can be set for a single
+   * platform in its Engine.ini, such as Config/Android/AndroidEngine.ini.
+   */
+  UPROPERTY(
+      Config,
+      EditAnywhere,
+      Category = "Textures",
+      meta = (DisplayName = "KTX2 Preserve High Quality"))
+  bool Ktx2PreserveHighQuality = false;
+
+  /**
+   * The format that KTX2 textures with three channels, usually base color
+   * and emissive textures, are transcoded to. If the platform doesn't support
+   * it, the Default format is used.
+   */
+  UPROPERTY(
+      Config,
+      EditAnywhere,
+      Category = "Textures",
+      meta = (DisplayName = "KTX2 Color Target"))
+  ECesiumKtx2TranscodeTarget Ktx2ColorTarget =
+      ECesiumKtx2TranscodeTarget::Default;
+
+  /**
+   * The format that KTX2 textures with four channels, usually base color
+   * textures with alpha, are transcoded to. If the platform doesn't support
+   * it, the Default format is used.
+   */
+  UPROPERTY(
+      Config,
+      EditAnywhere,
+      Category = "Textures",
+      meta = (DisplayName = "KTX2 Color and Alpha Target"))
+  ECesiumKtx2TranscodeTarget Ktx2ColorAlphaTarget =
+      ECesiumKtx2TranscodeTarget::Default;
+
+  /**
+   * The format that KTX2 textures with two channels, usually normal maps,
+   * are transcoded to, such as BC5 or ETC2_RG11. If the platform doesn't
+   * support it, the Default format is used.
+   */
+  UPROPERTY(
+      Config,
+      EditAnywhere,
+      Category = "Textures",
+      meta = (DisplayName = "KTX2 Normal Target"))
+  ECesiumKtx2TranscodeTarget Ktx2NormalTarget =
+      ECesiumKtx2TranscodeTarget::Default;
+
+  /**
+   * The format that KTX2 textures with one channel, such as occlusion
+   * textures, are transcoded to. If the platform doesn't support it, the
+   * Default format is used.
+   */
+  UPROPERTY(
+      Config,
+      EditAnywhere,
+      Category = "Textures",
+      meta = (DisplayName = "KTX2 Single Channel Target"))
+  ECesiumKtx2TranscodeTarget Ktx2SingleChannelTarget =
+      ECesiumKtx2TranscodeTarget::Default;
+
+  /**
+   * Whether tilesets draw every combination of their materials and the
+   * vertex layouts of tiles, without covering any pixels, for a few frames
+   * when play begins, so that the shaders and pipeline states that the tiles
+   * need are created before the first tiles are shown, instead of stalling
+   * the frames that show them.
+   */
+  UPROPERTY(Config, EditAnywhere, Category = "Rendering")
+  bool PrecachePipelineStates = true;
 };
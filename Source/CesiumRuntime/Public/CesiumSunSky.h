@@ -11,6 +11,8 @@
 #include "Components/StaticMeshComponent.h"
 #include "Engine/DirectionalLight.h"
 #include "GameFramework/Actor.h"
+#include <array>
+#include <optional>
 #include "CesiumSunSky.generated.h"
 
 class UCesiumGlobeAnchorComponent;
@@ -238,6 +240,9 @@ protected:
    * Updates the atmosphere automatically given current player pawn's longitude,
    * latitude, and height. Fixes artifacts seen with the atmosphere rendering
    * when flying high above the surface, or low to the ground in high latitudes.
+   *
+   * The ground radius is only computed again in frames where the view, the
+   * georeference origin or the thresholds below have changed.
    */
   UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Cesium|Atmosphere")
   bool UpdateAtmosphereAtRuntime = true;
@@ -443,4 +448,27 @@ private:
       ETeleportType Teleport);
 
   FDelegateHandle _transformUpdatedSubscription;
+
+  // Calls UpdateSun if the date, the time or the georeference origin changed
+  // since the last call, or the georeference moved this actor.
+  void _updateSunIfNeeded();
+
+  // Updates the atmosphere ground radius if the view or the georeference
+  // origin changed since the last update.
+  void _updateAtmosphereRadiusIfNeeded();
+
+  void _updateAtmosphereRadius(const FVector& viewLocation);
+
+  // The properties and the georeference origin that the sun position was
+  // last computed from, or nothing if it was never computed.
+  std::optional<std::array<double, 15>> _lastSunInputs;
+  TWeakObjectPtr<ADirectionalLight> _lastLevelDirectionalLight;
+
+  // Whether the georeference moved this actor since the sun was updated.
+  bool _sunUpdatePending = false;
+
+  // The view location, the georeference origin and the thresholds that the
+  // atmosphere ground radius was last computed from, or nothing if it was
+  // never computed.
+  std::optional<std::array<double, 8>> _lastAtmosphereInputs;
 };
@@ -0,0 +1,128 @@
+// Copyright 2020-2021 CesiumGS, Inc. and Contributors
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "CesiumTileLoadScheduler.generated.h"
+
+class ACesium3DTileset;
+
+/**
+ * The loading demand of a single tileset in the last frame, as reported by
+ * its tile selection.
+ */
+struct FCesiumTileLoadDemand {
+  /**
+   * The number of tiles rendered by the tileset.
+   */
+  int32 TilesRendered = 0;
+
+  /**
+   * The number of tiles waiting to be loaded because they are needed to
+   * render the current view at the required level of detail.
+   */
+  int32 TilesLoadingHighPriority = 0;
+
+  /**
+   * The number of tiles waiting to be loaded because they are needed to
+   * refine the current view.
+   */
+  int32 TilesLoadingMediumPriority = 0;
+
+  /**
+   * The number of tiles waiting to be loaded speculatively, such as ancestor
+   * and sibling tiles.
+   */
+  int32 TilesLoadingLowPriority = 0;
+
+  /**
+   * The number of active raster overlays on the tileset, which share its
+   * allocation of simultaneous raster overlay tile loads.
+   */
+  int32 RasterOverlays = 0;
+
+  /**
+   * The number of rendered tiles that are waiting for their raster overlay
+   * tiles to be loaded, and are shown with those of their ancestors until
+   * they are.
+   */
+  int32 TilesWaitingForRasterOverlays = 0;
+};
+
+/**
+ * Shares a single budget of simultaneous tile loads and cached bytes among
+ * all the Cesium 3D Tilesets in a world, and their raster overlays.
+ *
+ * The budget is enabled and sized in the Cesium project settings. Each frame,
+ * load slots are allocated according to the priority class of the tiles that
+ * are waiting to be loaded: geometry tiles needed for the current view,
+ * rendered tiles waiting for their raster overlays, geometry tiles that
+ * refine the view, and preloaded geometry tiles. Each class has a weight in
+ * the project settings, and the slots are divided among the tilesets, and
+ * between the geometry and the raster overlays of each tileset, in proportion
+ * to the weights of the tiles they are waiting for. So a tileset with many
+ * tiles needed for the current view receives more slots than one that is only
+ * preloading, and the overlays of visible tiles receive more slots than
+ * preloaded geometry. The byte budget is allocated according to the number of
+ * tiles each tileset renders. A tileset or overlay never uses more than its
+ * own MaximumSimultaneousTileLoads, and a tileset more than its own
+ * MaximumCachedBytes, whatever its allocation.
+ */
+UCLASS()
+class CESIUMRUNTIME_API UCesiumTileLoadScheduler : public UWorldSubsystem {
+  GENERATED_BODY()
+
+public:
+  /**
+   * Reports the loading demand of a tileset after its tile selection. The
+   * demand is used for the allocations of the next frame.
+   */
+  void ReportDemand(
+      const ACesium3DTileset* Tileset,
+      const FCesiumTileLoadDemand& Demand);
+
+  /**
+   * Stops allocating any of the budget to the given tileset.
+   */
+  void RemoveTileset(const ACesium3DTileset* Tileset);
+
+  /**
+   * Gets the share of the budget allocated to the given tileset in the
+   * current frame.
+   *
+   * @param Tileset The tileset.
+   * @param OutMaximumSimultaneousTileLoads The number of simultaneous
+   * geometry tile loads that the tileset may use.
+   * @param OutMaximumSimultaneousRasterOverlayTileLoads The number of
+   * simultaneous tile loads that each of the raster overlays of the tileset
+   * may use.
+   * @param OutMaximumCachedBytes The number of bytes the tileset may use to
+   * cache tiles.
+   * @return False if the shared budget is disabled, in which case the tileset
+   * should use its own limits.
+   */
+  bool GetAllocation(
+      const ACesium3DTileset* Tileset,
+      int32& OutMaximumSimultaneousTileLoads,
+      int32& OutMaximumSimultaneousRasterOverlayTileLoads,
+      int64& OutMaximumCachedBytes);
+
+private:
+  struct TilesetEntry {
+    TWeakObjectPtr<const ACesium3DTileset> pTileset;
+    FCesiumTileLoadDemand demand;
+    uint64 lastUpdateFrame = 0;
+    int32 maximumSimultaneousTileLoads = 0;
+    int32 maximumSimultaneousRasterOverlayTileLoads = 0;
+    int64 maximumCachedBytes = 0;
+  };
+
+  TilesetEntry* findEntry(const ACesium3DTileset* pTileset);
+  TilesetEntry& findOrAddEntry(const ACesium3DTileset* pTileset);
+  void updateAllocations();
+
+  TArray<TilesetEntry> _tilesets;
+  uint64 _allocationFrame = 0;
+  bool _allocationsValid = false;
+};
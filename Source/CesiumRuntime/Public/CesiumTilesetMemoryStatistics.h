@@ -0,0 +1,92 @@
+// Copyright 2020-2021 CesiumGS, Inc. and Contributors
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "CesiumTilesetMemoryStatistics.generated.h"
+
+/**
+ * The memory used by the Unreal Engine objects created for the tiles of a
+ * Cesium 3D Tileset.
+ *
+ * The byte counts are the sizes of the buffers and textures that are
+ * allocated on the GPU, or of the cooked physics meshes, and not the sizes of
+ * the tile data that was downloaded.
+ */
+USTRUCT(BlueprintType)
+struct CESIUMRUNTIME_API FCesiumTilesetMemoryStatistics {
+  GENERATED_BODY()
+
+  /**
+   * The number of tile models that have been created in Unreal Engine.
+   */
+  UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Cesium")
+  int32 TileModels = 0;
+
+  /**
+   * The number of materials created for the primitives of the tiles.
+   */
+  UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Cesium")
+  int32 Materials = 0;
+
+  /**
+   * The number of bytes in the vertex buffers of the tiles, including
+   * positions, normals, tangents, texture coordinates, and colors.
+   */
+  UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Cesium")
+  int64 VertexBufferBytes = 0;
+
+  /**
+   * The number of bytes in the index buffers of the tiles.
+   */
+  UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Cesium")
+  int64 IndexBufferBytes = 0;
+
+  /**
+   * The number of bytes in the textures of the tiles' glTF materials.
+   */
+  UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Cesium")
+  int64 TextureBytes = 0;
+
+  /**
+   * The number of bytes in the textures of the tileset's raster overlays.
+   */
+  UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Cesium")
+  int64 RasterOverlayTextureBytes = 0;
+
+  /**
+   * The approximate number of bytes in the collision meshes of the tiles.
+   * This counts the vertices and triangles given to the physics engine, but
+   * not its acceleration structures.
+   */
+  UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Cesium")
+  int64 CollisionBytes = 0;
+
+  /**
+   * The sum of all of the byte counts above.
+   */
+  UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Cesium")
+  int64 TotalBytes = 0;
+
+  FCesiumTilesetMemoryStatistics&
+  operator+=(const FCesiumTilesetMemoryStatistics& Other) {
+    this->TileModels += Other.TileModels;
+    this->Materials += Other.Materials;
+    this->VertexBufferBytes += Other.VertexBufferBytes;
+    this->IndexBufferBytes += Other.IndexBufferBytes;
+    this->TextureBytes += Other.TextureBytes;
+    this->RasterOverlayTextureBytes += Other.RasterOverlayTextureBytes;
+    this->CollisionBytes += Other.CollisionBytes;
+    this->TotalBytes += Other.TotalBytes;
+    return *this;
+  }
+
+  /**
+   * Recomputes TotalBytes from the other byte counts.
+   */
+  void UpdateTotalBytes() {
+    this->TotalBytes = this->VertexBufferBytes + this->IndexBufferBytes +
+                       this->TextureBytes + this->RasterOverlayTextureBytes +
+                       this->CollisionBytes;
+  }
+};
@@ -5,6 +5,9 @@
 #include "CesiumGeospatial/Ellipsoid.h"
 #include "HAL/Platform.h"
 #include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include <gsl/span>
+#include <memory>
 
 /**
  * @brief A lightweight structure to encapsulate coordinate transforms.
@@ -18,6 +21,44 @@
 class CESIUMRUNTIME_API GeoTransforms {
 
 public:
+  /**
+   * @brief The East-North-Up frame at a location, precomputed by
+   * {@link ComputeEastNorthUpFrame} so that repeated rotator and surface normal
+   * conversions at that location skip rebuilding it.
+   *
+   * A frame is only valid for the GeoTransforms that computed it, and has to
+   * be recomputed when the georeference origin changes. It does not depend on
+   * the floating origin, so it stays valid across origin rebases.
+   */
+  struct EastNorthUpFrame {
+    /**
+     * @brief The Earth-Centered, Earth-Fixed (ECEF) location of the frame.
+     */
+    glm::dvec3 ecef;
+
+    /**
+     * @brief The rotation matrix from East-North-Up to Unreal, as returned by
+     * {@link ComputeEastNorthUpToUnreal}.
+     */
+    glm::dmat3 eastNorthUpToUnreal;
+
+    /**
+     * @brief The rotation from East-North-Up to Unreal.
+     */
+    glm::dquat eastNorthUpToUnrealRotation;
+
+    /**
+     * @brief The rotation from Unreal to East-North-Up.
+     */
+    glm::dquat unrealToEastNorthUpRotation;
+
+    /**
+     * @brief The ellipsoid surface normal at the location, in Unreal world
+     * coordinates.
+     */
+    glm::dvec3 surfaceNormalUnreal;
+  };
+
   /**
    * @brief Creates a new instance
    */
@@ -153,6 +194,97 @@ public:
    */
   glm::dmat3 ComputeEastNorthUpToEcef(const glm::dvec3& Ecef) const noexcept;
 
+  /**
+   * Computes the East-North-Up frame at the specified Unreal world location
+   * (relative to the floating origin), for use with the functions below that
+   * take a frame instead of a location.
+   */
+  EastNorthUpFrame ComputeEastNorthUpFrame(
+      const glm::dvec3& origin,
+      const glm::dvec3& Ue) const noexcept;
+
+  /**
+   * Transforms a rotator from Unreal world to East-North-Up in the given
+   * precomputed frame. This is the same as the version that takes a location,
+   * without rebuilding the frame.
+   */
+  glm::dquat TransformRotatorUnrealToEastNorthUp(
+      const EastNorthUpFrame& Frame,
+      const glm::dquat& UeRotator) const noexcept;
+
+  /**
+   * Transforms a rotator from East-North-Up to Unreal world in the given
+   * precomputed frame. This is the same as the version that takes a location,
+   * without rebuilding the frame.
+   */
+  glm::dquat TransformRotatorEastNorthUpToUnreal(
+      const EastNorthUpFrame& Frame,
+      const glm::dquat& EnuRotator) const noexcept;
+
+  /*
+   * BATCH TRANSFORMS
+   *
+   * These transform many points at once, from the input span into the output
+   * span, which must have the same size. The output may be the same span as
+   * the input. Large batches are split across the task graph's worker
+   * threads.
+   */
+
+  /**
+   * Transforms each longitude in degrees (x), latitude in degrees (y), and
+   * height in meters (z) into Earth-Centered, Earth-Fixed (ECEF) coordinates.
+   */
+  void TransformLongitudeLatitudeHeightToEcef(
+      gsl::span<const glm::dvec3> LongitudeLatitudeHeights,
+      gsl::span<glm::dvec3> Ecefs) const noexcept;
+
+  /**
+   * Transforms each Earth-Centered, Earth-Fixed (ECEF) position into
+   * longitude in degrees (x), latitude in degrees (y), and height in
+   * meters (z).
+   */
+  void TransformEcefToLongitudeLatitudeHeight(
+      gsl::span<const glm::dvec3> Ecefs,
+      gsl::span<glm::dvec3> LongitudeLatitudeHeights) const noexcept;
+
+  /**
+   * Transforms each longitude in degrees (x), latitude in degrees (y), and
+   * height in meters (z) into Unreal world coordinates (relative to the
+   * floating origin).
+   */
+  void TransformLongitudeLatitudeHeightToUnreal(
+      const glm::dvec3& origin,
+      gsl::span<const glm::dvec3> LongitudeLatitudeHeights,
+      gsl::span<glm::dvec3> Ues) const noexcept;
+
+  /**
+   * Transforms each Unreal world position (relative to the floating origin)
+   * into longitude in degrees (x), latitude in degrees (y), and height in
+   * meters (z).
+   */
+  void TransformUnrealToLongitudeLatitudeHeight(
+      const glm::dvec3& origin,
+      gsl::span<const glm::dvec3> Ues,
+      gsl::span<glm::dvec3> LongitudeLatitudeHeights) const noexcept;
+
+  /**
+   * Transforms each Earth-Centered, Earth-Fixed (ECEF) position into Unreal
+   * world coordinates (relative to the floating origin).
+   */
+  void TransformEcefToUnreal(
+      const glm::dvec3& origin,
+      gsl::span<const glm::dvec3> Ecefs,
+      gsl::span<glm::dvec3> Ues) const noexcept;
+
+  /**
+   * Transforms each Unreal world position (relative to the floating origin)
+   * into Earth-Centered, Earth-Fixed (ECEF) coordinates.
+   */
+  void TransformUnrealToEcef(
+      const glm::dvec3& origin,
+      gsl::span<const glm::dvec3> Ues,
+      gsl::span<glm::dvec3> Ecefs) const noexcept;
+
   /*
    * GEOREFERENCE TRANSFORMS
    */
@@ -227,6 +359,19 @@ public:
     return _ellipsoid.geodeticSurfaceNormal(position);
   }
 
+  /**
+   * @brief Gets the ellipsoid that is used by this instance.
+   */
+  const CesiumGeospatial::Ellipsoid& GetEllipsoid() const noexcept {
+    return this->_ellipsoid;
+  }
+
+  /**
+   * @brief Gets the center position of this instance, in Earth-Centered,
+   * Earth-Fixed (ECEF) coordinates.
+   */
+  const glm::dvec3& GetCenter() const noexcept { return this->_center; }
+
   /**
    * Computes the rotation in ellipsoid surface normal between an old position
    * and a new position. This rotation is expressed in terms of Unreal world
@@ -257,6 +402,21 @@ public:
       const glm::dvec3& oldPosition,
       const glm::dvec3& newPosition) const;
 
+  /**
+   * Computes the rotation in ellipsoid surface normal between the location of
+   * a precomputed frame and a new position, expressed in terms of Unreal world
+   * coordinates. This is the same as the version that takes two positions,
+   * without recomputing the normal at the old position.
+   *
+   * @param oldFrame The frame at the ECEF position that the object moved from.
+   * @param newPosition The new ECEF position that the object moved to.
+   * @return The rotation from the ellipsoid surface normal at the old position
+   * to the ellipsoid surface normal at the new position.
+   */
+  glm::dquat ComputeSurfaceNormalRotationUnreal(
+      const EastNorthUpFrame& oldFrame,
+      const glm::dvec3& newPosition) const;
+
 private:
   /**
    * Update the derived state (i.e. the matrices) when either
@@ -274,3 +434,53 @@ private:
   glm::dmat4 _ueAbsToEcef;
   glm::dmat4 _ecefToUeAbs;
 };
+
+/**
+ * @brief An immutable copy of the GeoTransforms of a Georeference, which may
+ * be copied to and used from any thread, such as by parallel gameplay or AI
+ * tasks.
+ *
+ * The GeoTransforms of a snapshot never change, and copying a snapshot only
+ * copies a reference to them. When the origin or the ellipsoid of the
+ * Georeference changes, it takes a new snapshot with a higher version. See
+ * ACesiumGeoreference::GetGeoTransformsSnapshot.
+ */
+class GeoTransformsSnapshot {
+public:
+  /**
+   * @brief Creates a snapshot of the default GeoTransforms, with version 0.
+   */
+  GeoTransformsSnapshot()
+      : _pTransforms(std::make_shared<const GeoTransforms>()), _version(0) {}
+
+  /**
+   * @brief Creates a snapshot of the given GeoTransforms.
+   *
+   * @param transforms The GeoTransforms, which are copied.
+   * @param version The version of the snapshot.
+   */
+  GeoTransformsSnapshot(const GeoTransforms& transforms, uint64 version)
+      : _pTransforms(std::make_shared<const GeoTransforms>(transforms)),
+        _version(version) {}
+
+  /**
+   * @brief Gets the GeoTransforms of this snapshot.
+   */
+  const GeoTransforms& GetGeoTransforms() const noexcept {
+    return *this->_pTransforms;
+  }
+
+  const GeoTransforms* operator->() const noexcept {
+    return this->_pTransforms.get();
+  }
+
+  /**
+   * @brief Gets the version of this snapshot. Later snapshots of the same
+   * Georeference have higher versions.
+   */
+  uint64 GetVersion() const noexcept { return this->_version; }
+
+private:
+  std::shared_ptr<const GeoTransforms> _pTransforms;
+  uint64 _version;
+};
@@ -9,9 +9,17 @@
 #include <vector>
 #include "GlobeAwareDefaultPawn.generated.h"
 
+class ACesiumCameraManager;
 class ACesiumGeoreference;
 class UCesiumGlobeAnchorComponent;
 class UCurveFloat;
+struct FCesiumCamera;
+
+/**
+ * The delegate for the AGlobeAwareDefaultPawn::OnFlightHoldStarted and
+ * AGlobeAwareDefaultPawn::OnFlightHoldEnded events.
+ */
+DECLARE_DYNAMIC_MULTICAST_DELEGATE(FGlobeAwareDefaultPawnFlightHold);
 
 /**
  * This pawn can be used to easily move around the globe while maintaining a
@@ -98,6 +106,85 @@ public:
   UPROPERTY(EditAnywhere, Category = "Cesium", meta = (ClampMin = 0.0))
   double FlyToGranularityDegrees = 0.01;
 
+  /**
+   * Whether to start loading the tiles along the flight path and at the
+   * destination as soon as the flight begins.
+   *
+   * When this is true, the flight registers additional cameras with the
+   * {@link ACesiumCameraManager}: one looking from the destination, and
+   * {@see FlyToPrefetchSampleCount} at points ahead of the pawn along the
+   * flight path. They are removed when the flight ends.
+   */
+  UPROPERTY(EditAnywhere, Category = "Cesium|Flight Prefetch")
+  bool FlyToPrefetch = false;
+
+  /**
+   * The number of cameras placed ahead of the pawn along the flight path, in
+   * addition to the one at the destination.
+   */
+  UPROPERTY(
+      EditAnywhere,
+      Category = "Cesium|Flight Prefetch",
+      meta = (EditCondition = "FlyToPrefetch", ClampMin = 0))
+  int32 FlyToPrefetchSampleCount = 2;
+
+  /**
+   * The screen-space error scale of the cameras placed along the flight path.
+   * Values below one load coarser tiles, so that these cameras compete less
+   * with the pawn's view and the camera at the destination.
+   */
+  UPROPERTY(
+      EditAnywhere,
+      Category = "Cesium|Flight Prefetch",
+      meta = (EditCondition = "FlyToPrefetch", ClampMin = 0.0))
+  float FlyToPrefetchScreenSpaceErrorScale = 0.25f;
+
+  /**
+   * Whether the flight pauses before its final approach until the tiles of
+   * all tilesets are loaded, so that the pawn does not arrive at a blurry
+   * scene. This is most useful together with {@see FlyToPrefetch}.
+   */
+  UPROPERTY(EditAnywhere, Category = "Cesium|Flight Prefetch")
+  bool FlyToHoldUntilLoaded = false;
+
+  /**
+   * The fraction of the flight duration at which the final approach begins,
+   * and at which the flight holds when {@see FlyToHoldUntilLoaded} is true.
+   */
+  UPROPERTY(
+      EditAnywhere,
+      Category = "Cesium|Flight Prefetch",
+      meta =
+          (EditCondition = "FlyToHoldUntilLoaded",
+           ClampMin = 0.0,
+           ClampMax = 1.0))
+  float FlyToFinalApproachStart = 0.8f;
+
+  /**
+   * The longest time, in seconds, that the flight holds for tiles to load
+   * before it continues anyway.
+   */
+  UPROPERTY(
+      EditAnywhere,
+      Category = "Cesium|Flight Prefetch",
+      meta = (EditCondition = "FlyToHoldUntilLoaded", ClampMin = 0.0))
+  float FlyToHoldTimeout = 10.0f;
+
+  /**
+   * A delegate that is called when the flight starts holding before its final
+   * approach to wait for tiles to load.
+   */
+  UPROPERTY(BlueprintAssignable, Category = "Cesium")
+  FGlobeAwareDefaultPawnFlightHold OnFlightHoldStarted;
+
+  /**
+   * A delegate that is called when the flight stops holding and continues
+   * with its final approach, whether because the tiles were loaded or
+   * because the hold timed out.
+   */
+  UPROPERTY(BlueprintAssignable, Category = "Cesium")
+  FGlobeAwareDefaultPawnFlightHold OnFlightHoldEnded;
+
   /**
    * Begin a smooth camera flight to the given Earth-Centered, Earth-Fixed
    * (ECEF) destination such that the camera ends at the specified yaw and
@@ -158,6 +245,7 @@ public:
 
   virtual bool ShouldTickIfViewportsOnly() const override;
   virtual void Tick(float DeltaSeconds) override;
+  virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
   virtual void PostLoad() override;
   // virtual void Serialize(FArchive& Ar) override;
 
@@ -212,6 +300,37 @@ private:
    */
   void _handleFlightStep(float DeltaSeconds);
 
+  /**
+   * @brief Computes the fraction of the flight path covered after the given
+   * fraction of the flight duration, according to the FlyToProgressCurve.
+   */
+  double _computeFlightPercentage(double rawPercentage) const;
+
+  /**
+   * @brief Computes the ECEF position at the given fraction of the flight
+   * path by interpolating the _keypoints.
+   */
+  glm::dvec3 _computeFlightPositionECEF(double flyPercentage) const;
+
+  /**
+   * @brief Computes the camera for looking from the given fraction of the
+   * flight path, or returns false if there is no player view to base it on.
+   */
+  bool _computeFlightCamera(double flyPercentage, FCesiumCamera& camera) const;
+
+  /**
+   * @brief Whether all tilesets in the world have loaded the tiles for all
+   * of their views.
+   */
+  bool _areTilesetsLoaded() const;
+
+  /**
+   * @brief Registers or updates the flight prefetch cameras with the camera
+   * manager, looking ahead from the given fraction of the flight path.
+   */
+  void _updateFlightCameras(double flyPercentage);
+  void _removeFlightCameras();
+
   // helper variables for FlyToLocation
   bool _bFlyingToLocation = false;
   bool _bCanInterruptFlight = false;
@@ -220,4 +339,13 @@ private:
   FQuat _flyToDestinationRotation;
 
   std::vector<glm::dvec3> _keypoints;
+
+  // The flight prefetch cameras registered with the camera manager. The
+  // last one looks from the destination.
+  TWeakObjectPtr<ACesiumCameraManager> _pFlightCameraManager;
+  std::vector<int32> _flightCameraIds;
+
+  bool _bHoldingFlight = false;
+  bool _bFlightHoldFinished = false;
+  double _flightHoldTime = 0.0;
 };
@@ -7,6 +7,7 @@
 #include "Containers/UnrealString.h"
 #include "HAL/Platform.h"
 #include <cstddef>
+#include <memory>
 
 class CESIUMRUNTIME_API UnrealAssetAccessor
     : public CesiumAsync::IAssetAccessor {
@@ -29,6 +30,36 @@ public:
 
   virtual void tick() noexcept override;
 
+  /**
+   * Cancels the GET request in flight for the given URL and headers, if there
+   * is one. Identical GET requests made while one is in flight share its
+   * response, so all of the callers waiting for it are rejected.
+   *
+   * @return Whether a request was canceled.
+   */
+  bool cancel(
+      const std::string& url,
+      const std::vector<CesiumAsync::IAssetAccessor::THeader>& headers);
+
+  /**
+   * Cancels all of the GET requests in flight.
+   */
+  void cancelAll();
+
 private:
+  /**
+   * Sends hedged copies of the GET requests that have been in flight for
+   * much longer than the others, see
+   * UCesiumRuntimeSettings::HedgeSlowRequests.
+   */
+  void hedgeSlowRequests();
+
+  struct RequestRegistry;
   FString _userAgent;
+
+  // Whether request delegates run on the HTTP thread instead of the game
+  // thread, from UCesiumRuntimeSettings::CompleteRequestsOnHttpThread.
+  bool _completeOnHttpThread;
+
+  std::shared_ptr<RequestRegistry> _pRegistry;
 };
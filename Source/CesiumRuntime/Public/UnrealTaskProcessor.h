@@ -4,8 +4,24 @@
 
 #include "CesiumAsync/ITaskProcessor.h"
 #include "HAL/Platform.h"
+
+/**
+ * @brief Runs cesium-native's worker thread tasks.
+ *
+ * When the WorkerThreadCount runtime setting is greater than zero, the tasks
+ * run on a pool of threads of their own, shared by all the task processors,
+ * at the priority of the WorkerThreadPriority setting. Otherwise, they run on
+ * the task graph with Unreal's other tasks.
+ */
 class CESIUMRUNTIME_API UnrealTaskProcessor
     : public CesiumAsync::ITaskProcessor {
 public:
   virtual void startTask(std::function<void()> f) override;
-};
\ No newline at end of file
+
+  /**
+   * @brief Destroys the worker thread pool, if there is one, abandoning the
+   * tasks that haven't started yet. Tasks started after this run on the task
+   * graph.
+   */
+  static void shutdown();
+};